@@ -18,10 +18,12 @@ int arg_decode_cpu(const struct ArgparseOption *opt, void *out, const char *para
 
 int arg_decode_pixfmt(const struct ArgparseOption *opt, void *out, const char *param, int negated);
 
+int buildbench_main(int argc, char **argv);
 int colorspace_main(int argc, char **argv);
 int cpuinfo_main(int argc, char **argv);
 int depth_main(int argc, char **argv);
 int graph_main(int argc, char **argv);
+int premultiply_main(int argc, char **argv);
 int resize_main(int argc, char **argv);
 int unresize_main(int argc, char **argv);
 
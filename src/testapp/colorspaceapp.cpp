@@ -5,10 +5,17 @@
 #include <regex>
 #include <string>
 #include "colorspace/colorspace.h"
+#include "colorspace/gamma.h"
+#include "colorspace/operation.h"
 #include "common/except.h"
 #include "common/pixel.h"
 #include "graphengine/filter.h"
 
+#if defined(ZIMG_X86)
+  #include "colorspace/x86/operation_impl_x86.h"
+  #include "common/x86/cpuinfo_x86.h"
+#endif
+
 #include "apps.h"
 #include "argparse.h"
 #include "frame.h"
@@ -59,6 +66,58 @@ void execute(const graphengine::Filter *filter, const ImageFrame *src_frame, Ima
 	std::cout << "min: " << results.second << " (" << ns_per_sample(*src_frame, results.second) << " ns/sample)\n";
 }
 
+#if defined(ZIMG_X86)
+// Compares the LUT and polynomial implementations of the AVX2 transfer functions.
+void bench_transfer(zimg::colorspace::TransferCharacteristics transfer, double peak_luminance, const ImageFrame *src_frame, ImageFrame *dst_frame, unsigned times)
+{
+	using namespace zimg::colorspace;
+
+	zimg::X86Capabilities caps = zimg::query_x86_capabilities();
+	if (!caps.avx2 || !caps.f16c || !caps.fma)
+		throw std::runtime_error{ "AVX2 not available" };
+
+	TransferFunction func = select_transfer_function(transfer, peak_luminance, false);
+	OperationParams params;
+	params.set_peak_luminance(peak_luminance)
+		.set_approximate_gamma(true);
+
+	struct {
+		const char *name;
+		std::unique_ptr<Operation> op;
+	} cases[] = {
+		{ "tolinear lut", create_inverse_gamma_lut_operation_avx2(func, params) },
+		{ "tolinear polynomial", create_inverse_gamma_polynomial_operation_avx2(func, params) },
+		{ "togamma lut", create_gamma_lut_operation_avx2(func, params) },
+		{ "togamma polynomial", create_gamma_polynomial_operation_avx2(func, params) },
+	};
+
+	for (const auto &c : cases) {
+		if (!c.op) {
+			std::cout << c.name << ": not available\n";
+			continue;
+		}
+
+		auto results = measure_benchmark(times, [&]()
+		{
+			for (unsigned i = 0; i < src_frame->height(); ++i) {
+				const float *src[3];
+				float *dst[3];
+
+				for (unsigned p = 0; p < 3; ++p) {
+					src[p] = src_frame->as_buffer(p).get_line<float>(i);
+					dst[p] = dst_frame->as_buffer(p).get_line<float>(i);
+				}
+
+				c.op->process(src, dst, 0, src_frame->width());
+			}
+		});
+
+		std::cout << c.name << ": avg " << ns_per_sample(*src_frame, results.first) << " ns/sample, "
+		          << "min " << ns_per_sample(*src_frame, results.second) << " ns/sample\n";
+	}
+}
+#endif // ZIMG_X86
+
 
 struct Arguments {
 	const char *inpath;
@@ -74,6 +133,7 @@ struct Arguments {
 	char scene_referred;
 	char chromatic_adaptation;
 	const char *visualise_path;
+	char bench_transfer;
 	unsigned times;
 	zimg::CPUClass cpu;
 };
@@ -88,6 +148,7 @@ const ArgparseOption program_switches[] = {
 	{ OPTION_FLAG,   "s",     "scene-referred",       offsetof(Arguments, scene_referred),       nullptr, "use scene-referred transfer functions" },
 	{ OPTION_FLAG,   "c",     "chromatic-adaptation", offsetof(Arguments, chromatic_adaptation), nullptr, "use chromatic adaptation" },
 	{ OPTION_STRING, nullptr, "visualise",            offsetof(Arguments, visualise_path),       nullptr, "path to BMP file for visualisation" },
+	{ OPTION_FLAG,   nullptr, "bench-transfer",       offsetof(Arguments, bench_transfer),       nullptr, "benchmark AVX2 LUT and polynomial transfer functions of input" },
 	{ OPTION_UINT,   nullptr, "times",                offsetof(Arguments, times),                nullptr, "number of benchmark cycles" },
 	{ OPTION_USER1,  nullptr, "cpu",                  offsetof(Arguments, cpu),                  arg_decode_cpu, "select CPU type" },
 	{ OPTION_NULL }
@@ -135,6 +196,15 @@ int colorspace_main(int argc, char **argv)
 		if (src_frame.is_yuv() != yuv_in)
 			std::cerr << "warning: input file is of different color family than declared format\n";
 
+		if (args.bench_transfer) {
+#if defined(ZIMG_X86)
+			bench_transfer(args.csp_in.transfer, std::isnan(args.peak_luminance) ? 100.0 : args.peak_luminance, &src_frame, &dst_frame, args.times);
+			return 0;
+#else
+			throw std::runtime_error{ "transfer benchmark requires x86" };
+#endif
+		}
+
 		zimg::colorspace::ColorspaceConversion conv{ src_frame.width(), src_frame.height() };
 		conv.set_csp_in(args.csp_in)
 			.set_csp_out(args.csp_out)
@@ -1,7 +1,9 @@
 #include <atomic>
+#include <cstdint>
 #include <cstdio>
 #include <fstream>
 #include <exception>
+#include <iomanip>
 #include <iostream>
 #include <mutex>
 #include <streambuf>
@@ -13,6 +15,7 @@
 #include "depth/depth.h"
 #include "graph/filtergraph.h"
 #include "graph/graphbuilder.h"
+#include "graph/profile.h"
 #include "resize/filter.h"
 #include "resize/resize.h"
 #include "unresize/unresize.h"
@@ -297,48 +300,67 @@ void read_graph_params(zimg::graph::GraphBuilder::params *params, const JsonObje
 		params->cpu = lookup(g_cpu_table, val);
 }
 
-std::unique_ptr<zimg::graph::FilterGraph> create_graph(const json::Object &spec,
-                                                       zimg::graph::GraphBuilder::state *src_state_out,
-                                                       zimg::graph::GraphBuilder::state *dst_state_out,
-                                                       zimg::CPUClass cpu)
-{
-	zimg::graph::GraphBuilder::state src_state{};
-	zimg::graph::GraphBuilder::state dst_state{};
-	zimg::graph::GraphBuilder::params params{};
-	TracingObserver observer;
-	bool has_params = false;
-
+struct GraphSpec {
+	zimg::graph::GraphBuilder::state src_state;
+	zimg::graph::GraphBuilder::state dst_state;
+	zimg::graph::GraphBuilder::params params;
 	std::unique_ptr<zimg::resize::Filter> filters[2];
+	bool has_params;
+};
+
+void read_graph(GraphSpec *out, const json::Object &spec, zimg::CPUClass cpu, bool profile)
+{
 	JsonObject spec_obj{ spec, "root" };
 
 	try {
-		read_graph_state(&src_state, spec_obj.at("source").object());
+		read_graph_state(&out->src_state, spec_obj.at("source").object());
 
-		dst_state = src_state;
-		read_graph_state(&dst_state, spec_obj.at("target").object());
+		out->dst_state = out->src_state;
+		read_graph_state(&out->dst_state, spec_obj.at("target").object());
 
 		if (const auto &val = spec_obj["params"]) {
-			read_graph_params(&params, val.object(), filters);
-			has_params = true;
+			read_graph_params(&out->params, val.object(), out->filters);
+			out->has_params = true;
 		}
 
 		if (cpu >= static_cast<zimg::CPUClass>(0))
-			params.cpu = cpu;
+			out->params.cpu = cpu;
+		if (profile) {
+			out->params.profile = true;
+			out->has_params = true;
+		}
 	} catch (const std::invalid_argument &e) {
 		throw std::runtime_error{ e.what() };
 	} catch (const std::out_of_range &e) {
 		throw std::runtime_error{ e.what() };
 	}
+}
 
-	*src_state_out = src_state;
-	*dst_state_out = dst_state;
-
+std::unique_ptr<zimg::graph::FilterGraph> build_graph(const GraphSpec &spec, zimg::graph::FilterObserver *observer)
+{
 	zimg::graph::GraphBuilder builder;
-	return builder.set_source(src_state)
-		.connect(dst_state, has_params ? &params : nullptr, &observer)
+	return builder.set_source(spec.src_state)
+		.connect(spec.dst_state, spec.has_params ? &spec.params : nullptr, observer)
 		.build_graph();
 }
 
+std::unique_ptr<zimg::graph::FilterGraph> create_graph(const json::Object &spec,
+                                                       zimg::graph::GraphBuilder::state *src_state_out,
+                                                       zimg::graph::GraphBuilder::state *dst_state_out,
+                                                       zimg::CPUClass cpu,
+                                                       bool profile)
+{
+	GraphSpec graph_spec{};
+	TracingObserver observer;
+
+	read_graph(&graph_spec, spec, cpu, profile);
+
+	*src_state_out = graph_spec.src_state;
+	*dst_state_out = graph_spec.dst_state;
+
+	return build_graph(graph_spec, &observer);
+}
+
 ImageFrame allocate_frame(const zimg::graph::GraphBuilder::state &state)
 {
 	return{
@@ -376,11 +398,41 @@ void thread_target(const zimg::graph::FilterGraph *graph,
 	}
 }
 
-void execute(const json::Object &spec, unsigned times, unsigned threads, unsigned tile_width, zimg::CPUClass cpu)
+void print_profile(const zimg::graph::GraphProfile &profile)
+{
+	uint64_t total = 0;
+
+	for (size_t i = 0; i < profile.size(); ++i) {
+		total += profile[i].nanoseconds;
+	}
+
+	std::cout << '\n';
+	std::cout << std::left << std::setw(40) << "filter" << std::right
+	          << std::setw(12) << "size" << std::setw(10) << "calls" << std::setw(12) << "rows"
+	          << std::setw(14) << "pixels" << std::setw(12) << "time (ms)" << std::setw(10) << "ns/pixel" << std::setw(8) << "%" << '\n';
+
+	for (size_t i = 0; i < profile.size(); ++i) {
+		const zimg::graph::FilterProfile &entry = profile[i];
+		uint64_t pixels = entry.pixels;
+		uint64_t nanoseconds = entry.nanoseconds;
+		std::string size = std::to_string(entry.width) + 'x' + std::to_string(entry.height);
+
+		std::cout << std::left << std::setw(40) << entry.name << std::right
+		          << std::setw(12) << size << std::setw(10) << entry.calls << std::setw(12) << entry.rows
+		          << std::setw(14) << pixels << std::fixed << std::setprecision(3)
+		          << std::setw(12) << nanoseconds / 1e6
+		          << std::setw(10) << (pixels ? static_cast<double>(nanoseconds) / pixels : 0.0)
+		          << std::setprecision(1)
+		          << std::setw(8) << (total ? 100.0 * nanoseconds / total : 0.0) << '\n';
+		std::cout.unsetf(std::ios_base::floatfield);
+	}
+}
+
+void execute(const json::Object &spec, unsigned times, unsigned threads, unsigned tile_width, zimg::CPUClass cpu, bool profile)
 {
 	zimg::graph::GraphBuilder::state src_state;
 	zimg::graph::GraphBuilder::state dst_state;
-	std::unique_ptr<zimg::graph::FilterGraph> graph = create_graph(spec, &src_state, &dst_state, cpu);
+	std::unique_ptr<zimg::graph::FilterGraph> graph = create_graph(spec, &src_state, &dst_state, cpu, profile);
 
 	if (tile_width)
 		graph->set_tile_width(tile_width);
@@ -424,6 +476,29 @@ void execute(const json::Object &spec, unsigned times, unsigned threads, unsigne
 		std::cout << "iterations: " << times * n << '\n';
 		std::cout << "fps:        " << (times * n) / timer.elapsed() << '\n';
 	}
+
+	if (profile)
+		print_profile(*graph->get_profile());
+}
+
+
+void execute_buildbench(const json::Object &spec, unsigned times, zimg::CPUClass cpu)
+{
+	GraphSpec graph_spec{};
+	Timer timer;
+
+	read_graph(&graph_spec, spec, cpu, false);
+
+	// The first build also fills process-wide caches.
+	timer.start();
+	build_graph(graph_spec, nullptr);
+	timer.stop();
+
+	auto results = measure_benchmark(times, [&]() { build_graph(graph_spec, nullptr); }, [](unsigned, double) {});
+
+	std::cout << "first: " << timer.elapsed() * 1e6 << " us\n";
+	std::cout << "avg:   " << results.first * 1e6 << " us\n";
+	std::cout << "min:   " << results.second * 1e6 << " us\n";
 }
 
 
@@ -433,6 +508,7 @@ struct Arguments {
 	unsigned threads;
 	unsigned tile_width;
 	zimg::CPUClass cpu;
+	char profile;
 };
 
 const ArgparseOption program_switches[] = {
@@ -440,6 +516,7 @@ const ArgparseOption program_switches[] = {
 	{ OPTION_UINT,  nullptr, "threads",    offsetof(Arguments, threads),    nullptr, "number of threads" },
 	{ OPTION_UINT,  nullptr, "tile-width", offsetof(Arguments, tile_width), nullptr, "graph tile width" },
 	{ OPTION_USER1, nullptr, "cpu",        offsetof(Arguments, cpu),        arg_decode_cpu, "select CPU type" },
+	{ OPTION_FLAG,  nullptr, "profile",    offsetof(Arguments, profile),    nullptr, "print time spent in each filter" },
 	{ OPTION_NULL }
 };
 
@@ -450,6 +527,26 @@ const ArgparseOption program_positional[] = {
 
 const ArgparseCommandLine program_def = { program_switches, program_positional, "graph", "benchmark filter graph", };
 
+
+struct BuildbenchArguments {
+	const char *specpath;
+	unsigned times;
+	zimg::CPUClass cpu;
+};
+
+const ArgparseOption buildbench_switches[] = {
+	{ OPTION_UINT,  nullptr, "times", offsetof(BuildbenchArguments, times), nullptr, "number of graphs to build" },
+	{ OPTION_USER1, nullptr, "cpu",   offsetof(BuildbenchArguments, cpu),   arg_decode_cpu, "select CPU type" },
+	{ OPTION_NULL }
+};
+
+const ArgparseOption buildbench_positional[] = {
+	{ OPTION_STRING, nullptr, "specpath", offsetof(BuildbenchArguments, specpath), nullptr, "graph specification file" },
+	{ OPTION_NULL }
+};
+
+const ArgparseCommandLine buildbench_def = { buildbench_switches, buildbench_positional, "buildbench", "benchmark filter graph construction", };
+
 } // namespace
 
 
@@ -466,7 +563,32 @@ int graph_main(int argc, char **argv)
 
 	try {
 		json::Object spec = read_graph_spec(args.specpath);
-		execute(spec, args.times, args.threads, args.tile_width, args.cpu);
+		execute(spec, args.times, args.threads, args.tile_width, args.cpu, !!args.profile);
+	} catch (const zimg::error::Exception &e) {
+		std::cerr << e.what() << '\n';
+		return 2;
+	} catch (const std::exception &e) {
+		std::cerr << e.what() << '\n';
+		return 2;
+	}
+
+	return 0;
+}
+
+int buildbench_main(int argc, char **argv)
+{
+	BuildbenchArguments args{};
+	int ret;
+
+	args.times = 1000;
+	args.cpu = static_cast<zimg::CPUClass>(-1);
+
+	if ((ret = argparse_parse(&buildbench_def, &args, argc, argv)) < 0)
+		return ret == ARGPARSE_HELP_MESSAGE ? 0 : ret;
+
+	try {
+		json::Object spec = read_graph_spec(args.specpath);
+		execute_buildbench(spec, args.times, args.cpu);
 	} catch (const zimg::error::Exception &e) {
 		std::cerr << e.what() << '\n';
 		return 2;
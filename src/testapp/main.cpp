@@ -14,22 +14,26 @@ typedef int (*main_func)(int, char **);
 void usage()
 {
 	std::cout << "testapp subapp [args]\n";
+	std::cout << "    buildbench - benchmark graph construction\n";
 	std::cout << "    colorspace - change colorspace\n";
 	std::cout << "    cpuinfo    - show CPU information\n";
 	std::cout << "    depth      - change depth\n";
 	std::cout << "    graph      - benchmark filter graph\n";
 	std::cout << "    graph2     - benchmark filter graph\n";
+	std::cout << "    premul     - benchmark alpha premultiplication\n";
 	std::cout << "    resize     - resize images\n";
 	std::cout << "    unresize   - unresize images\n";
 }
 
 main_func lookup_app(const char *name)
 {
-	static const zimg::static_string_map<main_func, 7> map{
+	static const zimg::static_string_map<main_func, 8> map{
+		{ "buildbench", buildbench_main },
 		{ "colorspace", colorspace_main },
 		{ "cpuinfo",    cpuinfo_main },
 		{ "depth",      depth_main },
 		{ "graph",     graph_main },
+		{ "premul",     premultiply_main },
 		{ "resize",     resize_main },
 		{ "unresize",   unresize_main }
 	};
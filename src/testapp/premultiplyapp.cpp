@@ -0,0 +1,138 @@
+#include <iostream>
+#include <memory>
+#include <random>
+#include "common/alloc.h"
+#include "common/cpuinfo.h"
+#include "common/except.h"
+#include "common/pixel.h"
+#include "graph/simple_filters.h"
+#include "graphengine/filter.h"
+#include "graphengine/graph.h"
+
+#include "apps.h"
+#include "argparse.h"
+#include "frame.h"
+#include "timer.h"
+
+namespace {
+
+// Fills all planes with [0, 1), making every 16th pixel fully transparent.
+void fill_frame(ImageFrame &frame)
+{
+	std::mt19937 engine;
+	std::uniform_real_distribution<float> dist{ 0.0f, 1.0f };
+
+	for (unsigned p = 0; p < frame.planes(); ++p) {
+		graphengine::BufferDescriptor buf = frame.as_buffer(p);
+
+		for (unsigned i = 0; i < frame.height(p); ++i) {
+			float *row = buf.get_line<float>(i);
+
+			for (unsigned j = 0; j < frame.width(p); ++j) {
+				row[j] = p == 3 && j % 16 == 0 ? 0.0f : dist(engine);
+			}
+		}
+	}
+}
+
+// Applies |filter| to the color planes of an RGBA frame, with alpha as the second input.
+void execute(const graphengine::Filter *filter, const ImageFrame &src_frame, ImageFrame &dst_frame, unsigned times)
+{
+	graphengine::GraphImpl graph;
+	graphengine::PlaneDescriptor desc[4];
+
+	for (unsigned p = 0; p < 4; ++p) {
+		desc[p] = { src_frame.width(), src_frame.height(), sizeof(float) };
+	}
+
+	graphengine::node_id src_id = graph.add_source(4, desc);
+	graphengine::node_dep_desc ids[4];
+
+	for (unsigned p = 0; p < 3; ++p) {
+		graphengine::node_dep_desc deps[2] = { { src_id, p }, { src_id, 3 } };
+		ids[p] = { graph.add_transform(filter, deps), 0 };
+	}
+	ids[3] = { src_id, 3 };
+
+	graphengine::node_id sink_id = graph.add_sink(4, ids);
+
+	auto src_buffer = src_frame.as_buffer();
+	auto dst_buffer = dst_frame.as_buffer();
+	graphengine::Graph::Endpoint endpoints[2] = { { src_id, src_buffer.data() }, { sink_id, dst_buffer.data() } };
+	zimg::AlignedVector<unsigned char> tmp(graph.get_tmp_size(false));
+
+	auto results = measure_benchmark(times, [&]() { graph.run(endpoints, tmp.data()); }, [](unsigned n, double d)
+	{
+		std::cout << '#' << n << ": " << d << '\n';
+	});
+
+	double samples = static_cast<double>(static_cast<size_t>(src_frame.width()) * src_frame.height() * 3);
+	std::cout << "avg: " << results.first << " (" << results.first * 1e9 / samples << " ns/sample)\n";
+	std::cout << "min: " << results.second << " (" << results.second * 1e9 / samples << " ns/sample)\n";
+}
+
+
+struct Arguments {
+	unsigned width;
+	unsigned height;
+	char unpremultiply;
+	unsigned times;
+	zimg::CPUClass cpu;
+};
+
+const ArgparseOption program_switches[] = {
+	{ OPTION_UINT,  "w",     "width",         offsetof(Arguments, width),         nullptr, "image width" },
+	{ OPTION_UINT,  "h",     "height",        offsetof(Arguments, height),        nullptr, "image height" },
+	{ OPTION_FLAG,  nullptr, "unpremultiply", offsetof(Arguments, unpremultiply), nullptr, "benchmark unpremultiplication" },
+	{ OPTION_UINT,  nullptr, "times",         offsetof(Arguments, times),         nullptr, "number of benchmark cycles" },
+	{ OPTION_USER1, nullptr, "cpu",           offsetof(Arguments, cpu),           arg_decode_cpu, "select CPU type" },
+	{ OPTION_NULL }
+};
+
+const ArgparseOption program_positional[] = {
+	{ OPTION_NULL }
+};
+
+const ArgparseCommandLine program_def = { program_switches, program_positional, "premul", "benchmark alpha premultiplication of an RGBA float image", };
+
+} // namespace
+
+
+int premultiply_main(int argc, char **argv)
+{
+	Arguments args{};
+	int ret;
+
+	args.width = 1920;
+	args.height = 1080;
+	args.times = 100;
+	args.cpu = zimg::CPUClass::AUTO;
+
+	if ((ret = argparse_parse(&program_def, &args, argc, argv)) < 0)
+		return ret == ARGPARSE_HELP_MESSAGE ? 0 : ret;
+
+	try {
+		ImageFrame src_frame{ args.width, args.height, zimg::PixelType::FLOAT, 4 };
+		ImageFrame dst_frame{ args.width, args.height, zimg::PixelType::FLOAT, 4 };
+		fill_frame(src_frame);
+
+		std::unique_ptr<graphengine::Filter> filter;
+		if (args.unpremultiply)
+			filter = std::make_unique<zimg::graph::UnpremultiplyFilter>(args.width, args.height, args.cpu);
+		else
+			filter = std::make_unique<zimg::graph::PremultiplyFilter>(args.width, args.height, args.cpu);
+
+		execute(filter.get(), src_frame, dst_frame, args.times);
+	} catch (const graphengine::Exception &e) {
+		std::cerr << e.msg << '\n';
+		return 2;
+	} catch (const zimg::error::Exception &e) {
+		std::cerr << e.what() << '\n';
+		return 2;
+	} catch (const std::exception &e) {
+		std::cerr << e.what() << '\n';
+		return 2;
+	}
+
+	return 0;
+}
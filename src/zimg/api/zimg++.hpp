@@ -140,6 +140,43 @@ struct zfilter_graph_builder_params : zimg_graph_builder_params {
 	}
 };
 
+class FilterGraphStream {
+	zimg_filter_graph_stream *m_stream;
+
+	FilterGraphStream(const FilterGraphStream &);
+
+	FilterGraphStream &operator=(const FilterGraphStream &);
+
+	void check(zimg_error_code_e err) const
+	{
+		if (err)
+			throw zerror();
+	}
+public:
+	explicit FilterGraphStream(zimg_filter_graph_stream *stream) : m_stream(stream)
+	{
+	}
+
+	~FilterGraphStream()
+	{
+		zimg_filter_graph_stream_end(m_stream);
+	}
+
+	unsigned push_rows(const zimg_image_buffer_const &src, unsigned num_rows)
+	{
+		unsigned ret;
+		check(zimg_filter_graph_stream_push_rows(m_stream, &src, num_rows, &ret));
+		return ret;
+	}
+
+	unsigned pull_rows(const zimg_image_buffer &dst, unsigned num_rows)
+	{
+		unsigned ret;
+		check(zimg_filter_graph_stream_pull_rows(m_stream, &dst, num_rows, &ret));
+		return ret;
+	}
+};
+
 class FilterGraph {
 	zimg_filter_graph *m_graph;
 
@@ -217,6 +254,50 @@ public:
 		check(zimg_filter_graph_process(m_graph, &src, &dst, tmp, unpack_cb, unpack_user, pack_cb, pack_user));
 	}
 
+	void process_multi(const zimg_image_buffer_const &src, const zimg_image_buffer dst[], void *tmp,
+	                   zimg_filter_graph_callback unpack_cb = 0, void *unpack_user = 0,
+	                   const zimg_filter_graph_callback pack_cb[] = 0, void * const pack_user[] = 0) const
+	{
+		check(zimg_filter_graph_process_multi(m_graph, &src, dst, tmp, unpack_cb, unpack_user, pack_cb, pack_user));
+	}
+
+	size_t get_tmp_size_mt(unsigned num_bands) const
+	{
+		size_t ret;
+		check(zimg_filter_graph_get_tmp_size_mt(m_graph, num_bands, &ret));
+		return ret;
+	}
+
+	void process_mt(const zimg_image_buffer_const &src, const zimg_image_buffer &dst, void *tmp, unsigned num_bands,
+	                zimg_thread_pool_callback pool_cb, void *pool_user,
+	                zimg_filter_graph_callback unpack_cb = 0, void *unpack_user = 0,
+	                zimg_filter_graph_callback pack_cb = 0, void *pack_user = 0) const
+	{
+		check(zimg_filter_graph_process_mt(m_graph, &src, &dst, tmp, num_bands, unpack_cb, unpack_user, pack_cb, pack_user, pool_cb, pool_user));
+	}
+
+	unsigned get_profile(zimg_filter_profile *profile, unsigned count) const
+	{
+		check(zimg_filter_graph_get_profile(m_graph, profile, &count));
+		return count;
+	}
+
+	size_t serialize(void *buf, size_t size) const
+	{
+		check(zimg_filter_graph_serialize(m_graph, buf, &size));
+		return size;
+	}
+
+	zimg_filter_graph_stream *begin_stream() const
+	{
+		zimg_filter_graph_stream *stream;
+
+		if (!(stream = zimg_filter_graph_stream_begin(m_graph)))
+			throw zerror();
+
+		return stream;
+	}
+
 #if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
 	static FilterGraph build(const zimg_image_format &src_format, const zimg_image_format &dst_format, const zimg_graph_builder_params *params = 0)
 	{
@@ -227,6 +308,37 @@ public:
 
 		return FilterGraph(graph);
 	}
+
+	static FilterGraph build_multi(const zimg_image_format &src_format, const zimg_image_format dst_formats[], unsigned num_outputs,
+	                               const zimg_graph_builder_params *params = 0)
+	{
+		zimg_filter_graph *graph;
+
+		if (!(graph = zimg_filter_graph_build_multi(&src_format, dst_formats, num_outputs, params)))
+			throw zerror();
+
+		return FilterGraph(graph);
+	}
+
+	static FilterGraph build_pyramid(const zimg_image_format &src_format, unsigned num_levels, const zimg_graph_builder_params *params = 0)
+	{
+		zimg_filter_graph *graph;
+
+		if (!(graph = zimg_filter_graph_build_pyramid(&src_format, num_levels, params)))
+			throw zerror();
+
+		return FilterGraph(graph);
+	}
+
+	static FilterGraph deserialize(const void *buf, size_t size)
+	{
+		zimg_filter_graph *graph;
+
+		if (!(graph = zimg_filter_graph_deserialize(buf, size)))
+			throw zerror();
+
+		return FilterGraph(graph);
+	}
 #else
 	static zimg_filter_graph *build(const zimg_image_format &src_format, const zimg_image_format &dst_format, const zimg_graph_builder_params *params = 0)
 	{
@@ -237,6 +349,37 @@ public:
 
 		return graph;
 	}
+
+	static zimg_filter_graph *build_multi(const zimg_image_format &src_format, const zimg_image_format dst_formats[], unsigned num_outputs,
+	                                      const zimg_graph_builder_params *params = 0)
+	{
+		zimg_filter_graph *graph;
+
+		if (!(graph = zimg_filter_graph_build_multi(&src_format, dst_formats, num_outputs, params)))
+			throw zerror();
+
+		return graph;
+	}
+
+	static zimg_filter_graph *build_pyramid(const zimg_image_format &src_format, unsigned num_levels, const zimg_graph_builder_params *params = 0)
+	{
+		zimg_filter_graph *graph;
+
+		if (!(graph = zimg_filter_graph_build_pyramid(&src_format, num_levels, params)))
+			throw zerror();
+
+		return graph;
+	}
+
+	static zimg_filter_graph *deserialize(const void *buf, size_t size)
+	{
+		zimg_filter_graph *graph;
+
+		if (!(graph = zimg_filter_graph_deserialize(buf, size)))
+			throw zerror();
+
+		return graph;
+	}
 #endif
 };
 
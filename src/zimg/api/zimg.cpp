@@ -1,18 +1,26 @@
+#include <algorithm>
+#include <array>
 #include <climits>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <limits>
 #include <memory>
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 #include "common/cpuinfo.h"
 #include "common/except.h"
 #include "common/pixel.h"
 #include "common/static_map.h"
+#include "common/table_record.h"
 #include "common/zassert.h"
 #include "graph/filtergraph.h"
 #include "graph/graphbuilder.h"
+#include "graph/profile.h"
+#include "graph/serialize.h"
 #include "colorspace/colorspace.h"
 #include "depth/depth.h"
 #include "resize/filter.h"
@@ -27,6 +35,7 @@ constexpr unsigned API_VERSION_2_1 = ZIMG_MAKE_API_VERSION(2, 1);
 constexpr unsigned API_VERSION_2_2 = ZIMG_MAKE_API_VERSION(2, 2);
 constexpr unsigned API_VERSION_2_4 = ZIMG_MAKE_API_VERSION(2, 4);
 constexpr unsigned API_VERSION_2_5 = ZIMG_MAKE_API_VERSION(2, 5);
+constexpr unsigned API_VERSION_2_6 = ZIMG_MAKE_API_VERSION(2, 6);
 
 #define API_VERSION_ASSERT(x) zassert_d((x) >= API_VERSION_2_0, "API version invalid")
 
@@ -199,6 +208,21 @@ zimg::graph::GraphBuilder::AlphaType translate_alpha(zimg_alpha_type_e alpha)
 	return search_enum_map(map, alpha, "unrecognized alpha type");
 }
 
+zimg::graph::GraphBuilder::Layout translate_layout(zimg_plane_layout_e layout)
+{
+	using zimg::graph::GraphBuilder;
+
+	static constexpr const zimg::static_map<zimg_plane_layout_e, GraphBuilder::Layout, 6> map{
+		{ ZIMG_LAYOUT_PLANAR,     GraphBuilder::Layout::PLANAR },
+		{ ZIMG_LAYOUT_SEMIPLANAR, GraphBuilder::Layout::SEMIPLANAR },
+		{ ZIMG_LAYOUT_PACKED,     GraphBuilder::Layout::PACKED },
+		{ ZIMG_LAYOUT_PACKED_BGR, GraphBuilder::Layout::PACKED_BGR },
+		{ ZIMG_LAYOUT_YUYV,       GraphBuilder::Layout::YUYV },
+		{ ZIMG_LAYOUT_UYVY,       GraphBuilder::Layout::UYVY },
+	};
+	return search_enum_map(map, layout, "unrecognized plane layout");
+}
+
 zimg::graph::GraphBuilder::FieldParity translate_field_parity(zimg_field_parity_e field)
 {
 	using zimg::graph::GraphBuilder;
@@ -398,6 +422,8 @@ void import_graph_state_common(const zimg_image_format &src, zimg::graph::GraphB
 	}
 	if (src.version >= API_VERSION_2_4)
 		out->alpha = translate_alpha(src.alpha);
+	if (src.version >= API_VERSION_2_6)
+		out->layout = translate_layout(src.layout);
 }
 
 std::pair<zimg::graph::GraphBuilder::state, zimg::graph::GraphBuilder::state> import_graph_state(const zimg_image_format &src, const zimg_image_format &dst)
@@ -459,10 +485,221 @@ zimg::graph::GraphBuilder::params import_graph_params(const zimg_graph_builder_p
 		params.scene_referred = !!src.scene_referred;
 		params.chromatic_adaptation = !!src.chromatic_adaptation;
 	}
+	if (src.version >= API_VERSION_2_6) {
+		params.profile = !!src.enable_profiling;
+		params.colorspace_lut = !!src.allow_colorspace_lut;
+	}
 
 	return params;
 }
 
+// Arguments of a graph build call. Structures are normalized to the latest
+// API version, so that the request does not depend on the caller's version.
+struct graph_request {
+	enum class Kind : uint32_t {
+		SINGLE,
+		MULTI,
+		PYRAMID,
+	};
+
+	Kind kind;
+	zimg_image_format src_format;
+	std::vector<zimg_image_format> dst_formats;
+	unsigned num_levels;
+	bool has_params;
+	zimg_graph_builder_params params;
+};
+
+struct request_header {
+	uint32_t library_version[3];
+	uint32_t format_size;
+	uint32_t params_size;
+	uint32_t kind;
+	uint32_t num_dst_formats;
+	uint32_t num_levels;
+	uint32_t has_params;
+};
+
+zimg_image_format normalize_image_format(const zimg_image_format &src)
+{
+	API_VERSION_ASSERT(src.version);
+
+	size_t size = src.version >= API_VERSION_2_6 ? sizeof(zimg_image_format)
+		: src.version >= API_VERSION_2_4 ? offsetof(zimg_image_format, layout)
+		: src.version >= API_VERSION_2_1 ? offsetof(zimg_image_format, alpha)
+		: offsetof(zimg_image_format, active_region);
+
+	zimg_image_format ret{};
+	zimg_image_format_default(&ret, API_VERSION_2_6);
+	std::memcpy(&ret, &src, size);
+	ret.version = API_VERSION_2_6;
+	return ret;
+}
+
+zimg_graph_builder_params normalize_graph_params(const zimg_graph_builder_params &src)
+{
+	API_VERSION_ASSERT(src.version);
+
+	size_t size = src.version >= API_VERSION_2_6 ? sizeof(zimg_graph_builder_params)
+		: src.version >= API_VERSION_2_5 ? offsetof(zimg_graph_builder_params, enable_profiling)
+		: src.version >= API_VERSION_2_2 ? offsetof(zimg_graph_builder_params, scene_referred)
+		: offsetof(zimg_graph_builder_params, nominal_peak_luminance);
+
+	zimg_graph_builder_params ret{};
+	zimg_graph_builder_params_default(&ret, API_VERSION_2_6);
+	std::memcpy(&ret, &src, size);
+	ret.version = API_VERSION_2_6;
+	return ret;
+}
+
+graph_request make_graph_request(graph_request::Kind kind, const zimg_image_format &src_format, const zimg_image_format *dst_formats, unsigned num_dst_formats,
+                                 unsigned num_levels, const zimg_graph_builder_params *params)
+{
+	graph_request request{ kind, normalize_image_format(src_format), {}, num_levels, !!params, {} };
+
+	for (unsigned i = 0; i < num_dst_formats; ++i) {
+		zassert_d(src_format.version == dst_formats[i].version, "image format versions do not match");
+		request.dst_formats.push_back(normalize_image_format(dst_formats[i]));
+	}
+	if (params)
+		request.params = normalize_graph_params(*params);
+
+	return request;
+}
+
+std::vector<unsigned char> encode_graph_request(const graph_request &request)
+{
+	request_header header{
+		{ VERSION_INFO[0], VERSION_INFO[1], VERSION_INFO[2] },
+		sizeof(zimg_image_format),
+		sizeof(zimg_graph_builder_params),
+		static_cast<uint32_t>(request.kind),
+		static_cast<uint32_t>(request.dst_formats.size()),
+		request.num_levels,
+		request.has_params,
+	};
+
+	std::vector<unsigned char> ret(sizeof(header) + sizeof(zimg_image_format) * (request.dst_formats.size() + 1) + sizeof(zimg_graph_builder_params));
+	unsigned char *p = ret.data();
+
+	std::memcpy(p, &header, sizeof(header));
+	p += sizeof(header);
+	std::memcpy(p, &request.src_format, sizeof(zimg_image_format));
+	p += sizeof(zimg_image_format);
+	std::memcpy(p, request.dst_formats.data(), sizeof(zimg_image_format) * request.dst_formats.size());
+	p += sizeof(zimg_image_format) * request.dst_formats.size();
+	std::memcpy(p, &request.params, sizeof(zimg_graph_builder_params));
+
+	return ret;
+}
+
+graph_request decode_graph_request(const std::vector<unsigned char> &data)
+{
+	request_header header;
+
+	if (data.size() < sizeof(header))
+		zimg::error::throw_<zimg::error::IllegalArgument>("invalid graph blob");
+
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	if (!std::equal(std::begin(VERSION_INFO), std::end(VERSION_INFO), header.library_version))
+		zimg::error::throw_<zimg::error::UnsupportedOperation>("graph blob was created by a different library version");
+	if (header.format_size != sizeof(zimg_image_format) || header.params_size != sizeof(zimg_graph_builder_params))
+		zimg::error::throw_<zimg::error::IllegalArgument>("invalid graph blob");
+	if (header.kind > static_cast<uint32_t>(graph_request::Kind::PYRAMID))
+		zimg::error::throw_<zimg::error::IllegalArgument>("invalid graph blob");
+	if (header.num_dst_formats > (data.size() - sizeof(header)) / sizeof(zimg_image_format) ||
+	    data.size() != sizeof(header) + sizeof(zimg_image_format) * (header.num_dst_formats + 1) + sizeof(zimg_graph_builder_params))
+		zimg::error::throw_<zimg::error::IllegalArgument>("invalid graph blob");
+
+	graph_request request{ static_cast<graph_request::Kind>(header.kind), {}, std::vector<zimg_image_format>(header.num_dst_formats), header.num_levels, !!header.has_params, {} };
+	const unsigned char *p = data.data() + sizeof(header);
+
+	std::memcpy(&request.src_format, p, sizeof(zimg_image_format));
+	p += sizeof(zimg_image_format);
+	std::memcpy(request.dst_formats.data(), p, sizeof(zimg_image_format) * request.dst_formats.size());
+	p += sizeof(zimg_image_format) * request.dst_formats.size();
+	std::memcpy(&request.params, p, sizeof(zimg_graph_builder_params));
+
+	if (request.src_format.version != API_VERSION_2_6 || (request.has_params && request.params.version != API_VERSION_2_6) ||
+	    std::any_of(request.dst_formats.begin(), request.dst_formats.end(), [](const zimg_image_format &f) { return f.version != API_VERSION_2_6; }))
+	{
+		zimg::error::throw_<zimg::error::IllegalArgument>("invalid graph blob");
+	}
+
+	return request;
+}
+
+zimg::CPUClass graph_request_cpu(const graph_request &request)
+{
+	return request.has_params ? translate_cpu(request.params.cpu_type) : zimg::CPUClass::AUTO;
+}
+
+std::unique_ptr<zimg::graph::FilterGraph> build_graph(const graph_request &request)
+{
+	zimg::graph::GraphBuilder::state src_state;
+	std::vector<zimg::graph::GraphBuilder::state> dst_states(request.dst_formats.size());
+	zimg::graph::GraphBuilder::params graph_params;
+
+	std::unique_ptr<zimg::resize::Filter> filters[2];
+
+	if (request.kind == graph_request::Kind::PYRAMID) {
+		std::tie(src_state, std::ignore) = import_graph_state(request.src_format, request.src_format);
+	} else {
+		for (size_t i = 0; i < request.dst_formats.size(); ++i) {
+			zimg::graph::GraphBuilder::state state;
+			std::tie(state, dst_states[i]) = import_graph_state(request.src_format, request.dst_formats[i]);
+
+			if (i && state.colorspace != src_state.colorspace)
+				zimg::error::throw_<zimg::error::NoColorspaceConversion>("inconsistent source colorspace");
+
+			src_state = state;
+		}
+	}
+	if (request.has_params)
+		graph_params = import_graph_params(request.params, filters);
+
+	const zimg::graph::GraphBuilder::params *params_ptr = request.has_params ? &graph_params : nullptr;
+
+	zimg::graph::GraphBuilder builder;
+	builder.set_source(src_state);
+
+	switch (request.kind) {
+	case graph_request::Kind::SINGLE:
+		zassert_d(dst_states.size() == 1, "wrong number of outputs");
+		return builder.connect(dst_states[0], params_ptr).build_graph();
+	case graph_request::Kind::MULTI:
+		return builder.build_multi_graph(dst_states.data(), static_cast<unsigned>(dst_states.size()), params_ptr);
+	case graph_request::Kind::PYRAMID:
+		return builder.build_pyramid(request.num_levels, params_ptr);
+	}
+
+	zimg::error::throw_<zimg::error::InternalError>("invalid graph request");
+}
+
+zimg_filter_graph *build_graph_from_api(const graph_request &request)
+{
+	zimg::TableRecord tables;
+	std::unique_ptr<zimg::graph::FilterGraph> graph;
+	{
+		zimg::TableRecordScope scope{ &tables };
+		graph = build_graph(request);
+	}
+	graph->set_build_request(encode_graph_request(request), std::move(tables));
+	return graph.release();
+}
+
+std::vector<unsigned char> serialize_graph(const zimg::graph::FilterGraph &graph)
+{
+	const std::vector<unsigned char> &request_data = graph.get_build_request();
+	if (request_data.empty())
+		zimg::error::throw_<zimg::error::UnsupportedOperation>("graph can not be serialized");
+
+	graph_request request = decode_graph_request(request_data);
+	zimg::graph::GraphBlob blob{ zimg::cpu_resolve(graph_request_cpu(request)), request_data, graph.get_build_tables() };
+	return zimg::graph::write_graph_blob(blob);
+}
+
 } // namespace
 
 
@@ -589,6 +826,121 @@ zimg_error_code_e zimg_filter_graph_process(const zimg_filter_graph *ptr, const
 	EX_END
 }
 
+zimg_error_code_e zimg_filter_graph_process_multi(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer dst[], void *tmp,
+                                                   zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                                   const zimg_filter_graph_callback pack_cb[], void * const pack_user[])
+{
+	zassert_d(ptr, "null pointer");
+	zassert_d(src, "null pointer");
+	zassert_d(dst, "null pointer");
+
+	EX_BEGIN
+	const zimg::graph::FilterGraph *graph = assert_dynamic_type<const zimg::graph::FilterGraph>(ptr);
+	auto src_buf = import_image_buffer(*src);
+	std::vector<std::array<graphengine::BufferDescriptor, 4>> dst_buf;
+
+	for (unsigned i = 0; i < graph->get_num_outputs(); ++i) {
+		dst_buf.push_back(import_image_buffer(dst[i]));
+		graph->check_alignment(src_buf, dst_buf.back());
+	}
+	graph->process_multi(src_buf, dst_buf.data(), tmp, unpack_cb, unpack_user, pack_cb, pack_user);
+	EX_END
+}
+
+zimg_error_code_e zimg_filter_graph_get_tmp_size_mt(const zimg_filter_graph *ptr, unsigned num_bands, size_t *out)
+{
+	zassert_d(ptr, "null pointer");
+	zassert_d(out, "null pointer");
+
+	EX_BEGIN
+	*out = assert_dynamic_type<const zimg::graph::FilterGraph>(ptr)->get_tmp_size_mt(num_bands);
+	EX_END
+}
+
+zimg_error_code_e zimg_filter_graph_process_mt(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
+                                                unsigned num_bands,
+                                                zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                                zimg_filter_graph_callback pack_cb, void *pack_user,
+                                                zimg_thread_pool_callback pool_cb, void *pool_user)
+{
+	zassert_d(ptr, "null pointer");
+	zassert_d(src, "null pointer");
+	zassert_d(dst, "null pointer");
+
+	EX_BEGIN
+	auto src_buf = import_image_buffer(*src);
+	auto dst_buf = import_image_buffer(*dst);
+	assert_dynamic_type<const zimg::graph::FilterGraph>(ptr)
+		->check_alignment(src_buf, dst_buf)
+		->process_mt(src_buf, dst_buf, tmp, num_bands, unpack_cb, unpack_user, pack_cb, pack_user, pool_cb, pool_user);
+	EX_END
+}
+
+zimg_error_code_e zimg_filter_graph_get_profile(const zimg_filter_graph *ptr, zimg_filter_profile *profile, unsigned *count)
+{
+	zassert_d(ptr, "null pointer");
+	zassert_d(count, "null pointer");
+
+	EX_BEGIN
+	const zimg::graph::GraphProfile *graph_profile = assert_dynamic_type<const zimg::graph::FilterGraph>(ptr)->get_profile();
+	unsigned num_entries = graph_profile ? static_cast<unsigned>(graph_profile->size()) : 0;
+
+	if (profile) {
+		for (unsigned i = 0; i < std::min(*count, num_entries); ++i) {
+			const zimg::graph::FilterProfile &entry = (*graph_profile)[i];
+
+			profile[i].name = entry.name.c_str();
+			profile[i].width = entry.width;
+			profile[i].height = entry.height;
+			profile[i].calls = entry.calls;
+			profile[i].rows = entry.rows;
+			profile[i].pixels = entry.pixels;
+			profile[i].seconds = static_cast<double>(entry.nanoseconds) / 1e9;
+		}
+	}
+	*count = num_entries;
+	EX_END
+}
+
+zimg_error_code_e zimg_filter_graph_serialize(const zimg_filter_graph *ptr, void *buf, size_t *size)
+{
+	zassert_d(ptr, "null pointer");
+	zassert_d(size, "null pointer");
+
+	EX_BEGIN
+	std::vector<unsigned char> blob = serialize_graph(*assert_dynamic_type<const zimg::graph::FilterGraph>(ptr));
+
+	if (buf) {
+		if (*size < blob.size())
+			zimg::error::throw_<zimg::error::IllegalArgument>("buffer too small");
+		std::memcpy(buf, blob.data(), blob.size());
+	}
+	*size = blob.size();
+	EX_END
+}
+
+zimg_error_code_e zimg_filter_graph_stream_push_rows(zimg_filter_graph_stream *ptr, const zimg_image_buffer_const *src, unsigned num_rows, unsigned *num_accepted)
+{
+	zassert_d(ptr, "null pointer");
+	zassert_d(src, "null pointer");
+	zassert_d(num_accepted, "null pointer");
+
+	EX_BEGIN
+	*num_accepted = assert_dynamic_type<zimg::graph::FilterGraphStream>(ptr)->push_rows(import_image_buffer(*src), num_rows);
+	EX_END
+}
+
+zimg_error_code_e zimg_filter_graph_stream_pull_rows(zimg_filter_graph_stream *ptr, const zimg_image_buffer *dst, unsigned num_rows, unsigned *num_returned)
+{
+	zassert_d(ptr, "null pointer");
+	zassert_d(dst, "null pointer");
+	zassert_d(num_returned, "null pointer");
+
+	EX_BEGIN
+	*num_returned = assert_dynamic_type<zimg::graph::FilterGraphStream>(ptr)->pull_rows(import_image_buffer(*dst), num_rows);
+	EX_END
+}
+
 #undef EX_BEGIN
 #undef EX_END
 
@@ -627,6 +979,9 @@ void zimg_image_format_default(zimg_image_format *ptr, unsigned version)
 	if (version >= API_VERSION_2_4) {
 		ptr->alpha = ZIMG_ALPHA_NONE;
 	}
+	if (version >= API_VERSION_2_6) {
+		ptr->layout = ZIMG_LAYOUT_PLANAR;
+	}
 }
 
 void zimg_graph_builder_params_default(zimg_graph_builder_params *ptr, unsigned version)
@@ -657,6 +1012,10 @@ void zimg_graph_builder_params_default(zimg_graph_builder_params *ptr, unsigned
 		ptr->scene_referred = 0;
 		ptr->chromatic_adaptation = 0;
 	}
+	if (version >= API_VERSION_2_6) {
+		ptr->enable_profiling = 0;
+		ptr->allow_colorspace_lut = 0;
+	}
 }
 
 zimg_filter_graph *zimg_filter_graph_build(const zimg_image_format *src_format, const zimg_image_format *dst_format, const zimg_graph_builder_params *params)
@@ -665,27 +1024,81 @@ zimg_filter_graph *zimg_filter_graph_build(const zimg_image_format *src_format,
 	zassert_d(dst_format, "null pointer");
 
 	try {
-		zimg::graph::GraphBuilder::state src_state;
-		zimg::graph::GraphBuilder::state dst_state;
-		zimg::graph::GraphBuilder::params graph_params;
+		return build_graph_from_api(make_graph_request(graph_request::Kind::SINGLE, *src_format, dst_format, 1, 0, params));
+	} catch (...) {
+		handle_exception(std::current_exception());
+		return nullptr;
+	}
+}
 
-		std::unique_ptr<zimg::resize::Filter> filters[2];
+zimg_filter_graph *zimg_filter_graph_build_multi(const zimg_image_format *src_format, const zimg_image_format dst_formats[], unsigned num_outputs,
+                                                 const zimg_graph_builder_params *params)
+{
+	zassert_d(src_format, "null pointer");
+	zassert_d(dst_formats, "null pointer");
 
-		std::tie(src_state, dst_state) = import_graph_state(*src_format, *dst_format);
-		if (params)
-			graph_params = import_graph_params(*params, filters);
+	try {
+		return build_graph_from_api(make_graph_request(graph_request::Kind::MULTI, *src_format, dst_formats, num_outputs, 0, params));
+	} catch (...) {
+		handle_exception(std::current_exception());
+		return nullptr;
+	}
+}
 
-		zimg::graph::GraphBuilder builder;
-		return builder.set_source(src_state)
-			.connect(dst_state, params ? &graph_params : nullptr)
-			.build_graph()
-			.release();
+zimg_filter_graph *zimg_filter_graph_build_pyramid(const zimg_image_format *src_format, unsigned num_levels, const zimg_graph_builder_params *params)
+{
+	zassert_d(src_format, "null pointer");
+
+	try {
+		return build_graph_from_api(make_graph_request(graph_request::Kind::PYRAMID, *src_format, nullptr, 0, num_levels, params));
+	} catch (...) {
+		handle_exception(std::current_exception());
+		return nullptr;
+	}
+}
+
+zimg_filter_graph *zimg_filter_graph_deserialize(const void *buf, size_t size)
+{
+	zassert_d(buf, "null pointer");
+
+	try {
+		zimg::graph::GraphBlob blob = zimg::graph::read_graph_blob(buf, size);
+		graph_request request = decode_graph_request(blob.request);
+
+		// Blobs from less capable CPUs are rebuilt with the kernels they requested.
+		if (blob.cpu > zimg::cpu_resolve(zimg::CPUClass::AUTO))
+			zimg::error::throw_<zimg::error::UnsupportedOperation>("graph blob was created for an unsupported CPU");
+
+		std::unique_ptr<zimg::graph::FilterGraph> graph;
+		{
+			zimg::TableRecordScope scope{ &blob.tables };
+			graph = build_graph(request);
+		}
+		graph->set_build_request(std::move(blob.request), std::move(blob.tables));
+		return graph.release();
 	} catch (...) {
 		handle_exception(std::current_exception());
 		return nullptr;
 	}
 }
 
+zimg_filter_graph_stream *zimg_filter_graph_stream_begin(const zimg_filter_graph *ptr)
+{
+	zassert_d(ptr, "null pointer");
+
+	try {
+		return assert_dynamic_type<const zimg::graph::FilterGraph>(ptr)->begin_stream().release();
+	} catch (...) {
+		handle_exception(std::current_exception());
+		return nullptr;
+	}
+}
+
+void zimg_filter_graph_stream_end(zimg_filter_graph_stream *ptr)
+{
+	delete ptr;
+}
+
 void zimg_subgraph_free(zimg_subgraph *graph)
 {
 	delete graph;
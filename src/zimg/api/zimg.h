@@ -227,6 +227,24 @@ typedef enum zimg_alpha_type_e {
 	ZIMG_ALPHA_PREMULTIPLIED = 2  /**< Premultiplied alpha. */
 } zimg_alpha_type_e;
 
+/**
+ * Plane layout constants.
+ *
+ * Non-planar layouts store several components in one buffer plane. Samples
+ * are interleaved in units of the pixel type, so a 10-bit P010 image is
+ * described as ZIMG_PIXEL_WORD with a depth of 16.
+ *
+ * @see zimg_image_buffer_const
+ */
+typedef enum zimg_plane_layout_e {
+	ZIMG_LAYOUT_PLANAR     = 0, /**< One plane per component. */
+	ZIMG_LAYOUT_SEMIPLANAR = 1, /**< Y plane and interleaved U-V plane (NV12, P010). YUV only. */
+	ZIMG_LAYOUT_PACKED     = 2, /**< All components interleaved in plane order (RGB24, RGBA). No subsampling. */
+	ZIMG_LAYOUT_PACKED_BGR = 3, /**< As ZIMG_LAYOUT_PACKED, with the first three components reversed (BGR24, BGRA). */
+	ZIMG_LAYOUT_YUYV       = 4, /**< 4:2:2 YUV interleaved as Y-U-Y-V (YUY2). No alpha. */
+	ZIMG_LAYOUT_UYVY       = 5  /**< 4:2:2 YUV interleaved as U-Y-V-Y. No alpha. */
+} zimg_plane_layout_e;
+
 /**
  * Field parity constants.
  *
@@ -397,6 +415,11 @@ typedef enum zimg_resample_filter_e {
   * The plane order is R-G-B-A, Y-U-V-A, or X-Y-Z-A. If present, an alpha
   * channel is always the fourth plane, even if the image is greyscale.
   *
+  * For non-planar layouts ({@link zimg_plane_layout_e}), interleaved
+  * components share the buffer of their first plane. A semi-planar image
+  * stores U-V in the second plane and alpha, if any, in the fourth plane.
+  * Packed images are stored entirely in the first plane.
+  *
   * The row index mask can be set to the special value of
   * {@link ZIMG_BUFFER_MAX} to indicate a fully allocated image plane. Filter
   * instances will not read or write beyond image bounds, and no padding is
@@ -551,6 +574,208 @@ zimg_error_code_e zimg_filter_graph_process(const zimg_filter_graph *ptr, const
                                             zimg_filter_graph_callback unpack_cb, void *unpack_user,
                                             zimg_filter_graph_callback pack_cb, void *pack_user);
 
+/**
+ * Process an image with a filter graph having multiple outputs.
+ *
+ * The input image is read once and operations common to several outputs are
+ * executed once. The output buffers and callbacks are given in the order of
+ * the formats passed to {@link zimg_filter_graph_build_multi}. Graphs with
+ * one output may also be processed with this function.
+ *
+ * @param ptr graph handle
+ * @param[in] src input image buffer
+ * @param[out] dst array of output image buffers
+ * @param tmp temporary buffer
+ * @param unpack_cb user-defined input callback, may be NULL
+ * @param unpack_user private data for callback
+ * @param pack_cb array of user-defined output callbacks, may be NULL
+ * @param pack_user array of private data for callbacks, may be NULL
+ * @return error code
+ */
+ZIMG_VISIBILITY
+zimg_error_code_e zimg_filter_graph_process_multi(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer dst[], void *tmp,
+                                                  zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                                  const zimg_filter_graph_callback pack_cb[], void * const pack_user[]);
+
+/**
+ * Task function for parallel processing.
+ *
+ * @param task_user private data provided by the library
+ * @param index index of task
+ */
+typedef void (*zimg_task_func)(void *task_user, unsigned index);
+
+/**
+ * User callback for parallel processing.
+ *
+ * The callback must invoke {@p task} exactly once for each index in the range
+ * [0, num_tasks), passing {@p task_user} as the first argument. Tasks may be
+ * executed concurrently and in any order. The callback must not return until
+ * all tasks have completed.
+ *
+ * @param user user-defined private data
+ * @param task task function
+ * @param task_user private data for task function
+ * @param num_tasks number of tasks
+ * @return zero on success or non-zero on failure
+ */
+typedef int (*zimg_thread_pool_callback)(void *user, zimg_task_func task, void *task_user, unsigned num_tasks);
+
+/**
+ * Query the size of the temporary buffer required to execute the graph in
+ * multiple bands.
+ *
+ * @pre out != 0
+ * @param ptr graph handle
+ * @param num_bands requested number of bands
+ * @param[out] out set to the size of the buffer in bytes
+ * @return error code
+ * @see zimg_filter_graph_process_mt
+ */
+ZIMG_VISIBILITY
+zimg_error_code_e zimg_filter_graph_get_tmp_size_mt(const zimg_filter_graph *ptr, unsigned num_bands, size_t *out);
+
+/**
+ * Process an image with the filter graph using multiple threads.
+ *
+ * The output image is divided into horizontal bands, which are processed
+ * independently as tasks submitted to the thread pool. Lines of intermediate
+ * images required by adjacent bands are computed by each band. The number of
+ * bands may be reduced to satisfy alignment constraints, and graphs containing
+ * stateful filters, such as error diffusion, are processed as a single band.
+ *
+ * Unlike {@link zimg_filter_graph_process}, the input and output buffers
+ * must contain the entire image, i.e. have a mask of {@link ZIMG_BUFFER_MAX}.
+ * If provided, the callbacks may be invoked concurrently from multiple threads
+ * and may be invoked on the same lines multiple times.
+ *
+ * @param ptr graph handle
+ * @param[in] src input image buffer
+ * @param[out] dst output image buffer
+ * @param tmp temporary buffer
+ * @param num_bands requested number of bands
+ * @param unpack_cb user-defined input callback, may be NULL
+ * @param unpack_user private data for callback
+ * @param pack_cb user-defined output callback, may be NULL
+ * @param pack_user private data for callback
+ * @param pool_cb user-defined thread pool, may be NULL to process bands sequentially
+ * @param pool_user private data for thread pool
+ * @return error code
+ * @see zimg_filter_graph_get_tmp_size_mt
+ */
+ZIMG_VISIBILITY
+zimg_error_code_e zimg_filter_graph_process_mt(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
+                                               unsigned num_bands,
+                                               zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                               zimg_filter_graph_callback pack_cb, void *pack_user,
+                                               zimg_thread_pool_callback pool_cb, void *pool_user);
+
+/**
+ * Execution statistics of a filter in the graph.
+ */
+typedef struct zimg_filter_profile {
+	const char *name;          /**< Name of filter implementation, valid for the lifetime of the graph. */
+	unsigned width;            /**< Output width. */
+	unsigned height;           /**< Output height. */
+	unsigned long long calls;  /**< Number of invocations. */
+	unsigned long long rows;   /**< Number of lines produced. */
+	unsigned long long pixels; /**< Number of pixels produced. */
+	double seconds;            /**< Cumulative wall time in seconds. */
+} zimg_filter_profile;
+
+/**
+ * Query the execution statistics of each filter in the graph.
+ *
+ * Statistics are accumulated over all calls to process the graph, including
+ * concurrent calls, if the graph was built with
+ * {@link zimg_graph_builder_params::enable_profiling}. Otherwise, the graph
+ * reports no filters. Lines or pixels computed more than once, e.g. in
+ * overlapping tiles, are counted each time.
+ *
+ * @pre count != 0
+ * @param ptr graph handle
+ * @param[out] profile array of {@p count} entries, may be NULL
+ * @param[in,out] count on input, number of entries in the array. On output,
+ *                      set to the number of filters in the graph
+ * @return error code
+ */
+ZIMG_VISIBILITY
+zimg_error_code_e zimg_filter_graph_get_profile(const zimg_filter_graph *ptr, zimg_filter_profile *profile, unsigned *count);
+
+/**
+ * Opaque type representing the incremental execution of a filter graph.
+ *
+ * A stream accepts the lines of the input image as they become available and
+ * returns each line of the output image as soon as the input lines it depends
+ * on have been provided. Execution state and intermediate images are retained
+ * between calls, so neither call blocks waiting for data.
+ */
+typedef struct zimg_filter_graph_stream zimg_filter_graph_stream;
+
+/**
+ * Begin processing an image incrementally.
+ *
+ * The stream allocates its own intermediate buffers. The filter graph must
+ * not be deleted before the stream.
+ *
+ * @param ptr graph handle
+ * @return stream handle, or NULL on error
+ */
+ZIMG_VISIBILITY
+zimg_filter_graph_stream *zimg_filter_graph_stream_begin(const zimg_filter_graph *ptr);
+
+/**
+ * Provide the next lines of the input image.
+ *
+ * Line 0 of the buffer holds the first input line not yet accepted by the
+ * stream, subject to the buffer mask. If the image is subsampled, lines are
+ * accepted in units of the chroma subsampling, except at the end of the image.
+ *
+ * Fewer lines than provided are accepted if the internal buffers are full.
+ * Output lines must then be retrieved with
+ * {@link zimg_filter_graph_stream_pull_rows} before further input is
+ * accepted.
+ *
+ * @pre num_accepted != 0
+ * @param ptr stream handle
+ * @param[in] src input image buffer
+ * @param num_rows number of lines available in the buffer
+ * @param[out] num_accepted set to the number of lines consumed
+ * @return error code
+ */
+ZIMG_VISIBILITY
+zimg_error_code_e zimg_filter_graph_stream_push_rows(zimg_filter_graph_stream *ptr, const zimg_image_buffer_const *src, unsigned num_rows, unsigned *num_accepted);
+
+/**
+ * Retrieve the next lines of the output image.
+ *
+ * Line 0 of the buffer receives the first output line not yet returned by the
+ * stream, subject to the buffer mask. If the image is subsampled, lines are
+ * returned in units of the chroma subsampling, except at the end of the image.
+ *
+ * Fewer lines than requested, possibly none, are returned if insufficient
+ * input has been provided.
+ *
+ * @pre num_returned != 0
+ * @param ptr stream handle
+ * @param[out] dst output image buffer
+ * @param num_rows number of lines available in the buffer
+ * @param[out] num_returned set to the number of lines written
+ * @return error code
+ */
+ZIMG_VISIBILITY
+zimg_error_code_e zimg_filter_graph_stream_pull_rows(zimg_filter_graph_stream *ptr, const zimg_image_buffer *dst, unsigned num_rows, unsigned *num_returned);
+
+/**
+ * Delete the stream.
+ *
+ * A stream may be deleted before the entire image has been processed.
+ *
+ * @param ptr stream handle, may be NULL
+ */
+ZIMG_VISIBILITY
+void zimg_filter_graph_stream_end(zimg_filter_graph_stream *ptr);
+
 
 /**
  * Image format descriptor.
@@ -585,6 +810,8 @@ typedef struct zimg_image_format {
 	} active_region;
 
 	zimg_alpha_type_e alpha;                                  /**< Alpha channel (default ZIMG_ALPHA_NONE). Since API 2.4. */
+
+	zimg_plane_layout_e layout;                               /**< Plane layout (default ZIMG_LAYOUT_PLANAR). Since API 2.6. */
 } zimg_image_format;
 
 /**
@@ -644,6 +871,28 @@ typedef struct zimg_graph_builder_params {
 	char scene_referred;
 	/** Apply chromatic adaptation when changing white points (default false). */
 	char chromatic_adaptation;
+	/**
+	 * Record execution statistics of each filter (default false). Since API 2.6.
+	 *
+	 * Profiling adds a small overhead to each filter invocation.
+	 *
+	 * @see zimg_filter_graph_get_profile
+	 */
+	char enable_profiling;
+	/**
+	 * Evaluate colorspace conversions by interpolation in a 3D lookup table
+	 * (default false). Since API 2.6.
+	 *
+	 * The conversion is sampled on a 65x65x65 lattice spanning the nominal
+	 * range of the input and applied with tetrahedral interpolation. Inputs
+	 * outside of the nominal range are clamped. Conversions from linear light
+	 * and conversions consisting only of matrix operations are not affected.
+	 *
+	 * The absolute error is below 2^-8 for in-gamut colors whose converted
+	 * value lies within the nominal range. Colors clipped by a change of
+	 * primaries may deviate further near the gamut boundary.
+	 */
+	char allow_colorspace_lut;
 } zimg_graph_builder_params;
 
 /**
@@ -678,6 +927,82 @@ void zimg_graph_builder_params_default(zimg_graph_builder_params *ptr, unsigned
 ZIMG_VISIBILITY
 zimg_filter_graph *zimg_filter_graph_build(const zimg_image_format *src_format, const zimg_image_format *dst_format, const zimg_graph_builder_params *params);
 
+/**
+ * Create a graph converting one input format to several output formats.
+ *
+ * All outputs are produced by a single call to
+ * {@link zimg_filter_graph_process_multi}, e.g. to render every rung of an
+ * adaptive bitrate ladder in one pass over the source. The input formats
+ * implied by each output must agree, in particular with regards to
+ * unspecified colorspaces. Multi-output graphs can not be processed with
+ * {@link zimg_filter_graph_process}, {@link zimg_filter_graph_process_mt},
+ * or as a stream. {@link zimg_filter_graph_get_output_buffering} reports
+ * the first output.
+ *
+ * @param[in] src_format input image format
+ * @param[in] dst_formats array of output image formats
+ * @param num_outputs number of output formats
+ * @param[in] params filter parameters, may be NULL
+ * @return graph handle, or NULL on failure
+ */
+ZIMG_VISIBILITY
+zimg_filter_graph *zimg_filter_graph_build_multi(const zimg_image_format *src_format, const zimg_image_format dst_formats[], unsigned num_outputs,
+                                                 const zimg_graph_builder_params *params);
+
+/**
+ * Create a graph generating an image pyramid.
+ *
+ * The graph has one output per level, processed with
+ * {@link zimg_filter_graph_process_multi}. Level N halves the width and
+ * height of level N-1, rounded down to a multiple of the chroma subsampling
+ * factor, with level 0 being the input image. All levels share the input
+ * format. Each level is computed from the previous one as it is produced,
+ * using a fixed 2:1 filter equivalent to bilinear resampling. The input must
+ * not have an active subregion.
+ *
+ * @param[in] src_format input image format
+ * @param num_levels number of output levels
+ * @param[in] params filter parameters, may be NULL
+ * @return graph handle, or NULL on failure
+ */
+ZIMG_VISIBILITY
+zimg_filter_graph *zimg_filter_graph_build_pyramid(const zimg_image_format *src_format, unsigned num_levels, const zimg_graph_builder_params *params);
+
+/**
+ * Serialize a graph to a binary blob.
+ *
+ * The blob holds the formats and parameters of the graph, together with
+ * the resampling coefficients and lookup tables computed while building it.
+ * Restoring the blob with {@link zimg_filter_graph_deserialize} skips their
+ * computation. Blobs are specific to the library version and the CPU
+ * architecture. A blob can only be restored on a host supporting the CPU
+ * selected by the graph parameters, with {@link ZIMG_CPU_AUTO} resolved on
+ * the host which created the blob.
+ *
+ * If buf is NULL, the size of the blob is stored in size. Otherwise, size
+ * holds the size of buf on input and the size of the blob on output.
+ *
+ * @param ptr graph handle, which must have been created by a build function
+ * @param[out] buf output buffer, may be NULL
+ * @param[in,out] size buffer size in bytes
+ * @return error code
+ */
+ZIMG_VISIBILITY
+zimg_error_code_e zimg_filter_graph_serialize(const zimg_filter_graph *ptr, void *buf, size_t *size);
+
+/**
+ * Create a graph from a blob produced by {@link zimg_filter_graph_serialize}.
+ *
+ * The graph is equivalent to the serialized graph. The buffer is not
+ * referenced after the function returns.
+ *
+ * @param[in] buf serialized graph
+ * @param size size of buffer in bytes
+ * @return graph handle, or NULL on failure
+ */
+ZIMG_VISIBILITY
+zimg_filter_graph *zimg_filter_graph_deserialize(const void *buf, size_t size);
+
 
 #ifdef ZIMG_GRAPHENGINE_API
 /**
@@ -701,7 +1026,7 @@ void zimg_subgraph_free(zimg_subgraph *ptr);
  *
  * Note that the plane index semantics of graphengine differ from
  * {@link zimg_image_buffer}. The alpha plane of grey+alpha formats is plane 1,
- * not plane 3.
+ * not plane 3. Non-planar layouts have one node per buffer plane in use.
  *
  * @param ptr graph handle
  * @param[out] num_sources set to the number of input planes/source nodes
@@ -2,7 +2,7 @@
 
 #include <algorithm>
 #include <cstdint>
-#include <vector>
+#include <memory>
 #include <arm_neon.h>
 #include "common/align.h"
 #include "common/ccdep.h"
@@ -169,50 +169,36 @@ void matrix_filter_line_neon(const float *matrix, const float * const * RESTRICT
 
 
 class ToLinearLutOperationNeon final : public Operation {
-	std::vector<float> m_lut;
+	std::shared_ptr<const float[]> m_lut;
 	unsigned m_lut_depth;
 public:
 	ToLinearLutOperationNeon(gamma_func func, unsigned lut_depth, float postscale) :
-		m_lut((1UL << lut_depth) + 1),
+		m_lut{ get_to_linear_lut(func, postscale, lut_depth) },
 		m_lut_depth{ lut_depth }
-	{
-		// Allocate an extra LUT entry so that indexing can be done by multipying by a power of 2.
-		for (size_t i = 0; i < m_lut.size(); ++i) {
-			float x = static_cast<float>(i) / (1 << lut_depth) * 2.0f - 0.5f;
-			m_lut[i] = func(x) * postscale;
-		}
-	}
+	{}
 
 	unsigned alignment_mask() const noexcept override { return 0x3; }
 
 	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
 	{
-		to_linear_lut_filter_line(m_lut.data(), m_lut_depth, src[0], dst[0], left, right);
-		to_linear_lut_filter_line(m_lut.data(), m_lut_depth, src[1], dst[1], left, right);
-		to_linear_lut_filter_line(m_lut.data(), m_lut_depth, src[2], dst[2], left, right);
+		to_linear_lut_filter_line(m_lut.get(), m_lut_depth, src[0], dst[0], left, right);
+		to_linear_lut_filter_line(m_lut.get(), m_lut_depth, src[1], dst[1], left, right);
+		to_linear_lut_filter_line(m_lut.get(), m_lut_depth, src[2], dst[2], left, right);
 	}
 };
 
 class ToGammaLutOperationNeon final : public Operation {
-	std::vector<float> m_lut;
+	std::shared_ptr<const float[]> m_lut;
 public:
-	ToGammaLutOperationNeon(gamma_func func, float prescale) :
-		m_lut(static_cast<uint32_t>(UINT16_MAX) + 1)
-	{
-		for (size_t i = 0; i <= UINT16_MAX; ++i) {
-			uint16_t half = static_cast<uint16_t>(i);
-			float x = vgetq_lane_f32(vcvt_f32_f16(vreinterpret_f16_u16(vdup_n_u16(half))), 0);
-			m_lut[i] = func(x * prescale);
-		}
-	}
+	ToGammaLutOperationNeon(gamma_func func, float prescale) : m_lut{ get_to_gamma_lut(func, prescale) } {}
 
 	unsigned alignment_mask() const noexcept override { return 0x3; }
 
 	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
 	{
-		to_gamma_lut_filter_line(m_lut.data(), src[0], dst[0], left, right);
-		to_gamma_lut_filter_line(m_lut.data(), src[1], dst[1], left, right);
-		to_gamma_lut_filter_line(m_lut.data(), src[2], dst[2], left, right);
+		to_gamma_lut_filter_line(m_lut.get(), src[0], dst[0], left, right);
+		to_gamma_lut_filter_line(m_lut.get(), src[1], dst[1], left, right);
+		to_gamma_lut_filter_line(m_lut.get(), src[2], dst[2], left, right);
 	}
 };
 
@@ -1,37 +1,177 @@
+#include <algorithm>
 #include <array>
 #include <memory>
+#include "common/align.h"
+#include "common/alloc.h"
 #include "common/cpuinfo.h"
 #include "common/except.h"
 #include "common/pixel.h"
+#include "common/table_record.h"
 #include "common/zassert.h"
 #include "graph/filter_base.h"
 #include "colorspace.h"
 #include "colorspace_graph.h"
+#include "gamma.h"
+#include "matrix3.h"
 #include "operation.h"
+#include "operation_impl.h"
 
 namespace zimg::colorspace {
 
 namespace {
 
+// Pixels per strip. Each operation is applied to a strip before the next one,
+// so that the three rows of a strip remain resident in L1 between operations.
+constexpr unsigned STRIP_SIZE = 256;
+
+// Lattice points per axis of the 3D LUT.
+constexpr unsigned LUT3D_SIZE = 65;
+
 class ColorspaceConversionImpl : public graph::PointFilter {
 	std::array<std::unique_ptr<Operation>, 6> m_operations;
+	unsigned m_num_operations;
+
+	void apply(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept
+	{
+		if (m_num_operations == 1) {
+			m_operations[0]->process(src, dst, left, right);
+			return;
+		}
+
+		// Strip boundaries are multiples of STRIP_SIZE, which satisfies the alignment of every operation.
+		for (unsigned strip_left = left; strip_left < right;) {
+			unsigned strip_right = std::min(floor_n(strip_left, STRIP_SIZE) + STRIP_SIZE, right);
+
+			m_operations[0]->process(src, dst, strip_left, strip_right);
+
+			for (unsigned n = 1; n < m_num_operations; ++n) {
+				m_operations[n]->process(dst, dst, strip_left, strip_right);
+			}
+
+			strip_left = strip_right;
+		}
+	}
+
+	Lut3D sample_lut(unsigned first, unsigned last, bool chroma_in) const
+	{
+		const unsigned size = LUT3D_SIZE;
+		const unsigned num_points = size * size * size;
+
+		Lut3D lut{};
+		lut.size = size;
+		lut.data.resize(static_cast<size_t>(num_points) * 3);
+
+		for (unsigned c = 0; c < 3; ++c) {
+			lut.scale[c] = static_cast<float>(size - 1);
+			lut.offset[c] = chroma_in && c ? static_cast<float>(size - 1) / 2.0f : 0.0f;
+		}
+
+		AlignedVector<float> lattice[3];
+		float *lattice_ptr[3];
+
+		for (unsigned c = 0; c < 3; ++c) {
+			lattice[c].resize(ceil_n(num_points, AlignmentOf<float>));
+			lattice_ptr[c] = lattice[c].data();
+		}
+
+		for (unsigned idx = 0; idx < num_points; ++idx) {
+			unsigned coord[3] = { idx % size, idx / size % size, idx / (size * size) };
+
+			for (unsigned c = 0; c < 3; ++c) {
+				lattice[c][idx] = (static_cast<float>(coord[c]) - lut.offset[c]) / lut.scale[c];
+			}
+		}
+
+		for (unsigned n = first; n < last; ++n) {
+			m_operations[n]->process(lattice_ptr, lattice_ptr, 0, num_points);
+		}
+
+		for (unsigned idx = 0; idx < num_points; ++idx) {
+			for (unsigned c = 0; c < 3; ++c) {
+				lut.data[static_cast<size_t>(idx) * 3 + c] = lattice[c][idx];
+			}
+		}
+
+		return lut;
+	}
+
+	// Replaces the operations [first, last) with a LUT sampled from those operations.
+	void bake_lut(unsigned first, unsigned last, bool chroma_in, CPUClass cpu)
+	{
+		TableRecord *record = TableRecord::current();
+		std::shared_ptr<const Lut3D> lut;
+
+		if (record) {
+			TableRecord::key_type key{ record->next_ordinal(TableRecord::Kind::LUT3D), first, last, chroma_in, LUT3D_SIZE };
+
+			if (record->is_replay()) {
+				const TableRecord::entry *entry = record->find(TableRecord::Kind::LUT3D, key);
+				if (entry && static_cast<const Lut3D *>(entry->table.get())->size == LUT3D_SIZE)
+					lut = std::static_pointer_cast<const Lut3D>(entry->table);
+			} else {
+				lut = std::make_shared<Lut3D>(sample_lut(first, last, chroma_in));
+				record->add(TableRecord::Kind::LUT3D, std::move(key), lut);
+			}
+		}
+		if (!lut)
+			lut = std::make_shared<Lut3D>(sample_lut(first, last, chroma_in));
+
+		m_operations[first] = create_lut3d_operation(lut, cpu);
+		std::move(m_operations.begin() + last, m_operations.begin() + m_num_operations, m_operations.begin() + first + 1);
+		m_num_operations -= last - first - 1;
+
+		for (unsigned n = m_num_operations; n < m_operations.size(); ++n) {
+			m_operations[n].reset();
+		}
+	}
 
-	void build_graph(const ColorspaceDefinition &in, const ColorspaceDefinition &out, const OperationParams &params, CPUClass cpu)
+	void build_graph(const ColorspaceDefinition &in, const ColorspaceDefinition &out, const OperationParams &params, bool use_lut, CPUClass cpu)
 	{
 		auto path = get_operation_path(in, out);
 		zassert(!path.empty(), "empty path");
 		zassert(path.size() <= 6, "too many operations");
 
 		for (size_t i = 0; i < path.size(); ++i) {
-			m_operations[i] = path[i](params, cpu);
+			std::unique_ptr<Operation> op = path[i](params, cpu);
+
+			// Merge consecutive linear transforms, e.g. YUV to RGB followed by a gamut conversion.
+			if (m_num_operations && op->matrix() && m_operations[m_num_operations - 1]->matrix()) {
+				Matrix3x3 m = *op->matrix() * *m_operations[m_num_operations - 1]->matrix();
+				m_operations[m_num_operations - 1] = create_matrix_operation(m, cpu);
+				continue;
+			}
+
+			m_operations[m_num_operations++] = std::move(op);
+		}
+
+		// Only the non-linear section of the path is sampled, so that the lattice
+		// spans the RGB cube when the input is YUV. Linear light exceeds the
+		// range of the lattice.
+		if (use_lut && in.transfer != TransferCharacteristics::LINEAR) {
+			unsigned first = 0;
+			unsigned last = m_num_operations;
+
+			while (first < last && m_operations[first]->matrix()) {
+				++first;
+			}
+			while (last > first && m_operations[last - 1]->matrix()) {
+				--last;
+			}
+
+			if (first != last)
+				bake_lut(first, last, first == 0 && in.matrix != MatrixCoefficients::RGB && in.matrix != MatrixCoefficients::REC_2100_LMS, cpu);
+		}
+
+		for (unsigned i = 0; i < m_num_operations; ++i) {
 			m_desc.alignment_mask = std::max(m_desc.alignment_mask, m_operations[i]->alignment_mask());
 		}
 	}
 public:
 	ColorspaceConversionImpl(unsigned width, unsigned height,
 	                         const ColorspaceDefinition &in, const ColorspaceDefinition &out,
-	                         const OperationParams &params, CPUClass cpu) :
-		PointFilter(width, height, PixelType::FLOAT)
+	                         const OperationParams &params, bool use_lut, CPUClass cpu) :
+		PointFilter(width, height, PixelType::FLOAT),
+		m_num_operations{}
 	{
 		zassert_d(width <= pixel_max_width(PixelType::FLOAT), "overflow");
 
@@ -39,7 +179,7 @@ public:
 		m_desc.num_planes = 3;
 		m_desc.flags.in_place = 1;
 
-		build_graph(in, out, params, cpu);
+		build_graph(in, out, params, use_lut, cpu);
 	}
 
 	void process(const graphengine::BufferDescriptor in[3], const graphengine::BufferDescriptor out[3],
@@ -53,29 +193,56 @@ public:
 			dst_ptr[p] = out[p].get_line<float>(i);
 		}
 
-		m_operations[0]->process(src_ptr, dst_ptr, left, right);
+		apply(src_ptr, dst_ptr, left, right);
+	}
+};
 
-		if (!m_operations[1])
-			return;
-		m_operations[1]->process(dst_ptr, dst_ptr, left, right);
+OperationParams get_operation_params(const ColorspaceConversion &conv)
+{
+	OperationParams params;
+	params.set_peak_luminance(conv.peak_luminance)
+	      .set_approximate_gamma(conv.approximate_gamma)
+	      .set_scene_referred(conv.scene_referred)
+	      .set_chromatic_adaptation(conv.chromatic_adaptation);
+	return params;
+}
 
-		if (!m_operations[2])
-			return;
-		m_operations[2]->process(dst_ptr, dst_ptr, left, right);
+ColorspaceDefinition effective_colorspace(const ColorspaceDefinition &csp, bool scene_referred)
+{
+	ColorspaceDefinition ret = csp;
 
-		if (!m_operations[3])
-			return;
-		m_operations[3]->process(dst_ptr, dst_ptr, left, right);
+	if (!scene_referred && csp.transfer == TransferCharacteristics::SMPTE_240M)
+		ret.transfer = TransferCharacteristics::REC_709;
 
-		if (!m_operations[4])
-			return;
-		m_operations[4]->process(dst_ptr, dst_ptr, left, right);
+	return ret;
+}
 
-		if (!m_operations[5])
-			return;
-		m_operations[5]->process(dst_ptr, dst_ptr, left, right);
+// Checks if the conversion between RGB and another colorspace is performed in linear light.
+bool needs_linear_rgb(const ColorspaceDefinition &rgb, const ColorspaceDefinition &other)
+{
+	switch (other.matrix) {
+	case MatrixCoefficients::REC_2020_CL:
+	case MatrixCoefficients::CHROMATICITY_DERIVED_CL:
+	case MatrixCoefficients::REC_2100_LMS:
+	case MatrixCoefficients::REC_2100_ICTCP:
+		return true;
+	default:
+		return rgb.transfer != other.transfer || rgb.primaries != other.primaries;
 	}
-};
+}
+
+bool get_separable_transfer(const ColorspaceDefinition &csp, const ColorspaceDefinition &other, const OperationParams &params, TransferFunction *func)
+{
+	if (csp.matrix != MatrixCoefficients::RGB || csp.transfer == TransferCharacteristics::UNSPECIFIED || csp.transfer == TransferCharacteristics::LINEAR)
+		return false;
+	if (csp == other || !needs_linear_rgb(csp, other))
+		return false;
+	if (csp.transfer == TransferCharacteristics::ARIB_B67 && use_display_referred_b67(csp.primaries, params))
+		return false;
+
+	*func = select_transfer_function(csp.transfer, params.peak_luminance, params.scene_referred);
+	return true;
+}
 
 } // namespace
 
@@ -89,34 +256,34 @@ ColorspaceConversion::ColorspaceConversion(unsigned width, unsigned height) :
 	approximate_gamma{},
 	scene_referred{},
 	chromatic_adaptation{},
+	use_lut{},
 	cpu{ CPUClass::NONE }
 {}
 
+bool ColorspaceConversion::get_input_transfer(TransferFunction *func) const
+{
+	return get_separable_transfer(effective_colorspace(csp_in, scene_referred), effective_colorspace(csp_out, scene_referred), get_operation_params(*this), func);
+}
+
+bool ColorspaceConversion::get_output_transfer(TransferFunction *func) const
+{
+	return get_separable_transfer(effective_colorspace(csp_out, scene_referred), effective_colorspace(csp_in, scene_referred), get_operation_params(*this), func);
+}
+
 std::unique_ptr<graphengine::Filter> ColorspaceConversion::create() const try
 {
 	if (width > pixel_max_width(PixelType::FLOAT))
 		error::throw_<error::OutOfMemory>();
 
-	ColorspaceDefinition csp_in_effective = csp_in;
-	ColorspaceDefinition csp_out_effective = csp_out;
-
-	if (!scene_referred) {
-		if (csp_in.transfer == TransferCharacteristics::SMPTE_240M)
-			csp_in_effective.transfer = TransferCharacteristics::REC_709;
-		if (csp_out.transfer == TransferCharacteristics::SMPTE_240M)
-			csp_out_effective.transfer = TransferCharacteristics::REC_709;
-	}
+	ColorspaceDefinition csp_in_effective = effective_colorspace(csp_in, scene_referred);
+	ColorspaceDefinition csp_out_effective = effective_colorspace(csp_out, scene_referred);
 
 	if (csp_in_effective == csp_out_effective)
 		return nullptr;
 
-	OperationParams params;
-	params.set_peak_luminance(peak_luminance)
-	      .set_approximate_gamma(approximate_gamma)
-	      .set_scene_referred(scene_referred)
-	      .set_chromatic_adaptation(chromatic_adaptation);
+	OperationParams params = get_operation_params(*this);
 
-	return std::make_unique<ColorspaceConversionImpl>(width, height, csp_in_effective, csp_out_effective, params, cpu);
+	return std::make_unique<ColorspaceConversionImpl>(width, height, csp_in_effective, csp_out_effective, params, use_lut, cpu);
 } catch (const std::bad_alloc &) {
 	error::throw_<error::OutOfMemory>();
 }
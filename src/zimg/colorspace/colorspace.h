@@ -15,6 +15,8 @@ enum class CPUClass;
 
 namespace zimg::colorspace {
 
+struct TransferFunction;
+
 enum class MatrixCoefficients {
 	UNSPECIFIED,
 	RGB,
@@ -120,11 +122,35 @@ struct ColorspaceConversion {
 	BUILDER_MEMBER(bool, approximate_gamma)
 	BUILDER_MEMBER(bool, scene_referred)
 	BUILDER_MEMBER(bool, chromatic_adaptation)
+	BUILDER_MEMBER(bool, use_lut)
 	BUILDER_MEMBER(CPUClass, cpu)
 #undef BUILDER_MEMBER
 
 	ColorspaceConversion(unsigned width, unsigned height);
 
+	/**
+	 * Get the per-channel function which linearizes the input.
+	 *
+	 * The function exists if |csp_in| is non-linear RGB and the conversion
+	 * passes through linear RGB in the input primaries. The remainder of the
+	 * conversion is then equivalent to converting from |csp_in.to_linear()|.
+	 *
+	 * @param[out] func transfer function, applied with |to_linear|
+	 * @return true if the function exists
+	 */
+	bool get_input_transfer(TransferFunction *func) const;
+
+	/**
+	 * Get the per-channel function which encodes the output.
+	 *
+	 * The conversion is then equivalent to converting to |csp_out.to_linear()|.
+	 *
+	 * @param[out] func transfer function, applied with |to_gamma|
+	 * @return true if the function exists
+	 * @see get_input_transfer
+	 */
+	bool get_output_transfer(TransferFunction *func) const;
+
 	std::unique_ptr<graphengine::Filter> create() const;
 };
 
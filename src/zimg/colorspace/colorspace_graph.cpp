@@ -1,9 +1,10 @@
 #include <algorithm>
-#include <deque>
-#include <unordered_map>
-#include <unordered_set>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <utility>
 #include <type_traits>
+#include <vector>
 #include "common/except.h"
 #include "common/zassert.h"
 #include "colorspace.h"
@@ -100,17 +101,28 @@ constexpr bool is_valid_csp(const ColorspaceDefinition &csp)
 }
 
 
-struct ColorspaceHash {
-	size_t operator()(const ColorspaceDefinition &csp) const
-	{
-		return std::hash<unsigned long>{}(
-			(static_cast<unsigned long>(csp.matrix) << 16) |
-			(static_cast<unsigned long>(csp.transfer) << 8) |
-			(static_cast<unsigned long>(csp.primaries)));
-	}
-};
+typedef std::unique_ptr<Operation> (*operation_func)(const ColorspaceDefinition &, const ColorspaceDefinition &, const OperationParams &, CPUClass);
+typedef std::pair<ColorspaceDefinition, operation_func> ColorspaceNode;
+
+constexpr unsigned NUM_MATRIX = static_cast<unsigned>(MatrixCoefficients::REC_2100_ICTCP) + 1;
+constexpr unsigned NUM_TRANSFER = static_cast<unsigned>(TransferCharacteristics::ARIB_B67) + 1;
+constexpr unsigned NUM_PRIMARIES = static_cast<unsigned>(ColorPrimaries::EBU_3213_E) + 1;
+constexpr unsigned NUM_COLORSPACES = NUM_MATRIX * NUM_TRANSFER * NUM_PRIMARIES;
+static_assert(NUM_COLORSPACES < UINT16_MAX);
+
+constexpr unsigned colorspace_index(const ColorspaceDefinition &csp)
+{
+	return (static_cast<unsigned>(csp.matrix) * NUM_TRANSFER + static_cast<unsigned>(csp.transfer)) * NUM_PRIMARIES + static_cast<unsigned>(csp.primaries);
+}
 
-typedef std::pair<ColorspaceDefinition, OperationFactory> ColorspaceNode;
+constexpr ColorspaceDefinition colorspace_from_index(unsigned idx)
+{
+	return{
+		static_cast<MatrixCoefficients>(idx / (NUM_TRANSFER * NUM_PRIMARIES)),
+		static_cast<TransferCharacteristics>(idx / NUM_PRIMARIES % NUM_TRANSFER),
+		static_cast<ColorPrimaries>(idx % NUM_PRIMARIES),
+	};
+}
 
 std::vector<ColorspaceNode> get_neighboring_colorspaces(const ColorspaceDefinition &csp)
 {
@@ -118,9 +130,9 @@ std::vector<ColorspaceNode> get_neighboring_colorspaces(const ColorspaceDefiniti
 
 	std::vector<ColorspaceNode> edges;
 
-	auto add_edge = [&](const ColorspaceDefinition &out_csp, auto func)
+	auto add_edge = [&](const ColorspaceDefinition &out_csp, operation_func func)
 	{
-		edges.emplace_back(out_csp, std::bind(func, csp, out_csp, std::placeholders::_1, std::placeholders::_2));
+		edges.emplace_back(out_csp, func);
 	};
 
 	if (csp.matrix == MatrixCoefficients::RGB) {
@@ -192,50 +204,88 @@ std::vector<ColorspaceNode> get_neighboring_colorspaces(const ColorspaceDefiniti
 	return edges;
 }
 
-} // namespace
+// Breadth-first search tree rooted at a source colorspace. Each reachable
+// vertex records its parent and the operation converting from the parent.
+struct PathTree {
+	static constexpr uint16_t NO_PARENT = UINT16_MAX;
 
+	std::array<uint16_t, NUM_COLORSPACES> parent;
+	std::array<operation_func, NUM_COLORSPACES> func;
+};
 
-std::vector<OperationFactory> get_operation_path(const ColorspaceDefinition &in, const ColorspaceDefinition &out)
+std::unique_ptr<PathTree> build_path_tree(const ColorspaceDefinition &in)
 {
-	if (!is_valid_csp(in) || !is_valid_csp(out))
-		error::throw_<error::NoColorspaceConversion>("invalid colorspace definition");
+	std::unique_ptr<PathTree> tree = std::make_unique<PathTree>();
+	tree->parent.fill(PathTree::NO_PARENT);
+	tree->func.fill(nullptr);
 
-	std::vector<OperationFactory> path;
-	std::deque<ColorspaceDefinition> queue;
-	std::unordered_set<ColorspaceDefinition, ColorspaceHash> visited;
-	std::unordered_map<ColorspaceDefinition, ColorspaceNode, ColorspaceHash> parents;
-
-	ColorspaceDefinition vertex{};
-
-	visited.insert(in);
-	queue.push_back(in);
+	std::vector<uint16_t> queue;
+	queue.reserve(NUM_COLORSPACES);
 
-	while (!queue.empty()) {
-		vertex = queue.front();
-		queue.pop_front();
+	tree->parent[colorspace_index(in)] = static_cast<uint16_t>(colorspace_index(in));
+	queue.push_back(static_cast<uint16_t>(colorspace_index(in)));
 
-		if (vertex == out)
-			break;
+	for (size_t head = 0; head < queue.size(); ++head) {
+		unsigned vertex = queue[head];
 
-		for (auto &&edge : get_neighboring_colorspaces(vertex)) {
-			if (visited.find(edge.first) != visited.end())
+		for (const ColorspaceNode &edge : get_neighboring_colorspaces(colorspace_from_index(vertex))) {
+			unsigned idx = colorspace_index(edge.first);
+			if (tree->parent[idx] != PathTree::NO_PARENT)
 				continue;
 
-			visited.insert(edge.first);
-			queue.push_back(edge.first);
-			parents[edge.first] = std::make_pair(vertex, std::move(edge.second));
+			tree->parent[idx] = static_cast<uint16_t>(vertex);
+			tree->func[idx] = edge.second;
+			queue.push_back(static_cast<uint16_t>(idx));
 		}
 	}
-	if (vertex != out)
+
+	return tree;
+}
+
+// The graph is fixed, so the search from each source is run at most once per
+// process. Racing threads may both build a tree, in which case one is dropped.
+const PathTree &get_path_tree(const ColorspaceDefinition &in)
+{
+	static std::atomic<const PathTree *> cache[NUM_COLORSPACES];
+
+	std::atomic<const PathTree *> &entry = cache[colorspace_index(in)];
+	const PathTree *tree = entry.load(std::memory_order_acquire);
+
+	if (!tree) {
+		std::unique_ptr<PathTree> new_tree = build_path_tree(in);
+
+		if (entry.compare_exchange_strong(tree, new_tree.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+			tree = new_tree.release();
+	}
+
+	return *tree;
+}
+
+} // namespace
+
+
+std::vector<OperationFactory> get_operation_path(const ColorspaceDefinition &in, const ColorspaceDefinition &out)
+{
+	if (!is_valid_csp(in) || !is_valid_csp(out))
+		error::throw_<error::NoColorspaceConversion>("invalid colorspace definition");
+
+	const PathTree &tree = get_path_tree(in);
+	unsigned vertex = colorspace_index(out);
+
+	if (tree.parent[vertex] == PathTree::NO_PARENT)
 		error::throw_<error::NoColorspaceConversion>("no path between colorspaces");
 
-	while (vertex != in) {
-		auto it = parents.find(vertex);
-		zassert_d(it != parents.end(), "missing link in traversal path");
+	std::vector<OperationFactory> path;
+
+	while (vertex != colorspace_index(in)) {
+		unsigned parent = tree.parent[vertex];
+		operation_func func = tree.func[vertex];
+		ColorspaceDefinition csp_in = colorspace_from_index(parent);
+		ColorspaceDefinition csp_out = colorspace_from_index(vertex);
 
-		ColorspaceNode node = std::move(it->second);
-		path.push_back(std::move(node.second));
-		vertex = node.first;
+		zassert_d(func, "missing link in traversal path");
+		path.push_back([=](const OperationParams &params, CPUClass cpu) { return func(csp_in, csp_out, params, cpu); });
+		vertex = parent;
 	}
 	std::reverse(path.begin(), path.end());
 
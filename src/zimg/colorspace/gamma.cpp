@@ -1,8 +1,15 @@
 #include <algorithm>
 #include <cfloat>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <tuple>
 #include "common/except.h"
 #include "common/libm_wrapper.h"
+#include "common/table_record.h"
+#include "common/weak_cache.h"
 #include "common/zassert.h"
 #include "colorspace.h"
 #include "gamma.h"
@@ -408,6 +415,164 @@ TransferFunction select_transfer_function(TransferCharacteristics transfer, doub
 	return func;
 }
 
+
+namespace {
+
+// Exact conversion, so that tables match those filled with hardware conversions.
+float half_bits_to_float(uint16_t x) noexcept
+{
+	uint32_t sign = static_cast<uint32_t>(x & 0x8000U) << 16;
+	uint32_t exp = (x >> 10) & 0x1FU;
+	uint32_t mant = x & 0x3FFU;
+	uint32_t bits;
+
+	if (exp == 0x1F) {
+		// Signaling NaN is converted to quiet NaN.
+		bits = sign | 0x7F800000U | (mant << 13) | (mant ? 0x400000U : 0);
+	} else if (exp) {
+		bits = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+	} else if (mant) {
+		// Denormal half is a normal float.
+		exp = 127 - 15 + 1;
+		while (!(mant & 0x400U)) {
+			mant <<= 1;
+			--exp;
+		}
+		bits = sign | (exp << 23) | ((mant & 0x3FFU) << 13);
+	} else {
+		bits = sign;
+	}
+
+	float ret;
+	std::memcpy(&ret, &bits, sizeof(ret));
+	return ret;
+}
+
+// Transfer functions by a process-independent index, for recording tables.
+constexpr gamma_func RECORDED_GAMMA_FUNCS[] = {
+	rec_709_oetf, rec_709_inverse_oetf,
+	log100_oetf, log100_inverse_oetf,
+	log316_oetf, log316_inverse_oetf,
+	rec_470m_oetf, rec_470m_inverse_oetf,
+	rec_470bg_oetf, rec_470bg_inverse_oetf,
+	smpte_240m_oetf, smpte_240m_inverse_oetf,
+	rec_1361_oetf, rec_1361_inverse_oetf,
+	xvycc_oetf, xvycc_inverse_oetf,
+	arib_b67_oetf, arib_b67_inverse_oetf,
+	rec_1886_eotf, rec_1886_inverse_eotf,
+	rec_1361_eotf, rec_1361_inverse_eotf,
+	xvycc_eotf, xvycc_inverse_eotf,
+	srgb_eotf, srgb_inverse_eotf,
+	st_2084_eotf, st_2084_inverse_eotf,
+	st_428_eotf, st_428_inverse_eotf,
+	arib_b67_eotf, arib_b67_inverse_eotf,
+	st_2084_oetf, st_2084_inverse_oetf,
+};
+
+class GammaLutCache {
+	enum class Direction { TO_LINEAR, TO_GAMMA };
+
+	struct key_type {
+		Direction direction;
+		gamma_func func;
+		uint32_t scale_bits; // Compared bitwise, so that NaN is a valid key.
+		unsigned lut_depth;
+
+		bool operator<(const key_type &other) const noexcept
+		{
+			return std::tie(direction, func, scale_bits, lut_depth) < std::tie(other.direction, other.func, other.scale_bits, other.lut_depth);
+		}
+	};
+
+	// Each table is 256 KB, so fewer are retained than for resampling filters.
+	weak_cache<key_type, const float[], 4> m_cache;
+
+	static std::shared_ptr<const float[]> compute(const key_type &key, float scale)
+	{
+		EnsureSinglePrecision x87;
+
+		if (key.direction == Direction::TO_LINEAR) {
+			size_t size = (static_cast<size_t>(1) << key.lut_depth) + 1;
+			std::shared_ptr<float[]> lut{ new float[size] };
+
+			// Allocate an extra LUT entry so that indexing can be done by multipying by a power of 2.
+			for (size_t i = 0; i < size; ++i) {
+				float x = static_cast<float>(i) / (1 << key.lut_depth) * 2.0f - 0.5f;
+				lut[i] = key.func(x) * scale;
+			}
+			return lut;
+		} else {
+			std::shared_ptr<float[]> lut{ new float[static_cast<size_t>(UINT16_MAX) + 1] };
+
+			for (size_t i = 0; i <= UINT16_MAX; ++i) {
+				float x = half_bits_to_float(static_cast<uint16_t>(i));
+				lut[i] = key.func(x * scale);
+			}
+			return lut;
+		}
+	}
+
+	std::shared_ptr<const float[]> get_cached(Direction direction, gamma_func func, float scale, unsigned lut_depth)
+	{
+		key_type key{ direction, func, 0, lut_depth };
+		std::memcpy(&key.scale_bits, &scale, sizeof(scale));
+
+		return m_cache.get(key, [&]() { return compute(key, scale); });
+	}
+public:
+	std::shared_ptr<const float[]> get(Direction direction, gamma_func func, float scale, unsigned lut_depth)
+	{
+		TableRecord *record = TableRecord::current();
+		auto it = std::find(std::begin(RECORDED_GAMMA_FUNCS), std::end(RECORDED_GAMMA_FUNCS), func);
+
+		if (!record || it == std::end(RECORDED_GAMMA_FUNCS))
+			return get_cached(direction, func, scale, lut_depth);
+
+		TableRecord::key_type key{ static_cast<uint64_t>(direction), static_cast<uint64_t>(it - std::begin(RECORDED_GAMMA_FUNCS)), table_key_bits(scale), lut_depth };
+		size_t size = direction == Direction::TO_LINEAR ? (static_cast<size_t>(1) << lut_depth) + 1 : static_cast<size_t>(UINT16_MAX) + 1;
+
+		if (record->is_replay()) {
+			const TableRecord::entry *entry = record->find(TableRecord::Kind::GAMMA_LUT, key);
+			if (entry && entry->count == size)
+				return std::static_pointer_cast<const float[]>(entry->table);
+			return get_cached(direction, func, scale, lut_depth);
+		}
+
+		std::shared_ptr<const float[]> lut = get_cached(direction, func, scale, lut_depth);
+		record->add(TableRecord::Kind::GAMMA_LUT, std::move(key), lut, size);
+		return lut;
+	}
+
+	std::shared_ptr<const float[]> get_to_linear(gamma_func func, float postscale, unsigned lut_depth)
+	{
+		return get(Direction::TO_LINEAR, func, postscale, lut_depth);
+	}
+
+	std::shared_ptr<const float[]> get_to_gamma(gamma_func func, float prescale)
+	{
+		return get(Direction::TO_GAMMA, func, prescale, 16);
+	}
+};
+
+GammaLutCache &gamma_lut_cache()
+{
+	static GammaLutCache cache;
+	return cache;
+}
+
+} // namespace
+
+
+std::shared_ptr<const float[]> get_to_linear_lut(gamma_func func, float postscale, unsigned lut_depth)
+{
+	return gamma_lut_cache().get_to_linear(func, postscale, lut_depth);
+}
+
+std::shared_ptr<const float[]> get_to_gamma_lut(gamma_func func, float prescale)
+{
+	return gamma_lut_cache().get_to_gamma(func, prescale);
+}
+
 #if defined(_MSC_VER) && defined(_M_IX86)
 EnsureSinglePrecision::EnsureSinglePrecision() noexcept : m_fpu_word(_control87(0, 0))
 {
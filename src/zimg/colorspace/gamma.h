@@ -3,6 +3,8 @@
 #ifndef ZIMG_COLORSPACE_GAMMA_H_
 #define ZIMG_COLORSPACE_GAMMA_H_
 
+#include <memory>
+
 namespace zimg::colorspace {
 
 enum class TransferCharacteristics;
@@ -75,6 +77,28 @@ struct TransferFunction {
 
 TransferFunction select_transfer_function(TransferCharacteristics transfer, double peak_luminance, bool scene_referred);
 
+/**
+ * Get a lookup table of |func(x) * postscale| indexed by fixed-point input.
+ *
+ * Entry i corresponds to x = i / 2^lut_depth * 2 - 0.5, covering [-0.5, 1.5].
+ * The table has 2^lut_depth + 1 entries. Tables are shared between all
+ * callers with identical parameters.
+ *
+ * @param func transfer function
+ * @param postscale scale applied to the result
+ * @param lut_depth log2 of the table resolution
+ * @return lookup table
+ */
+std::shared_ptr<const float[]> get_to_linear_lut(gamma_func func, float postscale, unsigned lut_depth);
+
+/**
+ * Get a lookup table of |func(x * prescale)| indexed by the half-precision
+ * representation of x. The table has 2^16 entries.
+ *
+ * @see get_to_linear_lut
+ */
+std::shared_ptr<const float[]> get_to_gamma_lut(gamma_func func, float prescale);
+
 
 // MSVC 32-bit compiler generates x87 instructions when operating on floats
 // returned from external functions. The caller must set the x87 precision to
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "common/cpuinfo.h"
+#include "common/except.h"
+#include "common/pixel.h"
+#include "common/zassert.h"
+#include "depth/quantize.h"
+#include "colorspace.h"
+#include "colorspace_param.h"
+#include "matrix_int.h"
+#include "matrix3.h"
+
+#if defined(ZIMG_X86)
+  #include "x86/matrix_int_x86.h"
+#endif
+
+namespace zimg::colorspace {
+
+namespace {
+
+// Inputs are normalized to this many bits, leaving the sign bit of int16 free.
+constexpr unsigned WORKING_DEPTH = 14;
+constexpr unsigned MAX_DEPTH = 12;
+
+// The rounded coefficients may deviate from the true conversion by at most
+// this many units of the output, before the final rounding.
+constexpr double MAX_ERROR = 0.5;
+constexpr unsigned MAX_SHIFT = 24;
+
+bool is_ncl_matrix(MatrixCoefficients matrix)
+{
+	switch (matrix) {
+	case MatrixCoefficients::RGB:
+	case MatrixCoefficients::REC_601:
+	case MatrixCoefficients::REC_709:
+	case MatrixCoefficients::FCC:
+	case MatrixCoefficients::SMPTE_240M:
+	case MatrixCoefficients::YCGCO:
+	case MatrixCoefficients::REC_2020_NCL:
+	case MatrixCoefficients::CHROMATICITY_DERIVED_NCL:
+		return true;
+	default:
+		return false;
+	}
+}
+
+Matrix3x3 to_rgb_matrix(const ColorspaceDefinition &csp)
+{
+	if (csp.matrix == MatrixCoefficients::RGB)
+		return Matrix3x3::identity();
+	else if (csp.matrix == MatrixCoefficients::CHROMATICITY_DERIVED_NCL)
+		return ncl_yuv_to_rgb_matrix_from_primaries(csp.primaries);
+	else
+		return ncl_yuv_to_rgb_matrix(csp.matrix);
+}
+
+Matrix3x3 from_rgb_matrix(const ColorspaceDefinition &csp)
+{
+	if (csp.matrix == MatrixCoefficients::RGB)
+		return Matrix3x3::identity();
+	else if (csp.matrix == MatrixCoefficients::CHROMATICITY_DERIVED_NCL)
+		return ncl_rgb_to_yuv_matrix_from_primaries(csp.primaries);
+	else
+		return ncl_rgb_to_yuv_matrix(csp.matrix);
+}
+
+template <class T, class U>
+void matrix_int_c(const MatrixIntCoeffs &coeffs, const void * const src[3], void * const dst[3], unsigned left, unsigned right)
+{
+	const T *src0 = static_cast<const T *>(src[0]);
+	const T *src1 = static_cast<const T *>(src[1]);
+	const T *src2 = static_cast<const T *>(src[2]);
+
+	for (unsigned j = left; j < right; ++j) {
+		int32_t x0 = static_cast<int32_t>(src0[j]) << coeffs.src_shift;
+		int32_t x1 = static_cast<int32_t>(src1[j]) << coeffs.src_shift;
+		int32_t x2 = static_cast<int32_t>(src2[j]) << coeffs.src_shift;
+
+		for (unsigned p = 0; p < 3; ++p) {
+			int32_t accum = coeffs.c[p][0] * x0 + coeffs.c[p][1] * x1 + coeffs.c[p][2] * x2 + coeffs.bias[p];
+			accum = std::clamp<int32_t>(accum >> coeffs.shift, 0, coeffs.max);
+			static_cast<U *>(dst[p])[j] = static_cast<U>(accum);
+		}
+	}
+}
+
+} // namespace
+
+
+MatrixIntFilter::MatrixIntFilter(const MatrixIntCoeffs &coeffs, PixelType type_in, PixelType type_out, unsigned width, unsigned height, CPUClass cpu) :
+	PointFilter(width, height, type_out),
+	m_coeffs(coeffs),
+	m_func{ select_matrix_int_func(type_in, type_out, cpu) }
+{
+	zassert_d(width <= pixel_max_width(type_in), "overflow");
+
+	m_desc.num_deps = 3;
+	m_desc.num_planes = 3;
+}
+
+void MatrixIntFilter::process(const graphengine::BufferDescriptor in[3], const graphengine::BufferDescriptor out[3],
+                              unsigned i, unsigned left, unsigned right, void *, void *) const noexcept
+{
+	const void *src[3] = { in[0].get_line(i), in[1].get_line(i), in[2].get_line(i) };
+	void *dst[3] = { out[0].get_line(i), out[1].get_line(i), out[2].get_line(i) };
+
+	m_func(m_coeffs, src, dst, left, right);
+}
+
+
+bool compute_matrix_int_coeffs(const Matrix3x3 &m, const PixelFormat format_in[3], const PixelFormat format_out[3], MatrixIntCoeffs *coeffs)
+{
+	for (unsigned p = 0; p < 3; ++p) {
+		if (!pixel_is_integer(format_in[p].type) || !pixel_is_integer(format_out[p].type))
+			return false;
+		if (format_in[p].depth > MAX_DEPTH || format_out[p].depth > MAX_DEPTH)
+			return false;
+		if (format_in[p].depth != format_in[0].depth || format_out[p].depth != format_out[0].depth)
+			return false;
+	}
+
+	const unsigned src_shift = WORKING_DEPTH - format_in[0].depth;
+	const double src_max = static_cast<double>(depth::numeric_max(format_in[0].depth) << src_shift);
+
+	// Coefficients in units of the output per unit of the shifted input.
+	double c[3][3];
+	double bias[3];
+
+	for (unsigned i = 0; i < 3; ++i) {
+		double range_out = depth::integer_range(format_out[i]);
+		double offset_out = depth::integer_offset(format_out[i]);
+
+		bias[i] = offset_out;
+
+		for (unsigned j = 0; j < 3; ++j) {
+			double range_in = depth::integer_range(format_in[j]);
+			double offset_in = depth::integer_offset(format_in[j]);
+
+			c[i][j] = m[i][j] * range_out / range_in / (1U << src_shift);
+			bias[i] -= m[i][j] * range_out * offset_in / range_in;
+		}
+	}
+
+	// The largest shift which fits the coefficients and accumulator is the most accurate.
+	for (unsigned shift = MAX_SHIFT; shift > 0; --shift) {
+		const double mul = static_cast<double>(1UL << shift);
+		MatrixIntCoeffs result{};
+		bool ok = true;
+		double error = 0.0;
+
+		for (unsigned i = 0; i < 3 && ok; ++i) {
+			double bound = 0.0;
+			double row_error = 0.0;
+
+			for (unsigned j = 0; j < 3; ++j) {
+				double x = std::round(c[i][j] * mul);
+				ok = ok && std::fabs(x) <= INT16_MAX;
+				result.c[i][j] = ok ? static_cast<int16_t>(x) : 0;
+				bound += std::fabs(x) * src_max;
+				row_error += std::fabs(x / mul - c[i][j]) * src_max;
+			}
+
+			double b = std::round(bias[i] * mul);
+			row_error += std::fabs(b / mul - bias[i]);
+			b += static_cast<double>(1UL << (shift - 1));
+			bound += std::fabs(b);
+			ok = ok && bound <= INT32_MAX;
+			result.bias[i] = ok ? static_cast<int32_t>(b) : 0;
+			error = std::max(error, row_error);
+		}
+
+		if (!ok)
+			continue;
+		if (error > MAX_ERROR)
+			return false;
+
+		result.src_shift = src_shift;
+		result.shift = shift;
+		result.max = static_cast<uint16_t>(depth::numeric_max(format_out[0].depth));
+		*coeffs = result;
+		return true;
+	}
+
+	return false;
+}
+
+std::unique_ptr<graphengine::Filter> create_matrix_int_filter(const ColorspaceDefinition &csp_in, const ColorspaceDefinition &csp_out,
+                                                              const PixelFormat format_in[3], const PixelFormat format_out[3],
+                                                              unsigned width, unsigned height, CPUClass cpu)
+{
+	if (csp_in.transfer != csp_out.transfer || csp_in.primaries != csp_out.primaries)
+		return nullptr;
+	if (!is_ncl_matrix(csp_in.matrix) || !is_ncl_matrix(csp_out.matrix))
+		return nullptr;
+	if ((csp_in.matrix == MatrixCoefficients::CHROMATICITY_DERIVED_NCL || csp_out.matrix == MatrixCoefficients::CHROMATICITY_DERIVED_NCL) &&
+		csp_in.primaries == ColorPrimaries::UNSPECIFIED)
+	{
+		return nullptr;
+	}
+
+	for (unsigned p = 1; p < 3; ++p) {
+		if (format_in[p].type != format_in[0].type || format_out[p].type != format_out[0].type)
+			return nullptr;
+	}
+
+	MatrixIntCoeffs coeffs;
+	if (!compute_matrix_int_coeffs(from_rgb_matrix(csp_out) * to_rgb_matrix(csp_in), format_in, format_out, &coeffs))
+		return nullptr;
+
+	return std::make_unique<MatrixIntFilter>(coeffs, format_in[0].type, format_out[0].type, width, height, cpu);
+}
+
+
+matrix_int_func select_matrix_int_func(PixelType type_in, PixelType type_out, CPUClass cpu)
+{
+	matrix_int_func func = nullptr;
+
+#if defined(ZIMG_X86)
+	func = select_matrix_int_func_x86(type_in, type_out, cpu);
+#endif
+
+	if (!func && type_in == PixelType::BYTE && type_out == PixelType::BYTE)
+		func = matrix_int_c<uint8_t, uint8_t>;
+	if (!func && type_in == PixelType::BYTE && type_out == PixelType::WORD)
+		func = matrix_int_c<uint8_t, uint16_t>;
+	if (!func && type_in == PixelType::WORD && type_out == PixelType::BYTE)
+		func = matrix_int_c<uint16_t, uint8_t>;
+	if (!func && type_in == PixelType::WORD && type_out == PixelType::WORD)
+		func = matrix_int_c<uint16_t, uint16_t>;
+	if (!func)
+		error::throw_<error::InternalError>("unsupported pixel type");
+
+	return func;
+}
+
+} // namespace zimg::colorspace
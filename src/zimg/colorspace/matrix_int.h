@@ -0,0 +1,80 @@
+#pragma once
+
+#ifndef ZIMG_COLORSPACE_MATRIX_INT_H_
+#define ZIMG_COLORSPACE_MATRIX_INT_H_
+
+#include <cstdint>
+#include <memory>
+#include "graph/filter_base.h"
+
+namespace zimg {
+enum class CPUClass;
+enum class PixelType;
+struct PixelFormat;
+}
+
+namespace zimg::colorspace {
+
+struct ColorspaceDefinition;
+struct Matrix3x3;
+
+/**
+ * Fixed-point form of a matrix applied to integer samples.
+ *
+ * Inputs are shifted left by |src_shift|, so that every depth spans 14 bits.
+ * Each output is then computed as (c[i] . x + bias[i]) >> shift, clamped to
+ * [0, max]. The rounding term is included in |bias|.
+ */
+struct MatrixIntCoeffs {
+	int16_t c[3][3];
+	int32_t bias[3];
+	unsigned src_shift;
+	unsigned shift;
+	uint16_t max;
+};
+
+typedef void (*matrix_int_func)(const MatrixIntCoeffs &coeffs, const void * const src[3], void * const dst[3], unsigned left, unsigned right);
+
+/**
+ * Applies a YUV/RGB matrix to three integer planes without converting them to
+ * float. Range and depth conversions are folded into the coefficients.
+ */
+class MatrixIntFilter : public graph::PointFilter {
+	MatrixIntCoeffs m_coeffs;
+	matrix_int_func m_func;
+public:
+	MatrixIntFilter(const MatrixIntCoeffs &coeffs, PixelType type_in, PixelType type_out, unsigned width, unsigned height, CPUClass cpu);
+
+	void process(const graphengine::BufferDescriptor in[3], const graphengine::BufferDescriptor out[3],
+	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override;
+};
+
+/**
+ * Compute the fixed-point coefficients for a matrix between integer formats.
+ *
+ * @param m matrix in the normalized (float) domain
+ * @param format_in formats of the three input planes
+ * @param format_out formats of the three output planes
+ * @param coeffs receives the coefficients
+ * @return true if the result is accurate to within one unit of the output
+ */
+bool compute_matrix_int_coeffs(const Matrix3x3 &m, const PixelFormat format_in[3], const PixelFormat format_out[3], MatrixIntCoeffs *coeffs);
+
+/**
+ * Create a filter converting between colorspaces that differ only in
+ * non-constant luminance matrix coefficients.
+ *
+ * Inputs and outputs must be integer planes of at most 12 bits.
+ *
+ * @return filter, or nullptr if the conversion is not a single matrix or can
+ *         not be represented accurately in fixed point
+ */
+std::unique_ptr<graphengine::Filter> create_matrix_int_filter(const ColorspaceDefinition &csp_in, const ColorspaceDefinition &csp_out,
+                                                              const PixelFormat format_in[3], const PixelFormat format_out[3],
+                                                              unsigned width, unsigned height, CPUClass cpu);
+
+matrix_int_func select_matrix_int_func(PixelType type_in, PixelType type_out, CPUClass cpu);
+
+} // namespace zimg::colorspace
+
+#endif // ZIMG_COLORSPACE_MATRIX_INT_H_
@@ -9,18 +9,13 @@
 
 namespace zimg::colorspace {
 
-namespace {
+Operation::~Operation() = default;
 
 bool use_display_referred_b67(ColorPrimaries primaries, const OperationParams &params)
 {
 	return primaries != ColorPrimaries::UNSPECIFIED && !params.approximate_gamma && !params.scene_referred;
 }
 
-} // namespace
-
-
-Operation::~Operation() = default;
-
 std::unique_ptr<Operation> create_ncl_yuv_to_rgb_operation(const ColorspaceDefinition &in, const ColorspaceDefinition &out, const OperationParams &params, CPUClass cpu)
 {
 	zassert_d(in.transfer == out.transfer, "transfer mismatch");
@@ -69,7 +64,7 @@ std::unique_ptr<Operation> create_gamma_to_linear_operation(const ColorspaceDefi
 	zassert_d(in.transfer != TransferCharacteristics::LINEAR && out.transfer == TransferCharacteristics::LINEAR, "wrong transfer characteristics");
 
 	if (in.transfer == TransferCharacteristics::ARIB_B67 && use_display_referred_b67(in.primaries, params))
-		return create_inverse_arib_b67_operation(ncl_rgb_to_yuv_matrix_from_primaries(in.primaries), params);
+		return create_inverse_arib_b67_operation(ncl_rgb_to_yuv_matrix_from_primaries(in.primaries), params, cpu);
 	else
 		return create_inverse_gamma_operation(select_transfer_function(in.transfer, params.peak_luminance, params.scene_referred), params, cpu);
 }
@@ -82,7 +77,7 @@ std::unique_ptr<Operation> create_linear_to_gamma_operation(const ColorspaceDefi
 	zassert_d(in.transfer == TransferCharacteristics::LINEAR && out.transfer != TransferCharacteristics::LINEAR, "wrong transfer characteristics");
 
 	if (out.transfer == TransferCharacteristics::ARIB_B67 && use_display_referred_b67(out.primaries, params))
-		return create_arib_b67_operation(ncl_rgb_to_yuv_matrix_from_primaries(out.primaries), params);
+		return create_arib_b67_operation(ncl_rgb_to_yuv_matrix_from_primaries(out.primaries), params, cpu);
 	else
 		return create_gamma_operation(select_transfer_function(out.transfer, params.peak_luminance, params.scene_referred), params, cpu);
 }
@@ -13,6 +13,7 @@ enum class CPUClass;
 namespace zimg::colorspace {
 
 struct ColorspaceDefinition;
+struct Matrix3x3;
 
 enum class MatrixCoefficients;
 enum class TransferCharacteristics;
@@ -59,6 +60,15 @@ public:
 	 */
 	virtual unsigned alignment_mask() const noexcept = 0;
 
+	/**
+	 * Get the matrix applied by the operation, if it is a linear transform.
+	 *
+	 * Consecutive matrix operations can be merged into a single operation.
+	 *
+	 * @return pointer to matrix, or nullptr if operation is non-linear
+	 */
+	virtual const Matrix3x3 *matrix() const noexcept { return nullptr; }
+
 	/**
 	 * Apply operation to pixels.
 	 *
@@ -70,6 +80,16 @@ public:
 	virtual void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept = 0;
 };
 
+/**
+ * Check if ARIB STD-B67 is converted with the display-referred EOTF, which
+ * depends on all three channels.
+ *
+ * @param primaries color primaries
+ * @param params parameters
+ * @return true if display-referred
+ */
+bool use_display_referred_b67(ColorPrimaries primaries, const OperationParams &params);
+
 /**
  * Create an operation converting from YUV to RGB via a 3x3 matrix.
  *
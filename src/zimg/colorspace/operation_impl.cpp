@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cfloat>
+#include <utility>
 #include "common/zassert.h"
 #include "colorspace.h"
 #include "colorspace_param.h"
@@ -12,6 +13,8 @@
   #include "x86/operation_impl_x86.h"
 #elif defined(ZIMG_ARM)
   #include "arm/operation_impl_arm.h"
+#elif defined(ZIMG_VEC)
+  #include "vec/operation_impl_vec.h"
 #endif
 
 namespace zimg::colorspace {
@@ -284,10 +287,61 @@ public:
 	}
 };
 
+class Lut3DOperationC final : public OperationC {
+	std::shared_ptr<const Lut3D> m_lut;
+public:
+	explicit Lut3DOperationC(std::shared_ptr<const Lut3D> lut) : m_lut(std::move(lut)) {}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
+	{
+		const float *lut = m_lut->data.data();
+		const float limit = static_cast<float>(m_lut->size - 1);
+		const unsigned stride[3] = { 3, 3 * m_lut->size, 3 * m_lut->size * m_lut->size };
+
+		for (unsigned i = left; i < right; ++i) {
+			float frac[3];
+			unsigned base = 0;
+
+			for (unsigned c = 0; c < 3; ++c) {
+				// Operand order maps NaN to zero.
+				float x = std::min(std::max(0.0f, src[c][i] * m_lut->scale[c] + m_lut->offset[c]), limit);
+				unsigned idx = std::min(static_cast<unsigned>(x), m_lut->size - 2);
+
+				frac[c] = x - static_cast<float>(idx);
+				base += idx * stride[c];
+			}
+
+			// Select the tetrahedron containing the point. The first vertex moves
+			// along the axis of the largest fraction, the second vertex along all
+			// but the axis of the smallest fraction.
+			unsigned axis_max = frac[0] >= frac[1] && frac[0] >= frac[2] ? 0 : frac[1] >= frac[2] ? 1 : 2;
+			unsigned axis_min = frac[2] <= frac[0] && frac[2] <= frac[1] ? 2 : frac[1] <= frac[0] ? 1 : 0;
+
+			float f_max = frac[axis_max];
+			float f_min = frac[axis_min];
+			float f_mid = frac[0] + frac[1] + frac[2] - f_max - f_min;
+
+			const float *v0 = lut + base;
+			const float *v1 = v0 + stride[axis_max];
+			const float *v2 = v0 + stride[0] + stride[1] + stride[2] - stride[axis_min];
+			const float *v3 = v0 + stride[0] + stride[1] + stride[2];
+
+			float w0 = 1.0f - f_max;
+			float w1 = f_max - f_mid;
+			float w2 = f_mid - f_min;
+			float w3 = f_min;
+
+			for (unsigned c = 0; c < 3; ++c) {
+				dst[c][i] = w0 * v0[c] + w1 * v1[c] + w2 * v2[c] + w3 * v3[c];
+			}
+		}
+	}
+};
+
 } // namespace
 
 
-MatrixOperationImpl::MatrixOperationImpl(const Matrix3x3 &m)
+MatrixOperationImpl::MatrixOperationImpl(const Matrix3x3 &m) : m_source{ m }
 {
 	for (int i = 0; i < 3; ++i) {
 		for (int j = 0; j < 3; ++j) {
@@ -305,6 +359,8 @@ std::unique_ptr<Operation> create_matrix_operation(const Matrix3x3 &m, CPUClass
 	ret = create_matrix_operation_x86(m, cpu);
 #elif defined(ZIMG_ARM)
 	ret = create_matrix_operation_arm(m, cpu);
+#elif defined(ZIMG_VEC)
+	ret = create_matrix_operation_vec(m, cpu);
 #endif
 	if (!ret)
 		ret = std::make_unique<MatrixOperationC>(m);
@@ -342,20 +398,36 @@ std::unique_ptr<Operation> create_inverse_gamma_operation(const TransferFunction
 	return ret;
 }
 
-std::unique_ptr<Operation> create_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params)
+std::unique_ptr<Operation> create_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params, CPUClass cpu)
 {
 	zassert_d(!params.scene_referred, "must be display-referred");
 
 	TransferFunction func = select_transfer_function(TransferCharacteristics::ARIB_B67, params.peak_luminance, false);
-	return std::make_unique<AribB67OperationC>(m[0][0], m[0][1], m[0][2], func.to_gamma_scale);
+	std::unique_ptr<Operation> ret;
+
+#if defined(ZIMG_X86)
+	ret = create_arib_b67_operation_x86(m, func, params, cpu);
+#endif
+	if (!ret)
+		ret = std::make_unique<AribB67OperationC>(m[0][0], m[0][1], m[0][2], func.to_gamma_scale);
+
+	return ret;
 }
 
-std::unique_ptr<Operation> create_inverse_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params)
+std::unique_ptr<Operation> create_inverse_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params, CPUClass cpu)
 {
 	zassert_d(!params.scene_referred, "must be display-referred");
 
 	TransferFunction func = select_transfer_function(TransferCharacteristics::ARIB_B67, params.peak_luminance, false);
-	return std::make_unique<AribB67InverseOperationC>(m[0][0], m[0][1], m[0][2], func.to_linear_scale);
+	std::unique_ptr<Operation> ret;
+
+#if defined(ZIMG_X86)
+	ret = create_inverse_arib_b67_operation_x86(m, func, params, cpu);
+#endif
+	if (!ret)
+		ret = std::make_unique<AribB67InverseOperationC>(m[0][0], m[0][1], m[0][2], func.to_linear_scale);
+
+	return ret;
 }
 
 std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation(const ColorspaceDefinition &in, const ColorspaceDefinition &out, const OperationParams &params, CPUClass cpu)
@@ -367,7 +439,15 @@ std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation(const ColorspaceDefini
 	// CL is always scene-referred.
 	TransferFunction func = select_transfer_function(in.transfer, params.peak_luminance, true);
 	Matrix3x3 m = in.matrix == MatrixCoefficients::CHROMATICITY_DERIVED_CL ? ncl_rgb_to_yuv_matrix_from_primaries(in.primaries) : ncl_rgb_to_yuv_matrix(in.matrix);
-	return std::make_unique<CLToRGBOperationC>(func.to_gamma, func.to_linear, m[0][0], m[0][1], m[0][2], func.to_linear_scale);
+	std::unique_ptr<Operation> ret;
+
+#if defined(ZIMG_X86)
+	ret = create_cl_yuv_to_rgb_operation_x86(m, func, params, cpu);
+#endif
+	if (!ret)
+		ret = std::make_unique<CLToRGBOperationC>(func.to_gamma, func.to_linear, m[0][0], m[0][1], m[0][2], func.to_linear_scale);
+
+	return ret;
 }
 
 std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation(const ColorspaceDefinition &in, const ColorspaceDefinition &out, const OperationParams &params, CPUClass cpu)
@@ -379,7 +459,31 @@ std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation(const ColorspaceDefini
 	// CL is always scene-referred.
 	TransferFunction func = select_transfer_function(out.transfer, params.peak_luminance, true);
 	Matrix3x3 m = out.matrix == MatrixCoefficients::CHROMATICITY_DERIVED_CL ? ncl_rgb_to_yuv_matrix_from_primaries(out.primaries) : ncl_rgb_to_yuv_matrix(out.matrix);
-	return std::make_unique<CLToYUVOperationC>(func.to_gamma, m[0][0], m[0][1], m[0][2], func.to_gamma_scale);
+	std::unique_ptr<Operation> ret;
+
+#if defined(ZIMG_X86)
+	ret = create_cl_rgb_to_yuv_operation_x86(m, func, params, cpu);
+#endif
+	if (!ret)
+		ret = std::make_unique<CLToYUVOperationC>(func.to_gamma, m[0][0], m[0][1], m[0][2], func.to_gamma_scale);
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_lut3d_operation(const std::shared_ptr<const Lut3D> &lut, CPUClass cpu)
+{
+	zassert_d(lut->size >= 2, "lattice too small");
+	zassert_d(lut->data.size() == static_cast<size_t>(lut->size) * lut->size * lut->size * 3, "wrong lattice size");
+
+	std::unique_ptr<Operation> ret;
+
+#if defined(ZIMG_X86)
+	ret = create_lut3d_operation_x86(lut, cpu);
+#endif
+	if (!ret)
+		ret = std::make_unique<Lut3DOperationC>(lut);
+
+	return ret;
 }
 
 } // namespace zimg::colorspace
@@ -3,7 +3,10 @@
 #ifndef ZIMG_COLORSPACE_OPERATION_IMPL_H_
 #define ZIMG_COLORSPACE_OPERATION_IMPL_H_
 
+#include <memory>
+#include <vector>
 #include "common/libm_wrapper.h"
+#include "matrix3.h"
 #include "operation.h"
 
 namespace zimg {
@@ -12,13 +15,13 @@ enum class CPUClass;
 
 namespace zimg::colorspace {
 
-struct Matrix3x3;
 struct TransferFunction;
 
 /**
  * Base class for matrix operation implementations.
  */
 class MatrixOperationImpl : public Operation {
+	Matrix3x3 m_source;
 protected:
 	/**
 	 * Transformation matrix.
@@ -31,6 +34,22 @@ protected:
 	 * @param m transformation matrix
 	 */
 	explicit MatrixOperationImpl(const Matrix3x3 &matrix);
+public:
+	const Matrix3x3 *matrix() const noexcept override { return &m_source; }
+};
+
+/**
+ * Output triplets sampled on a regular lattice of input triplets.
+ *
+ * Lattice coordinates are obtained from input values as (x * scale + offset)
+ * and clamped to [0, size - 1]. Triplets are stored interleaved, with the
+ * first channel varying fastest.
+ */
+struct Lut3D {
+	unsigned size;
+	float scale[3];
+	float offset[3];
+	std::vector<float> data;
 };
 
 /**
@@ -64,18 +83,29 @@ std::unique_ptr<Operation> create_inverse_gamma_operation(const TransferFunction
  *
  * @param m RGB to YUV conversion matrix for color primaries
  * @param params parameters
+ * @param cpu create operation optimized for given cpu
  * @return concrete operation
  */
-std::unique_ptr<Operation> create_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params);
+std::unique_ptr<Operation> create_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params, CPUClass cpu);
 
 /**
  * Create operation consisting of converting ARIB STD-B67 to linear light using display-referred EOTF.
  *
  * @param m RGB to YUV conversion matrix for color primaries
  * @param params parameters
+ * @param cpu create operation optimized for given cpu
+ * @return concrete operation
+ */
+std::unique_ptr<Operation> create_inverse_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params, CPUClass cpu);
+
+/**
+ * Create operation consisting of tetrahedral interpolation in a 3D LUT.
+ *
+ * @param lut lookup table, shared with the operation
+ * @param cpu create operation optimized for given cpu
  * @return concrete operation
  */
-std::unique_ptr<Operation> create_inverse_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params);
+std::unique_ptr<Operation> create_lut3d_operation(const std::shared_ptr<const Lut3D> &lut, CPUClass cpu);
 
 } // namespace zimg::colorspace
 
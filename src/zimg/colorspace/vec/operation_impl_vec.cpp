@@ -0,0 +1,78 @@
+#ifdef ZIMG_VEC
+
+#include <algorithm>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "common/cpuinfo.h"
+#include "colorspace/operation_impl.h"
+#include "operation_impl_vec.h"
+
+#include "common/vec/vec_util.h"
+
+namespace zimg::colorspace {
+
+namespace {
+
+class MatrixOperationVec final : public MatrixOperationImpl {
+	void process_scalar(const float * const *src, float * const *dst, unsigned i) const
+	{
+		float a = src[0][i];
+		float b = src[1][i];
+		float c = src[2][i];
+
+		dst[0][i] = m_matrix[0][0] * a + m_matrix[0][1] * b + m_matrix[0][2] * c;
+		dst[1][i] = m_matrix[1][0] * a + m_matrix[1][1] * b + m_matrix[1][2] * c;
+		dst[2][i] = m_matrix[2][0] * a + m_matrix[2][1] * b + m_matrix[2][2] * c;
+	}
+public:
+	explicit MatrixOperationVec(const Matrix3x3 &m) : MatrixOperationImpl(m) {}
+
+	unsigned alignment_mask() const noexcept override { return 0; }
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
+	{
+		f32x4 coeffs[3][3];
+
+		for (unsigned k = 0; k < 3; ++k) {
+			for (unsigned kk = 0; kk < 3; ++kk) {
+				coeffs[k][kk] = f32x4{} + m_matrix[k][kk];
+			}
+		}
+
+		unsigned vec_left = std::min(ceil_n(left, 4), right);
+		unsigned vec_right = std::max(floor_n(right, 4), vec_left);
+
+		for (unsigned i = left; i < vec_left; ++i) {
+			process_scalar(src, dst, i);
+		}
+
+		for (unsigned i = vec_left; i < vec_right; i += 4) {
+			f32x4 a = vec_load<f32x4>(src[0] + i);
+			f32x4 b = vec_load<f32x4>(src[1] + i);
+			f32x4 c = vec_load<f32x4>(src[2] + i);
+
+			for (unsigned k = 0; k < 3; ++k) {
+				vec_store(dst[k] + i, coeffs[k][0] * a + coeffs[k][1] * b + coeffs[k][2] * c);
+			}
+		}
+
+		for (unsigned i = vec_right; i < right; ++i) {
+			process_scalar(src, dst, i);
+		}
+	}
+};
+
+} // namespace
+
+
+std::unique_ptr<Operation> create_matrix_operation_vec(const Matrix3x3 &m, CPUClass cpu)
+{
+	if (cpu_is_autodetect(cpu) || cpu >= CPUClass::GENERIC_VEC)
+		return std::make_unique<MatrixOperationVec>(m);
+	else
+		return nullptr;
+}
+
+} // namespace zimg::colorspace
+
+#endif // ZIMG_VEC
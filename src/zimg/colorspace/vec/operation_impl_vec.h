@@ -0,0 +1,25 @@
+#pragma once
+
+#ifdef ZIMG_VEC
+
+#ifndef ZIMG_COLORSPACE_VEC_OPERATION_IMPL_VEC_H_
+#define ZIMG_COLORSPACE_VEC_OPERATION_IMPL_VEC_H_
+
+#include <memory>
+
+namespace zimg {
+enum class CPUClass;
+}
+
+namespace zimg::colorspace {
+
+struct Matrix3x3;
+class Operation;
+
+std::unique_ptr<Operation> create_matrix_operation_vec(const Matrix3x3 &m, CPUClass cpu);
+
+} // namespace zimg::colorspace
+
+#endif // ZIMG_COLORSPACE_VEC_OPERATION_IMPL_VEC_H_
+
+#endif // ZIMG_VEC
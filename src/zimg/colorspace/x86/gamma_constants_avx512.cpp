@@ -190,6 +190,27 @@ const float ST2084InverseEOTF::horner4 alignas(64)[32] = {
 	5.8636643e-1f, 6.6135799e-1f, 7.3766392e-1f, 0.0000000e+0f, // [-3, -1], [-inf, -32]
 };
 
+// 2 / ln(2) / (2k + 1), k = 4..0.
+const float Log2::horner[5] = {
+	3.2059889797532520e-1f,
+	4.1219858311113240e-1f,
+	5.7707801635558535e-1f,
+	9.6179669392597560e-1f,
+	2.8853900817779268e+0f,
+};
+
+// ln(2)^k / k!, k = 7..0.
+const float Exp2::horner[8] = {
+	1.5252733804059840e-5f,
+	1.5403530393381608e-4f,
+	1.3333558146428443e-3f,
+	9.6181291076284772e-3f,
+	5.5504108664821580e-2f,
+	2.4022650695910071e-1f,
+	6.9314718055994531e-1f,
+	1.0000000000000000e+0f,
+};
+
 
 // Debug implementations.
 namespace {
@@ -315,6 +336,47 @@ float st_2084_inverse_eotf(float x)
 	return segmented_polynomial<ST2084InverseEOTF, true>(x);
 }
 
+float log2_approx(float x)
+{
+	float mant, t, t2, result;
+	int exp;
+
+	x = std::max(x, FLT_MIN);
+
+	// Decompose into mantissa on [0.75, 1.5) and exponent.
+	mant = std::frexp(x, &exp);
+	if (mant < 0.75f) {
+		mant *= 2.0f;
+		exp -= 1;
+	}
+
+	t = (mant - 1.0f) / (mant + 1.0f);
+	t2 = t * t;
+
+	result = Log2::horner[0];
+	for (unsigned i = 1; i < sizeof(Log2::horner) / sizeof(Log2::horner[0]); ++i) {
+		result = std::fma(result, t2, Log2::horner[i]);
+	}
+
+	return std::fma(result, t, static_cast<float>(exp));
+}
+
+float exp2_approx(float x)
+{
+	float n, result;
+
+	x = std::clamp(x, -125.0f, 127.0f);
+	n = std::nearbyint(x);
+	x = x - n;
+
+	result = Exp2::horner[0];
+	for (unsigned i = 1; i < sizeof(Exp2::horner) / sizeof(Exp2::horner[0]); ++i) {
+		result = std::fma(result, x, Exp2::horner[i]);
+	}
+
+	return std::ldexp(result, static_cast<int>(n));
+}
+
 } // namespace avx512constants
 } // namespace zimg::colorspace
 
@@ -60,6 +60,28 @@ struct ST2084InverseEOTF {
 	static const float horner4 alignas(64)[32];
 };
 
+struct Log2 {
+	// 9-th order odd polynomial in t = (m - 1) / (m + 1) for mantissa on domain [0.75, 1.5).
+	// Only the even coefficients are stored, evaluated in t^2.
+	static const float horner[5];
+};
+
+struct Exp2 {
+	// 7-th order polynomial on domain [-0.5, 0.5].
+	static const float horner[8];
+};
+
+struct Rec709OETF {
+	static constexpr float alpha = 1.09929682680944f;
+	static constexpr float beta = 0.018053968510807f;
+};
+
+struct AribB67OETF {
+	static constexpr float a = 0.17883277f;
+	static constexpr float b = 0.28466892f;
+	static constexpr float c = 0.55991073f;
+};
+
 // Debug implementations.
 float rec_1886_eotf(float x);
 float rec_1886_inverse_eotf(float x);
@@ -70,6 +92,9 @@ float srgb_inverse_eotf(float x);
 float st_2084_eotf(float x);
 float st_2084_inverse_eotf(float x);
 
+float log2_approx(float x);
+float exp2_approx(float x);
+
 } // namespace avx512constants
 } // namespace zimg::colorspace
 
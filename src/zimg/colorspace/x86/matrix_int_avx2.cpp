@@ -0,0 +1,134 @@
+#ifdef ZIMG_X86
+
+#include <algorithm>
+#include <cstdint>
+#include <immintrin.h>
+#include "common/ccdep.h"
+#include "matrix_int_x86.h"
+
+namespace zimg::colorspace {
+
+namespace {
+
+struct LoadU8 {
+	typedef uint8_t src_type;
+
+	static inline FORCE_INLINE __m256i load16(const uint8_t *ptr) { return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)ptr)); }
+};
+
+struct LoadU16 {
+	typedef uint16_t src_type;
+
+	static inline FORCE_INLINE __m256i load16(const uint16_t *ptr) { return _mm256_loadu_si256((const __m256i *)ptr); }
+};
+
+struct StoreU8 {
+	typedef uint8_t dst_type;
+
+	static inline FORCE_INLINE void store16(uint8_t *ptr, __m256i x)
+	{
+		x = _mm256_packus_epi16(x, x);
+		x = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 1, 2, 0));
+		_mm_storeu_si128((__m128i *)ptr, _mm256_castsi256_si128(x));
+	}
+};
+
+struct StoreU16 {
+	typedef uint16_t dst_type;
+
+	static inline FORCE_INLINE void store16(uint16_t *ptr, __m256i x) { _mm256_storeu_si256((__m256i *)ptr, x); }
+};
+
+inline FORCE_INLINE __m256i pack_coeffs(int16_t a, int16_t b)
+{
+	return _mm256_set1_epi32(static_cast<int32_t>(static_cast<uint16_t>(a) | (static_cast<uint32_t>(static_cast<uint16_t>(b)) << 16)));
+}
+
+template <class Load, class Store>
+void matrix_int_avx2(const MatrixIntCoeffs &coeffs, const void * const src[3], void * const dst[3], unsigned left, unsigned right)
+{
+	typedef typename Load::src_type T;
+	typedef typename Store::dst_type U;
+
+	const T *src0 = static_cast<const T *>(src[0]);
+	const T *src1 = static_cast<const T *>(src[1]);
+	const T *src2 = static_cast<const T *>(src[2]);
+	U *dst_p[3] = { static_cast<U *>(dst[0]), static_cast<U *>(dst[1]), static_cast<U *>(dst[2]) };
+
+	const __m128i src_shift = _mm_cvtsi32_si128(coeffs.src_shift);
+	const __m128i shift = _mm_cvtsi32_si128(coeffs.shift);
+	const __m256i max = _mm256_set1_epi16(static_cast<int16_t>(coeffs.max));
+
+	// The first two inputs are interleaved and the third is paired with zero,
+	// so that each output takes two multiply-adds.
+	__m256i c01[3];
+	__m256i c2[3];
+	__m256i bias[3];
+
+	for (unsigned p = 0; p < 3; ++p) {
+		c01[p] = pack_coeffs(coeffs.c[p][0], coeffs.c[p][1]);
+		c2[p] = pack_coeffs(coeffs.c[p][2], 0);
+		bias[p] = _mm256_set1_epi32(coeffs.bias[p]);
+	}
+
+	unsigned j;
+
+	for (j = left; j + 16 <= right; j += 16) {
+		__m256i x0 = _mm256_sll_epi16(Load::load16(src0 + j), src_shift);
+		__m256i x1 = _mm256_sll_epi16(Load::load16(src1 + j), src_shift);
+		__m256i x2 = _mm256_sll_epi16(Load::load16(src2 + j), src_shift);
+
+		__m256i x01_lo = _mm256_unpacklo_epi16(x0, x1);
+		__m256i x01_hi = _mm256_unpackhi_epi16(x0, x1);
+		__m256i x2_lo = _mm256_unpacklo_epi16(x2, _mm256_setzero_si256());
+		__m256i x2_hi = _mm256_unpackhi_epi16(x2, _mm256_setzero_si256());
+
+		for (unsigned p = 0; p < 3; ++p) {
+			__m256i lo = _mm256_add_epi32(_mm256_madd_epi16(x01_lo, c01[p]), _mm256_madd_epi16(x2_lo, c2[p]));
+			__m256i hi = _mm256_add_epi32(_mm256_madd_epi16(x01_hi, c01[p]), _mm256_madd_epi16(x2_hi, c2[p]));
+
+			lo = _mm256_sra_epi32(_mm256_add_epi32(lo, bias[p]), shift);
+			hi = _mm256_sra_epi32(_mm256_add_epi32(hi, bias[p]), shift);
+
+			__m256i out = _mm256_min_epu16(_mm256_packus_epi32(lo, hi), max);
+			Store::store16(dst_p[p] + j, out);
+		}
+	}
+	for (; j < right; ++j) {
+		int32_t x0 = static_cast<int32_t>(src0[j]) << coeffs.src_shift;
+		int32_t x1 = static_cast<int32_t>(src1[j]) << coeffs.src_shift;
+		int32_t x2 = static_cast<int32_t>(src2[j]) << coeffs.src_shift;
+
+		for (unsigned p = 0; p < 3; ++p) {
+			int32_t accum = coeffs.c[p][0] * x0 + coeffs.c[p][1] * x1 + coeffs.c[p][2] * x2 + coeffs.bias[p];
+			dst_p[p][j] = static_cast<U>(std::clamp<int32_t>(accum >> coeffs.shift, 0, coeffs.max));
+		}
+	}
+}
+
+} // namespace
+
+
+void matrix_int_b2b_avx2(const MatrixIntCoeffs &coeffs, const void * const src[3], void * const dst[3], unsigned left, unsigned right)
+{
+	matrix_int_avx2<LoadU8, StoreU8>(coeffs, src, dst, left, right);
+}
+
+void matrix_int_b2w_avx2(const MatrixIntCoeffs &coeffs, const void * const src[3], void * const dst[3], unsigned left, unsigned right)
+{
+	matrix_int_avx2<LoadU8, StoreU16>(coeffs, src, dst, left, right);
+}
+
+void matrix_int_w2b_avx2(const MatrixIntCoeffs &coeffs, const void * const src[3], void * const dst[3], unsigned left, unsigned right)
+{
+	matrix_int_avx2<LoadU16, StoreU8>(coeffs, src, dst, left, right);
+}
+
+void matrix_int_w2w_avx2(const MatrixIntCoeffs &coeffs, const void * const src[3], void * const dst[3], unsigned left, unsigned right)
+{
+	matrix_int_avx2<LoadU16, StoreU16>(coeffs, src, dst, left, right);
+}
+
+} // namespace zimg::colorspace
+
+#endif // ZIMG_X86
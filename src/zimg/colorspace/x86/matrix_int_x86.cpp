@@ -0,0 +1,65 @@
+#ifdef ZIMG_X86
+
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "matrix_int_x86.h"
+
+namespace zimg::colorspace {
+
+namespace {
+
+matrix_int_func select_matrix_int_func_avx2(PixelType type_in, PixelType type_out)
+{
+	if (type_in == PixelType::BYTE && type_out == PixelType::BYTE)
+		return matrix_int_b2b_avx2;
+	else if (type_in == PixelType::BYTE && type_out == PixelType::WORD)
+		return matrix_int_b2w_avx2;
+	else if (type_in == PixelType::WORD && type_out == PixelType::BYTE)
+		return matrix_int_w2b_avx2;
+	else if (type_in == PixelType::WORD && type_out == PixelType::WORD)
+		return matrix_int_w2w_avx2;
+	else
+		return nullptr;
+}
+
+matrix_int_func select_matrix_int_func_avx512(PixelType type_in, PixelType type_out)
+{
+	if (type_in == PixelType::BYTE && type_out == PixelType::BYTE)
+		return matrix_int_b2b_avx512;
+	else if (type_in == PixelType::BYTE && type_out == PixelType::WORD)
+		return matrix_int_b2w_avx512;
+	else if (type_in == PixelType::WORD && type_out == PixelType::BYTE)
+		return matrix_int_w2b_avx512;
+	else if (type_in == PixelType::WORD && type_out == PixelType::WORD)
+		return matrix_int_w2w_avx512;
+	else
+		return nullptr;
+}
+
+} // namespace
+
+
+matrix_int_func select_matrix_int_func_x86(PixelType type_in, PixelType type_out, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	matrix_int_func func = nullptr;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!func && cpu == CPUClass::AUTO_64B && caps.avx512f && caps.avx512bw)
+			func = select_matrix_int_func_avx512(type_in, type_out);
+		if (!func && caps.avx2)
+			func = select_matrix_int_func_avx2(type_in, type_out);
+	} else {
+		if (!func && cpu >= CPUClass::X86_AVX512)
+			func = select_matrix_int_func_avx512(type_in, type_out);
+		if (!func && cpu >= CPUClass::X86_AVX2)
+			func = select_matrix_int_func_avx2(type_in, type_out);
+	}
+
+	return func;
+}
+
+} // namespace zimg::colorspace
+
+#endif // ZIMG_X86
@@ -0,0 +1,33 @@
+#pragma once
+
+#ifdef ZIMG_X86
+
+#ifndef ZIMG_COLORSPACE_X86_MATRIX_INT_X86_H_
+#define ZIMG_COLORSPACE_X86_MATRIX_INT_X86_H_
+
+#include "colorspace/matrix_int.h"
+
+namespace zimg::colorspace {
+
+#define DECLARE_MATRIX_INT(x, cpu) \
+void matrix_int_##x##_##cpu(const MatrixIntCoeffs &coeffs, const void * const src[3], void * const dst[3], unsigned left, unsigned right)
+
+DECLARE_MATRIX_INT(b2b, avx2);
+DECLARE_MATRIX_INT(b2w, avx2);
+DECLARE_MATRIX_INT(w2b, avx2);
+DECLARE_MATRIX_INT(w2w, avx2);
+
+DECLARE_MATRIX_INT(b2b, avx512);
+DECLARE_MATRIX_INT(b2w, avx512);
+DECLARE_MATRIX_INT(w2b, avx512);
+DECLARE_MATRIX_INT(w2w, avx512);
+
+#undef DECLARE_MATRIX_INT
+
+matrix_int_func select_matrix_int_func_x86(PixelType type_in, PixelType type_out, CPUClass cpu);
+
+} // namespace zimg::colorspace
+
+#endif // ZIMG_COLORSPACE_X86_MATRIX_INT_X86_H_
+
+#endif // ZIMG_X86
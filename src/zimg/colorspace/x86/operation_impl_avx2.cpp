@@ -1,8 +1,10 @@
 #ifdef ZIMG_X86
 
 #include <algorithm>
+#include <cfloat>
 #include <cstdint>
-#include <vector>
+#include <memory>
+#include <utility>
 #include <immintrin.h>
 #include "common/align.h"
 #include "common/ccdep.h"
@@ -10,6 +12,7 @@
 #include "colorspace/gamma.h"
 #include "colorspace/operation.h"
 #include "colorspace/operation_impl.h"
+#include "gamma_constants_avx512.h"
 #include "operation_impl_x86.h"
 
 #include "common/x86/avx2_util.h"
@@ -119,6 +122,108 @@ void matrix_filter_line_avx2(const float *matrix, const float * const * RESTRICT
 #undef XARGS
 }
 
+inline FORCE_INLINE void lut3d_filter_line_avx2_xiter(unsigned j, const float *lut, const float * const *src,
+                                                      const __m256 scale[3], const __m256 offset[3], const __m256i stride[3],
+                                                      const __m256 &limit, const __m256i &idx_limit,
+                                                      __m256 &out0, __m256 &out1, __m256 &out2)
+{
+	__m256 frac[3];
+	__m256i base = _mm256_setzero_si256();
+
+	for (unsigned c = 0; c < 3; ++c) {
+		__m256 x = _mm256_fmadd_ps(_mm256_load_ps(src[c] + j), scale[c], offset[c]);
+		x = _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()), limit);
+
+		__m256i idx = _mm256_min_epi32(_mm256_cvttps_epi32(x), idx_limit);
+		frac[c] = _mm256_sub_ps(x, _mm256_cvtepi32_ps(idx));
+		base = _mm256_add_epi32(base, _mm256_mullo_epi32(idx, stride[c]));
+	}
+
+	// See Lut3DOperationC for the selection of the tetrahedron.
+	__m256 x_ge_y = _mm256_cmp_ps(frac[0], frac[1], _CMP_GE_OQ);
+	__m256 x_ge_z = _mm256_cmp_ps(frac[0], frac[2], _CMP_GE_OQ);
+	__m256 y_ge_z = _mm256_cmp_ps(frac[1], frac[2], _CMP_GE_OQ);
+	__m256 max_is_x = _mm256_and_ps(x_ge_y, x_ge_z);
+	__m256 min_is_z = _mm256_and_ps(x_ge_z, y_ge_z);
+
+	__m256 f_max = _mm256_blendv_ps(_mm256_blendv_ps(frac[2], frac[1], y_ge_z), frac[0], max_is_x);
+	__m256 f_min = _mm256_blendv_ps(_mm256_blendv_ps(frac[0], frac[1], x_ge_y), frac[2], min_is_z);
+	__m256 f_mid = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(frac[0], frac[1]), frac[2]), _mm256_add_ps(f_max, f_min));
+
+	__m256i stride_max = _mm256_blendv_epi8(_mm256_blendv_epi8(stride[2], stride[1], _mm256_castps_si256(y_ge_z)), stride[0], _mm256_castps_si256(max_is_x));
+	__m256i stride_min = _mm256_blendv_epi8(_mm256_blendv_epi8(stride[0], stride[1], _mm256_castps_si256(x_ge_y)), stride[2], _mm256_castps_si256(min_is_z));
+	__m256i stride_all = _mm256_add_epi32(_mm256_add_epi32(stride[0], stride[1]), stride[2]);
+
+	__m256i idx0 = base;
+	__m256i idx1 = _mm256_add_epi32(base, stride_max);
+	__m256i idx2 = _mm256_add_epi32(base, _mm256_sub_epi32(stride_all, stride_min));
+	__m256i idx3 = _mm256_add_epi32(base, stride_all);
+
+	__m256 w0 = _mm256_sub_ps(_mm256_set1_ps(1.0f), f_max);
+	__m256 w1 = _mm256_sub_ps(f_max, f_mid);
+	__m256 w2 = _mm256_sub_ps(f_mid, f_min);
+	__m256 w3 = f_min;
+
+#define INTERP(c) \
+  _mm256_fmadd_ps(w3, _mm256_i32gather_ps(lut + (c), idx3, sizeof(float)), \
+  _mm256_fmadd_ps(w2, _mm256_i32gather_ps(lut + (c), idx2, sizeof(float)), \
+  _mm256_fmadd_ps(w1, _mm256_i32gather_ps(lut + (c), idx1, sizeof(float)), \
+  _mm256_mul_ps(w0, _mm256_i32gather_ps(lut + (c), idx0, sizeof(float))))))
+	out0 = INTERP(0);
+	out1 = INTERP(1);
+	out2 = INTERP(2);
+#undef INTERP
+}
+
+void lut3d_filter_line_avx2(const Lut3D &lut, const float * const * RESTRICT src, float * const * RESTRICT dst, unsigned left, unsigned right)
+{
+	float *dst0 = dst[0];
+	float *dst1 = dst[1];
+	float *dst2 = dst[2];
+
+	const __m256 scale[3] = { _mm256_set1_ps(lut.scale[0]), _mm256_set1_ps(lut.scale[1]), _mm256_set1_ps(lut.scale[2]) };
+	const __m256 offset[3] = { _mm256_set1_ps(lut.offset[0]), _mm256_set1_ps(lut.offset[1]), _mm256_set1_ps(lut.offset[2]) };
+	const __m256i stride[3] = {
+		_mm256_set1_epi32(3),
+		_mm256_set1_epi32(static_cast<int>(3 * lut.size)),
+		_mm256_set1_epi32(static_cast<int>(3 * lut.size * lut.size)),
+	};
+	const __m256 limit = _mm256_set1_ps(static_cast<float>(lut.size - 1));
+	const __m256i idx_limit = _mm256_set1_epi32(static_cast<int>(lut.size - 2));
+	__m256 out0, out1, out2;
+
+	unsigned vec_left = ceil_n(left, 8);
+	unsigned vec_right = floor_n(right, 8);
+
+#define XITER lut3d_filter_line_avx2_xiter
+#define XARGS lut.data.data(), src, scale, offset, stride, limit, idx_limit, out0, out1, out2
+	if (left != vec_left) {
+		XITER(vec_left - 8, XARGS);
+
+		mm256_store_idxhi_ps(dst0 + vec_left - 8, out0, left % 8);
+		mm256_store_idxhi_ps(dst1 + vec_left - 8, out1, left % 8);
+		mm256_store_idxhi_ps(dst2 + vec_left - 8, out2, left % 8);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 8) {
+		XITER(j, XARGS);
+
+		_mm256_store_ps(dst0 + j, out0);
+		_mm256_store_ps(dst1 + j, out1);
+		_mm256_store_ps(dst2 + j, out2);
+	}
+
+	if (right != vec_right) {
+		XITER(vec_right, XARGS);
+
+		mm256_store_idxlo_ps(dst0 + vec_right, out0, right % 8);
+		mm256_store_idxlo_ps(dst1 + vec_right, out1, right % 8);
+		mm256_store_idxlo_ps(dst2 + vec_right, out2, right % 8);
+	}
+#undef XITER
+#undef XARGS
+}
+
 void to_linear_lut_filter_line_gather(const float *RESTRICT lut, unsigned lut_depth, const float *src, float *dst, unsigned left, unsigned right)
 {
 	unsigned vec_left = ceil_n(left, 8);
@@ -242,6 +347,508 @@ void to_gamma_lut_filter_line_nogather(const float *RESTRICT lut, const float *s
 	}
 }
 
+// Selects table[idx % 16] for each lane.
+inline FORCE_INLINE __m256 lookup16_ps(const float *table, __m256i idx)
+{
+	__m256 lo = _mm256_permutevar8x32_ps(_mm256_load_ps(table + 0), idx);
+	__m256 hi = _mm256_permutevar8x32_ps(_mm256_load_ps(table + 8), idx);
+	return _mm256_blendv_ps(lo, hi, _mm256_castsi256_ps(_mm256_slli_epi32(idx, 28)));
+}
+
+// Selects table[idx % 32] for each lane.
+inline FORCE_INLINE __m256 lookup32_ps(const float *table, __m256i idx)
+{
+	__m256 lo = lookup16_ps(table + 0, idx);
+	__m256 hi = lookup16_ps(table + 16, idx);
+	return _mm256_blendv_ps(lo, hi, _mm256_castsi256_ps(_mm256_slli_epi32(idx, 27)));
+}
+
+// Mantissa of a non-negative normal number, normalized to [1, 2).
+inline FORCE_INLINE __m256 getmant_ps(__m256 x)
+{
+	const __m256i mant_mask = _mm256_set1_epi32(0x007FFFFF);
+	const __m256i one = _mm256_set1_epi32(0x3F800000);
+	return _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(_mm256_castps_si256(x), mant_mask), one));
+}
+
+// AVX2 ports of the polynomial approximations in operation_impl_avx512.cpp.
+template <class T, bool Prescale>
+struct PowerFunction {
+	static inline FORCE_INLINE __m256 func(__m256 x, __m256 scale)
+	{
+		constexpr bool ExtendedExponent = sizeof(T::table) / sizeof(T::table[0]) == 32;
+
+		const __m256i exponent_min = _mm256_set1_epi32(127 - (ExtendedExponent ? 31 : 15));
+		const __m256 two_minus_eps = _mm256_set1_ps(1.99999988f);
+
+		__m256 orig, mant, mantpart, exppart;
+		__m256i exp;
+
+		if (Prescale)
+			x = _mm256_mul_ps(x, scale);
+
+		x = _mm256_max_ps(x, _mm256_setzero_ps());
+
+		orig = x;
+		x = _mm256_min_ps(x, two_minus_eps);
+
+		// Decompose into mantissa and exponent.
+		mant = getmant_ps(x);
+		exp = _mm256_srli_epi32(_mm256_castps_si256(x), 23);
+		exp = _mm256_max_epi32(exp, exponent_min);
+
+		// Apply polynomial approximation to mantissa.
+		mantpart = _mm256_set1_ps(T::horner[0]);
+		mantpart = _mm256_fmadd_ps(mantpart, mant, _mm256_set1_ps(T::horner[1]));
+		mantpart = _mm256_fmadd_ps(mantpart, mant, _mm256_set1_ps(T::horner[2]));
+		mantpart = _mm256_fmadd_ps(mantpart, mant, _mm256_set1_ps(T::horner[3]));
+		mantpart = _mm256_fmadd_ps(mantpart, mant, _mm256_set1_ps(T::horner[4]));
+		mantpart = _mm256_fmadd_ps(mantpart, mant, _mm256_set1_ps(T::horner[5]));
+
+		// Read f(2^e) from a 16 or 32-element LUT.
+		exppart = ExtendedExponent ? lookup32_ps(T::table, exp) : lookup16_ps(T::table, exp);
+
+		// f(m * 2^e) == f(m) * f(2^e)
+		x = _mm256_mul_ps(mantpart, exppart);
+
+		if (!Prescale)
+			x = _mm256_mul_ps(x, scale);
+
+		// The mantissa of zero is not recoverable from its bits, so flush it explicitly.
+		x = _mm256_and_ps(x, _mm256_cmp_ps(orig, _mm256_setzero_ps(), _CMP_NEQ_OQ));
+		return x;
+	}
+};
+
+template <class T, bool Eotf, bool Prescale>
+struct SRGBPowerFunction {
+	static inline FORCE_INLINE __m256 func(__m256 x, __m256 scale)
+	{
+		constexpr bool ExtendedExponent = sizeof(T::table) / sizeof(T::table[0]) == 32;
+
+		const __m256 two_minus_eps = _mm256_set1_ps(1.99999988f);
+
+		__m256 orig, mant, mantpart, exppart, mask;
+		__m256i exp;
+
+		if (Prescale)
+			x = _mm256_mul_ps(x, scale);
+
+		x = _mm256_max_ps(x, _mm256_setzero_ps());
+
+		orig = x;
+		x = _mm256_min_ps(x, two_minus_eps);
+
+		// Check if the argument belongs to the linear or the power domain.
+		mask = _mm256_cmp_ps(x, _mm256_set1_ps(T::knee), _CMP_LE_OQ);
+
+		// f(x) = (x * a + b) ^ p
+		if (Eotf)
+			x = _mm256_fmadd_ps(x, _mm256_set1_ps(T::power_scale), _mm256_set1_ps(T::power_offset));
+
+		// Decompose into mantissa and exponent.
+		mant = getmant_ps(x);
+		exp = _mm256_srli_epi32(_mm256_castps_si256(x), 23); // Exponent range limit not needed because of mask.
+
+		// Apply polynomial approximation to mantissa.
+		mantpart = _mm256_set1_ps(T::horner[0]);
+		mantpart = _mm256_fmadd_ps(mantpart, mant, _mm256_set1_ps(T::horner[1]));
+		mantpart = _mm256_fmadd_ps(mantpart, mant, _mm256_set1_ps(T::horner[2]));
+		mantpart = _mm256_fmadd_ps(mantpart, mant, _mm256_set1_ps(T::horner[3]));
+		mantpart = _mm256_fmadd_ps(mantpart, mant, _mm256_set1_ps(T::horner[4]));
+		mantpart = _mm256_fmadd_ps(mantpart, mant, _mm256_set1_ps(T::horner[5]));
+
+		// Read f(2^e) from a 16-element LUT.
+		exppart = lookup16_ps(ExtendedExponent ? T::table + 16 : T::table, exp);
+
+		// f(m * 2^e) == f(m) * f(2^e)
+		x = _mm256_mul_ps(mantpart, exppart);
+
+		// f(x) = (x ^ p) * a + b
+		if (!Eotf)
+			x = _mm256_fmadd_ps(x, _mm256_set1_ps(T::power_scale), _mm256_set1_ps(T::power_offset));
+
+		// Merge with the linear segment.
+		x = _mm256_blendv_ps(x, _mm256_mul_ps(orig, _mm256_set1_ps(T::linear_scale)), mask);
+
+		if (!Prescale)
+			x = _mm256_mul_ps(x, scale);
+
+		return x;
+	}
+};
+
+template <class T, bool Log, bool Prescale>
+struct SegmentedPolynomial {
+	static inline FORCE_INLINE __m256 func(__m256 x, __m256 scale)
+	{
+		__m256 result;
+		__m256i idx;
+
+		if (Prescale)
+			x = _mm256_mul_ps(x, scale);
+
+		x = _mm256_max_ps(x, _mm256_set1_ps(FLT_MIN));
+
+		if (Log) {
+			// Classify the argument into one of 32 segments by its exponent.
+			const __m256i exponent_min = _mm256_set1_epi32(127 - 32);
+			const __m256i exponent_max = _mm256_set1_epi32(127 - 1);
+			idx = _mm256_srli_epi32(_mm256_castps_si256(x), 23);
+			idx = _mm256_max_epi32(idx, exponent_min);
+			idx = _mm256_min_epi32(idx, exponent_max);
+		} else {
+			// Classify the argument into one of 32 uniform segments on [0, 1].
+			const __m256 one_minus_eps = _mm256_set1_ps(0.999999940f);
+			__m256 tmp = x;
+			tmp = _mm256_max_ps(tmp, _mm256_setzero_ps());
+			tmp = _mm256_min_ps(tmp, one_minus_eps);
+			tmp = _mm256_mul_ps(tmp, _mm256_set1_ps(32.0f));
+			idx = _mm256_cvttps_epi32(tmp);
+		}
+
+		// Apply the polynomial approximation for the segment.
+		result = lookup32_ps(T::horner0, idx);
+		result = _mm256_fmadd_ps(result, x, lookup32_ps(T::horner1, idx));
+		result = _mm256_fmadd_ps(result, x, lookup32_ps(T::horner2, idx));
+		result = _mm256_fmadd_ps(result, x, lookup32_ps(T::horner3, idx));
+		result = _mm256_fmadd_ps(result, x, lookup32_ps(T::horner4, idx));
+
+		if (!Log)
+			result = _mm256_max_ps(result, _mm256_setzero_ps());
+
+		if (!Prescale)
+			result = _mm256_mul_ps(result, scale);
+
+		return result;
+	}
+};
+
+typedef PowerFunction<avx512constants::Rec1886EOTF, false> FuncRec1886EOTF;
+typedef PowerFunction<avx512constants::Rec1886InverseEOTF, true> FuncRec1886InverseEOTF;
+typedef SRGBPowerFunction<avx512constants::SRGBEOTF, true, false> FuncSRGBEOTF;
+typedef SRGBPowerFunction<avx512constants::SRGBInverseEOTF, false, true> FuncSRGBInverseEOTF;
+typedef SegmentedPolynomial<avx512constants::ST2084EOTF, false, false> FuncST2084EOTF;
+typedef SegmentedPolynomial<avx512constants::ST2084InverseEOTF, true, true> FuncST2084InverseEOTF;
+
+// log2(x) for positive normal x.
+inline FORCE_INLINE __m256 log2_ps(__m256 x)
+{
+	typedef avx512constants::Log2 T;
+
+	const __m256 one = _mm256_set1_ps(1.0f);
+	__m256 mant, t, t2, result;
+	__m256i exp;
+
+	// Decompose into mantissa on [0.75, 1.5) and exponent.
+	exp = _mm256_srai_epi32(_mm256_sub_epi32(_mm256_castps_si256(x), _mm256_set1_epi32(0x3F400000)), 23);
+	mant = _mm256_castsi256_ps(_mm256_sub_epi32(_mm256_castps_si256(x), _mm256_slli_epi32(exp, 23)));
+
+	// log2(m) = t * P(t^2), t = (m - 1) / (m + 1)
+	t = _mm256_div_ps(_mm256_sub_ps(mant, one), _mm256_add_ps(mant, one));
+	t2 = _mm256_mul_ps(t, t);
+
+	result = _mm256_set1_ps(T::horner[0]);
+	result = _mm256_fmadd_ps(result, t2, _mm256_set1_ps(T::horner[1]));
+	result = _mm256_fmadd_ps(result, t2, _mm256_set1_ps(T::horner[2]));
+	result = _mm256_fmadd_ps(result, t2, _mm256_set1_ps(T::horner[3]));
+	result = _mm256_fmadd_ps(result, t2, _mm256_set1_ps(T::horner[4]));
+
+	return _mm256_fmadd_ps(result, t, _mm256_cvtepi32_ps(exp));
+}
+
+inline FORCE_INLINE __m256 exp2_ps(__m256 x)
+{
+	typedef avx512constants::Exp2 T;
+
+	__m256 n, result;
+
+	x = _mm256_max_ps(x, _mm256_set1_ps(-125.0f));
+	x = _mm256_min_ps(x, _mm256_set1_ps(127.0f));
+
+	// Split into integer and fractional part on [-0.5, 0.5].
+	n = _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	x = _mm256_sub_ps(x, n);
+
+	result = _mm256_set1_ps(T::horner[0]);
+	result = _mm256_fmadd_ps(result, x, _mm256_set1_ps(T::horner[1]));
+	result = _mm256_fmadd_ps(result, x, _mm256_set1_ps(T::horner[2]));
+	result = _mm256_fmadd_ps(result, x, _mm256_set1_ps(T::horner[3]));
+	result = _mm256_fmadd_ps(result, x, _mm256_set1_ps(T::horner[4]));
+	result = _mm256_fmadd_ps(result, x, _mm256_set1_ps(T::horner[5]));
+	result = _mm256_fmadd_ps(result, x, _mm256_set1_ps(T::horner[6]));
+	result = _mm256_fmadd_ps(result, x, _mm256_set1_ps(T::horner[7]));
+
+	// Scale by 2^n by adding to the exponent field.
+	return _mm256_castsi256_ps(_mm256_add_epi32(_mm256_castps_si256(result), _mm256_slli_epi32(_mm256_cvtps_epi32(n), 23)));
+}
+
+// x^y for positive normal x.
+inline FORCE_INLINE __m256 pow_ps(__m256 x, __m256 y)
+{
+	return exp2_ps(_mm256_mul_ps(y, log2_ps(x)));
+}
+
+inline FORCE_INLINE __m256 rec_709_oetf_ps(__m256 x)
+{
+	typedef avx512constants::Rec709OETF T;
+
+	__m256 mask, lin;
+
+	x = _mm256_max_ps(x, _mm256_setzero_ps());
+	mask = _mm256_cmp_ps(x, _mm256_set1_ps(T::beta), _CMP_LT_OQ);
+	lin = _mm256_mul_ps(x, _mm256_set1_ps(4.5f));
+
+	x = pow_ps(_mm256_max_ps(x, _mm256_set1_ps(FLT_MIN)), _mm256_set1_ps(0.45f));
+	x = _mm256_fmsub_ps(x, _mm256_set1_ps(T::alpha), _mm256_set1_ps(T::alpha - 1.0f));
+
+	return _mm256_blendv_ps(x, lin, mask);
+}
+
+inline FORCE_INLINE __m256 rec_709_inverse_oetf_ps(__m256 x)
+{
+	typedef avx512constants::Rec709OETF T;
+
+	__m256 mask, lin;
+
+	x = _mm256_max_ps(x, _mm256_setzero_ps());
+	mask = _mm256_cmp_ps(x, _mm256_set1_ps(4.5f * T::beta), _CMP_LT_OQ);
+	lin = _mm256_mul_ps(x, _mm256_set1_ps(1.0f / 4.5f));
+
+	x = _mm256_mul_ps(_mm256_add_ps(x, _mm256_set1_ps(T::alpha - 1.0f)), _mm256_set1_ps(1.0f / T::alpha));
+	x = pow_ps(x, _mm256_set1_ps(1.0f / 0.45f));
+
+	return _mm256_blendv_ps(x, lin, mask);
+}
+
+inline FORCE_INLINE __m256 arib_b67_oetf_ps(__m256 x)
+{
+	typedef avx512constants::AribB67OETF T;
+
+	__m256 mask, lin;
+
+	x = _mm256_max_ps(x, _mm256_setzero_ps());
+	mask = _mm256_cmp_ps(x, _mm256_set1_ps(1.0f / 12.0f), _CMP_LE_OQ);
+	lin = _mm256_sqrt_ps(_mm256_mul_ps(x, _mm256_set1_ps(3.0f)));
+
+	// a * ln(12 * x - b) + c
+	x = _mm256_fmsub_ps(x, _mm256_set1_ps(12.0f), _mm256_set1_ps(T::b));
+	x = log2_ps(_mm256_max_ps(x, _mm256_set1_ps(FLT_MIN)));
+	x = _mm256_fmadd_ps(x, _mm256_set1_ps(static_cast<float>(T::a * 0.69314718055994531)), _mm256_set1_ps(T::c));
+
+	return _mm256_blendv_ps(x, lin, mask);
+}
+
+inline FORCE_INLINE __m256 arib_b67_inverse_oetf_ps(__m256 x)
+{
+	typedef avx512constants::AribB67OETF T;
+
+	__m256 mask, lin;
+
+	x = _mm256_max_ps(x, _mm256_setzero_ps());
+	mask = _mm256_cmp_ps(x, _mm256_set1_ps(0.5f), _CMP_LE_OQ);
+	lin = _mm256_mul_ps(_mm256_mul_ps(x, x), _mm256_set1_ps(1.0f / 3.0f));
+
+	// (exp((x - c) / a) + b) / 12
+	x = _mm256_mul_ps(_mm256_sub_ps(x, _mm256_set1_ps(T::c)), _mm256_set1_ps(static_cast<float>(1.4426950408889634 / T::a)));
+	x = _mm256_add_ps(exp2_ps(x), _mm256_set1_ps(T::b));
+	x = _mm256_mul_ps(x, _mm256_set1_ps(1.0f / 12.0f));
+
+	return _mm256_blendv_ps(x, lin, mask);
+}
+
+// Operations on three planes. Constants are broadcast once per row.
+struct AribB67Func {
+	__m256 kr, kg, kb, scale;
+
+	AribB67Func(float kr_, float kg_, float kb_, float scale_) :
+		kr{ _mm256_set1_ps(kr_) }, kg{ _mm256_set1_ps(kg_) }, kb{ _mm256_set1_ps(kb_) }, scale{ _mm256_set1_ps(scale_) }
+	{}
+
+	inline FORCE_INLINE void func(__m256 &r, __m256 &g, __m256 &b) const
+	{
+		const float gamma = 1.2f;
+		__m256 yd, ys_inv;
+
+		r = _mm256_mul_ps(r, scale);
+		g = _mm256_mul_ps(g, scale);
+		b = _mm256_mul_ps(b, scale);
+
+		yd = _mm256_mul_ps(kr, r);
+		yd = _mm256_fmadd_ps(kg, g, yd);
+		yd = _mm256_fmadd_ps(kb, b, yd);
+		yd = _mm256_max_ps(yd, _mm256_set1_ps(FLT_MIN));
+		ys_inv = pow_ps(yd, _mm256_set1_ps((1.0f - gamma) / gamma));
+
+		r = arib_b67_oetf_ps(_mm256_mul_ps(r, ys_inv));
+		g = arib_b67_oetf_ps(_mm256_mul_ps(g, ys_inv));
+		b = arib_b67_oetf_ps(_mm256_mul_ps(b, ys_inv));
+	}
+};
+
+struct AribB67InverseFunc {
+	__m256 kr, kg, kb, scale;
+
+	AribB67InverseFunc(float kr_, float kg_, float kb_, float scale_) :
+		kr{ _mm256_set1_ps(kr_) }, kg{ _mm256_set1_ps(kg_) }, kb{ _mm256_set1_ps(kb_) }, scale{ _mm256_set1_ps(scale_) }
+	{}
+
+	inline FORCE_INLINE void func(__m256 &r, __m256 &g, __m256 &b) const
+	{
+		const float gamma = 1.2f;
+		__m256 ys;
+
+		r = arib_b67_inverse_oetf_ps(r);
+		g = arib_b67_inverse_oetf_ps(g);
+		b = arib_b67_inverse_oetf_ps(b);
+
+		ys = _mm256_mul_ps(kr, r);
+		ys = _mm256_fmadd_ps(kg, g, ys);
+		ys = _mm256_fmadd_ps(kb, b, ys);
+		ys = _mm256_max_ps(ys, _mm256_set1_ps(FLT_MIN));
+		ys = _mm256_mul_ps(pow_ps(ys, _mm256_set1_ps(gamma - 1.0f)), scale);
+
+		r = _mm256_mul_ps(r, ys);
+		g = _mm256_mul_ps(g, ys);
+		b = _mm256_mul_ps(b, ys);
+	}
+};
+
+struct CLToRGBFunc {
+	__m256 kr, kb, kg_inv, nb, pb, nr, pr, scale;
+
+	CLToRGBFunc(float kr_, float kg_, float kb_, float nb_, float pb_, float nr_, float pr_, float scale_) :
+		kr{ _mm256_set1_ps(kr_) }, kb{ _mm256_set1_ps(kb_) }, kg_inv{ _mm256_set1_ps(1.0f / kg_) },
+		nb{ _mm256_set1_ps(2.0f * nb_) }, pb{ _mm256_set1_ps(2.0f * pb_) },
+		nr{ _mm256_set1_ps(2.0f * nr_) }, pr{ _mm256_set1_ps(2.0f * pr_) },
+		scale{ _mm256_set1_ps(scale_) }
+	{}
+
+	inline FORCE_INLINE void func(__m256 &y, __m256 &u, __m256 &v) const
+	{
+		__m256 r, g, b;
+
+		b = _mm256_fmadd_ps(u, _mm256_blendv_ps(pb, nb, u), y);
+		r = _mm256_fmadd_ps(v, _mm256_blendv_ps(pr, nr, v), y);
+
+		b = rec_709_inverse_oetf_ps(b);
+		r = rec_709_inverse_oetf_ps(r);
+		y = rec_709_inverse_oetf_ps(y);
+
+		g = _mm256_fnmadd_ps(kr, r, y);
+		g = _mm256_fnmadd_ps(kb, b, g);
+		g = _mm256_mul_ps(g, kg_inv);
+
+		y = _mm256_mul_ps(r, scale);
+		u = _mm256_mul_ps(g, scale);
+		v = _mm256_mul_ps(b, scale);
+	}
+};
+
+struct CLToYUVFunc {
+	__m256 kr, kg, kb, nb, pb, nr, pr, scale;
+
+	CLToYUVFunc(float kr_, float kg_, float kb_, float nb_, float pb_, float nr_, float pr_, float scale_) :
+		kr{ _mm256_set1_ps(kr_) }, kg{ _mm256_set1_ps(kg_) }, kb{ _mm256_set1_ps(kb_) },
+		nb{ _mm256_set1_ps(0.5f / nb_) }, pb{ _mm256_set1_ps(0.5f / pb_) },
+		nr{ _mm256_set1_ps(0.5f / nr_) }, pr{ _mm256_set1_ps(0.5f / pr_) },
+		scale{ _mm256_set1_ps(scale_) }
+	{}
+
+	inline FORCE_INLINE void func(__m256 &r, __m256 &g, __m256 &b) const
+	{
+		__m256 y, b_minus_y, r_minus_y;
+
+		r = _mm256_mul_ps(r, scale);
+		g = _mm256_mul_ps(g, scale);
+		b = _mm256_mul_ps(b, scale);
+
+		y = _mm256_mul_ps(kr, r);
+		y = _mm256_fmadd_ps(kg, g, y);
+		y = _mm256_fmadd_ps(kb, b, y);
+
+		y = rec_709_oetf_ps(y);
+		b = rec_709_oetf_ps(b);
+		r = rec_709_oetf_ps(r);
+
+		b_minus_y = _mm256_sub_ps(b, y);
+		r_minus_y = _mm256_sub_ps(r, y);
+
+		r = y;
+		g = _mm256_mul_ps(b_minus_y, _mm256_blendv_ps(pb, nb, b_minus_y));
+		b = _mm256_mul_ps(r_minus_y, _mm256_blendv_ps(pr, nr, r_minus_y));
+	}
+};
+
+template <class Op>
+void filter_line3_avx2(const Op &op, const float * const * RESTRICT src, float * const * RESTRICT dst, unsigned left, unsigned right)
+{
+	const float *src0 = src[0];
+	const float *src1 = src[1];
+	const float *src2 = src[2];
+	float *dst0 = dst[0];
+	float *dst1 = dst[1];
+	float *dst2 = dst[2];
+
+	unsigned vec_left = ceil_n(left, 8);
+	unsigned vec_right = floor_n(right, 8);
+
+	if (left != vec_left) {
+		__m256 x = _mm256_load_ps(src0 + vec_left - 8);
+		__m256 y = _mm256_load_ps(src1 + vec_left - 8);
+		__m256 z = _mm256_load_ps(src2 + vec_left - 8);
+		op.func(x, y, z);
+
+		mm256_store_idxhi_ps(dst0 + vec_left - 8, x, left % 8);
+		mm256_store_idxhi_ps(dst1 + vec_left - 8, y, left % 8);
+		mm256_store_idxhi_ps(dst2 + vec_left - 8, z, left % 8);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 8) {
+		__m256 x = _mm256_load_ps(src0 + j);
+		__m256 y = _mm256_load_ps(src1 + j);
+		__m256 z = _mm256_load_ps(src2 + j);
+		op.func(x, y, z);
+
+		_mm256_store_ps(dst0 + j, x);
+		_mm256_store_ps(dst1 + j, y);
+		_mm256_store_ps(dst2 + j, z);
+	}
+
+	if (right != vec_right) {
+		__m256 x = _mm256_load_ps(src0 + vec_right);
+		__m256 y = _mm256_load_ps(src1 + vec_right);
+		__m256 z = _mm256_load_ps(src2 + vec_right);
+		op.func(x, y, z);
+
+		mm256_store_idxlo_ps(dst0 + vec_right, x, right % 8);
+		mm256_store_idxlo_ps(dst1 + vec_right, y, right % 8);
+		mm256_store_idxlo_ps(dst2 + vec_right, z, right % 8);
+	}
+}
+
+template <class Op>
+void gamma_filter_line_avx2(const float *src, float *dst, float scale, unsigned left, unsigned right)
+{
+	unsigned vec_left = ceil_n(left, 8);
+	unsigned vec_right = floor_n(right, 8);
+
+	if (left != vec_left) {
+		__m256 x = Op::func(_mm256_load_ps(src + vec_left - 8), _mm256_set1_ps(scale));
+		mm256_store_idxhi_ps(dst + vec_left - 8, x, left % 8);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 8) {
+		__m256 x = Op::func(_mm256_load_ps(src + j), _mm256_set1_ps(scale));
+		_mm256_store_ps(dst + j, x);
+	}
+
+	if (right != vec_right) {
+		__m256 x = Op::func(_mm256_load_ps(src + vec_right), _mm256_set1_ps(scale));
+		mm256_store_idxlo_ps(dst + vec_right, x, right % 8);
+	}
+}
+
 
 class MatrixOperationAVX2 final : public MatrixOperationImpl {
 public:
@@ -257,21 +864,13 @@ public:
 
 class ToLinearLutOperationAVX2 : public Operation {
 public:
-	std::vector<float> m_lut;
+	std::shared_ptr<const float[]> m_lut;
 	unsigned m_lut_depth;
 
 	ToLinearLutOperationAVX2(gamma_func func, unsigned lut_depth, float postscale) :
-		m_lut((1UL << lut_depth) + 1),
+		m_lut{ get_to_linear_lut(func, postscale, lut_depth) },
 		m_lut_depth{ lut_depth }
-	{
-		EnsureSinglePrecision x87;
-
-		// Allocate an extra LUT entry so that indexing can be done by multipying by a power of 2.
-		for (size_t i = 0; i < m_lut.size(); ++i) {
-			float x = static_cast<float>(i) / (1 << lut_depth) * 2.0f - 0.5f;
-			m_lut[i] = func(x) * postscale;
-		}
-	}
+	{}
 };
 
 class ToLinearLutOperationAVX2Gather final : public ToLinearLutOperationAVX2 {
@@ -282,9 +881,9 @@ public:
 
 	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
 	{
-		to_linear_lut_filter_line_gather(m_lut.data(), m_lut_depth, src[0], dst[0], left, right);
-		to_linear_lut_filter_line_gather(m_lut.data(), m_lut_depth, src[1], dst[1], left, right);
-		to_linear_lut_filter_line_gather(m_lut.data(), m_lut_depth, src[2], dst[2], left, right);
+		to_linear_lut_filter_line_gather(m_lut.get(), m_lut_depth, src[0], dst[0], left, right);
+		to_linear_lut_filter_line_gather(m_lut.get(), m_lut_depth, src[1], dst[1], left, right);
+		to_linear_lut_filter_line_gather(m_lut.get(), m_lut_depth, src[2], dst[2], left, right);
 	}
 };
 
@@ -296,27 +895,17 @@ public:
 
 	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
 	{
-		to_linear_lut_filter_line_nogather(m_lut.data(), m_lut_depth, src[0], dst[0], left, right);
-		to_linear_lut_filter_line_nogather(m_lut.data(), m_lut_depth, src[1], dst[1], left, right);
-		to_linear_lut_filter_line_nogather(m_lut.data(), m_lut_depth, src[2], dst[2], left, right);
+		to_linear_lut_filter_line_nogather(m_lut.get(), m_lut_depth, src[0], dst[0], left, right);
+		to_linear_lut_filter_line_nogather(m_lut.get(), m_lut_depth, src[1], dst[1], left, right);
+		to_linear_lut_filter_line_nogather(m_lut.get(), m_lut_depth, src[2], dst[2], left, right);
 	}
 };
 
 class ToGammaLutOperationAVX2 : public Operation {
 public:
-	std::vector<float> m_lut;
-
-	ToGammaLutOperationAVX2(gamma_func func, float prescale) :
-		m_lut(static_cast<uint32_t>(UINT16_MAX) + 1)
-	{
-		EnsureSinglePrecision x87;
+	std::shared_ptr<const float[]> m_lut;
 
-		for (size_t i = 0; i <= UINT16_MAX; ++i) {
-			uint16_t half = static_cast<uint16_t>(i);
-			float x = _mm_cvtss_f32(_mm_cvtph_ps(_mm_set1_epi16(half)));
-			m_lut[i] = func(x * prescale);
-		}
-	}
+	ToGammaLutOperationAVX2(gamma_func func, float prescale) : m_lut{ get_to_gamma_lut(func, prescale) } {}
 };
 
 class ToGammaLutOperationAVX2Gather final : public ToGammaLutOperationAVX2 {
@@ -327,9 +916,9 @@ public:
 
 	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
 	{
-		to_gamma_lut_filter_line_gather(m_lut.data(), src[0], dst[0], left, right);
-		to_gamma_lut_filter_line_gather(m_lut.data(), src[1], dst[1], left, right);
-		to_gamma_lut_filter_line_gather(m_lut.data(), src[2], dst[2], left, right);
+		to_gamma_lut_filter_line_gather(m_lut.get(), src[0], dst[0], left, right);
+		to_gamma_lut_filter_line_gather(m_lut.get(), src[1], dst[1], left, right);
+		to_gamma_lut_filter_line_gather(m_lut.get(), src[2], dst[2], left, right);
 	}
 };
 
@@ -341,9 +930,97 @@ public:
 
 	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
 	{
-		to_gamma_lut_filter_line_nogather(m_lut.data(), src[0], dst[0], left, right);
-		to_gamma_lut_filter_line_nogather(m_lut.data(), src[1], dst[1], left, right);
-		to_gamma_lut_filter_line_nogather(m_lut.data(), src[2], dst[2], left, right);
+		to_gamma_lut_filter_line_nogather(m_lut.get(), src[0], dst[0], left, right);
+		to_gamma_lut_filter_line_nogather(m_lut.get(), src[1], dst[1], left, right);
+		to_gamma_lut_filter_line_nogather(m_lut.get(), src[2], dst[2], left, right);
+	}
+};
+
+template <class Op>
+class GammaOperationAVX2 final : public Operation {
+	float m_scale;
+public:
+	explicit GammaOperationAVX2(float scale) : m_scale{ scale } {}
+
+	unsigned alignment_mask() const noexcept override { return 0x7; }
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
+	{
+		gamma_filter_line_avx2<Op>(src[0], dst[0], m_scale, left, right);
+		gamma_filter_line_avx2<Op>(src[1], dst[1], m_scale, left, right);
+		gamma_filter_line_avx2<Op>(src[2], dst[2], m_scale, left, right);
+	}
+};
+
+template <class Op>
+class AribB67OperationAVX2 final : public Operation {
+	float m_kr;
+	float m_kg;
+	float m_kb;
+	float m_scale;
+public:
+	AribB67OperationAVX2(double kr, double kg, double kb, float scale) :
+		m_kr{ static_cast<float>(kr) },
+		m_kg{ static_cast<float>(kg) },
+		m_kb{ static_cast<float>(kb) },
+		m_scale{ scale }
+	{}
+
+	unsigned alignment_mask() const noexcept override { return 0x7; }
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
+	{
+		filter_line3_avx2(Op{ m_kr, m_kg, m_kb, m_scale }, src, dst, left, right);
+	}
+};
+
+template <class Op>
+class CLOperationAVX2 final : public Operation {
+	float m_kr;
+	float m_kg;
+	float m_kb;
+	float m_nb;
+	float m_pb;
+	float m_nr;
+	float m_pr;
+	float m_scale;
+public:
+	CLOperationAVX2(gamma_func to_gamma, double kr, double kg, double kb, float scale) :
+		m_kr{ static_cast<float>(kr) },
+		m_kg{ static_cast<float>(kg) },
+		m_kb{ static_cast<float>(kb) },
+		m_nb{},
+		m_pb{},
+		m_nr{},
+		m_pr{},
+		m_scale{ scale }
+	{
+		EnsureSinglePrecision x87;
+
+		m_nb = to_gamma(1.0f - static_cast<float>(kb));
+		m_pb = 1.0f - to_gamma(static_cast<float>(kb));
+		m_nr = to_gamma(1.0f - static_cast<float>(kr));
+		m_pr = 1.0f - to_gamma(static_cast<float>(kr));
+	}
+
+	unsigned alignment_mask() const noexcept override { return 0x7; }
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
+	{
+		filter_line3_avx2(Op{ m_kr, m_kg, m_kb, m_nb, m_pb, m_nr, m_pr, m_scale }, src, dst, left, right);
+	}
+};
+
+class Lut3DOperationAVX2 final : public Operation {
+	std::shared_ptr<const Lut3D> m_lut;
+public:
+	explicit Lut3DOperationAVX2(std::shared_ptr<const Lut3D> lut) : m_lut(std::move(lut)) {}
+
+	unsigned alignment_mask() const noexcept override { return 0x7; }
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
+	{
+		lut3d_filter_line_avx2(*m_lut, src, dst, left, right);
 	}
 };
 
@@ -355,7 +1032,7 @@ std::unique_ptr<Operation> create_matrix_operation_avx2(const Matrix3x3 &m)
 	return std::make_unique<MatrixOperationAVX2>(m);
 }
 
-std::unique_ptr<Operation> create_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params)
+std::unique_ptr<Operation> create_gamma_lut_operation_avx2(const TransferFunction &transfer, const OperationParams &params)
 {
 	if (!params.approximate_gamma)
 		return nullptr;
@@ -368,7 +1045,36 @@ std::unique_ptr<Operation> create_gamma_operation_avx2(const TransferFunction &t
 		return std::make_unique<ToGammaLutOperationAVX2Gather>(transfer.to_gamma, transfer.to_gamma_scale);
 }
 
-std::unique_ptr<Operation> create_inverse_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params)
+std::unique_ptr<Operation> create_gamma_polynomial_operation_avx2(const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma)
+		return nullptr;
+
+	if (transfer.to_gamma == rec_1886_inverse_eotf)
+		return std::make_unique<GammaOperationAVX2<FuncRec1886InverseEOTF>>(transfer.to_gamma_scale);
+	else if (transfer.to_gamma == srgb_inverse_eotf)
+		return std::make_unique<GammaOperationAVX2<FuncSRGBInverseEOTF>>(transfer.to_gamma_scale);
+	else if (transfer.to_gamma == st_2084_inverse_eotf)
+		return std::make_unique<GammaOperationAVX2<FuncST2084InverseEOTF>>(transfer.to_gamma_scale);
+
+	return nullptr;
+}
+
+std::unique_ptr<Operation> create_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	// Prefer polynomials to the LUT if scattered loads are expensive.
+	if (cpu_has_slow_gather(caps))
+		ret = create_gamma_polynomial_operation_avx2(transfer, params);
+	if (!ret)
+		ret = create_gamma_lut_operation_avx2(transfer, params);
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_inverse_gamma_lut_operation_avx2(const TransferFunction &transfer, const OperationParams &params)
 {
 	if (!params.approximate_gamma)
 		return nullptr;
@@ -381,6 +1087,76 @@ std::unique_ptr<Operation> create_inverse_gamma_operation_avx2(const TransferFun
 		return std::make_unique<ToLinearLutOperationAVX2Gather>(transfer.to_linear, LUT_DEPTH, transfer.to_linear_scale);
 }
 
+std::unique_ptr<Operation> create_inverse_gamma_polynomial_operation_avx2(const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma)
+		return nullptr;
+
+	if (transfer.to_linear == rec_1886_eotf)
+		return std::make_unique<GammaOperationAVX2<FuncRec1886EOTF>>(transfer.to_linear_scale);
+	else if (transfer.to_linear == srgb_eotf)
+		return std::make_unique<GammaOperationAVX2<FuncSRGBEOTF>>(transfer.to_linear_scale);
+	else if (transfer.to_linear == st_2084_eotf)
+		return std::make_unique<GammaOperationAVX2<FuncST2084EOTF>>(transfer.to_linear_scale);
+
+	return nullptr;
+}
+
+std::unique_ptr<Operation> create_inverse_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	if (cpu_has_slow_gather(caps))
+		ret = create_inverse_gamma_polynomial_operation_avx2(transfer, params);
+	if (!ret)
+		ret = create_inverse_gamma_lut_operation_avx2(transfer, params);
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_arib_b67_operation_avx2(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma)
+		return nullptr;
+
+	return std::make_unique<AribB67OperationAVX2<AribB67Func>>(m[0][0], m[0][1], m[0][2], transfer.to_gamma_scale);
+}
+
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_avx2(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma)
+		return nullptr;
+
+	return std::make_unique<AribB67OperationAVX2<AribB67InverseFunc>>(m[0][0], m[0][1], m[0][2], transfer.to_linear_scale);
+}
+
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_avx2(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma || transfer.to_linear != rec_709_inverse_oetf)
+		return nullptr;
+
+	return std::make_unique<CLOperationAVX2<CLToRGBFunc>>(transfer.to_gamma, m[0][0], m[0][1], m[0][2], transfer.to_linear_scale);
+}
+
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_avx2(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma || transfer.to_gamma != rec_709_oetf)
+		return nullptr;
+
+	return std::make_unique<CLOperationAVX2<CLToYUVFunc>>(transfer.to_gamma, m[0][0], m[0][1], m[0][2], transfer.to_gamma_scale);
+}
+
+std::unique_ptr<Operation> create_lut3d_operation_avx2(const std::shared_ptr<const Lut3D> &lut)
+{
+	X86Capabilities caps = query_x86_capabilities();
+
+	if (cpu_has_slow_gather(caps))
+		return nullptr;
+
+	return std::make_unique<Lut3DOperationAVX2>(lut);
+}
+
 } // namespace zimg::colorspace
 
 #endif // ZIMG_X86
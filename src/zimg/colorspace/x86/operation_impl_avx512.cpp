@@ -1,6 +1,8 @@
 #ifdef ZIMG_X86
 
 #include <cfloat>
+#include <memory>
+#include <utility>
 #include <immintrin.h>
 #include "common/align.h"
 #include "common/ccdep.h"
@@ -96,6 +98,110 @@ void matrix_filter_line_avx512(const float *matrix, const float * const * RESTRI
 #undef XARGS
 }
 
+inline FORCE_INLINE void lut3d_filter_line_avx512_xiter(unsigned j, const float *lut, const float * const *src,
+                                                        const __m512 scale[3], const __m512 offset[3], const __m512i stride[3],
+                                                        const __m512 &limit, const __m512i &idx_limit,
+                                                        __m512 &out0, __m512 &out1, __m512 &out2)
+{
+	__m512 frac[3];
+	__m512i base = _mm512_setzero_si512();
+
+	for (unsigned c = 0; c < 3; ++c) {
+		__m512 x = _mm512_fmadd_ps(_mm512_load_ps(src[c] + j), scale[c], offset[c]);
+		x = _mm512_min_ps(_mm512_max_ps(x, _mm512_setzero_ps()), limit);
+
+		__m512i idx = _mm512_min_epi32(_mm512_cvttps_epi32(x), idx_limit);
+		frac[c] = _mm512_sub_ps(x, _mm512_cvtepi32_ps(idx));
+		base = _mm512_add_epi32(base, _mm512_mullo_epi32(idx, stride[c]));
+	}
+
+	// See Lut3DOperationC for the selection of the tetrahedron.
+	__mmask16 x_ge_y = _mm512_cmp_ps_mask(frac[0], frac[1], _CMP_GE_OQ);
+	__mmask16 x_ge_z = _mm512_cmp_ps_mask(frac[0], frac[2], _CMP_GE_OQ);
+	__mmask16 y_ge_z = _mm512_cmp_ps_mask(frac[1], frac[2], _CMP_GE_OQ);
+	__mmask16 max_is_x = x_ge_y & x_ge_z;
+	__mmask16 min_is_z = x_ge_z & y_ge_z;
+
+	__m512 f_max = _mm512_mask_blend_ps(max_is_x, _mm512_mask_blend_ps(y_ge_z, frac[2], frac[1]), frac[0]);
+	__m512 f_min = _mm512_mask_blend_ps(min_is_z, _mm512_mask_blend_ps(x_ge_y, frac[0], frac[1]), frac[2]);
+	__m512 f_mid = _mm512_sub_ps(_mm512_add_ps(_mm512_add_ps(frac[0], frac[1]), frac[2]), _mm512_add_ps(f_max, f_min));
+
+	__m512i stride_max = _mm512_mask_blend_epi32(max_is_x, _mm512_mask_blend_epi32(y_ge_z, stride[2], stride[1]), stride[0]);
+	__m512i stride_min = _mm512_mask_blend_epi32(min_is_z, _mm512_mask_blend_epi32(x_ge_y, stride[0], stride[1]), stride[2]);
+	__m512i stride_all = _mm512_add_epi32(_mm512_add_epi32(stride[0], stride[1]), stride[2]);
+
+	__m512i idx0 = base;
+	__m512i idx1 = _mm512_add_epi32(base, stride_max);
+	__m512i idx2 = _mm512_add_epi32(base, _mm512_sub_epi32(stride_all, stride_min));
+	__m512i idx3 = _mm512_add_epi32(base, stride_all);
+
+	__m512 w0 = _mm512_sub_ps(_mm512_set1_ps(1.0f), f_max);
+	__m512 w1 = _mm512_sub_ps(f_max, f_mid);
+	__m512 w2 = _mm512_sub_ps(f_mid, f_min);
+	__m512 w3 = f_min;
+
+#define INTERP(c) \
+  _mm512_fmadd_ps(w3, _mm512_i32gather_ps(idx3, lut + (c), sizeof(float)), \
+  _mm512_fmadd_ps(w2, _mm512_i32gather_ps(idx2, lut + (c), sizeof(float)), \
+  _mm512_fmadd_ps(w1, _mm512_i32gather_ps(idx1, lut + (c), sizeof(float)), \
+  _mm512_mul_ps(w0, _mm512_i32gather_ps(idx0, lut + (c), sizeof(float))))))
+	out0 = INTERP(0);
+	out1 = INTERP(1);
+	out2 = INTERP(2);
+#undef INTERP
+}
+
+void lut3d_filter_line_avx512(const Lut3D &lut, const float * const * RESTRICT src, float * const * RESTRICT dst, unsigned left, unsigned right)
+{
+	float *dst0 = dst[0];
+	float *dst1 = dst[1];
+	float *dst2 = dst[2];
+
+	const __m512 scale[3] = { _mm512_set1_ps(lut.scale[0]), _mm512_set1_ps(lut.scale[1]), _mm512_set1_ps(lut.scale[2]) };
+	const __m512 offset[3] = { _mm512_set1_ps(lut.offset[0]), _mm512_set1_ps(lut.offset[1]), _mm512_set1_ps(lut.offset[2]) };
+	const __m512i stride[3] = {
+		_mm512_set1_epi32(3),
+		_mm512_set1_epi32(static_cast<int>(3 * lut.size)),
+		_mm512_set1_epi32(static_cast<int>(3 * lut.size * lut.size)),
+	};
+	const __m512 limit = _mm512_set1_ps(static_cast<float>(lut.size - 1));
+	const __m512i idx_limit = _mm512_set1_epi32(static_cast<int>(lut.size - 2));
+	__m512 out0, out1, out2;
+
+	unsigned vec_left = ceil_n(left, 16);
+	unsigned vec_right = floor_n(right, 16);
+
+#define XITER lut3d_filter_line_avx512_xiter
+#define XARGS lut.data.data(), src, scale, offset, stride, limit, idx_limit, out0, out1, out2
+	if (left != vec_left) {
+		XITER(vec_left - 16, XARGS);
+		__mmask16 mask = mmask16_set_hi(vec_left - left);
+
+		_mm512_mask_store_ps(dst0 + vec_left - 16, mask, out0);
+		_mm512_mask_store_ps(dst1 + vec_left - 16, mask, out1);
+		_mm512_mask_store_ps(dst2 + vec_left - 16, mask, out2);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 16) {
+		XITER(j, XARGS);
+
+		_mm512_store_ps(dst0 + j, out0);
+		_mm512_store_ps(dst1 + j, out1);
+		_mm512_store_ps(dst2 + j, out2);
+	}
+
+	if (right != vec_right) {
+		XITER(vec_right, XARGS);
+		__mmask16 mask = mmask16_set_lo(right - vec_right);
+
+		_mm512_mask_store_ps(dst0 + vec_right, mask, out0);
+		_mm512_mask_store_ps(dst1 + vec_right, mask, out1);
+		_mm512_mask_store_ps(dst2 + vec_right, mask, out2);
+	}
+#undef XITER
+#undef XARGS
+}
+
 
 template <class T, bool Prescale>
 struct PowerFunction {
@@ -264,6 +370,314 @@ typedef SRGBPowerFunction<avx512constants::SRGBInverseEOTF, false, true> FuncSRG
 typedef SegmentedPolynomial<avx512constants::ST2084EOTF, false, false> FuncST2084EOTF;
 typedef SegmentedPolynomial<avx512constants::ST2084InverseEOTF, true, true> FuncST2084InverseEOTF;
 
+// log2(x) for positive normal x.
+inline FORCE_INLINE __m512 log2_ps(__m512 x)
+{
+	typedef avx512constants::Log2 T;
+
+	const __m512 one = _mm512_set1_ps(1.0f);
+	__m512 mant, t, t2, result;
+	__m512i exp;
+
+	// Decompose into mantissa on [0.75, 1.5) and exponent.
+	exp = _mm512_srai_epi32(_mm512_sub_epi32(_mm512_castps_si512(x), _mm512_set1_epi32(0x3F400000)), 23);
+	mant = _mm512_castsi512_ps(_mm512_sub_epi32(_mm512_castps_si512(x), _mm512_slli_epi32(exp, 23)));
+
+	// log2(m) = t * P(t^2), t = (m - 1) / (m + 1)
+	t = _mm512_div_ps(_mm512_sub_ps(mant, one), _mm512_add_ps(mant, one));
+	t2 = _mm512_mul_ps(t, t);
+
+	result = _mm512_set1_ps(T::horner[0]);
+	result = _mm512_fmadd_ps(result, t2, _mm512_set1_ps(T::horner[1]));
+	result = _mm512_fmadd_ps(result, t2, _mm512_set1_ps(T::horner[2]));
+	result = _mm512_fmadd_ps(result, t2, _mm512_set1_ps(T::horner[3]));
+	result = _mm512_fmadd_ps(result, t2, _mm512_set1_ps(T::horner[4]));
+
+	return _mm512_fmadd_ps(result, t, _mm512_cvtepi32_ps(exp));
+}
+
+inline FORCE_INLINE __m512 exp2_ps(__m512 x)
+{
+	typedef avx512constants::Exp2 T;
+
+	__m512 n, result;
+
+	x = _mm512_max_ps(x, _mm512_set1_ps(-125.0f));
+	x = _mm512_min_ps(x, _mm512_set1_ps(127.0f));
+
+	// Split into integer and fractional part on [-0.5, 0.5].
+	n = _mm512_roundscale_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	x = _mm512_sub_ps(x, n);
+
+	result = _mm512_set1_ps(T::horner[0]);
+	result = _mm512_fmadd_ps(result, x, _mm512_set1_ps(T::horner[1]));
+	result = _mm512_fmadd_ps(result, x, _mm512_set1_ps(T::horner[2]));
+	result = _mm512_fmadd_ps(result, x, _mm512_set1_ps(T::horner[3]));
+	result = _mm512_fmadd_ps(result, x, _mm512_set1_ps(T::horner[4]));
+	result = _mm512_fmadd_ps(result, x, _mm512_set1_ps(T::horner[5]));
+	result = _mm512_fmadd_ps(result, x, _mm512_set1_ps(T::horner[6]));
+	result = _mm512_fmadd_ps(result, x, _mm512_set1_ps(T::horner[7]));
+
+	// Scale by 2^n by adding to the exponent field.
+	return _mm512_castsi512_ps(_mm512_add_epi32(_mm512_castps_si512(result), _mm512_slli_epi32(_mm512_cvtps_epi32(n), 23)));
+}
+
+// x^y for positive normal x.
+inline FORCE_INLINE __m512 pow_ps(__m512 x, __m512 y)
+{
+	return exp2_ps(_mm512_mul_ps(y, log2_ps(x)));
+}
+
+inline FORCE_INLINE __m512 rec_709_oetf_ps(__m512 x)
+{
+	typedef avx512constants::Rec709OETF T;
+
+	__mmask16 mask;
+	__m512 lin;
+
+	x = _mm512_max_ps(x, _mm512_setzero_ps());
+	mask = _mm512_cmp_ps_mask(x, _mm512_set1_ps(T::beta), _CMP_LT_OQ);
+	lin = _mm512_mul_ps(x, _mm512_set1_ps(4.5f));
+
+	x = pow_ps(_mm512_max_ps(x, _mm512_set1_ps(FLT_MIN)), _mm512_set1_ps(0.45f));
+	x = _mm512_fmsub_ps(x, _mm512_set1_ps(T::alpha), _mm512_set1_ps(T::alpha - 1.0f));
+
+	return _mm512_mask_blend_ps(mask, x, lin);
+}
+
+inline FORCE_INLINE __m512 rec_709_inverse_oetf_ps(__m512 x)
+{
+	typedef avx512constants::Rec709OETF T;
+
+	__mmask16 mask;
+	__m512 lin;
+
+	x = _mm512_max_ps(x, _mm512_setzero_ps());
+	mask = _mm512_cmp_ps_mask(x, _mm512_set1_ps(4.5f * T::beta), _CMP_LT_OQ);
+	lin = _mm512_mul_ps(x, _mm512_set1_ps(1.0f / 4.5f));
+
+	x = _mm512_mul_ps(_mm512_add_ps(x, _mm512_set1_ps(T::alpha - 1.0f)), _mm512_set1_ps(1.0f / T::alpha));
+	x = pow_ps(x, _mm512_set1_ps(1.0f / 0.45f));
+
+	return _mm512_mask_blend_ps(mask, x, lin);
+}
+
+inline FORCE_INLINE __m512 arib_b67_oetf_ps(__m512 x)
+{
+	typedef avx512constants::AribB67OETF T;
+
+	__mmask16 mask;
+	__m512 lin;
+
+	x = _mm512_max_ps(x, _mm512_setzero_ps());
+	mask = _mm512_cmp_ps_mask(x, _mm512_set1_ps(1.0f / 12.0f), _CMP_LE_OQ);
+	lin = _mm512_sqrt_ps(_mm512_mul_ps(x, _mm512_set1_ps(3.0f)));
+
+	// a * ln(12 * x - b) + c
+	x = _mm512_fmsub_ps(x, _mm512_set1_ps(12.0f), _mm512_set1_ps(T::b));
+	x = log2_ps(_mm512_max_ps(x, _mm512_set1_ps(FLT_MIN)));
+	x = _mm512_fmadd_ps(x, _mm512_set1_ps(static_cast<float>(T::a * 0.69314718055994531)), _mm512_set1_ps(T::c));
+
+	return _mm512_mask_blend_ps(mask, x, lin);
+}
+
+inline FORCE_INLINE __m512 arib_b67_inverse_oetf_ps(__m512 x)
+{
+	typedef avx512constants::AribB67OETF T;
+
+	__mmask16 mask;
+	__m512 lin;
+
+	x = _mm512_max_ps(x, _mm512_setzero_ps());
+	mask = _mm512_cmp_ps_mask(x, _mm512_set1_ps(0.5f), _CMP_LE_OQ);
+	lin = _mm512_mul_ps(_mm512_mul_ps(x, x), _mm512_set1_ps(1.0f / 3.0f));
+
+	// (exp((x - c) / a) + b) / 12
+	x = _mm512_mul_ps(_mm512_sub_ps(x, _mm512_set1_ps(T::c)), _mm512_set1_ps(static_cast<float>(1.4426950408889634 / T::a)));
+	x = _mm512_add_ps(exp2_ps(x), _mm512_set1_ps(T::b));
+	x = _mm512_mul_ps(x, _mm512_set1_ps(1.0f / 12.0f));
+
+	return _mm512_mask_blend_ps(mask, x, lin);
+}
+
+// Operations on three planes. Constants are broadcast once per row.
+struct AribB67Func {
+	__m512 kr, kg, kb, scale;
+
+	AribB67Func(float kr_, float kg_, float kb_, float scale_) :
+		kr{ _mm512_set1_ps(kr_) }, kg{ _mm512_set1_ps(kg_) }, kb{ _mm512_set1_ps(kb_) }, scale{ _mm512_set1_ps(scale_) }
+	{}
+
+	inline FORCE_INLINE void func(__m512 &r, __m512 &g, __m512 &b) const
+	{
+		const float gamma = 1.2f;
+		__m512 yd, ys_inv;
+
+		r = _mm512_mul_ps(r, scale);
+		g = _mm512_mul_ps(g, scale);
+		b = _mm512_mul_ps(b, scale);
+
+		yd = _mm512_mul_ps(kr, r);
+		yd = _mm512_fmadd_ps(kg, g, yd);
+		yd = _mm512_fmadd_ps(kb, b, yd);
+		yd = _mm512_max_ps(yd, _mm512_set1_ps(FLT_MIN));
+		ys_inv = pow_ps(yd, _mm512_set1_ps((1.0f - gamma) / gamma));
+
+		r = arib_b67_oetf_ps(_mm512_mul_ps(r, ys_inv));
+		g = arib_b67_oetf_ps(_mm512_mul_ps(g, ys_inv));
+		b = arib_b67_oetf_ps(_mm512_mul_ps(b, ys_inv));
+	}
+};
+
+struct AribB67InverseFunc {
+	__m512 kr, kg, kb, scale;
+
+	AribB67InverseFunc(float kr_, float kg_, float kb_, float scale_) :
+		kr{ _mm512_set1_ps(kr_) }, kg{ _mm512_set1_ps(kg_) }, kb{ _mm512_set1_ps(kb_) }, scale{ _mm512_set1_ps(scale_) }
+	{}
+
+	inline FORCE_INLINE void func(__m512 &r, __m512 &g, __m512 &b) const
+	{
+		const float gamma = 1.2f;
+		__m512 ys;
+
+		r = arib_b67_inverse_oetf_ps(r);
+		g = arib_b67_inverse_oetf_ps(g);
+		b = arib_b67_inverse_oetf_ps(b);
+
+		ys = _mm512_mul_ps(kr, r);
+		ys = _mm512_fmadd_ps(kg, g, ys);
+		ys = _mm512_fmadd_ps(kb, b, ys);
+		ys = _mm512_max_ps(ys, _mm512_set1_ps(FLT_MIN));
+		ys = _mm512_mul_ps(pow_ps(ys, _mm512_set1_ps(gamma - 1.0f)), scale);
+
+		r = _mm512_mul_ps(r, ys);
+		g = _mm512_mul_ps(g, ys);
+		b = _mm512_mul_ps(b, ys);
+	}
+};
+
+struct CLToRGBFunc {
+	__m512 kr, kb, kg_inv, nb, pb, nr, pr, scale;
+
+	CLToRGBFunc(float kr_, float kg_, float kb_, float nb_, float pb_, float nr_, float pr_, float scale_) :
+		kr{ _mm512_set1_ps(kr_) }, kb{ _mm512_set1_ps(kb_) }, kg_inv{ _mm512_set1_ps(1.0f / kg_) },
+		nb{ _mm512_set1_ps(2.0f * nb_) }, pb{ _mm512_set1_ps(2.0f * pb_) },
+		nr{ _mm512_set1_ps(2.0f * nr_) }, pr{ _mm512_set1_ps(2.0f * pr_) },
+		scale{ _mm512_set1_ps(scale_) }
+	{}
+
+	inline FORCE_INLINE void func(__m512 &y, __m512 &u, __m512 &v) const
+	{
+		__mmask16 u_neg = _mm512_cmp_ps_mask(u, _mm512_setzero_ps(), _CMP_LT_OQ);
+		__mmask16 v_neg = _mm512_cmp_ps_mask(v, _mm512_setzero_ps(), _CMP_LT_OQ);
+		__m512 r, g, b;
+
+		b = _mm512_fmadd_ps(u, _mm512_mask_blend_ps(u_neg, pb, nb), y);
+		r = _mm512_fmadd_ps(v, _mm512_mask_blend_ps(v_neg, pr, nr), y);
+
+		b = rec_709_inverse_oetf_ps(b);
+		r = rec_709_inverse_oetf_ps(r);
+		y = rec_709_inverse_oetf_ps(y);
+
+		g = _mm512_fnmadd_ps(kr, r, y);
+		g = _mm512_fnmadd_ps(kb, b, g);
+		g = _mm512_mul_ps(g, kg_inv);
+
+		y = _mm512_mul_ps(r, scale);
+		u = _mm512_mul_ps(g, scale);
+		v = _mm512_mul_ps(b, scale);
+	}
+};
+
+struct CLToYUVFunc {
+	__m512 kr, kg, kb, nb, pb, nr, pr, scale;
+
+	CLToYUVFunc(float kr_, float kg_, float kb_, float nb_, float pb_, float nr_, float pr_, float scale_) :
+		kr{ _mm512_set1_ps(kr_) }, kg{ _mm512_set1_ps(kg_) }, kb{ _mm512_set1_ps(kb_) },
+		nb{ _mm512_set1_ps(0.5f / nb_) }, pb{ _mm512_set1_ps(0.5f / pb_) },
+		nr{ _mm512_set1_ps(0.5f / nr_) }, pr{ _mm512_set1_ps(0.5f / pr_) },
+		scale{ _mm512_set1_ps(scale_) }
+	{}
+
+	inline FORCE_INLINE void func(__m512 &r, __m512 &g, __m512 &b) const
+	{
+		__mmask16 u_neg, v_neg;
+		__m512 y, b_minus_y, r_minus_y;
+
+		r = _mm512_mul_ps(r, scale);
+		g = _mm512_mul_ps(g, scale);
+		b = _mm512_mul_ps(b, scale);
+
+		y = _mm512_mul_ps(kr, r);
+		y = _mm512_fmadd_ps(kg, g, y);
+		y = _mm512_fmadd_ps(kb, b, y);
+
+		y = rec_709_oetf_ps(y);
+		b = rec_709_oetf_ps(b);
+		r = rec_709_oetf_ps(r);
+
+		b_minus_y = _mm512_sub_ps(b, y);
+		r_minus_y = _mm512_sub_ps(r, y);
+
+		u_neg = _mm512_cmp_ps_mask(b_minus_y, _mm512_setzero_ps(), _CMP_LT_OQ);
+		v_neg = _mm512_cmp_ps_mask(r_minus_y, _mm512_setzero_ps(), _CMP_LT_OQ);
+
+		r = y;
+		g = _mm512_mul_ps(b_minus_y, _mm512_mask_blend_ps(u_neg, pb, nb));
+		b = _mm512_mul_ps(r_minus_y, _mm512_mask_blend_ps(v_neg, pr, nr));
+	}
+};
+
+template <class Op>
+void filter_line3_avx512(const Op &op, const float * const * RESTRICT src, float * const * RESTRICT dst, unsigned left, unsigned right)
+{
+	const float *src0 = src[0];
+	const float *src1 = src[1];
+	const float *src2 = src[2];
+	float *dst0 = dst[0];
+	float *dst1 = dst[1];
+	float *dst2 = dst[2];
+
+	unsigned vec_left = ceil_n(left, 16);
+	unsigned vec_right = floor_n(right, 16);
+
+	if (left != vec_left) {
+		__m512 x = _mm512_load_ps(src0 + vec_left - 16);
+		__m512 y = _mm512_load_ps(src1 + vec_left - 16);
+		__m512 z = _mm512_load_ps(src2 + vec_left - 16);
+		__mmask16 mask = mmask16_set_hi(vec_left - left);
+		op.func(x, y, z);
+
+		_mm512_mask_store_ps(dst0 + vec_left - 16, mask, x);
+		_mm512_mask_store_ps(dst1 + vec_left - 16, mask, y);
+		_mm512_mask_store_ps(dst2 + vec_left - 16, mask, z);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 16) {
+		__m512 x = _mm512_load_ps(src0 + j);
+		__m512 y = _mm512_load_ps(src1 + j);
+		__m512 z = _mm512_load_ps(src2 + j);
+		op.func(x, y, z);
+
+		_mm512_store_ps(dst0 + j, x);
+		_mm512_store_ps(dst1 + j, y);
+		_mm512_store_ps(dst2 + j, z);
+	}
+
+	if (right != vec_right) {
+		__m512 x = _mm512_load_ps(src0 + vec_right);
+		__m512 y = _mm512_load_ps(src1 + vec_right);
+		__m512 z = _mm512_load_ps(src2 + vec_right);
+		__mmask16 mask = mmask16_set_lo(right - vec_right);
+		op.func(x, y, z);
+
+		_mm512_mask_store_ps(dst0 + vec_right, mask, x);
+		_mm512_mask_store_ps(dst1 + vec_right, mask, y);
+		_mm512_mask_store_ps(dst2 + vec_right, mask, z);
+	}
+}
+
 template <class Op>
 void gamma_filter_line_avx512(const float *src, float *dst, float scale, unsigned left, unsigned right)
 {
@@ -320,6 +734,78 @@ public:
 	}
 };
 
+template <class Op>
+class AribB67OperationAVX512 final : public Operation {
+	float m_kr;
+	float m_kg;
+	float m_kb;
+	float m_scale;
+public:
+	AribB67OperationAVX512(double kr, double kg, double kb, float scale) :
+		m_kr{ static_cast<float>(kr) },
+		m_kg{ static_cast<float>(kg) },
+		m_kb{ static_cast<float>(kb) },
+		m_scale{ scale }
+	{}
+
+	unsigned alignment_mask() const noexcept override { return 0xF; }
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
+	{
+		filter_line3_avx512(Op{ m_kr, m_kg, m_kb, m_scale }, src, dst, left, right);
+	}
+};
+
+template <class Op>
+class CLOperationAVX512 final : public Operation {
+	float m_kr;
+	float m_kg;
+	float m_kb;
+	float m_nb;
+	float m_pb;
+	float m_nr;
+	float m_pr;
+	float m_scale;
+public:
+	CLOperationAVX512(gamma_func to_gamma, double kr, double kg, double kb, float scale) :
+		m_kr{ static_cast<float>(kr) },
+		m_kg{ static_cast<float>(kg) },
+		m_kb{ static_cast<float>(kb) },
+		m_nb{},
+		m_pb{},
+		m_nr{},
+		m_pr{},
+		m_scale{ scale }
+	{
+		EnsureSinglePrecision x87;
+
+		m_nb = to_gamma(1.0f - static_cast<float>(kb));
+		m_pb = 1.0f - to_gamma(static_cast<float>(kb));
+		m_nr = to_gamma(1.0f - static_cast<float>(kr));
+		m_pr = 1.0f - to_gamma(static_cast<float>(kr));
+	}
+
+	unsigned alignment_mask() const noexcept override { return 0xF; }
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
+	{
+		filter_line3_avx512(Op{ m_kr, m_kg, m_kb, m_nb, m_pb, m_nr, m_pr, m_scale }, src, dst, left, right);
+	}
+};
+
+class Lut3DOperationAVX512 final : public Operation {
+	std::shared_ptr<const Lut3D> m_lut;
+public:
+	explicit Lut3DOperationAVX512(std::shared_ptr<const Lut3D> lut) : m_lut(std::move(lut)) {}
+
+	unsigned alignment_mask() const noexcept override { return 0xF; }
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const noexcept override
+	{
+		lut3d_filter_line_avx512(*m_lut, src, dst, left, right);
+	}
+};
+
 } // namespace
 
 
@@ -358,6 +844,43 @@ std::unique_ptr<Operation> create_inverse_gamma_operation_avx512(const TransferF
 	return nullptr;
 }
 
+std::unique_ptr<Operation> create_arib_b67_operation_avx512(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma)
+		return nullptr;
+
+	return std::make_unique<AribB67OperationAVX512<AribB67Func>>(m[0][0], m[0][1], m[0][2], transfer.to_gamma_scale);
+}
+
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_avx512(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma)
+		return nullptr;
+
+	return std::make_unique<AribB67OperationAVX512<AribB67InverseFunc>>(m[0][0], m[0][1], m[0][2], transfer.to_linear_scale);
+}
+
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_avx512(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma || transfer.to_linear != rec_709_inverse_oetf)
+		return nullptr;
+
+	return std::make_unique<CLOperationAVX512<CLToRGBFunc>>(transfer.to_gamma, m[0][0], m[0][1], m[0][2], transfer.to_linear_scale);
+}
+
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_avx512(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma || transfer.to_gamma != rec_709_oetf)
+		return nullptr;
+
+	return std::make_unique<CLOperationAVX512<CLToYUVFunc>>(transfer.to_gamma, m[0][0], m[0][1], m[0][2], transfer.to_gamma_scale);
+}
+
+std::unique_ptr<Operation> create_lut3d_operation_avx512(const std::shared_ptr<const Lut3D> &lut)
+{
+	return std::make_unique<Lut3DOperationAVX512>(lut);
+}
+
 } // namespace zimg::colorspace
 
 #endif // ZIMG_X86
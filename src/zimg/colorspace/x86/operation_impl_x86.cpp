@@ -68,6 +68,106 @@ std::unique_ptr<Operation> create_inverse_gamma_operation_x86(const TransferFunc
 	return ret;
 }
 
+std::unique_ptr<Operation> create_arib_b67_operation_x86(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			ret = create_arib_b67_operation_avx512(m, transfer, params);
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_arib_b67_operation_avx2(m, transfer, params);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_arib_b67_operation_avx512(m, transfer, params);
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_arib_b67_operation_avx2(m, transfer, params);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_x86(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			ret = create_inverse_arib_b67_operation_avx512(m, transfer, params);
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_inverse_arib_b67_operation_avx2(m, transfer, params);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_inverse_arib_b67_operation_avx512(m, transfer, params);
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_inverse_arib_b67_operation_avx2(m, transfer, params);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_x86(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			ret = create_cl_yuv_to_rgb_operation_avx512(m, transfer, params);
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_cl_yuv_to_rgb_operation_avx2(m, transfer, params);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_cl_yuv_to_rgb_operation_avx512(m, transfer, params);
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_cl_yuv_to_rgb_operation_avx2(m, transfer, params);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_x86(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			ret = create_cl_rgb_to_yuv_operation_avx512(m, transfer, params);
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_cl_rgb_to_yuv_operation_avx2(m, transfer, params);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_cl_rgb_to_yuv_operation_avx512(m, transfer, params);
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_cl_rgb_to_yuv_operation_avx2(m, transfer, params);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_lut3d_operation_x86(const std::shared_ptr<const Lut3D> &lut, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			ret = create_lut3d_operation_avx512(lut);
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_lut3d_operation_avx2(lut);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_lut3d_operation_avx512(lut);
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_lut3d_operation_avx2(lut);
+	}
+
+	return ret;
+}
+
 } // namespace zimg::colorspace
 
 #endif // ZIMG_X86
@@ -13,6 +13,7 @@ enum class CPUClass;
 
 namespace zimg::colorspace {
 
+struct Lut3D;
 struct Matrix3x3;
 struct OperationParams;
 struct TransferFunction;
@@ -23,16 +24,47 @@ std::unique_ptr<Operation> create_matrix_operation_avx512(const Matrix3x3 &m);
 
 std::unique_ptr<Operation> create_matrix_operation_x86(const Matrix3x3 &m, CPUClass cpu);
 
+// Selects the polynomial approximation on CPUs with slow gathers and the LUT otherwise.
 std::unique_ptr<Operation> create_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params);
+std::unique_ptr<Operation> create_gamma_lut_operation_avx2(const TransferFunction &transfer, const OperationParams &params);
+std::unique_ptr<Operation> create_gamma_polynomial_operation_avx2(const TransferFunction &transfer, const OperationParams &params);
 std::unique_ptr<Operation> create_gamma_operation_avx512(const TransferFunction &transfer, const OperationParams &params);
 
 std::unique_ptr<Operation> create_gamma_operation_x86(const TransferFunction &transfer, const OperationParams &params, CPUClass cpu);
 
 std::unique_ptr<Operation> create_inverse_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params);
+std::unique_ptr<Operation> create_inverse_gamma_lut_operation_avx2(const TransferFunction &transfer, const OperationParams &params);
+std::unique_ptr<Operation> create_inverse_gamma_polynomial_operation_avx2(const TransferFunction &transfer, const OperationParams &params);
 std::unique_ptr<Operation> create_inverse_gamma_operation_avx512(const TransferFunction &transfer, const OperationParams &params);
 
 std::unique_ptr<Operation> create_inverse_gamma_operation_x86(const TransferFunction &transfer, const OperationParams &params, CPUClass cpu);
 
+std::unique_ptr<Operation> create_arib_b67_operation_avx2(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params);
+std::unique_ptr<Operation> create_arib_b67_operation_avx512(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params);
+
+std::unique_ptr<Operation> create_arib_b67_operation_x86(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params, CPUClass cpu);
+
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_avx2(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params);
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_avx512(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params);
+
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_x86(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params, CPUClass cpu);
+
+// Constant-luminance operations are only accelerated for the Rec. 709 transfer function.
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_avx2(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params);
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_avx512(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params);
+
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_x86(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params, CPUClass cpu);
+
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_avx2(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params);
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_avx512(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params);
+
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_x86(const Matrix3x3 &m, const TransferFunction &transfer, const OperationParams &params, CPUClass cpu);
+
+std::unique_ptr<Operation> create_lut3d_operation_avx2(const std::shared_ptr<const Lut3D> &lut);
+std::unique_ptr<Operation> create_lut3d_operation_avx512(const std::shared_ptr<const Lut3D> &lut);
+
+std::unique_ptr<Operation> create_lut3d_operation_x86(const std::shared_ptr<const Lut3D> &lut, CPUClass cpu);
+
 } // namespace zimg::colorspace
 
 #endif // ZIMG_COLORSPACE_X86_OPERATION_IMPL_X86_H_
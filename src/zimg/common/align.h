@@ -11,7 +11,7 @@ namespace zimg {
 #if defined(ZIMG_X86)
 constexpr int ALIGNMENT = 64;
 constexpr int ALIGNMENT_RELAXED = 32;
-#elif defined(ZIMG_ARM)
+#elif defined(ZIMG_ARM) || defined(ZIMG_VEC)
 constexpr int ALIGNMENT = 16;
 constexpr int ALIGNMENT_RELAXED = 16;
 #else
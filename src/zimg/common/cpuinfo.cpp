@@ -15,6 +15,21 @@ unsigned long cpu_cache_per_thread() noexcept
 	return ret ? ret : 1024 * 1024UL;
 }
 
+CPUClass cpu_resolve(CPUClass cpu) noexcept
+{
+	if (!cpu_is_autodetect(cpu))
+		return cpu;
+#if defined(ZIMG_X86)
+	return cpu_resolve_x86(cpu);
+#elif defined(ZIMG_ARM)
+	return CPUClass::ARM_NEON;
+#elif defined(ZIMG_VEC)
+	return CPUClass::GENERIC_VEC;
+#else
+	return CPUClass::NONE;
+#endif
+}
+
 bool cpu_has_fast_f16(CPUClass cpu) noexcept
 {
 	bool ret = false;
@@ -18,6 +18,8 @@ enum class CPUClass {
 	X86_AVX512_CLX, // VNNI
 #elif defined(ZIMG_ARM)
 	ARM_NEON,
+#elif defined(ZIMG_VEC)
+	GENERIC_VEC, // compiler vector extensions
 #endif
 };
 
@@ -28,6 +30,15 @@ constexpr bool cpu_is_autodetect(CPUClass cpu) noexcept
 
 unsigned long cpu_cache_per_thread() noexcept;
 
+/**
+ * Resolve autodetection to the most capable CPU class supported by the
+ * current processor. Other values are returned unchanged.
+ *
+ * @param cpu cpu class
+ * @return cpu class without autodetection
+ */
+CPUClass cpu_resolve(CPUClass cpu) noexcept;
+
 bool cpu_has_fast_f16(CPUClass cpu) noexcept;
 bool cpu_requires_64b_alignment(CPUClass cpu) noexcept;
 
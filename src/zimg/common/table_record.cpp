@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <cstring>
+#include "table_record.h"
+
+namespace zimg {
+
+namespace {
+
+thread_local TableRecord *g_current_record = nullptr;
+
+} // namespace
+
+
+TableRecord *TableRecord::current() noexcept
+{
+	return g_current_record;
+}
+
+void TableRecord::add(Kind kind, key_type key, std::shared_ptr<const void> table, size_t count)
+{
+	m_entries.push_back({ kind, std::move(key), std::move(table), count });
+}
+
+const TableRecord::entry *TableRecord::find(Kind kind, const key_type &key) const noexcept
+{
+	auto it = std::find_if(m_entries.begin(), m_entries.end(), [&](const entry &e) { return e.kind == kind && e.key == key; });
+	return it == m_entries.end() ? nullptr : &*it;
+}
+
+
+TableRecordScope::TableRecordScope(TableRecord *record) noexcept : m_prev{ g_current_record }
+{
+	g_current_record = record;
+}
+
+TableRecordScope::~TableRecordScope()
+{
+	g_current_record = m_prev;
+}
+
+
+uint64_t table_key_bits(double x) noexcept
+{
+	uint64_t bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+	return bits;
+}
+
+} // namespace zimg
@@ -0,0 +1,97 @@
+#pragma once
+
+#ifndef ZIMG_TABLE_RECORD_H_
+#define ZIMG_TABLE_RECORD_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace zimg {
+
+/**
+ * Precomputed tables obtained while building a graph.
+ *
+ * While a record is installed on the current thread with
+ * {@link TableRecordScope}, code computing coefficient or lookup tables
+ * appends each table to the record. A record in replay mode instead supplies
+ * previously recorded tables, so that rebuilding the same graph skips their
+ * computation.
+ */
+class TableRecord {
+public:
+	enum class Kind : uint32_t {
+		RESIZE_FILTER = 1, // resize::FilterContext
+		GAMMA_LUT = 2,     // float[count]
+		DEPTH_LUT = 3,     // float[count]
+		LUT3D = 4,         // colorspace::Lut3D
+	};
+	static constexpr unsigned NUM_KINDS = 4;
+
+	typedef std::vector<uint64_t> key_type;
+
+	struct entry {
+		Kind kind;
+		key_type key;
+		std::shared_ptr<const void> table;
+		size_t count;
+	};
+private:
+	std::vector<entry> m_entries;
+	std::array<uint64_t, NUM_KINDS> m_ordinal;
+	bool m_replay;
+public:
+	explicit TableRecord(bool replay = false) : m_entries{}, m_ordinal{}, m_replay{ replay } {}
+
+	/**
+	 * Get the record installed on the current thread.
+	 *
+	 * @return record, or null if none is installed
+	 */
+	static TableRecord *current() noexcept;
+
+	bool is_replay() const noexcept { return m_replay; }
+
+	const std::vector<entry> &entries() const noexcept { return m_entries; }
+
+	/**
+	 * Get the sequence number of the next table of a kind. Used to key tables
+	 * which have no compact description of their parameters.
+	 */
+	uint64_t next_ordinal(Kind kind) noexcept { return m_ordinal[static_cast<uint32_t>(kind) - 1]++; }
+
+	void add(Kind kind, key_type key, std::shared_ptr<const void> table, size_t count = 0);
+
+	/**
+	 * Find a table by kind and key.
+	 *
+	 * @return entry, or null if not found
+	 */
+	const entry *find(Kind kind, const key_type &key) const noexcept;
+};
+
+/**
+ * Installs a record on the current thread for the lifetime of the object.
+ */
+class TableRecordScope {
+	TableRecord *m_prev;
+public:
+	explicit TableRecordScope(TableRecord *record) noexcept;
+
+	TableRecordScope(const TableRecordScope &) = delete;
+
+	~TableRecordScope();
+
+	TableRecordScope &operator=(const TableRecordScope &) = delete;
+};
+
+/**
+ * Get the bit representation of a floating-point key component.
+ */
+uint64_t table_key_bits(double x) noexcept;
+
+} // namespace zimg
+
+#endif // ZIMG_TABLE_RECORD_H_
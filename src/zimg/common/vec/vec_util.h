@@ -0,0 +1,113 @@
+#pragma once
+
+#ifdef ZIMG_VEC
+
+#ifndef ZIMG_COMMON_VEC_VEC_UTIL_H_
+#define ZIMG_COMMON_VEC_VEC_UTIL_H_
+
+#include <cstdint>
+#include <cstring>
+#include "common/ccdep.h"
+
+namespace zimg {
+
+// Generic 128-bit vectors. The compiler lowers operations on these to the
+// native SIMD instructions of the target, or to scalar code if there are none.
+typedef float f32x4 __attribute__((vector_size(16)));
+typedef int32_t i32x4 __attribute__((vector_size(16)));
+typedef uint32_t u32x4 __attribute__((vector_size(16)));
+typedef int16_t i16x8 __attribute__((vector_size(16)));
+typedef uint16_t u16x8 __attribute__((vector_size(16)));
+typedef uint8_t u8x16 __attribute__((vector_size(16)));
+
+// Partial vectors used when widening or narrowing elements.
+typedef int16_t i16x4 __attribute__((vector_size(8)));
+typedef uint16_t u16x4 __attribute__((vector_size(8)));
+typedef uint8_t u8x8 __attribute__((vector_size(8)));
+typedef uint8_t u8x4 __attribute__((vector_size(4)));
+
+// Load a vector from [src], which need not be aligned.
+template <class V, class T>
+static inline FORCE_INLINE V vec_load(const T *src)
+{
+	V x;
+	std::memcpy(&x, src, sizeof(V));
+	return x;
+}
+
+// Store [x] to [dst], which need not be aligned.
+template <class V, class T>
+static inline FORCE_INLINE void vec_store(T *dst, V x)
+{
+	std::memcpy(dst, &x, sizeof(V));
+}
+
+// Convert each element of [x] to the element type of [V].
+template <class V, class U>
+static inline FORCE_INLINE V vec_convert(U x)
+{
+	return __builtin_convertvector(x, V);
+}
+
+// Store from [x] into [dst] the elements with index in [lo, hi).
+template <class V, class T>
+static inline FORCE_INLINE void vec_store_range(T *dst, V x, unsigned lo, unsigned hi)
+{
+	for (unsigned i = lo; i < hi; ++i) {
+		dst[i] = x[i];
+	}
+}
+
+// Select elements from [a] where [mask] is set, else from [b].
+template <class V, class M>
+static inline FORCE_INLINE V vec_select(M mask, V a, V b)
+{
+	return (V)((mask & (M)a) | (~mask & (M)b));
+}
+
+// Clamp [x] to [lo, hi]. Matches std::clamp, including for NaN.
+template <class V>
+static inline FORCE_INLINE V vec_clamp(V x, V lo, V hi)
+{
+	x = vec_select(x < lo, lo, x);
+	x = vec_select(hi < x, hi, x);
+	return x;
+}
+
+// Round to nearest integer, ties to even. Exact for |x| < 2^22.
+static inline FORCE_INLINE i32x4 vec_round_i32(f32x4 x)
+{
+	const f32x4 magic = f32x4{} + 12582912.0f; // 1.5 * 2^23
+	return vec_convert<i32x4>((x + magic) - magic);
+}
+
+// Transpose in-place the 4x4 matrix stored in [x0]-[x3].
+template <class V>
+static inline FORCE_INLINE void vec_transpose4(V &x0, V &x1, V &x2, V &x3)
+{
+	V t0 = { x0[0], x1[0], x2[0], x3[0] };
+	V t1 = { x0[1], x1[1], x2[1], x3[1] };
+	V t2 = { x0[2], x1[2], x2[2], x3[2] };
+	V t3 = { x0[3], x1[3], x2[3], x3[3] };
+
+	x0 = t0;
+	x1 = t1;
+	x2 = t2;
+	x3 = t3;
+}
+
+// Store each element of [x] to the corresponding destination.
+template <class V, class T>
+static inline FORCE_INLINE void vec_scatter4(T *dst0, T *dst1, T *dst2, T *dst3, V x)
+{
+	*dst0 = x[0];
+	*dst1 = x[1];
+	*dst2 = x[2];
+	*dst3 = x[3];
+}
+
+} // namespace zimg
+
+#endif // ZIMG_COMMON_VEC_VEC_UTIL_H_
+
+#endif // ZIMG_VEC
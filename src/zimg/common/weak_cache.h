@@ -0,0 +1,74 @@
+#pragma once
+
+#ifndef ZIMG_WEAK_CACHE_H_
+#define ZIMG_WEAK_CACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace zimg {
+
+// Thread-safe cache of immutable objects shared between users with identical
+// keys. Entries are held weakly, so that an object is freed with its last
+// user, except for the N most recently created objects, which are kept alive
+// so that graphs built and destroyed repeatedly do not recompute them.
+template <class Key, class T, std::size_t N>
+class weak_cache {
+	std::map<Key, std::weak_ptr<T>> m_cache;
+	std::array<std::shared_ptr<T>, N> m_retained;
+	std::size_t m_retain_pos = 0;
+	std::mutex m_mutex;
+
+	void prune()
+	{
+		for (auto it = m_cache.begin(); it != m_cache.end();) {
+			it = it->second.expired() ? m_cache.erase(it) : std::next(it);
+		}
+	}
+public:
+	/**
+	 * Look up the object for a key, creating it if needed.
+	 *
+	 * The object is created outside of the lock. Concurrent callers may
+	 * duplicate work, but all receive the first result inserted.
+	 *
+	 * @param key key, which must not contain unordered values
+	 * @param func function returning std::shared_ptr<T>
+	 * @return shared object
+	 */
+	template <class Func>
+	std::shared_ptr<T> get(const Key &key, Func func)
+	{
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+			auto it = m_cache.find(key);
+
+			if (it != m_cache.end()) {
+				if (auto ret = it->second.lock())
+					return ret;
+			}
+		}
+
+		std::shared_ptr<T> obj = func();
+
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		std::weak_ptr<T> &entry = m_cache[key];
+
+		if (auto existing = entry.lock())
+			return existing;
+
+		entry = obj;
+		prune();
+
+		m_retained[m_retain_pos++ % N] = obj;
+		return obj;
+	}
+};
+
+} // namespace zimg
+
+#endif // ZIMG_WEAK_CACHE_H_
@@ -419,6 +419,21 @@ unsigned long cpu_cache_per_thread_x86() noexcept
 		return cache.l1d / cache.l1d_threads;
 }
 
+CPUClass cpu_resolve_x86(CPUClass cpu) noexcept
+{
+	if (!cpu_is_autodetect(cpu))
+		return cpu;
+
+	X86Capabilities caps = query_x86_capabilities();
+	if (cpu_has_avx512_f_dq_bw_vl(caps) && caps.avx512vnni)
+		return CPUClass::X86_AVX512_CLX;
+	if (cpu_has_avx512_f_dq_bw_vl(caps))
+		return CPUClass::X86_AVX512;
+	if (caps.avx2)
+		return CPUClass::X86_AVX2;
+	return CPUClass::NONE;
+}
+
 bool cpu_has_fast_f16_x86(CPUClass cpu) noexcept
 {
 	if (cpu_is_autodetect(cpu)) {
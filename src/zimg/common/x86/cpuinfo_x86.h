@@ -87,6 +87,7 @@ X86CacheHierarchy query_x86_cache_hierarchy() noexcept;
 
 unsigned long cpu_cache_per_thread_x86() noexcept;
 
+CPUClass cpu_resolve_x86(CPUClass cpu) noexcept;
 bool cpu_has_fast_f16_x86(CPUClass cpu) noexcept;
 bool cpu_requires_64b_alignment_x86(CPUClass cpu) noexcept;
 
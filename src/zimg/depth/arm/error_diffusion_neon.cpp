@@ -14,6 +14,7 @@
 #include "common/except.h"
 #include "common/pixel.h"
 #include "common/zassert.h"
+#include "depth/error_diffusion.h"
 #include "depth/quantize.h"
 #include "graph/filter_base.h"
 #include "dither_arm.h"
@@ -24,6 +25,8 @@ namespace zimg::depth {
 
 namespace {
 
+static_assert(ED_WAVEFRONT_ROWS == 8 && ED_WAVEFRONT_LAG == 2, "wavefront is hard-coded for 8 rows");
+
 template <class T>
 struct Buffer {
 	const graphengine::BufferDescriptor &buffer;
@@ -34,14 +37,6 @@ struct Buffer {
 };
 
 
-struct error_state {
-	float err_left[8];
-	float err_top_right[8];
-	float err_top[8];
-	float err_top_left[8];
-};
-
-
 template <PixelType Type>
 struct error_diffusion_traits;
 
@@ -44,7 +44,8 @@ DepthConversion::DepthConversion(unsigned width, unsigned height) :
 	pixel_out{},
 	dither_type{ DitherType::NONE },
 	planes{ true, false, false, false },
-	cpu{ CPUClass::NONE }
+	cpu{ CPUClass::NONE },
+	transfer{}
 {}
 
 DepthConversion::result DepthConversion::create() const try
@@ -54,6 +55,15 @@ DepthConversion::result DepthConversion::create() const try
 	if ((!pixel_in.fullrange && pixel_in.depth < 8) || (!pixel_out.fullrange && pixel_out.depth < 8))
 		error::throw_<error::BitDepthOverflow>("bit depth must be at least 8 for limited range");
 
+	if (transfer.func) {
+		if (pixel_is_integer(pixel_in.type) && pixel_out.type == PixelType::FLOAT)
+			return{ create_convert_to_float_lut(width, height, pixel_in, pixel_out, transfer), planes.data() };
+		else if (pixel_in.type == PixelType::FLOAT && pixel_is_integer(pixel_out.type) && dither_type != DitherType::ERROR_DIFFUSION)
+			return create_dither(dither_type, width, height, pixel_in, pixel_out, transfer, planes.data(), cpu);
+		else
+			error::throw_<error::InternalError>("unsupported transfer conversion");
+	}
+
 	if (pixel_in == pixel_out)
 		return{};
 	else if (is_lossless_conversion(pixel_in, pixel_out))
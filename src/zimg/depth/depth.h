@@ -24,6 +24,16 @@ enum class DitherType {
 	ERROR_DIFFUSION,
 };
 
+/**
+ * Per-sample transfer function applied on the floating point side of a
+ * conversion, evaluated as (postscale * func(x * prescale)).
+ */
+struct Transfer {
+	float (*func)(float);
+	float prescale;
+	float postscale;
+};
+
 struct DepthConversion {
 	struct result {
 		std::array<std::unique_ptr<graphengine::Filter>, 4> filters;
@@ -45,6 +55,12 @@ struct DepthConversion {
 	BUILDER_MEMBER(std::array<bool COMMA 4>, planes)
 #undef COMMA
 	BUILDER_MEMBER(CPUClass, cpu)
+
+	/**
+	 * Transfer function fused into the conversion. Applied after converting
+	 * integer input to float, or before quantizing float input to integer.
+	 */
+	BUILDER_MEMBER(Transfer, transfer)
 #undef BUILDER_MEMBER
 
 	DepthConversion(unsigned width, unsigned height);
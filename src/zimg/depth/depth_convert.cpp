@@ -1,12 +1,16 @@
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <stdexcept>
 #include <tuple>
+#include "common/alloc.h"
 #include "common/checked_int.h"
 #include "common/except.h"
 #include "common/pixel.h"
+#include "common/table_record.h"
 #include "common/zassert.h"
 #include "graph/filter_base.h"
+#include "depth.h"
 #include "depth_convert.h"
 #include "quantize.h"
 
@@ -14,6 +18,8 @@
   #include "x86/depth_convert_x86.h"
 #elif defined(ZIMG_ARM)
   #include "arm/depth_convert_arm.h"
+#elif defined(ZIMG_VEC)
+  #include "vec/depth_convert_vec.h"
 #endif
 
 namespace zimg::depth {
@@ -182,6 +188,85 @@ public:
 	}
 };
 
+
+class ConvertToFloatLUT : public graph::PointFilter {
+	std::shared_ptr<const float[]> m_lut;
+	unsigned m_lut_max;
+	PixelType m_type_in;
+
+	void check_preconditions(unsigned width, const PixelFormat &pixel_in, const PixelFormat &pixel_out)
+	{
+		zassert_d(width <= pixel_max_width(pixel_in.type), "overflow");
+		zassert_d(width <= pixel_max_width(pixel_out.type), "overflow");
+
+		if (!pixel_is_integer(pixel_in.type))
+			error::throw_<error::InternalError>("lookup table requires integer input");
+		if (pixel_out.type != PixelType::FLOAT)
+			error::throw_<error::InternalError>("lookup table requires float output");
+	}
+
+	template <class T>
+	void process_line(const void *src, void *dst, unsigned left, unsigned right) const
+	{
+		const T *src_p = static_cast<const T *>(src);
+		float *dst_p = static_cast<float *>(dst);
+		const float *lut = m_lut.get();
+		unsigned max = m_lut_max;
+
+		std::transform(src_p + left, src_p + right, dst_p + left, [=](T x) { return lut[std::min(static_cast<unsigned>(x), max)]; });
+	}
+public:
+	ConvertToFloatLUT(unsigned width, unsigned height, const PixelFormat &pixel_in, const PixelFormat &pixel_out, const Transfer &transfer) :
+		PointFilter(width, height, pixel_out.type),
+		m_lut_max{ (1U << pixel_in.depth) - 1 },
+		m_type_in{ pixel_in.type }
+	{
+		check_preconditions(width, pixel_in, pixel_out);
+
+		m_desc.num_deps = 1;
+		m_desc.num_planes = 1;
+		m_desc.flags.in_place = pixel_size(pixel_in.type) == pixel_size(pixel_out.type);
+
+		size_t size = static_cast<size_t>(m_lut_max) + 1;
+		TableRecord *record = TableRecord::current();
+		TableRecord::key_type key;
+
+		if (record) {
+			key = { record->next_ordinal(TableRecord::Kind::DEPTH_LUT), pixel_in.depth };
+
+			if (record->is_replay()) {
+				const TableRecord::entry *entry = record->find(TableRecord::Kind::DEPTH_LUT, key);
+				if (entry && entry->count == size) {
+					m_lut = std::static_pointer_cast<const float[]>(entry->table);
+					return;
+				}
+			}
+		}
+
+		float scale, offset;
+		std::tie(scale, offset) = get_scale_offset(pixel_in, pixel_out);
+
+		std::shared_ptr<float[]> lut{ new float[size] };
+		for (size_t i = 0; i < size; ++i) {
+			float x = static_cast<float>(i) * scale + offset;
+			lut[i] = transfer.postscale * transfer.func(x * transfer.prescale);
+		}
+		m_lut = std::move(lut);
+
+		if (record && !record->is_replay())
+			record->add(TableRecord::Kind::DEPTH_LUT, std::move(key), m_lut, size);
+	}
+
+	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
+	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override
+	{
+		if (m_type_in == PixelType::BYTE)
+			process_line<uint8_t>(in->get_line(i), out->get_line(i), left, right);
+		else
+			process_line<uint16_t>(in->get_line(i), out->get_line(i), left, right);
+	}
+};
+
 } // namespace
 
 
@@ -193,6 +278,8 @@ std::unique_ptr<graphengine::Filter> create_left_shift(unsigned width, unsigned
 	func = select_left_shift_func_x86(pixel_in.type, pixel_out.type, cpu);
 #elif defined(ZIMG_ARM)
 	func = select_left_shift_func_arm(pixel_in.type, pixel_out.type, cpu);
+#elif defined(ZIMG_VEC)
+	func = select_left_shift_func_vec(pixel_in.type, pixel_out.type, cpu);
 #endif
 	if (!func)
 		func = select_left_shift_func(pixel_in.type, pixel_out.type);
@@ -208,6 +295,8 @@ std::unique_ptr<graphengine::Filter> create_convert_to_float(unsigned width, uns
 	func = select_depth_convert_func_x86(pixel_in, pixel_out, cpu);
 #elif defined(ZIMG_ARM)
 	func = select_depth_convert_func_arm(pixel_in, pixel_out, cpu);
+#elif defined(ZIMG_VEC)
+	func = select_depth_convert_func_vec(pixel_in, pixel_out, cpu);
 #endif
 	if (!func)
 		func = select_depth_convert_func(pixel_in.type, pixel_out.type);
@@ -216,4 +305,9 @@ std::unique_ptr<graphengine::Filter> create_convert_to_float(unsigned width, uns
 	return std::make_unique<ConvertToFloat>(func, width, height, pixel_in, pixel_out);
 }
 
+std::unique_ptr<graphengine::Filter> create_convert_to_float_lut(unsigned width, unsigned height, const PixelFormat &pixel_in, const PixelFormat &pixel_out, const Transfer &transfer)
+{
+	return std::make_unique<ConvertToFloatLUT>(width, height, pixel_in, pixel_out, transfer);
+}
+
 } // namespace zimg::depth
@@ -17,6 +17,8 @@ enum class CPUClass;
 
 namespace zimg::depth {
 
+struct Transfer;
+
 typedef void (*left_shift_func)(const void *src, void *dst, unsigned shift, unsigned left, unsigned right);
 typedef void (*depth_convert_func)(const void *src, void *dst, float scale, float offset, unsigned left, unsigned right);
 typedef void (*depth_f16c_func)(const void *src, void *dst, unsigned left, unsigned right);
@@ -25,6 +27,12 @@ std::unique_ptr<graphengine::Filter> create_left_shift(unsigned width, unsigned
 
 std::unique_ptr<graphengine::Filter> create_convert_to_float(unsigned width, unsigned height, const PixelFormat &pixel_in, const PixelFormat &pixel_out, CPUClass cpu);
 
+/**
+ * Create conversion from integer to float with a transfer function applied to
+ * the result. Every input code is precomputed into a lookup table.
+ */
+std::unique_ptr<graphengine::Filter> create_convert_to_float_lut(unsigned width, unsigned height, const PixelFormat &pixel_in, const PixelFormat &pixel_out, const Transfer &transfer);
+
 } // namespace zimg::depth
 
 #endif // ZIMG_DEPTH_DEPTH_CONVERT_H_
@@ -1,9 +1,11 @@
 #include <algorithm>
+#include <climits>
 #include <cmath>
 #include <memory>
 #include <stdexcept>
 #include <tuple>
 #include <utility>
+#include "common/align.h"
 #include "common/alloc.h"
 #include "common/checked_int.h"
 #include "common/except.h"
@@ -13,12 +15,15 @@
 #include "blue.h"
 #include "depth.h"
 #include "dither.h"
+#include "error_diffusion.h"
 #include "quantize.h"
 
 #if defined(ZIMG_X86)
   #include "x86/dither_x86.h"
 #elif defined(ZIMG_ARM)
   #include "arm/dither_arm.h"
+#elif defined(ZIMG_VEC)
+  #include "vec/dither_vec.h"
 #endif
 
 namespace zimg::depth {
@@ -54,6 +59,28 @@ void dither_ordered(const float *dither, unsigned dither_offset, unsigned dither
 	}
 }
 
+template <class U, bool F16C, class T>
+inline float dither_ed_pixel(T src, U *dst, float err_left, float err_top_right, float err_top, float err_top_left,
+                             float scale, float offset, unsigned bits)
+{
+	float x = load_float<F16C>(src) * scale + offset;
+
+	float err = 0;
+
+	err += err_left * (7.0f / 16.0f);
+	err += err_top_right * (3.0f / 16.0f);
+	err += err_top * (5.0f / 16.0f);
+	err += err_top_left * (1.0f / 16.0f);
+
+	x += err;
+	x = std::clamp(x, 0.0f, static_cast<float>(1UL << bits) - 1);
+
+	U q = static_cast<U>(std::lrint(x));
+
+	*dst = q;
+	return x - static_cast<float>(q);
+}
+
 template <class T, class U, bool F16C = false>
 void dither_ed(const void *src, void *dst, void *error_top, void *error_cur, float scale, float offset, unsigned bits, unsigned width)
 {
@@ -66,28 +93,95 @@ void dither_ed(const void *src, void *dst, void *error_top, void *error_cur, flo
 	U *dst_p = static_cast<U *>(dst);
 
 	for (unsigned j = 0; j < width; ++j) {
-		// Error array is padded by one on each side.
+		// Error array is padded by one on the left and two on the right.
 		unsigned j_err = j + 1;
 
-		float x= load_float<F16C>(src_p[j]) * scale + offset;
+		error_cur_p[j_err] = dither_ed_pixel<U, F16C>(src_p[j], dst_p + j, error_cur_p[j_err - 1],
+			error_top_p[j_err + 1], error_top_p[j_err + 0], error_top_p[j_err - 1], scale, offset, bits);
+	}
+}
+
+// Produces the same result as applying dither_ed to ED_WAVEFRONT_ROWS rows in
+// sequence. The rows form a skewed wavefront, so the dependency chains of
+// different rows overlap. Requires at least ED_WAVEFRONT_SKEW columns.
+template <class T, class U, bool F16C = false>
+void dither_ed_wavefront(const graphengine::BufferDescriptor &src, const graphengine::BufferDescriptor &dst, unsigned i,
+                         void *error_top, void *error_cur, float scale, float offset, unsigned bits, unsigned width)
+{
+	constexpr unsigned N = ED_WAVEFRONT_ROWS;
+	constexpr unsigned LAG = ED_WAVEFRONT_LAG;
+	constexpr unsigned SKEW = ED_WAVEFRONT_SKEW;
 
-		float err = 0;
+	const float *error_top_p = static_cast<const float *>(error_top);
+	float *error_cur_p = static_cast<float *>(error_cur);
 
-		err += error_cur_p[j_err - 1] * (7.0f / 16.0f);
-		err += error_top_p[j_err + 1] * (3.0f / 16.0f);
-		err += error_top_p[j_err + 0] * (5.0f / 16.0f);
-		err += error_top_p[j_err - 1] * (1.0f / 16.0f);
+	const T *src_p[N];
+	U *dst_p[N];
 
-		x += err;
-		x = std::clamp(x, 0.0f, static_cast<float>(1UL << bits) - 1);
+	for (unsigned r = 0; r < N; ++r) {
+		src_p[r] = src.get_line<T>(i + r);
+		dst_p[r] = dst.get_line<U>(i + r);
+	}
 
-		U q = static_cast<U>(std::lrint(x));
+	error_state state = {};
+	float error_tmp[N - 1][SKEW + 2] = {};
 
-		dst_p[j] = q;
-		error_cur_p[j_err] = x - static_cast<float>(q);
+	// Prologue.
+	for (unsigned r = 0; r < N - 1; ++r) {
+		void *top = r ? error_tmp[r - 1] : error_top;
+		dither_ed<T, U, F16C>(src_p[r], dst_p[r], top, error_tmp[r], scale, offset, bits, SKEW - LAG * r);
 	}
-}
 
+	// Wavefront.
+	for (unsigned r = 0; r < N; ++r) {
+		unsigned col = SKEW - LAG * r;
+		const float *top = r ? error_tmp[r - 1] : error_top_p;
+
+		state.err_left[r] = r < N - 1 ? error_tmp[r][col] : error_cur_p[0];
+		state.err_top_right[r] = top[col + 2];
+		state.err_top[r] = top[col + 1];
+		state.err_top_left[r] = top[col + 0];
+	}
+
+	unsigned count = width - SKEW;
+
+	for (unsigned j = 0; j < count; ++j) {
+		float err[N];
+
+		for (unsigned r = 0; r < N; ++r) {
+			unsigned col = j + SKEW - LAG * r;
+			err[r] = dither_ed_pixel<U, F16C>(src_p[r][col], dst_p[r] + col, state.err_left[r],
+				state.err_top_right[r], state.err_top[r], state.err_top_left[r], scale, offset, bits);
+		}
+
+		// Each row passes its error to the top-right position of the next row.
+		error_cur_p[j + 1] = err[N - 1];
+
+		for (unsigned r = 0; r < N; ++r) {
+			state.err_left[r] = err[r];
+			state.err_top_left[r] = state.err_top[r];
+			state.err_top[r] = state.err_top_right[r];
+			state.err_top_right[r] = r ? err[r - 1] : error_top_p[j + SKEW + 3];
+		}
+	}
+
+	// Epilogue. The temporary error rows continue from column |count|.
+	for (unsigned r = 1; r < N; ++r) {
+		unsigned col = SKEW - LAG * r;
+
+		error_tmp[r - 1][col + 2] = state.err_top_right[r];
+		error_tmp[r - 1][col + 1] = state.err_top[r];
+		error_tmp[r - 1][col + 0] = state.err_top_left[r];
+	}
+
+	for (unsigned r = 1; r < N; ++r) {
+		unsigned col = SKEW - LAG * r;
+		void *top = error_tmp[r - 1] + col;
+		void *cur = r < N - 1 ? error_tmp[r] + col : error_cur_p + count;
+
+		dither_ed<T, U, F16C>(src_p[r] + count + col, dst_p[r] + count + col, top, cur, scale, offset, bits, LAG * r);
+	}
+}
 
 dither_convert_func select_ordered_dither_func(PixelType pixel_in, PixelType pixel_out)
 {
@@ -133,6 +227,28 @@ auto select_error_diffusion_func(PixelType pixel_in, PixelType pixel_out)
 		error::throw_<error::InternalError>("no conversion between pixel types");
 }
 
+auto select_error_diffusion_wavefront_func(PixelType pixel_in, PixelType pixel_out)
+{
+	if (pixel_in == PixelType::BYTE && pixel_out == PixelType::BYTE)
+		return dither_ed_wavefront<uint8_t, uint8_t>;
+	else if (pixel_in == PixelType::BYTE && pixel_out == PixelType::WORD)
+		return dither_ed_wavefront<uint8_t, uint16_t>;
+	else if (pixel_in == PixelType::WORD && pixel_out == PixelType::BYTE)
+		return dither_ed_wavefront<uint16_t, uint8_t>;
+	else if (pixel_in == PixelType::WORD && pixel_out == PixelType::WORD)
+		return dither_ed_wavefront<uint16_t, uint16_t>;
+	else if (pixel_in == PixelType::HALF && pixel_out == PixelType::BYTE)
+		return dither_ed_wavefront<uint16_t, uint8_t, true>;
+	else if (pixel_in == PixelType::HALF && pixel_out == PixelType::WORD)
+		return dither_ed_wavefront<uint16_t, uint16_t, true>;
+	else if (pixel_in == PixelType::FLOAT && pixel_out == PixelType::BYTE)
+		return dither_ed_wavefront<float, uint8_t>;
+	else if (pixel_in == PixelType::FLOAT && pixel_out == PixelType::WORD)
+		return dither_ed_wavefront<float, uint16_t>;
+	else
+		error::throw_<error::InternalError>("no conversion between pixel types");
+}
+
 
 constexpr unsigned BAYER_TABLE_LEN = 16;
 constexpr unsigned BAYER_TABLE_SCALE = 255;
@@ -237,6 +353,7 @@ public:
 class OrderedDither : public graph::PointFilter {
 	std::shared_ptr<OrderedDitherTable> m_dither_table;
 	dither_convert_func m_func;
+	Transfer m_transfer;
 	float m_scale;
 	float m_offset;
 	unsigned m_depth;
@@ -251,11 +368,12 @@ class OrderedDither : public graph::PointFilter {
 			error::throw_<error::InternalError>("cannot dither to non-integer format");
 	}
 public:
-	OrderedDither(std::shared_ptr<OrderedDitherTable> table, dither_convert_func func, unsigned width, unsigned height,
+	OrderedDither(std::shared_ptr<OrderedDitherTable> table, dither_convert_func func, const Transfer &transfer, unsigned width, unsigned height,
 	              const PixelFormat &pixel_in, const PixelFormat &pixel_out, unsigned plane) :
 		PointFilter(width, height, pixel_out.type),
 		m_dither_table{ std::move(table) },
 		m_func{ func },
+		m_transfer(transfer),
 		m_scale{},
 		m_offset{},
 		m_depth{ pixel_out.depth },
@@ -267,6 +385,13 @@ public:
 		m_desc.num_planes = 1;
 		m_desc.flags.in_place = pixel_size(pixel_in.type) == pixel_size(pixel_out.type);
 
+		if (m_transfer.func) {
+			if (pixel_in.type != PixelType::FLOAT)
+				error::throw_<error::InternalError>("transfer function requires float input");
+
+			m_desc.scratchpad_size = (ceil_n(checked_size_t{ width }, AlignmentOf<float>) * sizeof(float)).get();
+		}
+
 		std::tie(m_scale, m_offset) = get_scale_offset(pixel_in, pixel_out);
 	}
 
@@ -278,6 +403,21 @@ public:
 		const void *src_line = in->get_line(i);
 		void *dst_line = out->get_line(i);
 
+		// Vector kernels may load the full alignment groups around [left, right).
+		if (m_transfer.func) {
+			const float *src_p = static_cast<const float *>(src_line);
+			float *tmp_p = static_cast<float *>(tmp);
+			unsigned tmp_left = floor_n(left, AlignmentOf<float>);
+			unsigned tmp_right = std::min(ceil_n(right, AlignmentOf<float>), m_desc.format.width);
+			Transfer transfer = m_transfer;
+
+			std::transform(src_p + tmp_left, src_p + tmp_right, tmp_p + tmp_left, [=](float x)
+			{
+				return transfer.postscale * transfer.func(x * transfer.prescale);
+			});
+			src_line = tmp;
+		}
+
 		m_func(std::get<0>(dither), std::get<1>(dither), std::get<2>(dither), src_line, dst_line, m_scale, m_offset, m_depth, left, right);
 	}
 };
@@ -286,8 +426,11 @@ public:
 class ErrorDiffusion : public graph::FilterBase {
 public:
 	typedef void (*ed_func)(const void *src, void *dst, void *error_top, void *error_cur, float scale, float offset, unsigned bits, unsigned width);
+	typedef void (*ed_wavefront_func)(const graphengine::BufferDescriptor &src, const graphengine::BufferDescriptor &dst, unsigned i,
+	                                  void *error_top, void *error_cur, float scale, float offset, unsigned bits, unsigned width);
 private:
 	ed_func m_func;
+	ed_wavefront_func m_wavefront_func;
 	float m_scale;
 	float m_offset;
 	unsigned m_depth;
@@ -300,9 +443,18 @@ private:
 		if (!pixel_is_integer(pixel_out.type))
 			error::throw_<error::InternalError>("cannot dither to non-integer format");
 	}
+
+	std::pair<void *, void *> get_error_rows(void *context, bool parity) const
+	{
+		void *error_a = context;
+		void *error_b = static_cast<uint8_t *>(context) + m_desc.context_size / 2;
+
+		return parity ? std::make_pair(error_a, error_b) : std::make_pair(error_b, error_a);
+	}
 public:
-	ErrorDiffusion(ed_func func, unsigned width, unsigned height, const PixelFormat &pixel_in, const PixelFormat &pixel_out) :
+	ErrorDiffusion(ed_func func, ed_wavefront_func wavefront_func, unsigned width, unsigned height, const PixelFormat &pixel_in, const PixelFormat &pixel_out) :
 		m_func{ func },
+		m_wavefront_func{ width >= ED_WAVEFRONT_SKEW ? wavefront_func : nullptr },
 		m_scale{},
 		m_offset{},
 		m_depth{ pixel_out.depth }
@@ -312,9 +464,9 @@ public:
 		m_desc.format = { width, height, pixel_size(pixel_out.type) };
 		m_desc.num_deps = 1;
 		m_desc.num_planes = 1;
-		m_desc.step = 1;
+		m_desc.step = m_wavefront_func ? ED_WAVEFRONT_ROWS : 1;
 
-		m_desc.context_size = ((static_cast<checked_size_t>(width) + 2) * sizeof(float) * 2).get();
+		m_desc.context_size = ((static_cast<checked_size_t>(width) + 3) * sizeof(float) * 2).get();
 
 		m_desc.flags.stateful = 1;
 		m_desc.flags.in_place = pixel_size(pixel_in.type) == pixel_size(pixel_out.type);
@@ -323,7 +475,11 @@ public:
 		std::tie(m_scale, m_offset) = get_scale_offset(pixel_in, pixel_out);
 	}
 
-	pair_unsigned get_row_deps(unsigned i) const noexcept override { return{ i, i + 1 }; }
+	pair_unsigned get_row_deps(unsigned i) const noexcept override
+	{
+		unsigned last = std::min(i, UINT_MAX - m_desc.step) + m_desc.step;
+		return{ i, std::min(last, m_desc.format.height) };
+	}
 
 	pair_unsigned get_col_deps(unsigned, unsigned) const noexcept override { return{ 0, m_desc.format.width }; }
 
@@ -335,16 +491,20 @@ public:
 	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
 	             unsigned i, unsigned left, unsigned right, void *context, void *tmp) const noexcept override
 	{
-		const void *src_p = in->get_line(i);
-		void *dst_p = out->get_line(i);
-
-		void *error_a = context;
-		void *error_b = static_cast<uint8_t *>(context) + m_desc.context_size / 2;
+		// The error rows alternate between groups of rows.
+		bool parity = !!((i / m_desc.step) % 2);
 
-		void *error_top = i % 2 ? error_a : error_b;
-		void *error_cur = i % 2 ? error_b : error_a;
+		if (m_wavefront_func && m_desc.format.height - i >= ED_WAVEFRONT_ROWS) {
+			auto error = get_error_rows(context, parity);
+			m_wavefront_func(*in, *out, i, error.first, error.second, m_scale, m_offset, m_depth, m_desc.format.width);
+			return;
+		}
 
-		m_func(src_p, dst_p, error_top, error_cur, m_scale, m_offset, m_depth, m_desc.format.width);
+		for (unsigned ii = i; ii < get_row_deps(i).second; ++ii) {
+			auto error = get_error_rows(context, parity);
+			m_func(in->get_line(ii), out->get_line(ii), error.first, error.second, m_scale, m_offset, m_depth, m_desc.format.width);
+			parity = !parity;
+		}
 	}
 };
 
@@ -375,11 +535,14 @@ std::unique_ptr<graphengine::Filter> create_error_diffusion(unsigned width, unsi
 #endif
 
 	ErrorDiffusion::ed_func func = nullptr;
+	ErrorDiffusion::ed_wavefront_func wavefront_func = nullptr;
 
-	if (!func)
+	if (!func) {
 		func = select_error_diffusion_func(pixel_in.type, pixel_out.type);
+		wavefront_func = select_error_diffusion_wavefront_func(pixel_in.type, pixel_out.type);
+	}
 
-	return std::make_unique<ErrorDiffusion>(func, width, height, pixel_in, pixel_out);
+	return std::make_unique<ErrorDiffusion>(func, wavefront_func, width, height, pixel_in, pixel_out);
 }
 
 } // namespace
@@ -387,8 +550,17 @@ std::unique_ptr<graphengine::Filter> create_error_diffusion(unsigned width, unsi
 
 DepthConversion::result create_dither(DitherType type, unsigned width, unsigned height, const PixelFormat &pixel_in, const PixelFormat &pixel_out, const bool planes[4], CPUClass cpu)
 {
-	if (type == DitherType::ERROR_DIFFUSION)
+	return create_dither(type, width, height, pixel_in, pixel_out, {}, planes, cpu);
+}
+
+DepthConversion::result create_dither(DitherType type, unsigned width, unsigned height, const PixelFormat &pixel_in, const PixelFormat &pixel_out,
+                                      const Transfer &transfer, const bool planes[4], CPUClass cpu)
+{
+	if (type == DitherType::ERROR_DIFFUSION) {
+		if (transfer.func)
+			error::throw_<error::InternalError>("error diffusion does not support transfer function");
 		return{ create_error_diffusion(width, height, pixel_in, pixel_out, cpu), planes };
+	}
 
 	dither_convert_func func = nullptr;
 
@@ -396,6 +568,8 @@ DepthConversion::result create_dither(DitherType type, unsigned width, unsigned
 	func = select_ordered_dither_func_x86(pixel_in, pixel_out, cpu);
 #elif defined(ZIMG_ARM)
 	func = select_ordered_dither_func_arm(pixel_in, pixel_out, cpu);
+#elif defined(ZIMG_VEC)
+	func = select_ordered_dither_func_vec(pixel_in, pixel_out, cpu);
 #endif
 	if (!func)
 		func = select_ordered_dither_func(pixel_in.type, pixel_out.type);
@@ -406,7 +580,7 @@ DepthConversion::result create_dither(DitherType type, unsigned width, unsigned
 		if (!planes[p])
 			continue;
 
-		res.filters[p] = std::make_unique<OrderedDither>(table, func, width, height, pixel_in, pixel_out, p);
+		res.filters[p] = std::make_unique<OrderedDither>(table, func, transfer, width, height, pixel_in, pixel_out, p);
 		res.filter_refs[p] = res.filters[p].get();
 	}
 	return res;
@@ -25,6 +25,13 @@ typedef void (*dither_f16c_func)(const void *src, void *dst, unsigned left, unsi
 
 DepthConversion::result create_dither(DitherType type, unsigned width, unsigned height, const PixelFormat &pixel_in, const PixelFormat &pixel_out, const bool planes[4], CPUClass cpu);
 
+/**
+ * Create dither with a transfer function applied to the floating point input
+ * before quantization. Error diffusion is not supported.
+ */
+DepthConversion::result create_dither(DitherType type, unsigned width, unsigned height, const PixelFormat &pixel_in, const PixelFormat &pixel_out,
+                                      const Transfer &transfer, const bool planes[4], CPUClass cpu);
+
 } // namespace zimg::depth
 
 #endif // ZIMG_DEPTH_DITHER_H_
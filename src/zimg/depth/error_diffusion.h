@@ -0,0 +1,26 @@
+#pragma once
+
+#ifndef ZIMG_DEPTH_ERROR_DIFFUSION_H_
+#define ZIMG_DEPTH_ERROR_DIFFUSION_H_
+
+namespace zimg::depth {
+
+// Error diffusion processes a group of rows as a skewed wavefront. Row i + k
+// trails row i + k - 1 by ED_WAVEFRONT_LAG columns, which is the minimum lag
+// that satisfies the top-right dependency of Floyd-Steinberg, so each column
+// step of the wavefront updates one pixel of every row independently.
+constexpr unsigned ED_WAVEFRONT_ROWS = 8;
+constexpr unsigned ED_WAVEFRONT_LAG = 2;
+constexpr unsigned ED_WAVEFRONT_SKEW = ED_WAVEFRONT_LAG * (ED_WAVEFRONT_ROWS - 1);
+
+// Errors adjacent to the next pixel of each row in the wavefront.
+struct error_state {
+	float err_left[ED_WAVEFRONT_ROWS];
+	float err_top_right[ED_WAVEFRONT_ROWS];
+	float err_top[ED_WAVEFRONT_ROWS];
+	float err_top_left[ED_WAVEFRONT_ROWS];
+};
+
+} // namespace zimg::depth
+
+#endif // ZIMG_DEPTH_ERROR_DIFFUSION_H_
@@ -0,0 +1,119 @@
+#ifdef ZIMG_VEC
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "depth_convert_vec.h"
+
+#include "common/vec/vec_util.h"
+
+namespace zimg::depth {
+
+namespace {
+
+template <class T>
+using pixel_x8 = std::conditional_t<std::is_same_v<T, uint8_t>, u8x8, u16x8>;
+
+template <class T>
+using pixel_x4 = std::conditional_t<std::is_same_v<T, uint8_t>, u8x4, u16x4>;
+
+template <class T, class U>
+void left_shift_vec(const void *src, void *dst, unsigned shift, unsigned left, unsigned right)
+{
+	const T *src_p = static_cast<const T *>(src);
+	U *dst_p = static_cast<U *>(dst);
+
+	unsigned vec_left = std::min(ceil_n(left, 8), right);
+	unsigned vec_right = std::max(floor_n(right, 8), vec_left);
+
+	for (unsigned j = left; j < vec_left; ++j) {
+		dst_p[j] = static_cast<U>(static_cast<unsigned>(src_p[j]) << shift);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 8) {
+		u16x8 x = vec_convert<u16x8>(vec_load<pixel_x8<T>>(src_p + j));
+		x <<= shift;
+		vec_store(dst_p + j, vec_convert<pixel_x8<U>>(x));
+	}
+
+	for (unsigned j = vec_right; j < right; ++j) {
+		dst_p[j] = static_cast<U>(static_cast<unsigned>(src_p[j]) << shift);
+	}
+}
+
+template <class T>
+void integer_to_float_vec(const void *src, void *dst, float scale, float offset, unsigned left, unsigned right)
+{
+	const T *src_p = static_cast<const T *>(src);
+	float *dst_p = static_cast<float *>(dst);
+
+	const f32x4 scale_ps = f32x4{} + scale;
+	const f32x4 offset_ps = f32x4{} + offset;
+
+	unsigned vec_left = std::min(ceil_n(left, 4), right);
+	unsigned vec_right = std::max(floor_n(right, 4), vec_left);
+
+	for (unsigned j = left; j < vec_left; ++j) {
+		dst_p[j] = static_cast<float>(src_p[j]) * scale + offset;
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 4) {
+		f32x4 x = vec_convert<f32x4>(vec_load<pixel_x4<T>>(src_p + j));
+		vec_store(dst_p + j, x * scale_ps + offset_ps);
+	}
+
+	for (unsigned j = vec_right; j < right; ++j) {
+		dst_p[j] = static_cast<float>(src_p[j]) * scale + offset;
+	}
+}
+
+left_shift_func select_left_shift_func_generic(PixelType pixel_in, PixelType pixel_out)
+{
+	if (pixel_in == PixelType::BYTE && pixel_out == PixelType::BYTE)
+		return left_shift_vec<uint8_t, uint8_t>;
+	else if (pixel_in == PixelType::BYTE && pixel_out == PixelType::WORD)
+		return left_shift_vec<uint8_t, uint16_t>;
+	else if (pixel_in == PixelType::WORD && pixel_out == PixelType::BYTE)
+		return left_shift_vec<uint16_t, uint8_t>;
+	else if (pixel_in == PixelType::WORD && pixel_out == PixelType::WORD)
+		return left_shift_vec<uint16_t, uint16_t>;
+	else
+		return nullptr;
+}
+
+depth_convert_func select_depth_convert_func_generic(PixelType pixel_in, PixelType pixel_out)
+{
+	if (pixel_in == PixelType::BYTE && pixel_out == PixelType::FLOAT)
+		return integer_to_float_vec<uint8_t>;
+	else if (pixel_in == PixelType::WORD && pixel_out == PixelType::FLOAT)
+		return integer_to_float_vec<uint16_t>;
+	else
+		return nullptr;
+}
+
+} // namespace
+
+
+left_shift_func select_left_shift_func_vec(PixelType pixel_in, PixelType pixel_out, CPUClass cpu)
+{
+	if (cpu_is_autodetect(cpu) || cpu >= CPUClass::GENERIC_VEC)
+		return select_left_shift_func_generic(pixel_in, pixel_out);
+	else
+		return nullptr;
+}
+
+depth_convert_func select_depth_convert_func_vec(const PixelFormat &format_in, const PixelFormat &format_out, CPUClass cpu)
+{
+	if (cpu_is_autodetect(cpu) || cpu >= CPUClass::GENERIC_VEC)
+		return select_depth_convert_func_generic(format_in.type, format_out.type);
+	else
+		return nullptr;
+}
+
+} // namespace zimg::depth
+
+#endif // ZIMG_VEC
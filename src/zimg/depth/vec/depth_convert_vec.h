@@ -0,0 +1,20 @@
+#pragma once
+
+#ifdef ZIMG_VEC
+
+#ifndef ZIMG_DEPTH_VEC_DEPTH_CONVERT_VEC_H_
+#define ZIMG_DEPTH_VEC_DEPTH_CONVERT_VEC_H_
+
+#include "depth/depth_convert.h"
+
+namespace zimg::depth {
+
+left_shift_func select_left_shift_func_vec(PixelType pixel_in, PixelType pixel_out, CPUClass cpu);
+
+depth_convert_func select_depth_convert_func_vec(const PixelFormat &format_in, const PixelFormat &format_out, CPUClass cpu);
+
+} // namespace zimg::depth
+
+#endif // ZIMG_DEPTH_VEC_DEPTH_CONVERT_VEC_H_
+
+#endif // ZIMG_VEC
@@ -0,0 +1,104 @@
+#ifdef ZIMG_VEC
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "dither_vec.h"
+
+#include "common/vec/vec_util.h"
+
+namespace zimg::depth {
+
+namespace {
+
+template <class T>
+using pixel_x4 = std::conditional_t<std::is_same_v<T, uint8_t>, u8x4, std::conditional_t<std::is_same_v<T, uint16_t>, u16x4, f32x4>>;
+
+template <class T, class U>
+inline FORCE_INLINE U ordered_dither_pixel(float d, T src, float scale, float offset, float maxval)
+{
+	float x = static_cast<float>(src) * scale + offset;
+	x += d;
+	x = std::clamp(x, 0.0f, maxval);
+	return static_cast<U>(std::lrint(x));
+}
+
+// Rounding is exact, as the clamped value never exceeds 2^16.
+template <class T, class U>
+void ordered_dither_vec(const float *dither, unsigned dither_offset, unsigned dither_mask,
+                        const void *src, void *dst, float scale, float offset, unsigned bits, unsigned left, unsigned right)
+{
+	const T *src_p = static_cast<const T *>(src);
+	U *dst_p = static_cast<U *>(dst);
+
+	const float maxval = static_cast<float>(1UL << bits) - 1;
+	const f32x4 scale_ps = f32x4{} + scale;
+	const f32x4 offset_ps = f32x4{} + offset;
+	const f32x4 lo = {};
+	const f32x4 hi = f32x4{} + maxval;
+
+	unsigned vec_left = std::min(ceil_n(left, 4), right);
+	unsigned vec_right = std::max(floor_n(right, 4), vec_left);
+
+	for (unsigned j = left; j < vec_left; ++j) {
+		dst_p[j] = ordered_dither_pixel<T, U>(dither[(dither_offset + j) & dither_mask], src_p[j], scale, offset, maxval);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 4) {
+		f32x4 d = {
+			dither[(dither_offset + j + 0) & dither_mask],
+			dither[(dither_offset + j + 1) & dither_mask],
+			dither[(dither_offset + j + 2) & dither_mask],
+			dither[(dither_offset + j + 3) & dither_mask],
+		};
+		f32x4 x = vec_convert<f32x4>(vec_load<pixel_x4<T>>(src_p + j));
+
+		x = x * scale_ps + offset_ps;
+		x += d;
+		x = vec_clamp(x, lo, hi);
+
+		vec_store(dst_p + j, vec_convert<pixel_x4<U>>(vec_round_i32(x)));
+	}
+
+	for (unsigned j = vec_right; j < right; ++j) {
+		dst_p[j] = ordered_dither_pixel<T, U>(dither[(dither_offset + j) & dither_mask], src_p[j], scale, offset, maxval);
+	}
+}
+
+dither_convert_func select_ordered_dither_func_generic(PixelType pixel_in, PixelType pixel_out)
+{
+	if (pixel_in == PixelType::BYTE && pixel_out == PixelType::BYTE)
+		return ordered_dither_vec<uint8_t, uint8_t>;
+	else if (pixel_in == PixelType::BYTE && pixel_out == PixelType::WORD)
+		return ordered_dither_vec<uint8_t, uint16_t>;
+	else if (pixel_in == PixelType::WORD && pixel_out == PixelType::BYTE)
+		return ordered_dither_vec<uint16_t, uint8_t>;
+	else if (pixel_in == PixelType::WORD && pixel_out == PixelType::WORD)
+		return ordered_dither_vec<uint16_t, uint16_t>;
+	else if (pixel_in == PixelType::FLOAT && pixel_out == PixelType::BYTE)
+		return ordered_dither_vec<float, uint8_t>;
+	else if (pixel_in == PixelType::FLOAT && pixel_out == PixelType::WORD)
+		return ordered_dither_vec<float, uint16_t>;
+	else
+		return nullptr;
+}
+
+} // namespace
+
+
+dither_convert_func select_ordered_dither_func_vec(const PixelFormat &pixel_in, const PixelFormat &pixel_out, CPUClass cpu)
+{
+	if (cpu_is_autodetect(cpu) || cpu >= CPUClass::GENERIC_VEC)
+		return select_ordered_dither_func_generic(pixel_in.type, pixel_out.type);
+	else
+		return nullptr;
+}
+
+} // namespace zimg::depth
+
+#endif // ZIMG_VEC
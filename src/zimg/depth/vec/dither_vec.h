@@ -0,0 +1,18 @@
+#pragma once
+
+#ifdef ZIMG_VEC
+
+#ifndef ZIMG_DEPTH_VEC_DITHER_VEC_H_
+#define ZIMG_DEPTH_VEC_DITHER_VEC_H_
+
+#include "depth/dither.h"
+
+namespace zimg::depth {
+
+dither_convert_func select_ordered_dither_func_vec(const PixelFormat &pixel_in, const PixelFormat &pixel_out, CPUClass cpu);
+
+} // namespace zimg::depth
+
+#endif // ZIMG_DEPTH_VEC_DITHER_VEC_H_
+
+#endif // ZIMG_VEC
@@ -12,6 +12,7 @@
 #include "common/except.h"
 #include "common/pixel.h"
 #include "common/zassert.h"
+#include "depth/error_diffusion.h"
 #include "depth/quantize.h"
 #include "graph/filter_base.h"
 #include "dither_x86.h"
@@ -22,6 +23,8 @@ namespace zimg::depth {
 
 namespace {
 
+static_assert(ED_WAVEFRONT_ROWS == 8 && ED_WAVEFRONT_LAG == 2, "wavefront is hard-coded for 8 rows");
+
 template <class T>
 struct Buffer {
 	const graphengine::BufferDescriptor &buffer;
@@ -32,14 +35,6 @@ struct Buffer {
 };
 
 
-struct error_state {
-	float err_left[8];
-	float err_top_right[8];
-	float err_top[8];
-	float err_top_left[8];
-};
-
-
 template <PixelType SrcType>
 struct error_diffusion_traits;
 
@@ -0,0 +1,38 @@
+#ifdef ZIMG_ARM
+
+#include "common/cpuinfo.h"
+#include "premultiply_arm.h"
+
+namespace zimg::graph {
+
+premultiply_func select_premultiply_func_arm(CPUClass cpu)
+{
+	premultiply_func func = nullptr;
+
+	if (cpu_is_autodetect(cpu)) {
+		func = premultiply_neon;
+	} else {
+		if (!func && cpu >= CPUClass::ARM_NEON)
+			func = premultiply_neon;
+	}
+
+	return func;
+}
+
+premultiply_func select_unpremultiply_func_arm(CPUClass cpu)
+{
+	premultiply_func func = nullptr;
+
+	if (cpu_is_autodetect(cpu)) {
+		func = unpremultiply_neon;
+	} else {
+		if (!func && cpu >= CPUClass::ARM_NEON)
+			func = unpremultiply_neon;
+	}
+
+	return func;
+}
+
+} // namespace zimg::graph
+
+#endif // ZIMG_ARM
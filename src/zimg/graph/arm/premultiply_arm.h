@@ -0,0 +1,28 @@
+#pragma once
+
+#ifdef ZIMG_ARM
+
+#ifndef ZIMG_GRAPH_ARM_PREMULTIPLY_ARM_H_
+#define ZIMG_GRAPH_ARM_PREMULTIPLY_ARM_H_
+
+#include "graph/simple_filters.h"
+
+namespace zimg::graph {
+
+#define DECLARE_PREMULTIPLY(x, cpu) \
+void x##_##cpu(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+
+DECLARE_PREMULTIPLY(premultiply, neon);
+DECLARE_PREMULTIPLY(unpremultiply, neon);
+
+#undef DECLARE_PREMULTIPLY
+
+premultiply_func select_premultiply_func_arm(CPUClass cpu);
+
+premultiply_func select_unpremultiply_func_arm(CPUClass cpu);
+
+} // namespace zimg::graph
+
+#endif // ZIMG_GRAPH_ARM_PREMULTIPLY_ARM_H_
+
+#endif // ZIMG_ARM
@@ -0,0 +1,69 @@
+#ifdef ZIMG_ARM
+
+#include <arm_neon.h>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "premultiply_arm.h"
+
+#include "common/arm/neon_util.h"
+
+namespace zimg::graph {
+
+namespace {
+
+struct Premultiply {
+	static inline FORCE_INLINE float32x4_t func(float32x4_t x, float32x4_t a)
+	{
+		return vmulq_f32(x, a);
+	}
+};
+
+struct Unpremultiply {
+	static inline FORCE_INLINE float32x4_t func(float32x4_t x, float32x4_t a)
+	{
+		a = vmaxq_f32(a, vdupq_n_f32(0.0f));
+		a = vminq_f32(a, vdupq_n_f32(1.0f));
+
+		uint32x4_t zero_mask = vceqq_f32(a, vdupq_n_f32(0.0f));
+		return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(vdivq_f32(x, a)), zero_mask));
+	}
+};
+
+template <class Op>
+void premultiply_line_neon(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+{
+	unsigned vec_left = ceil_n(left, 4);
+	unsigned vec_right = floor_n(right, 4);
+
+	if (left != vec_left) {
+		float32x4_t x = Op::func(vld1q_f32(src + vec_left - 4), vld1q_f32(alpha + vec_left - 4));
+		neon_store_idxhi_f32(dst + vec_left - 4, x, left % 4);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 4) {
+		float32x4_t x = Op::func(vld1q_f32(src + j), vld1q_f32(alpha + j));
+		vst1q_f32(dst + j, x);
+	}
+
+	if (right != vec_right) {
+		float32x4_t x = Op::func(vld1q_f32(src + vec_right), vld1q_f32(alpha + vec_right));
+		neon_store_idxlo_f32(dst + vec_right, x, right % 4);
+	}
+}
+
+} // namespace
+
+
+void premultiply_neon(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+{
+	premultiply_line_neon<Premultiply>(src, alpha, dst, left, right);
+}
+
+void unpremultiply_neon(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+{
+	premultiply_line_neon<Unpremultiply>(src, alpha, dst, left, right);
+}
+
+} // namespace zimg::graph
+
+#endif // ZIMG_ARM
@@ -0,0 +1,809 @@
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <numeric>
+#include "common/align.h"
+#include "common/checked_int.h"
+#include "common/except.h"
+#include "common/zassert.h"
+#include "graphengine/filter.h"
+#include "band_executor.h"
+
+namespace zimg::graph {
+
+namespace {
+
+unsigned subsample_log2(unsigned full, unsigned sub)
+{
+	unsigned ss = 0;
+
+	while (ss < 31 && (static_cast<unsigned long long>(sub) << ss) < full) {
+		++ss;
+	}
+	return ss;
+}
+
+// Smallest ring buffer holding |count| rows of an image with |height| rows.
+unsigned select_ring_mask(unsigned count, unsigned height)
+{
+	if (count >= height)
+		return graphengine::BUFFER_MAX;
+
+	unsigned long long size = 1;
+	while (size < count) {
+		size <<= 1;
+	}
+	return size >= height ? graphengine::BUFFER_MAX : static_cast<unsigned>(size - 1);
+}
+
+checked_size_t plane_stride(const graphengine::PlaneDescriptor &desc)
+{
+	return ceil_n(checked_size_t{ desc.width } * desc.bytes_per_sample, ALIGNMENT);
+}
+
+} // namespace
+
+
+struct BandExecutor::band_plan {
+	// Rows of the output image in the band.
+	unsigned top;
+	unsigned bottom;
+
+	// Rows of each node required by the band.
+	std::vector<std::pair<unsigned, unsigned>> range;
+
+	// Ring buffer mask of each node.
+	std::vector<unsigned> mask;
+
+	// Output plane written directly by each node plane, or -1.
+	std::vector<std::array<int, graphengine::NODE_MAX_PLANES>> output;
+
+	// Offset of each node in the band buffer area.
+	std::vector<size_t> offset;
+
+	// Whether each output plane is copied from another buffer.
+	std::array<bool, graphengine::NODE_MAX_PLANES> sink_copy;
+
+	size_t buffer_size;
+};
+
+
+class BandExecutor::band_state {
+	const BandExecutor &m_exec;
+	const band_plan &m_plan;
+	std::vector<unsigned> m_cursor;
+	std::vector<unsigned> m_edge_low;
+	std::vector<unsigned> m_span;
+	std::vector<std::array<graphengine::BufferDescriptor, graphengine::NODE_MAX_PLANES>> m_buffers;
+	const graphengine::BufferDescriptor *m_dst;
+	unsigned char *m_context;
+	void *m_scratchpad;
+	unsigned m_source_cursor;
+	callback_type m_unpack_cb;
+	void *m_unpack_user;
+	callback_type m_pack_cb;
+	void *m_pack_user;
+	bool m_simulate;
+
+	void init_cursors()
+	{
+		const std::vector<node> &nodes = m_exec.m_nodes;
+
+		m_cursor.resize(nodes.size());
+		m_edge_low.resize(m_exec.m_num_edges);
+		m_span.resize(nodes.size());
+
+		for (size_t n = 0; n < nodes.size(); ++n) {
+			const node &nd = nodes[n];
+			const auto &range = m_plan.range[n];
+
+			m_cursor[n] = range.first;
+
+			for (unsigned d = 0; d < nd.num_deps; ++d) {
+				m_edge_low[nd.edge_base + d] = range.first < range.second ? m_plan.range[nd.deps[d].first].first : UINT_MAX;
+			}
+		}
+
+		m_source_cursor = UINT_MAX;
+		for (unsigned p = 0; p < m_exec.m_num_sources; ++p) {
+			const node &nd = nodes[m_exec.m_sources[p]];
+			const auto &range = m_plan.range[m_exec.m_sources[p]];
+
+			if (range.first < range.second)
+				m_source_cursor = std::min(m_source_cursor, range.first << nd.subsample_h);
+		}
+		m_source_cursor -= m_source_cursor % m_exec.m_source_group;
+	}
+
+	void update_span(unsigned n)
+	{
+		unsigned low = UINT_MAX;
+
+		for (unsigned e : m_exec.m_nodes[n].consumers) {
+			low = std::min(low, m_edge_low[e]);
+		}
+		if (low < m_cursor[n])
+			m_span[n] = std::max(m_span[n], m_cursor[n] - low);
+	}
+
+	void unpack(unsigned n, unsigned end)
+	{
+		if (!m_unpack_cb)
+			return;
+
+		const node &nd = m_exec.m_nodes[n];
+		unsigned luma_end = static_cast<unsigned>(std::min(static_cast<unsigned long long>(end) << nd.subsample_h,
+		                                                   static_cast<unsigned long long>(m_exec.m_source_height)));
+
+		while (m_source_cursor < luma_end) {
+			if (m_unpack_cb(m_unpack_user, m_source_cursor, 0, m_exec.m_source_width))
+				error::throw_<error::UserCallbackFailed>("user callback failed");
+
+			m_source_cursor = std::min(m_source_cursor + m_exec.m_source_group, m_exec.m_source_height);
+		}
+	}
+
+	void ensure(unsigned n, unsigned end)
+	{
+		const node &nd = m_exec.m_nodes[n];
+
+		if (!nd.filter) {
+			m_cursor[n] = std::max(m_cursor[n], end);
+			if (!m_simulate)
+				unpack(n, end);
+			return;
+		}
+
+		while (m_cursor[n] < end) {
+			unsigned i = m_cursor[n];
+			auto row_deps = nd.filter->get_row_deps(i);
+
+			for (unsigned d = 0; d < nd.num_deps; ++d) {
+				m_edge_low[nd.edge_base + d] = row_deps.first;
+				ensure(nd.deps[d].first, row_deps.second);
+			}
+
+			if (m_simulate) {
+				for (unsigned d = 0; d < nd.num_deps; ++d) {
+					update_span(nd.deps[d].first);
+				}
+			} else {
+				graphengine::BufferDescriptor in[graphengine::NODE_MAX_PLANES];
+
+				for (unsigned d = 0; d < nd.num_deps; ++d) {
+					in[d] = m_buffers[nd.deps[d].first][nd.deps[d].second];
+				}
+				nd.filter->process(in, m_buffers[n].data(), i, 0, nd.desc.width, m_context + nd.context_offset, m_scratchpad);
+			}
+
+			m_cursor[n] = nd.desc.height - i > nd.step ? i + nd.step : nd.desc.height;
+		}
+	}
+
+	void copy_rows(unsigned p, unsigned top, unsigned bottom)
+	{
+		const dep_desc &dep = m_exec.m_sinks[p];
+		const graphengine::BufferDescriptor &src = m_buffers[dep.first][dep.second];
+		size_t rowsize = static_cast<size_t>(m_exec.m_nodes[dep.first].desc.width) * m_exec.m_nodes[dep.first].desc.bytes_per_sample;
+
+		for (unsigned i = top; i < bottom; ++i) {
+			std::memcpy(m_dst[p].get_line<unsigned char>(i), src.get_line<unsigned char>(i), rowsize);
+		}
+	}
+public:
+	// Dry run to determine buffering requirements.
+	band_state(const BandExecutor &exec, const band_plan &plan) :
+		m_exec(exec),
+		m_plan(plan),
+		m_dst{},
+		m_context{},
+		m_scratchpad{},
+		m_source_cursor{},
+		m_unpack_cb{},
+		m_unpack_user{},
+		m_pack_cb{},
+		m_pack_user{},
+		m_simulate{ true }
+	{
+		init_cursors();
+	}
+
+	band_state(const BandExecutor &exec, const band_plan &plan, const graphengine::BufferDescriptor src[], const graphengine::BufferDescriptor dst[], unsigned char *tmp,
+	           callback_type unpack_cb, void *unpack_user, callback_type pack_cb, void *pack_user) :
+		m_exec(exec),
+		m_plan(plan),
+		m_dst{ dst },
+		m_context{ tmp + exec.m_scratchpad_size },
+		m_scratchpad{ tmp },
+		m_source_cursor{},
+		m_unpack_cb{ unpack_cb },
+		m_unpack_user{ unpack_user },
+		m_pack_cb{ pack_cb },
+		m_pack_user{ pack_user },
+		m_simulate{}
+	{
+		const std::vector<node> &nodes = m_exec.m_nodes;
+		unsigned char *buffer_base = m_context + exec.m_context_size;
+
+		init_cursors();
+		m_buffers.resize(nodes.size());
+
+		for (unsigned p = 0; p < exec.m_num_sources; ++p) {
+			m_buffers[exec.m_sources[p]][0] = src[p];
+		}
+
+		for (size_t n = 0; n < nodes.size(); ++n) {
+			const node &nd = nodes[n];
+			unsigned char *ptr = buffer_base + plan.offset[n];
+			unsigned mask = plan.mask[n];
+			size_t stride = plane_stride(nd.desc).get();
+			size_t rows = mask == graphengine::BUFFER_MAX ? nd.desc.height : static_cast<size_t>(mask) + 1;
+
+			if (!nd.filter || plan.range[n].first >= plan.range[n].second)
+				continue;
+
+			for (unsigned q = 0; q < nd.num_planes; ++q) {
+				if (plan.output[n][q] >= 0) {
+					m_buffers[n][q] = dst[plan.output[n][q]];
+				} else {
+					m_buffers[n][q] = { ptr, static_cast<ptrdiff_t>(stride), mask };
+					ptr += rows * stride;
+				}
+			}
+		}
+	}
+
+	const std::vector<unsigned> &span() const { return m_span; }
+
+	unsigned cursor(unsigned n) const { return m_cursor[n]; }
+
+	// Lowest row of a source plane still required by its consumers.
+	unsigned source_low(unsigned p) const
+	{
+		unsigned low = UINT_MAX;
+
+		for (unsigned e : m_exec.m_nodes[m_exec.m_sources[p]].consumers) {
+			low = std::min(low, m_edge_low[e]);
+		}
+		return low;
+	}
+
+	const graphengine::BufferDescriptor &sink_buffer(unsigned p) const
+	{
+		const dep_desc &dep = m_exec.m_sinks[p];
+		return m_buffers[dep.first][dep.second];
+	}
+
+	void init_contexts()
+	{
+		const std::vector<node> &nodes = m_exec.m_nodes;
+
+		for (size_t n = 0; n < nodes.size(); ++n) {
+			if (nodes[n].filter && m_plan.range[n].first < m_plan.range[n].second)
+				nodes[n].filter->init_context(m_context + nodes[n].context_offset);
+		}
+	}
+
+	void run_group(unsigned i)
+	{
+		unsigned group_bottom = std::min(m_plan.bottom - i, m_exec.m_sink_group) + i;
+
+		for (unsigned p = 0; p < m_exec.m_num_sinks; ++p) {
+			const dep_desc &dep = m_exec.m_sinks[p];
+			unsigned ss = m_exec.m_sink_subsample_h[p];
+			unsigned top = i >> ss;
+			unsigned bottom = group_bottom >> ss;
+
+			m_edge_low[m_exec.m_sink_edge_base + p] = top;
+			ensure(dep.first, bottom);
+
+			if (m_simulate)
+				update_span(dep.first);
+			else if (m_plan.sink_copy[p] && m_dst)
+				copy_rows(p, top, bottom);
+		}
+
+		if (!m_simulate && m_pack_cb && m_pack_cb(m_pack_user, i, 0, m_exec.m_sink_width))
+			error::throw_<error::UserCallbackFailed>("user callback failed");
+	}
+
+	void run()
+	{
+		if (!m_simulate)
+			init_contexts();
+
+		for (unsigned i = m_plan.top; i < m_plan.bottom; i += m_exec.m_sink_group) {
+			run_group(i);
+		}
+	}
+};
+
+
+BandExecutor::BandExecutor() :
+	m_sources{},
+	m_sinks{},
+	m_sink_subsample_h{},
+	m_num_sources{},
+	m_num_sinks{},
+	m_num_edges{},
+	m_sink_edge_base{},
+	m_source_width{},
+	m_source_height{},
+	m_source_group{ 1 },
+	m_sink_width{},
+	m_sink_height{},
+	m_sink_group{ 1 },
+	m_band_alignment{ 1 },
+	m_context_size{},
+	m_scratchpad_size{},
+	m_stateful{}
+{}
+
+unsigned BandExecutor::node_index(graphengine::node_id id) const
+{
+	auto it = std::find_if(m_nodes.begin(), m_nodes.end(), [=](const node &nd) { return nd.id == id; });
+	if (it == m_nodes.end())
+		error::throw_<error::InternalError>("invalid node id");
+	return static_cast<unsigned>(it - m_nodes.begin());
+}
+
+void BandExecutor::add_source(graphengine::node_id id)
+{
+	node nd{};
+	nd.id = id;
+	nd.num_planes = 1;
+	nd.step = 1;
+	m_nodes.push_back(std::move(nd));
+}
+
+void BandExecutor::add_transform(graphengine::node_id id, const graphengine::Filter *filter, const graphengine::node_dep_desc deps[])
+{
+	const graphengine::FilterDescriptor &desc = filter->descriptor();
+
+	node nd{};
+	nd.id = id;
+	nd.filter = filter;
+	nd.desc = desc.format;
+	nd.num_deps = desc.num_deps;
+	nd.num_planes = desc.num_planes;
+	nd.step = desc.step;
+
+	for (unsigned d = 0; d < desc.num_deps; ++d) {
+		nd.deps[d] = { node_index(deps[d].id), deps[d].plane };
+	}
+	m_nodes.push_back(std::move(nd));
+}
+
+void BandExecutor::set_endpoints(unsigned num_sources, const graphengine::node_id source_ids[], const graphengine::PlaneDescriptor source_desc[],
+                                 unsigned num_sinks, const graphengine::node_dep_desc sink_deps[])
+{
+	zassert_d(num_sources && num_sources <= graphengine::NODE_MAX_PLANES, "invalid source count");
+	zassert_d(num_sinks && num_sinks <= graphengine::NODE_MAX_PLANES, "invalid sink count");
+
+	m_num_sources = num_sources;
+	m_source_width = source_desc[0].width;
+	m_source_height = source_desc[0].height;
+	m_source_group = 1;
+
+	for (unsigned p = 0; p < num_sources; ++p) {
+		unsigned n = node_index(source_ids[p]);
+		node &nd = m_nodes[n];
+
+		nd.desc = source_desc[p];
+		nd.subsample_h = subsample_log2(m_source_height, nd.desc.height);
+		m_sources[p] = n;
+		m_source_group = std::max(m_source_group, 1U << nd.subsample_h);
+	}
+
+	m_num_sinks = num_sinks;
+	for (unsigned p = 0; p < num_sinks; ++p) {
+		m_sinks[p] = { node_index(sink_deps[p].id), sink_deps[p].plane };
+	}
+
+	m_sink_width = m_nodes[m_sinks[0].first].desc.width;
+	m_sink_height = m_nodes[m_sinks[0].first].desc.height;
+	m_sink_group = 1;
+
+	for (unsigned p = 0; p < num_sinks; ++p) {
+		m_sink_subsample_h[p] = subsample_log2(m_sink_height, m_nodes[m_sinks[p].first].desc.height);
+		m_sink_group = std::max(m_sink_group, 1U << m_sink_subsample_h[p]);
+	}
+
+	// Band boundaries must not split the rows produced by a single call to a
+	// filter writing directly to the output.
+	m_band_alignment = m_sink_group;
+	for (unsigned p = 0; p < num_sinks; ++p) {
+		const node &nd = m_nodes[m_sinks[p].first];
+		if (nd.filter)
+			m_band_alignment = std::lcm(m_band_alignment, nd.step << m_sink_subsample_h[p]);
+	}
+
+	checked_size_t context_size = 0;
+	checked_size_t scratchpad_size = 0;
+
+	m_num_edges = 0;
+	m_stateful = false;
+
+	for (node &nd : m_nodes) {
+		nd.consumers.clear();
+	}
+
+	for (node &nd : m_nodes) {
+		nd.edge_base = m_num_edges;
+
+		for (unsigned d = 0; d < nd.num_deps; ++d) {
+			m_nodes[nd.deps[d].first].consumers.push_back(m_num_edges++);
+		}
+
+		if (nd.filter) {
+			const graphengine::FilterDescriptor &desc = nd.filter->descriptor();
+
+			nd.context_offset = context_size.get();
+			context_size += ceil_n(checked_size_t{ desc.context_size }, ALIGNMENT);
+			scratchpad_size = std::max(scratchpad_size, ceil_n(checked_size_t{ desc.scratchpad_size }, ALIGNMENT));
+			m_stateful = m_stateful || desc.flags.stateful;
+		}
+	}
+
+	m_sink_edge_base = m_num_edges;
+	for (unsigned p = 0; p < num_sinks; ++p) {
+		m_nodes[m_sinks[p].first].consumers.push_back(m_num_edges++);
+	}
+
+	m_context_size = context_size.get();
+	m_scratchpad_size = scratchpad_size.get();
+}
+
+unsigned BandExecutor::get_num_bands(unsigned num_bands) const
+{
+	if (m_stateful)
+		return 1;
+
+	unsigned max_bands = std::max(m_sink_height / m_band_alignment, 1U);
+	return std::clamp(num_bands, 1U, max_bands);
+}
+
+auto BandExecutor::plan_bands(unsigned num_bands) const -> std::vector<band_plan>
+{
+	num_bands = get_num_bands(num_bands);
+
+	auto boundary = [&](unsigned k)
+	{
+		if (k == num_bands)
+			return m_sink_height;
+
+		unsigned row = static_cast<unsigned>(static_cast<unsigned long long>(m_sink_height) * k / num_bands);
+		return row - row % m_band_alignment;
+	};
+
+	std::vector<band_plan> plans(num_bands);
+
+	for (unsigned k = 0; k < num_bands; ++k) {
+		plans[k].top = boundary(k);
+		plans[k].bottom = boundary(k + 1);
+		plan_band(plans[k], true);
+	}
+	return plans;
+}
+
+void BandExecutor::plan_band(band_plan &plan, bool direct_output) const
+{
+	size_t num_nodes = m_nodes.size();
+
+	auto extend = [&](unsigned n, unsigned first, unsigned last)
+	{
+		plan.range[n].first = std::min(plan.range[n].first, first);
+		plan.range[n].second = std::max(plan.range[n].second, last);
+	};
+
+	// Propagate the required rows from the output to the input. Nodes are
+	// stored in topological order.
+	plan.range.assign(num_nodes, { UINT_MAX, 0 });
+
+	for (unsigned p = 0; p < m_num_sinks; ++p) {
+		unsigned ss = m_sink_subsample_h[p];
+		extend(m_sinks[p].first, plan.top >> ss, plan.bottom >> ss);
+	}
+
+	for (size_t n = num_nodes; n-- > 0;) {
+		const node &nd = m_nodes[n];
+		auto &range = plan.range[n];
+
+		if (!nd.filter || range.first >= range.second)
+			continue;
+
+		range.first -= range.first % nd.step;
+
+		unsigned dep_first = UINT_MAX;
+		unsigned dep_last = 0;
+
+		for (unsigned i = range.first; i < range.second; i += nd.step) {
+			auto row_deps = nd.filter->get_row_deps(i);
+			dep_first = std::min(dep_first, row_deps.first);
+			dep_last = std::max(dep_last, row_deps.second);
+		}
+
+		for (unsigned d = 0; d < nd.num_deps; ++d) {
+			extend(nd.deps[d].first, dep_first, dep_last);
+		}
+	}
+
+	// Write directly to the output if all rows computed lie within the band.
+	// Streams keep the final rows in internal buffers until they are read.
+	plan.output.assign(num_nodes, {});
+	for (auto &output : plan.output) {
+		output.fill(-1);
+	}
+
+	for (unsigned p = 0; p < m_num_sinks; ++p) {
+		unsigned n = m_sinks[p].first;
+		unsigned q = m_sinks[p].second;
+		unsigned ss = m_sink_subsample_h[p];
+		const auto &range = plan.range[n];
+
+		bool direct = direct_output && m_nodes[n].filter && plan.output[n][q] < 0 && range.first >= (plan.top >> ss) && range.second <= (plan.bottom >> ss);
+		if (direct)
+			plan.output[n][q] = static_cast<int>(p);
+
+		plan.sink_copy[p] = !direct;
+	}
+
+	// Size the intermediate buffers.
+	band_state simulation{ *this, plan };
+	simulation.run();
+
+	checked_size_t offset = 0;
+
+	plan.mask.assign(num_nodes, graphengine::BUFFER_MAX);
+	plan.offset.assign(num_nodes, 0);
+
+	for (size_t n = 0; n < num_nodes; ++n) {
+		const node &nd = m_nodes[n];
+
+		if (!nd.filter || plan.range[n].first >= plan.range[n].second)
+			continue;
+
+		unsigned num_internal = static_cast<unsigned>(std::count(plan.output[n].begin(), plan.output[n].begin() + nd.num_planes, -1));
+		if (!num_internal)
+			continue;
+
+		unsigned mask = select_ring_mask(std::max(simulation.span()[n], nd.step), nd.desc.height);
+		size_t rows = mask == graphengine::BUFFER_MAX ? nd.desc.height : static_cast<size_t>(mask) + 1;
+
+		plan.mask[n] = mask;
+		plan.offset[n] = offset.get();
+		offset += plane_stride(nd.desc) * rows * num_internal;
+	}
+
+	plan.buffer_size = offset.get();
+}
+
+size_t BandExecutor::get_tmp_size(unsigned num_bands) const
+{
+	std::vector<band_plan> plans = plan_bands(num_bands);
+	checked_size_t band_size = 0;
+
+	for (const band_plan &plan : plans) {
+		band_size = std::max(band_size, checked_size_t{ m_scratchpad_size } + m_context_size + plan.buffer_size);
+	}
+	return (band_size * plans.size() + (ALIGNMENT - 1)).get();
+}
+
+void BandExecutor::process(const graphengine::BufferDescriptor src[], const graphengine::BufferDescriptor dst[], void *tmp, unsigned num_bands,
+                           callback_type unpack_cb, void *unpack_user, callback_type pack_cb, void *pack_user,
+                           thread_pool_type pool_cb, void *pool_user) const
+{
+	for (unsigned p = 0; p < m_num_sources; ++p) {
+		if (src[p].mask != graphengine::BUFFER_MAX)
+			error::throw_<error::IllegalArgument>("band processing requires buffers containing the entire image");
+	}
+	for (unsigned p = 0; p < m_num_sinks; ++p) {
+		if (dst[p].mask != graphengine::BUFFER_MAX)
+			error::throw_<error::IllegalArgument>("band processing requires buffers containing the entire image");
+	}
+
+	struct task_data {
+		const BandExecutor *self;
+		const std::vector<band_plan> *plans;
+		const graphengine::BufferDescriptor *src;
+		const graphengine::BufferDescriptor *dst;
+		unsigned char *tmp;
+		size_t band_size;
+		callback_type unpack_cb;
+		void *unpack_user;
+		callback_type pack_cb;
+		void *pack_user;
+		std::vector<std::exception_ptr> errors;
+	};
+
+	std::vector<band_plan> plans = plan_bands(num_bands);
+	size_t band_size = 0;
+
+	for (const band_plan &plan : plans) {
+		band_size = std::max(band_size, m_scratchpad_size + m_context_size + plan.buffer_size);
+	}
+
+	unsigned char *tmp_aligned = reinterpret_cast<unsigned char *>(ceil_n(reinterpret_cast<uintptr_t>(tmp), ALIGNMENT));
+	task_data data{ this, &plans, src, dst, tmp_aligned, band_size, unpack_cb, unpack_user, pack_cb, pack_user, std::vector<std::exception_ptr>(plans.size()) };
+
+	task_func task = [](void *task_user, unsigned index)
+	{
+		task_data *data = static_cast<task_data *>(task_user);
+		zassert_d(index < data->plans->size(), "band index out of range");
+
+		try {
+			band_state state{ *data->self, (*data->plans)[index], data->src, data->dst, data->tmp + data->band_size * index,
+			                  data->unpack_cb, data->unpack_user, data->pack_cb, data->pack_user };
+			state.run();
+		} catch (...) {
+			data->errors[index] = std::current_exception();
+		}
+	};
+
+	if (pool_cb) {
+		if (pool_cb(pool_user, task, &data, static_cast<unsigned>(plans.size())))
+			error::throw_<error::UserCallbackFailed>("thread pool callback failed");
+	} else {
+		for (unsigned k = 0; k < plans.size(); ++k) {
+			task(&data, k);
+		}
+	}
+
+	for (const std::exception_ptr &e : data.errors) {
+		if (e)
+			std::rethrow_exception(e);
+	}
+}
+
+
+
+BandStream::BandStream(std::shared_ptr<const BandExecutor> exec) :
+	m_exec{ std::move(exec) },
+	m_plan{ std::make_unique<BandExecutor::band_plan>() },
+	m_source_buffers{},
+	m_source_row{},
+	m_sink_row{}
+{
+	const BandExecutor &e = *m_exec;
+
+	m_plan->top = 0;
+	m_plan->bottom = e.m_sink_height;
+	e.plan_band(*m_plan, false);
+
+	// Record the input rows needed before each output row group can be
+	// produced, and the rows of each input plane live at that point.
+	std::array<unsigned, graphengine::NODE_MAX_PLANES> source_span{};
+	BandExecutor::band_state simulation{ e, *m_plan };
+
+	for (unsigned i = 0; i < e.m_sink_height; i += e.m_sink_group) {
+		std::array<unsigned, graphengine::NODE_MAX_PLANES> low{};
+
+		for (unsigned p = 0; p < e.m_num_sources; ++p) {
+			low[p] = simulation.source_low(p);
+		}
+
+		simulation.run_group(i);
+
+		unsigned required = 0;
+		for (unsigned p = 0; p < e.m_num_sources; ++p) {
+			const BandExecutor::node &nd = e.m_nodes[e.m_sources[p]];
+			unsigned long long luma_rows = static_cast<unsigned long long>(simulation.cursor(e.m_sources[p])) << nd.subsample_h;
+			required = std::max(required, static_cast<unsigned>(std::min(luma_rows, static_cast<unsigned long long>(e.m_source_height))));
+		}
+		required = std::min(ceil_n(required, e.m_source_group), e.m_source_height);
+		m_source_required.push_back(required);
+
+		for (unsigned p = 0; p < e.m_num_sources; ++p) {
+			const BandExecutor::node &nd = e.m_nodes[e.m_sources[p]];
+			unsigned rows = std::min((required + (1U << nd.subsample_h) - 1) >> nd.subsample_h, nd.desc.height);
+
+			if (rows > low[p])
+				source_span[p] = std::max(source_span[p], rows - low[p]);
+		}
+	}
+
+	checked_size_t size = checked_size_t{ e.m_scratchpad_size } + e.m_context_size + m_plan->buffer_size;
+	std::array<size_t, graphengine::NODE_MAX_PLANES> source_offset{};
+
+	for (unsigned p = 0; p < e.m_num_sources; ++p) {
+		const BandExecutor::node &nd = e.m_nodes[e.m_sources[p]];
+		unsigned mask = select_ring_mask(std::max(source_span[p], e.m_source_group >> nd.subsample_h), nd.desc.height);
+		size_t rows = mask == graphengine::BUFFER_MAX ? nd.desc.height : static_cast<size_t>(mask) + 1;
+
+		source_offset[p] = size.get();
+		m_source_buffers[p] = { nullptr, static_cast<ptrdiff_t>(plane_stride(nd.desc).get()), mask };
+		size += plane_stride(nd.desc) * rows;
+	}
+
+	m_tmp.resize(size.get());
+
+	for (unsigned p = 0; p < e.m_num_sources; ++p) {
+		m_source_buffers[p].ptr = m_tmp.data() + source_offset[p];
+	}
+
+	m_state = std::make_unique<BandExecutor::band_state>(e, *m_plan, m_source_buffers.data(), nullptr, m_tmp.data(), nullptr, nullptr, nullptr, nullptr);
+	m_state->init_contexts();
+}
+
+BandStream::~BandStream() = default;
+
+bool BandStream::source_available(unsigned bottom) const
+{
+	const BandExecutor &e = *m_exec;
+
+	for (unsigned p = 0; p < e.m_num_sources; ++p) {
+		const BandExecutor::node &nd = e.m_nodes[e.m_sources[p]];
+		unsigned mask = m_source_buffers[p].mask;
+		unsigned long long rows = mask == graphengine::BUFFER_MAX ? nd.desc.height : static_cast<unsigned long long>(mask) + 1;
+		unsigned last = ((bottom + (1U << nd.subsample_h) - 1) >> nd.subsample_h) - 1;
+
+		// Writing a row replaces the row one buffer length above it.
+		if (last >= m_state->source_low(p) + rows)
+			return false;
+	}
+	return true;
+}
+
+unsigned BandStream::push(const graphengine::BufferDescriptor src[], unsigned num_rows)
+{
+	const BandExecutor &e = *m_exec;
+	unsigned first = m_source_row;
+
+	while (m_source_row < e.m_source_height) {
+		unsigned bottom = std::min(e.m_source_height - m_source_row, e.m_source_group) + m_source_row;
+
+		if (bottom - first > num_rows || !source_available(bottom))
+			break;
+
+		for (unsigned p = 0; p < e.m_num_sources; ++p) {
+			const BandExecutor::node &nd = e.m_nodes[e.m_sources[p]];
+			unsigned ss = nd.subsample_h;
+			unsigned base = first >> ss;
+			unsigned plane_bottom = std::min((bottom + (1U << ss) - 1) >> ss, nd.desc.height);
+			size_t rowsize = static_cast<size_t>(nd.desc.width) * nd.desc.bytes_per_sample;
+
+			for (unsigned i = m_source_row >> ss; i < plane_bottom; ++i) {
+				std::memcpy(m_source_buffers[p].get_line<unsigned char>(i), src[p].get_line<unsigned char>(i - base), rowsize);
+			}
+		}
+
+		m_source_row = bottom;
+	}
+
+	return m_source_row - first;
+}
+
+unsigned BandStream::pull(const graphengine::BufferDescriptor dst[], unsigned num_rows)
+{
+	const BandExecutor &e = *m_exec;
+	unsigned first = m_sink_row;
+
+	while (m_sink_row < e.m_sink_height) {
+		unsigned bottom = std::min(e.m_sink_height - m_sink_row, e.m_sink_group) + m_sink_row;
+
+		if (bottom - first > num_rows || m_source_row < m_source_required[m_sink_row / e.m_sink_group])
+			break;
+
+		m_state->run_group(m_sink_row);
+
+		for (unsigned p = 0; p < e.m_num_sinks; ++p) {
+			const BandExecutor::node &nd = e.m_nodes[e.m_sinks[p].first];
+			const graphengine::BufferDescriptor &buf = m_state->sink_buffer(p);
+			unsigned ss = e.m_sink_subsample_h[p];
+			unsigned base = first >> ss;
+			size_t rowsize = static_cast<size_t>(nd.desc.width) * nd.desc.bytes_per_sample;
+
+			for (unsigned i = m_sink_row >> ss; i < bottom >> ss; ++i) {
+				std::memcpy(dst[p].get_line<unsigned char>(i - base), buf.get_line<unsigned char>(i), rowsize);
+			}
+		}
+
+		m_sink_row = bottom;
+	}
+
+	return m_sink_row - first;
+}
+
+} // namespace zimg::graph
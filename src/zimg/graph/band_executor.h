@@ -0,0 +1,177 @@
+#pragma once
+
+#ifndef ZIMG_GRAPH_BAND_EXECUTOR_H_
+#define ZIMG_GRAPH_BAND_EXECUTOR_H_
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "common/alloc.h"
+#include "graphengine/types.h"
+
+namespace graphengine {
+class Filter;
+}
+
+namespace zimg::graph {
+
+class BandStream;
+
+/**
+ * Executes a filter graph as independent horizontal bands of the output image.
+ *
+ * The executor mirrors the topology of a graphengine subgraph. Each band
+ * computes the rows of every node required by its output rows, as given by
+ * the row dependencies of the filters, so that bands can be processed
+ * concurrently. Rows shared by adjacent bands are computed by both bands.
+ */
+class BandExecutor {
+public:
+	typedef int (*callback_type)(void *user, unsigned i, unsigned left, unsigned right);
+	typedef void (*task_func)(void *task_user, unsigned index);
+	typedef int (*thread_pool_type)(void *user, task_func task, void *task_user, unsigned num_tasks);
+private:
+	// Node index and plane.
+	typedef std::pair<unsigned, unsigned> dep_desc;
+
+	struct node {
+		graphengine::node_id id;
+		const graphengine::Filter *filter; // Null for source nodes.
+		graphengine::PlaneDescriptor desc;
+		unsigned num_deps;
+		unsigned num_planes;
+		unsigned step;
+		unsigned subsample_h; // Source nodes only.
+		std::array<dep_desc, graphengine::NODE_MAX_PLANES> deps;
+		unsigned edge_base; // Edge index of first dependency.
+		std::vector<unsigned> consumers; // Edge indices.
+		size_t context_offset;
+	};
+
+	struct band_plan;
+	class band_state;
+
+	std::vector<node> m_nodes;
+	std::array<unsigned, graphengine::NODE_MAX_PLANES> m_sources;
+	std::array<dep_desc, graphengine::NODE_MAX_PLANES> m_sinks;
+	std::array<unsigned, graphengine::NODE_MAX_PLANES> m_sink_subsample_h;
+	unsigned m_num_sources;
+	unsigned m_num_sinks;
+	unsigned m_num_edges;
+	unsigned m_sink_edge_base;
+
+	unsigned m_source_width;
+	unsigned m_source_height;
+	unsigned m_source_group;
+	unsigned m_sink_width;
+	unsigned m_sink_height;
+	unsigned m_sink_group;
+	unsigned m_band_alignment;
+
+	size_t m_context_size;
+	size_t m_scratchpad_size;
+	bool m_stateful;
+
+	unsigned node_index(graphengine::node_id id) const;
+
+	std::vector<band_plan> plan_bands(unsigned num_bands) const;
+
+	void plan_band(band_plan &plan, bool direct_output) const;
+
+	friend class BandStream;
+public:
+	BandExecutor();
+
+	void add_source(graphengine::node_id id);
+
+	void add_transform(graphengine::node_id id, const graphengine::Filter *filter, const graphengine::node_dep_desc deps[]);
+
+	/**
+	 * Select the endpoints of the graph and finalize the topology.
+	 *
+	 * @param num_sources number of input planes
+	 * @param source_ids node ids of input planes
+	 * @param source_desc dimensions of input planes
+	 * @param num_sinks number of output planes
+	 * @param sink_deps nodes connected to output planes
+	 */
+	void set_endpoints(unsigned num_sources, const graphengine::node_id source_ids[], const graphengine::PlaneDescriptor source_desc[],
+	                   unsigned num_sinks, const graphengine::node_dep_desc sink_deps[]);
+
+	/**
+	 * Get the number of bands used when requesting a given number of bands.
+	 *
+	 * Graphs containing stateful filters, e.g. error diffusion, are always
+	 * executed as a single band.
+	 */
+	unsigned get_num_bands(unsigned num_bands) const;
+
+	size_t get_tmp_size(unsigned num_bands) const;
+
+	/**
+	 * Process an image as a series of bands.
+	 *
+	 * Input and output buffers must contain the entire image. If a thread pool
+	 * is not provided, the bands are executed sequentially.
+	 */
+	void process(const graphengine::BufferDescriptor src[], const graphengine::BufferDescriptor dst[], void *tmp, unsigned num_bands,
+	             callback_type unpack_cb, void *unpack_user, callback_type pack_cb, void *pack_user,
+	             thread_pool_type pool_cb, void *pool_user) const;
+};
+
+/**
+ * Executes a filter graph incrementally as input rows become available.
+ *
+ * The image is processed as a single band whose row cursors and intermediate
+ * buffers persist between calls. Input rows are copied into ring buffers large
+ * enough to hold the rows required by the next output row group, and output
+ * rows are copied out of the buffers of the final filters.
+ */
+class BandStream {
+	std::shared_ptr<const BandExecutor> m_exec;
+	std::unique_ptr<BandExecutor::band_plan> m_plan;
+	std::unique_ptr<BandExecutor::band_state> m_state;
+	AlignedVector<unsigned char> m_tmp;
+	std::array<graphengine::BufferDescriptor, graphengine::NODE_MAX_PLANES> m_source_buffers;
+	std::vector<unsigned> m_source_required; // Input rows required by each output row group.
+	unsigned m_source_row;
+	unsigned m_sink_row;
+
+	bool source_available(unsigned bottom) const;
+public:
+	explicit BandStream(std::shared_ptr<const BandExecutor> exec);
+
+	~BandStream();
+
+	/**
+	 * Copy the next rows of the input image.
+	 *
+	 * Line 0 of each buffer holds the first row not yet consumed. Rows are
+	 * accepted in units of the vertical subsampling while there is space in
+	 * the internal buffers.
+	 *
+	 * @return number of rows accepted
+	 */
+	unsigned push(const graphengine::BufferDescriptor src[], unsigned num_rows);
+
+	/**
+	 * Produce the next rows of the output image.
+	 *
+	 * Line 0 of each buffer receives the first row not yet returned. Rows are
+	 * produced in units of the vertical subsampling while the required input
+	 * rows are available.
+	 *
+	 * @return number of rows produced
+	 */
+	unsigned pull(const graphengine::BufferDescriptor dst[], unsigned num_rows);
+
+	unsigned input_row() const { return m_source_row; }
+
+	unsigned output_row() const { return m_sink_row; }
+};
+
+} // namespace zimg::graph
+
+#endif // ZIMG_GRAPH_BAND_EXECUTOR_H_
@@ -1,12 +1,13 @@
 #include <algorithm>
 #include <climits>
 #include <cstdint>
-#include <tuple>
+#include <vector>
 #include "common/align.h"
 #include "common/except.h"
 #include "common/zassert.h"
 #include "graphengine/graph.h"
 #include "graphengine/types.h"
+#include "band_executor.h"
 #include "filtergraph.h"
 #include "graphengine_except.h"
 
@@ -16,14 +17,27 @@ FilterGraph::FilterGraph(std::unique_ptr<graphengine::Graph> graph, std::shared_
 	m_graph{ std::move(graph) },
 	m_instance_data{ std::move(instance_data) },
 	m_source_id{ source_id },
-	m_sink_id{ sink_id },
-	m_requires_64b{},
-	m_source_greyalpha{},
-	m_sink_greyalpha{}
+	m_source_planes{ 0, 1, 2, 3 },
+	m_outputs{ { sink_id, { 0, 1, 2, 3 } } },
+	m_build_request{},
+	m_build_tables{},
+	m_requires_64b{}
 {}
 
 FilterGraph::~FilterGraph() = default;
 
+void FilterGraph::check_single_output() const
+{
+	if (m_outputs.size() > 1)
+		error::throw_<error::UnsupportedOperation>("graph has multiple outputs");
+}
+
+void FilterGraph::check_band_executor() const
+{
+	if (!m_band_executor)
+		error::throw_<error::UnsupportedOperation>("graph does not support band processing");
+}
+
 const FilterGraph *FilterGraph::check_alignment(const std::array<graphengine::BufferDescriptor, 4> &src, const std::array<graphengine::BufferDescriptor, 4> &dst) const
 {
 #define POINTER_ALIGNMENT_ASSERT(x) zassert_d(!(x) || reinterpret_cast<uintptr_t>(x) % alignment == 0, "pointer not aligned")
@@ -71,10 +85,14 @@ unsigned FilterGraph::get_input_buffering() const try
 	rethrow_graphengine_exception(e);
 }
 
-unsigned FilterGraph::get_output_buffering() const try
+unsigned FilterGraph::get_output_buffering(unsigned index) const try
 {
+	if (index >= m_outputs.size())
+		error::throw_<error::IllegalArgument>("output index out of range");
+
+	graphengine::node_id sink_id = m_outputs[index].sink_id;
 	graphengine::Graph::BufferingRequirement buffering = m_graph->get_buffering_requirement();
-	auto it = std::find_if(buffering.begin(), buffering.end(), [=](const auto &entry) { return entry.id == m_sink_id; });
+	auto it = std::find_if(buffering.begin(), buffering.end(), [=](const auto &entry) { return entry.id == sink_id; });
 	zassert(it != buffering.end(), "invalid node id");
 	return std::min(it->mask, UINT_MAX - 1) + 1;
 } catch (const graphengine::Exception &e) {
@@ -95,38 +113,122 @@ void FilterGraph::set_tile_width(unsigned tile_width)
 
 void FilterGraph::process(const std::array<graphengine::BufferDescriptor, 4> &src, const std::array<graphengine::BufferDescriptor, 4> &dst, void *tmp, callback_type unpack_cb, void *unpack_user, callback_type pack_cb, void *pack_user) const
 {
+	check_single_output();
+
+	graphengine::BufferDescriptor src_reorder[4];
+	graphengine::BufferDescriptor dst_reorder[4];
+
+	for (unsigned p = 0; p < 4; ++p) {
+		src_reorder[p] = src[m_source_planes[p]];
+		dst_reorder[p] = dst[m_outputs.front().sink_planes[p]];
+	}
+
 	graphengine::Graph::Endpoint endpoints[] = {
-		{ m_source_id, src.data(), { unpack_cb, unpack_user } },
-		{ m_sink_id, dst.data(), { pack_cb, pack_user } },
+		{ m_source_id, src_reorder, { unpack_cb, unpack_user } },
+		{ m_outputs.front().sink_id, dst_reorder, { pack_cb, pack_user } },
 	};
 
-	graphengine::BufferDescriptor src_reorder[2];
-	if (m_source_greyalpha) {
-		src_reorder[0] = src[0];
-		src_reorder[1] = src[3];
-		endpoints[0].buffer = src_reorder;
+	try {
+		m_graph->run(endpoints, tmp);
+	} catch (const graphengine::Exception &e) {
+		rethrow_graphengine_exception(e);
+	}
+}
+
+void FilterGraph::process_multi(const std::array<graphengine::BufferDescriptor, 4> &src, const std::array<graphengine::BufferDescriptor, 4> dst[], void *tmp,
+                                callback_type unpack_cb, void *unpack_user, const callback_type pack_cb[], void * const pack_user[]) const
+{
+	graphengine::BufferDescriptor src_reorder[4];
+	std::vector<std::array<graphengine::BufferDescriptor, 4>> dst_reorder(m_outputs.size());
+	std::vector<graphengine::Graph::Endpoint> endpoints;
+
+	for (unsigned p = 0; p < 4; ++p) {
+		src_reorder[p] = src[m_source_planes[p]];
 	}
+	endpoints.push_back({ m_source_id, src_reorder, { unpack_cb, unpack_user } });
 
-	graphengine::BufferDescriptor dst_reorder[2];
-	if (m_sink_greyalpha) {
-		dst_reorder[0] = dst[0];
-		dst_reorder[1] = dst[3];
-		endpoints[1].buffer = dst_reorder;
+	for (size_t i = 0; i < m_outputs.size(); ++i) {
+		for (unsigned p = 0; p < 4; ++p) {
+			dst_reorder[i][p] = dst[i][m_outputs[i].sink_planes[p]];
+		}
+		endpoints.push_back({ m_outputs[i].sink_id, dst_reorder[i].data(), { pack_cb ? pack_cb[i] : nullptr, pack_user ? pack_user[i] : nullptr } });
 	}
 
 	try {
-		m_graph->run(endpoints, tmp);
+		m_graph->run(endpoints.data(), tmp);
 	} catch (const graphengine::Exception &e) {
 		rethrow_graphengine_exception(e);
 	}
 }
 
+size_t FilterGraph::get_tmp_size_mt(unsigned num_bands) const
+{
+	check_single_output();
+	check_band_executor();
+	return m_band_executor->get_tmp_size(num_bands);
+}
+
+void FilterGraph::process_mt(const std::array<graphengine::BufferDescriptor, 4> &src, const std::array<graphengine::BufferDescriptor, 4> &dst, void *tmp, unsigned num_bands,
+                             callback_type unpack_cb, void *unpack_user, callback_type pack_cb, void *pack_user, thread_pool_type pool_cb, void *pool_user) const
+{
+	check_single_output();
+	check_band_executor();
+
+	graphengine::BufferDescriptor src_reorder[4];
+	graphengine::BufferDescriptor dst_reorder[4];
+
+	for (unsigned p = 0; p < 4; ++p) {
+		src_reorder[p] = src[m_source_planes[p]];
+		dst_reorder[p] = dst[m_outputs.front().sink_planes[p]];
+	}
+
+	m_band_executor->process(src_reorder, dst_reorder, tmp, num_bands, unpack_cb, unpack_user, pack_cb, pack_user, pool_cb, pool_user);
+}
+
+std::unique_ptr<FilterGraphStream> FilterGraph::begin_stream() const
+{
+	check_single_output();
+	check_band_executor();
+	return std::make_unique<FilterGraphStream>(std::make_unique<BandStream>(m_band_executor), m_source_planes, m_outputs.front().sink_planes);
+}
+
+
+FilterGraphStream::FilterGraphStream(std::unique_ptr<BandStream> stream, const std::array<unsigned, 4> &source_planes, const std::array<unsigned, 4> &sink_planes) :
+	m_stream{ std::move(stream) },
+	m_source_planes(source_planes),
+	m_sink_planes(sink_planes)
+{}
+
+FilterGraphStream::~FilterGraphStream() = default;
+
+unsigned FilterGraphStream::push_rows(const std::array<graphengine::BufferDescriptor, 4> &src, unsigned num_rows)
+{
+	graphengine::BufferDescriptor src_reorder[4];
+
+	for (unsigned p = 0; p < 4; ++p) {
+		src_reorder[p] = src[m_source_planes[p]];
+	}
+	return m_stream->push(src_reorder, num_rows);
+}
+
+unsigned FilterGraphStream::pull_rows(const std::array<graphengine::BufferDescriptor, 4> &dst, unsigned num_rows)
+{
+	graphengine::BufferDescriptor dst_reorder[4];
+
+	for (unsigned p = 0; p < 4; ++p) {
+		dst_reorder[p] = dst[m_sink_planes[p]];
+	}
+	return m_stream->pull(dst_reorder, num_rows);
+}
+
+
 SubGraph::SubGraph(std::unique_ptr<graphengine::SubGraph> subgraph, std::shared_ptr<void> instance_data, plane_desc_list source_desc, node_list source_ids, node_list sink_ids) :
 	m_subgraph(std::move(subgraph)),
 	m_instance_data(std::move(instance_data)),
 	m_source_desc(source_desc),
 	m_source_ids(source_ids),
-	m_sink_ids(sink_ids),
+	m_source_planes{ 0, 1, 2, 3 },
+	m_outputs{ { sink_ids, { 0, 1, 2, 3 } } },
 	m_requires_64b{}
 {}
 
@@ -141,7 +243,7 @@ std::pair<unsigned, unsigned> SubGraph::get_endpoint_ids(int source_ids[], int s
 		if (id != graphengine::null_node)
 			source_ids[num_sources++] = id;
 	}
-	for (graphengine::node_id id : m_sink_ids) {
+	for (graphengine::node_id id : m_outputs.front().sink_ids) {
 		if (id != graphengine::null_node)
 			sink_ids[num_sinks++] = id;
 	}
@@ -152,41 +254,50 @@ std::pair<unsigned, unsigned> SubGraph::get_endpoint_ids(int source_ids[], int s
 std::unique_ptr<FilterGraph> SubGraph::build_full_graph() const try
 {
 	std::unique_ptr<graphengine::Graph> graph = std::make_unique<graphengine::GraphImpl>();
-	unsigned num_source_planes = 0;
-	unsigned num_sink_planes = 0;
 	int subgraph_source_ids[4];
 	int subgraph_sink_ids[4];
 
-	std::tie(num_source_planes, num_sink_planes) = get_endpoint_ids(subgraph_source_ids, subgraph_sink_ids);
+	unsigned num_source_planes = get_endpoint_ids(subgraph_source_ids, subgraph_sink_ids).first;
 	graphengine::node_id real_source_id = graph->add_source(num_source_planes, m_source_desc.data());
 
 	graphengine::SubGraph::Mapping source_mapping[graphengine::NODE_MAX_PLANES];
-	graphengine::SubGraph::Mapping sink_mapping[graphengine::NODE_MAX_PLANES];
+	std::vector<graphengine::SubGraph::Mapping> sink_mapping(m_outputs.size() * graphengine::NODE_MAX_PLANES);
 
 	for (unsigned i = 0; i < num_source_planes; ++i) {
 		source_mapping[i].internal_id = subgraph_source_ids[i];
 		source_mapping[i].external_dep = { real_source_id, i };
 	}
 
-	m_subgraph->connect(graph.get(), num_source_planes, source_mapping, sink_mapping);
+	m_subgraph->connect(graph.get(), num_source_planes, source_mapping, sink_mapping.data());
+
+	// Each output becomes a separate sink node. Nodes upstream of the sinks are shared.
+	std::vector<graphengine::node_id> real_sink_ids;
 
-	graphengine::node_dep_desc real_sink_deps[graphengine::NODE_MAX_PLANES];
-	for (unsigned i = 0; i < num_sink_planes; ++i) {
-		graphengine::SubGraph::Mapping *mapping = std::find_if(sink_mapping, sink_mapping + graphengine::NODE_MAX_PLANES,
-			[=](const auto &mapping) { return mapping.internal_id == subgraph_sink_ids[i]; });
+	for (const output &out : m_outputs) {
+		graphengine::node_dep_desc real_sink_deps[graphengine::NODE_MAX_PLANES];
+		unsigned num_sink_planes = 0;
 
-		real_sink_deps[i] = mapping->external_dep;
+		for (graphengine::node_id id : out.sink_ids) {
+			if (id == graphengine::null_node)
+				continue;
+
+			auto mapping = std::find_if(sink_mapping.begin(), sink_mapping.end(), [=](const auto &mapping) { return mapping.internal_id == id; });
+			real_sink_deps[num_sink_planes++] = mapping->external_dep;
+		}
+
+		real_sink_ids.push_back(graph->add_sink(num_sink_planes, real_sink_deps));
 	}
 
-	graphengine::node_id real_sink_id = graph->add_sink(num_sink_planes, real_sink_deps);
+	std::unique_ptr<FilterGraph> filtergraph = std::make_unique<FilterGraph>(std::move(graph), m_instance_data, real_source_id, real_sink_ids.front());
+	filtergraph->set_buffer_planes(m_source_planes, m_outputs.front().sink_planes);
+	for (size_t i = 1; i < m_outputs.size(); ++i) {
+		filtergraph->add_output(real_sink_ids[i], m_outputs[i].sink_planes);
+	}
 
-	std::unique_ptr<FilterGraph> filtergraph = std::make_unique<FilterGraph>(std::move(graph), m_instance_data, real_source_id, real_sink_id);
+	filtergraph->set_band_executor(m_band_executor);
+	filtergraph->set_profile(m_profile);
 	if (m_requires_64b)
 		filtergraph->set_requires_64b_alignment();
-	if (num_source_planes == 2)
-		filtergraph->set_source_greyalpha();
-	if (num_sink_planes == 2)
-		filtergraph->set_sink_greyalpha();
 
 	return filtergraph;
 } catch (const graphengine::Exception &e) {
@@ -6,6 +6,8 @@
 #include <array>
 #include <memory>
 #include <utility>
+#include <vector>
+#include "common/table_record.h"
 #include "graphengine/types.h"
 
 // Base class in global namespace for API export.
@@ -21,6 +23,12 @@ struct zimg_subgraph {
 
 zimg_subgraph::~zimg_subgraph() = default;
 
+struct zimg_filter_graph_stream {
+	virtual inline ~zimg_filter_graph_stream() = 0;
+};
+
+zimg_filter_graph_stream::~zimg_filter_graph_stream() = default;
+
 
 namespace graphengine {
 class Graph;
@@ -29,16 +37,48 @@ class SubGraph;
 
 namespace zimg::graph {
 
+class BandExecutor;
+class BandStream;
+class GraphProfile;
+
+class FilterGraphStream : public zimg_filter_graph_stream {
+	std::unique_ptr<BandStream> m_stream;
+	std::array<unsigned, 4> m_source_planes;
+	std::array<unsigned, 4> m_sink_planes;
+public:
+	FilterGraphStream(std::unique_ptr<BandStream> stream, const std::array<unsigned, 4> &source_planes, const std::array<unsigned, 4> &sink_planes);
+
+	~FilterGraphStream();
+
+	unsigned push_rows(const std::array<graphengine::BufferDescriptor, 4> &src, unsigned num_rows);
+
+	unsigned pull_rows(const std::array<graphengine::BufferDescriptor, 4> &dst, unsigned num_rows);
+};
+
 class FilterGraph : public zimg_filter_graph {
 	typedef int (*callback_type)(void *user, unsigned i, unsigned left, unsigned right);
+	typedef void (*task_func)(void *task_user, unsigned index);
+	typedef int (*thread_pool_type)(void *user, task_func task, void *task_user, unsigned num_tasks);
+
+	struct output {
+		graphengine::node_id sink_id;
+		std::array<unsigned, 4> sink_planes;
+	};
 
 	std::unique_ptr<graphengine::Graph> m_graph;
 	std::shared_ptr<void> m_instance_data;
+	std::shared_ptr<const BandExecutor> m_band_executor;
+	std::shared_ptr<GraphProfile> m_profile;
 	graphengine::node_id m_source_id;
-	graphengine::node_id m_sink_id;
+	std::array<unsigned, 4> m_source_planes;
+	std::vector<output> m_outputs;
+	std::vector<unsigned char> m_build_request;
+	TableRecord m_build_tables;
 	bool m_requires_64b;
-	bool m_source_greyalpha;
-	bool m_sink_greyalpha;
+
+	void check_single_output() const;
+
+	void check_band_executor() const;
 public:
 	FilterGraph(std::unique_ptr<graphengine::Graph> graph, std::shared_ptr<void> instance_data, graphengine::node_id source_id, graphengine::node_id sink_id);
 
@@ -51,7 +91,9 @@ public:
 
 	unsigned get_input_buffering() const;
 
-	unsigned get_output_buffering() const;
+	unsigned get_output_buffering(unsigned index = 0) const;
+
+	unsigned get_num_outputs() const { return static_cast<unsigned>(m_outputs.size()); }
 
 	unsigned get_tile_width() const;
 
@@ -59,22 +101,66 @@ public:
 
 	void set_requires_64b_alignment() { m_requires_64b = true; }
 
-	void set_source_greyalpha() { m_source_greyalpha = true; }
+	// Index of the API buffer plane backing each graph endpoint plane.
+	void set_buffer_planes(const std::array<unsigned, 4> &source_planes, const std::array<unsigned, 4> &sink_planes)
+	{
+		m_source_planes = source_planes;
+		m_outputs.front().sink_planes = sink_planes;
+	}
+
+	// Add a sink fed by the same source. Multi-output graphs are executed with FilterGraph::process_multi.
+	void add_output(graphengine::node_id sink_id, const std::array<unsigned, 4> &sink_planes) { m_outputs.push_back({ sink_id, sink_planes }); }
 
-	void set_sink_greyalpha() { m_sink_greyalpha = true; }
+	void set_band_executor(std::shared_ptr<const BandExecutor> executor) { m_band_executor = std::move(executor); }
+
+	void set_profile(std::shared_ptr<GraphProfile> profile) { m_profile = std::move(profile); }
+
+	// Execution statistics, or null if the graph was built without profiling.
+	GraphProfile *get_profile() const { return m_profile.get(); }
+
+	// Opaque description of the API call which built the graph, and the
+	// tables recorded while building it, used to serialize the graph.
+	void set_build_request(std::vector<unsigned char> request, TableRecord tables)
+	{
+		m_build_request = std::move(request);
+		m_build_tables = std::move(tables);
+	}
+
+	const std::vector<unsigned char> &get_build_request() const { return m_build_request; }
+
+	const TableRecord &get_build_tables() const { return m_build_tables; }
 
 	void process(const std::array<graphengine::BufferDescriptor, 4> &src, const std::array<graphengine::BufferDescriptor, 4> &dst, void *tmp, callback_type unpack_cb, void *unpack_user, callback_type pack_cb, void *pack_user) const;
+
+	// Produce all outputs in one pass over the source. The callback arrays may be null.
+	void process_multi(const std::array<graphengine::BufferDescriptor, 4> &src, const std::array<graphengine::BufferDescriptor, 4> dst[], void *tmp,
+	                   callback_type unpack_cb, void *unpack_user, const callback_type pack_cb[], void * const pack_user[]) const;
+
+	size_t get_tmp_size_mt(unsigned num_bands) const;
+
+	void process_mt(const std::array<graphengine::BufferDescriptor, 4> &src, const std::array<graphengine::BufferDescriptor, 4> &dst, void *tmp, unsigned num_bands,
+	                callback_type unpack_cb, void *unpack_user, callback_type pack_cb, void *pack_user, thread_pool_type pool_cb, void *pool_user) const;
+
+	std::unique_ptr<FilterGraphStream> begin_stream() const;
 };
 
 class SubGraph : public zimg_subgraph {
 	typedef std::array<graphengine::node_id, graphengine::NODE_MAX_PLANES> node_list;
 	typedef std::array<graphengine::PlaneDescriptor, graphengine::NODE_MAX_PLANES> plane_desc_list;
 
+	struct output {
+		node_list sink_ids;
+		std::array<unsigned, 4> sink_planes;
+	};
+
 	std::unique_ptr<graphengine::SubGraph> m_subgraph;
 	std::shared_ptr<void> m_instance_data;
+	std::shared_ptr<const BandExecutor> m_band_executor;
+	std::shared_ptr<GraphProfile> m_profile;
 	plane_desc_list m_source_desc;
 	node_list m_source_ids;
-	node_list m_sink_ids;
+	std::array<unsigned, 4> m_source_planes;
+	std::vector<output> m_outputs;
 
 	bool m_requires_64b;
 public:
@@ -88,6 +174,19 @@ public:
 
 	void set_requires_64b_alignment() { m_requires_64b = true; }
 
+	void set_buffer_planes(const std::array<unsigned, 4> &source_planes, const std::array<unsigned, 4> &sink_planes)
+	{
+		m_source_planes = source_planes;
+		m_outputs.front().sink_planes = sink_planes;
+	}
+
+	// Add another set of sink nodes. Only the first output is reported by SubGraph::get_endpoint_ids.
+	void add_output(const node_list &sink_ids, const std::array<unsigned, 4> &sink_planes) { m_outputs.push_back({ sink_ids, sink_planes }); }
+
+	void set_band_executor(std::shared_ptr<const BandExecutor> executor) { m_band_executor = std::move(executor); }
+
+	void set_profile(std::shared_ptr<GraphProfile> profile) { m_profile = std::move(profile); }
+
 	std::unique_ptr<FilterGraph> build_full_graph() const;
 };
 
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include "colorspace/matrix3.h"
+#include "common/checked_int.h"
+#include "common/cpuinfo.h"
+#include "common/zassert.h"
+#include "depth/quantize.h"
+#include "fused_filters.h"
+
+#if defined(ZIMG_X86)
+  #include "x86/fused_filters_x86.h"
+#endif
+
+namespace zimg::graph {
+
+ChromaUpsampleFilter::ChromaUpsampleFilter(std::shared_ptr<const resize::FilterContext> filter_h, std::shared_ptr<const resize::FilterContext> filter_v, const PixelFormat &format) :
+	m_filter_h(std::move(filter_h)),
+	m_filter_v(std::move(filter_v)),
+	m_type{ format.type },
+	m_scale{},
+	m_offset{},
+	m_sorted_h{ std::is_sorted(m_filter_h->left.begin(), m_filter_h->left.end()) },
+	m_sorted_v{ std::is_sorted(m_filter_v->left.begin(), m_filter_v->left.end()) }
+{
+	zassert_d(pixel_is_integer(format.type), "must be integer");
+	zassert_d(m_filter_h->input_width <= pixel_max_width(PixelType::FLOAT), "overflow");
+
+	std::tie(m_scale, m_offset) = depth::get_scale_offset(format, PixelType::FLOAT);
+
+	m_desc.format = { m_filter_h->filter_rows, m_filter_v->filter_rows, pixel_size(PixelType::FLOAT) };
+	m_desc.num_deps = 2;
+	m_desc.num_planes = 2;
+	m_desc.step = 1;
+	m_desc.scratchpad_size = (checked_size_t{ m_filter_h->input_width } * sizeof(float)).get();
+	m_desc.flags.entire_row = !m_sorted_h;
+}
+
+auto ChromaUpsampleFilter::get_row_deps(unsigned i) const noexcept -> pair_unsigned
+{
+	if (!m_sorted_v)
+		return{ 0, m_filter_v->input_width };
+
+	unsigned top = m_filter_v->left[i];
+	return{ top, top + m_filter_v->filter_width };
+}
+
+auto ChromaUpsampleFilter::get_col_deps(unsigned left, unsigned right) const noexcept -> pair_unsigned
+{
+	if (!m_sorted_h)
+		return{ 0, m_filter_h->input_width };
+
+	unsigned col_left = m_filter_h->left[left];
+	unsigned col_right = m_filter_h->left[right - 1] + m_filter_h->filter_width;
+	return{ col_left, col_right };
+}
+
+template <class T>
+void ChromaUpsampleFilter::process_plane(const graphengine::BufferDescriptor &in, const graphengine::BufferDescriptor &out,
+                                         unsigned i, unsigned left, unsigned right, float *tmp) const noexcept
+{
+	auto cols = get_col_deps(left, right);
+
+	// Vertical pass with conversion to float into a single row at source width.
+	const float *filter_v = m_filter_v->data.data() + static_cast<size_t>(m_filter_v->phase[i]) * m_filter_v->stride;
+	unsigned top = m_filter_v->left[i];
+
+	std::fill(tmp + cols.first, tmp + cols.second, 0.0f);
+
+	for (unsigned k = 0; k < m_filter_v->filter_width; ++k) {
+		const T *src_p = in.get_line<T>(top + k);
+		float coeff = filter_v[k];
+
+		for (unsigned j = cols.first; j < cols.second; ++j) {
+			tmp[j] += coeff * static_cast<float>(src_p[j]);
+		}
+	}
+
+	for (unsigned j = cols.first; j < cols.second; ++j) {
+		tmp[j] = tmp[j] * m_scale + m_offset;
+	}
+
+	// Horizontal pass from the float row into the output.
+	float *dst_p = out.get_line<float>(i);
+
+	for (unsigned j = left; j < right; ++j) {
+		const float *filter_h = m_filter_h->data.data() + static_cast<size_t>(m_filter_h->phase[j]) * m_filter_h->stride;
+		const float *src_p = tmp + m_filter_h->left[j];
+		float accum = 0.0f;
+
+		for (unsigned k = 0; k < m_filter_h->filter_width; ++k) {
+			accum += filter_h[k] * src_p[k];
+		}
+
+		dst_p[j] = accum;
+	}
+}
+
+void ChromaUpsampleFilter::process(const graphengine::BufferDescriptor in[2], const graphengine::BufferDescriptor out[2],
+                                   unsigned i, unsigned left, unsigned right, void *, void *tmp) const noexcept
+{
+	for (unsigned p = 0; p < 2; ++p) {
+		if (m_type == PixelType::BYTE)
+			process_plane<uint8_t>(in[p], out[p], i, left, right, static_cast<float *>(tmp));
+		else
+			process_plane<uint16_t>(in[p], out[p], i, left, right, static_cast<float *>(tmp));
+	}
+}
+
+
+YUVToRGBFilter::YUVToRGBFilter(const colorspace::Matrix3x3 &matrix, const PixelFormat &format, unsigned width, unsigned height) :
+	PointFilter(width, height, PixelType::FLOAT),
+	m_matrix{},
+	m_type{ format.type },
+	m_scale{},
+	m_offset{}
+{
+	zassert_d(pixel_is_integer(format.type), "must be integer");
+
+	for (unsigned i = 0; i < 3; ++i) {
+		for (unsigned j = 0; j < 3; ++j) {
+			m_matrix[i][j] = static_cast<float>(matrix[i][j]);
+		}
+	}
+
+	std::tie(m_scale, m_offset) = depth::get_scale_offset(format, PixelType::FLOAT);
+
+	m_desc.num_deps = 3;
+	m_desc.num_planes = 3;
+}
+
+template <class T>
+void YUVToRGBFilter::process_t(const graphengine::BufferDescriptor in[3], const graphengine::BufferDescriptor out[3],
+                               unsigned i, unsigned left, unsigned right) const noexcept
+{
+	const T *src_y = in[0].get_line<T>(i);
+	const float *src_u = in[1].get_line<float>(i);
+	const float *src_v = in[2].get_line<float>(i);
+	float *dst_r = out[0].get_line<float>(i);
+	float *dst_g = out[1].get_line<float>(i);
+	float *dst_b = out[2].get_line<float>(i);
+
+	for (unsigned j = left; j < right; ++j) {
+		float y = static_cast<float>(src_y[j]) * m_scale + m_offset;
+		float u = src_u[j];
+		float v = src_v[j];
+
+		dst_r[j] = m_matrix[0][0] * y + m_matrix[0][1] * u + m_matrix[0][2] * v;
+		dst_g[j] = m_matrix[1][0] * y + m_matrix[1][1] * u + m_matrix[1][2] * v;
+		dst_b[j] = m_matrix[2][0] * y + m_matrix[2][1] * u + m_matrix[2][2] * v;
+	}
+}
+
+void YUVToRGBFilter::process(const graphengine::BufferDescriptor in[3], const graphengine::BufferDescriptor out[3],
+                             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept
+{
+	if (m_type == PixelType::BYTE)
+		process_t<uint8_t>(in, out, i, left, right);
+	else
+		process_t<uint16_t>(in, out, i, left, right);
+}
+
+
+std::unique_ptr<graphengine::Filter> create_chroma_upsample(const resize::Filter &filter, const PixelFormat &format, unsigned src_width, unsigned src_height,
+                                                            unsigned dst_width, unsigned dst_height, double shift_w, double shift_h, double subwidth, double subheight, CPUClass cpu)
+{
+	std::unique_ptr<graphengine::Filter> ret;
+
+	auto filter_h = resize::get_filter_context(filter, src_width, dst_width, shift_w, subwidth, resize::FilterPrecision::FLOAT);
+	auto filter_v = resize::get_filter_context(filter, src_height, dst_height, shift_h, subheight, resize::FilterPrecision::FLOAT);
+
+#if defined(ZIMG_X86)
+	ret = create_chroma_upsample_x86(filter_h, filter_v, format, cpu);
+#endif
+#if defined(ZIMG_X86) || defined(ZIMG_ARM) || defined(ZIMG_VEC)
+	if (!ret && cpu != CPUClass::NONE)
+		return nullptr;
+#endif
+	if (!ret)
+		ret = std::make_unique<ChromaUpsampleFilter>(filter_h, filter_v, format);
+
+	return ret;
+}
+
+std::unique_ptr<graphengine::Filter> create_yuv_to_rgb(const colorspace::Matrix3x3 &matrix, const PixelFormat &format, unsigned width, unsigned height, CPUClass cpu)
+{
+	std::unique_ptr<graphengine::Filter> ret;
+
+#if defined(ZIMG_X86)
+	ret = create_yuv_to_rgb_x86(matrix, format, width, height, cpu);
+#endif
+#if defined(ZIMG_X86) || defined(ZIMG_ARM) || defined(ZIMG_VEC)
+	if (!ret && cpu != CPUClass::NONE)
+		return nullptr;
+#endif
+	if (!ret)
+		ret = std::make_unique<YUVToRGBFilter>(matrix, format, width, height);
+
+	return ret;
+}
+
+} // namespace zimg::graph
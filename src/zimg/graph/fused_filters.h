@@ -0,0 +1,87 @@
+#pragma once
+
+#ifndef ZIMG_GRAPH_FUSED_FILTERS_H_
+#define ZIMG_GRAPH_FUSED_FILTERS_H_
+
+#include <memory>
+#include "common/pixel.h"
+#include "graphengine/filter.h"
+#include "resize/filter.h"
+#include "filter_base.h"
+
+namespace zimg {
+enum class CPUClass;
+}
+
+namespace zimg::colorspace {
+struct Matrix3x3;
+}
+
+namespace zimg::graph {
+
+// Converts both integer chroma planes to float and upsamples them in one pass.
+class ChromaUpsampleFilter : public FilterBase {
+	std::shared_ptr<const resize::FilterContext> m_filter_h;
+	std::shared_ptr<const resize::FilterContext> m_filter_v;
+	PixelType m_type;
+	float m_scale;
+	float m_offset;
+	bool m_sorted_h;
+	bool m_sorted_v;
+
+	template <class T>
+	void process_plane(const graphengine::BufferDescriptor &in, const graphengine::BufferDescriptor &out,
+	                   unsigned i, unsigned left, unsigned right, float *tmp) const noexcept;
+public:
+	ChromaUpsampleFilter(std::shared_ptr<const resize::FilterContext> filter_h, std::shared_ptr<const resize::FilterContext> filter_v, const PixelFormat &format);
+
+	pair_unsigned get_row_deps(unsigned i) const noexcept override;
+
+	pair_unsigned get_col_deps(unsigned left, unsigned right) const noexcept override;
+
+	void process(const graphengine::BufferDescriptor in[2], const graphengine::BufferDescriptor out[2],
+	             unsigned i, unsigned left, unsigned right, void *, void *tmp) const noexcept override;
+};
+
+// Converts integer luma to float and applies a YUV to RGB matrix in one pass.
+class YUVToRGBFilter : public PointFilter {
+	float m_matrix[3][3];
+	PixelType m_type;
+	float m_scale;
+	float m_offset;
+
+	template <class T>
+	void process_t(const graphengine::BufferDescriptor in[3], const graphengine::BufferDescriptor out[3],
+	               unsigned i, unsigned left, unsigned right) const noexcept;
+public:
+	YUVToRGBFilter(const colorspace::Matrix3x3 &matrix, const PixelFormat &format, unsigned width, unsigned height);
+
+	void process(const graphengine::BufferDescriptor in[3], const graphengine::BufferDescriptor out[3],
+	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override;
+};
+
+/**
+ * Create a filter converting both integer chroma planes to float and
+ * upsampling them.
+ *
+ * The portable filters are only used when |cpu| does not select a SIMD
+ * instruction set, since the separate depth and resize passes have
+ * vectorized kernels. Otherwise, the result is null if no vectorized fused
+ * kernel is available for |cpu|.
+ *
+ * @return filter, or null if the unfused path should be used
+ */
+std::unique_ptr<graphengine::Filter> create_chroma_upsample(const resize::Filter &filter, const PixelFormat &format, unsigned src_width, unsigned src_height,
+                                                            unsigned dst_width, unsigned dst_height, double shift_w, double shift_h, double subwidth, double subheight, CPUClass cpu);
+
+/**
+ * Create a filter converting integer luma and float chroma to float RGB.
+ *
+ * @see create_chroma_upsample
+ * @return filter, or null if the unfused path should be used
+ */
+std::unique_ptr<graphengine::Filter> create_yuv_to_rgb(const colorspace::Matrix3x3 &matrix, const PixelFormat &format, unsigned width, unsigned height, CPUClass cpu);
+
+} // namespace zimg::graph
+
+#endif // ZIMG_GRAPH_FUSED_FILTERS_H_
@@ -3,19 +3,28 @@
 #include <memory>
 #include <tuple>
 #include <utility>
+#include <vector>
 #include "colorspace/colorspace.h"
+#include "colorspace/colorspace_param.h"
+#include "colorspace/gamma.h"
+#include "colorspace/matrix_int.h"
 #include "common/cpuinfo.h"
 #include "common/except.h"
 #include "common/pixel.h"
 #include "depth/depth.h"
 #include "graphengine/filter.h"
 #include "graphengine/graph.h"
+#include "resize/decimate.h"
 #include "resize/filter.h"
 #include "resize/resize.h"
 #include "unresize/unresize.h"
+#include "band_executor.h"
 #include "filtergraph.h"
+#include "fused_filters.h"
 #include "graphbuilder.h"
 #include "graphengine_except.h"
+#include "packing.h"
+#include "profile.h"
 #include "simple_filters.h"
 
 
@@ -187,6 +196,85 @@ double luma_parity_offset(GraphBuilder::FieldParity parity)
 		return 0.0;
 }
 
+unsigned num_components(const GraphBuilder::state &state)
+{
+	return (state.color == GraphBuilder::ColorFamily::GREY ? 1 : 3) + (state.alpha != GraphBuilder::AlphaType::NONE ? 1 : 0);
+}
+
+bool is_packed_layout(GraphBuilder::Layout layout)
+{
+	return layout == GraphBuilder::Layout::PACKED || layout == GraphBuilder::Layout::PACKED_BGR;
+}
+
+bool is_packed_422_layout(GraphBuilder::Layout layout)
+{
+	return layout == GraphBuilder::Layout::YUYV || layout == GraphBuilder::Layout::UYVY;
+}
+
+// Returns the buffer planes used by an image, and their indices in the API buffer.
+unsigned get_buffer_planes(const GraphBuilder::state &state, graphengine::PlaneDescriptor desc[], unsigned api_planes[])
+{
+	unsigned bytes_per_sample = pixel_size(state.type);
+	unsigned chroma_width = state.width >> state.subsample_w;
+	unsigned chroma_height = state.height >> state.subsample_h;
+	unsigned n = 0;
+
+	auto add_plane = [&](unsigned index, unsigned width, unsigned height)
+	{
+		desc[n] = { width, height, bytes_per_sample };
+		api_planes[n] = index;
+		++n;
+	};
+
+	if (is_packed_layout(state.layout)) {
+		add_plane(PLANE_Y, state.width * num_components(state), state.height);
+	} else if (is_packed_422_layout(state.layout)) {
+		add_plane(PLANE_Y, state.width * 2, state.height);
+	} else {
+		add_plane(PLANE_Y, state.width, state.height);
+
+		if (state.layout == GraphBuilder::Layout::SEMIPLANAR) {
+			add_plane(PLANE_U, chroma_width * 2, chroma_height);
+		} else if (state.color != GraphBuilder::ColorFamily::GREY) {
+			add_plane(PLANE_U, chroma_width, chroma_height);
+			add_plane(PLANE_V, chroma_width, chroma_height);
+		}
+
+		if (state.alpha != GraphBuilder::AlphaType::NONE)
+			add_plane(PLANE_A, state.width, state.height);
+	}
+
+	return n;
+}
+
+void validate_layout(const GraphBuilder::state &state)
+{
+	if (state.layout == GraphBuilder::Layout::SEMIPLANAR) {
+		if (state.color != GraphBuilder::ColorFamily::YUV)
+			error::throw_<error::ColorFamilyMismatch>("semi-planar layout requires YUV color family");
+	}
+
+	if (is_packed_layout(state.layout)) {
+		if (state.layout == GraphBuilder::Layout::PACKED_BGR && state.color == GraphBuilder::ColorFamily::GREY)
+			error::throw_<error::ColorFamilyMismatch>("BGR layout requires three color planes");
+		if (state.subsample_w || state.subsample_h)
+			error::throw_<error::UnsupportedSubsampling>("packed layout cannot be subsampled");
+		if (state.width > pixel_max_width(state.type) / num_components(state))
+			error::throw_<error::InvalidImageSize>("image width exceeds memory addressing limit");
+	}
+
+	if (is_packed_422_layout(state.layout)) {
+		if (state.color != GraphBuilder::ColorFamily::YUV)
+			error::throw_<error::ColorFamilyMismatch>("YUYV and UYVY layouts require YUV color family");
+		if (state.subsample_w != 1 || state.subsample_h != 0)
+			error::throw_<error::UnsupportedSubsampling>("YUYV and UYVY layouts require 4:2:2 subsampling");
+		if (state.alpha != GraphBuilder::AlphaType::NONE)
+			error::throw_<error::UnsupportedOperation>("YUYV and UYVY layouts cannot have alpha channel");
+		if (state.width > pixel_max_width(state.type) / 2)
+			error::throw_<error::InvalidImageSize>("image width exceeds memory addressing limit");
+	}
+}
+
 void validate_state(const GraphBuilder::state &state)
 {
 	if (!state.width || !state.height)
@@ -232,6 +320,15 @@ void validate_state(const GraphBuilder::state &state)
 		error::throw_<error::InvalidImageSize>("active window must be finite");
 	if (state.active_width <= 0 || state.active_height <= 0)
 		error::throw_<error::InvalidImageSize>("active window must be positive");
+
+	validate_layout(state);
+}
+
+void validate_target(const GraphBuilder::state &state)
+{
+	validate_state(state);
+	if (state.active_left != 0 || state.active_top != 0 || state.active_width != state.width || state.active_height != state.height)
+		error::throw_<error::ResamplingNotAvailable>("active subregion not supported on target image");
 }
 
 } // namespace
@@ -244,24 +341,25 @@ class SubGraphBuilder {
 private:
 	std::vector<std::unique_ptr<graphengine::Filter>> m_filters;
 	std::unique_ptr<graphengine::SubGraph> m_subgraph;
+	std::shared_ptr<GraphProfile> m_profile;
+	BandExecutor m_executor;
 	graphengine::node_id m_source_ids[4];
-	graphengine::node_id m_sink_ids[4];
 public:
 	SubGraphBuilder() :
 		m_subgraph(std::make_unique<graphengine::SubGraphImpl>()),
-		m_source_ids{},
-		m_sink_ids{}
+		m_source_ids{}
 	{
 		m_source_ids[0] = m_subgraph->add_source();
 		m_source_ids[1] = m_subgraph->add_source();
 		m_source_ids[2] = m_subgraph->add_source();
 		m_source_ids[3] = m_subgraph->add_source();
 
-		std::fill_n(m_sink_ids, 4, graphengine::null_node);
+		for (graphengine::node_id id : m_source_ids) {
+			m_executor.add_source(id);
+		}
 	}
 
 	graphengine::node_id source_id(unsigned p) const { return m_source_ids[p]; }
-	graphengine::node_id sink_id(unsigned p) const { return m_sink_ids[p]; }
 
 	const graphengine::Filter *save_filter(std::unique_ptr<graphengine::Filter> filter)
 	{
@@ -269,25 +367,47 @@ public:
 		return m_filters.back().get();
 	}
 
+	const std::shared_ptr<GraphProfile> &profile() const { return m_profile; }
+
+	// Record execution statistics for filters added from now on.
+	void enable_profiling()
+	{
+		if (!m_profile)
+			m_profile = std::make_shared<GraphProfile>();
+	}
+
 	graphengine::node_id add_transform(const graphengine::Filter *filter, const graphengine::node_dep_desc deps[])
 	{
 		zassert_d(!!m_subgraph, "");
-		return m_subgraph->add_transform(filter, deps);
+
+		if (m_profile)
+			filter = save_filter(std::make_unique<ProfilingFilter>(filter, m_profile));
+
+		graphengine::node_id id = m_subgraph->add_transform(filter, deps);
+		m_executor.add_transform(id, filter, deps);
+		return id;
 	}
 
-	void set_sink(unsigned num_planes, const graphengine::node_dep_desc deps[])
+	void add_sink(unsigned num_planes, const graphengine::node_dep_desc deps[], graphengine::node_id ids[])
 	{
 		zassert_d(!!m_subgraph, "");
 
 		for (unsigned p = 0; p < num_planes; ++p) {
-			m_sink_ids[p] = m_subgraph->add_sink(deps[p]);
+			ids[p] = m_subgraph->add_sink(deps[p]);
 		}
 	}
 
-	std::pair<std::unique_ptr<graphengine::SubGraph>, std::shared_ptr<void>> release()
+	void set_band_endpoints(unsigned num_sources, const graphengine::node_id source_ids[], const graphengine::PlaneDescriptor source_desc[],
+	                        unsigned num_sinks, const graphengine::node_dep_desc sink_deps[])
+	{
+		m_executor.set_endpoints(num_sources, source_ids, source_desc, num_sinks, sink_deps);
+	}
+
+	std::tuple<std::unique_ptr<graphengine::SubGraph>, std::shared_ptr<void>, std::shared_ptr<const BandExecutor>> release()
 	{
 		std::shared_ptr<void> opaque = std::make_shared<decltype(m_filters)>(std::move(m_filters));
-		auto ret = std::make_pair(std::move(m_subgraph), std::move(opaque));
+		std::shared_ptr<const BandExecutor> executor = std::make_shared<BandExecutor>(std::move(m_executor));
+		auto ret = std::make_tuple(std::move(m_subgraph), std::move(opaque), std::move(executor));
 		*this = SubGraphBuilder{};
 		return ret;
 	}
@@ -439,8 +559,14 @@ private:
 
 	SubGraphBuilder m_graph;
 	std::array<graphengine::node_dep_desc, PLANE_NUM> m_ids;
+	plane_mask m_premul_pending;
+	graphengine::node_dep_desc m_premul_alpha;
+	const graphengine::Filter *m_premul_filter;
 	state m_source_state;
 	internal_state m_state;
+	Layout m_sink_layout;
+	CPUClass m_cpu;
+	bool m_source_unpacked;
 	bool m_requires_64b;
 
 	internal_state make_float_444_state(const internal_state &state, bool include_alpha)
@@ -465,11 +591,66 @@ private:
 		}
 	}
 
+	// Applies a premultiplication deferred by |premultiply| to the planes in |mask|.
+	void flush_premultiply(plane_mask mask)
+	{
+		apply_mask(mask, [&](int p)
+		{
+			if (!m_premul_pending[p])
+				return;
+
+			graphengine::node_dep_desc deps[2] = { m_ids[p], m_premul_alpha };
+			m_ids[p] = { m_graph.add_transform(m_premul_filter, deps), 0 };
+			m_premul_pending[p] = false;
+		});
+	}
+
+	bool premultiply_pending(plane_mask mask)
+	{
+		bool pending = true;
+		apply_mask(mask, [&](int p) { pending = pending && m_premul_pending[p]; });
+		return pending;
+	}
+
 	void attach_greyscale_filter(const graphengine::Filter *filter, plane_mask mask)
 	{
+		flush_premultiply(mask);
 		apply_mask(mask, [&](int p) { m_ids[p] = { m_graph.add_transform(filter, &m_ids[p]), 0 }; });
 	}
 
+	// Attaches a filter taking the color planes in |mask| as a single node.
+	void attach_color_filter(const graphengine::Filter *filter, plane_mask mask)
+	{
+		graphengine::node_dep_desc deps[PLANE_NUM];
+		unsigned n = 0;
+
+		flush_premultiply(mask);
+		apply_mask(mask, [&](int p) { deps[n++] = m_ids[p]; });
+
+		graphengine::node_id id = m_graph.add_transform(filter, deps);
+
+		n = 0;
+		apply_mask(mask, [&](int p) { m_ids[p] = { id, n++ }; });
+	}
+
+	// Attaches a filter taking the color planes in |mask| followed by |alpha|.
+	graphengine::node_id attach_alpha_filter(const graphengine::Filter *filter, plane_mask mask, graphengine::node_dep_desc alpha)
+	{
+		graphengine::node_dep_desc deps[PLANE_NUM];
+		unsigned n = 0;
+
+		iassert(!mask[PLANE_A]);
+
+		apply_mask(mask, [&](int p) { deps[n++] = m_ids[p]; });
+		deps[n] = alpha;
+
+		graphengine::node_id id = m_graph.add_transform(filter, deps);
+
+		n = 0;
+		apply_mask(mask, [&](int p) { m_ids[p] = { id, n++ }; m_premul_pending[p] = false; });
+		return id;
+	}
+
 	void check_is_444_float(bool check_alpha)
 	{
 		iassert(m_state.planes[PLANE_Y].format.type == PixelType::FLOAT);
@@ -599,7 +780,11 @@ private:
 		return target.alpha != AlphaType::STRAIGHT || needs_colorspace(target) || needs_interpolation(target);
 	}
 
-	void drop_plane(int p) { m_ids[p] = graphengine::null_dep; }
+	void drop_plane(int p)
+	{
+		m_ids[p] = graphengine::null_dep;
+		m_premul_pending[p] = false;
+	}
 
 	void yuv_to_grey(FilterObserver &observer)
 	{
@@ -618,6 +803,7 @@ private:
 
 		observer.grey_to_rgb();
 
+		flush_premultiply(luma_planes);
 		m_ids[PLANE_U] = m_ids[PLANE_Y];
 		m_ids[PLANE_V] = m_ids[PLANE_Y];
 
@@ -658,33 +844,34 @@ private:
 		m_state.planes[PLANE_V].format = format;
 	}
 
-	void premultiply(FilterObserver &observer)
+	void premultiply(const params &params, FilterObserver &observer)
 	{
 		iassert(m_state.alpha == AlphaType::STRAIGHT);
 		check_is_444_float(true);
 
 		observer.premultiply();
 
+		// The filter is attached when the color planes are next used, unless
+		// the premultiplication can be performed by the resizer.
 		auto filter = std::make_unique<PremultiplyFilter>(
-			m_state.planes[PLANE_Y].width, m_state.planes[PLANE_Y].height);
-		for (unsigned p = 0; p < (m_state.has_chroma() ? 3U : 1U); ++p) {
-			graphengine::node_dep_desc deps[2] = { m_ids[p], m_ids[PLANE_A] };
-			m_ids[p] = { m_graph.add_transform(filter.get(), deps), 0 };
-		}
-		m_graph.save_filter(std::move(filter));
+			m_state.planes[PLANE_Y].width, m_state.planes[PLANE_Y].height, params.cpu);
+		m_premul_filter = m_graph.save_filter(std::move(filter));
+		m_premul_alpha = m_ids[PLANE_A];
+		m_premul_pending = m_state.has_chroma() ? luma_planes | chroma_planes : luma_planes;
 
 		m_state.alpha = AlphaType::PREMULTIPLIED;
 	}
 
-	void unpremultiply(FilterObserver &observer)
+	void unpremultiply(const params &params, FilterObserver &observer)
 	{
 		iassert(m_state.alpha == AlphaType::PREMULTIPLIED);
 		check_is_444_float(true);
 
 		observer.unpremultiply();
+		flush_premultiply(luma_planes | chroma_planes);
 
 		auto filter = std::make_unique<UnpremultiplyFilter>(
-			m_state.planes[PLANE_Y].width, m_state.planes[PLANE_Y].height);
+			m_state.planes[PLANE_Y].width, m_state.planes[PLANE_Y].height, params.cpu);
 		for (unsigned p = 0; p < (m_state.has_chroma() ? 3U : 1U); ++p) {
 			graphengine::node_dep_desc deps[2] = {m_ids[p], m_ids[PLANE_A]};
 			m_ids[p] = { m_graph.add_transform(filter.get(), deps), 0 };
@@ -723,15 +910,22 @@ private:
 		if (params.unresize)
 			return PixelType::FLOAT;
 
-		bool supported[4] = { false, true, cpu_has_fast_f16(params.cpu), true };
+		PixelFormat src_format = m_state.planes[p].format;
+		PixelFormat dst_format = target.planes[p].format;
+
+		// BYTE is only used when no depth conversion is required, so that no precision is lost.
+		bool byte_supported = src_format.type == PixelType::BYTE && src_format == dst_format;
+#ifdef ZIMG_ARM
+		// There are no vectorized 8-bit resizers for ARM.
+		byte_supported = byte_supported && params.cpu == CPUClass::NONE;
+#endif
+
+		bool supported[4] = { byte_supported, true, cpu_has_fast_f16(params.cpu), true };
 		auto is_supported_type = [=](PixelType type) { return supported[static_cast<int>(type)]; };
 
 		double src_pels = static_cast<double>(m_state.planes[p].width) * m_state.planes[p].height;
 		double dst_pels = static_cast<double>(target.planes[p].width) * target.planes[p].height;
 
-		PixelFormat src_format = m_state.planes[p].format;
-		PixelFormat dst_format = target.planes[p].format;
-
 		// If both formats are supported, pick the one that ends up converting the fewest pixels.
 		if (is_supported_type(src_format.type) && is_supported_type(dst_format.type))
 			return src_pels < dst_pels ? dst_format : src_format;
@@ -750,6 +944,20 @@ private:
 		return PixelType::FLOAT;
 	}
 
+	// Map active region in output image to the corresponding rectangle in input image.
+	static std::tuple<double, double, double, double> map_active_region(const internal_state::plane &src_plane, const internal_state::plane &dst_plane)
+	{
+		double scale_w = static_cast<double>(dst_plane.active_width) / src_plane.active_width;
+		double scale_h = static_cast<double>(dst_plane.active_height) / src_plane.active_height;
+
+		double shift_w = src_plane.active_left - dst_plane.active_left / scale_w;
+		double shift_h = src_plane.active_top - dst_plane.active_top / scale_h;
+		double subwidth = src_plane.active_width * (dst_plane.width / dst_plane.active_width);
+		double subheight = src_plane.active_height * (dst_plane.height / dst_plane.active_height);
+
+		return{ shift_w, shift_h, subwidth, subheight };
+	}
+
 	void resize_plane(const internal_state &target, const params &params, FilterObserver &observer, plane_mask mask, int p)
 	{
 		if (!needs_resize_plane(target, p))
@@ -766,17 +974,12 @@ private:
 			}
 		}
 
-		double scale_w = static_cast<double>(dst_plane.active_width) / src_plane.active_width;
-		double scale_h = static_cast<double>(dst_plane.active_height) / src_plane.active_height;
-
-		// Map active region in output image to the corresponding rectangle in input image.
-		double shift_w = src_plane.active_left - dst_plane.active_left / scale_w;
-		double shift_h = src_plane.active_top - dst_plane.active_top / scale_h;
-		double subwidth = src_plane.active_width * (dst_plane.width / dst_plane.active_width);
-		double subheight = src_plane.active_height * (dst_plane.height / dst_plane.active_height);
+		auto [shift_w, shift_h, subwidth, subheight] = map_active_region(src_plane, dst_plane);
 
 		std::unique_ptr<graphengine::Filter> first;
 		std::unique_ptr<graphengine::Filter> second;
+		unsigned color_planes = 1;
+		bool premultiply = false;
 
 		if (params.unresize) {
 			unresize::UnresizeConversion conv{ src_plane.width, src_plane.height, src_plane.format.type };
@@ -803,6 +1006,16 @@ private:
 				.set_subheight(subheight)
 				.set_cpu(params.cpu);
 
+			// Planes sharing a filter are resized together.
+			color_planes = static_cast<unsigned>(std::count(mask.begin(), mask.end(), true));
+			conv.set_color_planes(color_planes);
+
+			// A deferred premultiplication is performed by the first pass.
+			if (premultiply_pending(mask) && conv.premultiply_supported()) {
+				conv.set_premultiply(true);
+				premultiply = true;
+			}
+
 			observer.resize(conv, p);
 
 			auto filter_list = conv.create();
@@ -810,9 +1023,16 @@ private:
 			second = std::move(filter_list.second);
 		}
 
-		if (first)
+		if (first && premultiply)
+			attach_alpha_filter(m_graph.save_filter(std::move(first)), mask, m_premul_alpha);
+		else if (first && color_planes > 1)
+			attach_color_filter(m_graph.save_filter(std::move(first)), mask);
+		else if (first)
 			attach_greyscale_filter(m_graph.save_filter(std::move(first)), mask);
-		if (second)
+
+		if (second && color_planes > 1)
+			attach_color_filter(m_graph.save_filter(std::move(second)), mask);
+		else if (second)
 			attach_greyscale_filter(m_graph.save_filter(std::move(second)), mask);
 
 		apply_mask(mask, [&](int q)
@@ -823,27 +1043,123 @@ private:
 		});
 	}
 
-	void convert_colorspace(const colorspace::ColorspaceDefinition &csp, const params &params, FilterObserver &observer)
+	bool can_resize_unpremultiply(const internal_state &target, const params &params)
 	{
-		iassert(m_state.color != ColorFamily::GREY);
-		check_is_444_float(false);
+		if (params.unresize || needs_colorspace(target) || m_state.color != target.color)
+			return false;
+		// Chroma is resized in the same filter as luma.
+		if (m_state.color == ColorFamily::YUV && params.filter_uv != params.filter)
+			return false;
 
-		if (m_state.colorspace == csp)
-			return;
+		plane_mask mask = m_state.has_chroma() ? luma_planes | chroma_planes : luma_planes;
+		bool supported = true;
+
+		// Color planes must be FLOAT and all planes must be sited identically.
+		apply_mask(mask | alpha_planes, [&](int p)
+		{
+			internal_state::plane plane = m_state.planes[p];
+			plane.format = m_state.planes[PLANE_Y].format;
+
+			supported = supported && plane == m_state.planes[PLANE_Y];
+			supported = supported && (p == PLANE_A || m_state.planes[p].format.type == PixelType::FLOAT);
+		});
+
+		return supported && needs_resize_plane(target, PLANE_Y);
+	}
+
+	// Resize all planes to |target| and unpremultiply as part of the last pass.
+	bool resize_unpremultiply(const internal_state &target, const params &params, FilterObserver &observer)
+	{
+		iassert(m_state.alpha == AlphaType::PREMULTIPLIED);
+
+		if (!can_resize_unpremultiply(target, params))
+			return false;
+
+		plane_mask mask = m_state.has_chroma() ? luma_planes | chroma_planes : luma_planes;
+		unsigned num_planes = m_state.has_chroma() ? 3 : 1;
+
+		const internal_state::plane &src_plane = m_state.planes[PLANE_Y];
+		const internal_state::plane &dst_plane = target.planes[PLANE_Y];
+		auto [shift_w, shift_h, subwidth, subheight] = map_active_region(src_plane, dst_plane);
+
+		resize::ResizeConversion conv{ src_plane.width, src_plane.height, PixelType::FLOAT };
+		conv.set_depth(src_plane.format.depth)
+			.set_filter(params.filter)
+			.set_dst_width(dst_plane.width)
+			.set_dst_height(dst_plane.height)
+			.set_shift_w(shift_w)
+			.set_shift_h(shift_h)
+			.set_subwidth(subwidth)
+			.set_subheight(subheight)
+			.set_cpu(params.cpu)
+			.set_color_planes(num_planes)
+			.set_unpremultiply(true);
+
+		// The alpha plane saved by a deferred premultiplication is already FLOAT.
+		bool premultiply = premultiply_pending(mask) && conv.premultiply_supported();
+		graphengine::node_dep_desc alpha = m_premul_alpha;
+
+		if (premultiply) {
+			conv.set_premultiply(true);
+		} else {
+			flush_premultiply(mask);
+			convert_pixel_format(target.planes[PLANE_A].format, params, observer, alpha_planes, PLANE_A);
+			alpha = m_ids[PLANE_A];
+		}
+
+		observer.resize(conv, PLANE_Y);
+		if (m_state.color == ColorFamily::YUV)
+			observer.resize(conv, PLANE_U);
+		observer.resize(conv, PLANE_A);
+		observer.unpremultiply();
+
+		auto filter_list = conv.create();
+		iassert(filter_list.first);
+
+		graphengine::node_id id = attach_alpha_filter(m_graph.save_filter(std::move(filter_list.first)), mask, alpha);
+		if (filter_list.second)
+			id = attach_alpha_filter(m_graph.save_filter(std::move(filter_list.second)), mask, { id, num_planes });
+		m_ids[PLANE_A] = { id, num_planes };
 
+		apply_mask(mask, [&](int q)
+		{
+			PixelFormat format = m_state.planes[q].format;
+			m_state.planes[q] = target.planes[q];
+			m_state.planes[q].format = format;
+		});
+		m_state.planes[PLANE_A] = target.planes[PLANE_A];
+		m_state.alpha = AlphaType::STRAIGHT;
+		return true;
+	}
+
+	colorspace::ColorspaceConversion make_colorspace_conversion(const colorspace::ColorspaceDefinition &csp, const params &params)
+	{
 		colorspace::ColorspaceConversion conv{ m_state.planes[0].width, m_state.planes[0].height };
 		conv.set_csp_in(m_state.colorspace)
 			.set_csp_out(csp)
 			.set_approximate_gamma(params.approximate_gamma)
 			.set_scene_referred(params.scene_referred)
+			.set_use_lut(params.colorspace_lut)
 			.set_cpu(params.cpu);
 		if (!std::isnan(params.peak_luminance))
 			conv.set_peak_luminance(params.peak_luminance);
+		return conv;
+	}
 
+	void convert_colorspace(const colorspace::ColorspaceDefinition &csp, const params &params, FilterObserver &observer)
+	{
+		iassert(m_state.color != ColorFamily::GREY);
+		check_is_444_float(false);
+
+		if (m_state.colorspace == csp)
+			return;
+
+		colorspace::ColorspaceConversion conv = make_colorspace_conversion(csp, params);
 		observer.colorspace(conv);
 
 		auto filter = conv.create();
 		if (filter) {
+			flush_premultiply(luma_planes | chroma_planes);
 			graphengine::node_id id = m_graph.add_transform(m_graph.save_filter(std::move(filter)), m_ids.data());
 			m_ids[PLANE_Y] = { id, 0 };
 			m_ids[PLANE_U] = { id, 1 };
@@ -862,9 +1178,136 @@ private:
 		m_state.colorspace = csp;
 	}
 
-	void convert_pixel_format(const PixelFormat &format, const params &params, FilterObserver &observer, plane_mask mask, int p)
+	bool can_upsample_yuv_to_rgb(const internal_state &target, const colorspace::ColorspaceDefinition &csp, const params &params)
+	{
+		if (m_state.color != ColorFamily::YUV || csp.matrix != colorspace::MatrixCoefficients::RGB)
+			return false;
+		if (m_state.colorspace.transfer != csp.transfer || m_state.colorspace.primaries != csp.primaries)
+			return false;
+
+		switch (m_state.colorspace.matrix) {
+		case colorspace::MatrixCoefficients::REC_601:
+		case colorspace::MatrixCoefficients::REC_709:
+		case colorspace::MatrixCoefficients::FCC:
+		case colorspace::MatrixCoefficients::SMPTE_240M:
+		case colorspace::MatrixCoefficients::YCGCO:
+		case colorspace::MatrixCoefficients::REC_2020_NCL:
+		case colorspace::MatrixCoefficients::CHROMATICITY_DERIVED_NCL:
+			break;
+		default:
+			return false;
+		}
+
+		if (params.unresize)
+			return false;
+		if (!dynamic_cast<const resize::BilinearFilter *>(params.filter_uv) && !dynamic_cast<const resize::BicubicFilter *>(params.filter_uv))
+			return false;
+
+		if (!pixel_is_integer(m_state.planes[PLANE_Y].format.type) || !pixel_is_integer(m_state.planes[PLANE_U].format.type))
+			return false;
+
+		// Luma must already be at the working resolution.
+		if (needs_resize_plane(target, PLANE_Y) || !needs_resize_plane(target, PLANE_U))
+			return false;
+
+		// Chroma must be upsampled by at most 2:1 in each direction.
+		double ratio_w = target.planes[PLANE_U].active_width / m_state.planes[PLANE_U].active_width;
+		double ratio_h = target.planes[PLANE_U].active_height / m_state.planes[PLANE_U].active_height;
+
+		return (ratio_w == 1.0 || ratio_w == 2.0) && (ratio_h == 1.0 || ratio_h == 2.0);
+	}
+
+	bool upsample_yuv_to_rgb(const internal_state &target, const colorspace::ColorspaceDefinition &csp, const params &params, FilterObserver &observer)
+	{
+		const internal_state::plane &src_plane = m_state.planes[PLANE_U];
+		const internal_state::plane &dst_plane = target.planes[PLANE_U];
+		auto [shift_w, shift_h, subwidth, subheight] = map_active_region(src_plane, dst_plane);
+
+		colorspace::Matrix3x3 m = m_state.colorspace.matrix == colorspace::MatrixCoefficients::CHROMATICITY_DERIVED_NCL ?
+			colorspace::ncl_yuv_to_rgb_matrix_from_primaries(m_state.colorspace.primaries) :
+			colorspace::ncl_yuv_to_rgb_matrix(m_state.colorspace.matrix);
+
+		auto upsample = create_chroma_upsample(*params.filter_uv, src_plane.format, src_plane.width, src_plane.height,
+			dst_plane.width, dst_plane.height, shift_w, shift_h, subwidth, subheight, params.cpu);
+		auto matrix = create_yuv_to_rgb(m, m_state.planes[PLANE_Y].format, m_state.planes[PLANE_Y].width, m_state.planes[PLANE_Y].height, params.cpu);
+		if (!upsample || !matrix)
+			return false;
+
+		observer.upsample_yuv_to_rgb();
+
+		flush_premultiply(luma_planes | chroma_planes);
+
+		graphengine::node_id chroma_id = m_graph.add_transform(m_graph.save_filter(std::move(upsample)), &m_ids[PLANE_U]);
+
+		graphengine::node_dep_desc deps[3] = { m_ids[PLANE_Y], { chroma_id, 0 }, { chroma_id, 1 } };
+		graphengine::node_id id = m_graph.add_transform(m_graph.save_filter(std::move(matrix)), deps);
+
+		m_ids[PLANE_Y] = { id, 0 };
+		m_ids[PLANE_U] = { id, 1 };
+		m_ids[PLANE_V] = { id, 2 };
+
+		m_state.planes[PLANE_Y] = target.planes[PLANE_Y];
+		m_state.planes[PLANE_U] = target.planes[PLANE_U];
+		m_state.planes[PLANE_V] = target.planes[PLANE_V];
+		m_state.planes[PLANE_U].format.chroma = false;
+		m_state.planes[PLANE_V].format.chroma = false;
+		m_state.color = ColorFamily::RGB;
+		m_state.colorspace = csp;
+		return true;
+	}
+
+	bool can_convert_colorspace_int(const internal_state &target, const params &params)
+	{
+		if (!m_state.has_chroma() || !target.has_chroma())
+			return false;
+		if (params.dither_type != depth::DitherType::NONE)
+			return false;
+
+		// Chroma must already be sited on the luma grid.
+		for (int p : { PLANE_U, PLANE_V }) {
+			internal_state::plane plane = m_state.planes[p];
+			plane.format = m_state.planes[PLANE_Y].format;
+
+			if (plane != m_state.planes[PLANE_Y])
+				return false;
+		}
+
+		return !needs_resize_plane(target, PLANE_Y) && !needs_resize_plane(target, PLANE_U) && !needs_resize_plane(target, PLANE_V);
+	}
+
+	bool convert_colorspace_int(const internal_state &target, const params &params, FilterObserver &observer)
+	{
+		if (!can_convert_colorspace_int(target, params))
+			return false;
+
+		const PixelFormat format_in[3] = { m_state.planes[PLANE_Y].format, m_state.planes[PLANE_U].format, m_state.planes[PLANE_V].format };
+		const PixelFormat format_out[3] = { target.planes[PLANE_Y].format, target.planes[PLANE_U].format, target.planes[PLANE_V].format };
+
+		auto filter = colorspace::create_matrix_int_filter(m_state.colorspace, target.colorspace, format_in, format_out,
+			m_state.planes[PLANE_Y].width, m_state.planes[PLANE_Y].height, params.cpu);
+		if (!filter)
+			return false;
+
+		observer.matrix_int();
+
+		flush_premultiply(luma_planes | chroma_planes);
+		graphengine::node_id id = m_graph.add_transform(m_graph.save_filter(std::move(filter)), m_ids.data());
+		m_ids[PLANE_Y] = { id, 0 };
+		m_ids[PLANE_U] = { id, 1 };
+		m_ids[PLANE_V] = { id, 2 };
+
+		m_state.planes[PLANE_Y] = target.planes[PLANE_Y];
+		m_state.planes[PLANE_U] = target.planes[PLANE_U];
+		m_state.planes[PLANE_V] = target.planes[PLANE_V];
+		m_state.color = target.color;
+		m_state.colorspace = target.colorspace;
+		return true;
+	}
+
+	void convert_pixel_format(const PixelFormat &format, const params &params, FilterObserver &observer, plane_mask mask, int p,
+	                          const depth::Transfer &transfer = {})
 	{
-		if (m_state.planes[p].format == format)
+		if (m_state.planes[p].format == format && !transfer.func)
 			return;
 
 		depth::DepthConversion conv{ m_state.planes[p].width, m_state.planes[p].height };
@@ -872,11 +1315,13 @@ private:
 			.set_pixel_out(format)
 			.set_dither_type(params.dither_type)
 			.set_planes(mask)
-			.set_cpu(params.cpu);
+			.set_cpu(params.cpu)
+			.set_transfer(transfer);
 
 		observer.depth(conv, p);
 
 		auto result = conv.create();
+		flush_premultiply(mask);
 		apply_mask(mask, [&](int q)
 		{
 			if (result.filter_refs[q])
@@ -956,6 +1401,35 @@ private:
 		iassert(m_state.planes[p] == target.planes[p]);
 	}
 
+	// Halve a plane with a DecimateFilter if the plane is sited identically at
+	// both scales. Otherwise fall back to the general resizer.
+	void decimate_plane(const internal_state &target, const params &params, FilterObserver &observer, ConnectMode mode)
+	{
+		int p = mode == ConnectMode::LUMA ? PLANE_Y : mode == ConnectMode::CHROMA ? PLANE_U : PLANE_A;
+		plane_mask mask = mode == ConnectMode::LUMA ? (m_state.color == ColorFamily::RGB ? luma_planes | chroma_planes : luma_planes) :
+		                  mode == ConnectMode::CHROMA ? chroma_planes : alpha_planes;
+
+		const internal_state::plane &src_plane = m_state.planes[p];
+		const internal_state::plane &dst_plane = target.planes[p];
+		auto [shift_w, shift_h, subwidth, subheight] = map_active_region(src_plane, dst_plane);
+
+		bool direct = src_plane.format == dst_plane.format &&
+			src_plane.format.type != PixelType::HALF &&
+			src_plane.width == dst_plane.width * 2 &&
+			src_plane.height == dst_plane.height * 2 &&
+			shift_w == 0 && shift_h == 0 &&
+			subwidth == src_plane.width && subheight == src_plane.height;
+
+		if (!direct) {
+			connect_plane(target, params, observer, mode, false);
+			return;
+		}
+
+		auto filter = std::make_unique<resize::DecimateFilter>(src_plane.width, src_plane.height, src_plane.format.type, params.cpu);
+		attach_greyscale_filter(m_graph.save_filter(std::move(filter)), mask);
+		apply_mask(mask, [&](int q) { m_state.planes[q] = target.planes[q]; });
+	}
+
 	void connect_color_channels_planar(const internal_state &target, const params &params, FilterObserver &observer, bool reinterpret_range)
 	{
 		connect_plane(target, params, observer, ConnectMode::LUMA, reinterpret_range);
@@ -964,9 +1438,53 @@ private:
 			connect_plane(target, params, observer, ConnectMode::CHROMA, reinterpret_range);
 	}
 
+	// Linearize integer RGB while converting it to float, if the colorspace
+	// conversion to |csp| would begin by linearizing the input.
+	bool convert_to_linear_float(const internal_state &target, const colorspace::ColorspaceDefinition &csp, const params &params, FilterObserver &observer)
+	{
+		const PixelFormat &format = m_state.planes[PLANE_Y].format;
+		colorspace::TransferFunction func;
+
+		// Larger tables no longer fit in L1.
+		if (m_state.color != ColorFamily::RGB || !pixel_is_integer(format.type) || format.depth > 10)
+			return false;
+		if (needs_resize_plane(target, PLANE_Y))
+			return false;
+		if (!make_colorspace_conversion(csp, params).get_input_transfer(&func))
+			return false;
+
+		convert_pixel_format(target.planes[PLANE_Y].format, params, observer, luma_planes | chroma_planes, PLANE_Y, { func.to_linear, 1.0f, func.to_linear_scale });
+		m_state.colorspace = m_state.colorspace.to_linear();
+		return true;
+	}
+
+	// Apply the output transfer function while quantizing linear RGB to
+	// integer, if the colorspace conversion would end by encoding the output.
+	bool convert_from_linear_float(const internal_state &target, const params &params, FilterObserver &observer)
+	{
+		const PixelFormat &format = target.planes[PLANE_Y].format;
+		colorspace::TransferFunction func;
+
+		if (target.color != ColorFamily::RGB || !pixel_is_integer(format.type))
+			return false;
+		if (needs_resize_plane(target, PLANE_Y))
+			return false;
+		// Approximate gamma is already vectorized in the colorspace filter.
+		if (params.dither_type == depth::DitherType::ERROR_DIFFUSION || params.approximate_gamma)
+			return false;
+		if (!make_colorspace_conversion(target.colorspace, params).get_output_transfer(&func))
+			return false;
+
+		convert_colorspace(target.colorspace.to_linear(), params, observer);
+		convert_pixel_format(format, params, observer, luma_planes | chroma_planes, PLANE_Y, { func.to_gamma, func.to_gamma_scale, 1.0f });
+		m_state.colorspace = target.colorspace;
+		return true;
+	}
+
 	void connect_color_channels(const internal_state &target, const params &params, FilterObserver &observer)
 	{
-		if (needs_colorspace(target)) {
+		// Integer planes which only change matrix are converted in fixed point.
+		if (needs_colorspace(target) && !convert_colorspace_int(target, params, observer)) {
 			internal_state tmp = make_float_444_state(m_state, false);
 
 			const internal_state &w = m_state.planes[PLANE_Y].width < target.planes[PLANE_Y].width ? m_state : target;
@@ -982,7 +1500,12 @@ private:
 			if (tmp.has_chroma())
 				tmp.chroma_from_luma_444();
 
-			connect_color_channels_planar(tmp, params, observer, false);
+			// Subsampled integer YUV can be converted to RGB without intermediate planes at either resolution.
+			// Otherwise, integer RGB may be linearized as part of the conversion to float.
+			if (!can_upsample_yuv_to_rgb(tmp, target.colorspace, params) || !upsample_yuv_to_rgb(tmp, target.colorspace, params, observer)) {
+				convert_to_linear_float(tmp, target.colorspace, params, observer);
+				connect_color_channels_planar(tmp, params, observer, false);
+			}
 
 			if (!m_state.has_chroma()) {
 				colorspace::MatrixCoefficients matrix =
@@ -990,7 +1513,8 @@ private:
 				grey_to_rgb(matrix, observer);
 			}
 
-			convert_colorspace(target.colorspace, params, observer);
+			if (!convert_from_linear_float(target, params, observer))
+				convert_colorspace(target.colorspace, params, observer);
 			iassert(m_state.colorspace == target.colorspace);
 		}
 
@@ -1028,7 +1552,7 @@ private:
 			connect_color_channels(tmp, params, observer);
 			connect_plane(tmp, params, observer, ConnectMode::ALPHA, false);
 
-			premultiply(observer);
+			premultiply(params, observer);
 
 			if (target.has_alpha() && target.planes[PLANE_A] == orig_alpha_plane) {
 				m_ids[PLANE_A] = orig_alpha_node;
@@ -1047,10 +1571,13 @@ private:
 			graphengine::node_dep_desc orig_alpha_node = m_ids[PLANE_A];
 
 			internal_state tmp = make_float_444_state(target, true);
-			connect_color_channels(tmp, params, observer);
-			connect_plane(tmp, params, observer, ConnectMode::ALPHA, false);
 
-			unpremultiply(observer);
+			if (!resize_unpremultiply(tmp, params, observer)) {
+				connect_color_channels(tmp, params, observer);
+				connect_plane(tmp, params, observer, ConnectMode::ALPHA, false);
+
+				unpremultiply(params, observer);
+			}
 
 			if (target.has_alpha() && target.planes[PLANE_A] == orig_alpha_plane) {
 				m_ids[PLANE_A] = orig_alpha_node;
@@ -1067,14 +1594,251 @@ private:
 		if (!m_state.has_alpha() && target.has_alpha())
 			add_opaque_alpha(target.alpha, observer);
 
+		flush_premultiply(luma_planes | chroma_planes);
+
 		if (m_state != target)
 			error::throw_<error::InternalError>("failed to connect graph");
 	}
+
+	// Intermediate state on the way to every target, up to the first of the
+	// colorspace, resolution and depth stages in which the targets differ.
+	internal_state make_shared_state(const internal_state targets[], unsigned num_targets, const params &params)
+	{
+		const internal_state &first = targets[0];
+
+		auto all_targets = [&](auto pred) { return std::all_of(targets, targets + num_targets, pred); };
+		auto same_geometry = [](internal_state::plane lhs, const internal_state::plane &rhs) { lhs.format = rhs.format; return lhs == rhs; };
+
+		// Alpha is premultiplied around the stages of each target.
+		if (m_state.has_alpha() || !m_state.has_chroma() || !first.has_chroma())
+			return m_state;
+		if (!all_targets([&](const internal_state &t) { return t.color == first.color && t.colorspace == first.colorspace; }))
+			return m_state;
+		if (!needs_colorspace(first) || can_convert_colorspace_int(first, params))
+			return m_state;
+
+		bool shared_resolution = all_targets([&](const internal_state &t)
+		{
+			return same_geometry(t.planes[PLANE_Y], first.planes[PLANE_Y]) && same_geometry(t.planes[PLANE_U], first.planes[PLANE_U]);
+		});
+		bool shared_depth = shared_resolution && all_targets([&](const internal_state &t)
+		{
+			return t.planes[PLANE_Y].format == first.planes[PLANE_Y].format && t.planes[PLANE_U].format == first.planes[PLANE_U].format;
+		});
+
+		bool no_downscale = all_targets([&](const internal_state &t)
+		{
+			return t.planes[PLANE_Y].width >= m_state.planes[PLANE_Y].width && t.planes[PLANE_Y].height >= m_state.planes[PLANE_Y].height;
+		});
+
+		// Targets of different resolutions share a float conversion at the source
+		// resolution. Each target then resizes full-resolution float planes, which
+		// is slower than separate conversions if any target is downscaled.
+		if (!shared_resolution && !no_downscale)
+			return m_state;
+
+		internal_state shared = shared_resolution ? first : m_state;
+		shared.color = first.color;
+		shared.colorspace = first.colorspace;
+		shared.alpha = AlphaType::NONE;
+
+		return shared_depth ? shared : make_float_444_state(shared, false);
+	}
+
+	graphengine::node_id add_deinterleave(graphengine::node_dep_desc dep, unsigned width, unsigned height, unsigned num_components, const int component_map[], CPUClass cpu)
+	{
+		auto filter = std::make_unique<DeinterleaveFilter>(width, height, m_source_state.type, num_components, component_map, cpu);
+		return m_graph.add_transform(m_graph.save_filter(std::move(filter)), &dep);
+	}
+
+	graphengine::node_dep_desc add_interleave(const graphengine::node_dep_desc deps[], unsigned num_inputs, unsigned width, unsigned height,
+	                                          unsigned num_components, const int component_map[], CPUClass cpu)
+	{
+		auto filter = std::make_unique<InterleaveFilter>(width, height, m_state.planes[PLANE_Y].format.type, num_inputs, num_components, component_map, cpu);
+		return{ m_graph.add_transform(m_graph.save_filter(std::move(filter)), deps), 0 };
+	}
+
+	void unpack_source(CPUClass cpu)
+	{
+		const state &source = m_source_state;
+		Layout layout = source.layout;
+		graphengine::node_dep_desc packed = { m_graph.source_id(PLANE_Y), 0 };
+
+		if (layout == Layout::SEMIPLANAR) {
+			static constexpr int map[2] = { 0, 1 };
+			graphengine::node_id id = add_deinterleave({ m_graph.source_id(PLANE_U), 0 }, source.width >> source.subsample_w, source.height >> source.subsample_h, 2, map, cpu);
+
+			m_ids[PLANE_Y] = packed;
+			m_ids[PLANE_U] = { id, 0 };
+			m_ids[PLANE_V] = { id, 1 };
+			if (m_state.has_alpha())
+				m_ids[PLANE_A] = { m_graph.source_id(PLANE_A), 0 };
+		} else if (is_packed_layout(layout)) {
+			unsigned n = num_components(source);
+			int map[PLANE_NUM] = { 0, 1, 2, 3 };
+
+			if (n == 1) {
+				m_ids[PLANE_Y] = packed;
+				m_source_unpacked = true;
+				return;
+			}
+			if (layout == Layout::PACKED_BGR)
+				std::swap(map[0], map[2]);
+
+			graphengine::node_id id = add_deinterleave(packed, source.width, source.height, n, map, cpu);
+			m_ids[PLANE_Y] = { id, 0 };
+			if (m_state.has_chroma()) {
+				m_ids[PLANE_U] = { id, 1 };
+				m_ids[PLANE_V] = { id, 2 };
+			}
+			if (m_state.has_alpha())
+				m_ids[PLANE_A] = { id, n - 1 };
+		} else if (is_packed_422_layout(layout)) {
+			static constexpr int luma_map_yuyv[2] = { 0, -1 };
+			static constexpr int luma_map_uyvy[2] = { -1, 0 };
+			static constexpr int chroma_map_yuyv[4] = { -1, 0, -1, 1 };
+			static constexpr int chroma_map_uyvy[4] = { 0, -1, 1, -1 };
+			bool yuyv = layout == Layout::YUYV;
+
+			graphengine::node_id luma_id = add_deinterleave(packed, source.width, source.height, 2, yuyv ? luma_map_yuyv : luma_map_uyvy, cpu);
+			graphengine::node_id chroma_id = add_deinterleave(packed, source.width / 2, source.height, 4, yuyv ? chroma_map_yuyv : chroma_map_uyvy, cpu);
+
+			m_ids[PLANE_Y] = { luma_id, 0 };
+			m_ids[PLANE_U] = { chroma_id, 0 };
+			m_ids[PLANE_V] = { chroma_id, 1 };
+		}
+
+		m_source_unpacked = true;
+	}
+
+	unsigned pack_sink(graphengine::node_dep_desc deps[], unsigned api_planes[])
+	{
+		Layout layout = m_sink_layout;
+		unsigned width = m_state.planes[PLANE_Y].width;
+		unsigned height = m_state.planes[PLANE_Y].height;
+		unsigned n = 0;
+
+		auto add_plane = [&](unsigned index, graphengine::node_dep_desc dep)
+		{
+			deps[n] = dep;
+			api_planes[n] = index;
+			++n;
+		};
+
+		if (layout == Layout::SEMIPLANAR) {
+			static constexpr int map[2] = { 0, 1 };
+
+			add_plane(PLANE_Y, m_ids[PLANE_Y]);
+			add_plane(PLANE_U, add_interleave(&m_ids[PLANE_U], 2, m_state.planes[PLANE_U].width, m_state.planes[PLANE_U].height, 2, map, m_cpu));
+			if (m_state.has_alpha())
+				add_plane(PLANE_A, m_ids[PLANE_A]);
+		} else if (is_packed_layout(layout) && (m_state.has_chroma() || m_state.has_alpha())) {
+			graphengine::node_dep_desc inputs[PLANE_NUM];
+			int map[PLANE_NUM] = { 0, 1, 2, 3 };
+			unsigned num_inputs = 0;
+
+			inputs[num_inputs++] = m_ids[PLANE_Y];
+			if (m_state.has_chroma()) {
+				inputs[num_inputs++] = m_ids[PLANE_U];
+				inputs[num_inputs++] = m_ids[PLANE_V];
+			}
+			if (m_state.has_alpha())
+				inputs[num_inputs++] = m_ids[PLANE_A];
+			if (layout == Layout::PACKED_BGR)
+				std::swap(map[0], map[2]);
+
+			add_plane(PLANE_Y, add_interleave(inputs, num_inputs, width, height, num_inputs, map, m_cpu));
+		} else if (is_packed_422_layout(layout)) {
+			// Interleave U-V first, so that both inputs of the final pass have the same width.
+			static constexpr int chroma_map[2] = { 0, 1 };
+			static constexpr int map_yuyv[2] = { 0, 1 };
+			static constexpr int map_uyvy[2] = { 1, 0 };
+
+			graphengine::node_dep_desc inputs[2] = { m_ids[PLANE_Y] };
+			inputs[1] = add_interleave(&m_ids[PLANE_U], 2, width / 2, height, 2, chroma_map, m_cpu);
+			add_plane(PLANE_Y, add_interleave(inputs, 2, width, height, 2, layout == Layout::YUYV ? map_yuyv : map_uyvy, m_cpu));
+		} else {
+			add_plane(PLANE_Y, m_ids[PLANE_Y]);
+			if (m_state.has_chroma()) {
+				add_plane(PLANE_U, m_ids[PLANE_U]);
+				add_plane(PLANE_V, m_ids[PLANE_V]);
+			}
+			if (m_state.has_alpha())
+				add_plane(PLANE_A, m_ids[PLANE_A]);
+		}
+
+		return n;
+	}
+
+	struct sink_list {
+		std::array<graphengine::node_dep_desc, graphengine::NODE_MAX_PLANES> deps;
+		std::array<graphengine::node_id, graphengine::NODE_MAX_PLANES> ids;
+		std::array<unsigned, graphengine::NODE_MAX_PLANES> planes;
+		unsigned num_planes;
+	};
+
+	// Add sink nodes for the current format.
+	sink_list add_sink()
+	{
+		sink_list sink{};
+		std::fill(sink.deps.begin(), sink.deps.end(), graphengine::null_dep);
+		std::fill(sink.ids.begin(), sink.ids.end(), graphengine::null_node);
+
+		sink.num_planes = pack_sink(sink.deps.data(), sink.planes.data());
+		m_graph.add_sink(sink.num_planes, sink.deps.data(), sink.ids.data());
+		return sink;
+	}
+
+	std::unique_ptr<SubGraph> release_subgraph(const std::vector<sink_list> &sinks)
+	{
+		// Count input planes.
+		std::array<graphengine::PlaneDescriptor, graphengine::NODE_MAX_PLANES> source_desc{};
+		std::array<graphengine::node_id, graphengine::NODE_MAX_PLANES> source_ids;
+		std::array<unsigned, graphengine::NODE_MAX_PLANES> source_planes{};
+		std::fill(source_ids.begin(), source_ids.end(), graphengine::null_node);
+
+		unsigned num_source_planes = get_buffer_planes(m_source_state, source_desc.data(), source_planes.data());
+		for (unsigned p = 0; p < num_source_planes; ++p) {
+			source_ids[p] = m_graph.source_id(source_planes[p]);
+		}
+
+		// The band executor drives a single sink.
+		bool single_output = sinks.size() == 1;
+		if (single_output)
+			m_graph.set_band_endpoints(num_source_planes, source_ids.data(), source_desc.data(), sinks.front().num_planes, sinks.front().deps.data());
+
+		std::unique_ptr<graphengine::SubGraph> subgraph;
+		std::shared_ptr<void> opaque;
+		std::shared_ptr<const BandExecutor> executor;
+		std::shared_ptr<GraphProfile> profile = m_graph.profile();
+		std::tie(subgraph, opaque, executor) = m_graph.release();
+
+		bool requires_64b = m_requires_64b;
+		*this = impl();
+
+		auto ret = std::make_unique<SubGraph>(std::move(subgraph), std::move(opaque), source_desc, source_ids, sinks.front().ids);
+		ret->set_buffer_planes(source_planes, sinks.front().planes);
+		for (size_t i = 1; i < sinks.size(); ++i) {
+			ret->add_output(sinks[i].ids, sinks[i].planes);
+		}
+		if (single_output)
+			ret->set_band_executor(std::move(executor));
+		ret->set_profile(std::move(profile));
+		if (requires_64b)
+			ret->set_requires_64b_alignment();
+		return ret;
+	}
 public:
 	impl() :
 		m_ids(),
+		m_premul_pending{},
+		m_premul_alpha{ graphengine::null_dep },
+		m_premul_filter{},
 		m_source_state{},
 		m_state{},
+		m_sink_layout{},
+		m_cpu{ CPUClass::AUTO },
+		m_source_unpacked{},
 		m_requires_64b{}
 	{
 		std::fill(m_ids.begin(), m_ids.end(), graphengine::null_dep);
@@ -1087,8 +1851,13 @@ public:
 
 		m_source_state = source;
 		m_state = internal_state{ source };
+		m_sink_layout = source.layout;
 		m_requires_64b = false;
 
+		// Interleaved sources are split on the first connection, once the CPU type is known.
+		if (source.layout != Layout::PLANAR)
+			return;
+
 		m_ids[PLANE_Y] = { m_graph.source_id(PLANE_Y), 0 };
 		if (m_state.has_chroma()) {
 			m_ids[PLANE_U] = { m_graph.source_id(PLANE_U), 0 };
@@ -1096,6 +1865,7 @@ public:
 		}
 		if (m_state.has_alpha())
 			m_ids[PLANE_A] = { m_graph.source_id(PLANE_A), 0 };
+		m_source_unpacked = true;
 	}
 
 	void connect(const state &target, const params &params, FilterObserver &observer)
@@ -1103,9 +1873,18 @@ public:
 		if (!m_state.planes[0].width)
 			error::throw_<error::InternalError>("graph not initialized");
 
+		if (params.profile)
+			m_graph.enable_profiling();
+
+		if (!m_source_unpacked)
+			unpack_source(params.cpu);
+
 		internal_state internal_target{ target };
 		connect_internal(internal_target, params, observer);
 
+		m_sink_layout = target.layout;
+		m_cpu = params.cpu;
+
 #ifdef ZIMG_X86
 		if (params.cpu == CPUClass::AUTO_64B || params.cpu >= CPUClass::X86_AVX512)
 			m_requires_64b = true;
@@ -1117,69 +1896,102 @@ public:
 		if (!m_state.planes[0].width)
 			error::throw_<error::InternalError>("graph not initialized");
 
-		// Count input planes.
-		std::array<graphengine::PlaneDescriptor, graphengine::NODE_MAX_PLANES> source_desc{};
-		std::array<graphengine::node_id, graphengine::NODE_MAX_PLANES> source_ids;
-		std::fill(source_ids.begin(), source_ids.end(), graphengine::null_node);
+		if (!m_source_unpacked)
+			unpack_source(m_cpu);
 
-		{
-			auto source_desc_it = source_desc.begin();
-			auto source_ids_it = source_ids.begin();
-
-			*source_desc_it++ = { m_source_state.width, m_source_state.height, zimg::pixel_size(m_source_state.type) };
-			*source_ids_it++ = m_graph.source_id(PLANE_Y);
-			if (m_source_state.color != ColorFamily::GREY) {
-				*source_desc_it++ = { m_source_state.width >> m_source_state.subsample_w, m_source_state.height >> m_source_state.subsample_h, zimg::pixel_size(m_source_state.type) };
-				*source_desc_it++ = { m_source_state.width >> m_source_state.subsample_w, m_source_state.height >> m_source_state.subsample_h, zimg::pixel_size(m_source_state.type) };
-				*source_ids_it++ = m_graph.source_id(PLANE_U);
-				*source_ids_it++ = m_graph.source_id(PLANE_V);
-			}
-			if (m_source_state.alpha != AlphaType::NONE) {
-				*source_desc_it++ = { m_source_state.width, m_source_state.height, zimg::pixel_size(m_source_state.type) };
-				*source_ids_it++ = m_graph.source_id(PLANE_A);
-			}
-		}
+		return release_subgraph({ add_sink() });
+	}
 
-		// Count output planes.
-		std::array<graphengine::node_dep_desc, graphengine::NODE_MAX_PLANES> sink_deps;
-		std::fill(sink_deps.begin(), sink_deps.end(), graphengine::null_dep);
+	std::unique_ptr<SubGraph> build_multi_subgraph(const state targets[], unsigned num_targets, const params &params, FilterObserver &observer)
+	{
+		if (!m_state.planes[0].width)
+			error::throw_<error::InternalError>("graph not initialized");
 
-		unsigned num_sink_deps;
-		{
-			auto sink_deps_it = sink_deps.begin();
+		if (!m_source_unpacked)
+			unpack_source(params.cpu);
 
-			*sink_deps_it++ = m_ids[PLANE_Y];
-			if (m_state.has_chroma()) {
-				*sink_deps_it++ = m_ids[PLANE_U];
-				*sink_deps_it++ = m_ids[PLANE_V];
-			}
-			if (m_state.has_alpha())
-				*sink_deps_it++ = m_ids[PLANE_A];
+		if (params.profile)
+			m_graph.enable_profiling();
 
-			num_sink_deps = static_cast<unsigned>(sink_deps_it - sink_deps.begin());
-		}
+		// Connect the stages common to all targets once, then branch from
+		// the last shared node.
+		std::vector<internal_state> internal_targets(targets, targets + num_targets);
+		internal_state shared = make_shared_state(internal_targets.data(), num_targets, params);
+
+		if (shared != m_state)
+			connect_internal(shared, params, observer);
 
-		// Set sink planes.
-		m_graph.set_sink(num_sink_deps, sink_deps.data());
+		std::array<graphengine::node_dep_desc, PLANE_NUM> branch_ids = m_ids;
+		internal_state branch_state = m_state;
+		std::vector<sink_list> sinks;
 
-		std::array<graphengine::node_id, graphengine::NODE_MAX_PLANES> sink_ids;
-		std::fill(sink_ids.begin(), sink_ids.end(), graphengine::null_node);
+		for (unsigned i = 0; i < num_targets; ++i) {
+			m_ids = branch_ids;
+			m_state = branch_state;
 
-		for (unsigned p = 0; p < num_sink_deps; ++p) {
-			sink_ids[p] = m_graph.sink_id(p);
+			connect(targets[i], params, observer);
+			sinks.push_back(add_sink());
 		}
 
-		std::unique_ptr<graphengine::SubGraph> subgraph;
-		std::shared_ptr<void> opaque;
-		std::tie(subgraph, opaque) = m_graph.release();
+		return release_subgraph(sinks);
+	}
 
-		bool requires_64b = m_requires_64b;
-		*this = impl();
+	std::unique_ptr<SubGraph> build_pyramid_subgraph(unsigned num_levels, const params &params, FilterObserver &observer)
+	{
+		static const resize::BilinearFilter bilinear;
 
-		auto ret = std::make_unique<SubGraph>(std::move(subgraph), std::move(opaque), source_desc, source_ids, sink_ids);
-		if (requires_64b)
-			ret->set_requires_64b_alignment();
-		return ret;
+		if (!m_state.planes[0].width)
+			error::throw_<error::InternalError>("graph not initialized");
+
+		const state &source = m_source_state;
+		if (m_state != internal_state{ source })
+			error::throw_<error::InternalError>("image pyramid requires an unconnected graph");
+		if (source.active_left != 0 || source.active_top != 0 || source.active_width != source.width || source.active_height != source.height)
+			error::throw_<error::ResamplingNotAvailable>("image pyramid not supported for given subregion");
+
+		if (params.profile)
+			m_graph.enable_profiling();
+
+		if (!m_source_unpacked)
+			unpack_source(params.cpu);
+
+		m_cpu = params.cpu;
+#ifdef ZIMG_X86
+		if (params.cpu == CPUClass::AUTO_64B || params.cpu >= CPUClass::X86_AVX512)
+			m_requires_64b = true;
+#endif
+
+		// Planes that can not be decimated directly use the equivalent bilinear resize.
+		GraphBuilder::params fallback_params = params;
+		fallback_params.filter = &bilinear;
+		fallback_params.filter_uv = &bilinear;
+
+		// Each level is computed from the previous one, so that the total work
+		// is bounded by 4/3 of the first level.
+		state level = source;
+		std::vector<sink_list> sinks;
+
+		for (unsigned i = 0; i < num_levels; ++i) {
+			level.width = ((level.width / 2) >> level.subsample_w) << level.subsample_w;
+			level.height = ((level.height / 2) >> level.subsample_h) << level.subsample_h;
+			if (!level.width || !level.height)
+				error::throw_<error::InvalidImageSize>("too many pyramid levels for image dimensions");
+
+			level.active_width = level.width;
+			level.active_height = level.height;
+
+			internal_state target{ level };
+			decimate_plane(target, fallback_params, observer, ConnectMode::LUMA);
+			if (m_state.color == ColorFamily::YUV)
+				decimate_plane(target, fallback_params, observer, ConnectMode::CHROMA);
+			if (m_state.has_alpha())
+				decimate_plane(target, fallback_params, observer, ConnectMode::ALPHA);
+
+			iassert(m_state == target);
+			sinks.push_back(add_sink());
+		}
+
+		return release_subgraph(sinks);
 	}
 };
 
@@ -1192,6 +2004,9 @@ GraphBuilder::params::params() noexcept :
 	peak_luminance{ NAN },
 	approximate_gamma{},
 	scene_referred{},
+	chromatic_adaptation{},
+	colorspace_lut{},
+	profile{},
 	cpu{ CPUClass::AUTO }
 {
 	static const resize::BicubicFilter bicubic;
@@ -1227,9 +2042,7 @@ GraphBuilder &GraphBuilder::connect(const state &target, const params *params, F
 	static const GraphBuilder::params default_params;
 	DefaultFilterObserver default_observer;
 
-	validate_state(target);
-	if (target.active_left != 0 || target.active_top != 0 || target.active_width != target.width || target.active_height != target.height)
-		error::throw_<error::ResamplingNotAvailable>("active subregion not supported on target image");
+	validate_target(target);
 
 	if (!params)
 		params = &default_params;
@@ -1258,4 +2071,48 @@ std::unique_ptr<FilterGraph> GraphBuilder::build_graph()
 	return build_subgraph()->build_full_graph();
 }
 
+std::unique_ptr<FilterGraph> GraphBuilder::build_multi_graph(const state targets[], unsigned num_targets, const params *params, FilterObserver *observer) try
+{
+	static const GraphBuilder::params default_params;
+	DefaultFilterObserver default_observer;
+
+	if (!num_targets)
+		error::throw_<error::IllegalArgument>("no target formats");
+
+	for (unsigned i = 0; i < num_targets; ++i) {
+		validate_target(targets[i]);
+	}
+
+	if (!params)
+		params = &default_params;
+	if (!observer)
+		observer = &default_observer;
+
+	return get_impl()->build_multi_subgraph(targets, num_targets, *params, *observer)->build_full_graph();
+} catch (const graphengine::Exception &e) {
+	rethrow_graphengine_exception(e);
+} catch (const std::exception &e) {
+	error::throw_<error::InternalError>(e.what());
+}
+
+std::unique_ptr<FilterGraph> GraphBuilder::build_pyramid(unsigned num_levels, const params *params, FilterObserver *observer) try
+{
+	static const GraphBuilder::params default_params;
+	DefaultFilterObserver default_observer;
+
+	if (!num_levels)
+		error::throw_<error::IllegalArgument>("no pyramid levels");
+
+	if (!params)
+		params = &default_params;
+	if (!observer)
+		observer = &default_observer;
+
+	return get_impl()->build_pyramid_subgraph(num_levels, *params, *observer)->build_full_graph();
+} catch (const graphengine::Exception &e) {
+	rethrow_graphengine_exception(e);
+} catch (const std::exception &e) {
+	error::throw_<error::InternalError>(e.what());
+}
+
 } // namespace zimg::graph
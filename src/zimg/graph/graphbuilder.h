@@ -51,6 +51,8 @@ public:
 	virtual void yuv_to_grey() {}
 	virtual void grey_to_yuv() {}
 	virtual void grey_to_rgb() {}
+	virtual void upsample_yuv_to_rgb() {}
+	virtual void matrix_int() {}
 
 	virtual void premultiply() {}
 	virtual void unpremultiply() {}
@@ -104,6 +106,16 @@ public:
 		BOTTOM,
 	};
 
+	// Arrangement of components in memory.
+	enum class Layout {
+		PLANAR,
+		SEMIPLANAR,
+		PACKED,
+		PACKED_BGR,
+		YUYV,
+		UYVY,
+	};
+
 	// Canonical state.
 	struct state {
 		unsigned width;
@@ -128,6 +140,7 @@ public:
 		double active_height;
 
 		AlphaType alpha;
+		Layout layout;
 	};
 
 	// Filter instantiation parameters.
@@ -140,6 +153,8 @@ public:
 		bool approximate_gamma;
 		bool scene_referred;
 		bool chromatic_adaptation;
+		bool colorspace_lut;
+		bool profile;
 		CPUClass cpu;
 
 		params() noexcept;
@@ -207,6 +222,40 @@ public:
 	 * @return graph
 	 */
 	std::unique_ptr<FilterGraph> build_graph();
+
+	/**
+	 * Finalize and return a filter graph with one output node per target.
+	 *
+	 * The nodes already in the graph, including the source, are executed once
+	 * and shared by all outputs. If all targets share a colorspace, the
+	 * conversion to it is also shared, along with the resolution and depth
+	 * stages that every target agrees on. The graph is processed with
+	 * FilterGraph::process_multi.
+	 *
+	 * @param targets array of image formats
+	 * @param num_targets number of targets
+	 * @param params filter instantiation parameters
+	 * @param observer observer
+	 * @return graph
+	 */
+	std::unique_ptr<FilterGraph> build_multi_graph(const state targets[], unsigned num_targets, const params *params, FilterObserver *observer = nullptr);
+
+	/**
+	 * Finalize and return a filter graph producing an image pyramid.
+	 *
+	 * The graph has one output per level. Each level halves the width and
+	 * height of the previous level, rounded down to a multiple of the chroma
+	 * subsampling factor, and keeps the source format. Levels are computed
+	 * from the previous level with a fixed 2:1 filter equivalent to bilinear
+	 * resampling. The source must not have an active subregion and no
+	 * connections may have been made.
+	 *
+	 * @param num_levels number of levels, excluding the source
+	 * @param params filter instantiation parameters
+	 * @param observer observer
+	 * @return graph
+	 */
+	std::unique_ptr<FilterGraph> build_pyramid(unsigned num_levels, const params *params, FilterObserver *observer = nullptr);
 };
 
 } // namespace zimg::graph
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "common/checked_int.h"
+#include "common/cpuinfo.h"
+#include "common/except.h"
+#include "common/zassert.h"
+#include "packing.h"
+
+#if defined(ZIMG_X86)
+  #include "x86/packing_x86.h"
+#endif
+
+namespace zimg::graph {
+
+namespace {
+
+template <class T, unsigned N>
+void deinterleave_c(const void *src, void * const dst[], unsigned left, unsigned right)
+{
+	const T *src_p = static_cast<const T *>(src);
+
+	for (unsigned c = 0; c < N; ++c) {
+		T *dst_p = static_cast<T *>(dst[c]);
+		if (!dst_p)
+			continue;
+
+		for (unsigned j = left; j < right; ++j) {
+			dst_p[j] = src_p[static_cast<size_t>(j) * N + c];
+		}
+	}
+}
+
+template <class T, unsigned N>
+void interleave_c(const void * const src[], void *dst, unsigned left, unsigned right)
+{
+	const T *src_p[N];
+	T *dst_p = static_cast<T *>(dst);
+
+	for (unsigned c = 0; c < N; ++c) {
+		src_p[c] = static_cast<const T *>(src[c]);
+	}
+
+	for (unsigned j = left; j < right; ++j) {
+		for (unsigned c = 0; c < N; ++c) {
+			dst_p[static_cast<size_t>(j) * N + c] = src_p[c][j];
+		}
+	}
+}
+
+template <class T>
+void interleave_partial(const void * const src[], void *dst, unsigned num_components, unsigned left, unsigned right)
+{
+	T *dst_p = static_cast<T *>(dst);
+
+	for (unsigned j = left; j < right; ++j) {
+		dst_p[j] = static_cast<const T *>(src[j % num_components])[j / num_components];
+	}
+}
+
+template <class T>
+deinterleave_func select_deinterleave_func_c(unsigned num_components)
+{
+	switch (num_components) {
+	case 2:
+		return deinterleave_c<T, 2>;
+	case 3:
+		return deinterleave_c<T, 3>;
+	case 4:
+		return deinterleave_c<T, 4>;
+	default:
+		error::throw_<error::InternalError>("unsupported number of components");
+	}
+}
+
+template <class T>
+interleave_func select_interleave_func_c(unsigned num_components)
+{
+	switch (num_components) {
+	case 2:
+		return interleave_c<T, 2>;
+	case 3:
+		return interleave_c<T, 3>;
+	case 4:
+		return interleave_c<T, 4>;
+	default:
+		error::throw_<error::InternalError>("unsupported number of components");
+	}
+}
+
+} // namespace
+
+
+DeinterleaveFilter::DeinterleaveFilter(unsigned width, unsigned height, PixelType type, unsigned num_components, const int component_map[], CPUClass cpu) :
+	m_func{ select_deinterleave_func(pixel_size(type), num_components, cpu) },
+	m_num_components{ num_components },
+	m_bytes_per_sample{ pixel_size(type) },
+	m_component_map{ -1, -1, -1, -1 }
+{
+	zassert_d(num_components <= PACKING_MAX_COMPONENTS, "too many components");
+	zassert_d(checked_size_t{ width } * num_components <= pixel_max_width(type), "overflow");
+
+	unsigned num_planes = 0;
+	for (unsigned c = 0; c < num_components; ++c) {
+		m_component_map[c] = component_map[c];
+		num_planes = std::max(num_planes, static_cast<unsigned>(component_map[c] + 1));
+	}
+
+	m_desc.format = { width, height, m_bytes_per_sample };
+	m_desc.num_deps = 1;
+	m_desc.num_planes = num_planes;
+	m_desc.step = 1;
+}
+
+auto DeinterleaveFilter::get_col_deps(unsigned left, unsigned right) const noexcept -> pair_unsigned
+{
+	return{ left * m_num_components, right * m_num_components };
+}
+
+void DeinterleaveFilter::process(const graphengine::BufferDescriptor in[1], const graphengine::BufferDescriptor out[], unsigned i,
+                                 unsigned left, unsigned right, void *, void *) const noexcept
+{
+	void *dst[PACKING_MAX_COMPONENTS] = {};
+
+	for (unsigned c = 0; c < m_num_components; ++c) {
+		if (m_component_map[c] >= 0)
+			dst[c] = out[m_component_map[c]].get_line(i);
+	}
+
+	m_func(in->get_line(i), dst, left, right);
+}
+
+
+InterleaveFilter::InterleaveFilter(unsigned width, unsigned height, PixelType type, unsigned num_inputs, unsigned num_components, const int component_map[], CPUClass cpu) :
+	m_func{ select_interleave_func(pixel_size(type), num_components, cpu) },
+	m_num_components{ num_components },
+	m_bytes_per_sample{ pixel_size(type) },
+	m_component_map{}
+{
+	zassert_d(num_components <= PACKING_MAX_COMPONENTS, "too many components");
+	zassert_d(checked_size_t{ width } * num_components <= pixel_max_width(type), "overflow");
+
+	for (unsigned c = 0; c < num_components; ++c) {
+		zassert_d(component_map[c] >= 0 && static_cast<unsigned>(component_map[c]) < num_inputs, "invalid component");
+		m_component_map[c] = component_map[c];
+	}
+
+	m_desc.format = { width * num_components, height, m_bytes_per_sample };
+	m_desc.num_deps = num_inputs;
+	m_desc.num_planes = 1;
+	m_desc.step = 1;
+}
+
+auto InterleaveFilter::get_col_deps(unsigned left, unsigned right) const noexcept -> pair_unsigned
+{
+	return{ left / m_num_components, right / m_num_components + (right % m_num_components ? 1 : 0) };
+}
+
+void InterleaveFilter::process_partial(const void * const src[], void *dst, unsigned left, unsigned right) const noexcept
+{
+	if (m_bytes_per_sample == 1)
+		interleave_partial<uint8_t>(src, dst, m_num_components, left, right);
+	else if (m_bytes_per_sample == 2)
+		interleave_partial<uint16_t>(src, dst, m_num_components, left, right);
+	else
+		interleave_partial<uint32_t>(src, dst, m_num_components, left, right);
+}
+
+void InterleaveFilter::process(const graphengine::BufferDescriptor in[], const graphengine::BufferDescriptor out[1], unsigned i,
+                               unsigned left, unsigned right, void *, void *) const noexcept
+{
+	const void *src[PACKING_MAX_COMPONENTS] = {};
+	void *dst = out->get_line(i);
+
+	for (unsigned c = 0; c < m_num_components; ++c) {
+		src[c] = in[m_component_map[c]].get_line(i);
+	}
+
+	// Tiles may begin or end in the middle of a group.
+	unsigned group_left = left / m_num_components + (left % m_num_components ? 1 : 0);
+	unsigned group_right = right / m_num_components;
+
+	if (group_left >= group_right) {
+		process_partial(src, dst, left, right);
+		return;
+	}
+
+	process_partial(src, dst, left, group_left * m_num_components);
+	m_func(src, dst, group_left, group_right);
+	process_partial(src, dst, group_right * m_num_components, right);
+}
+
+
+deinterleave_func select_deinterleave_func(unsigned bytes_per_sample, unsigned num_components, CPUClass cpu)
+{
+	deinterleave_func func = nullptr;
+
+#if defined(ZIMG_X86)
+	func = select_deinterleave_func_x86(bytes_per_sample, num_components, cpu);
+#endif
+
+	if (!func && bytes_per_sample == 1)
+		func = select_deinterleave_func_c<uint8_t>(num_components);
+	if (!func && bytes_per_sample == 2)
+		func = select_deinterleave_func_c<uint16_t>(num_components);
+	if (!func && bytes_per_sample == 4)
+		func = select_deinterleave_func_c<uint32_t>(num_components);
+	if (!func)
+		error::throw_<error::InternalError>("unsupported sample size");
+
+	return func;
+}
+
+interleave_func select_interleave_func(unsigned bytes_per_sample, unsigned num_components, CPUClass cpu)
+{
+	interleave_func func = nullptr;
+
+#if defined(ZIMG_X86)
+	func = select_interleave_func_x86(bytes_per_sample, num_components, cpu);
+#endif
+
+	if (!func && bytes_per_sample == 1)
+		func = select_interleave_func_c<uint8_t>(num_components);
+	if (!func && bytes_per_sample == 2)
+		func = select_interleave_func_c<uint16_t>(num_components);
+	if (!func && bytes_per_sample == 4)
+		func = select_interleave_func_c<uint32_t>(num_components);
+	if (!func)
+		error::throw_<error::InternalError>("unsupported sample size");
+
+	return func;
+}
+
+} // namespace zimg::graph
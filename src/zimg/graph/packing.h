@@ -0,0 +1,70 @@
+#pragma once
+
+#ifndef ZIMG_GRAPH_PACKING_H_
+#define ZIMG_GRAPH_PACKING_H_
+
+#include "common/pixel.h"
+#include "graphengine/filter.h"
+#include "filter_base.h"
+
+namespace zimg {
+enum class CPUClass;
+}
+
+namespace zimg::graph {
+
+// Interleaved rows are addressed in units of whole component groups.
+typedef void (*deinterleave_func)(const void *src, void * const dst[], unsigned left, unsigned right);
+typedef void (*interleave_func)(const void * const src[], void *dst, unsigned left, unsigned right);
+
+constexpr unsigned PACKING_MAX_COMPONENTS = 4;
+
+// Splits a row of interleaved components into separate planes.
+//
+// The input plane has |num_components| samples per output pixel. Components
+// mapped to a negative plane index are skipped.
+class DeinterleaveFilter : public FilterBase {
+	deinterleave_func m_func;
+	unsigned m_num_components;
+	unsigned m_bytes_per_sample;
+	int m_component_map[PACKING_MAX_COMPONENTS];
+public:
+	DeinterleaveFilter(unsigned width, unsigned height, PixelType type, unsigned num_components, const int component_map[], CPUClass cpu);
+
+	pair_unsigned get_row_deps(unsigned i) const noexcept override { return{ i, i + 1 }; }
+
+	pair_unsigned get_col_deps(unsigned left, unsigned right) const noexcept override;
+
+	void process(const graphengine::BufferDescriptor in[1], const graphengine::BufferDescriptor out[], unsigned i,
+	             unsigned left, unsigned right, void *, void *) const noexcept override;
+};
+
+// Combines separate planes into a row of interleaved components.
+//
+// Component |c| of each output group is read from input |component_map[c]|.
+// The output plane is |num_components| times the input width.
+class InterleaveFilter : public FilterBase {
+	interleave_func m_func;
+	unsigned m_num_components;
+	unsigned m_bytes_per_sample;
+	int m_component_map[PACKING_MAX_COMPONENTS];
+
+	void process_partial(const void * const src[], void *dst, unsigned left, unsigned right) const noexcept;
+public:
+	InterleaveFilter(unsigned width, unsigned height, PixelType type, unsigned num_inputs, unsigned num_components, const int component_map[], CPUClass cpu);
+
+	pair_unsigned get_row_deps(unsigned i) const noexcept override { return{ i, i + 1 }; }
+
+	pair_unsigned get_col_deps(unsigned left, unsigned right) const noexcept override;
+
+	void process(const graphengine::BufferDescriptor in[], const graphengine::BufferDescriptor out[1], unsigned i,
+	             unsigned left, unsigned right, void *, void *) const noexcept override;
+};
+
+deinterleave_func select_deinterleave_func(unsigned bytes_per_sample, unsigned num_components, CPUClass cpu);
+
+interleave_func select_interleave_func(unsigned bytes_per_sample, unsigned num_components, CPUClass cpu);
+
+} // namespace zimg::graph
+
+#endif // ZIMG_GRAPH_PACKING_H_
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <typeinfo>
+#include "profile.h"
+
+#if defined(__GNUC__) && __has_include(<cxxabi.h>)
+  #include <cxxabi.h>
+  #define HAVE_CXXABI
+#endif
+
+namespace zimg::graph {
+
+namespace {
+
+// Unqualified class name of the filter implementation.
+std::string filter_name(const graphengine::Filter &filter)
+{
+	std::string name = typeid(filter).name();
+
+#ifdef HAVE_CXXABI
+	int status = 0;
+	if (char *demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status)) {
+		name = demangled;
+		std::free(demangled);
+	}
+#endif
+
+	// Strip template arguments and namespaces.
+	size_t pos = name.find('<');
+	if (pos != std::string::npos)
+		name.erase(pos);
+
+	pos = name.find_last_of(": ");
+	if (pos != std::string::npos)
+		name.erase(0, pos + 1);
+
+	return name;
+}
+
+} // namespace
+
+
+FilterProfile::FilterProfile(std::string name, unsigned width, unsigned height) :
+	name{ std::move(name) },
+	width{ width },
+	height{ height },
+	calls{},
+	rows{},
+	pixels{},
+	nanoseconds{}
+{}
+
+FilterProfile &GraphProfile::add(const graphengine::Filter &filter)
+{
+	const graphengine::PlaneDescriptor &format = filter.descriptor().format;
+	return m_entries.emplace_back(filter_name(filter), format.width, format.height);
+}
+
+void GraphProfile::reset() noexcept
+{
+	for (FilterProfile &entry : m_entries) {
+		entry.calls = 0;
+		entry.rows = 0;
+		entry.pixels = 0;
+		entry.nanoseconds = 0;
+	}
+}
+
+
+ProfilingFilter::ProfilingFilter(const graphengine::Filter *filter, std::shared_ptr<GraphProfile> profile) :
+	m_filter{ filter },
+	m_owner{ std::move(profile) },
+	m_profile{ &m_owner->add(*filter) }
+{}
+
+void ProfilingFilter::process(const graphengine::BufferDescriptor in[], const graphengine::BufferDescriptor out[], unsigned i,
+                              unsigned left, unsigned right, void *context, void *tmp) const noexcept
+{
+	auto start = std::chrono::steady_clock::now();
+	m_filter->process(in, out, i, left, right, context, tmp);
+	auto end = std::chrono::steady_clock::now();
+
+	const graphengine::FilterDescriptor &desc = m_filter->descriptor();
+	unsigned rows = std::min(desc.step, desc.format.height - i);
+
+	m_profile->calls.fetch_add(1, std::memory_order_relaxed);
+	m_profile->rows.fetch_add(rows, std::memory_order_relaxed);
+	m_profile->pixels.fetch_add(static_cast<uint64_t>(right - left) * rows, std::memory_order_relaxed);
+	m_profile->nanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(), std::memory_order_relaxed);
+}
+
+} // namespace zimg::graph
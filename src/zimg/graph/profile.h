@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef ZIMG_GRAPH_PROFILE_H_
+#define ZIMG_GRAPH_PROFILE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include "graphengine/filter.h"
+
+namespace zimg::graph {
+
+// Execution statistics of a single graph node.
+struct FilterProfile {
+	std::string name;
+	unsigned width;
+	unsigned height;
+	std::atomic<uint64_t> calls;
+	std::atomic<uint64_t> rows;
+	std::atomic<uint64_t> pixels;
+	std::atomic<uint64_t> nanoseconds;
+
+	FilterProfile(std::string name, unsigned width, unsigned height);
+};
+
+class GraphProfile {
+	std::deque<FilterProfile> m_entries;
+public:
+	FilterProfile &add(const graphengine::Filter &filter);
+
+	size_t size() const noexcept { return m_entries.size(); }
+
+	const FilterProfile &operator[](size_t i) const noexcept { return m_entries[i]; }
+
+	void reset() noexcept;
+};
+
+/**
+ * Forwards to another filter, recording the time spent in each call.
+ *
+ * Counters are updated atomically, so that a graph can be executed
+ * concurrently from multiple threads.
+ */
+class ProfilingFilter : public graphengine::Filter {
+	const graphengine::Filter *m_filter;
+	std::shared_ptr<GraphProfile> m_owner;
+	FilterProfile *m_profile;
+public:
+	ProfilingFilter(const graphengine::Filter *filter, std::shared_ptr<GraphProfile> profile);
+
+	int version() const noexcept override { return m_filter->version(); }
+
+	const graphengine::FilterDescriptor &descriptor() const noexcept override { return m_filter->descriptor(); }
+
+	pair_unsigned get_row_deps(unsigned i) const noexcept override { return m_filter->get_row_deps(i); }
+
+	pair_unsigned get_col_deps(unsigned left, unsigned right) const noexcept override { return m_filter->get_col_deps(left, right); }
+
+	void init_context(void *context) const noexcept override { m_filter->init_context(context); }
+
+	void process(const graphengine::BufferDescriptor in[], const graphengine::BufferDescriptor out[], unsigned i,
+	             unsigned left, unsigned right, void *context, void *tmp) const noexcept override;
+};
+
+} // namespace zimg::graph
+
+#endif // ZIMG_GRAPH_PROFILE_H_
@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include "common/align.h"
+#include "common/cpuinfo.h"
+#include "common/except.h"
+#include "colorspace/operation_impl.h"
+#include "resize/filter.h"
+#include "serialize.h"
+
+namespace zimg::graph {
+
+namespace {
+
+constexpr char BLOB_MAGIC[8] = { 'z', 'i', 'm', 'g', 'b', 'l', 'o', 'b' };
+constexpr uint32_t BLOB_FORMAT_VERSION = 1;
+
+// CPUClass values are only meaningful within one architecture.
+enum class BlobArch : uint32_t {
+	NONE,
+	X86,
+	ARM,
+	VEC,
+};
+
+#if defined(ZIMG_X86)
+constexpr BlobArch BLOB_ARCH = BlobArch::X86;
+#elif defined(ZIMG_ARM)
+constexpr BlobArch BLOB_ARCH = BlobArch::ARM;
+#elif defined(ZIMG_VEC)
+constexpr BlobArch BLOB_ARCH = BlobArch::VEC;
+#else
+constexpr BlobArch BLOB_ARCH = BlobArch::NONE;
+#endif
+
+// Fields are in native byte order. Sections are padded to 8 bytes.
+struct blob_header {
+	char magic[8];
+	uint32_t format_version;
+	uint32_t arch;
+	uint32_t cpu;
+	uint32_t num_tables;
+	uint64_t request_size;
+};
+
+struct table_header {
+	uint32_t kind;
+	uint32_t key_size;
+	uint64_t payload_size;
+};
+
+struct filter_header {
+	uint32_t filter_width;
+	uint32_t filter_rows;
+	uint32_t num_phases;
+	uint32_t input_width;
+	uint32_t stride;
+	uint32_t stride_i16;
+	uint32_t has_f32;
+	uint32_t has_i16;
+};
+
+struct lut3d_header {
+	uint32_t size;
+	float scale[3];
+	float offset[3];
+	uint32_t reserved;
+};
+
+[[noreturn]] void throw_invalid_blob()
+{
+	error::throw_<error::IllegalArgument>("invalid graph blob");
+}
+
+
+class BlobWriter {
+	std::vector<unsigned char> m_buf;
+public:
+	size_t size() const noexcept { return m_buf.size(); }
+
+	void write(const void *data, size_t size)
+	{
+		const unsigned char *p = static_cast<const unsigned char *>(data);
+		m_buf.insert(m_buf.end(), p, p + size);
+		m_buf.resize(ceil_n(m_buf.size(), 8));
+	}
+
+	template <class T>
+	void write(const T &x) { write(&x, sizeof(x)); }
+
+	void patch(size_t offset, const void *data, size_t size) { std::memcpy(m_buf.data() + offset, data, size); }
+
+	std::vector<unsigned char> release() { return std::move(m_buf); }
+};
+
+class BlobReader {
+	const unsigned char *m_ptr;
+	size_t m_size;
+public:
+	BlobReader(const void *buf, size_t size) : m_ptr{ static_cast<const unsigned char *>(buf) }, m_size{ size } {}
+
+	size_t remaining() const noexcept { return m_size; }
+
+	const unsigned char *read(size_t size)
+	{
+		size_t padded = ceil_n(size, 8);
+		if (padded < size || padded > m_size)
+			throw_invalid_blob();
+
+		const unsigned char *ret = m_ptr;
+		m_ptr += padded;
+		m_size -= padded;
+		return ret;
+	}
+
+	void read(void *dst, size_t size) { std::memcpy(dst, read(size), size); }
+
+	template <class T>
+	T read()
+	{
+		T x;
+		read(&x, sizeof(x));
+		return x;
+	}
+
+	BlobReader sub(size_t size) { return{ read(size), size }; }
+};
+
+
+void write_filter_context(BlobWriter &w, const resize::FilterContext &ctx)
+{
+	filter_header header{ ctx.filter_width, ctx.filter_rows, ctx.num_phases, ctx.input_width, ctx.stride, ctx.stride_i16, !ctx.data.empty(), !ctx.data_i16.empty() };
+	w.write(header);
+
+	if (header.has_f32)
+		w.write(ctx.data.data(), ctx.data.size() * sizeof(float));
+	if (header.has_i16)
+		w.write(ctx.data_i16.data(), ctx.data_i16.size() * sizeof(int16_t));
+
+	w.write(ctx.left.data(), ctx.left.size() * sizeof(unsigned));
+	w.write(ctx.phase.data(), ctx.phase.size() * sizeof(unsigned));
+}
+
+std::shared_ptr<const resize::FilterContext> read_filter_context(BlobReader &r)
+{
+	filter_header header = r.read<filter_header>();
+
+	if (!header.filter_width || !header.filter_rows || !header.num_phases || header.num_phases > header.filter_rows)
+		throw_invalid_blob();
+	if (header.filter_width > header.input_width || header.stride < header.filter_width || header.stride_i16 < header.filter_width)
+		throw_invalid_blob();
+	if (header.stride % AlignmentOf<float> || header.stride_i16 % AlignmentOf<int16_t>)
+		throw_invalid_blob();
+
+	// Bounds the table sizes, so that the checks on the remaining size do not overflow.
+	if (header.filter_rows > r.remaining() / sizeof(unsigned) ||
+	    header.num_phases > r.remaining() / header.stride ||
+	    header.num_phases > r.remaining() / header.stride_i16)
+		throw_invalid_blob();
+
+	auto ctx = std::make_shared<resize::FilterContext>();
+	ctx->filter_width = header.filter_width;
+	ctx->filter_rows = header.filter_rows;
+	ctx->num_phases = header.num_phases;
+	ctx->input_width = header.input_width;
+	ctx->stride = header.stride;
+	ctx->stride_i16 = header.stride_i16;
+
+	try {
+		if (header.has_f32) {
+			ctx->data.resize(static_cast<size_t>(header.num_phases) * header.stride);
+			r.read(ctx->data.data(), ctx->data.size() * sizeof(float));
+		}
+		if (header.has_i16) {
+			ctx->data_i16.resize(static_cast<size_t>(header.num_phases) * header.stride_i16);
+			r.read(ctx->data_i16.data(), ctx->data_i16.size() * sizeof(int16_t));
+		}
+
+		ctx->left.resize(header.filter_rows);
+		ctx->phase.resize(header.filter_rows);
+	} catch (const std::length_error &) {
+		error::throw_<error::OutOfMemory>();
+	}
+
+	r.read(ctx->left.data(), ctx->left.size() * sizeof(unsigned));
+	r.read(ctx->phase.data(), ctx->phase.size() * sizeof(unsigned));
+
+	for (unsigned i = 0; i < header.filter_rows; ++i) {
+		if (ctx->left[i] > header.input_width - header.filter_width || ctx->phase[i] >= header.num_phases)
+			throw_invalid_blob();
+	}
+
+	return ctx;
+}
+
+void write_lut3d(BlobWriter &w, const colorspace::Lut3D &lut)
+{
+	lut3d_header header{ lut.size, { lut.scale[0], lut.scale[1], lut.scale[2] }, { lut.offset[0], lut.offset[1], lut.offset[2] } };
+	w.write(header);
+	w.write(lut.data.data(), lut.data.size() * sizeof(float));
+}
+
+std::shared_ptr<const colorspace::Lut3D> read_lut3d(BlobReader &r)
+{
+	lut3d_header header = r.read<lut3d_header>();
+
+	if (!header.size || header.size > 256)
+		throw_invalid_blob();
+
+	auto lut = std::make_shared<colorspace::Lut3D>();
+	lut->size = header.size;
+	std::copy_n(header.scale, 3, lut->scale);
+	std::copy_n(header.offset, 3, lut->offset);
+
+	size_t count = static_cast<size_t>(header.size) * header.size * header.size * 3;
+	if (count > r.remaining() / sizeof(float))
+		throw_invalid_blob();
+
+	lut->data.resize(count);
+	r.read(lut->data.data(), count * sizeof(float));
+	return lut;
+}
+
+void write_float_table(BlobWriter &w, const float *table, size_t count)
+{
+	w.write(static_cast<uint64_t>(count));
+	w.write(table, count * sizeof(float));
+}
+
+std::shared_ptr<const float[]> read_float_table(BlobReader &r, size_t *count_out)
+{
+	uint64_t count = r.read<uint64_t>();
+	if (count > r.remaining() / sizeof(float))
+		throw_invalid_blob();
+
+	std::shared_ptr<float[]> table{ new float[count] };
+	r.read(table.get(), static_cast<size_t>(count) * sizeof(float));
+	*count_out = static_cast<size_t>(count);
+	return table;
+}
+
+} // namespace
+
+
+std::vector<unsigned char> write_graph_blob(const GraphBlob &blob)
+{
+	BlobWriter w;
+
+	blob_header header{};
+	std::copy_n(BLOB_MAGIC, sizeof(BLOB_MAGIC), header.magic);
+	header.format_version = BLOB_FORMAT_VERSION;
+	header.arch = static_cast<uint32_t>(BLOB_ARCH);
+	header.cpu = static_cast<uint32_t>(blob.cpu);
+	header.num_tables = static_cast<uint32_t>(blob.tables.entries().size());
+	header.request_size = blob.request.size();
+
+	w.write(header);
+	w.write(blob.request.data(), blob.request.size());
+
+	for (const TableRecord::entry &entry : blob.tables.entries()) {
+		table_header table{ static_cast<uint32_t>(entry.kind), static_cast<uint32_t>(entry.key.size()), 0 };
+
+		size_t table_offset = w.size();
+		w.write(table);
+		w.write(entry.key.data(), entry.key.size() * sizeof(uint64_t));
+
+		size_t payload_offset = w.size();
+
+		switch (entry.kind) {
+		case TableRecord::Kind::RESIZE_FILTER:
+			write_filter_context(w, *static_cast<const resize::FilterContext *>(entry.table.get()));
+			break;
+		case TableRecord::Kind::GAMMA_LUT:
+		case TableRecord::Kind::DEPTH_LUT:
+			write_float_table(w, static_cast<const float *>(entry.table.get()), entry.count);
+			break;
+		case TableRecord::Kind::LUT3D:
+			write_lut3d(w, *static_cast<const colorspace::Lut3D *>(entry.table.get()));
+			break;
+		}
+
+		table.payload_size = w.size() - payload_offset;
+		w.patch(table_offset, &table, sizeof(table));
+	}
+
+	return w.release();
+}
+
+GraphBlob read_graph_blob(const void *buf, size_t size)
+{
+	BlobReader r{ buf, size };
+	blob_header header = r.read<blob_header>();
+
+	if (std::memcmp(header.magic, BLOB_MAGIC, sizeof(BLOB_MAGIC)))
+		throw_invalid_blob();
+	if (header.format_version != BLOB_FORMAT_VERSION)
+		error::throw_<error::UnsupportedOperation>("unsupported graph blob version");
+	if (header.arch != static_cast<uint32_t>(BLOB_ARCH))
+		error::throw_<error::UnsupportedOperation>("graph blob was created for a different CPU");
+	if (header.request_size > r.remaining())
+		throw_invalid_blob();
+
+	GraphBlob blob{ static_cast<CPUClass>(header.cpu), {}, TableRecord{ true } };
+
+	const unsigned char *request = r.read(static_cast<size_t>(header.request_size));
+	blob.request.assign(request, request + header.request_size);
+
+	for (uint32_t n = 0; n < header.num_tables; ++n) {
+		table_header table = r.read<table_header>();
+
+		if (table.key_size > r.remaining() / sizeof(uint64_t))
+			throw_invalid_blob();
+
+		TableRecord::key_type key(table.key_size);
+		r.read(key.data(), key.size() * sizeof(uint64_t));
+
+		if (table.payload_size > r.remaining())
+			throw_invalid_blob();
+
+		BlobReader payload = r.sub(static_cast<size_t>(table.payload_size));
+		TableRecord::Kind kind = static_cast<TableRecord::Kind>(table.kind);
+
+		switch (kind) {
+		case TableRecord::Kind::RESIZE_FILTER:
+			blob.tables.add(kind, std::move(key), read_filter_context(payload));
+			break;
+		case TableRecord::Kind::GAMMA_LUT:
+		case TableRecord::Kind::DEPTH_LUT: {
+			size_t count;
+			std::shared_ptr<const float[]> table = read_float_table(payload, &count);
+			blob.tables.add(kind, std::move(key), std::move(table), count);
+			break;
+		}
+		case TableRecord::Kind::LUT3D:
+			blob.tables.add(kind, std::move(key), read_lut3d(payload));
+			break;
+		default:
+			throw_invalid_blob();
+		}
+	}
+
+	return blob;
+}
+
+} // namespace zimg::graph
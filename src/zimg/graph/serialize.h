@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef ZIMG_GRAPH_SERIALIZE_H_
+#define ZIMG_GRAPH_SERIALIZE_H_
+
+#include <cstddef>
+#include <vector>
+#include "common/table_record.h"
+
+namespace zimg {
+enum class CPUClass;
+}
+
+namespace zimg::graph {
+
+/**
+ * Serialized filter graph.
+ *
+ * Filters select their kernels when they are constructed, so a graph is
+ * restored by building it again. The blob holds the request which built the
+ * graph, together with the tables computed while building it, which are
+ * replayed instead of being computed again.
+ */
+struct GraphBlob {
+	/**
+	 * CPU the graph was built for, with autodetection resolved.
+	 */
+	CPUClass cpu;
+
+	/**
+	 * Build request, opaque to the blob format.
+	 */
+	std::vector<unsigned char> request;
+
+	/**
+	 * Tables computed while building the graph.
+	 */
+	TableRecord tables;
+};
+
+/**
+ * Encode a blob in the binary format.
+ *
+ * @param blob blob
+ * @return serialized bytes
+ */
+std::vector<unsigned char> write_graph_blob(const GraphBlob &blob);
+
+/**
+ * Decode a blob in the binary format. The returned tables are in replay mode.
+ *
+ * @param buf serialized bytes
+ * @param size size of buffer in bytes
+ * @return blob
+ */
+GraphBlob read_graph_blob(const void *buf, size_t size);
+
+} // namespace zimg::graph
+
+#endif // ZIMG_GRAPH_SERIALIZE_H_
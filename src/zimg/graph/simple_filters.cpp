@@ -1,10 +1,38 @@
 #include <algorithm>
 #include <cstdint>
+#include "common/cpuinfo.h"
 #include "common/pixel.h"
 #include "simple_filters.h"
 
+#if defined(ZIMG_X86)
+  #include "x86/premultiply_x86.h"
+#elif defined(ZIMG_ARM)
+  #include "arm/premultiply_arm.h"
+#endif
+
 namespace zimg::graph {
 
+namespace {
+
+void premultiply_c(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		dst[j] = src[j] * alpha[j];
+	}
+}
+
+void unpremultiply_c(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		float a = alpha[j];
+		a = std::clamp(a, 0.0f, 1.0f);
+		dst[j] = a == 0.0f ? 0.0f : src[j] / a;
+	}
+}
+
+} // namespace
+
+
 CopyRectFilter::CopyRectFilter(unsigned left, unsigned top, unsigned width, unsigned height, PixelType type) :
 	m_left{ left },
 	m_top{ top }
@@ -66,7 +94,9 @@ void ValueInitializeFilter::process(const graphengine::BufferDescriptor *in, con
 }
 
 
-PremultiplyFilter::PremultiplyFilter(unsigned width, unsigned height) : PointFilter(width, height, PixelType::FLOAT)
+PremultiplyFilter::PremultiplyFilter(unsigned width, unsigned height, CPUClass cpu) :
+	PointFilter(width, height, PixelType::FLOAT),
+	m_func{ select_premultiply_func(cpu) }
 {
 	m_desc.num_deps = 2;
 	m_desc.num_planes = 1;
@@ -76,19 +106,13 @@ PremultiplyFilter::PremultiplyFilter(unsigned width, unsigned height) : PointFil
 void PremultiplyFilter::process(const graphengine::BufferDescriptor in[2], const graphengine::BufferDescriptor *out,
                                 unsigned i, unsigned left, unsigned right, void *, void *) const noexcept
 {
-	const float *src_p = in[0].get_line<float>(i);
-	const float *alpha = in[1].get_line<float>(i);
-	float *dst_p = out->get_line<float>(i);
-
-	for (unsigned j = left; j < right; ++j) {
-		float a = alpha[j];
-		a = std::clamp(a, 0.0f, 1.0f);
-		dst_p[j] = src_p[j] * alpha[j];
-	}
+	m_func(in[0].get_line<float>(i), in[1].get_line<float>(i), out->get_line<float>(i), left, right);
 }
 
 
-UnpremultiplyFilter::UnpremultiplyFilter(unsigned width, unsigned height) : PointFilter(width, height, PixelType::FLOAT)
+UnpremultiplyFilter::UnpremultiplyFilter(unsigned width, unsigned height, CPUClass cpu) :
+	PointFilter(width, height, PixelType::FLOAT),
+	m_func{ select_unpremultiply_func(cpu) }
 {
 	m_desc.num_deps = 2;
 	m_desc.num_planes = 1;
@@ -98,15 +122,40 @@ UnpremultiplyFilter::UnpremultiplyFilter(unsigned width, unsigned height) : Poin
 void UnpremultiplyFilter::process(const graphengine::BufferDescriptor in[2], const graphengine::BufferDescriptor *out,
                                   unsigned i, unsigned left, unsigned right, void *, void *) const noexcept
 {
-	const float *src_p = in[0].get_line<float>(i);
-	const float *alpha = in[1].get_line<float>(i);
-	float *dst_p = out->get_line<float>(i);
+	m_func(in[0].get_line<float>(i), in[1].get_line<float>(i), out->get_line<float>(i), left, right);
+}
 
-	for (unsigned j = left; j < right; ++j) {
-		float a = alpha[j];
-		a = std::clamp(a, 0.0f, 1.0f);
-		dst_p[j] = a == 0.0f ? 0.0f : src_p[j] / a;
-	}
+
+premultiply_func select_premultiply_func(CPUClass cpu)
+{
+	premultiply_func func = nullptr;
+
+#if defined(ZIMG_X86)
+	func = select_premultiply_func_x86(cpu);
+#elif defined(ZIMG_ARM)
+	func = select_premultiply_func_arm(cpu);
+#endif
+
+	if (!func)
+		func = premultiply_c;
+
+	return func;
+}
+
+premultiply_func select_unpremultiply_func(CPUClass cpu)
+{
+	premultiply_func func = nullptr;
+
+#if defined(ZIMG_X86)
+	func = select_unpremultiply_func_x86(cpu);
+#elif defined(ZIMG_ARM)
+	func = select_unpremultiply_func_arm(cpu);
+#endif
+
+	if (!func)
+		func = unpremultiply_c;
+
+	return func;
 }
 
 } // namespace zimg::graph
@@ -8,11 +8,14 @@
 #include "filter_base.h"
 
 namespace zimg {
+enum class CPUClass;
 enum class PixelType;
 }
 
 namespace zimg::graph{
 
+typedef void (*premultiply_func)(const float *src, const float *alpha, float *dst, unsigned left, unsigned right);
+
 // Copies a subrectangle.
 class CopyRectFilter : public graph::FilterBase {
 	unsigned m_left;
@@ -51,8 +54,9 @@ public:
 
 // Premultiplies an image.
 class PremultiplyFilter : public PointFilter {
+	premultiply_func m_func;
 public:
-	PremultiplyFilter(unsigned width, unsigned height);
+	PremultiplyFilter(unsigned width, unsigned height, CPUClass cpu);
 
 	void process(const graphengine::BufferDescriptor in[2], const graphengine::BufferDescriptor *out,
 	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override;
@@ -60,13 +64,18 @@ public:
 
 // Unpremultiplies an image.
 class UnpremultiplyFilter : public PointFilter {
+	premultiply_func m_func;
 public:
-	UnpremultiplyFilter(unsigned width, unsigned height);
+	UnpremultiplyFilter(unsigned width, unsigned height, CPUClass cpu);
 
 	void process(const graphengine::BufferDescriptor in[2], const graphengine::BufferDescriptor *out,
 	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override;
 };
 
+premultiply_func select_premultiply_func(CPUClass cpu);
+
+premultiply_func select_unpremultiply_func(CPUClass cpu);
+
 } // namespace zimg::graph
 
 #endif // ZIMG_GRAPH_SIMPLE_FILTERS_H_
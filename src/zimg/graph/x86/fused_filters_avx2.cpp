@@ -0,0 +1,408 @@
+#ifdef ZIMG_X86
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <tuple>
+#include <immintrin.h>
+#include "colorspace/matrix3.h"
+#include "common/align.h"
+#include "common/alloc.h"
+#include "common/ccdep.h"
+#include "common/checked_int.h"
+#include "common/make_array.h"
+#include "common/pixel.h"
+#include "common/unroll.h"
+#include "depth/quantize.h"
+#include "graph/filter_base.h"
+#include "resize/filter.h"
+#include "fused_filters_x86.h"
+
+#include "common/x86/avx2_util.h"
+
+namespace zimg::graph {
+
+namespace {
+
+inline FORCE_INLINE __m256 load8_ps(const uint8_t *ptr)
+{
+	return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)ptr)));
+}
+
+inline FORCE_INLINE __m256 load8_ps(const uint16_t *ptr)
+{
+	return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_load_si128((const __m128i *)ptr)));
+}
+
+
+template <class T>
+inline FORCE_INLINE __m256 upsample_v_xiter(unsigned j, const T * const *src, const float *filter_data, unsigned filter_width)
+{
+	__m256 accum0 = _mm256_setzero_ps();
+	__m256 accum1 = _mm256_setzero_ps();
+	unsigned k = 0;
+
+	for (; k + 2 <= filter_width; k += 2) {
+		accum0 = _mm256_fmadd_ps(_mm256_set1_ps(filter_data[k + 0]), load8_ps(src[k + 0] + j), accum0);
+		accum1 = _mm256_fmadd_ps(_mm256_set1_ps(filter_data[k + 1]), load8_ps(src[k + 1] + j), accum1);
+	}
+	if (k < filter_width)
+		accum0 = _mm256_fmadd_ps(_mm256_set1_ps(filter_data[k]), load8_ps(src[k] + j), accum0);
+
+	return _mm256_add_ps(accum0, accum1);
+}
+
+// Vertical pass with conversion to float, producing one row at source width.
+template <class T>
+void upsample_line_v_avx2(const T * const *src, const float *filter_data, unsigned filter_width, float *dst, float scale, float offset, unsigned left, unsigned right)
+{
+	const __m256 scale_ps = _mm256_set1_ps(scale);
+	const __m256 offset_ps = _mm256_set1_ps(offset);
+
+	unsigned vec_left = ceil_n(left, 8);
+	unsigned vec_right = floor_n(right, 8);
+
+	if (left != vec_left) {
+		__m256 x = upsample_v_xiter(vec_left - 8, src, filter_data, filter_width);
+		mm256_store_idxhi_ps(dst + vec_left - 8, _mm256_fmadd_ps(x, scale_ps, offset_ps), left % 8);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 8) {
+		__m256 x = upsample_v_xiter(j, src, filter_data, filter_width);
+		_mm256_store_ps(dst + j, _mm256_fmadd_ps(x, scale_ps, offset_ps));
+	}
+
+	if (right != vec_right) {
+		__m256 x = upsample_v_xiter(vec_right, src, filter_data, filter_width);
+		mm256_store_idxlo_ps(dst + vec_right, _mm256_fmadd_ps(x, scale_ps, offset_ps), right % 8);
+	}
+}
+
+// Horizontal pass from the float row, with the taps of 8 outputs permuted from a single window.
+template <unsigned Taps>
+void upsample_line_h_perm_avx2(const unsigned * RESTRICT permute_left, const unsigned * RESTRICT permute_mask, const float * RESTRICT filter_data, unsigned input_width,
+                               const float * RESTRICT src, float * RESTRICT dst, unsigned left, unsigned right)
+{
+	static_assert(Taps <= 8, "permuted resampler only supports up to 8 taps");
+
+	unsigned vec_right = floor_n(right, 8);
+	unsigned fallback_idx = vec_right;
+
+#define mm256_alignr_epi8_ps(a, b, imm) _mm256_castsi256_ps(_mm256_alignr_epi8(_mm256_castps_si256((a)), _mm256_castps_si256((b)), (imm)))
+	for (unsigned j = floor_n(left, 8); j < vec_right; j += 8) {
+		unsigned left = permute_left[j / 8];
+
+		if (input_width - left < (Taps >= 6 ? 16 : 12)) {
+			fallback_idx = j;
+			break;
+		}
+
+		const __m256i mask = _mm256_load_si256((const __m256i *)(permute_mask + j));
+		const float *data = filter_data + static_cast<size_t>(j) * Taps;
+
+		__m256 accum0 = _mm256_setzero_ps();
+		__m256 accum1 = _mm256_setzero_ps();
+
+		__m256 x0 = _mm256_loadu_ps(src + left + 0);
+		__m256 x4 = _mm256_loadu_ps(src + left + 4);
+		__m256 x8 = Taps >= 6 ? _mm256_loadu_ps(src + left + 8) : _mm256_setzero_ps();
+
+		unroll<Taps>(ZIMG_UNROLL_FUNC(k)
+		{
+			__m256 &acc = k % 2 ? accum1 : accum0;
+
+			__m256 coeffs = _mm256_load_ps(data + k * 8);
+			__m256 x;
+
+			if constexpr (k >= 4)
+				x = k % 4 ? mm256_alignr_epi8_ps(x8, x4, (k % 4) * 4) : x4;
+			else
+				x = k % 4 ? mm256_alignr_epi8_ps(x4, x0, (k % 4) * 4) : x0;
+
+			x = _mm256_permutevar8x32_ps(x, mask);
+			acc = _mm256_fmadd_ps(coeffs, x, acc);
+		});
+
+		_mm256_store_ps(dst + j, _mm256_add_ps(accum0, accum1));
+	}
+#undef mm256_alignr_epi8_ps
+	for (unsigned j = fallback_idx; j < right; j += 8) {
+		unsigned left = permute_left[j / 8];
+		const float *data = filter_data + static_cast<size_t>(j) * Taps;
+
+		__m256 accum0 = _mm256_setzero_ps();
+		__m256 accum1 = _mm256_setzero_ps();
+
+		for (unsigned k = 0; k < Taps; ++k) {
+			alignas(32) float tmp[8];
+
+			for (unsigned kk = 0; kk < 8; ++kk) {
+				tmp[kk] = src[left + permute_mask[j + kk] + k];
+			}
+
+			__m256 x = _mm256_load_ps(tmp);
+			__m256 coeffs = _mm256_load_ps(data + k * 8);
+
+			if (k % 2)
+				accum1 = _mm256_fmadd_ps(coeffs, x, accum1);
+			else
+				accum0 = _mm256_fmadd_ps(coeffs, x, accum0);
+		}
+		_mm256_store_ps(dst + j, _mm256_add_ps(accum0, accum1));
+	}
+}
+
+constexpr auto upsample_line_h_perm_avx2_jt = make_array(
+	upsample_line_h_perm_avx2<1>,
+	upsample_line_h_perm_avx2<2>,
+	upsample_line_h_perm_avx2<3>,
+	upsample_line_h_perm_avx2<4>,
+	upsample_line_h_perm_avx2<5>,
+	upsample_line_h_perm_avx2<6>,
+	upsample_line_h_perm_avx2<7>,
+	upsample_line_h_perm_avx2<8>);
+
+
+template <class T>
+class ChromaUpsampleFilter_AVX2 : public FilterBase {
+	typedef decltype(upsample_line_h_perm_avx2_jt)::value_type func_type;
+
+	static constexpr unsigned MAX_TAPS_V = 8;
+
+	struct PermuteContext {
+		AlignedVector<unsigned> left;
+		AlignedVector<unsigned> permute;
+		AlignedVector<float> data;
+		unsigned filter_rows;
+		unsigned filter_width;
+		unsigned input_width;
+	};
+
+	PermuteContext m_filter_h;
+	std::shared_ptr<const resize::FilterContext> m_filter_v;
+	func_type m_func;
+	float m_scale;
+	float m_offset;
+	bool m_sorted_v;
+
+	static bool supported(const resize::FilterContext &filter_h, const resize::FilterContext &filter_v)
+	{
+		if (filter_h.filter_width > 8 || filter_v.filter_width > MAX_TAPS_V)
+			return false;
+
+		for (unsigned i = 0; i < filter_h.filter_rows; i += 8) {
+			auto minmax = std::minmax_element(filter_h.left.begin() + i, filter_h.left.begin() + std::min(i + 8, filter_h.filter_rows));
+			if (*minmax.second - *minmax.first >= 8)
+				return false;
+		}
+		return true;
+	}
+
+	static PermuteContext make_permute_context(const resize::FilterContext &filter)
+	{
+		PermuteContext context{};
+
+		context.left.resize(ceil_n(filter.filter_rows, 8) / 8);
+		context.permute.resize(ceil_n(filter.filter_rows, 8));
+		context.data.resize(ceil_n(filter.filter_rows, 8) * filter.filter_width);
+		context.filter_rows = filter.filter_rows;
+		context.filter_width = filter.filter_width;
+		context.input_width = filter.input_width;
+
+		for (unsigned i = 0; i < filter.filter_rows; i += 8) {
+			unsigned left_min = UINT_MAX;
+
+			for (unsigned ii = i; ii < std::min(i + 8, context.filter_rows); ++ii) {
+				left_min = std::min(left_min, filter.left[ii]);
+			}
+
+			for (unsigned ii = i; ii < std::min(i + 8, context.filter_rows); ++ii) {
+				context.permute[ii] = filter.left[ii] - left_min;
+			}
+			context.left[i / 8] = left_min;
+
+			float *data = context.data.data() + i * context.filter_width;
+			for (unsigned k = 0; k < context.filter_width; ++k) {
+				for (unsigned ii = i; ii < std::min(i + 8, context.filter_rows); ++ii) {
+					data[static_cast<size_t>(k) * 8 + (ii - i)] = filter.data[filter.phase[ii] * static_cast<ptrdiff_t>(filter.stride) + k];
+				}
+			}
+		}
+
+		return context;
+	}
+
+	ChromaUpsampleFilter_AVX2(const resize::FilterContext &filter_h, std::shared_ptr<const resize::FilterContext> filter_v, const PixelFormat &format) :
+		m_filter_h(make_permute_context(filter_h)),
+		m_filter_v(std::move(filter_v)),
+		m_func{ upsample_line_h_perm_avx2_jt[filter_h.filter_width - 1] },
+		m_scale{},
+		m_offset{},
+		m_sorted_v{ std::is_sorted(m_filter_v->left.begin(), m_filter_v->left.end()) }
+	{
+		std::tie(m_scale, m_offset) = depth::get_scale_offset(format, PixelType::FLOAT);
+
+		m_desc.format = { m_filter_h.filter_rows, m_filter_v->filter_rows, pixel_size(PixelType::FLOAT) };
+		m_desc.num_deps = 2;
+		m_desc.num_planes = 2;
+		m_desc.step = 1;
+		m_desc.alignment_mask = 7;
+		m_desc.scratchpad_size = (checked_size_t{ ceil_n(m_filter_h.input_width, 8) } * sizeof(float)).get();
+		m_desc.flags.entire_row = !std::is_sorted(m_filter_h.left.begin(), m_filter_h.left.end());
+	}
+public:
+	static std::unique_ptr<graphengine::Filter> create(const std::shared_ptr<const resize::FilterContext> &filter_h,
+	                                                   const std::shared_ptr<const resize::FilterContext> &filter_v, const PixelFormat &format)
+	{
+		if (!supported(*filter_h, *filter_v))
+			return nullptr;
+
+		std::unique_ptr<graphengine::Filter> ret{ new ChromaUpsampleFilter_AVX2(*filter_h, filter_v, format) };
+		return ret;
+	}
+
+	pair_unsigned get_row_deps(unsigned i) const noexcept override
+	{
+		if (!m_sorted_v)
+			return{ 0, m_filter_v->input_width };
+
+		unsigned top = m_filter_v->left[i];
+		return{ top, top + m_filter_v->filter_width };
+	}
+
+	pair_unsigned get_col_deps(unsigned left, unsigned right) const noexcept override
+	{
+		if (m_desc.flags.entire_row)
+			return{ 0, m_filter_h.input_width };
+
+		unsigned input_width = m_filter_h.input_width;
+		unsigned right_base = m_filter_h.left[(right + 7) / 8 - 1];
+		unsigned iter_width = m_filter_h.filter_width + 8;
+		return{ m_filter_h.left[left / 8], right_base + std::min(input_width - right_base, iter_width) };
+	}
+
+	void process(const graphengine::BufferDescriptor in[2], const graphengine::BufferDescriptor out[2],
+	             unsigned i, unsigned left, unsigned right, void *, void *tmp) const noexcept override
+	{
+		auto cols = get_col_deps(left, right);
+		float *row = static_cast<float *>(tmp);
+
+		const float *filter_v = m_filter_v->data.data() + static_cast<size_t>(m_filter_v->phase[i]) * m_filter_v->stride;
+		unsigned top = m_filter_v->left[i];
+
+		for (unsigned p = 0; p < 2; ++p) {
+			const T *src_lines[MAX_TAPS_V];
+
+			for (unsigned k = 0; k < m_filter_v->filter_width; ++k) {
+				src_lines[k] = in[p].get_line<T>(top + k);
+			}
+
+			upsample_line_v_avx2(src_lines, filter_v, m_filter_v->filter_width, row, m_scale, m_offset, cols.first, cols.second);
+			m_func(m_filter_h.left.data(), m_filter_h.permute.data(), m_filter_h.data.data(), m_filter_h.input_width, row, out[p].get_line<float>(i), left, right);
+		}
+	}
+};
+
+
+template <class T>
+class YUVToRGBFilter_AVX2 : public PointFilter {
+	float m_matrix[3][3];
+	float m_scale;
+	float m_offset;
+
+	inline FORCE_INLINE void convert8(const T *src_y, const float *src_u, const float *src_v, __m256 &r, __m256 &g, __m256 &b) const
+	{
+		__m256 y = _mm256_fmadd_ps(load8_ps(src_y), _mm256_set1_ps(m_scale), _mm256_set1_ps(m_offset));
+		__m256 u = _mm256_load_ps(src_u);
+		__m256 v = _mm256_load_ps(src_v);
+
+		r = _mm256_fmadd_ps(_mm256_set1_ps(m_matrix[0][0]), y, _mm256_fmadd_ps(_mm256_set1_ps(m_matrix[0][1]), u, _mm256_mul_ps(_mm256_set1_ps(m_matrix[0][2]), v)));
+		g = _mm256_fmadd_ps(_mm256_set1_ps(m_matrix[1][0]), y, _mm256_fmadd_ps(_mm256_set1_ps(m_matrix[1][1]), u, _mm256_mul_ps(_mm256_set1_ps(m_matrix[1][2]), v)));
+		b = _mm256_fmadd_ps(_mm256_set1_ps(m_matrix[2][0]), y, _mm256_fmadd_ps(_mm256_set1_ps(m_matrix[2][1]), u, _mm256_mul_ps(_mm256_set1_ps(m_matrix[2][2]), v)));
+	}
+public:
+	YUVToRGBFilter_AVX2(const colorspace::Matrix3x3 &matrix, const PixelFormat &format, unsigned width, unsigned height) :
+		PointFilter(width, height, PixelType::FLOAT),
+		m_matrix{},
+		m_scale{},
+		m_offset{}
+	{
+		for (unsigned i = 0; i < 3; ++i) {
+			for (unsigned j = 0; j < 3; ++j) {
+				m_matrix[i][j] = static_cast<float>(matrix[i][j]);
+			}
+		}
+
+		std::tie(m_scale, m_offset) = depth::get_scale_offset(format, PixelType::FLOAT);
+
+		m_desc.num_deps = 3;
+		m_desc.num_planes = 3;
+	}
+
+	void process(const graphengine::BufferDescriptor in[3], const graphengine::BufferDescriptor out[3],
+	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override
+	{
+		const T *src_y = in[0].get_line<T>(i);
+		const float *src_u = in[1].get_line<float>(i);
+		const float *src_v = in[2].get_line<float>(i);
+		float *dst_r = out[0].get_line<float>(i);
+		float *dst_g = out[1].get_line<float>(i);
+		float *dst_b = out[2].get_line<float>(i);
+
+		unsigned vec_left = ceil_n(left, 8);
+		unsigned vec_right = floor_n(right, 8);
+		__m256 r, g, b;
+
+		if (left != vec_left) {
+			unsigned j = vec_left - 8;
+			convert8(src_y + j, src_u + j, src_v + j, r, g, b);
+			mm256_store_idxhi_ps(dst_r + j, r, left % 8);
+			mm256_store_idxhi_ps(dst_g + j, g, left % 8);
+			mm256_store_idxhi_ps(dst_b + j, b, left % 8);
+		}
+
+		for (unsigned j = vec_left; j < vec_right; j += 8) {
+			convert8(src_y + j, src_u + j, src_v + j, r, g, b);
+			_mm256_store_ps(dst_r + j, r);
+			_mm256_store_ps(dst_g + j, g);
+			_mm256_store_ps(dst_b + j, b);
+		}
+
+		if (right != vec_right) {
+			unsigned j = vec_right;
+			convert8(src_y + j, src_u + j, src_v + j, r, g, b);
+			mm256_store_idxlo_ps(dst_r + j, r, right % 8);
+			mm256_store_idxlo_ps(dst_g + j, g, right % 8);
+			mm256_store_idxlo_ps(dst_b + j, b, right % 8);
+		}
+	}
+};
+
+} // namespace
+
+
+std::unique_ptr<graphengine::Filter> create_chroma_upsample_avx2(const std::shared_ptr<const resize::FilterContext> &filter_h,
+                                                                 const std::shared_ptr<const resize::FilterContext> &filter_v, const PixelFormat &format)
+{
+	if (format.type == PixelType::BYTE)
+		return ChromaUpsampleFilter_AVX2<uint8_t>::create(filter_h, filter_v, format);
+	else if (format.type == PixelType::WORD)
+		return ChromaUpsampleFilter_AVX2<uint16_t>::create(filter_h, filter_v, format);
+	else
+		return nullptr;
+}
+
+std::unique_ptr<graphengine::Filter> create_yuv_to_rgb_avx2(const colorspace::Matrix3x3 &matrix, const PixelFormat &format, unsigned width, unsigned height)
+{
+	if (format.type == PixelType::BYTE)
+		return std::make_unique<YUVToRGBFilter_AVX2<uint8_t>>(matrix, format, width, height);
+	else if (format.type == PixelType::WORD)
+		return std::make_unique<YUVToRGBFilter_AVX2<uint16_t>>(matrix, format, width, height);
+	else
+		return nullptr;
+}
+
+} // namespace zimg::graph
+
+#endif // ZIMG_X86
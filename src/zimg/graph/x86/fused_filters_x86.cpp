@@ -0,0 +1,46 @@
+#ifdef ZIMG_X86
+
+#include "common/cpuinfo.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "graphengine/filter.h"
+#include "fused_filters_x86.h"
+
+namespace zimg::graph {
+
+std::unique_ptr<graphengine::Filter> create_chroma_upsample_x86(const std::shared_ptr<const resize::FilterContext> &filter_h,
+                                                                const std::shared_ptr<const resize::FilterContext> &filter_v, const PixelFormat &format, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<graphengine::Filter> ret;
+
+	// The horizontal pass uses cross-lane permutes.
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2 && !cpu_has_slow_permute(caps))
+			ret = create_chroma_upsample_avx2(filter_h, filter_v, format);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_chroma_upsample_avx2(filter_h, filter_v, format);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<graphengine::Filter> create_yuv_to_rgb_x86(const colorspace::Matrix3x3 &matrix, const PixelFormat &format, unsigned width, unsigned height, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<graphengine::Filter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_yuv_to_rgb_avx2(matrix, format, width, height);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_yuv_to_rgb_avx2(matrix, format, width, height);
+	}
+
+	return ret;
+}
+
+} // namespace zimg::graph
+
+#endif // ZIMG_X86
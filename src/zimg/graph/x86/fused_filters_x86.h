@@ -0,0 +1,50 @@
+#pragma once
+
+#ifdef ZIMG_X86
+
+#ifndef ZIMG_GRAPH_X86_FUSED_FILTERS_X86_H_
+#define ZIMG_GRAPH_X86_FUSED_FILTERS_X86_H_
+
+#include <memory>
+
+namespace graphengine {
+class Filter;
+}
+
+namespace zimg {
+enum class CPUClass;
+struct PixelFormat;
+}
+
+namespace zimg::colorspace {
+struct Matrix3x3;
+}
+
+namespace zimg::resize {
+struct FilterContext;
+}
+
+namespace zimg::graph {
+
+#define DECLARE_CHROMA_UPSAMPLE(cpu) \
+std::unique_ptr<graphengine::Filter> create_chroma_upsample_##cpu(const std::shared_ptr<const resize::FilterContext> &filter_h, \
+                                                                  const std::shared_ptr<const resize::FilterContext> &filter_v, const PixelFormat &format);
+#define DECLARE_YUV_TO_RGB(cpu) \
+std::unique_ptr<graphengine::Filter> create_yuv_to_rgb_##cpu(const colorspace::Matrix3x3 &matrix, const PixelFormat &format, unsigned width, unsigned height);
+
+DECLARE_CHROMA_UPSAMPLE(avx2)
+DECLARE_YUV_TO_RGB(avx2)
+
+#undef DECLARE_CHROMA_UPSAMPLE
+#undef DECLARE_YUV_TO_RGB
+
+std::unique_ptr<graphengine::Filter> create_chroma_upsample_x86(const std::shared_ptr<const resize::FilterContext> &filter_h,
+                                                                const std::shared_ptr<const resize::FilterContext> &filter_v, const PixelFormat &format, CPUClass cpu);
+
+std::unique_ptr<graphengine::Filter> create_yuv_to_rgb_x86(const colorspace::Matrix3x3 &matrix, const PixelFormat &format, unsigned width, unsigned height, CPUClass cpu);
+
+} // namespace zimg::graph
+
+#endif // ZIMG_GRAPH_X86_FUSED_FILTERS_X86_H_
+
+#endif // ZIMG_X86
@@ -0,0 +1,236 @@
+#ifdef ZIMG_X86
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include "common/ccdep.h"
+#include "packing_x86.h"
+
+namespace zimg::graph {
+
+namespace {
+
+struct PackU8 {
+	typedef uint8_t type;
+
+	static inline FORCE_INLINE void deinterleave2(__m256i a, __m256i b, __m256i &even, __m256i &odd)
+	{
+		const __m256i mask = _mm256_set1_epi16(0x00FF);
+
+		even = _mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+		odd = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+		even = _mm256_permute4x64_epi64(even, _MM_SHUFFLE(3, 1, 2, 0));
+		odd = _mm256_permute4x64_epi64(odd, _MM_SHUFFLE(3, 1, 2, 0));
+	}
+
+	static inline FORCE_INLINE void interleave2(__m256i a, __m256i b, __m256i &lo, __m256i &hi)
+	{
+		__m256i x = _mm256_unpacklo_epi8(a, b);
+		__m256i y = _mm256_unpackhi_epi8(a, b);
+		lo = _mm256_permute2x128_si256(x, y, 0x20);
+		hi = _mm256_permute2x128_si256(x, y, 0x31);
+	}
+};
+
+struct PackU16 {
+	typedef uint16_t type;
+
+	static inline FORCE_INLINE void deinterleave2(__m256i a, __m256i b, __m256i &even, __m256i &odd)
+	{
+		const __m256i mask = _mm256_set1_epi32(0x0000FFFF);
+
+		even = _mm256_packus_epi32(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+		odd = _mm256_packus_epi32(_mm256_srli_epi32(a, 16), _mm256_srli_epi32(b, 16));
+		even = _mm256_permute4x64_epi64(even, _MM_SHUFFLE(3, 1, 2, 0));
+		odd = _mm256_permute4x64_epi64(odd, _MM_SHUFFLE(3, 1, 2, 0));
+	}
+
+	static inline FORCE_INLINE void interleave2(__m256i a, __m256i b, __m256i &lo, __m256i &hi)
+	{
+		__m256i x = _mm256_unpacklo_epi16(a, b);
+		__m256i y = _mm256_unpackhi_epi16(a, b);
+		lo = _mm256_permute2x128_si256(x, y, 0x20);
+		hi = _mm256_permute2x128_si256(x, y, 0x31);
+	}
+};
+
+
+inline FORCE_INLINE __m256i loadu(const void *ptr)
+{
+	return _mm256_loadu_si256(static_cast<const __m256i *>(ptr));
+}
+
+inline FORCE_INLINE void storeu(void *ptr, __m256i x)
+{
+	_mm256_storeu_si256(static_cast<__m256i *>(ptr), x);
+}
+
+
+template <class Traits>
+void deinterleave2_avx2(const void *src, void * const dst[], unsigned left, unsigned right)
+{
+	typedef typename Traits::type T;
+	constexpr unsigned V = 32 / sizeof(T);
+
+	const T *src_p = static_cast<const T *>(src);
+	T *dst0 = static_cast<T *>(dst[0]);
+	T *dst1 = static_cast<T *>(dst[1]);
+	unsigned j = left;
+
+	for (; right - j >= V; j += V) {
+		const T *ptr = src_p + static_cast<size_t>(j) * 2;
+		__m256i c0, c1;
+
+		Traits::deinterleave2(loadu(ptr + 0 * V), loadu(ptr + 1 * V), c0, c1);
+
+		if (dst0)
+			storeu(dst0 + j, c0);
+		if (dst1)
+			storeu(dst1 + j, c1);
+	}
+	for (; j < right; ++j) {
+		if (dst0)
+			dst0[j] = src_p[static_cast<size_t>(j) * 2 + 0];
+		if (dst1)
+			dst1[j] = src_p[static_cast<size_t>(j) * 2 + 1];
+	}
+}
+
+template <class Traits>
+void deinterleave4_avx2(const void *src, void * const dst[], unsigned left, unsigned right)
+{
+	typedef typename Traits::type T;
+	constexpr unsigned V = 32 / sizeof(T);
+
+	const T *src_p = static_cast<const T *>(src);
+	T *dst_p[4] = { static_cast<T *>(dst[0]), static_cast<T *>(dst[1]), static_cast<T *>(dst[2]), static_cast<T *>(dst[3]) };
+	unsigned j = left;
+
+	for (; right - j >= V; j += V) {
+		const T *ptr = src_p + static_cast<size_t>(j) * 4;
+		__m256i c[4];
+		__m256i e0, o0, e1, o1;
+
+		// First pass separates (c0, c2) from (c1, c3), second pass splits the pairs.
+		Traits::deinterleave2(loadu(ptr + 0 * V), loadu(ptr + 1 * V), e0, o0);
+		Traits::deinterleave2(loadu(ptr + 2 * V), loadu(ptr + 3 * V), e1, o1);
+		Traits::deinterleave2(e0, e1, c[0], c[2]);
+		Traits::deinterleave2(o0, o1, c[1], c[3]);
+
+		for (unsigned k = 0; k < 4; ++k) {
+			if (dst_p[k])
+				storeu(dst_p[k] + j, c[k]);
+		}
+	}
+	for (; j < right; ++j) {
+		for (unsigned k = 0; k < 4; ++k) {
+			if (dst_p[k])
+				dst_p[k][j] = src_p[static_cast<size_t>(j) * 4 + k];
+		}
+	}
+}
+
+template <class Traits>
+void interleave2_avx2(const void * const src[], void *dst, unsigned left, unsigned right)
+{
+	typedef typename Traits::type T;
+	constexpr unsigned V = 32 / sizeof(T);
+
+	const T *src0 = static_cast<const T *>(src[0]);
+	const T *src1 = static_cast<const T *>(src[1]);
+	T *dst_p = static_cast<T *>(dst);
+	unsigned j = left;
+
+	for (; right - j >= V; j += V) {
+		T *ptr = dst_p + static_cast<size_t>(j) * 2;
+		__m256i lo, hi;
+
+		Traits::interleave2(loadu(src0 + j), loadu(src1 + j), lo, hi);
+		storeu(ptr + 0 * V, lo);
+		storeu(ptr + 1 * V, hi);
+	}
+	for (; j < right; ++j) {
+		dst_p[static_cast<size_t>(j) * 2 + 0] = src0[j];
+		dst_p[static_cast<size_t>(j) * 2 + 1] = src1[j];
+	}
+}
+
+template <class Traits>
+void interleave4_avx2(const void * const src[], void *dst, unsigned left, unsigned right)
+{
+	typedef typename Traits::type T;
+	constexpr unsigned V = 32 / sizeof(T);
+
+	const T *src_p[4] = { static_cast<const T *>(src[0]), static_cast<const T *>(src[1]), static_cast<const T *>(src[2]), static_cast<const T *>(src[3]) };
+	T *dst_p = static_cast<T *>(dst);
+	unsigned j = left;
+
+	for (; right - j >= V; j += V) {
+		T *ptr = dst_p + static_cast<size_t>(j) * 4;
+		__m256i e0, e1, o0, o1;
+		__m256i x0, x1, x2, x3;
+
+		// Pair (c0, c2) and (c1, c3) first, so that the second pass yields whole groups.
+		Traits::interleave2(loadu(src_p[0] + j), loadu(src_p[2] + j), e0, e1);
+		Traits::interleave2(loadu(src_p[1] + j), loadu(src_p[3] + j), o0, o1);
+		Traits::interleave2(e0, o0, x0, x1);
+		Traits::interleave2(e1, o1, x2, x3);
+
+		storeu(ptr + 0 * V, x0);
+		storeu(ptr + 1 * V, x1);
+		storeu(ptr + 2 * V, x2);
+		storeu(ptr + 3 * V, x3);
+	}
+	for (; j < right; ++j) {
+		for (unsigned k = 0; k < 4; ++k) {
+			dst_p[static_cast<size_t>(j) * 4 + k] = src_p[k][j];
+		}
+	}
+}
+
+} // namespace
+
+
+void deinterleave_b2_avx2(const void *src, void * const dst[], unsigned left, unsigned right)
+{
+	deinterleave2_avx2<PackU8>(src, dst, left, right);
+}
+
+void deinterleave_b4_avx2(const void *src, void * const dst[], unsigned left, unsigned right)
+{
+	deinterleave4_avx2<PackU8>(src, dst, left, right);
+}
+
+void deinterleave_w2_avx2(const void *src, void * const dst[], unsigned left, unsigned right)
+{
+	deinterleave2_avx2<PackU16>(src, dst, left, right);
+}
+
+void deinterleave_w4_avx2(const void *src, void * const dst[], unsigned left, unsigned right)
+{
+	deinterleave4_avx2<PackU16>(src, dst, left, right);
+}
+
+void interleave_b2_avx2(const void * const src[], void *dst, unsigned left, unsigned right)
+{
+	interleave2_avx2<PackU8>(src, dst, left, right);
+}
+
+void interleave_b4_avx2(const void * const src[], void *dst, unsigned left, unsigned right)
+{
+	interleave4_avx2<PackU8>(src, dst, left, right);
+}
+
+void interleave_w2_avx2(const void * const src[], void *dst, unsigned left, unsigned right)
+{
+	interleave2_avx2<PackU16>(src, dst, left, right);
+}
+
+void interleave_w4_avx2(const void * const src[], void *dst, unsigned left, unsigned right)
+{
+	interleave4_avx2<PackU16>(src, dst, left, right);
+}
+
+} // namespace zimg::graph
+
+#endif // ZIMG_X86
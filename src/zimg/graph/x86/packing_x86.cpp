@@ -0,0 +1,76 @@
+#ifdef ZIMG_X86
+
+#include "common/cpuinfo.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "packing_x86.h"
+
+namespace zimg::graph {
+
+namespace {
+
+deinterleave_func select_deinterleave_func_avx2(unsigned bytes_per_sample, unsigned num_components)
+{
+	if (bytes_per_sample == 1 && num_components == 2)
+		return deinterleave_b2_avx2;
+	else if (bytes_per_sample == 1 && num_components == 4)
+		return deinterleave_b4_avx2;
+	else if (bytes_per_sample == 2 && num_components == 2)
+		return deinterleave_w2_avx2;
+	else if (bytes_per_sample == 2 && num_components == 4)
+		return deinterleave_w4_avx2;
+	else
+		return nullptr;
+}
+
+interleave_func select_interleave_func_avx2(unsigned bytes_per_sample, unsigned num_components)
+{
+	if (bytes_per_sample == 1 && num_components == 2)
+		return interleave_b2_avx2;
+	else if (bytes_per_sample == 1 && num_components == 4)
+		return interleave_b4_avx2;
+	else if (bytes_per_sample == 2 && num_components == 2)
+		return interleave_w2_avx2;
+	else if (bytes_per_sample == 2 && num_components == 4)
+		return interleave_w4_avx2;
+	else
+		return nullptr;
+}
+
+} // namespace
+
+
+deinterleave_func select_deinterleave_func_x86(unsigned bytes_per_sample, unsigned num_components, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	deinterleave_func func = nullptr;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!func && caps.avx2)
+			func = select_deinterleave_func_avx2(bytes_per_sample, num_components);
+	} else {
+		if (!func && cpu >= CPUClass::X86_AVX2)
+			func = select_deinterleave_func_avx2(bytes_per_sample, num_components);
+	}
+
+	return func;
+}
+
+interleave_func select_interleave_func_x86(unsigned bytes_per_sample, unsigned num_components, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	interleave_func func = nullptr;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!func && caps.avx2)
+			func = select_interleave_func_avx2(bytes_per_sample, num_components);
+	} else {
+		if (!func && cpu >= CPUClass::X86_AVX2)
+			func = select_interleave_func_avx2(bytes_per_sample, num_components);
+	}
+
+	return func;
+}
+
+} // namespace zimg::graph
+
+#endif // ZIMG_X86
@@ -0,0 +1,38 @@
+#pragma once
+
+#ifdef ZIMG_X86
+
+#ifndef ZIMG_GRAPH_X86_PACKING_X86_H_
+#define ZIMG_GRAPH_X86_PACKING_X86_H_
+
+#include "graph/packing.h"
+
+namespace zimg::graph {
+
+#define DECLARE_DEINTERLEAVE(x, cpu) \
+void deinterleave_##x##_##cpu(const void *src, void * const dst[], unsigned left, unsigned right)
+#define DECLARE_INTERLEAVE(x, cpu) \
+void interleave_##x##_##cpu(const void * const src[], void *dst, unsigned left, unsigned right)
+
+DECLARE_DEINTERLEAVE(b2, avx2);
+DECLARE_DEINTERLEAVE(b4, avx2);
+DECLARE_DEINTERLEAVE(w2, avx2);
+DECLARE_DEINTERLEAVE(w4, avx2);
+
+DECLARE_INTERLEAVE(b2, avx2);
+DECLARE_INTERLEAVE(b4, avx2);
+DECLARE_INTERLEAVE(w2, avx2);
+DECLARE_INTERLEAVE(w4, avx2);
+
+#undef DECLARE_DEINTERLEAVE
+#undef DECLARE_INTERLEAVE
+
+deinterleave_func select_deinterleave_func_x86(unsigned bytes_per_sample, unsigned num_components, CPUClass cpu);
+
+interleave_func select_interleave_func_x86(unsigned bytes_per_sample, unsigned num_components, CPUClass cpu);
+
+} // namespace zimg::graph
+
+#endif // ZIMG_GRAPH_X86_PACKING_X86_H_
+
+#endif // ZIMG_X86
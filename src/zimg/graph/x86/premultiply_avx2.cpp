@@ -0,0 +1,70 @@
+#ifdef ZIMG_X86
+
+#include <immintrin.h>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "premultiply_x86.h"
+
+#include "common/x86/avx2_util.h"
+
+namespace zimg::graph {
+
+namespace {
+
+struct Premultiply {
+	static inline FORCE_INLINE __m256 func(__m256 x, __m256 a)
+	{
+		return _mm256_mul_ps(x, a);
+	}
+};
+
+struct Unpremultiply {
+	static inline FORCE_INLINE __m256 func(__m256 x, __m256 a)
+	{
+		// Operand order matches std::clamp for NaN inputs.
+		a = _mm256_max_ps(_mm256_setzero_ps(), a);
+		a = _mm256_min_ps(_mm256_set1_ps(1.0f), a);
+
+		__m256 zero_mask = _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_EQ_OQ);
+		return _mm256_andnot_ps(zero_mask, _mm256_div_ps(x, a));
+	}
+};
+
+template <class Op>
+void premultiply_line_avx2(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+{
+	unsigned vec_left = ceil_n(left, 8);
+	unsigned vec_right = floor_n(right, 8);
+
+	if (left != vec_left) {
+		__m256 x = Op::func(_mm256_load_ps(src + vec_left - 8), _mm256_load_ps(alpha + vec_left - 8));
+		mm256_store_idxhi_ps(dst + vec_left - 8, x, left % 8);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 8) {
+		__m256 x = Op::func(_mm256_load_ps(src + j), _mm256_load_ps(alpha + j));
+		_mm256_store_ps(dst + j, x);
+	}
+
+	if (right != vec_right) {
+		__m256 x = Op::func(_mm256_load_ps(src + vec_right), _mm256_load_ps(alpha + vec_right));
+		mm256_store_idxlo_ps(dst + vec_right, x, right % 8);
+	}
+}
+
+} // namespace
+
+
+void premultiply_avx2(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+{
+	premultiply_line_avx2<Premultiply>(src, alpha, dst, left, right);
+}
+
+void unpremultiply_avx2(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+{
+	premultiply_line_avx2<Unpremultiply>(src, alpha, dst, left, right);
+}
+
+} // namespace zimg::graph
+
+#endif // ZIMG_X86
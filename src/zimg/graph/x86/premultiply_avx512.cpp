@@ -0,0 +1,70 @@
+#ifdef ZIMG_X86
+
+#include <immintrin.h>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "premultiply_x86.h"
+
+#include "common/x86/avx512_util.h"
+
+namespace zimg::graph {
+
+namespace {
+
+struct Premultiply {
+	static inline FORCE_INLINE __m512 func(__m512 x, __m512 a)
+	{
+		return _mm512_mul_ps(x, a);
+	}
+};
+
+struct Unpremultiply {
+	static inline FORCE_INLINE __m512 func(__m512 x, __m512 a)
+	{
+		// Operand order matches std::clamp for NaN inputs.
+		a = _mm512_max_ps(_mm512_setzero_ps(), a);
+		a = _mm512_min_ps(_mm512_set1_ps(1.0f), a);
+
+		__mmask16 nonzero = _mm512_cmp_ps_mask(a, _mm512_setzero_ps(), _CMP_NEQ_UQ);
+		return _mm512_maskz_div_ps(nonzero, x, a);
+	}
+};
+
+template <class Op>
+void premultiply_line_avx512(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+{
+	unsigned vec_left = ceil_n(left, 16);
+	unsigned vec_right = floor_n(right, 16);
+
+	if (left != vec_left) {
+		__m512 x = Op::func(_mm512_load_ps(src + vec_left - 16), _mm512_load_ps(alpha + vec_left - 16));
+		_mm512_mask_store_ps(dst + vec_left - 16, mmask16_set_hi(vec_left - left), x);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 16) {
+		__m512 x = Op::func(_mm512_load_ps(src + j), _mm512_load_ps(alpha + j));
+		_mm512_store_ps(dst + j, x);
+	}
+
+	if (right != vec_right) {
+		__m512 x = Op::func(_mm512_load_ps(src + vec_right), _mm512_load_ps(alpha + vec_right));
+		_mm512_mask_store_ps(dst + vec_right, mmask16_set_lo(right - vec_right), x);
+	}
+}
+
+} // namespace
+
+
+void premultiply_avx512(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+{
+	premultiply_line_avx512<Premultiply>(src, alpha, dst, left, right);
+}
+
+void unpremultiply_avx512(const float *src, const float *alpha, float *dst, unsigned left, unsigned right)
+{
+	premultiply_line_avx512<Unpremultiply>(src, alpha, dst, left, right);
+}
+
+} // namespace zimg::graph
+
+#endif // ZIMG_X86
@@ -0,0 +1,51 @@
+#ifdef ZIMG_X86
+
+#include "common/cpuinfo.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "premultiply_x86.h"
+
+namespace zimg::graph {
+
+premultiply_func select_premultiply_func_x86(CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	premultiply_func func = nullptr;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!func && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			func = premultiply_avx512;
+		if (!func && caps.avx2)
+			func = premultiply_avx2;
+	} else {
+		if (!func && cpu >= CPUClass::X86_AVX512)
+			func = premultiply_avx512;
+		if (!func && cpu >= CPUClass::X86_AVX2)
+			func = premultiply_avx2;
+	}
+
+	return func;
+}
+
+premultiply_func select_unpremultiply_func_x86(CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	premultiply_func func = nullptr;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!func && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			func = unpremultiply_avx512;
+		if (!func && caps.avx2)
+			func = unpremultiply_avx2;
+	} else {
+		if (!func && cpu >= CPUClass::X86_AVX512)
+			func = unpremultiply_avx512;
+		if (!func && cpu >= CPUClass::X86_AVX2)
+			func = unpremultiply_avx2;
+	}
+
+	return func;
+}
+
+} // namespace zimg::graph
+
+#endif // ZIMG_X86
@@ -21,9 +21,9 @@ namespace zimg::resize {
 struct FilterContext;
 
 #define DECLARE_IMPL_H(cpu) \
-std::unique_ptr<graphengine::Filter> create_resize_impl_h_##cpu(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+std::unique_ptr<graphengine::Filter> create_resize_impl_h_##cpu(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 #define DECLARE_IMPL_V(cpu) \
-std::unique_ptr<graphengine::Filter> create_resize_impl_v_##cpu(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+std::unique_ptr<graphengine::Filter> create_resize_impl_v_##cpu(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth)
 
 DECLARE_IMPL_H(neon);
 
@@ -32,9 +32,9 @@ DECLARE_IMPL_V(neon);
 #undef DECLARE_IMPL_H
 #undef DECLARE_IMPL_V
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_h_arm(const FilterContext &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu);
+std::unique_ptr<graphengine::Filter> create_resize_impl_h_arm(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu);
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_v_arm(const FilterContext &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu);
+std::unique_ptr<graphengine::Filter> create_resize_impl_v_arm(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu);
 
 } // namespace zimg::resize
 
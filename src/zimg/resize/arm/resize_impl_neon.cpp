@@ -85,7 +85,7 @@ inline FORCE_INLINE int16x8_t export_i30_u16(int32x4_t lo, int32x4_t hi)
 
 
 template <int Taps>
-inline FORCE_INLINE uint16x8_t resize_line8_h_u16_neon_xiter(unsigned j, const unsigned *filter_left, const int16_t *filter_data, unsigned filter_stride, unsigned filter_width,
+inline FORCE_INLINE uint16x8_t resize_line8_h_u16_neon_xiter(unsigned j, const unsigned *filter_left, const unsigned *filter_phase, const int16_t *filter_data, unsigned filter_stride, unsigned filter_width,
                                                              const uint16_t *src, unsigned src_base, uint16_t limit)
 {
 	static_assert(Taps <= 8, "only up to 8 taps can be unrolled");
@@ -95,7 +95,7 @@ inline FORCE_INLINE uint16x8_t resize_line8_h_u16_neon_xiter(unsigned j, const u
 	const int16x8_t i16_min = vdupq_n_s16(INT16_MIN);
 	const int16x8_t lim = vdupq_n_s16(limit + INT16_MIN);
 
-	const int16_t *filter_coeffs = filter_data + j * filter_stride;
+	const int16_t *filter_coeffs = filter_data + filter_phase[j] * filter_stride;
 	const uint16_t *src_p = src + (filter_left[j] - src_base) * 8;
 
 	int32x4_t accum_lo = vdupq_n_s32(0);
@@ -133,14 +133,14 @@ inline FORCE_INLINE uint16x8_t resize_line8_h_u16_neon_xiter(unsigned j, const u
 }
 
 template <int Taps>
-void resize_line8_h_u16_neon(const unsigned * RESTRICT filter_left, const int16_t * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+void resize_line8_h_u16_neon(const unsigned * RESTRICT filter_left, const unsigned * RESTRICT filter_phase, const int16_t * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
                              const uint16_t * RESTRICT src, uint16_t * const * RESTRICT dst, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
 {
 	unsigned vec_left = ceil_n(left, 8);
 	unsigned vec_right = floor_n(right, 8);
 
 #define XITER resize_line8_h_u16_neon_xiter<Taps>
-#define XARGS filter_left, filter_data, filter_stride, filter_width, src, src_base, limit
+#define XARGS filter_left, filter_phase, filter_data, filter_stride, filter_width, src, src_base, limit
 	for (unsigned j = left; j < vec_left; ++j) {
 		uint16x8_t x = XITER(j, XARGS);
 		neon_scatter_u16(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, dst[4] + j, dst[5] + j, dst[6] + j, dst[7] + j, x);
@@ -200,14 +200,14 @@ constexpr auto resize_line8_h_u16_neon_jt_large = make_array(
 
 
 template <int Taps>
-inline FORCE_INLINE float32x4_t resize_line4_h_f32_neon_xiter(unsigned j, const unsigned *filter_left, const float *filter_data, unsigned filter_stride, unsigned filter_width,
+inline FORCE_INLINE float32x4_t resize_line4_h_f32_neon_xiter(unsigned j, const unsigned *filter_left, const unsigned *filter_phase, const float *filter_data, unsigned filter_stride, unsigned filter_width,
                                                               const float *src, unsigned src_base)
 {
 	static_assert(Taps <= 8, "only up to 8 taps can be unrolled");
 	static_assert(Taps >= -3, "only up to 3 taps in epilogue");
 	constexpr int Tail = Taps >= 4 ? Taps - 4 : Taps > 0 ? Taps : -Taps;
 
-	const float *filter_coeffs = filter_data + j * filter_stride;
+	const float *filter_coeffs = filter_data + filter_phase[j] * filter_stride;
 	const float *src_p = src + (filter_left[j] - src_base) * 4;
 
 	float32x4_t accum0 = vdupq_n_f32(0.0f);
@@ -243,14 +243,14 @@ inline FORCE_INLINE float32x4_t resize_line4_h_f32_neon_xiter(unsigned j, const
 }
 
 template <int Taps>
-void resize_line4_h_f32_neon(const unsigned * RESTRICT filter_left, const float * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+void resize_line4_h_f32_neon(const unsigned * RESTRICT filter_left, const unsigned * RESTRICT filter_phase, const float * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
                             const float * RESTRICT src, float * const * RESTRICT dst, unsigned src_base, unsigned left, unsigned right)
 {
 	unsigned vec_left = ceil_n(left, 4);
 	unsigned vec_right = floor_n(right, 4);
 
 #define XITER resize_line4_h_f32_neon_xiter<Taps>
-#define XARGS filter_left, filter_data, filter_stride, filter_width, src, src_base
+#define XARGS filter_left, filter_phase, filter_data, filter_stride, filter_width, src, src_base
 	for (unsigned j = left; j < vec_left; ++j) {
 		float32x4_t x = XITER(j, XARGS);
 		neon_scatter_f32(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, x);
@@ -504,18 +504,18 @@ class ResizeImplH_U16_Neon final : public ResizeImplH {
 	decltype(resize_line8_h_u16_neon_jt_small)::value_type m_func;
 	uint16_t m_pixel_max;
 public:
-	ResizeImplH_U16_Neon(const FilterContext &filter, unsigned height, unsigned depth) try :
+	ResizeImplH_U16_Neon(const std::shared_ptr<const FilterContext> &filter, unsigned height, unsigned depth) try :
 		ResizeImplH(filter, height, PixelType::WORD),
 		m_func{},
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{
 		m_desc.step = 8;
-		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter.input_width }, 8) * sizeof(uint16_t) * 8).get();
+		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter->input_width }, 8) * sizeof(uint16_t) * 8).get();
 
-		if (filter.filter_width <= 8)
-			m_func = resize_line8_h_u16_neon_jt_small[filter.filter_width - 1];
+		if (filter->filter_width <= 8)
+			m_func = resize_line8_h_u16_neon_jt_small[filter->filter_width - 1];
 		else
-			m_func = resize_line8_h_u16_neon_jt_large[filter.filter_width % 8];
+			m_func = resize_line8_h_u16_neon_jt_large[filter->filter_width % 8];
 	} catch (const std::overflow_error &) {
 		error::throw_<error::OutOfMemory>();
 	}
@@ -540,7 +540,7 @@ public:
 			dst_ptr[n] = out->get_line<uint16_t>(std::min(i + n, height - 1));
 		}
 
-		m_func(m_filter.left.data(), m_filter.data_i16.data(), m_filter.stride_i16, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->phase.data(), m_filter->data_i16.data(), m_filter->stride_i16, m_filter->filter_width,
 		       transpose_buf, dst_ptr, floor_n(range.first, 8), left, right, m_pixel_max);
 	}
 };
@@ -549,17 +549,17 @@ public:
 class ResizeImplH_F32_Neon final : public ResizeImplH {
 	decltype(resize_line4_h_f32_neon_jt_small)::value_type m_func;
 public:
-	ResizeImplH_F32_Neon(const FilterContext &filter, unsigned height) try :
+	ResizeImplH_F32_Neon(const std::shared_ptr<const FilterContext> &filter, unsigned height) try :
 		ResizeImplH(filter, height, PixelType::FLOAT),
 		m_func{}
 	{
 		m_desc.step = 4;
-		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter.input_width }, 4) * sizeof(float) * 4).get();
+		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter->input_width }, 4) * sizeof(float) * 4).get();
 
-		if (filter.filter_width <= 8)
-			m_func = resize_line4_h_f32_neon_jt_small[filter.filter_width - 1];
+		if (filter->filter_width <= 8)
+			m_func = resize_line4_h_f32_neon_jt_small[filter->filter_width - 1];
 		else
-			m_func = resize_line4_h_f32_neon_jt_large[filter.filter_width % 4];
+			m_func = resize_line4_h_f32_neon_jt_large[filter->filter_width % 4];
 	} catch (const std::overflow_error &) {
 		error::throw_<error::OutOfMemory>();
 	}
@@ -586,7 +586,7 @@ public:
 		dst_ptr[2] = out->get_line<float>(std::min(i + 2, height - 1));
 		dst_ptr[3] = out->get_line<float>(std::min(i + 3, height - 1));
 
-		m_func(m_filter.left.data(), m_filter.data.data(), m_filter.stride, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->phase.data(), m_filter->data.data(), m_filter->stride, m_filter->filter_width,
 		       transpose_buf, dst_ptr, floor_n(range.first, 4), left, right);
 	}
 };
@@ -595,11 +595,11 @@ public:
 class ResizeImplV_U16_Neon : public ResizeImplV {
 	uint16_t m_pixel_max;
 public:
-	ResizeImplV_U16_Neon(const FilterContext &filter, unsigned width, unsigned depth) try :
+	ResizeImplV_U16_Neon(const std::shared_ptr<const FilterContext> &filter, unsigned width, unsigned depth) try :
 		ResizeImplV(filter, width, PixelType::WORD),
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{
-		if (m_filter.filter_width > 8)
+		if (m_filter->filter_width > 8)
 			m_desc.scratchpad_size = (ceil_n(checked_size_t{ width }, 8) * sizeof(uint32_t)).get();
 	} catch (const std::overflow_error &) {
 		error::throw_<error::OutOfMemory>();
@@ -608,15 +608,15 @@ public:
 	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
 	             unsigned i, unsigned left, unsigned right, void *, void *tmp) const noexcept override
 	{
-		const int16_t *filter_data = m_filter.data_i16.data() + i * m_filter.stride_i16;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const int16_t *filter_data = m_filter->data_i16.data() + m_filter->phase[i] * m_filter->stride_i16;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
 		const uint16_t *src_lines[8] = { 0 };
 		uint16_t *dst_line = out->get_line<uint16_t>(i);
 		int32_t *accum_buf = static_cast<int32_t *>(tmp);
 
-		unsigned top = m_filter.left[i];
+		unsigned top = m_filter->left[i];
 
 		auto gather_8_lines = [&](unsigned i)
 		{
@@ -650,23 +650,23 @@ public:
 
 class ResizeImplV_F32_Neon : public ResizeImplV {
 public:
-	ResizeImplV_F32_Neon(const FilterContext &filter, unsigned width) :
+	ResizeImplV_F32_Neon(const std::shared_ptr<const FilterContext> &filter, unsigned width) :
 		ResizeImplV(filter, width, PixelType::FLOAT)
 	{}
 
 	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
 	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override
 	{
-		const float *filter_data = m_filter.data.data() + i * m_filter.stride;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const float *filter_data = m_filter->data.data() + m_filter->phase[i] * m_filter->stride;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
 		const float *src_lines[8] = { 0 };
 		float *dst_line = out->get_line<float>(i);
 
 		{
 			unsigned taps_remain = std::min(filter_width - 0, 8U);
-			unsigned top = m_filter.left[i] + 0;
+			unsigned top = m_filter->left[i] + 0;
 
 			src_lines[0] = in->get_line<float>(std::min(top + 0, src_height - 1));
 			src_lines[1] = in->get_line<float>(std::min(top + 1, src_height - 1));
@@ -682,7 +682,7 @@ public:
 
 		for (unsigned k = 8; k < filter_width; k += 8) {
 			unsigned taps_remain = std::min(filter_width - k, 8U);
-			unsigned top = m_filter.left[i] + k;
+			unsigned top = m_filter->left[i] + k;
 
 			src_lines[0] = in->get_line<float>(std::min(top + 0, src_height - 1));
 			src_lines[1] = in->get_line<float>(std::min(top + 1, src_height - 1));
@@ -701,7 +701,7 @@ public:
 } // namespace
 
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_h_neon(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+std::unique_ptr<graphengine::Filter> create_resize_impl_h_neon(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graphengine::Filter> ret;
 
@@ -713,7 +713,7 @@ std::unique_ptr<graphengine::Filter> create_resize_impl_h_neon(const FilterConte
 	return ret;
 }
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_v_neon(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+std::unique_ptr<graphengine::Filter> create_resize_impl_v_neon(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graphengine::Filter> ret;
 
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include "common/checked_int.h"
+#include "common/cpuinfo.h"
+#include "common/except.h"
+#include "common/pixel.h"
+#include "common/zassert.h"
+#include "decimate.h"
+
+#if defined(ZIMG_X86)
+  #include "x86/decimate_x86.h"
+#endif
+
+namespace zimg::resize {
+
+namespace {
+
+template <class T>
+using decimate_accum_t = std::conditional_t<std::is_integral_v<T>, uint32_t, float>;
+
+template <class T>
+decimate_accum_t<T> decimate_taps(decimate_accum_t<T> a, decimate_accum_t<T> b, decimate_accum_t<T> c, decimate_accum_t<T> d)
+{
+	if constexpr (std::is_integral_v<T>)
+		return a + 3 * (b + c) + d;
+	else
+		return 0.125f * (a + d) + 0.375f * (b + c);
+}
+
+template <class T>
+void decimate_c(const void * const src[4], void *dst, void *tmp, unsigned src_width, unsigned left, unsigned right)
+{
+	typedef decimate_accum_t<T> U;
+
+	const T *src0 = static_cast<const T *>(src[0]);
+	const T *src1 = static_cast<const T *>(src[1]);
+	const T *src2 = static_cast<const T *>(src[2]);
+	const T *src3 = static_cast<const T *>(src[3]);
+	T *dst_p = static_cast<T *>(dst);
+
+	// Column -1 is stored at index 0.
+	U *tmp_p = static_cast<U *>(tmp) + 1;
+
+	unsigned col_left = left ? left * 2 - 1 : 0;
+	unsigned col_right = std::min(right * 2 + 1, src_width);
+
+	for (unsigned j = col_left; j < col_right; ++j) {
+		tmp_p[j] = decimate_taps<T>(src0[j], src1[j], src2[j], src3[j]);
+	}
+
+	// Mirror the edge columns, as compute_filter does.
+	if (col_left == 0)
+		tmp_p[-1] = tmp_p[0];
+	if (col_right == src_width)
+		tmp_p[src_width] = tmp_p[src_width - 1];
+
+	for (unsigned j = left; j < right; ++j) {
+		const U *ptr = tmp_p + j * 2;
+		U accum = decimate_taps<T>(ptr[-1], ptr[0], ptr[1], ptr[2]);
+
+		if constexpr (std::is_integral_v<T>)
+			dst_p[j] = static_cast<T>((accum + 32) >> 6);
+		else
+			dst_p[j] = accum;
+	}
+}
+
+} // namespace
+
+
+DecimateFilter::DecimateFilter(unsigned src_width, unsigned src_height, PixelType type, CPUClass cpu) :
+	m_func{ select_decimate_func(type, cpu) },
+	m_src_width{ src_width },
+	m_src_height{ src_height }
+{
+	zassert_d(src_width % 2 == 0 && src_height % 2 == 0, "dimensions must be even");
+
+	m_desc.format = { src_width / 2, src_height / 2, pixel_size(type) };
+	m_desc.num_deps = 1;
+	m_desc.num_planes = 1;
+	m_desc.step = 1;
+	m_desc.scratchpad_size = ((checked_size_t{ src_width } + 2) * sizeof(float)).get();
+}
+
+auto DecimateFilter::get_row_deps(unsigned i) const noexcept -> pair_unsigned
+{
+	unsigned top = i ? i * 2 - 1 : 0;
+	unsigned bottom = std::min(i * 2 + 3, m_src_height);
+	return{ top, bottom };
+}
+
+auto DecimateFilter::get_col_deps(unsigned left, unsigned right) const noexcept -> pair_unsigned
+{
+	unsigned col_left = left ? left * 2 - 1 : 0;
+	unsigned col_right = std::min(right * 2 + 1, m_src_width);
+	return{ col_left, col_right };
+}
+
+void DecimateFilter::process(const graphengine::BufferDescriptor in[1], const graphengine::BufferDescriptor out[1], unsigned i,
+                             unsigned left, unsigned right, void *, void *tmp) const noexcept
+{
+	const void *src[4];
+
+	// Mirror the edge rows.
+	for (unsigned k = 0; k < 4; ++k) {
+		unsigned row = std::clamp(static_cast<int>(i * 2 + k) - 1, 0, static_cast<int>(m_src_height) - 1);
+		src[k] = in->get_line(row);
+	}
+
+	m_func(src, out->get_line(i), tmp, m_src_width, left, right);
+}
+
+
+decimate_func select_decimate_func(PixelType type, CPUClass cpu)
+{
+	decimate_func func = nullptr;
+
+#if defined(ZIMG_X86)
+	func = select_decimate_func_x86(type, cpu);
+#endif
+
+	if (!func && type == PixelType::BYTE)
+		func = decimate_c<uint8_t>;
+	if (!func && type == PixelType::WORD)
+		func = decimate_c<uint16_t>;
+	if (!func && type == PixelType::FLOAT)
+		func = decimate_c<float>;
+	if (!func)
+		error::throw_<error::InternalError>("unsupported pixel type");
+
+	return func;
+}
+
+} // namespace zimg::resize
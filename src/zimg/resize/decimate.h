@@ -0,0 +1,45 @@
+#pragma once
+
+#ifndef ZIMG_RESIZE_DECIMATE_H_
+#define ZIMG_RESIZE_DECIMATE_H_
+
+#include <memory>
+#include "graph/filter_base.h"
+
+namespace zimg {
+enum class CPUClass;
+enum class PixelType;
+}
+
+namespace zimg::resize {
+
+// Computes output columns [left, right) from four input rows of width |src_width|.
+// The scratch buffer holds one float or 32-bit integer row of |src_width + 2| samples.
+typedef void (*decimate_func)(const void * const src[4], void *dst, void *tmp, unsigned src_width, unsigned left, unsigned right);
+
+// Halves the width and height of an image.
+//
+// Each output sample is the separable [1 3 3 1] / 8 filter centered between
+// two input samples in each direction, which equals bilinear resampling at an
+// exact 2:1 ratio with the same edge handling as compute_filter. The fixed
+// taps allow a single pass with one rounding step for integer types.
+class DecimateFilter : public graph::FilterBase {
+	decimate_func m_func;
+	unsigned m_src_width;
+	unsigned m_src_height;
+public:
+	DecimateFilter(unsigned src_width, unsigned src_height, PixelType type, CPUClass cpu);
+
+	pair_unsigned get_row_deps(unsigned i) const noexcept override;
+
+	pair_unsigned get_col_deps(unsigned left, unsigned right) const noexcept override;
+
+	void process(const graphengine::BufferDescriptor in[1], const graphengine::BufferDescriptor out[1], unsigned i,
+	             unsigned left, unsigned right, void *, void *tmp) const noexcept override;
+};
+
+decimate_func select_decimate_func(PixelType type, CPUClass cpu);
+
+} // namespace zimg::resize
+
+#endif // ZIMG_RESIZE_DECIMATE_H_
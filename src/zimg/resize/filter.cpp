@@ -1,14 +1,24 @@
 #include <algorithm>
+#include <array>
 #include <cfloat>
 #include <climits>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <map>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
 #include <vector>
+#include "common/align.h"
 #include "common/except.h"
 #include "common/libm_wrapper.h"
-#include "common/matrix.h"
+#include "common/table_record.h"
+#include "common/weak_cache.h"
 #include "common/zassert.h"
 #include "filter.h"
 
@@ -40,8 +50,48 @@ double round_halfup(double x) noexcept
 }
 
 
-FilterContext matrix_to_filter(const RowMatrix<double> &m)
+// Filter weights stored as one dense run of columns per row. The layout
+// matches a RowMatrix built by assigning each coefficient, but without the
+// per-element bounds checks and reallocations.
+class FilterMatrix {
+	std::vector<double> m_data;
+	std::vector<size_t> m_offset;
+	std::vector<size_t> m_left;
+	std::vector<size_t> m_right;
+	size_t m_cols;
+public:
+	FilterMatrix(size_t rows, size_t cols, size_t row_capacity) : m_cols{ cols }
+	{
+		m_data.reserve(rows * row_capacity);
+		m_offset.reserve(rows);
+		m_left.reserve(rows);
+		m_right.reserve(rows);
+	}
+
+	void add_row(size_t left, size_t right, const double *data)
+	{
+		m_offset.push_back(m_data.size());
+		m_left.push_back(left);
+		m_right.push_back(right);
+		m_data.insert(m_data.end(), data, data + (right - left));
+	}
+
+	size_t rows() const noexcept { return m_left.size(); }
+	size_t cols() const noexcept { return m_cols; }
+
+	size_t row_left(size_t i) const noexcept { return m_left[i]; }
+	size_t row_right(size_t i) const noexcept { return m_right[i]; }
+
+	double val(size_t i, size_t j) const noexcept
+	{
+		return j < m_left[i] || j >= m_right[i] ? 0.0 : m_data[m_offset[i] + j - m_left[i]];
+	}
+};
+
+FilterContext matrix_to_filter(const FilterMatrix &m, FilterPrecision precision)
 {
+	bool want_f32 = precision != FilterPrecision::INT16;
+	bool want_i16 = precision != FilterPrecision::FLOAT;
 	size_t width = 0;
 
 	for (size_t i = 0; i < m.rows(); ++i) {
@@ -55,6 +105,12 @@ FilterContext matrix_to_filter(const RowMatrix<double> &m)
 		error::throw_<error::OutOfMemory>();
 
 	FilterContext e{};
+	std::vector<float> row_f32(width);
+	std::vector<int16_t> row_i16(width);
+	std::vector<float> phases_f32;
+	std::vector<int16_t> phases_i16;
+	std::map<std::string, unsigned> phase_map;
+	std::string key;
 
 	try {
 		e.filter_width = static_cast<unsigned>(width);
@@ -66,9 +122,8 @@ FilterContext matrix_to_filter(const RowMatrix<double> &m)
 		if (e.filter_rows > UINT_MAX / e.stride || e.filter_rows > UINT_MAX / e.stride_i16)
 			error::throw_<error::OutOfMemory>();
 
-		e.data.resize(static_cast<size_t>(e.stride) * e.filter_rows);
-		e.data_i16.resize(static_cast<size_t>(e.stride_i16) * e.filter_rows);
 		e.left.resize(e.filter_rows);
+		e.phase.resize(e.filter_rows);
 	} catch (const std::length_error &) {
 		error::throw_<error::OutOfMemory>();
 	}
@@ -88,7 +143,7 @@ FilterContext matrix_to_filter(const RowMatrix<double> &m)
 		 * continues to sum as close to 1.0 as possible after rounding.
 		 */
 		for (size_t j = 0; j < width; ++j) {
-			double coeff = m[i][left + j];
+			double coeff = m.val(i, left + j);
 
 			double coeff_expected_f32 = coeff - f32_err;
 			double coeff_expected_i16 = coeff * (1 << 14) - i16_err;
@@ -107,8 +162,8 @@ FilterContext matrix_to_filter(const RowMatrix<double> &m)
 			f32_sum += coeff_f32;
 			i16_sum += coeff_i16;
 
-			e.data[i * e.stride + j] = coeff_f32;
-			e.data_i16[i * e.stride_i16 + j] = coeff_i16;
+			row_f32[j] = coeff_f32;
+			row_i16[j] = coeff_i16;
 		}
 
 		/* The final sum may still be off by a few ULP. This can not be fixed for
@@ -118,19 +173,137 @@ FilterContext matrix_to_filter(const RowMatrix<double> &m)
 		zassert_d(1.0 - f32_sum <= FLT_EPSILON, "error too great");
 		zassert_d(std::abs((1 << 14) - i16_sum) <= 1, "error too great");
 
-		e.data_i16[i * e.stride_i16 + i16_greatest_idx] += (1 << 14) - i16_sum;
+		row_i16[i16_greatest_idx] += (1 << 14) - i16_sum;
+
+		// Rows are matched on their stored bit patterns, so only coefficients
+		// that produce identical output are shared.
+		key.clear();
+		if (want_f32)
+			key.append(reinterpret_cast<const char *>(row_f32.data()), width * sizeof(float));
+		if (want_i16)
+			key.append(reinterpret_cast<const char *>(row_i16.data()), width * sizeof(int16_t));
+
+		auto it = phase_map.find(key);
+		if (it == phase_map.end()) {
+			it = phase_map.emplace(key, static_cast<unsigned>(phase_map.size())).first;
+
+			if (want_f32)
+				phases_f32.insert(phases_f32.end(), row_f32.begin(), row_f32.end());
+			if (want_i16)
+				phases_i16.insert(phases_i16.end(), row_i16.begin(), row_i16.end());
+		}
 
 		e.left[i] = left;
+		e.phase[i] = it->second;
+	}
+
+	e.num_phases = static_cast<unsigned>(phase_map.size());
+
+	try {
+		if (want_f32)
+			e.data.resize(static_cast<size_t>(e.stride) * e.num_phases);
+		if (want_i16)
+			e.data_i16.resize(static_cast<size_t>(e.stride_i16) * e.num_phases);
+	} catch (const std::length_error &) {
+		error::throw_<error::OutOfMemory>();
+	}
+
+	for (size_t p = 0; p < e.num_phases; ++p) {
+		if (want_f32)
+			std::copy_n(phases_f32.begin() + p * width, width, e.data.begin() + p * e.stride);
+		if (want_i16)
+			std::copy_n(phases_i16.begin() + p * width, width, e.data_i16.begin() + p * e.stride_i16);
 	}
 
 	return e;
 }
 
+
+// Shares immutable filter coefficients between filters with identical parameters.
+class FilterContextCache {
+	struct key_type {
+		std::type_index type;
+		std::array<double, 2> params;
+		unsigned src_dim;
+		unsigned dst_dim;
+		double shift;
+		double subwidth;
+		FilterPrecision precision;
+
+		bool operator<(const key_type &other) const noexcept
+		{
+			return std::tie(type, params, src_dim, dst_dim, shift, subwidth, precision) <
+				std::tie(other.type, other.params, other.src_dim, other.dst_dim, other.shift, other.subwidth, other.precision);
+		}
+	};
+
+	weak_cache<key_type, const FilterContext, 16> m_cache;
+
+	std::shared_ptr<const FilterContext> get_cached(const Filter &filter, unsigned src_dim, unsigned dst_dim, double shift, double subwidth, FilterPrecision precision)
+	{
+		key_type key{ typeid(filter), filter.params(), src_dim, dst_dim, shift, subwidth, precision };
+		auto compute = [&]() { return std::make_shared<const FilterContext>(compute_filter(filter, src_dim, dst_dim, shift, subwidth, precision)); };
+
+		// Unordered values can not be used as keys.
+		if (!std::isfinite(key.params[0]) || !std::isfinite(key.params[1]) || !std::isfinite(shift) || !std::isfinite(subwidth))
+			return compute();
+
+		return m_cache.get(key, compute);
+	}
+
+	static TableRecord::key_type record_key(const Filter &filter, unsigned src_dim, unsigned dst_dim, double shift, double subwidth, FilterPrecision precision)
+	{
+		// The filter type is identified by its name, which is stable across processes.
+		uint64_t type_hash = 0xCBF29CE484222325ULL;
+		for (const char *p = typeid(filter).name(); *p; ++p) {
+			type_hash = (type_hash ^ static_cast<unsigned char>(*p)) * 0x100000001B3ULL;
+		}
+
+		std::array<double, 2> params = filter.params();
+		return{ type_hash, table_key_bits(params[0]), table_key_bits(params[1]), src_dim, dst_dim,
+			table_key_bits(shift), table_key_bits(subwidth), static_cast<uint64_t>(precision) };
+	}
+public:
+	std::shared_ptr<const FilterContext> get(const Filter &filter, unsigned src_dim, unsigned dst_dim, double shift, double subwidth, FilterPrecision precision)
+	{
+		TableRecord *record = TableRecord::current();
+		if (!record)
+			return get_cached(filter, src_dim, dst_dim, shift, subwidth, precision);
+
+		TableRecord::key_type key = record_key(filter, src_dim, dst_dim, shift, subwidth, precision);
+
+		if (record->is_replay()) {
+			if (const TableRecord::entry *entry = record->find(TableRecord::Kind::RESIZE_FILTER, key)) {
+				auto ctx = std::static_pointer_cast<const FilterContext>(entry->table);
+				bool has_f32 = precision != FilterPrecision::INT16;
+				bool has_i16 = precision != FilterPrecision::FLOAT;
+
+				// Recorded filters are only used if they fit the kernels reading them.
+				if (ctx->input_width == src_dim && ctx->filter_rows == dst_dim && has_f32 == !ctx->data.empty() && has_i16 == !ctx->data_i16.empty())
+					return ctx;
+			}
+			return get_cached(filter, src_dim, dst_dim, shift, subwidth, precision);
+		}
+
+		std::shared_ptr<const FilterContext> ctx = get_cached(filter, src_dim, dst_dim, shift, subwidth, precision);
+		record->add(TableRecord::Kind::RESIZE_FILTER, std::move(key), ctx);
+		return ctx;
+	}
+};
+
+FilterContextCache &filter_context_cache()
+{
+	static FilterContextCache cache;
+	return cache;
+}
+
 } // namespace
 
 
 Filter::~Filter() = default;
 
+std::array<double, 2> Filter::params() const { return{}; }
+
 unsigned PointFilter::support() const { return 0; }
 
 double PointFilter::operator()(double x) const { return 1.0; }
@@ -145,6 +318,8 @@ double BilinearFilter::operator()(double x) const
 
 
 BicubicFilter::BicubicFilter(double b, double c) :
+	b{ b },
+	c{ c },
 	p0{ (  6.0 -  2.0 * b           ) / 6.0 },
 	p2{ (-18.0 + 12.0 * b +  6.0 * c) / 6.0 },
 	p3{ ( 12.0 -  9.0 * b -  6.0 * c) / 6.0 },
@@ -168,6 +343,8 @@ double BicubicFilter::operator()(double x) const
 		return 0.0;
 }
 
+std::array<double, 2> BicubicFilter::params() const { return{ b, c }; }
+
 
 unsigned Spline16Filter::support() const { return 2; }
 
@@ -245,8 +422,10 @@ double LanczosFilter::operator()(double x) const
 	return x < taps ? sinc(x) * sinc(x / taps) : 0.0;
 }
 
+std::array<double, 2> LanczosFilter::params() const { return{ static_cast<double>(taps), 0.0 }; }
+
 
-FilterContext compute_filter(const Filter &f, unsigned src_dim, unsigned dst_dim, double shift, double width)
+FilterContext compute_filter(const Filter &f, unsigned src_dim, unsigned dst_dim, double shift, double width, FilterPrecision precision)
 {
 	double scale = static_cast<double>(dst_dim) / width;
 	double step = std::min(scale, 1.0);
@@ -257,7 +436,10 @@ FilterContext compute_filter(const Filter &f, unsigned src_dim, unsigned dst_dim
 		error::throw_<error::ResamplingNotAvailable>("filter width too great");
 
 	try {
-		RowMatrix<double> m{ dst_dim, src_dim };
+		FilterMatrix m{ dst_dim, src_dim, filter_size };
+		std::vector<double> weights(filter_size);
+		std::vector<size_t> indices(filter_size);
+		std::vector<double> row;
 
 		for (unsigned i = 0; i < dst_dim; ++i) {
 			// Position of output sample on input grid.
@@ -267,10 +449,12 @@ FilterContext compute_filter(const Filter &f, unsigned src_dim, unsigned dst_dim
 			double total = 0.0;
 			for (unsigned j = 0; j < filter_size; ++j) {
 				double xpos = begin_pos + j;
-				total += f((xpos - pos) * step);
+				weights[j] = f((xpos - pos) * step);
+				total += weights[j];
 			}
 
 			size_t left = SIZE_MAX;
+			size_t last = 0;
 
 			for (unsigned j = 0; j < filter_size; ++j) {
 				double xpos = begin_pos + j;
@@ -287,22 +471,38 @@ FilterContext compute_filter(const Filter &f, unsigned src_dim, unsigned dst_dim
 				// Clamp the position if it is still out of bounds.
 				real_pos = std::clamp(real_pos, 0.0, std::nextafter(src_dim, -INFINITY));
 
-				size_t idx = static_cast<size_t>(std::floor(real_pos));
-				m[i][idx] += f((xpos - pos) * step) / total;
-				left = std::min(left, idx);
+				indices[j] = static_cast<size_t>(std::floor(real_pos));
+				left = std::min(left, indices[j]);
+				last = std::max(last, indices[j]);
 			}
 
-			// Force allocating an entry to keep the left offset table sorted.
-			if (m[i][left] == 0.0) {
-				m[i][left] = DBL_EPSILON;
-				m[i][left] = 0.0;
+			// The leftmost entry is always kept, so that the left offset table
+			// stays sorted. Other entries extend the row only once non-zero.
+			size_t right = left + 1;
+			row.assign(last - left + 1, 0.0);
+
+			for (unsigned j = 0; j < filter_size; ++j) {
+				double &coeff = row[indices[j] - left];
+				double sum = coeff + weights[j] / total;
+
+				if (sum != coeff) {
+					coeff = sum;
+					right = std::max(right, indices[j] + 1);
+				}
 			}
+
+			m.add_row(left, right, row.data());
 		}
 
-		return matrix_to_filter(m);
+		return matrix_to_filter(m, precision);
 	} catch (const std::length_error &) {
 		error::throw_<error::OutOfMemory>();
 	}
 }
 
+std::shared_ptr<const FilterContext> get_filter_context(const Filter &f, unsigned src_dim, unsigned dst_dim, double shift, double width, FilterPrecision precision)
+{
+	return filter_context_cache().get(f, src_dim, dst_dim, shift, width, precision);
+}
+
 } // namespace zimg::resize
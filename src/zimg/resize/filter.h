@@ -3,7 +3,9 @@
 #ifndef ZIMG_RESIZE_FILTER_H_
 #define ZIMG_RESIZE_FILTER_H_
 
+#include <array>
 #include <cstddef>
+#include <memory>
 #include "common/alloc.h"
 
 namespace zimg::resize {
@@ -28,6 +30,14 @@ public:
 	 * @return filter coefficient at position
 	 */
 	virtual double operator()(double x) const = 0;
+
+	/**
+	 * Filters of the same type with equal parameters compute identical taps.
+	 * Filters with configurable behaviour must override this function.
+	 *
+	 * @return filter parameters
+	 */
+	virtual std::array<double, 2> params() const;
 };
 
 /**
@@ -59,6 +69,7 @@ public:
 	static constexpr double DEFAULT_B = 0.0;
 	static constexpr double DEFAULT_C = 0.5;
 private:
+	double b, c;
 	double p0, p2, p3;
 	double q0, q1, q2, q3;
 public:
@@ -73,6 +84,8 @@ public:
 	unsigned support() const override;
 
 	double operator()(double x) const override;
+
+	std::array<double, 2> params() const override;
 };
 
 /**
@@ -125,10 +138,25 @@ public:
 	unsigned support() const override;
 
 	double operator()(double x) const override;
+
+	std::array<double, 2> params() const override;
+};
+
+/**
+ * Coefficient formats to compute for a filter.
+ */
+enum class FilterPrecision {
+	FLOAT,
+	INT16,
+	ALL,
 };
 
 /**
  * Computed filter taps for a given scale and shift.
+ *
+ * Rows with identical coefficients, such as the repeating phases of a
+ * rational scale factor, share storage. Row i uses the coefficients at
+ * phase[i] * stride in the data arrays.
  */
 struct FilterContext {
 	/**
@@ -141,6 +169,11 @@ struct FilterContext {
 	 */
 	unsigned filter_rows;
 
+	/**
+	 * Number of distinct coefficient rows.
+	 */
+	unsigned num_phases;
+
 	/**
 	 * Width of the filter input.
 	 */
@@ -153,7 +186,8 @@ struct FilterContext {
 	unsigned stride_i16;
 
 	/**
-	 * Filter data. Integer data is signed 1.14 fixed point.
+	 * Filter data, one row per phase. Integer data is signed 1.14 fixed point.
+	 * Formats not requested by the {@link FilterPrecision} are left empty.
 	 */
 	AlignedVector<float> data;
 	AlignedVector<int16_t> data_i16;
@@ -162,6 +196,11 @@ struct FilterContext {
 	 * Indices of leftmost non-zero coefficients.
 	 */
 	AlignedVector<unsigned> left;
+
+	/**
+	 * Index of the coefficient row used by each filter row.
+	 */
+	AlignedVector<unsigned> phase;
 };
 
 /**
@@ -173,9 +212,21 @@ struct FilterContext {
  * @param dst_dim target dimension in pixels
  * @param shift shift to apply in units of source pixels
  * @param width active subwindow in units of source pixels
+ * @param precision coefficient formats to compute
  * @return the computed filter
  */
-FilterContext compute_filter(const Filter &f, unsigned src_dim, unsigned dst_dim, double shift, double width);
+FilterContext compute_filter(const Filter &f, unsigned src_dim, unsigned dst_dim, double shift, double width,
+                             FilterPrecision precision = FilterPrecision::ALL);
+
+/**
+ * Compute the resizing function as in {@link compute_filter}, sharing the
+ * result between all callers with identical parameters. Recently computed
+ * filters are kept alive, so rebuilding a graph does not recompute them.
+ *
+ * @see compute_filter
+ */
+std::shared_ptr<const FilterContext> get_filter_context(const Filter &f, unsigned src_dim, unsigned dst_dim, double shift, double width,
+                                                        FilterPrecision precision = FilterPrecision::ALL);
 
 } // namespace zimg::resize
 
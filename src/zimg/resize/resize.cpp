@@ -32,9 +32,24 @@ ResizeConversion::ResizeConversion(unsigned src_width, unsigned src_height, Pixe
 	shift_h{},
 	subwidth{ static_cast<double>(src_width) },
 	subheight{ static_cast<double>(src_height) },
-	cpu{ CPUClass::NONE }
+	cpu{ CPUClass::NONE },
+	color_planes{ 1 },
+	premultiply{},
+	unpremultiply{}
 {}
 
+bool ResizeConversion::premultiply_supported() const
+{
+	bool skip_h = (src_width == dst_width && shift_w == 0 && subwidth == src_width);
+	bool skip_v = (src_height == dst_height && shift_h == 0 && subheight == src_height);
+
+	if (type != PixelType::FLOAT || skip_h)
+		return false;
+
+	// Do not override the pass order chosen by the cost model.
+	return skip_v || resize_h_first(static_cast<double>(dst_width) / subwidth, static_cast<double>(dst_height) / subheight);
+}
+
 auto ResizeConversion::create() const -> filter_pair try
 {
 	if (src_width > pixel_max_width(type) || dst_width > pixel_max_width(type))
@@ -45,11 +60,17 @@ auto ResizeConversion::create() const -> filter_pair try
 
 	if (skip_h && skip_v)
 		return{};
+	if ((premultiply && !premultiply_supported()) || (unpremultiply && type != PixelType::FLOAT))
+		error::throw_<error::InternalError>("unsupported alpha resize");
 
 	auto builder = ResizeImplBuilder{ src_width, src_height, type }
 		.set_depth(depth)
 		.set_filter(filter)
-		.set_cpu(cpu);
+		.set_cpu(cpu)
+		.set_color_planes(color_planes)
+		.set_premultiply(premultiply)
+		.set_unpremultiply(unpremultiply && (skip_h || skip_v))
+		.set_resize_alpha(unpremultiply);
 	filter_pair ret{};
 
 	if (skip_h) {
@@ -79,6 +100,8 @@ auto ResizeConversion::create() const -> filter_pair try
 			                    .set_dst_dim(dst_height)
 			                    .set_shift(shift_h)
 			                    .set_subwidth(subheight)
+			                    .set_premultiply(false)
+			                    .set_unpremultiply(unpremultiply)
 			                    .create();
 		} else {
 			ret.first = builder.set_horizontal(false)
@@ -92,6 +115,7 @@ auto ResizeConversion::create() const -> filter_pair try
 			                    .set_dst_dim(dst_width)
 			                    .set_shift(shift_w)
 			                    .set_subwidth(subwidth)
+			                    .set_unpremultiply(unpremultiply)
 			                    .create();
 		}
 	}
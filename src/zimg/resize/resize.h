@@ -36,10 +36,34 @@ struct ResizeConversion {
 	BUILDER_MEMBER(double, subwidth)
 	BUILDER_MEMBER(double, subheight)
 	BUILDER_MEMBER(CPUClass, cpu)
+	BUILDER_MEMBER(unsigned, color_planes)
+	BUILDER_MEMBER(bool, premultiply)
+	BUILDER_MEMBER(bool, unpremultiply)
 #undef BUILDER_MEMBER
 
 	ResizeConversion(unsigned src_width, unsigned src_height, PixelType type);
 
+	/**
+	 * Check if premultiplication can be fused into the first pass.
+	 *
+	 * Fused premultiplication requires a horizontal pass that is performed
+	 * first, so it is not supported if a vertical pass is cheaper to do first.
+	 *
+	 * @return true if {@link premultiply} may be set
+	 */
+	bool premultiply_supported() const;
+
+	/**
+	 * Create the filters for the conversion.
+	 *
+	 * If {@link premultiply} or {@link unpremultiply} is set, each filter
+	 * takes |color_planes| color planes followed by an alpha plane. The
+	 * first pass multiplies the color planes by alpha, and the last pass
+	 * divides them by the resized alpha. With {@link unpremultiply}, the
+	 * resized alpha plane is also the last output of each pass.
+	 *
+	 * @return pair of filters, which may be null
+	 */
 	filter_pair create() const;
 };
 
@@ -1,10 +1,13 @@
 #include <algorithm>
 #include <climits>
 #include <cstdint>
+#include "common/align.h"
+#include "common/checked_int.h"
 #include "common/cpuinfo.h"
 #include "common/except.h"
 #include "common/pixel.h"
 #include "common/zassert.h"
+#include "graph/simple_filters.h"
 #include "filter.h"
 #include "resize_impl.h"
 
@@ -12,6 +15,8 @@
   #include "x86/resize_impl_x86.h"
 #elif defined(ZIMG_ARM)
   #include "arm/resize_impl_arm.h"
+#elif defined(ZIMG_VEC)
+  #include "vec/resize_impl_vec.h"
 #endif
 
 namespace zimg::resize {
@@ -41,6 +46,31 @@ uint16_t pack_pixel_u16(int32_t x, int32_t pixel_max) noexcept
 	return static_cast<uint16_t>(x);
 }
 
+uint8_t pack_pixel_u8(int32_t x, int32_t pixel_max) noexcept
+{
+	x = (x + (1 << 13)) >> 14;
+	x = std::max(std::min(x, pixel_max), static_cast<int32_t>(0));
+
+	return static_cast<uint8_t>(x);
+}
+
+void resize_line_h_u8_c(const FilterContext &filter, const uint8_t *src, uint8_t *dst, unsigned left, unsigned right, unsigned pixel_max)
+{
+	for (unsigned j = left; j < right; ++j) {
+		unsigned left = filter.left[j];
+		int32_t accum = 0;
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			int32_t coeff = filter.data_i16[filter.phase[j] * filter.stride_i16 + k];
+			int32_t x = src[left + k];
+
+			accum += coeff * x;
+		}
+
+		dst[j] = pack_pixel_u8(accum, pixel_max);
+	}
+}
+
 void resize_line_h_u16_c(const FilterContext &filter, const uint16_t *src, uint16_t *dst, unsigned left, unsigned right, unsigned pixel_max)
 {
 	for (unsigned j = left; j < right; ++j) {
@@ -48,7 +78,7 @@ void resize_line_h_u16_c(const FilterContext &filter, const uint16_t *src, uint1
 		int32_t accum = 0;
 
 		for (unsigned k = 0; k < filter.filter_width; ++k) {
-			int32_t coeff = filter.data_i16[j * filter.stride_i16 + k];
+			int32_t coeff = filter.data_i16[filter.phase[j] * filter.stride_i16 + k];
 			int32_t x = unpack_pixel_u16(src[left + k]);
 
 			accum += coeff * x;
@@ -65,7 +95,7 @@ void resize_line_h_f32_c(const FilterContext &filter, const float *src, float *d
 		float accum = 0;
 
 		for (unsigned k = 0; k < filter.filter_width; ++k) {
-			float coeff = filter.data[j * filter.stride + k];
+			float coeff = filter.data[filter.phase[j] * filter.stride + k];
 			float x = src[top + k];
 
 			accum += coeff * x;
@@ -75,9 +105,50 @@ void resize_line_h_f32_c(const FilterContext &filter, const float *src, float *d
 	}
 }
 
+void resize_line3_h_f32_c(const FilterContext &filter, const float * const src[3], float * const dst[3], unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		unsigned top = filter.left[j];
+		float accum0 = 0;
+		float accum1 = 0;
+		float accum2 = 0;
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			float coeff = filter.data[filter.phase[j] * filter.stride + k];
+
+			accum0 += coeff * src[0][top + k];
+			accum1 += coeff * src[1][top + k];
+			accum2 += coeff * src[2][top + k];
+		}
+
+		dst[0][j] = accum0;
+		dst[1][j] = accum1;
+		dst[2][j] = accum2;
+	}
+}
+
+void resize_line_v_u8_c(const FilterContext &filter, const Buffer<const uint8_t> &src, const Buffer<uint8_t> &dst, unsigned i, unsigned left, unsigned right, unsigned pixel_max)
+{
+	const int16_t *filter_coeffs = &filter.data_i16[filter.phase[i] * filter.stride_i16];
+	unsigned top = filter.left[i];
+
+	for (unsigned j = left; j < right; ++j) {
+		int32_t accum = 0;
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			int32_t coeff = filter_coeffs[k];
+			int32_t x = src[top + k][j];
+
+			accum += coeff * x;
+		}
+
+		dst[i][j] = pack_pixel_u8(accum, pixel_max);
+	}
+}
+
 void resize_line_v_u16_c(const FilterContext &filter, const Buffer<const uint16_t> &src, const Buffer<uint16_t> &dst, unsigned i, unsigned left, unsigned right, unsigned pixel_max)
 {
-	const int16_t *filter_coeffs = &filter.data_i16[i * filter.stride_i16];
+	const int16_t *filter_coeffs = &filter.data_i16[filter.phase[i] * filter.stride_i16];
 	unsigned top = filter.left[i];
 
 	for (unsigned j = left; j < right; ++j) {
@@ -96,7 +167,7 @@ void resize_line_v_u16_c(const FilterContext &filter, const Buffer<const uint16_
 
 void resize_line_v_f32_c(const FilterContext &filter, const Buffer<const float> &src, const Buffer<float> &dst, unsigned i, unsigned left, unsigned right)
 {
-	const float *filter_coeffs = &filter.data[i * filter.stride];
+	const float *filter_coeffs = &filter.data[filter.phase[i] * filter.stride];
 	unsigned top = filter.left[i];
 
 	for (unsigned j = left; j < right; ++j) {
@@ -118,22 +189,42 @@ class ResizeImplH_C : public ResizeImplH {
 	PixelType m_type;
 	uint32_t m_pixel_max;
 public:
-	ResizeImplH_C(const FilterContext &filter, unsigned height, PixelType type, unsigned depth) :
+	ResizeImplH_C(const std::shared_ptr<const FilterContext> &filter, unsigned height, PixelType type, unsigned depth) :
 		ResizeImplH(filter, height, type),
 		m_type{ type },
 		m_pixel_max{ static_cast<uint32_t>(1UL << depth) - 1 }
 	{
-		if (m_type != PixelType::WORD && m_type != PixelType::FLOAT)
+		if (m_type != PixelType::BYTE && m_type != PixelType::WORD && m_type != PixelType::FLOAT)
 			error::throw_<error::InternalError>("pixel type not supported");
 	}
 
 	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
 	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override
 	{
-		if (m_type == PixelType::WORD)
-			resize_line_h_u16_c(m_filter, in->get_line<uint16_t>(i), out->get_line<uint16_t>(i), left, right, m_pixel_max);
+		if (m_type == PixelType::BYTE)
+			resize_line_h_u8_c(*m_filter, in->get_line<uint8_t>(i), out->get_line<uint8_t>(i), left, right, m_pixel_max);
+		else if (m_type == PixelType::WORD)
+			resize_line_h_u16_c(*m_filter, in->get_line<uint16_t>(i), out->get_line<uint16_t>(i), left, right, m_pixel_max);
 		else
-			resize_line_h_f32_c(m_filter, in->get_line<float>(i), out->get_line<float>(i), left, right);
+			resize_line_h_f32_c(*m_filter, in->get_line<float>(i), out->get_line<float>(i), left, right);
+	}
+};
+
+class ResizeImplH3_C : public ResizeImplH {
+public:
+	ResizeImplH3_C(const std::shared_ptr<const FilterContext> &filter, unsigned height) :
+		ResizeImplH(filter, height, PixelType::FLOAT)
+	{
+		m_desc.num_deps = 3;
+		m_desc.num_planes = 3;
+	}
+
+	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
+	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override
+	{
+		const float *src[3] = { in[0].get_line<float>(i), in[1].get_line<float>(i), in[2].get_line<float>(i) };
+		float *dst[3] = { out[0].get_line<float>(i), out[1].get_line<float>(i), out[2].get_line<float>(i) };
+		resize_line3_h_f32_c(*m_filter, src, dst, left, right);
 	}
 };
 
@@ -141,40 +232,179 @@ class ResizeImplV_C : public ResizeImplV {
 	PixelType m_type;
 	uint32_t m_pixel_max;
 public:
-	ResizeImplV_C(const FilterContext &filter, unsigned width, PixelType type, unsigned depth) :
+	ResizeImplV_C(const std::shared_ptr<const FilterContext> &filter, unsigned width, PixelType type, unsigned depth) :
 		ResizeImplV(filter, width, type),
 		m_type{ type },
 		m_pixel_max{ static_cast<uint32_t>(1UL << depth) - 1 }
 	{
-		if (m_type != PixelType::WORD && m_type != PixelType::FLOAT)
+		if (m_type != PixelType::BYTE && m_type != PixelType::WORD && m_type != PixelType::FLOAT)
 			error::throw_<error::InternalError>("pixel type not supported");
 	}
 
 	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
 	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override
 	{
-		if (m_type == PixelType::WORD)
-			resize_line_v_u16_c(m_filter, *in, *out, i, left, right, m_pixel_max);
+		if (m_type == PixelType::BYTE)
+			resize_line_v_u8_c(*m_filter, *in, *out, i, left, right, m_pixel_max);
+		else if (m_type == PixelType::WORD)
+			resize_line_v_u16_c(*m_filter, *in, *out, i, left, right, m_pixel_max);
 		else
-			resize_line_v_f32_c(m_filter, *in, *out, i, left, right);
+			resize_line_v_f32_c(*m_filter, *in, *out, i, left, right);
+	}
+};
+
+
+// Applies a single-plane resize pass to several planes in one node.
+class ResizeImplPlanes : public graph::FilterBase {
+	std::unique_ptr<graphengine::Filter> m_impl;
+	unsigned m_planes;
+public:
+	ResizeImplPlanes(std::unique_ptr<graphengine::Filter> impl, unsigned planes) :
+		m_impl(std::move(impl)),
+		m_planes{ planes }
+	{
+		zassert_d(planes && planes <= graphengine::NODE_MAX_PLANES, "too many planes");
+		zassert_d(!m_impl->descriptor().flags.stateful, "stateful filter");
+
+		m_desc = m_impl->descriptor();
+		m_desc.num_deps = planes;
+		m_desc.num_planes = planes;
+	}
+
+	pair_unsigned get_row_deps(unsigned i) const noexcept override { return m_impl->get_row_deps(i); }
+
+	pair_unsigned get_col_deps(unsigned left, unsigned right) const noexcept override { return m_impl->get_col_deps(left, right); }
+
+	void init_context(void *context) const noexcept override { m_impl->init_context(context); }
+
+	void process(const graphengine::BufferDescriptor in[], const graphengine::BufferDescriptor out[],
+	             unsigned i, unsigned left, unsigned right, void *context, void *tmp) const noexcept override
+	{
+		for (unsigned p = 0; p < m_planes; ++p) {
+			m_impl->process(&in[p], &out[p], i, left, right, context, tmp);
+		}
+	}
+};
+
+// Applies a resize pass to several color planes sharing an alpha plane.
+class ResizeImplAlpha : public graph::FilterBase {
+	std::unique_ptr<graphengine::Filter> m_impl;
+	graph::premultiply_func m_premultiply;
+	graph::premultiply_func m_unpremultiply;
+	size_t m_impl_scratchpad_size;
+	size_t m_row_stride;
+	unsigned m_row_mask;
+	unsigned m_src_width;
+	unsigned m_color_planes;
+	bool m_resize_alpha;
+
+	// Premultiplies the rows and columns read by |m_impl| into a ring buffer.
+	graphengine::BufferDescriptor premultiply_rows(const graphengine::BufferDescriptor &src, const graphengine::BufferDescriptor &alpha,
+	                                               unsigned i, unsigned left, unsigned right, void *tmp) const noexcept
+	{
+		auto row_range = m_impl->get_row_deps(i);
+		auto col_range = m_impl->get_col_deps(left, right);
+
+		// Match the aligned loads of the vectorized resizers.
+		unsigned col_left = floor_n(col_range.first, AlignmentOf<float>);
+		unsigned col_right = std::min(ceil_n(col_range.second, AlignmentOf<float>), m_src_width);
+
+		graphengine::BufferDescriptor buf{ static_cast<unsigned char *>(tmp) + m_impl_scratchpad_size, static_cast<ptrdiff_t>(m_row_stride), m_row_mask };
+
+		for (unsigned ii = row_range.first; ii < row_range.second; ++ii) {
+			m_premultiply(src.get_line<float>(ii), alpha.get_line<float>(ii), buf.get_line<float>(ii), col_left, col_right);
+		}
+		return buf;
+	}
+public:
+	ResizeImplAlpha(std::unique_ptr<graphengine::Filter> impl, unsigned src_width, unsigned color_planes,
+	                bool premultiply, bool unpremultiply, bool resize_alpha, CPUClass cpu) :
+		m_impl(std::move(impl)),
+		m_premultiply{},
+		m_unpremultiply{},
+		m_impl_scratchpad_size{},
+		m_row_stride{},
+		m_row_mask{},
+		m_src_width{ src_width },
+		m_color_planes{ color_planes },
+		m_resize_alpha{ resize_alpha }
+	{
+		const graphengine::FilterDescriptor &desc = m_impl->descriptor();
+
+		zassert_d(color_planes && color_planes < graphengine::NODE_MAX_PLANES, "too many planes");
+		zassert_d(!unpremultiply || resize_alpha, "unpremultiplication requires resized alpha");
+		zassert_d(!desc.flags.stateful, "stateful filter");
+
+		m_desc = desc;
+		m_desc.num_deps = color_planes + 1;
+		m_desc.num_planes = color_planes + (resize_alpha ? 1 : 0);
+		m_desc.flags.in_place = false;
+
+		if (premultiply) {
+			unsigned rows = 1;
+			while (rows < desc.step) {
+				rows *= 2;
+			}
+
+			m_premultiply = graph::select_premultiply_func(cpu);
+			m_impl_scratchpad_size = ceil_n(checked_size_t{ desc.scratchpad_size }, ALIGNMENT).get();
+			m_row_stride = ceil_n(checked_size_t{ src_width } * sizeof(float), ALIGNMENT).get();
+			m_row_mask = rows - 1;
+			m_desc.scratchpad_size = (m_impl_scratchpad_size + checked_size_t{ m_row_stride } * rows).get();
+		}
+		if (unpremultiply)
+			m_unpremultiply = graph::select_unpremultiply_func(cpu);
+	}
+
+	pair_unsigned get_row_deps(unsigned i) const noexcept override { return m_impl->get_row_deps(i); }
+
+	pair_unsigned get_col_deps(unsigned left, unsigned right) const noexcept override { return m_impl->get_col_deps(left, right); }
+
+	void init_context(void *context) const noexcept override { m_impl->init_context(context); }
+
+	void process(const graphengine::BufferDescriptor in[], const graphengine::BufferDescriptor out[],
+	             unsigned i, unsigned left, unsigned right, void *context, void *tmp) const noexcept override
+	{
+		const graphengine::BufferDescriptor &alpha = in[m_color_planes];
+
+		if (m_resize_alpha)
+			m_impl->process(&alpha, &out[m_color_planes], i, left, right, context, tmp);
+
+		for (unsigned p = 0; p < m_color_planes; ++p) {
+			if (m_premultiply) {
+				graphengine::BufferDescriptor buf = premultiply_rows(in[p], alpha, i, left, right, tmp);
+				m_impl->process(&buf, &out[p], i, left, right, context, tmp);
+			} else {
+				m_impl->process(&in[p], &out[p], i, left, right, context, tmp);
+			}
+
+			if (m_unpremultiply) {
+				unsigned last = std::min(std::min(i, UINT_MAX - m_desc.step) + m_desc.step, m_desc.format.height);
+
+				for (unsigned ii = i; ii < last; ++ii) {
+					float *dst = out[p].get_line<float>(ii);
+					m_unpremultiply(dst, out[m_color_planes].get_line<float>(ii), dst, left, right);
+				}
+			}
+		}
 	}
 };
 
 } // namespace
 
 
-ResizeImplH::ResizeImplH(const FilterContext &filter, unsigned height, PixelType type) :
-	m_filter(filter)
+ResizeImplH::ResizeImplH(std::shared_ptr<const FilterContext> filter, unsigned height, PixelType type) :
+	m_filter(std::move(filter))
 {
-	zassert_d(m_filter.input_width <= pixel_max_width(type), "overflow");
-	zassert_d(m_filter.filter_rows <= pixel_max_width(type), "overflow");
+	zassert_d(m_filter->input_width <= pixel_max_width(type), "overflow");
+	zassert_d(m_filter->filter_rows <= pixel_max_width(type), "overflow");
 
-	m_desc.format = { m_filter.filter_rows, height, pixel_size(type) };
+	m_desc.format = { m_filter->filter_rows, height, pixel_size(type) };
 	m_desc.num_deps = 1;
 	m_desc.num_planes = 1;
 	m_desc.step = 1;
 
-	m_desc.flags.entire_row = !std::is_sorted(m_filter.left.begin(), m_filter.left.end());
+	m_desc.flags.entire_row = !std::is_sorted(m_filter->left.begin(), m_filter->left.end());
 }
 
 auto ResizeImplH::get_row_deps(unsigned i) const noexcept -> pair_unsigned
@@ -187,40 +417,40 @@ auto ResizeImplH::get_row_deps(unsigned i) const noexcept -> pair_unsigned
 auto ResizeImplH::get_col_deps(unsigned left, unsigned right) const noexcept -> pair_unsigned
 {
 	if (m_desc.flags.entire_row)
-		return{ 0, m_filter.input_width };
+		return{ 0, m_filter->input_width };
 
-	unsigned left_dep = m_filter.left[left];
-	unsigned right_dep = m_filter.left[right - 1] + m_filter.filter_width;
+	unsigned left_dep = m_filter->left[left];
+	unsigned right_dep = m_filter->left[right - 1] + m_filter->filter_width;
 	return{ left_dep, right_dep };
 }
 
 
-ResizeImplV::ResizeImplV(const FilterContext &filter, unsigned width, PixelType type) :
-	m_filter(filter),
+ResizeImplV::ResizeImplV(std::shared_ptr<const FilterContext> filter, unsigned width, PixelType type) :
+	m_filter(std::move(filter)),
 	m_unsorted{}
 {
 	zassert_d(width <= pixel_max_width(type), "overflow");
 
-	m_desc.format = { width, filter.filter_rows, pixel_size(type) };
+	m_desc.format = { width, m_filter->filter_rows, pixel_size(type) };
 	m_desc.num_deps = 1;
 	m_desc.num_planes = 1;
 	m_desc.step = 1;
 
-	m_unsorted = !std::is_sorted(m_filter.left.begin(), m_filter.left.end());
+	m_unsorted = !std::is_sorted(m_filter->left.begin(), m_filter->left.end());
 }
 
 auto ResizeImplV::get_row_deps(unsigned i) const noexcept -> pair_unsigned
 {
 	if (m_unsorted)
-		return{ 0, m_filter.input_width };
+		return{ 0, m_filter->input_width };
 
 	unsigned step = m_desc.step;
 	unsigned last = std::min(std::min(i, UINT_MAX - step) + step, m_desc.format.height);
-	unsigned top_dep = m_filter.left[i];
-	unsigned bot_dep = m_filter.left[last - 1];
+	unsigned top_dep = m_filter->left[i];
+	unsigned bot_dep = m_filter->left[last - 1];
 
-	zassert_d(bot_dep <= UINT_MAX - m_filter.filter_width, "overflow");
-	return{ top_dep, bot_dep + m_filter.filter_width };
+	zassert_d(bot_dep <= UINT_MAX - m_filter->filter_width, "overflow");
+	return{ top_dep, bot_dep + m_filter->filter_width };
 }
 
 auto ResizeImplV::get_col_deps(unsigned left, unsigned right) const noexcept -> pair_unsigned
@@ -239,7 +469,11 @@ ResizeImplBuilder::ResizeImplBuilder(unsigned src_width, unsigned src_height, Pi
 	filter{},
 	shift{},
 	subwidth{},
-	cpu{ CPUClass::NONE }
+	cpu{ CPUClass::NONE },
+	color_planes{ 1 },
+	premultiply{},
+	unpremultiply{},
+	resize_alpha{}
 {}
 
 std::unique_ptr<graphengine::Filter> ResizeImplBuilder::create() const
@@ -247,22 +481,52 @@ std::unique_ptr<graphengine::Filter> ResizeImplBuilder::create() const
 	std::unique_ptr<graphengine::Filter> ret;
 
 	unsigned src_dim = horizontal ? src_width : src_height;
-	FilterContext filter_ctx = compute_filter(*filter, src_dim, dst_dim, shift, subwidth);
+	// Integer kernels use fixed point coefficients, and all others use float.
+	FilterPrecision precision = pixel_is_integer(type) ? FilterPrecision::INT16 : FilterPrecision::FLOAT;
+	std::shared_ptr<const FilterContext> filter_ctx = get_filter_context(*filter, src_dim, dst_dim, shift, subwidth, precision);
+
+	// Planes without alpha are resized together. Alpha passes wrap a single-plane filter.
+	bool multi_plane = color_planes > 1 && !premultiply && !resize_alpha;
+	bool fused_planes = false;
 
 #if defined(ZIMG_X86)
-	ret = horizontal ?
-		create_resize_impl_h_x86(filter_ctx, src_height, type, depth, cpu) :
-		create_resize_impl_v_x86(filter_ctx, src_width, type, depth, cpu);
+	if (multi_plane && horizontal && color_planes == 3)
+		ret = create_resize_impl_h3_x86(filter_ctx, src_height, type, depth, cpu);
+	fused_planes = !!ret;
+
+	if (!ret) {
+		ret = horizontal ?
+			create_resize_impl_h_x86(filter_ctx, src_height, type, depth, cpu) :
+			create_resize_impl_v_x86(filter_ctx, src_width, type, depth, cpu);
+	}
 #elif defined(ZIMG_ARM)
 	ret = horizontal ?
 		create_resize_impl_h_arm(filter_ctx, src_height, type, depth, cpu) :
 		create_resize_impl_v_arm(filter_ctx, src_width, type, depth, cpu);
+#elif defined(ZIMG_VEC)
+	ret = horizontal ?
+		create_resize_impl_h_vec(filter_ctx, src_height, type, depth, cpu) :
+		create_resize_impl_v_vec(filter_ctx, src_width, type, depth, cpu);
 #endif
+	if (!ret && multi_plane && horizontal && color_planes == 3 && type == PixelType::FLOAT) {
+		ret = std::make_unique<ResizeImplH3_C>(filter_ctx, src_height);
+		fused_planes = true;
+	}
 	if (!ret && horizontal)
 		ret = std::make_unique<ResizeImplH_C>(filter_ctx, src_height, type, depth);
 	if (!ret && !horizontal)
 		ret = std::make_unique<ResizeImplV_C>(filter_ctx, src_width, type, depth);
 
+	if (multi_plane && !fused_planes)
+		ret = std::make_unique<ResizeImplPlanes>(std::move(ret), color_planes);
+
+	if (premultiply || resize_alpha) {
+		if (type != PixelType::FLOAT || (premultiply && !horizontal) || (unpremultiply && !resize_alpha))
+			error::throw_<error::InternalError>("unsupported alpha resize");
+
+		ret = std::make_unique<ResizeImplAlpha>(std::move(ret), src_width, color_planes, premultiply, unpremultiply, resize_alpha, cpu);
+	}
+
 	return ret;
 }
 
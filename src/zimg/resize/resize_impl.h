@@ -17,10 +17,13 @@ namespace zimg::resize {
 
 class ResizeImplH : public graph::FilterBase {
 protected:
-	FilterContext m_filter;
+	std::shared_ptr<const FilterContext> m_filter;
 
-	ResizeImplH(const FilterContext &filter, unsigned height, PixelType type);
+	ResizeImplH(std::shared_ptr<const FilterContext> filter, unsigned height, PixelType type);
 public:
+	// Coefficients, shared between passes with identical parameters.
+	const std::shared_ptr<const FilterContext> &filter_context() const noexcept { return m_filter; }
+
 	pair_unsigned get_row_deps(unsigned i) const noexcept override;
 
 	pair_unsigned get_col_deps(unsigned left, unsigned right) const noexcept override;
@@ -30,11 +33,13 @@ public:
 
 class ResizeImplV : public graph::FilterBase {
 protected:
-	FilterContext m_filter;
+	std::shared_ptr<const FilterContext> m_filter;
 	bool m_unsorted;
 
-	ResizeImplV(const FilterContext &filter, unsigned width, PixelType type);
+	ResizeImplV(std::shared_ptr<const FilterContext> filter, unsigned width, PixelType type);
 public:
+	const std::shared_ptr<const FilterContext> &filter_context() const noexcept { return m_filter; }
+
 	pair_unsigned get_row_deps(unsigned i) const noexcept override;
 
 	pair_unsigned get_col_deps(unsigned left, unsigned right) const noexcept override;
@@ -42,6 +47,20 @@ public:
 	void init_context(void *) const noexcept override {}
 };
 
+/**
+ * Builder for a single resize pass.
+ *
+ * If |color_planes| is greater than one, the pass processes that many planes
+ * sharing the same filter in a single node. Horizontal passes on three planes
+ * may use kernels that load each filter coefficient once for all planes.
+ *
+ * If |premultiply| or |resize_alpha| is set, the pass processes
+ * |color_planes| FLOAT planes with an alpha plane as the last input.
+ * Premultiplication is applied to the color planes as they are loaded, which
+ * is only possible for horizontal passes. If |resize_alpha| is set, the alpha
+ * plane is also resized and returned as the last output, and |unpremultiply|
+ * divides the resized color planes by it.
+ */
 struct ResizeImplBuilder {
 	unsigned src_width;
 	unsigned src_height;
@@ -55,6 +74,10 @@ struct ResizeImplBuilder {
 	BUILDER_MEMBER(double, shift)
 	BUILDER_MEMBER(double, subwidth)
 	BUILDER_MEMBER(CPUClass, cpu)
+	BUILDER_MEMBER(unsigned, color_planes)
+	BUILDER_MEMBER(bool, premultiply)
+	BUILDER_MEMBER(bool, unpremultiply)
+	BUILDER_MEMBER(bool, resize_alpha)
 #undef BUILDER_MEMBER
 
 	ResizeImplBuilder(unsigned src_width, unsigned src_height, PixelType type);
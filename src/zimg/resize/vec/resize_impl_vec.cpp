@@ -0,0 +1,527 @@
+#ifdef ZIMG_VEC
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "common/checked_int.h"
+#include "common/cpuinfo.h"
+#include "common/except.h"
+#include "common/make_array.h"
+#include "common/pixel.h"
+#include "resize/resize_impl.h"
+#include "resize_impl_vec.h"
+
+#include "common/vec/vec_util.h"
+
+namespace zimg::resize {
+
+namespace {
+
+template <class V, class T>
+void transpose_line_4x4(T * RESTRICT dst, const T * const * RESTRICT src, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; j += 4) {
+		V x0, x1, x2, x3;
+
+		x0 = vec_load<V>(src[0] + j);
+		x1 = vec_load<V>(src[1] + j);
+		x2 = vec_load<V>(src[2] + j);
+		x3 = vec_load<V>(src[3] + j);
+
+		vec_transpose4(x0, x1, x2, x3);
+
+		vec_store(dst + 0, x0);
+		vec_store(dst + 4, x1);
+		vec_store(dst + 8, x2);
+		vec_store(dst + 12, x3);
+
+		dst += 16;
+	}
+}
+
+template <class T>
+using pixel_x4 = std::conditional_t<std::is_same_v<T, uint8_t>, u8x4, u16x4>;
+
+// Words are biased to the signed range to match the scalar implementation.
+template <class T>
+inline FORCE_INLINE i32x4 import_pixel(const T *src)
+{
+	i32x4 x = vec_convert<i32x4>(vec_load<pixel_x4<T>>(src));
+
+	if constexpr (std::is_same_v<T, uint16_t>)
+		x += INT16_MIN;
+
+	return x;
+}
+
+template <class T>
+inline FORCE_INLINE pixel_x4<T> export_pixel(i32x4 x, i32x4 limit)
+{
+	x = (x + (1 << 13)) >> 14;
+
+	if constexpr (std::is_same_v<T, uint16_t>)
+		x -= INT16_MIN;
+
+	x = vec_clamp(x, i32x4{}, limit);
+	return vec_convert<pixel_x4<T>>(x);
+}
+
+
+// Taps of zero selects the runtime filter width.
+template <class T, unsigned Taps>
+inline FORCE_INLINE i32x4 resize_line4_h_int_vec_xiter(unsigned j, const unsigned *filter_left, const unsigned *filter_phase, const int16_t *filter_data, unsigned filter_stride, unsigned filter_width,
+                                                       const T *src, unsigned src_base)
+{
+	const int16_t *filter_coeffs = filter_data + filter_phase[j] * filter_stride;
+	const T *src_p = src + (filter_left[j] - src_base) * 4;
+	unsigned taps = Taps ? Taps : filter_width;
+
+	i32x4 accum = {};
+
+	for (unsigned k = 0; k < taps; ++k) {
+		int32_t c = filter_coeffs[k];
+		accum += c * import_pixel(src_p + k * 4);
+	}
+
+	return accum;
+}
+
+template <class T, unsigned Taps>
+void resize_line4_h_int_vec(const unsigned * RESTRICT filter_left, const unsigned * RESTRICT filter_phase, const int16_t * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+                            const T * RESTRICT src, T * const * RESTRICT dst, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
+{
+	const i32x4 lim = i32x4{} + limit;
+
+	unsigned vec_left = std::min(ceil_n(left, 4), right);
+	unsigned vec_right = std::max(floor_n(right, 4), vec_left);
+
+#define XITER resize_line4_h_int_vec_xiter<T, Taps>
+#define XARGS filter_left, filter_phase, filter_data, filter_stride, filter_width, src, src_base
+	for (unsigned j = left; j < vec_left; ++j) {
+		pixel_x4<T> x = export_pixel<T>(XITER(j, XARGS), lim);
+		vec_scatter4(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, x);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 4) {
+		pixel_x4<T> x0, x1, x2, x3;
+
+		x0 = export_pixel<T>(XITER(j + 0, XARGS), lim);
+		x1 = export_pixel<T>(XITER(j + 1, XARGS), lim);
+		x2 = export_pixel<T>(XITER(j + 2, XARGS), lim);
+		x3 = export_pixel<T>(XITER(j + 3, XARGS), lim);
+
+		vec_transpose4(x0, x1, x2, x3);
+
+		vec_store(dst[0] + j, x0);
+		vec_store(dst[1] + j, x1);
+		vec_store(dst[2] + j, x2);
+		vec_store(dst[3] + j, x3);
+	}
+
+	for (unsigned j = vec_right; j < right; ++j) {
+		pixel_x4<T> x = export_pixel<T>(XITER(j, XARGS), lim);
+		vec_scatter4(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, x);
+	}
+#undef XITER
+#undef XARGS
+}
+
+template <class T>
+constexpr auto resize_line4_h_int_vec_jt = make_array(
+	resize_line4_h_int_vec<T, 0>,
+	resize_line4_h_int_vec<T, 1>,
+	resize_line4_h_int_vec<T, 2>,
+	resize_line4_h_int_vec<T, 3>,
+	resize_line4_h_int_vec<T, 4>,
+	resize_line4_h_int_vec<T, 5>,
+	resize_line4_h_int_vec<T, 6>,
+	resize_line4_h_int_vec<T, 7>,
+	resize_line4_h_int_vec<T, 8>);
+
+
+template <unsigned Taps>
+inline FORCE_INLINE f32x4 resize_line4_h_f32_vec_xiter(unsigned j, const unsigned *filter_left, const unsigned *filter_phase, const float *filter_data, unsigned filter_stride, unsigned filter_width,
+                                                       const float *src, unsigned src_base)
+{
+	const float *filter_coeffs = filter_data + filter_phase[j] * filter_stride;
+	const float *src_p = src + (filter_left[j] - src_base) * 4;
+	unsigned taps = Taps ? Taps : filter_width;
+
+	f32x4 accum = {};
+
+	for (unsigned k = 0; k < taps; ++k) {
+		accum += filter_coeffs[k] * vec_load<f32x4>(src_p + k * 4);
+	}
+
+	return accum;
+}
+
+template <unsigned Taps>
+void resize_line4_h_f32_vec(const unsigned * RESTRICT filter_left, const unsigned * RESTRICT filter_phase, const float * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+                            const float * RESTRICT src, float * const * RESTRICT dst, unsigned src_base, unsigned left, unsigned right)
+{
+	unsigned vec_left = std::min(ceil_n(left, 4), right);
+	unsigned vec_right = std::max(floor_n(right, 4), vec_left);
+
+#define XITER resize_line4_h_f32_vec_xiter<Taps>
+#define XARGS filter_left, filter_phase, filter_data, filter_stride, filter_width, src, src_base
+	for (unsigned j = left; j < vec_left; ++j) {
+		f32x4 x = XITER(j, XARGS);
+		vec_scatter4(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, x);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 4) {
+		f32x4 x0, x1, x2, x3;
+
+		x0 = XITER(j + 0, XARGS);
+		x1 = XITER(j + 1, XARGS);
+		x2 = XITER(j + 2, XARGS);
+		x3 = XITER(j + 3, XARGS);
+
+		vec_transpose4(x0, x1, x2, x3);
+
+		vec_store(dst[0] + j, x0);
+		vec_store(dst[1] + j, x1);
+		vec_store(dst[2] + j, x2);
+		vec_store(dst[3] + j, x3);
+	}
+
+	for (unsigned j = vec_right; j < right; ++j) {
+		f32x4 x = XITER(j, XARGS);
+		vec_scatter4(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, x);
+	}
+#undef XITER
+#undef XARGS
+}
+
+constexpr auto resize_line4_h_f32_vec_jt = make_array(
+	resize_line4_h_f32_vec<0>,
+	resize_line4_h_f32_vec<1>,
+	resize_line4_h_f32_vec<2>,
+	resize_line4_h_f32_vec<3>,
+	resize_line4_h_f32_vec<4>,
+	resize_line4_h_f32_vec<5>,
+	resize_line4_h_f32_vec<6>,
+	resize_line4_h_f32_vec<7>,
+	resize_line4_h_f32_vec<8>);
+
+
+// Accumulators are kept in 32-bit integers between batches of eight taps.
+template <class T, unsigned Taps, bool Initial, bool Final>
+void resize_line_v_int_vec(const int16_t * RESTRICT filter_data, const T * const * RESTRICT src, T * RESTRICT dst, int32_t * RESTRICT accum,
+                           unsigned left, unsigned right, uint16_t limit)
+{
+	static_assert(Taps >= 1 && Taps <= 8, "must have between 1-8 taps");
+
+	const i32x4 lim = i32x4{} + limit;
+	unsigned accum_base = floor_n(left, 4);
+
+	for (unsigned j = accum_base; j < right; j += 4) {
+		i32x4 x = Initial ? i32x4{} : vec_load<i32x4>(accum + j - accum_base);
+
+		for (unsigned k = 0; k < Taps; ++k) {
+			int32_t c = filter_data[k];
+			x += c * import_pixel(src[k] + j);
+		}
+
+		if constexpr (Final) {
+			pixel_x4<T> out = export_pixel<T>(x, lim);
+
+			if (j < left || j + 4 > right)
+				vec_store_range(dst + j, out, std::max(j, left) - j, std::min(j + 4, right) - j);
+			else
+				vec_store(dst + j, out);
+		} else {
+			vec_store(accum + j - accum_base, x);
+		}
+	}
+}
+
+template <class T>
+constexpr auto resize_line_v_int_vec_jt_small = make_array(
+	resize_line_v_int_vec<T, 1, true, true>,
+	resize_line_v_int_vec<T, 2, true, true>,
+	resize_line_v_int_vec<T, 3, true, true>,
+	resize_line_v_int_vec<T, 4, true, true>,
+	resize_line_v_int_vec<T, 5, true, true>,
+	resize_line_v_int_vec<T, 6, true, true>,
+	resize_line_v_int_vec<T, 7, true, true>,
+	resize_line_v_int_vec<T, 8, true, true>);
+
+template <class T>
+constexpr auto resize_line_v_int_vec_initial = resize_line_v_int_vec<T, 8, true, false>;
+
+template <class T>
+constexpr auto resize_line_v_int_vec_update = resize_line_v_int_vec<T, 8, false, false>;
+
+template <class T>
+constexpr auto resize_line_v_int_vec_jt_final = make_array(
+	resize_line_v_int_vec<T, 1, false, true>,
+	resize_line_v_int_vec<T, 2, false, true>,
+	resize_line_v_int_vec<T, 3, false, true>,
+	resize_line_v_int_vec<T, 4, false, true>,
+	resize_line_v_int_vec<T, 5, false, true>,
+	resize_line_v_int_vec<T, 6, false, true>,
+	resize_line_v_int_vec<T, 7, false, true>,
+	resize_line_v_int_vec<T, 8, false, true>);
+
+
+// Partial sums are kept in the destination between batches of eight taps.
+template <unsigned Taps, bool Continue>
+void resize_line_v_f32_vec(const float * RESTRICT filter_data, const float * const * RESTRICT src, float * RESTRICT dst, unsigned left, unsigned right)
+{
+	static_assert(Taps >= 1 && Taps <= 8, "must have between 1-8 taps");
+
+	for (unsigned j = floor_n(left, 4); j < right; j += 4) {
+		f32x4 x = Continue ? vec_load<f32x4>(dst + j) : f32x4{};
+
+		for (unsigned k = 0; k < Taps; ++k) {
+			x += filter_data[k] * vec_load<f32x4>(src[k] + j);
+		}
+
+		if (j < left || j + 4 > right)
+			vec_store_range(dst + j, x, std::max(j, left) - j, std::min(j + 4, right) - j);
+		else
+			vec_store(dst + j, x);
+	}
+}
+
+constexpr auto resize_line_v_f32_vec_jt_init = make_array(
+	resize_line_v_f32_vec<1, false>,
+	resize_line_v_f32_vec<2, false>,
+	resize_line_v_f32_vec<3, false>,
+	resize_line_v_f32_vec<4, false>,
+	resize_line_v_f32_vec<5, false>,
+	resize_line_v_f32_vec<6, false>,
+	resize_line_v_f32_vec<7, false>,
+	resize_line_v_f32_vec<8, false>);
+
+constexpr auto resize_line_v_f32_vec_jt_cont = make_array(
+	resize_line_v_f32_vec<1, true>,
+	resize_line_v_f32_vec<2, true>,
+	resize_line_v_f32_vec<3, true>,
+	resize_line_v_f32_vec<4, true>,
+	resize_line_v_f32_vec<5, true>,
+	resize_line_v_f32_vec<6, true>,
+	resize_line_v_f32_vec<7, true>,
+	resize_line_v_f32_vec<8, true>);
+
+
+template <class T>
+class ResizeImplH_Int_Vec final : public ResizeImplH {
+	typename decltype(resize_line4_h_int_vec_jt<T>)::value_type m_func;
+	uint16_t m_pixel_max;
+public:
+	ResizeImplH_Int_Vec(const std::shared_ptr<const FilterContext> &filter, unsigned height, PixelType type, unsigned depth) try :
+		ResizeImplH(filter, height, type),
+		m_func{},
+		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
+	{
+		m_desc.step = 4;
+		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter->input_width }, 4) * sizeof(T) * 4).get();
+
+		m_func = resize_line4_h_int_vec_jt<T>[filter->filter_width <= 8 ? filter->filter_width : 0];
+	} catch (const std::overflow_error &) {
+		error::throw_<error::OutOfMemory>();
+	}
+
+	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
+	             unsigned i, unsigned left, unsigned right, void *, void *tmp) const noexcept override
+	{
+		auto range = get_col_deps(left, right);
+
+		const T *src_ptr[4] = { 0 };
+		T *dst_ptr[4] = { 0 };
+		T *transpose_buf = static_cast<T *>(tmp);
+		unsigned height = m_desc.format.height;
+
+		for (unsigned n = 0; n < 4; ++n) {
+			src_ptr[n] = in->get_line<T>(std::min(i + n, height - 1));
+		}
+
+		transpose_line_4x4<pixel_x4<T>>(transpose_buf, src_ptr, floor_n(range.first, 4), ceil_n(range.second, 4));
+
+		for (unsigned n = 0; n < 4; ++n) {
+			dst_ptr[n] = out->get_line<T>(std::min(i + n, height - 1));
+		}
+
+		m_func(m_filter->left.data(), m_filter->phase.data(), m_filter->data_i16.data(), m_filter->stride_i16, m_filter->filter_width,
+		       transpose_buf, dst_ptr, floor_n(range.first, 4), left, right, m_pixel_max);
+	}
+};
+
+
+class ResizeImplH_F32_Vec final : public ResizeImplH {
+	decltype(resize_line4_h_f32_vec_jt)::value_type m_func;
+public:
+	ResizeImplH_F32_Vec(const std::shared_ptr<const FilterContext> &filter, unsigned height) try :
+		ResizeImplH(filter, height, PixelType::FLOAT),
+		m_func{}
+	{
+		m_desc.step = 4;
+		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter->input_width }, 4) * sizeof(float) * 4).get();
+
+		m_func = resize_line4_h_f32_vec_jt[filter->filter_width <= 8 ? filter->filter_width : 0];
+	} catch (const std::overflow_error &) {
+		error::throw_<error::OutOfMemory>();
+	}
+
+	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
+	             unsigned i, unsigned left, unsigned right, void *, void *tmp) const noexcept override
+	{
+		auto range = get_col_deps(left, right);
+
+		const float *src_ptr[4] = { 0 };
+		float *dst_ptr[4] = { 0 };
+		float *transpose_buf = static_cast<float *>(tmp);
+		unsigned height = m_desc.format.height;
+
+		for (unsigned n = 0; n < 4; ++n) {
+			src_ptr[n] = in->get_line<float>(std::min(i + n, height - 1));
+		}
+
+		transpose_line_4x4<f32x4>(transpose_buf, src_ptr, floor_n(range.first, 4), ceil_n(range.second, 4));
+
+		for (unsigned n = 0; n < 4; ++n) {
+			dst_ptr[n] = out->get_line<float>(std::min(i + n, height - 1));
+		}
+
+		m_func(m_filter->left.data(), m_filter->phase.data(), m_filter->data.data(), m_filter->stride, m_filter->filter_width,
+		       transpose_buf, dst_ptr, floor_n(range.first, 4), left, right);
+	}
+};
+
+
+template <class T>
+class ResizeImplV_Int_Vec final : public ResizeImplV {
+	uint16_t m_pixel_max;
+public:
+	ResizeImplV_Int_Vec(const std::shared_ptr<const FilterContext> &filter, unsigned width, PixelType type, unsigned depth) try :
+		ResizeImplV(filter, width, type),
+		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
+	{
+		if (m_filter->filter_width > 8)
+			m_desc.scratchpad_size = (ceil_n(checked_size_t{ width }, 4) * sizeof(int32_t)).get();
+	} catch (const std::overflow_error &) {
+		error::throw_<error::OutOfMemory>();
+	}
+
+	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
+	             unsigned i, unsigned left, unsigned right, void *, void *tmp) const noexcept override
+	{
+		const int16_t *filter_data = m_filter->data_i16.data() + m_filter->phase[i] * m_filter->stride_i16;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
+
+		const T *src_lines[8] = { 0 };
+		T *dst_line = out->get_line<T>(i);
+		int32_t *accum_buf = static_cast<int32_t *>(tmp);
+
+		unsigned top = m_filter->left[i];
+
+		auto gather_8_lines = [&](unsigned i)
+		{
+			for (unsigned n = 0; n < 8; ++n) {
+				src_lines[n] = in->get_line<T>(std::min(i + n, src_height - 1));
+			}
+		};
+
+#define XARGS src_lines, dst_line, accum_buf, left, right, m_pixel_max
+		if (filter_width <= 8) {
+			gather_8_lines(top);
+			resize_line_v_int_vec_jt_small<T>[filter_width - 1](filter_data, XARGS);
+		} else {
+			unsigned k_end = ceil_n(filter_width, 8) - 8;
+
+			gather_8_lines(top);
+			resize_line_v_int_vec_initial<T>(filter_data + 0, XARGS);
+
+			for (unsigned k = 8; k < k_end; k += 8) {
+				gather_8_lines(top + k);
+				resize_line_v_int_vec_update<T>(filter_data + k, XARGS);
+			}
+
+			gather_8_lines(top + k_end);
+			resize_line_v_int_vec_jt_final<T>[filter_width - k_end - 1](filter_data + k_end, XARGS);
+		}
+#undef XARGS
+	}
+};
+
+
+class ResizeImplV_F32_Vec final : public ResizeImplV {
+public:
+	ResizeImplV_F32_Vec(const std::shared_ptr<const FilterContext> &filter, unsigned width) :
+		ResizeImplV(filter, width, PixelType::FLOAT)
+	{}
+
+	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
+	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override
+	{
+		const float *filter_data = m_filter->data.data() + m_filter->phase[i] * m_filter->stride;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
+
+		const float *src_lines[8] = { 0 };
+		float *dst_line = out->get_line<float>(i);
+
+		for (unsigned k = 0; k < filter_width; k += 8) {
+			unsigned taps_remain = std::min(filter_width - k, 8U);
+			unsigned top = m_filter->left[i] + k;
+
+			for (unsigned n = 0; n < 8; ++n) {
+				src_lines[n] = in->get_line<float>(std::min(top + n, src_height - 1));
+			}
+
+			if (k == 0)
+				resize_line_v_f32_vec_jt_init[taps_remain - 1](filter_data + k, src_lines, dst_line, left, right);
+			else
+				resize_line_v_f32_vec_jt_cont[taps_remain - 1](filter_data + k, src_lines, dst_line, left, right);
+		}
+	}
+};
+
+} // namespace
+
+
+std::unique_ptr<graphengine::Filter> create_resize_impl_h_vec(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu)
+{
+	std::unique_ptr<graphengine::Filter> ret;
+
+	if (!cpu_is_autodetect(cpu) && cpu < CPUClass::GENERIC_VEC)
+		return ret;
+
+	if (type == PixelType::FLOAT)
+		ret = std::make_unique<ResizeImplH_F32_Vec>(context, height);
+	else if (type == PixelType::WORD)
+		ret = std::make_unique<ResizeImplH_Int_Vec<uint16_t>>(context, height, type, depth);
+	else if (type == PixelType::BYTE)
+		ret = std::make_unique<ResizeImplH_Int_Vec<uint8_t>>(context, height, type, depth);
+
+	return ret;
+}
+
+std::unique_ptr<graphengine::Filter> create_resize_impl_v_vec(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu)
+{
+	std::unique_ptr<graphengine::Filter> ret;
+
+	if (!cpu_is_autodetect(cpu) && cpu < CPUClass::GENERIC_VEC)
+		return ret;
+
+	if (type == PixelType::FLOAT)
+		ret = std::make_unique<ResizeImplV_F32_Vec>(context, width);
+	else if (type == PixelType::WORD)
+		ret = std::make_unique<ResizeImplV_Int_Vec<uint16_t>>(context, width, type, depth);
+	else if (type == PixelType::BYTE)
+		ret = std::make_unique<ResizeImplV_Int_Vec<uint8_t>>(context, width, type, depth);
+
+	return ret;
+}
+
+} // namespace zimg::resize
+
+#endif // ZIMG_VEC
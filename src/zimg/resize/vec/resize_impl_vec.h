@@ -0,0 +1,31 @@
+#pragma once
+
+#ifdef ZIMG_VEC
+
+#ifndef ZIMG_RESIZE_VEC_RESIZE_IMPL_VEC_H_
+#define ZIMG_RESIZE_VEC_RESIZE_IMPL_VEC_H_
+
+#include <memory>
+
+namespace graphengine {
+class Filter;
+}
+
+namespace zimg {
+enum class CPUClass;
+enum class PixelType;
+}
+
+namespace zimg::resize {
+
+struct FilterContext;
+
+std::unique_ptr<graphengine::Filter> create_resize_impl_h_vec(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu);
+
+std::unique_ptr<graphengine::Filter> create_resize_impl_v_vec(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu);
+
+} // namespace zimg::resize
+
+#endif // ZIMG_RESIZE_VEC_RESIZE_IMPL_VEC_H_
+
+#endif // ZIMG_VEC
@@ -0,0 +1,176 @@
+#ifdef ZIMG_X86
+
+#include <algorithm>
+#include <cstdint>
+#include <immintrin.h>
+#include "common/ccdep.h"
+#include "decimate_x86.h"
+
+namespace zimg::resize {
+
+namespace {
+
+inline FORCE_INLINE void deinterleave2_ps(__m256 a, __m256 b, __m256 &even, __m256 &odd)
+{
+	even = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+	odd = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+	even = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), _MM_SHUFFLE(3, 1, 2, 0)));
+	odd = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odd), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+// Integer samples are accumulated in 32-bit lanes. The sum of the 16 taps is 64.
+struct DecimateInt {
+	typedef __m256i vec_type;
+	typedef uint32_t accum_type;
+
+	static inline FORCE_INLINE __m256i load_accum(const uint32_t *p) { return _mm256_loadu_si256((const __m256i *)p); }
+
+	static inline FORCE_INLINE void store_accum(uint32_t *p, __m256i x) { _mm256_storeu_si256((__m256i *)p, x); }
+
+	static inline FORCE_INLINE __m256i taps(__m256i a, __m256i b, __m256i c, __m256i d)
+	{
+		__m256i mid = _mm256_add_epi32(b, c);
+		mid = _mm256_add_epi32(mid, _mm256_slli_epi32(mid, 1));
+		return _mm256_add_epi32(_mm256_add_epi32(a, d), mid);
+	}
+
+	static inline FORCE_INLINE void deinterleave2(__m256i a, __m256i b, __m256i &even, __m256i &odd)
+	{
+		__m256 even_ps, odd_ps;
+		deinterleave2_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), even_ps, odd_ps);
+		even = _mm256_castps_si256(even_ps);
+		odd = _mm256_castps_si256(odd_ps);
+	}
+
+	static inline FORCE_INLINE __m256i round(__m256i x) { return _mm256_srli_epi32(_mm256_add_epi32(x, _mm256_set1_epi32(32)), 6); }
+
+	static inline FORCE_INLINE uint32_t taps_scalar(uint32_t a, uint32_t b, uint32_t c, uint32_t d) { return a + 3 * (b + c) + d; }
+
+	static inline FORCE_INLINE uint32_t round_scalar(uint32_t x) { return (x + 32) >> 6; }
+};
+
+struct DecimateU8 : DecimateInt {
+	typedef uint8_t pixel_type;
+
+	static inline FORCE_INLINE __m256i load(const uint8_t *p) { return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)p)); }
+
+	static inline FORCE_INLINE void store(uint8_t *p, __m256i x)
+	{
+		x = _mm256_packus_epi32(round(x), round(x));
+		x = _mm256_packus_epi16(x, x);
+		_mm_storel_epi64((__m128i *)p, _mm_unpacklo_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1)));
+	}
+};
+
+struct DecimateU16 : DecimateInt {
+	typedef uint16_t pixel_type;
+
+	static inline FORCE_INLINE __m256i load(const uint16_t *p) { return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)p)); }
+
+	static inline FORCE_INLINE void store(uint16_t *p, __m256i x)
+	{
+		x = _mm256_packus_epi32(round(x), round(x));
+		x = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 0, 2, 0));
+		_mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(x));
+	}
+};
+
+struct DecimateF32 {
+	typedef float pixel_type;
+	typedef __m256 vec_type;
+	typedef float accum_type;
+
+	static inline FORCE_INLINE __m256 load(const float *p) { return _mm256_loadu_ps(p); }
+
+	static inline FORCE_INLINE void store(float *p, __m256 x) { _mm256_storeu_ps(p, x); }
+
+	static inline FORCE_INLINE __m256 load_accum(const float *p) { return _mm256_loadu_ps(p); }
+
+	static inline FORCE_INLINE void store_accum(float *p, __m256 x) { _mm256_storeu_ps(p, x); }
+
+	// Same association as the C implementation, so that results are bit-exact.
+	static inline FORCE_INLINE __m256 taps(__m256 a, __m256 b, __m256 c, __m256 d)
+	{
+		__m256 outer = _mm256_mul_ps(_mm256_set1_ps(0.125f), _mm256_add_ps(a, d));
+		__m256 inner = _mm256_mul_ps(_mm256_set1_ps(0.375f), _mm256_add_ps(b, c));
+		return _mm256_add_ps(outer, inner);
+	}
+
+	static inline FORCE_INLINE void deinterleave2(__m256 a, __m256 b, __m256 &even, __m256 &odd) { deinterleave2_ps(a, b, even, odd); }
+
+	static inline FORCE_INLINE float taps_scalar(float a, float b, float c, float d) { return 0.125f * (a + d) + 0.375f * (b + c); }
+
+	static inline FORCE_INLINE float round_scalar(float x) { return x; }
+};
+
+template <class Traits>
+void decimate_avx2(const void * const src[4], void *dst, void *tmp, unsigned src_width, unsigned left, unsigned right)
+{
+	typedef typename Traits::pixel_type T;
+	typedef typename Traits::accum_type U;
+	typedef typename Traits::vec_type V;
+
+	const T *src0 = static_cast<const T *>(src[0]);
+	const T *src1 = static_cast<const T *>(src[1]);
+	const T *src2 = static_cast<const T *>(src[2]);
+	const T *src3 = static_cast<const T *>(src[3]);
+	T *dst_p = static_cast<T *>(dst);
+
+	// Column -1 is stored at index 0.
+	U *tmp_p = static_cast<U *>(tmp) + 1;
+
+	unsigned col_left = left ? left * 2 - 1 : 0;
+	unsigned col_right = std::min(right * 2 + 1, src_width);
+	unsigned j;
+
+	for (j = col_left; j + 8 <= col_right; j += 8) {
+		V x = Traits::taps(Traits::load(src0 + j), Traits::load(src1 + j), Traits::load(src2 + j), Traits::load(src3 + j));
+		Traits::store_accum(tmp_p + j, x);
+	}
+	for (; j < col_right; ++j) {
+		tmp_p[j] = Traits::taps_scalar(src0[j], src1[j], src2[j], src3[j]);
+	}
+
+	if (col_left == 0)
+		tmp_p[-1] = tmp_p[0];
+	if (col_right == src_width)
+		tmp_p[src_width] = tmp_p[src_width - 1];
+
+	// Output j depends on columns [2j - 1, 2j + 3). The even/odd lanes of the
+	// rows starting at 2j - 1 and 2j + 1 supply the four taps.
+	for (j = left; j + 8 <= right; j += 8) {
+		const U *ptr = tmp_p + j * 2;
+		V a, b, c, d;
+
+		Traits::deinterleave2(Traits::load_accum(ptr - 1), Traits::load_accum(ptr + 7), a, b);
+		Traits::deinterleave2(Traits::load_accum(ptr + 1), Traits::load_accum(ptr + 9), c, d);
+		Traits::store(dst_p + j, Traits::taps(a, b, c, d));
+	}
+	for (; j < right; ++j) {
+		const U *ptr = tmp_p + j * 2;
+		U accum = Traits::taps_scalar(ptr[-1], ptr[0], ptr[1], ptr[2]);
+		dst_p[j] = static_cast<T>(Traits::round_scalar(accum));
+	}
+}
+
+} // namespace
+
+
+void decimate_b_avx2(const void * const src[4], void *dst, void *tmp, unsigned src_width, unsigned left, unsigned right)
+{
+	decimate_avx2<DecimateU8>(src, dst, tmp, src_width, left, right);
+}
+
+void decimate_w_avx2(const void * const src[4], void *dst, void *tmp, unsigned src_width, unsigned left, unsigned right)
+{
+	decimate_avx2<DecimateU16>(src, dst, tmp, src_width, left, right);
+}
+
+void decimate_f_avx2(const void * const src[4], void *dst, void *tmp, unsigned src_width, unsigned left, unsigned right)
+{
+	decimate_avx2<DecimateF32>(src, dst, tmp, src_width, left, right);
+}
+
+} // namespace zimg::resize
+
+#endif // ZIMG_X86
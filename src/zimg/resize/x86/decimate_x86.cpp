@@ -0,0 +1,47 @@
+#ifdef ZIMG_X86
+
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "decimate_x86.h"
+
+namespace zimg::resize {
+
+namespace {
+
+decimate_func select_decimate_func_avx2(PixelType type)
+{
+	switch (type) {
+	case PixelType::BYTE:
+		return decimate_b_avx2;
+	case PixelType::WORD:
+		return decimate_w_avx2;
+	case PixelType::FLOAT:
+		return decimate_f_avx2;
+	default:
+		return nullptr;
+	}
+}
+
+} // namespace
+
+
+decimate_func select_decimate_func_x86(PixelType type, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	decimate_func func = nullptr;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!func && caps.avx2)
+			func = select_decimate_func_avx2(type);
+	} else {
+		if (!func && cpu >= CPUClass::X86_AVX2)
+			func = select_decimate_func_avx2(type);
+	}
+
+	return func;
+}
+
+} // namespace zimg::resize
+
+#endif // ZIMG_X86
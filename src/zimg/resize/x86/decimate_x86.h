@@ -0,0 +1,27 @@
+#pragma once
+
+#ifdef ZIMG_X86
+
+#ifndef ZIMG_RESIZE_X86_DECIMATE_X86_H_
+#define ZIMG_RESIZE_X86_DECIMATE_X86_H_
+
+#include "resize/decimate.h"
+
+namespace zimg::resize {
+
+#define DECLARE_DECIMATE(x, cpu) \
+void decimate_##x##_##cpu(const void * const src[4], void *dst, void *tmp, unsigned src_width, unsigned left, unsigned right)
+
+DECLARE_DECIMATE(b, avx2);
+DECLARE_DECIMATE(w, avx2);
+DECLARE_DECIMATE(f, avx2);
+
+#undef DECLARE_DECIMATE
+
+decimate_func select_decimate_func_x86(PixelType type, CPUClass cpu);
+
+} // namespace zimg::resize
+
+#endif // ZIMG_RESIZE_X86_DECIMATE_X86_H_
+
+#endif // ZIMG_X86
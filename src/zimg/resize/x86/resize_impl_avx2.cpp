@@ -140,6 +140,67 @@ inline FORCE_INLINE __m256i export_i30_u16(__m256i lo, __m256i hi)
 	return lo;
 }
 
+inline FORCE_INLINE __m256i load16_epi16(const uint8_t *ptr)
+{
+	return _mm256_cvtepu8_epi16(_mm_load_si128((const __m128i *)ptr));
+}
+
+inline FORCE_INLINE __m256i load16_epi16(const uint16_t *ptr)
+{
+	return _mm256_load_si256((const __m256i *)ptr);
+}
+
+inline FORCE_INLINE __m128i narrow16_epi16(__m256i x)
+{
+	return _mm_packus_epi16(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+}
+
+inline FORCE_INLINE void store16_epi16(uint8_t *ptr, __m256i x)
+{
+	_mm_store_si128((__m128i *)ptr, narrow16_epi16(x));
+}
+
+inline FORCE_INLINE void store16_epi16(uint16_t *ptr, __m256i x)
+{
+	_mm256_store_si256((__m256i *)ptr, x);
+}
+
+inline FORCE_INLINE void store16_idxlo_epi16(uint8_t *ptr, __m256i x, unsigned idx)
+{
+	mm_store_idxlo_epi8((__m128i *)ptr, narrow16_epi16(x), idx);
+}
+
+inline FORCE_INLINE void store16_idxlo_epi16(uint16_t *ptr, __m256i x, unsigned idx)
+{
+	mm256_store_idxlo_epi16((__m256i *)ptr, x, idx);
+}
+
+inline FORCE_INLINE void store16_idxhi_epi16(uint8_t *ptr, __m256i x, unsigned idx)
+{
+	mm_store_idxhi_epi8((__m128i *)ptr, narrow16_epi16(x), idx);
+}
+
+inline FORCE_INLINE void store16_idxhi_epi16(uint16_t *ptr, __m256i x, unsigned idx)
+{
+	mm256_store_idxhi_epi16((__m256i *)ptr, x, idx);
+}
+
+inline FORCE_INLINE void scatter16_epi16(uint8_t * const *dst, unsigned j, __m256i x)
+{
+	uint16_t tmp alignas(32)[16];
+	_mm256_store_si256((__m256i *)tmp, x);
+
+	for (unsigned n = 0; n < 16; ++n) {
+		dst[n][j] = static_cast<uint8_t>(tmp[n]);
+	}
+}
+
+inline FORCE_INLINE void scatter16_epi16(uint16_t * const *dst, unsigned j, __m256i x)
+{
+	mm_scatter_epi16(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, dst[4] + j, dst[5] + j, dst[6] + j, dst[7] + j, _mm256_castsi256_si128(x));
+	mm_scatter_epi16(dst[8] + j, dst[9] + j, dst[10] + j, dst[11] + j, dst[12] + j, dst[13] + j, dst[14] + j, dst[15] + j, _mm256_extractf128_si256(x, 1));
+}
+
 
 template <class Traits, class T>
 void transpose_line_8x8(T * RESTRICT dst, const T * const * RESTRICT src, unsigned left, unsigned right)
@@ -173,27 +234,29 @@ void transpose_line_8x8(T * RESTRICT dst, const T * const * RESTRICT src, unsign
 	}
 }
 
-void transpose_line_16x16_epi16(uint16_t * RESTRICT dst, const uint16_t * const * RESTRICT src, unsigned left, unsigned right)
+// Transposes 16-bit or zero-extended 8-bit pixels into a 16-bit buffer.
+template <class T>
+void transpose_line_16x16_epi16(uint16_t * RESTRICT dst, const T * const * RESTRICT src, unsigned left, unsigned right)
 {
 	for (unsigned j = left; j < right; j += 16) {
 		__m256i x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
 
-		x0 = _mm256_load_si256((const __m256i *)(src[0] + j));
-		x1 = _mm256_load_si256((const __m256i *)(src[1] + j));
-		x2 = _mm256_load_si256((const __m256i *)(src[2] + j));
-		x3 = _mm256_load_si256((const __m256i *)(src[3] + j));
-		x4 = _mm256_load_si256((const __m256i *)(src[4] + j));
-		x5 = _mm256_load_si256((const __m256i *)(src[5] + j));
-		x6 = _mm256_load_si256((const __m256i *)(src[6] + j));
-		x7 = _mm256_load_si256((const __m256i *)(src[7] + j));
-		x8 = _mm256_load_si256((const __m256i *)(src[8] + j));
-		x9 = _mm256_load_si256((const __m256i *)(src[9] + j));
-		x10 = _mm256_load_si256((const __m256i *)(src[10] + j));
-		x11 = _mm256_load_si256((const __m256i *)(src[11] + j));
-		x12 = _mm256_load_si256((const __m256i *)(src[12] + j));
-		x13 = _mm256_load_si256((const __m256i *)(src[13] + j));
-		x14 = _mm256_load_si256((const __m256i *)(src[14] + j));
-		x15 = _mm256_load_si256((const __m256i *)(src[15] + j));
+		x0 = load16_epi16(src[0] + j);
+		x1 = load16_epi16(src[1] + j);
+		x2 = load16_epi16(src[2] + j);
+		x3 = load16_epi16(src[3] + j);
+		x4 = load16_epi16(src[4] + j);
+		x5 = load16_epi16(src[5] + j);
+		x6 = load16_epi16(src[6] + j);
+		x7 = load16_epi16(src[7] + j);
+		x8 = load16_epi16(src[8] + j);
+		x9 = load16_epi16(src[9] + j);
+		x10 = load16_epi16(src[10] + j);
+		x11 = load16_epi16(src[11] + j);
+		x12 = load16_epi16(src[12] + j);
+		x13 = load16_epi16(src[13] + j);
+		x14 = load16_epi16(src[14] + j);
+		x15 = load16_epi16(src[15] + j);
 
 		mm256_transpose16_epi16(x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15);
 
@@ -220,7 +283,7 @@ void transpose_line_16x16_epi16(uint16_t * RESTRICT dst, const uint16_t * const
 
 
 template <int Taps>
-inline FORCE_INLINE __m256i resize_line8_h_u16_avx2_xiter(unsigned j, const unsigned *filter_left, const int16_t *filter_data, unsigned filter_stride, unsigned filter_width,
+inline FORCE_INLINE __m256i resize_line8_h_u16_avx2_xiter(unsigned j, const unsigned *filter_left, const unsigned *filter_phase, const int16_t *filter_data, unsigned filter_stride, unsigned filter_width,
                                                           const uint16_t *src, unsigned src_base, uint16_t limit)
 {
 	static_assert(Taps <= 8, "only up to 8 taps can be unrolled");
@@ -231,7 +294,7 @@ inline FORCE_INLINE __m256i resize_line8_h_u16_avx2_xiter(unsigned j, const unsi
 	const __m256i i16_min = _mm256_set1_epi16(INT16_MIN);
 	const __m256i lim = _mm256_set1_epi16(limit + INT16_MIN);
 
-	const int16_t *filter_coeffs = filter_data + j * filter_stride;
+	const int16_t *filter_coeffs = filter_data + filter_phase[j] * filter_stride;
 	const uint16_t *src_p = src + (filter_left[j] - src_base) * 16;
 
 	__m256i accum_lo = _mm256_setzero_si256();
@@ -276,20 +339,18 @@ inline FORCE_INLINE __m256i resize_line8_h_u16_avx2_xiter(unsigned j, const unsi
 	return accum_lo;
 }
 
-template <int Taps>
-void resize_line8_h_u16_avx2(const unsigned * RESTRICT filter_left, const int16_t * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
-                             const uint16_t * RESTRICT src, uint16_t * const * /* RESTRICT */ dst, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
+template <int Taps, class T>
+void resize_line8_h_u16_avx2(const unsigned * RESTRICT filter_left, const unsigned * RESTRICT filter_phase, const int16_t * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+                             const uint16_t * RESTRICT src, T * const * /* RESTRICT */ dst, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
 {
 	unsigned vec_left = ceil_n(left, 16);
 	unsigned vec_right = floor_n(right, 16);
 
 #define XITER resize_line8_h_u16_avx2_xiter<Taps>
-#define XARGS filter_left, filter_data, filter_stride, filter_width, src, src_base, limit
+#define XARGS filter_left, filter_phase, filter_data, filter_stride, filter_width, src, src_base, limit
 	for (unsigned j = left; j < vec_left; ++j) {
 		__m256i x = XITER(j, XARGS);
-
-		mm_scatter_epi16(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, dst[4] + j, dst[5] + j, dst[6] + j, dst[7] + j, _mm256_castsi256_si128(x));
-		mm_scatter_epi16(dst[8] + j, dst[9] + j, dst[10] + j, dst[11] + j, dst[12] + j, dst[13] + j, dst[14] + j, dst[15] + j, _mm256_extractf128_si256(x, 1));
+		scatter16_epi16(dst, j, x);
 	}
 
 	for (unsigned j = vec_left; j < vec_right; j += 16) {
@@ -320,57 +381,57 @@ void resize_line8_h_u16_avx2(const unsigned * RESTRICT filter_left, const int16_
 
 		mm256_transpose16_epi16(x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15);
 
-		_mm256_store_si256((__m256i *)(dst[0] + j), x0);
-		_mm256_store_si256((__m256i *)(dst[1] + j), x1);
-		_mm256_store_si256((__m256i *)(dst[2] + j), x2);
-		_mm256_store_si256((__m256i *)(dst[3] + j), x3);
-		_mm256_store_si256((__m256i *)(dst[4] + j), x4);
-		_mm256_store_si256((__m256i *)(dst[5] + j), x5);
-		_mm256_store_si256((__m256i *)(dst[6] + j), x6);
-		_mm256_store_si256((__m256i *)(dst[7] + j), x7);
-		_mm256_store_si256((__m256i *)(dst[8] + j), x8);
-		_mm256_store_si256((__m256i *)(dst[9] + j), x9);
-		_mm256_store_si256((__m256i *)(dst[10] + j), x10);
-		_mm256_store_si256((__m256i *)(dst[11] + j), x11);
-		_mm256_store_si256((__m256i *)(dst[12] + j), x12);
-		_mm256_store_si256((__m256i *)(dst[13] + j), x13);
-		_mm256_store_si256((__m256i *)(dst[14] + j), x14);
-		_mm256_store_si256((__m256i *)(dst[15] + j), x15);
+		store16_epi16(dst[0] + j, x0);
+		store16_epi16(dst[1] + j, x1);
+		store16_epi16(dst[2] + j, x2);
+		store16_epi16(dst[3] + j, x3);
+		store16_epi16(dst[4] + j, x4);
+		store16_epi16(dst[5] + j, x5);
+		store16_epi16(dst[6] + j, x6);
+		store16_epi16(dst[7] + j, x7);
+		store16_epi16(dst[8] + j, x8);
+		store16_epi16(dst[9] + j, x9);
+		store16_epi16(dst[10] + j, x10);
+		store16_epi16(dst[11] + j, x11);
+		store16_epi16(dst[12] + j, x12);
+		store16_epi16(dst[13] + j, x13);
+		store16_epi16(dst[14] + j, x14);
+		store16_epi16(dst[15] + j, x15);
 	}
 
 	for (unsigned j = vec_right; j < right; ++j) {
 		__m256i x = XITER(j, XARGS);
-
-		mm_scatter_epi16(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, dst[4] + j, dst[5] + j, dst[6] + j, dst[7] + j, _mm256_castsi256_si128(x));
-		mm_scatter_epi16(dst[8] + j, dst[9] + j, dst[10] + j, dst[11] + j, dst[12] + j, dst[13] + j, dst[14] + j, dst[15] + j, _mm256_extractf128_si256(x, 1));
+		scatter16_epi16(dst, j, x);
 	}
 #undef XITER
 #undef XARGS
 }
 
+template <class T>
 constexpr auto resize_line8_h_u16_avx2_jt_small = make_array(
-	resize_line8_h_u16_avx2<2>,
-	resize_line8_h_u16_avx2<2>,
-	resize_line8_h_u16_avx2<4>,
-	resize_line8_h_u16_avx2<4>,
-	resize_line8_h_u16_avx2<6>,
-	resize_line8_h_u16_avx2<6>,
-	resize_line8_h_u16_avx2<8>,
-	resize_line8_h_u16_avx2<8>);
-
+	resize_line8_h_u16_avx2<2, T>,
+	resize_line8_h_u16_avx2<2, T>,
+	resize_line8_h_u16_avx2<4, T>,
+	resize_line8_h_u16_avx2<4, T>,
+	resize_line8_h_u16_avx2<6, T>,
+	resize_line8_h_u16_avx2<6, T>,
+	resize_line8_h_u16_avx2<8, T>,
+	resize_line8_h_u16_avx2<8, T>);
+
+template <class T>
 constexpr auto resize_line8_h_u16_avx2_jt_large = make_array(
-	resize_line8_h_u16_avx2<0>,
-	resize_line8_h_u16_avx2<-2>,
-	resize_line8_h_u16_avx2<-2>,
-	resize_line8_h_u16_avx2<-4>,
-	resize_line8_h_u16_avx2<-4>,
-	resize_line8_h_u16_avx2<-6>,
-	resize_line8_h_u16_avx2<-6>,
-	resize_line8_h_u16_avx2<0>);
+	resize_line8_h_u16_avx2<0, T>,
+	resize_line8_h_u16_avx2<-2, T>,
+	resize_line8_h_u16_avx2<-2, T>,
+	resize_line8_h_u16_avx2<-4, T>,
+	resize_line8_h_u16_avx2<-4, T>,
+	resize_line8_h_u16_avx2<-6, T>,
+	resize_line8_h_u16_avx2<-6, T>,
+	resize_line8_h_u16_avx2<0, T>);
 
 
 template <class Traits, int Taps>
-inline FORCE_INLINE __m256 resize_line8_h_fp_avx2_xiter(unsigned j, const unsigned *filter_left, const float *filter_data, unsigned filter_stride, unsigned filter_width,
+inline FORCE_INLINE __m256 resize_line8_h_fp_avx2_xiter(unsigned j, const unsigned *filter_left, const unsigned *filter_phase, const float *filter_data, unsigned filter_stride, unsigned filter_width,
                                                         const typename Traits::pixel_type *src, unsigned src_base)
 {
 	static_assert(Taps <= 8, "only up to 8 taps can be unrolled");
@@ -379,7 +440,7 @@ inline FORCE_INLINE __m256 resize_line8_h_fp_avx2_xiter(unsigned j, const unsign
 
 	typedef typename Traits::pixel_type pixel_type;
 
-	const float *filter_coeffs = filter_data + j * filter_stride;
+	const float *filter_coeffs = filter_data + filter_phase[j] * filter_stride;
 	const pixel_type *src_p = src + (filter_left[j] - src_base) * 8;
 
 	__m256 accum0 = _mm256_setzero_ps();
@@ -414,14 +475,14 @@ inline FORCE_INLINE __m256 resize_line8_h_fp_avx2_xiter(unsigned j, const unsign
 }
 
 template <class Traits, int Taps>
-void resize_line8_h_fp_avx2(const unsigned * RESTRICT filter_left, const float * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+void resize_line8_h_fp_avx2(const unsigned * RESTRICT filter_left, const unsigned * RESTRICT filter_phase, const float * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
                             const typename Traits::pixel_type * RESTRICT src, typename Traits::pixel_type * const * /* RESTRICT */ dst, unsigned src_base, unsigned left, unsigned right)
 {
 	unsigned vec_left = ceil_n(left, 8);
 	unsigned vec_right = floor_n(right, 8);
 
 #define XITER resize_line8_h_fp_avx2_xiter<Traits, Taps>
-#define XARGS filter_left, filter_data, filter_stride, filter_width, src, src_base
+#define XARGS filter_left, filter_phase, filter_data, filter_stride, filter_width, src, src_base
 	for (unsigned j = left; j < vec_left; ++j) {
 		__m256 x = XITER(j, XARGS);
 		Traits::scatter8(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, dst[4] + j, dst[5] + j, dst[6] + j, dst[7] + j, x);
@@ -478,6 +539,152 @@ constexpr auto resize_line8_h_fp_avx2_jt_large = make_array(
 	resize_line8_h_fp_avx2<Traits, -3>);
 
 
+template <class Traits, int Taps>
+inline FORCE_INLINE void resize_line8x3_h_fp_avx2_xiter(unsigned j, const unsigned *filter_left, const unsigned *filter_phase, const float *filter_data, unsigned filter_stride, unsigned filter_width,
+                                                        const typename Traits::pixel_type * const *src, unsigned src_base, __m256 &out0, __m256 &out1, __m256 &out2)
+{
+	static_assert(Taps <= 8, "only up to 8 taps can be unrolled");
+	static_assert(Taps >= -3, "only up to 3 taps in epilogue");
+	constexpr int Tail = Taps >= 4 ? Taps - 4 : Taps > 0 ? Taps : -Taps;
+
+	typedef typename Traits::pixel_type pixel_type;
+
+	const float *filter_coeffs = filter_data + filter_phase[j] * filter_stride;
+	ptrdiff_t offset = static_cast<ptrdiff_t>(filter_left[j] - src_base) * 8;
+	const pixel_type *src0_p = src[0] + offset;
+	const pixel_type *src1_p = src[1] + offset;
+	const pixel_type *src2_p = src[2] + offset;
+
+	__m256 accum0a = _mm256_setzero_ps();
+	__m256 accum0b = _mm256_setzero_ps();
+	__m256 accum1a = _mm256_setzero_ps();
+	__m256 accum1b = _mm256_setzero_ps();
+	__m256 accum2a = _mm256_setzero_ps();
+	__m256 accum2b = _mm256_setzero_ps();
+	__m256 coeffs;
+
+	// Each coefficient is broadcast once and applied to all three planes.
+	auto f = ZIMG_UNROLL_FUNC(kk)
+	{
+		__m256 &acc0 = kk % 2 ? accum0b : accum0a;
+		__m256 &acc1 = kk % 2 ? accum1b : accum1a;
+		__m256 &acc2 = kk % 2 ? accum2b : accum2a;
+		__m256 c = _mm256_shuffle_ps(coeffs, coeffs, static_cast<unsigned>(_MM_SHUFFLE(kk, kk, kk, kk)));
+
+		acc0 = _mm256_fmadd_ps(c, Traits::load8(src0_p + kk * 8), acc0);
+		acc1 = _mm256_fmadd_ps(c, Traits::load8(src1_p + kk * 8), acc1);
+		acc2 = _mm256_fmadd_ps(c, Traits::load8(src2_p + kk * 8), acc2);
+	};
+
+	unsigned k_end = Taps >= 4 ? 4 : Taps > 0 ? 0 : floor_n(filter_width, 4);
+
+	for (unsigned k = 0; k < k_end; k += 4) {
+		coeffs = _mm256_broadcast_ps((const __m128 *)(filter_coeffs + k));
+		unroll<4>(f);
+		src0_p += 32;
+		src1_p += 32;
+		src2_p += 32;
+	}
+
+	if constexpr (Tail) {
+		coeffs = _mm256_broadcast_ps((const __m128 *)(filter_coeffs + k_end));
+		unroll<Tail>(f);
+	}
+
+	if constexpr (Taps <= 0 || Taps >= 2) {
+		accum0a = _mm256_add_ps(accum0a, accum0b);
+		accum1a = _mm256_add_ps(accum1a, accum1b);
+		accum2a = _mm256_add_ps(accum2a, accum2b);
+	}
+
+	out0 = accum0a;
+	out1 = accum1a;
+	out2 = accum2a;
+}
+
+template <class Traits, int Taps>
+void resize_line8x3_h_fp_avx2(const unsigned * RESTRICT filter_left, const unsigned * RESTRICT filter_phase, const float * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+                              const typename Traits::pixel_type * const *src, typename Traits::pixel_type * const (*dst)[8], unsigned src_base, unsigned left, unsigned right)
+{
+	unsigned vec_left = ceil_n(left, 8);
+	unsigned vec_right = floor_n(right, 8);
+
+#define XITER resize_line8x3_h_fp_avx2_xiter<Traits, Taps>
+#define XARGS filter_left, filter_phase, filter_data, filter_stride, filter_width, src, src_base
+#define SCATTER(p, x) Traits::scatter8(dst[p][0] + j, dst[p][1] + j, dst[p][2] + j, dst[p][3] + j, dst[p][4] + j, dst[p][5] + j, dst[p][6] + j, dst[p][7] + j, x)
+	for (unsigned j = left; j < vec_left; ++j) {
+		__m256 x0, x1, x2;
+		XITER(j, XARGS, x0, x1, x2);
+		SCATTER(0, x0);
+		SCATTER(1, x1);
+		SCATTER(2, x2);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 8) {
+		float cache alignas(32)[3][8][8];
+
+		for (unsigned jj = j; jj < j + 8; ++jj) {
+			__m256 x0, x1, x2;
+			XITER(jj, XARGS, x0, x1, x2);
+			_mm256_store_ps(cache[0][jj - j], x0);
+			_mm256_store_ps(cache[1][jj - j], x1);
+			_mm256_store_ps(cache[2][jj - j], x2);
+		}
+
+		for (unsigned p = 0; p < 3; ++p) {
+			__m256 x0 = _mm256_load_ps(cache[p][0]);
+			__m256 x1 = _mm256_load_ps(cache[p][1]);
+			__m256 x2 = _mm256_load_ps(cache[p][2]);
+			__m256 x3 = _mm256_load_ps(cache[p][3]);
+			__m256 x4 = _mm256_load_ps(cache[p][4]);
+			__m256 x5 = _mm256_load_ps(cache[p][5]);
+			__m256 x6 = _mm256_load_ps(cache[p][6]);
+			__m256 x7 = _mm256_load_ps(cache[p][7]);
+
+			mm256_transpose8_ps(x0, x1, x2, x3, x4, x5, x6, x7);
+
+			Traits::store8(dst[p][0] + j, x0);
+			Traits::store8(dst[p][1] + j, x1);
+			Traits::store8(dst[p][2] + j, x2);
+			Traits::store8(dst[p][3] + j, x3);
+			Traits::store8(dst[p][4] + j, x4);
+			Traits::store8(dst[p][5] + j, x5);
+			Traits::store8(dst[p][6] + j, x6);
+			Traits::store8(dst[p][7] + j, x7);
+		}
+	}
+
+	for (unsigned j = vec_right; j < right; ++j) {
+		__m256 x0, x1, x2;
+		XITER(j, XARGS, x0, x1, x2);
+		SCATTER(0, x0);
+		SCATTER(1, x1);
+		SCATTER(2, x2);
+	}
+#undef XITER
+#undef XARGS
+#undef SCATTER
+}
+
+template <class Traits>
+constexpr auto resize_line8x3_h_fp_avx2_jt_small = make_array(
+	resize_line8x3_h_fp_avx2<Traits, 1>,
+	resize_line8x3_h_fp_avx2<Traits, 2>,
+	resize_line8x3_h_fp_avx2<Traits, 3>,
+	resize_line8x3_h_fp_avx2<Traits, 4>,
+	resize_line8x3_h_fp_avx2<Traits, 5>,
+	resize_line8x3_h_fp_avx2<Traits, 6>,
+	resize_line8x3_h_fp_avx2<Traits, 7>,
+	resize_line8x3_h_fp_avx2<Traits, 8>);
+
+template <class Traits>
+constexpr auto resize_line8x3_h_fp_avx2_jt_large = make_array(
+	resize_line8x3_h_fp_avx2<Traits, 0>,
+	resize_line8x3_h_fp_avx2<Traits, -1>,
+	resize_line8x3_h_fp_avx2<Traits, -2>,
+	resize_line8x3_h_fp_avx2<Traits, -3>);
+
+
 template <unsigned Taps>
 void resize_line_h_perm_u16_avx2(const unsigned * RESTRICT permute_left, const unsigned * RESTRICT permute_mask, const int16_t * RESTRICT filter_data, unsigned input_width,
                                  const uint16_t * RESTRICT src, uint16_t * RESTRICT dst, unsigned left, unsigned right, uint16_t limit)
@@ -664,8 +871,8 @@ constexpr unsigned V_ACCUM_INITIAL = 1;
 constexpr unsigned V_ACCUM_UPDATE = 2;
 constexpr unsigned V_ACCUM_FINAL = 3;
 
-template <unsigned Taps, unsigned AccumMode>
-inline FORCE_INLINE __m256i resize_line_v_u16_avx2_xiter(unsigned j, unsigned accum_base, const uint16_t * const srcp[8],
+template <unsigned Taps, unsigned AccumMode, class T>
+inline FORCE_INLINE __m256i resize_line_v_u16_avx2_xiter(unsigned j, unsigned accum_base, const T * const srcp[8],
                                                          uint32_t * RESTRICT accum_p, const __m256i c[4], uint16_t limit)
 {
 	static_assert(Taps >= 2 && Taps <= 8, "must have between 2-8 taps");
@@ -681,8 +888,8 @@ inline FORCE_INLINE __m256i resize_line_v_u16_avx2_xiter(unsigned j, unsigned ac
 	{
 		__m256i x0, x1, xl, xh;
 
-		x0 = _mm256_load_si256((const __m256i *)(srcp[k * 2 + 0] + j));
-		x1 = _mm256_load_si256((const __m256i *)(srcp[k * 2 + 1] + j));
+		x0 = load16_epi16(srcp[k * 2 + 0] + j);
+		x1 = load16_epi16(srcp[k * 2 + 1] + j);
 		x0 = _mm256_add_epi16(x0, i16_min);
 		x1 = _mm256_add_epi16(x1, i16_min);
 
@@ -715,10 +922,10 @@ inline FORCE_INLINE __m256i resize_line_v_u16_avx2_xiter(unsigned j, unsigned ac
 	}
 }
 
-template <unsigned Taps, unsigned AccumMode>
-void resize_line_v_u16_avx2(const int16_t * RESTRICT filter_data, const uint16_t * const * RESTRICT src, uint16_t * RESTRICT dst, uint32_t * RESTRICT accum, unsigned left, unsigned right, uint16_t limit)
+template <unsigned Taps, unsigned AccumMode, class T>
+void resize_line_v_u16_avx2(const int16_t * RESTRICT filter_data, const T * const * RESTRICT src, T * RESTRICT dst, uint32_t * RESTRICT accum, unsigned left, unsigned right, uint16_t limit)
 {
-	const uint16_t *srcp[8] = { src[0], src[1], src[2], src[3], src[4], src[5], src[6], src[7] };
+	const T *srcp[8] = { src[0], src[1], src[2], src[3], src[4], src[5], src[6], src[7] };
 
 	unsigned vec_left = ceil_n(left, 16);
 	unsigned vec_right = floor_n(right, 16);
@@ -731,54 +938,58 @@ void resize_line_v_u16_avx2(const int16_t * RESTRICT filter_data, const uint16_t
 		_mm256_unpacklo_epi16(_mm256_set1_epi16(filter_data[6]), _mm256_set1_epi16(filter_data[7])),
 	};
 
-#define XITER resize_line_v_u16_avx2_xiter<Taps, AccumMode>
+#define XITER resize_line_v_u16_avx2_xiter<Taps, AccumMode, T>
 #define XARGS accum_base, srcp, accum, c, limit
 	if (left != vec_left) {
 		__m256i out = XITER(vec_left - 16, XARGS);
 
 		if constexpr (AccumMode == V_ACCUM_NONE || AccumMode == V_ACCUM_FINAL)
-			mm256_store_idxhi_epi16((__m256i *)(dst + vec_left - 16), out, left % 16);
+			store16_idxhi_epi16(dst + vec_left - 16, out, left % 16);
 	}
 
 	for (unsigned j = vec_left; j < vec_right; j += 16) {
 		__m256i out = XITER(j, XARGS);
 
 		if constexpr (AccumMode == V_ACCUM_NONE || AccumMode == V_ACCUM_FINAL)
-			_mm256_store_si256((__m256i *)(dst + j), out);
+			store16_epi16(dst + j, out);
 	}
 
 	if (right != vec_right) {
 		__m256i out = XITER(vec_right, XARGS);
 
 		if constexpr (AccumMode == V_ACCUM_NONE || AccumMode == V_ACCUM_FINAL)
-			mm256_store_idxlo_epi16((__m256i *)(dst + vec_right), out, right % 16);
+			store16_idxlo_epi16(dst + vec_right, out, right % 16);
 	}
 #undef XITER
 #undef XARGS
 }
 
+template <class T>
 constexpr auto resize_line_v_u16_avx2_jt_small = make_array(
-	resize_line_v_u16_avx2<2, V_ACCUM_NONE>,
-	resize_line_v_u16_avx2<2, V_ACCUM_NONE>,
-	resize_line_v_u16_avx2<4, V_ACCUM_NONE>,
-	resize_line_v_u16_avx2<4, V_ACCUM_NONE>,
-	resize_line_v_u16_avx2<6, V_ACCUM_NONE>,
-	resize_line_v_u16_avx2<6, V_ACCUM_NONE>,
-	resize_line_v_u16_avx2<8, V_ACCUM_NONE>,
-	resize_line_v_u16_avx2<8, V_ACCUM_NONE>);
-
-constexpr auto resize_line_v_u16_avx2_initial = resize_line_v_u16_avx2<8, V_ACCUM_INITIAL>;
-constexpr auto resize_line_v_u16_avx2_update = resize_line_v_u16_avx2<8, V_ACCUM_UPDATE>;
-
+	resize_line_v_u16_avx2<2, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx2<2, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx2<4, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx2<4, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx2<6, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx2<6, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx2<8, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx2<8, V_ACCUM_NONE, T>);
+
+template <class T>
+constexpr auto resize_line_v_u16_avx2_initial = resize_line_v_u16_avx2<8, V_ACCUM_INITIAL, T>;
+template <class T>
+constexpr auto resize_line_v_u16_avx2_update = resize_line_v_u16_avx2<8, V_ACCUM_UPDATE, T>;
+
+template <class T>
 constexpr auto resize_line_v_u16_avx2_jt_final = make_array(
-	resize_line_v_u16_avx2<2, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx2<2, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx2<4, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx2<4, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx2<6, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx2<6, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx2<8, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx2<8, V_ACCUM_FINAL>);
+	resize_line_v_u16_avx2<2, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx2<2, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx2<4, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx2<4, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx2<6, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx2<6, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx2<8, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx2<8, V_ACCUM_FINAL, T>);
 
 
 template <class Traits, unsigned Taps, bool Continue, class T = typename Traits::pixel_type>
@@ -874,22 +1085,23 @@ constexpr auto resize_line_v_fp_avx2_jt_cont = make_array(
 	resize_line_v_fp_avx2<Traits, 8, true>);
 
 
-class ResizeImplH_U16_AVX2 : public ResizeImplH {
-	decltype(resize_line8_h_u16_avx2_jt_small)::value_type m_func;
+template <class T>
+class ResizeImplH_Int_AVX2 : public ResizeImplH {
+	typename decltype(resize_line8_h_u16_avx2_jt_small<T>)::value_type m_func;
 	uint16_t m_pixel_max;
 public:
-	ResizeImplH_U16_AVX2(const FilterContext &filter, unsigned height, unsigned depth) try :
-		ResizeImplH(filter, height, PixelType::WORD),
+	ResizeImplH_Int_AVX2(const std::shared_ptr<const FilterContext> &filter, unsigned height, unsigned depth) try :
+		ResizeImplH(filter, height, std::is_same_v<T, uint8_t> ? PixelType::BYTE : PixelType::WORD),
 		m_func{},
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{
 		m_desc.step = 16;
-		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter.input_width }, 16) * sizeof(uint16_t) * 16).get();
+		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter->input_width }, 16) * sizeof(uint16_t) * 16).get();
 
-		if (filter.filter_width > 8)
-			m_func = resize_line8_h_u16_avx2_jt_large[filter.filter_width % 8];
+		if (filter->filter_width > 8)
+			m_func = resize_line8_h_u16_avx2_jt_large<T>[filter->filter_width % 8];
 		else
-			m_func = resize_line8_h_u16_avx2_jt_small[filter.filter_width - 1];
+			m_func = resize_line8_h_u16_avx2_jt_small<T>[filter->filter_width - 1];
 	} catch (const std::overflow_error &) {
 		error::throw_<error::OutOfMemory>();
 	}
@@ -899,22 +1111,22 @@ public:
 	{
 		auto range = get_col_deps(left, right);
 
-		const uint16_t *src_ptr[16] = { 0 };
-		uint16_t *dst_ptr[16] = { 0 };
+		const T *src_ptr[16] = { 0 };
+		T *dst_ptr[16] = { 0 };
 		uint16_t *transpose_buf = static_cast<uint16_t *>(tmp);
 		unsigned height = m_desc.format.height;
 
 		for (unsigned n = 0; n < 16; ++n) {
-			src_ptr[n] = in->get_line<uint16_t>(std::min(i + n, height - 1));
+			src_ptr[n] = in->get_line<T>(std::min(i + n, height - 1));
 		}
 
 		transpose_line_16x16_epi16(transpose_buf, src_ptr, floor_n(range.first, 16), ceil_n(range.second, 16));
 
 		for (unsigned n = 0; n < 16; ++n) {
-			dst_ptr[n] = out->get_line<uint16_t>(std::min(i + n, height - 1));
+			dst_ptr[n] = out->get_line<T>(std::min(i + n, height - 1));
 		}
 
-		m_func(m_filter.left.data(), m_filter.data_i16.data(), m_filter.stride_i16, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->phase.data(), m_filter->data_i16.data(), m_filter->stride_i16, m_filter->filter_width,
 		       transpose_buf, dst_ptr, floor_n(range.first, 16), left, right, m_pixel_max);
 	}
 };
@@ -927,17 +1139,17 @@ class ResizeImplH_FP_AVX2 : public ResizeImplH {
 
 	func_type m_func;
 public:
-	ResizeImplH_FP_AVX2(const FilterContext &filter, unsigned height) try :
+	ResizeImplH_FP_AVX2(const std::shared_ptr<const FilterContext> &filter, unsigned height) try :
 		ResizeImplH(filter, height, Traits::type_constant),
 		m_func{}
 	{
 		m_desc.step = 8;
-		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter.input_width }, 8) * sizeof(pixel_type) * 8).get();
+		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter->input_width }, 8) * sizeof(pixel_type) * 8).get();
 
-		if (filter.filter_width <= 8)
-			m_func = resize_line8_h_fp_avx2_jt_small<Traits>[filter.filter_width - 1];
+		if (filter->filter_width <= 8)
+			m_func = resize_line8_h_fp_avx2_jt_small<Traits>[filter->filter_width - 1];
 		else
-			m_func = resize_line8_h_fp_avx2_jt_large<Traits>[filter.filter_width % 4];
+			m_func = resize_line8_h_fp_avx2_jt_large<Traits>[filter->filter_width % 4];
 	} catch (const std::overflow_error &) {
 		error::throw_<error::OutOfMemory>();
 	}
@@ -972,7 +1184,63 @@ public:
 		dst_ptr[6] = out->get_line<pixel_type>(std::min(i + 6, height - 1));
 		dst_ptr[7] = out->get_line<pixel_type>(std::min(i + 7, height - 1));
 
-		m_func(m_filter.left.data(), m_filter.data.data(), m_filter.stride, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->phase.data(), m_filter->data.data(), m_filter->stride, m_filter->filter_width,
+		       transpose_buf, dst_ptr, floor_n(range.first, 8), left, right);
+	}
+};
+
+template <class Traits>
+class ResizeImplH3_FP_AVX2 : public ResizeImplH {
+	typedef typename Traits::pixel_type pixel_type;
+	typedef typename decltype(resize_line8x3_h_fp_avx2_jt_small<Traits>)::value_type func_type;
+
+	func_type m_func;
+	size_t m_plane_size;
+public:
+	ResizeImplH3_FP_AVX2(const std::shared_ptr<const FilterContext> &filter, unsigned height) try :
+		ResizeImplH(filter, height, Traits::type_constant),
+		m_func{},
+		m_plane_size{}
+	{
+		checked_size_t plane_size = ceil_n(checked_size_t{ filter->input_width }, 8) * 8;
+
+		m_desc.num_deps = 3;
+		m_desc.num_planes = 3;
+		m_desc.step = 8;
+		m_desc.scratchpad_size = (plane_size * sizeof(pixel_type) * 3).get();
+		m_plane_size = plane_size.get();
+
+		if (filter->filter_width <= 8)
+			m_func = resize_line8x3_h_fp_avx2_jt_small<Traits>[filter->filter_width - 1];
+		else
+			m_func = resize_line8x3_h_fp_avx2_jt_large<Traits>[filter->filter_width % 4];
+	} catch (const std::overflow_error &) {
+		error::throw_<error::OutOfMemory>();
+	}
+
+	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
+	             unsigned i, unsigned left, unsigned right, void *, void *tmp) const noexcept override
+	{
+		auto range = get_col_deps(left, right);
+
+		const pixel_type *src_ptr[8] = { 0 };
+		const pixel_type *transpose_buf[3];
+		pixel_type *dst_ptr[3][8] = { { 0 } };
+		unsigned height = m_desc.format.height;
+
+		for (unsigned p = 0; p < 3; ++p) {
+			pixel_type *buf = static_cast<pixel_type *>(tmp) + p * m_plane_size;
+
+			for (unsigned n = 0; n < 8; ++n) {
+				src_ptr[n] = in[p].get_line<pixel_type>(std::min(i + n, height - 1));
+				dst_ptr[p][n] = out[p].get_line<pixel_type>(std::min(i + n, height - 1));
+			}
+
+			transpose_line_8x8<Traits>(buf, src_ptr, floor_n(range.first, 8), ceil_n(range.second, 8));
+			transpose_buf[p] = buf;
+		}
+
+		m_func(m_filter->left.data(), m_filter->phase.data(), m_filter->data.data(), m_filter->stride, m_filter->filter_width,
 		       transpose_buf, dst_ptr, floor_n(range.first, 8), left, right);
 	}
 };
@@ -1046,11 +1314,11 @@ public:
 					unsigned offset = (filter.left[ii] - context.left[i / 8]) % 2;
 
 					if (offset) {
-						data[static_cast<size_t>(k / 2) * 16 + (ii - i) * 2 + 1] = filter.data_i16[ii * static_cast<ptrdiff_t>(filter.stride_i16) + k + 0];
-						data[static_cast<size_t>(k / 2 + 1) * 16 + (ii - i) * 2] = filter.data_i16[ii * static_cast<ptrdiff_t>(filter.stride_i16) + k + 1];
+						data[static_cast<size_t>(k / 2) * 16 + (ii - i) * 2 + 1] = filter.data_i16[filter.phase[ii] * static_cast<ptrdiff_t>(filter.stride_i16) + k + 0];
+						data[static_cast<size_t>(k / 2 + 1) * 16 + (ii - i) * 2] = filter.data_i16[filter.phase[ii] * static_cast<ptrdiff_t>(filter.stride_i16) + k + 1];
 					} else {
-						data[static_cast<size_t>(k / 2) * 16 + (ii - i) * 2 + 0] = filter.data_i16[ii * static_cast<ptrdiff_t>(filter.stride_i16) + k + 0];
-						data[static_cast<size_t>(k / 2) * 16 + (ii - i) * 2 + 1] = filter.data_i16[ii * static_cast<ptrdiff_t>(filter.stride_i16) + k + 1];
+						data[static_cast<size_t>(k / 2) * 16 + (ii - i) * 2 + 0] = filter.data_i16[filter.phase[ii] * static_cast<ptrdiff_t>(filter.stride_i16) + k + 0];
+						data[static_cast<size_t>(k / 2) * 16 + (ii - i) * 2 + 1] = filter.data_i16[filter.phase[ii] * static_cast<ptrdiff_t>(filter.stride_i16) + k + 1];
 					}
 				}
 			}
@@ -1110,10 +1378,23 @@ class ResizeImplH_Permute_FP_AVX2 : public graph::FilterBase {
 		m_desc.flags.entire_row = !std::is_sorted(m_context.left.begin(), m_context.left.end());
 	}
 public:
-	static std::unique_ptr<graphengine::Filter> create(const FilterContext &filter, unsigned height)
+	static bool supported(const FilterContext &filter)
 	{
 		// Transpose is faster for large filters.
 		if (filter.filter_width > 8)
+			return false;
+
+		for (unsigned i = 0; i < filter.filter_rows; i += 8) {
+			auto minmax = std::minmax_element(filter.left.begin() + i, filter.left.begin() + std::min(i + 8, filter.filter_rows));
+			if (*minmax.second - *minmax.first >= 8)
+				return false;
+		}
+		return true;
+	}
+
+	static std::unique_ptr<graphengine::Filter> create(const FilterContext &filter, unsigned height)
+	{
+		if (!supported(filter))
 			return nullptr;
 
 		PermuteContext context{};
@@ -1127,14 +1408,10 @@ public:
 
 		for (unsigned i = 0; i < filter.filter_rows; i += 8) {
 			unsigned left_min = UINT_MAX;
-			unsigned left_max = 0U;
 
 			for (unsigned ii = i; ii < std::min(i + 8, context.filter_rows); ++ii) {
 				left_min = std::min(left_min, filter.left[ii]);
-				left_max = std::max(left_max, filter.left[ii]);
 			}
-			if (left_max - left_min >= 8)
-				return nullptr;
 
 			for (unsigned ii = i; ii < std::min(i + 8, context.filter_rows); ++ii) {
 				context.permute[ii] = filter.left[ii] - left_min;
@@ -1144,7 +1421,7 @@ public:
 			float *data = context.data.data() + i * context.filter_width;
 			for (unsigned k = 0; k < context.filter_width; ++k) {
 				for (unsigned ii = i; ii < std::min(i + 8, context.filter_rows); ++ii) {
-					data[static_cast<size_t>(k) * 8 + (ii - i)] = filter.data[ii * static_cast<ptrdiff_t>(filter.stride) + k];
+					data[static_cast<size_t>(k) * 8 + (ii - i)] = filter.data[filter.phase[ii] * static_cast<ptrdiff_t>(filter.stride) + k];
 				}
 			}
 		}
@@ -1174,14 +1451,15 @@ public:
 };
 
 
-class ResizeImplV_U16_AVX2 : public ResizeImplV {
+template <class T>
+class ResizeImplV_Int_AVX2 : public ResizeImplV {
 	uint16_t m_pixel_max;
 public:
-	ResizeImplV_U16_AVX2(const FilterContext &filter, unsigned width, unsigned depth) try :
-		ResizeImplV(filter, width, PixelType::WORD),
+	ResizeImplV_Int_AVX2(const std::shared_ptr<const FilterContext> &filter, unsigned width, unsigned depth) try :
+		ResizeImplV(filter, width, std::is_same_v<T, uint8_t> ? PixelType::BYTE : PixelType::WORD),
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{
-		if (m_filter.filter_width > 8)
+		if (m_filter->filter_width > 8)
 			m_desc.scratchpad_size = (ceil_n(checked_size_t{ width }, 16) * sizeof(uint32_t)).get();
 	} catch (const std::overflow_error &) {
 		error::throw_<error::OutOfMemory>();
@@ -1190,39 +1468,39 @@ public:
 	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
 	             unsigned i, unsigned left, unsigned right, void *, void *tmp) const noexcept override
 	{
-		const int16_t *filter_data = m_filter.data_i16.data() + i * m_filter.stride_i16;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const int16_t *filter_data = m_filter->data_i16.data() + m_filter->phase[i] * m_filter->stride_i16;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
-		const uint16_t *src_lines[8] = { 0 };
-		uint16_t *dst_line = out->get_line<uint16_t>(i);
+		const T *src_lines[8] = { 0 };
+		T *dst_line = out->get_line<T>(i);
 		uint32_t *accum_buf = static_cast<uint32_t *>(tmp);
 
-		unsigned top = m_filter.left[i];
+		unsigned top = m_filter->left[i];
 
 		auto calculate_line_address = [&](unsigned i)
 		{
 			for (unsigned n = 0; n < 8; ++n) {
-				src_lines[n] = in->get_line<uint16_t>(std::min(i + n, src_height - 1));
+				src_lines[n] = in->get_line<T>(std::min(i + n, src_height - 1));
 			}
 		};
 
 		if (filter_width <= 8) {
 			calculate_line_address(top);
-			resize_line_v_u16_avx2_jt_small[filter_width - 1](filter_data, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx2_jt_small<T>[filter_width - 1](filter_data, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 		} else {
 			unsigned k_end = ceil_n(filter_width, 8) - 8;
 
 			calculate_line_address(top);
-			resize_line_v_u16_avx2_initial(filter_data + 0, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx2_initial<T>(filter_data + 0, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 
 			for (unsigned k = 8; k < k_end; k += 8) {
 				calculate_line_address(top + k);
-				resize_line_v_u16_avx2_update(filter_data + k, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+				resize_line_v_u16_avx2_update<T>(filter_data + k, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 			}
 
 			calculate_line_address(top + k_end);
-			resize_line_v_u16_avx2_jt_final[filter_width - k_end - 1](filter_data + k_end, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx2_jt_final<T>[filter_width - k_end - 1](filter_data + k_end, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 		}
 	}
 };
@@ -1232,23 +1510,23 @@ template <class Traits>
 class ResizeImplV_FP_AVX2 : public ResizeImplV {
 	typedef typename Traits::pixel_type pixel_type;
 public:
-	ResizeImplV_FP_AVX2(const FilterContext &filter, unsigned width) :
+	ResizeImplV_FP_AVX2(const std::shared_ptr<const FilterContext> &filter, unsigned width) :
 		ResizeImplV(filter, width, Traits::type_constant)
 	{}
 
 	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
 	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override
 	{
-		const float *filter_data = m_filter.data.data() + i * m_filter.stride;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const float *filter_data = m_filter->data.data() + m_filter->phase[i] * m_filter->stride;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
 		const pixel_type *src_lines[8] = { 0 };
 		pixel_type *dst_line = out->get_line<pixel_type>(i);
 
 		{
 			unsigned taps_remain = std::min(filter_width - 0, 8U);
-			unsigned top = m_filter.left[i] + 0;
+			unsigned top = m_filter->left[i] + 0;
 
 			src_lines[0] = in->get_line<pixel_type>(std::min(top + 0, src_height - 1));
 			src_lines[1] = in->get_line<pixel_type>(std::min(top + 1, src_height - 1));
@@ -1264,7 +1542,7 @@ public:
 
 		for (unsigned k = 8; k < filter_width; k += 8) {
 			unsigned taps_remain = std::min(filter_width - k, 8U);
-			unsigned top = m_filter.left[i] + k;
+			unsigned top = m_filter->left[i] + k;
 
 			src_lines[0] = in->get_line<pixel_type>(std::min(top + 0, src_height - 1));
 			src_lines[1] = in->get_line<pixel_type>(std::min(top + 1, src_height - 1));
@@ -1283,7 +1561,7 @@ public:
 } // namespace
 
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_h_avx2(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+std::unique_ptr<graphengine::Filter> create_resize_impl_h_avx2(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graphengine::Filter> ret;
 
@@ -1291,16 +1569,18 @@ std::unique_ptr<graphengine::Filter> create_resize_impl_h_avx2(const FilterConte
 	if (cpu_has_slow_permute(query_x86_capabilities()))
 		ret = nullptr;
 	else if (type == PixelType::WORD)
-		ret = ResizeImplH_Permute_U16_AVX2::create(context, height, depth);
+		ret = ResizeImplH_Permute_U16_AVX2::create(*context, height, depth);
 	else if (type == PixelType::HALF)
-		ret = ResizeImplH_Permute_FP_AVX2<f16_traits>::create(context, height);
+		ret = ResizeImplH_Permute_FP_AVX2<f16_traits>::create(*context, height);
 	else if (type == PixelType::FLOAT)
-		ret = ResizeImplH_Permute_FP_AVX2<f32_traits>::create(context, height);
+		ret = ResizeImplH_Permute_FP_AVX2<f32_traits>::create(*context, height);
 #endif
 
 	if (!ret) {
-		if (type == PixelType::WORD)
-			ret = std::make_unique<ResizeImplH_U16_AVX2>(context, height, depth);
+		if (type == PixelType::BYTE)
+			ret = std::make_unique<ResizeImplH_Int_AVX2<uint8_t>>(context, height, depth);
+		else if (type == PixelType::WORD)
+			ret = std::make_unique<ResizeImplH_Int_AVX2<uint16_t>>(context, height, depth);
 		else if (type == PixelType::HALF)
 			ret = std::make_unique<ResizeImplH_FP_AVX2<f16_traits>>(context, height);
 		else if (type == PixelType::FLOAT)
@@ -1310,12 +1590,36 @@ std::unique_ptr<graphengine::Filter> create_resize_impl_h_avx2(const FilterConte
 	return ret;
 }
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_v_avx2(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+std::unique_ptr<graphengine::Filter> create_resize_impl_h3_avx2(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graphengine::Filter> ret;
 
-	if (type == PixelType::WORD)
-		ret = std::make_unique<ResizeImplV_U16_AVX2>(context, width, depth);
+#ifndef ZIMG_RESIZE_NO_PERMUTE
+	// Small filters are handled per plane by the permute kernel.
+	if (!cpu_has_slow_permute(query_x86_capabilities())) {
+		if (type == PixelType::HALF && ResizeImplH_Permute_FP_AVX2<f16_traits>::supported(*context))
+			return nullptr;
+		if (type == PixelType::FLOAT && ResizeImplH_Permute_FP_AVX2<f32_traits>::supported(*context))
+			return nullptr;
+	}
+#endif
+
+	if (type == PixelType::HALF)
+		ret = std::make_unique<ResizeImplH3_FP_AVX2<f16_traits>>(context, height);
+	else if (type == PixelType::FLOAT)
+		ret = std::make_unique<ResizeImplH3_FP_AVX2<f32_traits>>(context, height);
+
+	return ret;
+}
+
+std::unique_ptr<graphengine::Filter> create_resize_impl_v_avx2(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth)
+{
+	std::unique_ptr<graphengine::Filter> ret;
+
+	if (type == PixelType::BYTE)
+		ret = std::make_unique<ResizeImplV_Int_AVX2<uint8_t>>(context, width, depth);
+	else if (type == PixelType::WORD)
+		ret = std::make_unique<ResizeImplV_Int_AVX2<uint16_t>>(context, width, depth);
 	else if (type == PixelType::HALF)
 		ret = std::make_unique<ResizeImplV_FP_AVX2<f16_traits>>(context, width);
 	else if (type == PixelType::FLOAT)
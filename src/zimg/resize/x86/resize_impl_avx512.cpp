@@ -173,7 +173,7 @@ void transpose_line_16x16(T * RESTRICT dst, const T * const * RESTRICT src, unsi
 
 
 template <class Traits, int Taps>
-inline FORCE_INLINE __m512 resize_line16_h_fp_avx512_xiter(unsigned j, const unsigned *filter_left, const float *filter_data, unsigned filter_stride, unsigned filter_width,
+inline FORCE_INLINE __m512 resize_line16_h_fp_avx512_xiter(unsigned j, const unsigned *filter_left, const unsigned *filter_phase, const float *filter_data, unsigned filter_stride, unsigned filter_width,
                                                            const typename Traits::pixel_type *src, unsigned src_base)
 {
 	static_assert(Taps <= 8, "only up to 8 taps can be unrolled");
@@ -182,7 +182,7 @@ inline FORCE_INLINE __m512 resize_line16_h_fp_avx512_xiter(unsigned j, const uns
 
 	typedef typename Traits::pixel_type pixel_type;
 
-	const float *filter_coeffs = filter_data + j * filter_stride;
+	const float *filter_coeffs = filter_data + filter_phase[j] * filter_stride;
 	const pixel_type *src_p = src + (filter_left[j] - src_base) * 16;
 
 	__m512 accum0 = _mm512_setzero_ps();
@@ -218,14 +218,14 @@ inline FORCE_INLINE __m512 resize_line16_h_fp_avx512_xiter(unsigned j, const uns
 }
 
 template <class Traits, int Taps>
-void resize_line16_h_fp_avx512(const unsigned * RESTRICT filter_left, const float * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+void resize_line16_h_fp_avx512(const unsigned * RESTRICT filter_left, const unsigned * RESTRICT filter_phase, const float * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
                                const typename Traits::pixel_type * RESTRICT src, typename Traits::pixel_type * const * /* RESTRICT */ dst, unsigned src_base, unsigned left, unsigned right)
 {
 	unsigned vec_left = ceil_n(left, 16);
 	unsigned vec_right = floor_n(right, 16);
 
 #define XITER resize_line16_h_fp_avx512_xiter<Traits, Taps>
-#define XARGS filter_left, filter_data, filter_stride, filter_width, src, src_base
+#define XARGS filter_left, filter_phase, filter_data, filter_stride, filter_width, src, src_base
 	for (unsigned j = left; j < vec_left; ++j) {
 		__m512 x = XITER(j, XARGS);
 		Traits::scatter16(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, dst[4] + j, dst[5] + j, dst[6] + j, dst[7] + j,
@@ -290,6 +290,155 @@ constexpr auto resize_line16_h_fp_avx512_jt_large = make_array(
 	resize_line16_h_fp_avx512<Traits, -3>);
 
 
+template <class Traits, int Taps>
+inline FORCE_INLINE void resize_line16x3_h_fp_avx512_xiter(unsigned j, const unsigned *filter_left, const unsigned *filter_phase, const float *filter_data, unsigned filter_stride, unsigned filter_width,
+                                                           const typename Traits::pixel_type * const *src, unsigned src_base, __m512 &out0, __m512 &out1, __m512 &out2)
+{
+	static_assert(Taps <= 8, "only up to 8 taps can be unrolled");
+	static_assert(Taps >= -3, "only up to 3 taps in epilogue");
+	constexpr int Tail = Taps >= 4 ? Taps - 4 : Taps > 0 ? Taps : -Taps;
+
+	typedef typename Traits::pixel_type pixel_type;
+
+	const float *filter_coeffs = filter_data + filter_phase[j] * filter_stride;
+	ptrdiff_t offset = static_cast<ptrdiff_t>(filter_left[j] - src_base) * 16;
+	const pixel_type *src0_p = src[0] + offset;
+	const pixel_type *src1_p = src[1] + offset;
+	const pixel_type *src2_p = src[2] + offset;
+
+	__m512 accum0a = _mm512_setzero_ps();
+	__m512 accum0b = _mm512_setzero_ps();
+	__m512 accum1a = _mm512_setzero_ps();
+	__m512 accum1b = _mm512_setzero_ps();
+	__m512 accum2a = _mm512_setzero_ps();
+	__m512 accum2b = _mm512_setzero_ps();
+	__m512 coeffs;
+
+	// Each coefficient is broadcast once and applied to all three planes.
+	auto f = ZIMG_UNROLL_FUNC(kk)
+	{
+		__m512 &acc0 = kk % 2 ? accum0b : accum0a;
+		__m512 &acc1 = kk % 2 ? accum1b : accum1a;
+		__m512 &acc2 = kk % 2 ? accum2b : accum2a;
+		__m512 c = _mm512_shuffle_ps(coeffs, coeffs, static_cast<unsigned>(_MM_SHUFFLE(kk, kk, kk, kk)));
+
+		acc0 = _mm512_fmadd_ps(c, Traits::load16(src0_p + kk * 16), acc0);
+		acc1 = _mm512_fmadd_ps(c, Traits::load16(src1_p + kk * 16), acc1);
+		acc2 = _mm512_fmadd_ps(c, Traits::load16(src2_p + kk * 16), acc2);
+	};
+
+	unsigned k_end = Taps >= 4 ? 4 : Taps > 0 ? 0 : floor_n(filter_width, 4);
+
+	for (unsigned k = 0; k < k_end; k += 4) {
+		coeffs = _mm512_broadcast_f32x4(_mm_load_ps(filter_coeffs + k));
+		unroll<4>(f);
+		src0_p += 64;
+		src1_p += 64;
+		src2_p += 64;
+	}
+
+	if constexpr (Tail) {
+		coeffs = _mm512_broadcast_f32x4(_mm_load_ps(filter_coeffs + k_end));
+		unroll<Tail>(f);
+	}
+
+	if constexpr (Taps <= 0 || Taps >= 2) {
+		accum0a = _mm512_add_ps(accum0a, accum0b);
+		accum1a = _mm512_add_ps(accum1a, accum1b);
+		accum2a = _mm512_add_ps(accum2a, accum2b);
+	}
+
+	out0 = accum0a;
+	out1 = accum1a;
+	out2 = accum2a;
+}
+
+template <class Traits, int Taps>
+void resize_line16x3_h_fp_avx512(const unsigned * RESTRICT filter_left, const unsigned * RESTRICT filter_phase, const float * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+                                 const typename Traits::pixel_type * const *src, typename Traits::pixel_type * const (*dst)[16], unsigned src_base, unsigned left, unsigned right)
+{
+	unsigned vec_left = ceil_n(left, 16);
+	unsigned vec_right = floor_n(right, 16);
+
+#define XITER resize_line16x3_h_fp_avx512_xiter<Traits, Taps>
+#define XARGS filter_left, filter_phase, filter_data, filter_stride, filter_width, src, src_base
+#define SCATTER(p, x) Traits::scatter16(dst[p][0] + j, dst[p][1] + j, dst[p][2] + j, dst[p][3] + j, dst[p][4] + j, dst[p][5] + j, dst[p][6] + j, dst[p][7] + j, \
+                                        dst[p][8] + j, dst[p][9] + j, dst[p][10] + j, dst[p][11] + j, dst[p][12] + j, dst[p][13] + j, dst[p][14] + j, dst[p][15] + j, x)
+	for (unsigned j = left; j < vec_left; ++j) {
+		__m512 x0, x1, x2;
+		XITER(j, XARGS, x0, x1, x2);
+		SCATTER(0, x0);
+		SCATTER(1, x1);
+		SCATTER(2, x2);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 16) {
+		float cache alignas(64)[3][16][16];
+
+		for (unsigned jj = j; jj < j + 16; ++jj) {
+			__m512 x0, x1, x2;
+			XITER(jj, XARGS, x0, x1, x2);
+			_mm512_store_ps(cache[0][jj - j], x0);
+			_mm512_store_ps(cache[1][jj - j], x1);
+			_mm512_store_ps(cache[2][jj - j], x2);
+		}
+
+		for (unsigned p = 0; p < 3; ++p) {
+			__m512 x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
+
+			x0  = _mm512_load_ps(cache[p][0]);  x1  = _mm512_load_ps(cache[p][1]);
+			x2  = _mm512_load_ps(cache[p][2]);  x3  = _mm512_load_ps(cache[p][3]);
+			x4  = _mm512_load_ps(cache[p][4]);  x5  = _mm512_load_ps(cache[p][5]);
+			x6  = _mm512_load_ps(cache[p][6]);  x7  = _mm512_load_ps(cache[p][7]);
+			x8  = _mm512_load_ps(cache[p][8]);  x9  = _mm512_load_ps(cache[p][9]);
+			x10 = _mm512_load_ps(cache[p][10]); x11 = _mm512_load_ps(cache[p][11]);
+			x12 = _mm512_load_ps(cache[p][12]); x13 = _mm512_load_ps(cache[p][13]);
+			x14 = _mm512_load_ps(cache[p][14]); x15 = _mm512_load_ps(cache[p][15]);
+
+			mm512_transpose16_ps(x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15);
+
+			Traits::store16(dst[p][0] + j,  x0);  Traits::store16(dst[p][1] + j,  x1);
+			Traits::store16(dst[p][2] + j,  x2);  Traits::store16(dst[p][3] + j,  x3);
+			Traits::store16(dst[p][4] + j,  x4);  Traits::store16(dst[p][5] + j,  x5);
+			Traits::store16(dst[p][6] + j,  x6);  Traits::store16(dst[p][7] + j,  x7);
+			Traits::store16(dst[p][8] + j,  x8);  Traits::store16(dst[p][9] + j,  x9);
+			Traits::store16(dst[p][10] + j, x10); Traits::store16(dst[p][11] + j, x11);
+			Traits::store16(dst[p][12] + j, x12); Traits::store16(dst[p][13] + j, x13);
+			Traits::store16(dst[p][14] + j, x14); Traits::store16(dst[p][15] + j, x15);
+		}
+	}
+
+	for (unsigned j = vec_right; j < right; ++j) {
+		__m512 x0, x1, x2;
+		XITER(j, XARGS, x0, x1, x2);
+		SCATTER(0, x0);
+		SCATTER(1, x1);
+		SCATTER(2, x2);
+	}
+#undef XITER
+#undef XARGS
+#undef SCATTER
+}
+
+template <class Traits>
+constexpr auto resize_line16x3_h_fp_avx512_jt_small = make_array(
+	resize_line16x3_h_fp_avx512<Traits, 1>,
+	resize_line16x3_h_fp_avx512<Traits, 2>,
+	resize_line16x3_h_fp_avx512<Traits, 3>,
+	resize_line16x3_h_fp_avx512<Traits, 4>,
+	resize_line16x3_h_fp_avx512<Traits, 5>,
+	resize_line16x3_h_fp_avx512<Traits, 6>,
+	resize_line16x3_h_fp_avx512<Traits, 7>,
+	resize_line16x3_h_fp_avx512<Traits, 8>);
+
+template <class Traits>
+constexpr auto resize_line16x3_h_fp_avx512_jt_large = make_array(
+	resize_line16x3_h_fp_avx512<Traits, 0>,
+	resize_line16x3_h_fp_avx512<Traits, -1>,
+	resize_line16x3_h_fp_avx512<Traits, -2>,
+	resize_line16x3_h_fp_avx512<Traits, -3>);
+
+
 template <class Traits, unsigned Taps>
 void resize_line_h_perm_fp_avx512(const unsigned * RESTRICT permute_left, const unsigned * RESTRICT permute_mask, const float * RESTRICT filter_data, unsigned input_width,
                                   const typename Traits::pixel_type * RESTRICT src, typename Traits::pixel_type * RESTRICT dst, unsigned left, unsigned right)
@@ -489,17 +638,17 @@ class ResizeImplH_FP_AVX512 : public ResizeImplH {
 
 	func_type m_func;
 public:
-	ResizeImplH_FP_AVX512(const FilterContext &filter, unsigned height) try :
+	ResizeImplH_FP_AVX512(const std::shared_ptr<const FilterContext> &filter, unsigned height) try :
 		ResizeImplH(filter, height, Traits::type_constant),
 		m_func{}
 	{
 		m_desc.step = 16;
-		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter.input_width }, 16) * sizeof(pixel_type) * 16).get();
+		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter->input_width }, 16) * sizeof(pixel_type) * 16).get();
 
-		if (filter.filter_width <= 8)
-			m_func = resize_line16_h_fp_avx512_jt_small<Traits>[filter.filter_width - 1];
+		if (filter->filter_width <= 8)
+			m_func = resize_line16_h_fp_avx512_jt_small<Traits>[filter->filter_width - 1];
 		else
-			m_func = resize_line16_h_fp_avx512_jt_large<Traits>[filter.filter_width % 4];
+			m_func = resize_line16_h_fp_avx512_jt_large<Traits>[filter->filter_width % 4];
 	} catch (const std::overflow_error &) {
 		error::throw_<error::OutOfMemory>();
 	}
@@ -522,7 +671,64 @@ public:
 		calculate_line_address(dst_ptr + 0, out->ptr, out->stride, out->mask, i + 0, height);
 		calculate_line_address(dst_ptr + 8, out->ptr, out->stride, out->mask, i + std::min(8U, height - i - 1), height);
 
-		m_func(m_filter.left.data(), m_filter.data.data(), m_filter.stride, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->phase.data(), m_filter->data.data(), m_filter->stride, m_filter->filter_width,
+		       transpose_buf, dst_ptr, floor_n(range.first, 16), left, right);
+	}
+};
+
+template <class Traits>
+class ResizeImplH3_FP_AVX512 : public ResizeImplH {
+	typedef typename Traits::pixel_type pixel_type;
+	typedef typename decltype(resize_line16x3_h_fp_avx512_jt_small<Traits>)::value_type func_type;
+
+	func_type m_func;
+	size_t m_plane_size;
+public:
+	ResizeImplH3_FP_AVX512(const std::shared_ptr<const FilterContext> &filter, unsigned height) try :
+		ResizeImplH(filter, height, Traits::type_constant),
+		m_func{},
+		m_plane_size{}
+	{
+		checked_size_t plane_size = ceil_n(checked_size_t{ filter->input_width }, 16) * 16;
+
+		m_desc.num_deps = 3;
+		m_desc.num_planes = 3;
+		m_desc.step = 16;
+		m_desc.scratchpad_size = (plane_size * sizeof(pixel_type) * 3).get();
+		m_plane_size = plane_size.get();
+
+		if (filter->filter_width <= 8)
+			m_func = resize_line16x3_h_fp_avx512_jt_small<Traits>[filter->filter_width - 1];
+		else
+			m_func = resize_line16x3_h_fp_avx512_jt_large<Traits>[filter->filter_width % 4];
+	} catch (const std::overflow_error &) {
+		error::throw_<error::OutOfMemory>();
+	}
+
+	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
+	             unsigned i, unsigned left, unsigned right, void *, void *tmp) const noexcept override
+	{
+		auto range = get_col_deps(left, right);
+
+		alignas(64) const pixel_type *src_ptr[16];
+		alignas(64) pixel_type *dst_ptr[3][16];
+		const pixel_type *transpose_buf[3];
+		unsigned height = m_desc.format.height;
+
+		for (unsigned p = 0; p < 3; ++p) {
+			pixel_type *buf = static_cast<pixel_type *>(tmp) + p * m_plane_size;
+
+			calculate_line_address(src_ptr + 0, in[p].ptr, in[p].stride, in[p].mask, i + 0, height);
+			calculate_line_address(src_ptr + 8, in[p].ptr, in[p].stride, in[p].mask, i + std::min(8U, height - i - 1), height);
+
+			transpose_line_16x16<Traits>(buf, src_ptr, floor_n(range.first, 16), ceil_n(range.second, 16));
+			transpose_buf[p] = buf;
+
+			calculate_line_address(dst_ptr[p] + 0, out[p].ptr, out[p].stride, out[p].mask, i + 0, height);
+			calculate_line_address(dst_ptr[p] + 8, out[p].ptr, out[p].stride, out[p].mask, i + std::min(8U, height - i - 1), height);
+		}
+
+		m_func(m_filter->left.data(), m_filter->phase.data(), m_filter->data.data(), m_filter->stride, m_filter->filter_width,
 		       transpose_buf, dst_ptr, floor_n(range.first, 16), left, right);
 	}
 };
@@ -557,10 +763,23 @@ class ResizeImplH_Permute_FP_AVX512 : public graph::FilterBase {
 		m_desc.flags.entire_row = !std::is_sorted(m_context.left.begin(), m_context.left.end());
 	}
 public:
-	static std::unique_ptr<graphengine::Filter> create(const FilterContext &filter, unsigned height)
+	static bool supported(const FilterContext &filter)
 	{
 		// Transpose is faster for large filters.
 		if (filter.filter_width > 16)
+			return false;
+
+		for (unsigned i = 0; i < filter.filter_rows; i += 16) {
+			auto minmax = std::minmax_element(filter.left.begin() + i, filter.left.begin() + std::min(i + 16, filter.filter_rows));
+			if (*minmax.second - *minmax.first >= 16)
+				return false;
+		}
+		return true;
+	}
+
+	static std::unique_ptr<graphengine::Filter> create(const FilterContext &filter, unsigned height)
+	{
+		if (!supported(filter))
 			return nullptr;
 
 		PermuteContext context{};
@@ -574,14 +793,10 @@ public:
 
 		for (unsigned i = 0; i < filter.filter_rows; i += 16) {
 			unsigned left_min = UINT_MAX;
-			unsigned left_max = 0U;
 
 			for (unsigned ii = i; ii < std::min(i + 16, context.filter_rows); ++ii) {
 				left_min = std::min(left_min, filter.left[ii]);
-				left_max = std::max(left_max, filter.left[ii]);
 			}
-			if (left_max - left_min >= 16)
-				return nullptr;
 
 			for (unsigned ii = i; ii < std::min(i + 16, context.filter_rows); ++ii) {
 				context.permute[ii] = filter.left[ii] - left_min;
@@ -591,7 +806,7 @@ public:
 			float *data = context.data.data() + i * context.filter_width;
 			for (unsigned k = 0; k < context.filter_width; ++k) {
 				for (unsigned ii = i; ii < std::min(i + 16, context.filter_rows); ++ii) {
-					data[static_cast<size_t>(k) * 16 + (ii - i)] = filter.data[ii * static_cast<ptrdiff_t>(filter.stride) + k];
+					data[static_cast<size_t>(k) * 16 + (ii - i)] = filter.data[filter.phase[ii] * static_cast<ptrdiff_t>(filter.stride) + k];
 				}
 			}
 		}
@@ -625,23 +840,23 @@ template <class Traits>
 class ResizeImplV_FP_AVX512 : public ResizeImplV {
 	typedef typename Traits::pixel_type pixel_type;
 public:
-	ResizeImplV_FP_AVX512(const FilterContext &filter, unsigned width) :
+	ResizeImplV_FP_AVX512(const std::shared_ptr<const FilterContext> &filter, unsigned width) :
 		ResizeImplV(filter, width, Traits::type_constant)
 	{}
 
 	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
 	             unsigned i, unsigned left, unsigned right, void *, void *) const noexcept override
 	{
-		const float *filter_data = m_filter.data.data() + i * m_filter.stride;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const float *filter_data = m_filter->data.data() + m_filter->phase[i] * m_filter->stride;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
 		alignas(64) const pixel_type *src_lines[8];
 		pixel_type *dst_line = out->get_line<pixel_type>(i);
 
 		{
 			unsigned taps_remain = std::min(filter_width - 0, 8U);
-			unsigned top = m_filter.left[i] + 0;
+			unsigned top = m_filter->left[i] + 0;
 
 			calculate_line_address(src_lines, in->ptr, in->stride, in->mask, top, src_height);
 			resize_line_v_fp_avx512_jt_init<Traits>[taps_remain - 1](filter_data + 0, src_lines, dst_line, left, right);
@@ -649,7 +864,7 @@ public:
 
 		for (unsigned k = 8; k < filter_width; k += 8) {
 			unsigned taps_remain = std::min(filter_width - k, 8U);
-			unsigned top = m_filter.left[i] + k;
+			unsigned top = m_filter->left[i] + k;
 
 			calculate_line_address(src_lines, in->ptr, in->stride, in->mask, top, src_height);
 			resize_line_v_fp_avx512_jt_cont<Traits>[taps_remain - 1](filter_data + k, src_lines, dst_line, left, right);
@@ -660,22 +875,24 @@ public:
 } // namespace
 
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_h_avx512(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+std::unique_ptr<graphengine::Filter> create_resize_impl_h_avx512(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graphengine::Filter> ret;
 
 #ifndef ZIMG_RESIZE_NO_PERMUTE
 	if (type == PixelType::WORD)
-		ret = ResizeImplH_Permute_U16_AVX512::create(context, height, depth);
+		ret = ResizeImplH_Permute_U16_AVX512::create(*context, height, depth);
 	else if (type == PixelType::HALF)
-		ret = ResizeImplH_Permute_FP_AVX512<f16_traits>::create(context, height);
+		ret = ResizeImplH_Permute_FP_AVX512<f16_traits>::create(*context, height);
 	else if (type == PixelType::FLOAT)
-		ret = ResizeImplH_Permute_FP_AVX512<f32_traits>::create(context, height);
+		ret = ResizeImplH_Permute_FP_AVX512<f32_traits>::create(*context, height);
 #endif
 
 	if (!ret) {
-		if (type == PixelType::WORD)
-			ret = std::make_unique<ResizeImplH_U16_AVX512>(context, height, depth);
+		if (type == PixelType::BYTE)
+			ret = std::make_unique<ResizeImplH_Int_AVX512<uint8_t>>(context, height, depth);
+		else if (type == PixelType::WORD)
+			ret = std::make_unique<ResizeImplH_Int_AVX512<uint16_t>>(context, height, depth);
 		else if (type == PixelType::HALF)
 			ret = std::make_unique<ResizeImplH_FP_AVX512<f16_traits>>(context, height);
 		else if (type == PixelType::FLOAT)
@@ -685,12 +902,34 @@ std::unique_ptr<graphengine::Filter> create_resize_impl_h_avx512(const FilterCon
 	return ret;
 }
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_v_avx512(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+std::unique_ptr<graphengine::Filter> create_resize_impl_h3_avx512(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graphengine::Filter> ret;
 
-	if (type == PixelType::WORD)
-		ret = std::make_unique<ResizeImplV_U16_AVX512>(context, width, depth);
+#ifndef ZIMG_RESIZE_NO_PERMUTE
+	// Small filters are handled per plane by the permute kernel.
+	if (type == PixelType::HALF && ResizeImplH_Permute_FP_AVX512<f16_traits>::supported(*context))
+		return nullptr;
+	if (type == PixelType::FLOAT && ResizeImplH_Permute_FP_AVX512<f32_traits>::supported(*context))
+		return nullptr;
+#endif
+
+	if (type == PixelType::HALF)
+		ret = std::make_unique<ResizeImplH3_FP_AVX512<f16_traits>>(context, height);
+	else if (type == PixelType::FLOAT)
+		ret = std::make_unique<ResizeImplH3_FP_AVX512<f32_traits>>(context, height);
+
+	return ret;
+}
+
+std::unique_ptr<graphengine::Filter> create_resize_impl_v_avx512(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth)
+{
+	std::unique_ptr<graphengine::Filter> ret;
+
+	if (type == PixelType::BYTE)
+		ret = std::make_unique<ResizeImplV_Int_AVX512<uint8_t>>(context, width, depth);
+	else if (type == PixelType::WORD)
+		ret = std::make_unique<ResizeImplV_Int_AVX512<uint16_t>>(context, width, depth);
 	else if (type == PixelType::HALF)
 		ret = std::make_unique<ResizeImplV_FP_AVX512<f16_traits>>(context, width);
 	else if (type == PixelType::FLOAT)
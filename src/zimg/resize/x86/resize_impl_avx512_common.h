@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <climits>
 #include <cstdint>
+#include <type_traits>
 #include "common/align.h"
 #include "common/ccdep.h"
 #include "common/checked_int.h"
@@ -44,20 +45,70 @@ inline FORCE_INLINE __m512i export2_i30_u16(__m512i lo, __m512i hi)
 	return lo;
 }
 
-void transpose_line_32x32_epi16(uint16_t * RESTRICT dst, const uint16_t * const * RESTRICT src, unsigned left, unsigned right)
+inline FORCE_INLINE __m512i load32_epi16(const uint8_t *ptr)
+{
+	return _mm512_cvtepu8_epi16(_mm256_load_si256((const __m256i *)ptr));
+}
+
+inline FORCE_INLINE __m512i load32_epi16(const uint16_t *ptr)
+{
+	return _mm512_load_si512(ptr);
+}
+
+inline FORCE_INLINE void store32_epi16(uint8_t *ptr, __m512i x)
+{
+	_mm256_store_si256((__m256i *)ptr, _mm512_cvtepi16_epi8(x));
+}
+
+inline FORCE_INLINE void store32_epi16(uint16_t *ptr, __m512i x)
+{
+	_mm512_store_si512(ptr, x);
+}
+
+inline FORCE_INLINE void mask_store32_epi16(uint8_t *ptr, __mmask32 mask, __m512i x)
+{
+	_mm256_mask_storeu_epi8(ptr, mask, _mm512_cvtepi16_epi8(x));
+}
+
+inline FORCE_INLINE void mask_store32_epi16(uint16_t *ptr, __mmask32 mask, __m512i x)
+{
+	_mm512_mask_storeu_epi16(ptr, mask, x);
+}
+
+inline FORCE_INLINE void scatter32_epi16(uint8_t * const *dst, unsigned j, __m512i x)
+{
+	uint8_t tmp alignas(32)[32];
+	_mm256_store_si256((__m256i *)tmp, _mm512_cvtepi16_epi8(x));
+
+	for (unsigned n = 0; n < 32; ++n) {
+		dst[n][j] = tmp[n];
+	}
+}
+
+inline FORCE_INLINE void scatter32_epi16(uint16_t * const *dst, unsigned j, __m512i x)
+{
+	mm_scatter_epi16(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, dst[4] + j, dst[5] + j, dst[6] + j, dst[7] + j, _mm512_castsi512_si128(x));
+	mm_scatter_epi16(dst[8] + j, dst[9] + j, dst[10] + j, dst[11] + j, dst[12] + j, dst[13] + j, dst[14] + j, dst[15] + j, _mm512_extracti32x4_epi32(x, 1));
+	mm_scatter_epi16(dst[16] + j, dst[17] + j, dst[18] + j, dst[19] + j, dst[20] + j, dst[21] + j, dst[22] + j, dst[23] + j, _mm512_extracti32x4_epi32(x, 2));
+	mm_scatter_epi16(dst[24] + j, dst[25] + j, dst[26] + j, dst[27] + j, dst[28] + j, dst[29] + j, dst[30] + j, dst[31] + j, _mm512_extracti32x4_epi32(x, 3));
+}
+
+// Transposes 16-bit or zero-extended 8-bit pixels into a 16-bit buffer.
+template <class T>
+void transpose_line_32x32_epi16(uint16_t * RESTRICT dst, const T * const * RESTRICT src, unsigned left, unsigned right)
 {
 	for (unsigned j = left; j < right; j += 32) {
 		__m512i x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
 		__m512i x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31;
 
-		x0  = _mm512_load_si512(src[0] + j);  x1  = _mm512_load_si512(src[1] + j);  x2  = _mm512_load_si512(src[2] + j);  x3  = _mm512_load_si512(src[3] + j);
-		x4  = _mm512_load_si512(src[4] + j);  x5  = _mm512_load_si512(src[5] + j);  x6  = _mm512_load_si512(src[6] + j);  x7  = _mm512_load_si512(src[7] + j);
-		x8  = _mm512_load_si512(src[8] + j);  x9  = _mm512_load_si512(src[9] + j);  x10 = _mm512_load_si512(src[10] + j); x11 = _mm512_load_si512(src[11] + j);
-		x12 = _mm512_load_si512(src[12] + j); x13 = _mm512_load_si512(src[13] + j); x14 = _mm512_load_si512(src[14] + j); x15 = _mm512_load_si512(src[15] + j);
-		x16 = _mm512_load_si512(src[16] + j); x17 = _mm512_load_si512(src[17] + j); x18 = _mm512_load_si512(src[18] + j); x19 = _mm512_load_si512(src[19] + j);
-		x20 = _mm512_load_si512(src[20] + j); x21 = _mm512_load_si512(src[21] + j); x22 = _mm512_load_si512(src[22] + j); x23 = _mm512_load_si512(src[23] + j);
-		x24 = _mm512_load_si512(src[24] + j); x25 = _mm512_load_si512(src[25] + j); x26 = _mm512_load_si512(src[26] + j); x27 = _mm512_load_si512(src[27] + j);
-		x28 = _mm512_load_si512(src[28] + j); x29 = _mm512_load_si512(src[29] + j); x30 = _mm512_load_si512(src[30] + j); x31 = _mm512_load_si512(src[31] + j);
+		x0  = load32_epi16(src[0] + j);  x1  = load32_epi16(src[1] + j);  x2  = load32_epi16(src[2] + j);  x3  = load32_epi16(src[3] + j);
+		x4  = load32_epi16(src[4] + j);  x5  = load32_epi16(src[5] + j);  x6  = load32_epi16(src[6] + j);  x7  = load32_epi16(src[7] + j);
+		x8  = load32_epi16(src[8] + j);  x9  = load32_epi16(src[9] + j);  x10 = load32_epi16(src[10] + j); x11 = load32_epi16(src[11] + j);
+		x12 = load32_epi16(src[12] + j); x13 = load32_epi16(src[13] + j); x14 = load32_epi16(src[14] + j); x15 = load32_epi16(src[15] + j);
+		x16 = load32_epi16(src[16] + j); x17 = load32_epi16(src[17] + j); x18 = load32_epi16(src[18] + j); x19 = load32_epi16(src[19] + j);
+		x20 = load32_epi16(src[20] + j); x21 = load32_epi16(src[21] + j); x22 = load32_epi16(src[22] + j); x23 = load32_epi16(src[23] + j);
+		x24 = load32_epi16(src[24] + j); x25 = load32_epi16(src[25] + j); x26 = load32_epi16(src[26] + j); x27 = load32_epi16(src[27] + j);
+		x28 = load32_epi16(src[28] + j); x29 = load32_epi16(src[29] + j); x30 = load32_epi16(src[30] + j); x31 = load32_epi16(src[31] + j);
 
 		mm512_transpose32_epi16(x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15,
 		                        x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31);
@@ -76,7 +127,7 @@ void transpose_line_32x32_epi16(uint16_t * RESTRICT dst, const uint16_t * const
 }
 
 template <int Taps>
-inline FORCE_INLINE __m512i resize_line16_h_u16_avx512_xiter(unsigned j, const unsigned *filter_left, const int16_t *filter_data, unsigned filter_stride, unsigned filter_width,
+inline FORCE_INLINE __m512i resize_line16_h_u16_avx512_xiter(unsigned j, const unsigned *filter_left, const unsigned *filter_phase, const int16_t *filter_data, unsigned filter_stride, unsigned filter_width,
                                                              const uint16_t *src, unsigned src_base, uint16_t limit)
 {
 	static_assert(Taps <= 8, "only up to 8 taps can be unrolled");
@@ -87,7 +138,7 @@ inline FORCE_INLINE __m512i resize_line16_h_u16_avx512_xiter(unsigned j, const u
 	const __m512i i16_min = _mm512_set1_epi16(INT16_MIN);
 	const __m512i lim = _mm512_set1_epi16(limit + INT16_MIN);
 
-	const int16_t *filter_coeffs = filter_data + j * filter_stride;
+	const int16_t *filter_coeffs = filter_data + filter_phase[j] * filter_stride;
 	const uint16_t *src_p = src + (filter_left[j] - src_base) * 32;
 
 	__m512i accum_lo = _mm512_setzero_si512();
@@ -129,22 +180,18 @@ inline FORCE_INLINE __m512i resize_line16_h_u16_avx512_xiter(unsigned j, const u
 	return accum_lo;
 }
 
-template <int Taps>
-void resize_line16_h_u16_avx512(const unsigned * RESTRICT filter_left, const int16_t * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
-                                const uint16_t * RESTRICT src, uint16_t * const * /* RESTRICT */ dst, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
+template <int Taps, class T>
+void resize_line16_h_u16_avx512(const unsigned * RESTRICT filter_left, const unsigned * RESTRICT filter_phase, const int16_t * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+                                const uint16_t * RESTRICT src, T * const * /* RESTRICT */ dst, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
 {
 	unsigned vec_left = ceil_n(left, 32);
 	unsigned vec_right = floor_n(right, 32);
 
 #define XITER resize_line16_h_u16_avx512_xiter<Taps>
-#define XARGS filter_left, filter_data, filter_stride, filter_width, src, src_base, limit
+#define XARGS filter_left, filter_phase, filter_data, filter_stride, filter_width, src, src_base, limit
 	for (unsigned j = left; j < vec_left; ++j) {
 		__m512i x = XITER(j, XARGS);
-
-		mm_scatter_epi16(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, dst[4] + j, dst[5] + j, dst[6] + j, dst[7] + j, _mm512_castsi512_si128(x));
-		mm_scatter_epi16(dst[8] + j, dst[9] + j, dst[10] + j, dst[11] + j, dst[12] + j, dst[13] + j, dst[14] + j, dst[15] + j, _mm512_extracti32x4_epi32(x, 1));
-		mm_scatter_epi16(dst[16] + j, dst[17] + j, dst[18] + j, dst[19] + j, dst[20] + j, dst[21] + j, dst[22] + j, dst[23] + j, _mm512_extracti32x4_epi32(x, 2));
-		mm_scatter_epi16(dst[24] + j, dst[25] + j, dst[26] + j, dst[27] + j, dst[28] + j, dst[29] + j, dst[30] + j, dst[31] + j, _mm512_extracti32x4_epi32(x, 3));
+		scatter32_epi16(dst, j, x);
 	}
 
 	for (unsigned j = vec_left; j < vec_right; j += 32) {
@@ -169,47 +216,45 @@ void resize_line16_h_u16_avx512(const unsigned * RESTRICT filter_left, const int
 		mm512_transpose32_epi16(x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15,
 		                        x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31);
 
-		_mm512_store_si512(dst[0] + j,  x0);  _mm512_store_si512(dst[1] + j,  x1);  _mm512_store_si512(dst[2] + j,  x2);  _mm512_store_si512(dst[3] + j,  x3);
-		_mm512_store_si512(dst[4] + j,  x4);  _mm512_store_si512(dst[5] + j,  x5);  _mm512_store_si512(dst[6] + j,  x6);  _mm512_store_si512(dst[7] + j,  x7);
-		_mm512_store_si512(dst[8] + j,  x8);  _mm512_store_si512(dst[9] + j,  x9);  _mm512_store_si512(dst[10] + j, x10); _mm512_store_si512(dst[11] + j, x11);
-		_mm512_store_si512(dst[12] + j, x12); _mm512_store_si512(dst[13] + j, x13); _mm512_store_si512(dst[14] + j, x14); _mm512_store_si512(dst[15] + j, x15);
-		_mm512_store_si512(dst[16] + j, x16); _mm512_store_si512(dst[17] + j, x17); _mm512_store_si512(dst[18] + j, x18); _mm512_store_si512(dst[19] + j, x19);
-		_mm512_store_si512(dst[20] + j, x20); _mm512_store_si512(dst[21] + j, x21); _mm512_store_si512(dst[22] + j, x22); _mm512_store_si512(dst[23] + j, x23);
-		_mm512_store_si512(dst[24] + j, x24); _mm512_store_si512(dst[25] + j, x25); _mm512_store_si512(dst[26] + j, x26); _mm512_store_si512(dst[27] + j, x27);
-		_mm512_store_si512(dst[28] + j, x28); _mm512_store_si512(dst[29] + j, x29); _mm512_store_si512(dst[30] + j, x30); _mm512_store_si512(dst[31] + j, x31);
+		store32_epi16(dst[0] + j,  x0);  store32_epi16(dst[1] + j,  x1);  store32_epi16(dst[2] + j,  x2);  store32_epi16(dst[3] + j,  x3);
+		store32_epi16(dst[4] + j,  x4);  store32_epi16(dst[5] + j,  x5);  store32_epi16(dst[6] + j,  x6);  store32_epi16(dst[7] + j,  x7);
+		store32_epi16(dst[8] + j,  x8);  store32_epi16(dst[9] + j,  x9);  store32_epi16(dst[10] + j, x10); store32_epi16(dst[11] + j, x11);
+		store32_epi16(dst[12] + j, x12); store32_epi16(dst[13] + j, x13); store32_epi16(dst[14] + j, x14); store32_epi16(dst[15] + j, x15);
+		store32_epi16(dst[16] + j, x16); store32_epi16(dst[17] + j, x17); store32_epi16(dst[18] + j, x18); store32_epi16(dst[19] + j, x19);
+		store32_epi16(dst[20] + j, x20); store32_epi16(dst[21] + j, x21); store32_epi16(dst[22] + j, x22); store32_epi16(dst[23] + j, x23);
+		store32_epi16(dst[24] + j, x24); store32_epi16(dst[25] + j, x25); store32_epi16(dst[26] + j, x26); store32_epi16(dst[27] + j, x27);
+		store32_epi16(dst[28] + j, x28); store32_epi16(dst[29] + j, x29); store32_epi16(dst[30] + j, x30); store32_epi16(dst[31] + j, x31);
 	}
 
 	for (unsigned j = vec_right; j < right; ++j) {
 		__m512i x = XITER(j, XARGS);
-
-		mm_scatter_epi16(dst[0] + j, dst[1] + j, dst[2] + j, dst[3] + j, dst[4] + j, dst[5] + j, dst[6] + j, dst[7] + j, _mm512_castsi512_si128(x));
-		mm_scatter_epi16(dst[8] + j, dst[9] + j, dst[10] + j, dst[11] + j, dst[12] + j, dst[13] + j, dst[14] + j, dst[15] + j, _mm512_extracti32x4_epi32(x, 1));
-		mm_scatter_epi16(dst[16] + j, dst[17] + j, dst[18] + j, dst[19] + j, dst[20] + j, dst[21] + j, dst[22] + j, dst[23] + j, _mm512_extracti32x4_epi32(x, 2));
-		mm_scatter_epi16(dst[24] + j, dst[25] + j, dst[26] + j, dst[27] + j, dst[28] + j, dst[29] + j, dst[30] + j, dst[31] + j, _mm512_extracti32x4_epi32(x, 3));
+		scatter32_epi16(dst, j, x);
 	}
 #undef XITER
 #undef XARGS
 }
 
+template <class T>
 constexpr auto resize_line16_h_u16_avx512_jt_small = make_array(
-	resize_line16_h_u16_avx512<2>,
-	resize_line16_h_u16_avx512<2>,
-	resize_line16_h_u16_avx512<4>,
-	resize_line16_h_u16_avx512<4>,
-	resize_line16_h_u16_avx512<6>,
-	resize_line16_h_u16_avx512<6>,
-	resize_line16_h_u16_avx512<8>,
-	resize_line16_h_u16_avx512<8>);
-
+	resize_line16_h_u16_avx512<2, T>,
+	resize_line16_h_u16_avx512<2, T>,
+	resize_line16_h_u16_avx512<4, T>,
+	resize_line16_h_u16_avx512<4, T>,
+	resize_line16_h_u16_avx512<6, T>,
+	resize_line16_h_u16_avx512<6, T>,
+	resize_line16_h_u16_avx512<8, T>,
+	resize_line16_h_u16_avx512<8, T>);
+
+template <class T>
 constexpr auto resize_line16_h_u16_avx512_jt_large = make_array(
-	resize_line16_h_u16_avx512<0>,
-	resize_line16_h_u16_avx512<-2>,
-	resize_line16_h_u16_avx512<-2>,
-	resize_line16_h_u16_avx512<-4>,
-	resize_line16_h_u16_avx512<-4>,
-	resize_line16_h_u16_avx512<-6>,
-	resize_line16_h_u16_avx512<-6>,
-	resize_line16_h_u16_avx512<0>);
+	resize_line16_h_u16_avx512<0, T>,
+	resize_line16_h_u16_avx512<-2, T>,
+	resize_line16_h_u16_avx512<-2, T>,
+	resize_line16_h_u16_avx512<-4, T>,
+	resize_line16_h_u16_avx512<-4, T>,
+	resize_line16_h_u16_avx512<-6, T>,
+	resize_line16_h_u16_avx512<-6, T>,
+	resize_line16_h_u16_avx512<0, T>);
 
 
 template <unsigned Taps>
@@ -313,8 +358,8 @@ constexpr unsigned V_ACCUM_INITIAL = 1;
 constexpr unsigned V_ACCUM_UPDATE = 2;
 constexpr unsigned V_ACCUM_FINAL = 3;
 
-template <unsigned Taps, unsigned AccumMode>
-inline FORCE_INLINE __m512i resize_line_v_u16_avx512_xiter(unsigned j, unsigned accum_base, const uint16_t * const srcp[8],
+template <unsigned Taps, unsigned AccumMode, class T>
+inline FORCE_INLINE __m512i resize_line_v_u16_avx512_xiter(unsigned j, unsigned accum_base, const T * const srcp[8],
                                                            uint32_t * RESTRICT accum_p, const __m512i c[4], uint16_t limit)
 {
 	static_assert(Taps >= 2 && Taps <= 8, "must have between 2-8 taps");
@@ -330,8 +375,8 @@ inline FORCE_INLINE __m512i resize_line_v_u16_avx512_xiter(unsigned j, unsigned
 	{
 		__m512i x0, x1, xl, xh;
 
-		x0 = _mm512_load_si512(srcp[k * 2 + 0] + j);
-		x1 = _mm512_load_si512(srcp[k * 2 + 1] + j);
+		x0 = load32_epi16(srcp[k * 2 + 0] + j);
+		x1 = load32_epi16(srcp[k * 2 + 1] + j);
 		x0 = _mm512_add_epi16(x0, i16_min);
 		x1 = _mm512_add_epi16(x1, i16_min);
 
@@ -362,11 +407,11 @@ inline FORCE_INLINE __m512i resize_line_v_u16_avx512_xiter(unsigned j, unsigned
 	}
 }
 
-template <unsigned Taps, unsigned AccumMode>
-void resize_line_v_u16_avx512(const int16_t * RESTRICT filter_data, const uint16_t * const * RESTRICT src, uint16_t * RESTRICT dst, uint32_t * RESTRICT accum,
+template <unsigned Taps, unsigned AccumMode, class T>
+void resize_line_v_u16_avx512(const int16_t * RESTRICT filter_data, const T * const * RESTRICT src, T * RESTRICT dst, uint32_t * RESTRICT accum,
                               unsigned left, unsigned right, uint16_t limit)
 {
-	const uint16_t *srcp[8] = { src[0], src[1], src[2], src[3], src[4], src[5], src[6], src[7] };
+	const T *srcp[8] = { src[0], src[1], src[2], src[3], src[4], src[5], src[6], src[7] };
 	unsigned vec_left = ceil_n(left, 32);
 	unsigned vec_right = floor_n(right, 32);
 	unsigned accum_base = floor_n(left, 32);
@@ -378,54 +423,58 @@ void resize_line_v_u16_avx512(const int16_t * RESTRICT filter_data, const uint16
 		_mm512_unpacklo_epi16(_mm512_set1_epi16(filter_data[6]), _mm512_set1_epi16(filter_data[7])),
 	};
 
-#define XITER resize_line_v_u16_avx512_xiter<Taps, AccumMode>
+#define XITER resize_line_v_u16_avx512_xiter<Taps, AccumMode, T>
 #define XARGS accum_base, srcp, accum, c, limit
 	if (left != vec_left) {
 		__m512i out = XITER(vec_left - 32, XARGS);
 
 		if (AccumMode == V_ACCUM_NONE || AccumMode == V_ACCUM_FINAL)
-			_mm512_mask_storeu_epi16(dst + vec_left - 32, mmask32_set_hi(vec_left - left), out);
+			mask_store32_epi16(dst + vec_left - 32, mmask32_set_hi(vec_left - left), out);
 	}
 
 	for (unsigned j = vec_left; j < vec_right; j += 32) {
 		__m512i out = XITER(j, XARGS);
 
 		if (AccumMode == V_ACCUM_NONE || AccumMode == V_ACCUM_FINAL)
-			_mm512_store_si512(dst + j, out);
+			store32_epi16(dst + j, out);
 	}
 
 	if (right != vec_right) {
 		__m512i out = XITER(vec_right, XARGS);
 
 		if (AccumMode == V_ACCUM_NONE || AccumMode == V_ACCUM_FINAL)
-			_mm512_mask_storeu_epi16(dst + vec_right, mmask32_set_lo(right - vec_right), out);
+			mask_store32_epi16(dst + vec_right, mmask32_set_lo(right - vec_right), out);
 	}
 #undef XITER
 #undef XARGS
 }
 
+template <class T>
 constexpr auto resize_line_v_u16_avx512_jt_small = make_array(
-	resize_line_v_u16_avx512<2, V_ACCUM_NONE>,
-	resize_line_v_u16_avx512<2, V_ACCUM_NONE>,
-	resize_line_v_u16_avx512<4, V_ACCUM_NONE>,
-	resize_line_v_u16_avx512<4, V_ACCUM_NONE>,
-	resize_line_v_u16_avx512<6, V_ACCUM_NONE>,
-	resize_line_v_u16_avx512<6, V_ACCUM_NONE>,
-	resize_line_v_u16_avx512<8, V_ACCUM_NONE>,
-	resize_line_v_u16_avx512<8, V_ACCUM_NONE>);
-
-constexpr auto resize_line_v_u16_avx512_initial = resize_line_v_u16_avx512<8, V_ACCUM_INITIAL>;
-constexpr auto resize_line_v_u16_avx512_update = resize_line_v_u16_avx512<8, V_ACCUM_UPDATE>;
-
+	resize_line_v_u16_avx512<2, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx512<2, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx512<4, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx512<4, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx512<6, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx512<6, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx512<8, V_ACCUM_NONE, T>,
+	resize_line_v_u16_avx512<8, V_ACCUM_NONE, T>);
+
+template <class T>
+constexpr auto resize_line_v_u16_avx512_initial = resize_line_v_u16_avx512<8, V_ACCUM_INITIAL, T>;
+template <class T>
+constexpr auto resize_line_v_u16_avx512_update = resize_line_v_u16_avx512<8, V_ACCUM_UPDATE, T>;
+
+template <class T>
 constexpr auto resize_line_v_u16_avx512_jt_final = make_array(
-	resize_line_v_u16_avx512<2, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx512<2, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx512<4, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx512<4, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx512<6, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx512<6, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx512<8, V_ACCUM_FINAL>,
-	resize_line_v_u16_avx512<8, V_ACCUM_FINAL>);
+	resize_line_v_u16_avx512<2, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx512<2, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx512<4, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx512<4, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx512<6, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx512<6, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx512<8, V_ACCUM_FINAL, T>,
+	resize_line_v_u16_avx512<8, V_ACCUM_FINAL, T>);
 
 
 inline FORCE_INLINE void calculate_line_address(void *dst, const void *src, ptrdiff_t stride, unsigned mask, unsigned i, unsigned height)
@@ -448,22 +497,23 @@ inline FORCE_INLINE void calculate_line_address(void *dst, const void *src, ptrd
 }
 
 
-class ResizeImplH_U16_AVX512 : public ResizeImplH {
-	decltype(resize_line16_h_u16_avx512_jt_small)::value_type m_func;
+template <class T>
+class ResizeImplH_Int_AVX512 : public ResizeImplH {
+	typename decltype(resize_line16_h_u16_avx512_jt_small<T>)::value_type m_func;
 	uint16_t m_pixel_max;
 public:
-	ResizeImplH_U16_AVX512(const FilterContext &filter, unsigned height, unsigned depth) try :
-		ResizeImplH(filter, height, PixelType::WORD),
+	ResizeImplH_Int_AVX512(const std::shared_ptr<const FilterContext> &filter, unsigned height, unsigned depth) try :
+		ResizeImplH(filter, height, std::is_same_v<T, uint8_t> ? PixelType::BYTE : PixelType::WORD),
 		m_func{},
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{
 		m_desc.step = 32;
-		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter.input_width }, 32) * sizeof(uint16_t) * 32).get();
+		m_desc.scratchpad_size = (ceil_n(checked_size_t{ filter->input_width }, 32) * sizeof(uint16_t) * 32).get();
 
-		if (filter.filter_width > 8)
-			m_func = resize_line16_h_u16_avx512_jt_large[filter.filter_width % 8];
+		if (filter->filter_width > 8)
+			m_func = resize_line16_h_u16_avx512_jt_large<T>[filter->filter_width % 8];
 		else
-			m_func = resize_line16_h_u16_avx512_jt_small[filter.filter_width - 1];
+			m_func = resize_line16_h_u16_avx512_jt_small<T>[filter->filter_width - 1];
 	} catch (const std::overflow_error &) {
 		error::throw_<error::OutOfMemory>();
 	}
@@ -473,8 +523,8 @@ public:
 	{
 		auto range = get_col_deps(left, right);
 
-		alignas(64) const uint16_t *src_ptr[32];
-		alignas(64) uint16_t *dst_ptr[32];
+		alignas(64) const T *src_ptr[32];
+		alignas(64) T *dst_ptr[32];
 		uint16_t *transpose_buf = static_cast<uint16_t *>(tmp);
 		unsigned height = m_desc.format.height;
 
@@ -490,7 +540,7 @@ public:
 		calculate_line_address(dst_ptr + 16, out->ptr, out->stride, out->mask, i + std::min(16U, height - i - 1), height);
 		calculate_line_address(dst_ptr + 24, out->ptr, out->stride, out->mask, i + std::min(24U, height - i - 1), height);
 
-		m_func(m_filter.left.data(), m_filter.data_i16.data(), m_filter.stride_i16, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->phase.data(), m_filter->data_i16.data(), m_filter->stride_i16, m_filter->filter_width,
 		       transpose_buf, dst_ptr, floor_n(range.first, 32), left, right, m_pixel_max);
 	}
 };
@@ -562,8 +612,8 @@ public:
 			int16_t *data = context.data.data() + i * context.filter_width;
 			for (unsigned k = 0; k < context.filter_width; k += 2) {
 				for (unsigned ii = i; ii < std::min(i + 16, context.filter_rows); ++ii) {
-					data[static_cast<size_t>(k / 2) * 32 + (ii - i) * 2 + 0] = filter.data_i16[ii * static_cast<ptrdiff_t>(filter.stride_i16) + k + 0];
-					data[static_cast<size_t>(k / 2) * 32 + (ii - i) * 2 + 1] = filter.data_i16[ii * static_cast<ptrdiff_t>(filter.stride_i16) + k + 1];
+					data[static_cast<size_t>(k / 2) * 32 + (ii - i) * 2 + 0] = filter.data_i16[filter.phase[ii] * static_cast<ptrdiff_t>(filter.stride_i16) + k + 0];
+					data[static_cast<size_t>(k / 2) * 32 + (ii - i) * 2 + 1] = filter.data_i16[filter.phase[ii] * static_cast<ptrdiff_t>(filter.stride_i16) + k + 1];
 				}
 			}
 		}
@@ -593,14 +643,15 @@ public:
 };
 
 
-class ResizeImplV_U16_AVX512 : public ResizeImplV {
+template <class T>
+class ResizeImplV_Int_AVX512 : public ResizeImplV {
 	uint16_t m_pixel_max;
 public:
-	ResizeImplV_U16_AVX512(const FilterContext &filter, unsigned width, unsigned depth) try :
-		ResizeImplV(filter, width, PixelType::WORD),
+	ResizeImplV_Int_AVX512(const std::shared_ptr<const FilterContext> &filter, unsigned width, unsigned depth) try :
+		ResizeImplV(filter, width, std::is_same_v<T, uint8_t> ? PixelType::BYTE : PixelType::WORD),
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{
-		if (m_filter.filter_width > 8)
+		if (m_filter->filter_width > 8)
 			m_desc.scratchpad_size = (ceil_n(checked_size_t{ width }, 32) * sizeof(uint32_t)).get();
 	} catch (const std::overflow_error &) {
 		error::throw_<error::OutOfMemory>();
@@ -609,32 +660,32 @@ public:
 	void process(const graphengine::BufferDescriptor *in, const graphengine::BufferDescriptor *out,
 	             unsigned i, unsigned left, unsigned right, void *, void *tmp) const noexcept override
 	{
-		const int16_t *filter_data = m_filter.data_i16.data() + i * m_filter.stride_i16;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const int16_t *filter_data = m_filter->data_i16.data() + m_filter->phase[i] * m_filter->stride_i16;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
-		alignas(64) const uint16_t *src_lines[8];
-		uint16_t *dst_line = out->get_line<uint16_t>(i);
+		alignas(64) const T *src_lines[8];
+		T *dst_line = out->get_line<T>(i);
 		uint32_t *accum_buf = static_cast<uint32_t *>(tmp);
 
-		unsigned top = m_filter.left[i];
+		unsigned top = m_filter->left[i];
 
 		if (filter_width <= 8) {
 			calculate_line_address(src_lines, in->ptr, in->stride, in->mask, top + 0, src_height);
-			resize_line_v_u16_avx512_jt_small[filter_width - 1](filter_data, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx512_jt_small<T>[filter_width - 1](filter_data, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 		} else {
 			unsigned k_end = ceil_n(filter_width, 8) - 8;
 
 			calculate_line_address(src_lines, in->ptr, in->stride, in->mask, top + 0, src_height);
-			resize_line_v_u16_avx512_initial(filter_data + 0, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx512_initial<T>(filter_data + 0, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 
 			for (unsigned k = 8; k < k_end; k += 8) {
 				calculate_line_address(src_lines, in->ptr, in->stride, in->mask, top + k, src_height);
-				resize_line_v_u16_avx512_update(filter_data + k, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+				resize_line_v_u16_avx512_update<T>(filter_data + k, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 			}
 
 			calculate_line_address(src_lines, in->ptr, in->stride, in->mask, top + k_end, src_height);
-			resize_line_v_u16_avx512_jt_final[filter_width - k_end - 1](filter_data + k_end, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx512_jt_final<T>[filter_width - k_end - 1](filter_data + k_end, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 		}
 	}
 };
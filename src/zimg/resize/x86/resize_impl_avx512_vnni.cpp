@@ -10,29 +10,33 @@
 
 namespace zimg::resize {
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_h_avx512_vnni(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+std::unique_ptr<graphengine::Filter> create_resize_impl_h_avx512_vnni(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graphengine::Filter> ret;
 
 #ifndef ZIMG_RESIZE_NO_PERMUTE
 	if (type == PixelType::WORD)
-		ret = ResizeImplH_Permute_U16_AVX512::create(context, height, depth);
+		ret = ResizeImplH_Permute_U16_AVX512::create(*context, height, depth);
 #endif
 
 	if (!ret) {
-		if (type == PixelType::WORD)
-			ret = std::make_unique<ResizeImplH_U16_AVX512>(context, height, depth);
+		if (type == PixelType::BYTE)
+			ret = std::make_unique<ResizeImplH_Int_AVX512<uint8_t>>(context, height, depth);
+		else if (type == PixelType::WORD)
+			ret = std::make_unique<ResizeImplH_Int_AVX512<uint16_t>>(context, height, depth);
 	}
 
 	return ret;
 }
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_v_avx512_vnni(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+std::unique_ptr<graphengine::Filter> create_resize_impl_v_avx512_vnni(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graphengine::Filter> ret;
 
-	if (type == PixelType::WORD)
-		ret = std::make_unique<ResizeImplV_U16_AVX512>(context, width, depth);
+	if (type == PixelType::BYTE)
+		ret = std::make_unique<ResizeImplV_Int_AVX512<uint8_t>>(context, width, depth);
+	else if (type == PixelType::WORD)
+		ret = std::make_unique<ResizeImplV_Int_AVX512<uint16_t>>(context, width, depth);
 
 	return ret;
 }
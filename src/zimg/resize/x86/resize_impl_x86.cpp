@@ -7,7 +7,7 @@
 
 namespace zimg::resize {
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_h_x86(const FilterContext &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu)
+std::unique_ptr<graphengine::Filter> create_resize_impl_h_x86(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu)
 {
 	X86Capabilities caps = query_x86_capabilities();
 	std::unique_ptr<graphengine::Filter> ret;
@@ -33,7 +33,28 @@ std::unique_ptr<graphengine::Filter> create_resize_impl_h_x86(const FilterContex
 	return ret;
 }
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_v_x86(const FilterContext &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu)
+std::unique_ptr<graphengine::Filter> create_resize_impl_h3_x86(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<graphengine::Filter> ret;
+
+	// Do not fall back to a narrower instruction set if the wider one prefers a single-plane kernel.
+	if (cpu_is_autodetect(cpu)) {
+		if (cpu == CPUClass::AUTO_64B && cpu_has_avx512_f_dq_bw_vl(caps))
+			ret = create_resize_impl_h3_avx512(context, height, type, depth);
+		else if (caps.avx2)
+			ret = create_resize_impl_h3_avx2(context, height, type, depth);
+	} else {
+		if (cpu >= CPUClass::X86_AVX512)
+			ret = create_resize_impl_h3_avx512(context, height, type, depth);
+		else if (cpu >= CPUClass::X86_AVX2)
+			ret = create_resize_impl_h3_avx2(context, height, type, depth);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<graphengine::Filter> create_resize_impl_v_x86(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu)
 {
 	X86Capabilities caps = query_x86_capabilities();
 	std::unique_ptr<graphengine::Filter> ret;
@@ -21,23 +21,30 @@ namespace zimg::resize {
 struct FilterContext;
 
 #define DECLARE_IMPL_H(cpu) \
-std::unique_ptr<graphengine::Filter> create_resize_impl_h_##cpu(const FilterContext &context, unsigned height, PixelType type, unsigned depth);
+std::unique_ptr<graphengine::Filter> create_resize_impl_h_##cpu(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth);
+#define DECLARE_IMPL_H3(cpu) \
+std::unique_ptr<graphengine::Filter> create_resize_impl_h3_##cpu(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth);
 #define DECLARE_IMPL_V(cpu) \
-std::unique_ptr<graphengine::Filter> create_resize_impl_v_##cpu(const FilterContext &context, unsigned width, PixelType type, unsigned depth);
+std::unique_ptr<graphengine::Filter> create_resize_impl_v_##cpu(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth);
 
 DECLARE_IMPL_H(avx2)
 DECLARE_IMPL_H(avx512)
 DECLARE_IMPL_H(avx512_vnni)
 
+DECLARE_IMPL_H3(avx2)
+DECLARE_IMPL_H3(avx512)
+
 DECLARE_IMPL_V(avx2)
 DECLARE_IMPL_V(avx512)
 DECLARE_IMPL_V(avx512_vnni)
 
 #undef DECLARE_IMPL_H
+#undef DECLARE_IMPL_H3
 #undef DECLARE_IMPL_V
 
-std::unique_ptr<graphengine::Filter> create_resize_impl_h_x86(const FilterContext &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu);
-std::unique_ptr<graphengine::Filter> create_resize_impl_v_x86(const FilterContext &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu);
+std::unique_ptr<graphengine::Filter> create_resize_impl_h_x86(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu);
+std::unique_ptr<graphengine::Filter> create_resize_impl_h3_x86(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu);
+std::unique_ptr<graphengine::Filter> create_resize_impl_v_x86(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu);
 
 } // namespace zimg::resize
 
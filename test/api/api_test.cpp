@@ -1,7 +1,12 @@
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <vector>
 #include "api/zimg.h"
+#include "common/alloc.h"
+#include "common/cpuinfo.h"
+#include "graph/serialize.h"
 
 #include "gtest/gtest.h"
 
@@ -86,3 +91,114 @@ TEST(APITest, test_api_2_4_compat)
 		EXPECT_EQ(0xCC, *(reinterpret_cast<unsigned char *>(&format) + i));
 	}
 }
+
+TEST(APITest, test_serialize_graph)
+{
+	zimg_image_format src_format;
+	zimg_image_format dst_format;
+	zimg_image_format_default(&src_format, ZIMG_API_VERSION);
+	zimg_image_format_default(&dst_format, ZIMG_API_VERSION);
+
+	src_format.width = 64;
+	src_format.height = 48;
+	src_format.pixel_type = ZIMG_PIXEL_BYTE;
+	src_format.pixel_range = ZIMG_RANGE_FULL;
+
+	dst_format = src_format;
+	dst_format.width = 40;
+	dst_format.height = 30;
+	dst_format.pixel_type = ZIMG_PIXEL_FLOAT;
+
+	zimg_graph_builder_params params;
+	zimg_graph_builder_params_default(&params, ZIMG_API_VERSION);
+	params.resample_filter = ZIMG_RESIZE_LANCZOS;
+
+	zimg_filter_graph *graph = zimg_filter_graph_build(&src_format, &dst_format, &params);
+	ASSERT_TRUE(graph);
+
+	size_t size = 0;
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_serialize(graph, nullptr, &size));
+	ASSERT_NE(0U, size);
+
+	std::vector<unsigned char> blob(size);
+	size_t small_size = size - 1;
+	EXPECT_EQ(ZIMG_ERROR_ILLEGAL_ARGUMENT, zimg_filter_graph_serialize(graph, blob.data(), &small_size));
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_serialize(graph, blob.data(), &size));
+	ASSERT_EQ(blob.size(), size);
+
+	zimg_filter_graph *restored = zimg_filter_graph_deserialize(blob.data(), blob.size());
+	ASSERT_TRUE(restored);
+
+	// A restored graph produces the same output.
+	zimg::AlignedVector<uint8_t> src(64 * 48);
+	zimg::AlignedVector<float> dst[2] = { zimg::AlignedVector<float>(40 * 32), zimg::AlignedVector<float>(40 * 32) };
+	for (size_t i = 0; i < src.size(); ++i) {
+		src[i] = static_cast<uint8_t>(i * 37);
+	}
+
+	zimg_filter_graph *graphs[2] = { graph, restored };
+	for (unsigned n = 0; n < 2; ++n) {
+		size_t tmp_size;
+		ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_get_tmp_size(graphs[n], &tmp_size));
+		zimg::AlignedVector<unsigned char> tmp(tmp_size);
+
+		zimg_image_buffer_const src_buf{ ZIMG_API_VERSION };
+		src_buf.plane[0] = { src.data(), 64, ZIMG_BUFFER_MAX };
+		zimg_image_buffer dst_buf{ ZIMG_API_VERSION };
+		dst_buf.plane[0] = { dst[n].data(), 40 * sizeof(float), ZIMG_BUFFER_MAX };
+
+		ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_process(graphs[n], &src_buf, &dst_buf, tmp.data(), nullptr, nullptr, nullptr, nullptr));
+	}
+	EXPECT_EQ(dst[0], dst[1]);
+
+	zimg_filter_graph_free(graph);
+	zimg_filter_graph_free(restored);
+
+	blob[0] ^= 0xFF;
+	EXPECT_FALSE(zimg_filter_graph_deserialize(blob.data(), blob.size()));
+	EXPECT_EQ(ZIMG_ERROR_ILLEGAL_ARGUMENT, zimg_get_last_error(nullptr, 0));
+}
+
+TEST(APITest, test_deserialize_cpu)
+{
+	zimg_image_format src_format;
+	zimg_image_format dst_format;
+	zimg_image_format_default(&src_format, ZIMG_API_VERSION);
+	zimg_image_format_default(&dst_format, ZIMG_API_VERSION);
+
+	src_format.width = 64;
+	src_format.height = 48;
+	src_format.pixel_type = ZIMG_PIXEL_BYTE;
+
+	dst_format = src_format;
+	dst_format.width = 32;
+
+	zimg_filter_graph *graph = zimg_filter_graph_build(&src_format, &dst_format, nullptr);
+	ASSERT_TRUE(graph);
+
+	size_t size = 0;
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_serialize(graph, nullptr, &size));
+	std::vector<unsigned char> data(size);
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_serialize(graph, data.data(), &size));
+	zimg_filter_graph_free(graph);
+
+	zimg::graph::GraphBlob blob = zimg::graph::read_graph_blob(data.data(), data.size());
+	zimg::CPUClass host = zimg::cpu_resolve(zimg::CPUClass::AUTO);
+	EXPECT_EQ(host, blob.cpu);
+
+	// A blob from a less capable host is restored with the host's kernels.
+	blob.cpu = zimg::CPUClass::NONE;
+	std::vector<unsigned char> lower = zimg::graph::write_graph_blob(blob);
+	zimg_filter_graph *restored = zimg_filter_graph_deserialize(lower.data(), lower.size());
+	EXPECT_TRUE(restored);
+	zimg_filter_graph_free(restored);
+
+#if defined(ZIMG_X86)
+	if (host < zimg::CPUClass::X86_AVX512_CLX) {
+		blob.cpu = zimg::CPUClass::X86_AVX512_CLX;
+		std::vector<unsigned char> higher = zimg::graph::write_graph_blob(blob);
+		EXPECT_FALSE(zimg_filter_graph_deserialize(higher.data(), higher.size()));
+		EXPECT_EQ(ZIMG_ERROR_UNSUPPORTED_OPERATION, zimg_get_last_error(nullptr, 0));
+	}
+#endif
+}
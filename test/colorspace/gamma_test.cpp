@@ -1,6 +1,8 @@
 #include <cmath>
+#include <cstdint>
 
 #include "colorspace/gamma.h"
+#include "depth/quantize.h"
 #include "gtest/gtest.h"
 
 namespace {
@@ -346,3 +348,31 @@ TEST(GammaTest, test_arib_b67_eotf)
 	test_monotonic(zimg::colorspace::arib_b67_inverse_eotf, 1.0f, 2.0f, 1UL << 16);
 	test_monotonic(zimg::colorspace::arib_b67_eotf, 1.0f, 2.0f, 1UL << 16);
 }
+
+TEST(GammaTest, test_lut_cache)
+{
+	auto to_linear = zimg::colorspace::get_to_linear_lut(zimg::colorspace::st_2084_eotf, 100.0f, 16);
+	auto to_gamma = zimg::colorspace::get_to_gamma_lut(zimg::colorspace::st_2084_inverse_eotf, 0.01f);
+
+	EXPECT_EQ(to_linear, zimg::colorspace::get_to_linear_lut(zimg::colorspace::st_2084_eotf, 100.0f, 16));
+	EXPECT_EQ(to_gamma, zimg::colorspace::get_to_gamma_lut(zimg::colorspace::st_2084_inverse_eotf, 0.01f));
+	EXPECT_NE(to_linear, zimg::colorspace::get_to_linear_lut(zimg::colorspace::st_2084_eotf, 50.0f, 16));
+	EXPECT_NE(to_linear, zimg::colorspace::get_to_linear_lut(zimg::colorspace::st_2084_eotf, 100.0f, 12));
+	EXPECT_NE(to_gamma, zimg::colorspace::get_to_gamma_lut(zimg::colorspace::srgb_inverse_eotf, 0.01f));
+
+	zimg::colorspace::EnsureSinglePrecision x87;
+
+	for (uint32_t i = 0; i <= (1UL << 16); ++i) {
+		float x = static_cast<float>(i) / (1UL << 16) * 2.0f - 0.5f;
+		ASSERT_EQ(zimg::colorspace::st_2084_eotf(x) * 100.0f, to_linear[i]) << i;
+	}
+	for (uint32_t i = 0; i <= UINT16_MAX; ++i) {
+		float x = zimg::depth::half_to_float(static_cast<uint16_t>(i));
+		float expected = zimg::colorspace::st_2084_inverse_eotf(x * 0.01f);
+
+		if (std::isnan(expected))
+			ASSERT_TRUE(std::isnan(to_gamma[i])) << i;
+		else
+			ASSERT_EQ(expected, to_gamma[i]) << i;
+	}
+}
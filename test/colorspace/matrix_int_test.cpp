@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include "colorspace/colorspace.h"
+#include "colorspace/matrix_int.h"
+#include "common/alloc.h"
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "depth/quantize.h"
+#include "graphengine/filter.h"
+
+#include "gtest/gtest.h"
+#include "filter_compare.h"
+
+namespace {
+
+using zimg::colorspace::ColorspaceDefinition;
+using zimg::colorspace::MatrixCoefficients;
+using zimg::colorspace::TransferCharacteristics;
+using zimg::colorspace::ColorPrimaries;
+
+unsigned read_sample(const TestPlane &plane, unsigned i, unsigned j, zimg::PixelType type)
+{
+	return type == zimg::PixelType::BYTE ? plane.row(i)[j] : reinterpret_cast<const uint16_t *>(plane.row(i))[j];
+}
+
+void make_formats(zimg::PixelFormat format[3], zimg::PixelType type, unsigned depth, bool fullrange, MatrixCoefficients matrix)
+{
+	for (unsigned p = 0; p < 3; ++p) {
+		format[p] = { type, depth, fullrange, p != 0 && matrix != MatrixCoefficients::RGB, matrix == MatrixCoefficients::YCGCO };
+	}
+}
+
+// Compares the fixed-point filter to the float conversion with rounding to the output format.
+void test_case(const ColorspaceDefinition &csp_in, const ColorspaceDefinition &csp_out, zimg::PixelType type_in, unsigned depth_in, bool fullrange_in,
+               zimg::PixelType type_out, unsigned depth_out, bool fullrange_out)
+{
+	const unsigned w = 640;
+	const unsigned h = 16;
+
+	SCOPED_TRACE(static_cast<int>(csp_in.matrix));
+	SCOPED_TRACE(static_cast<int>(csp_out.matrix));
+	SCOPED_TRACE(depth_in);
+	SCOPED_TRACE(depth_out);
+
+	zimg::PixelFormat format_in[3];
+	zimg::PixelFormat format_out[3];
+	make_formats(format_in, type_in, depth_in, fullrange_in, csp_in.matrix);
+	make_formats(format_out, type_out, depth_out, fullrange_out, csp_out.matrix);
+
+	auto filter = zimg::colorspace::create_matrix_int_filter(csp_in, csp_out, format_in, format_out, w, h, zimg::CPUClass::NONE);
+	ASSERT_TRUE(filter);
+
+	auto reference = zimg::colorspace::ColorspaceConversion{ w, 1 }
+		.set_csp_in(csp_in)
+		.set_csp_out(csp_out)
+		.set_cpu(zimg::CPUClass::NONE)
+		.create();
+	ASSERT_TRUE(reference);
+
+	std::unique_ptr<TestPlane> src[3];
+	std::unique_ptr<TestPlane> dst[3];
+	graphengine::BufferDescriptor src_buf[3];
+	graphengine::BufferDescriptor dst_buf[3];
+
+	for (unsigned p = 0; p < 3; ++p) {
+		src[p] = std::make_unique<TestPlane>(w, h, type_in);
+		dst[p] = std::make_unique<TestPlane>(w, h, type_out);
+		src[p]->fill_random(type_in, depth_in);
+		src_buf[p] = src[p]->buffer();
+		dst_buf[p] = dst[p]->buffer();
+	}
+
+	for (unsigned i = 0; i < h; ++i) {
+		filter->process(src_buf, dst_buf, i, 0, w, nullptr, nullptr);
+	}
+
+	zimg::AlignedVector<float> tmp(w * 3);
+	graphengine::BufferDescriptor tmp_buf[3];
+	for (unsigned p = 0; p < 3; ++p) {
+		tmp_buf[p] = { tmp.data() + p * w, 0, graphengine::BUFFER_MAX };
+	}
+
+	for (unsigned i = 0; i < h; ++i) {
+		for (unsigned p = 0; p < 3; ++p) {
+			auto [scale, offset] = zimg::depth::get_scale_offset(format_in[p], zimg::PixelType::FLOAT);
+
+			for (unsigned j = 0; j < w; ++j) {
+				tmp[p * w + j] = static_cast<float>(read_sample(*src[p], i, j, type_in)) * scale + offset;
+			}
+		}
+
+		reference->process(tmp_buf, tmp_buf, 0, 0, w, nullptr, nullptr);
+
+		for (unsigned p = 0; p < 3; ++p) {
+			auto [scale, offset] = zimg::depth::get_scale_offset(zimg::PixelType::FLOAT, format_out[p]);
+			float max = static_cast<float>(zimg::depth::numeric_max(depth_out));
+
+			for (unsigned j = 0; j < w; ++j) {
+				float expected = std::clamp(std::nearbyint(tmp[p * w + j] * scale + offset), 0.0f, max);
+				unsigned actual = read_sample(*dst[p], i, j, type_out);
+				ASSERT_LE(std::fabs(expected - static_cast<float>(actual)), 1.0f) << "plane " << p << " at (" << i << ", " << j << ")";
+			}
+		}
+	}
+}
+
+} // namespace
+
+
+TEST(MatrixIntTest, test_yuv_to_rgb)
+{
+	const ColorspaceDefinition yuv{ MatrixCoefficients::REC_709, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 };
+	const ColorspaceDefinition rgb = yuv.to_rgb();
+
+	test_case(yuv, rgb, zimg::PixelType::BYTE, 8, false, zimg::PixelType::BYTE, 8, true);
+	test_case(yuv, rgb, zimg::PixelType::WORD, 10, false, zimg::PixelType::WORD, 10, false);
+	test_case(yuv, rgb, zimg::PixelType::BYTE, 8, false, zimg::PixelType::WORD, 10, true);
+	test_case(yuv, rgb, zimg::PixelType::WORD, 12, true, zimg::PixelType::BYTE, 8, true);
+}
+
+TEST(MatrixIntTest, test_rgb_to_yuv)
+{
+	const ColorspaceDefinition yuv{ MatrixCoefficients::REC_2020_NCL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 };
+	const ColorspaceDefinition rgb = yuv.to_rgb();
+
+	test_case(rgb, yuv, zimg::PixelType::BYTE, 8, true, zimg::PixelType::BYTE, 8, false);
+	test_case(rgb, yuv, zimg::PixelType::WORD, 10, true, zimg::PixelType::WORD, 12, false);
+}
+
+TEST(MatrixIntTest, test_yuv_to_yuv)
+{
+	const ColorspaceDefinition yuv_601{ MatrixCoefficients::REC_601, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 };
+	const ColorspaceDefinition yuv_709 = yuv_601.to(MatrixCoefficients::REC_709);
+	const ColorspaceDefinition ycgco = yuv_601.to(MatrixCoefficients::YCGCO);
+
+	test_case(yuv_601, yuv_709, zimg::PixelType::BYTE, 8, false, zimg::PixelType::BYTE, 8, false);
+	test_case(ycgco, yuv_709, zimg::PixelType::WORD, 10, false, zimg::PixelType::WORD, 10, false);
+}
+
+TEST(MatrixIntTest, test_unsupported)
+{
+	const ColorspaceDefinition yuv{ MatrixCoefficients::REC_709, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 };
+	zimg::PixelFormat format_8[3];
+	zimg::PixelFormat format_16[3];
+	zimg::PixelFormat format_f[3];
+	make_formats(format_8, zimg::PixelType::BYTE, 8, false, MatrixCoefficients::REC_709);
+	make_formats(format_16, zimg::PixelType::WORD, 16, false, MatrixCoefficients::REC_709);
+	make_formats(format_f, zimg::PixelType::FLOAT, 32, false, MatrixCoefficients::REC_709);
+
+	// Non-linear path.
+	EXPECT_FALSE(zimg::colorspace::create_matrix_int_filter(yuv, yuv.to_rgb().to_linear(), format_8, format_8, 64, 64, zimg::CPUClass::NONE));
+	EXPECT_FALSE(zimg::colorspace::create_matrix_int_filter(yuv, yuv.to(MatrixCoefficients::REC_2020_CL), format_8, format_8, 64, 64, zimg::CPUClass::NONE));
+	// Formats outside of the fixed-point range.
+	EXPECT_FALSE(zimg::colorspace::create_matrix_int_filter(yuv, yuv.to_rgb(), format_16, format_8, 64, 64, zimg::CPUClass::NONE));
+	EXPECT_FALSE(zimg::colorspace::create_matrix_int_filter(yuv, yuv.to_rgb(), format_8, format_f, 64, 64, zimg::CPUClass::NONE));
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#ifndef ZIMG_TEST_COLORSPACE_OPERATION_COMPARE_H_
+#define ZIMG_TEST_COLORSPACE_OPERATION_COMPARE_H_
+
+#ifndef GOOGLETEST_INCLUDE_GTEST_GTEST_H_
+  #error gtest not included
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include "colorspace/colorspace.h"
+#include "colorspace/colorspace_param.h"
+#include "colorspace/operation.h"
+#include "common/alloc.h"
+#include "common/cpuinfo.h"
+#include "graphengine/filter.h"
+#include "graphengine/types.h"
+
+// Checks that a vectorized operation matches the C operation within a relative tolerance.
+inline void test_case_operation(std::unique_ptr<zimg::colorspace::Operation> op_c, std::unique_ptr<zimg::colorspace::Operation> op_simd, float tolerance)
+{
+	const unsigned w = 640;
+
+	ASSERT_TRUE(op_c);
+	ASSERT_TRUE(op_simd);
+
+	std::mt19937 engine;
+	std::uniform_real_distribution<float> dist{ -0.25f, 1.25f };
+	zimg::AlignedVector<float> src[3];
+	zimg::AlignedVector<float> dst_c[3];
+	zimg::AlignedVector<float> dst_simd[3];
+
+	for (unsigned p = 0; p < 3; ++p) {
+		src[p].resize(w);
+		dst_c[p].resize(w);
+		dst_simd[p].resize(w);
+
+		for (float &x : src[p]) {
+			x = dist(engine);
+		}
+		// Range endpoints.
+		src[p][3 + p] = 0.0f;
+		src[p][6 + p] = 1.0f;
+	}
+
+	const float * const src_p[3] = { src[0].data(), src[1].data(), src[2].data() };
+	float * const dst_c_p[3] = { dst_c[0].data(), dst_c[1].data(), dst_c[2].data() };
+	float * const dst_simd_p[3] = { dst_simd[0].data(), dst_simd[1].data(), dst_simd[2].data() };
+
+	// Unaligned span to exercise partial vectors.
+	op_c->process(src_p, dst_c_p, 3, w - 5);
+	op_simd->process(src_p, dst_simd_p, 3, w - 5);
+
+	for (unsigned p = 0; p < 3; ++p) {
+		for (unsigned j = 3; j < w - 5; ++j) {
+			float expected = dst_c[p][j];
+			ASSERT_NEAR(expected, dst_simd[p][j], tolerance * std::max(std::fabs(expected), 1.0f / 1024)) << "plane " << p << " at " << j;
+		}
+	}
+}
+
+// Checks that a 3D LUT conversion for |cpu| matches the C conversion, including NaN inputs.
+inline void test_case_lut(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg::colorspace::ColorspaceDefinition &csp_out, zimg::CPUClass cpu)
+{
+	const unsigned w = 640;
+
+	auto builder = zimg::colorspace::ColorspaceConversion{ w, 1 }
+		.set_csp_in(csp_in)
+		.set_csp_out(csp_out)
+		.set_use_lut(true);
+
+	auto filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
+	auto filter_simd = builder.set_cpu(cpu).create();
+
+	ASSERT_TRUE(filter_c);
+	ASSERT_TRUE(filter_simd);
+
+	std::mt19937 engine;
+	std::uniform_real_distribution<float> dist{ -0.25f, 1.25f };
+	zimg::AlignedVector<float> src[3];
+	zimg::AlignedVector<float> dst_c[3];
+	zimg::AlignedVector<float> dst_simd[3];
+	graphengine::BufferDescriptor src_buf[3];
+	graphengine::BufferDescriptor dst_c_buf[3];
+	graphengine::BufferDescriptor dst_simd_buf[3];
+
+	for (unsigned p = 0; p < 3; ++p) {
+		src[p].resize(w);
+		dst_c[p].resize(w);
+		dst_simd[p].resize(w);
+
+		for (float &x : src[p]) {
+			x = dist(engine);
+		}
+		src[p][p] = std::numeric_limits<float>::quiet_NaN();
+
+		src_buf[p] = { src[p].data(), 0, graphengine::BUFFER_MAX };
+		dst_c_buf[p] = { dst_c[p].data(), 0, graphengine::BUFFER_MAX };
+		dst_simd_buf[p] = { dst_simd[p].data(), 0, graphengine::BUFFER_MAX };
+	}
+
+	// Unaligned span to exercise partial vectors.
+	filter_c->process(src_buf, dst_c_buf, 0, 3, w - 5, nullptr, nullptr);
+	filter_simd->process(src_buf, dst_simd_buf, 0, 3, w - 5, nullptr, nullptr);
+
+	for (unsigned p = 0; p < 3; ++p) {
+		for (unsigned j = 3; j < w - 5; ++j) {
+			ASSERT_NEAR(dst_c[p][j], dst_simd[p][j], 1e-5f) << "plane " << p << " at " << j;
+		}
+	}
+}
+
+#endif // ZIMG_TEST_COLORSPACE_OPERATION_COMPARE_H_
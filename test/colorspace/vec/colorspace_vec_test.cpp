@@ -0,0 +1,60 @@
+#ifdef ZIMG_VEC
+
+#include <cmath>
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "colorspace/colorspace.h"
+#include "graphengine/filter.h"
+
+#include "gtest/gtest.h"
+#include "graphengine/filter_validation.h"
+
+// Whether multiply-adds are fused depends on the compiler and target, so the
+// output is only compared against the C implementation.
+
+namespace {
+
+void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg::colorspace::ColorspaceDefinition &csp_out, double expected_snr)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+
+	auto builder = zimg::colorspace::ColorspaceConversion{ w, h }
+		.set_csp_in(csp_in)
+		.set_csp_out(csp_out);
+
+	auto filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
+	auto filter_vec = builder.set_cpu(zimg::CPUClass::GENERIC_VEC).create();
+
+	ASSERT_TRUE(filter_c);
+	ASSERT_TRUE(filter_vec);
+
+	graphengine::FilterValidation(filter_vec.get(), { w, h, zimg::pixel_size(zimg::PixelType::FLOAT) })
+		.set_reference_filter(filter_c.get(), expected_snr)
+		.set_input_pixel_format(0, { zimg::pixel_depth(zimg::PixelType::FLOAT), true, false })
+		.set_input_pixel_format(1, { zimg::pixel_depth(zimg::PixelType::FLOAT), true, csp_in.matrix != zimg::colorspace::MatrixCoefficients::RGB })
+		.set_input_pixel_format(2, { zimg::pixel_depth(zimg::PixelType::FLOAT), true, csp_in.matrix != zimg::colorspace::MatrixCoefficients::RGB })
+		.set_output_pixel_format(0, { zimg::pixel_depth(zimg::PixelType::FLOAT), true, false })
+		.set_output_pixel_format(1, { zimg::pixel_depth(zimg::PixelType::FLOAT), true, csp_out.matrix != zimg::colorspace::MatrixCoefficients::RGB })
+		.set_output_pixel_format(2, { zimg::pixel_depth(zimg::PixelType::FLOAT), true, csp_out.matrix != zimg::colorspace::MatrixCoefficients::RGB })
+		.run();
+}
+
+} // namespace
+
+
+TEST(ColorspaceConversionVecTest, test_matrix)
+{
+	using namespace zimg::colorspace;
+
+	const double expected_snr = 120.0;
+
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::UNSPECIFIED, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::REC_709, TransferCharacteristics::UNSPECIFIED, ColorPrimaries::UNSPECIFIED },
+	          expected_snr);
+	test_case({ MatrixCoefficients::REC_2020_NCL, TransferCharacteristics::UNSPECIFIED, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::REC_709, TransferCharacteristics::UNSPECIFIED, ColorPrimaries::UNSPECIFIED },
+	          expected_snr);
+}
+
+#endif // ZIMG_VEC
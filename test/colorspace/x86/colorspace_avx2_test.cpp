@@ -1,14 +1,26 @@
 #ifdef ZIMG_X86
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
 #include "colorspace/colorspace.h"
+#include "colorspace/colorspace_param.h"
+#include "colorspace/gamma.h"
+#include "colorspace/operation.h"
+#include "colorspace/operation_impl.h"
+#include "colorspace/x86/operation_impl_x86.h"
+#include "common/alloc.h"
 #include "common/cpuinfo.h"
 #include "common/pixel.h"
 #include "common/x86/cpuinfo_x86.h"
 #include "graphengine/filter.h"
+#include "graphengine/types.h"
 
 #include "gtest/gtest.h"
 #include "graphengine/filter_validation.h"
+#include "colorspace/operation_compare.h"
 
 namespace {
 
@@ -48,6 +60,92 @@ void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg:
 		.run();
 }
 
+void test_case_polynomial(zimg::colorspace::TransferCharacteristics transfer, float tolerance)
+{
+	const unsigned w = 640;
+
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	auto func = zimg::colorspace::select_transfer_function(transfer, 100.0, false);
+	auto params = zimg::colorspace::OperationParams{}.set_peak_luminance(100.0).set_approximate_gamma(true);
+
+	std::unique_ptr<zimg::colorspace::Operation> op_c[2] = {
+		zimg::colorspace::create_inverse_gamma_operation(func, params, zimg::CPUClass::NONE),
+		zimg::colorspace::create_gamma_operation(func, params, zimg::CPUClass::NONE),
+	};
+	std::unique_ptr<zimg::colorspace::Operation> op_avx2[2] = {
+		zimg::colorspace::create_inverse_gamma_polynomial_operation_avx2(func, params),
+		zimg::colorspace::create_gamma_polynomial_operation_avx2(func, params),
+	};
+	std::unique_ptr<zimg::colorspace::Operation> op_avx512[2];
+
+	if (zimg::query_x86_capabilities().avx512f) {
+		op_avx512[0] = zimg::colorspace::create_inverse_gamma_operation_avx512(func, params);
+		op_avx512[1] = zimg::colorspace::create_gamma_operation_avx512(func, params);
+	}
+
+	std::mt19937 engine;
+	std::uniform_real_distribution<float> dist{ 0.0f, 1.0f };
+	zimg::AlignedVector<float> src[3];
+	zimg::AlignedVector<float> dst_c[3];
+	zimg::AlignedVector<float> dst_avx2[3];
+	zimg::AlignedVector<float> dst_avx512[3];
+
+	for (unsigned p = 0; p < 3; ++p) {
+		src[p].resize(w);
+		dst_c[p].resize(w);
+		dst_avx2[p].resize(w);
+		dst_avx512[p].resize(w);
+	}
+
+	for (unsigned n = 0; n < 2; ++n) {
+		SCOPED_TRACE(n ? "togamma" : "tolinear");
+		ASSERT_TRUE(op_c[n]);
+		ASSERT_TRUE(op_avx2[n]);
+
+		for (unsigned p = 0; p < 3; ++p) {
+			for (float &x : src[p]) {
+				x = dist(engine);
+			}
+		}
+		// Range endpoints and negative values.
+		src[0][3] = 0.0f;
+		src[0][4] = 1.0f;
+		src[0][5] = -0.25f;
+
+		const float * const src_p[3] = { src[0].data(), src[1].data(), src[2].data() };
+		float * const dst_c_p[3] = { dst_c[0].data(), dst_c[1].data(), dst_c[2].data() };
+		float * const dst_avx2_p[3] = { dst_avx2[0].data(), dst_avx2[1].data(), dst_avx2[2].data() };
+		float * const dst_avx512_p[3] = { dst_avx512[0].data(), dst_avx512[1].data(), dst_avx512[2].data() };
+
+		// Unaligned span to exercise partial vectors.
+		op_c[n]->process(src_p, dst_c_p, 3, w - 5);
+		op_avx2[n]->process(src_p, dst_avx2_p, 3, w - 5);
+
+		for (unsigned p = 0; p < 3; ++p) {
+			for (unsigned j = 3; j < w - 5; ++j) {
+				float expected = dst_c[p][j];
+				ASSERT_NEAR(expected, dst_avx2[p][j], tolerance * std::max(std::fabs(expected), 1.0f / 1024)) << "plane " << p << " at " << j;
+			}
+		}
+
+		// The AVX2 polynomials are ports of the AVX-512 ones and must match them exactly.
+		if (!op_avx512[n])
+			continue;
+
+		op_avx512[n]->process(src_p, dst_avx512_p, 3, w - 5);
+
+		for (unsigned p = 0; p < 3; ++p) {
+			for (unsigned j = 3; j < w - 5; ++j) {
+				ASSERT_EQ(dst_avx512[p][j], dst_avx2[p][j]) << "plane " << p << " at " << j;
+			}
+		}
+	}
+}
+
 } // namespace
 
 
@@ -114,4 +212,75 @@ TEST(ColorspaceConversionAVX2Test, test_transfer_lut)
 	          expected_sha1[3], expected_togamma_snr);
 }
 
+TEST(ColorspaceConversionAVX2Test, test_lut)
+{
+	using namespace zimg::colorspace;
+
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	SCOPED_TRACE("st2084->709");
+	test_case_lut({ MatrixCoefficients::REC_2020_NCL, TransferCharacteristics::ST_2084, ColorPrimaries::REC_2020 },
+	              { MatrixCoefficients::REC_709, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 }, zimg::CPUClass::X86_AVX2);
+	SCOPED_TRACE("709 rgb->st2084 rgb");
+	test_case_lut({ MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 },
+	              { MatrixCoefficients::RGB, TransferCharacteristics::ST_2084, ColorPrimaries::REC_2020 }, zimg::CPUClass::X86_AVX2);
+}
+
+TEST(ColorspaceConversionAVX2Test, test_transfer_polynomial)
+{
+	using namespace zimg::colorspace;
+
+	SCOPED_TRACE("rec_1886");
+	test_case_polynomial(TransferCharacteristics::REC_709, 1e-5f);
+	SCOPED_TRACE("srgb");
+	test_case_polynomial(TransferCharacteristics::SRGB, 1e-5f);
+	SCOPED_TRACE("st_2084");
+	test_case_polynomial(TransferCharacteristics::ST_2084, 1e-3f); // Same accuracy as AVX-512.
+}
+
+TEST(ColorspaceConversionAVX2Test, test_arib_b67)
+{
+	using namespace zimg::colorspace;
+
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	Matrix3x3 m = ncl_rgb_to_yuv_matrix_from_primaries(ColorPrimaries::REC_2020);
+	auto func = select_transfer_function(TransferCharacteristics::ARIB_B67, 1000.0, false);
+	auto params = OperationParams{}.set_peak_luminance(1000.0).set_approximate_gamma(true);
+
+	SCOPED_TRACE("tolinear");
+	test_case_operation(create_inverse_arib_b67_operation(m, params, zimg::CPUClass::NONE), create_inverse_arib_b67_operation_avx2(m, func, params), 1e-5f);
+	SCOPED_TRACE("togamma");
+	test_case_operation(create_arib_b67_operation(m, params, zimg::CPUClass::NONE), create_arib_b67_operation_avx2(m, func, params), 1e-5f);
+}
+
+TEST(ColorspaceConversionAVX2Test, test_constant_luminance)
+{
+	using namespace zimg::colorspace;
+
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	ColorspaceDefinition csp_2020cl{ MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 };
+	ColorspaceDefinition csp_2020_rgb{ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 };
+
+	Matrix3x3 m = ncl_rgb_to_yuv_matrix(MatrixCoefficients::REC_2020_CL);
+	auto func = select_transfer_function(TransferCharacteristics::REC_709, 100.0, true);
+	auto params = OperationParams{}.set_peak_luminance(100.0).set_approximate_gamma(true);
+
+	// Differences of gamma-encoded values amplify the error near zero.
+	SCOPED_TRACE("tolinear");
+	test_case_operation(create_cl_yuv_to_rgb_operation(csp_2020cl, csp_2020_rgb, params, zimg::CPUClass::NONE), create_cl_yuv_to_rgb_operation_avx2(m, func, params), 1e-4f);
+	SCOPED_TRACE("togamma");
+	test_case_operation(create_cl_rgb_to_yuv_operation(csp_2020_rgb, csp_2020cl, params, zimg::CPUClass::NONE), create_cl_rgb_to_yuv_operation_avx2(m, func, params), 1e-4f);
+}
+
 #endif // ZIMG_X86
@@ -1,14 +1,26 @@
 #ifdef ZIMG_X86
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
 #include "colorspace/colorspace.h"
+#include "colorspace/colorspace_param.h"
+#include "colorspace/gamma.h"
+#include "colorspace/operation.h"
+#include "colorspace/operation_impl.h"
+#include "colorspace/x86/operation_impl_x86.h"
+#include "common/alloc.h"
 #include "common/cpuinfo.h"
 #include "common/pixel.h"
 #include "common/x86/cpuinfo_x86.h"
 #include "graphengine/filter.h"
+#include "graphengine/types.h"
 
 #include "gtest/gtest.h"
 #include "graphengine/filter_validation.h"
+#include "colorspace/operation_compare.h"
 
 namespace {
 
@@ -154,4 +166,63 @@ TEST(ColorspaceConversionAVX512Test, test_transfer_st_2084)
 	          expected_sha1[1], expected_togamma_snr);
 }
 
+TEST(ColorspaceConversionAVX512Test, test_lut)
+{
+	using namespace zimg::colorspace;
+
+	if (!zimg::query_x86_capabilities().avx512f) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	SCOPED_TRACE("st2084->709");
+	test_case_lut({ MatrixCoefficients::REC_2020_NCL, TransferCharacteristics::ST_2084, ColorPrimaries::REC_2020 },
+	              { MatrixCoefficients::REC_709, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 }, zimg::CPUClass::X86_AVX512);
+	SCOPED_TRACE("709 rgb->st2084 rgb");
+	test_case_lut({ MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 },
+	              { MatrixCoefficients::RGB, TransferCharacteristics::ST_2084, ColorPrimaries::REC_2020 }, zimg::CPUClass::X86_AVX512);
+}
+
+TEST(ColorspaceConversionAVX512Test, test_arib_b67)
+{
+	using namespace zimg::colorspace;
+
+	if (!zimg::query_x86_capabilities().avx512f) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	Matrix3x3 m = ncl_rgb_to_yuv_matrix_from_primaries(ColorPrimaries::REC_2020);
+	auto func = select_transfer_function(TransferCharacteristics::ARIB_B67, 1000.0, false);
+	auto params = OperationParams{}.set_peak_luminance(1000.0).set_approximate_gamma(true);
+
+	SCOPED_TRACE("tolinear");
+	test_case_operation(create_inverse_arib_b67_operation(m, params, zimg::CPUClass::NONE), create_inverse_arib_b67_operation_avx512(m, func, params), 1e-5f);
+	SCOPED_TRACE("togamma");
+	test_case_operation(create_arib_b67_operation(m, params, zimg::CPUClass::NONE), create_arib_b67_operation_avx512(m, func, params), 1e-5f);
+}
+
+TEST(ColorspaceConversionAVX512Test, test_constant_luminance)
+{
+	using namespace zimg::colorspace;
+
+	if (!zimg::query_x86_capabilities().avx512f) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	ColorspaceDefinition csp_2020cl{ MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 };
+	ColorspaceDefinition csp_2020_rgb{ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 };
+
+	Matrix3x3 m = ncl_rgb_to_yuv_matrix(MatrixCoefficients::REC_2020_CL);
+	auto func = select_transfer_function(TransferCharacteristics::REC_709, 100.0, true);
+	auto params = OperationParams{}.set_peak_luminance(100.0).set_approximate_gamma(true);
+
+	// Differences of gamma-encoded values amplify the error near zero.
+	SCOPED_TRACE("tolinear");
+	test_case_operation(create_cl_yuv_to_rgb_operation(csp_2020cl, csp_2020_rgb, params, zimg::CPUClass::NONE), create_cl_yuv_to_rgb_operation_avx512(m, func, params), 1e-4f);
+	SCOPED_TRACE("togamma");
+	test_case_operation(create_cl_rgb_to_yuv_operation(csp_2020_rgb, csp_2020cl, params, zimg::CPUClass::NONE), create_cl_rgb_to_yuv_operation_avx512(m, func, params), 1e-4f);
+}
+
 #endif // ZIMG_X86
@@ -103,4 +103,14 @@ TEST(GammaConstantsAVX512Test, test_st_2084)
 	test_linear_to_gamma(st_2084_inverse_eotf, avx512constants::st_2084_inverse_eotf, -31, 0, 1e-5f, 1e-7f);
 }
 
+TEST(GammaConstantsAVX512Test, test_log2_exp2)
+{
+	using namespace zimg::colorspace;
+
+	SCOPED_TRACE("exp2");
+	test_gamma_to_linear(exp2f, avx512constants::exp2_approx, -4.0f, 4.0f, 1e-6f, 1e-6f);
+	SCOPED_TRACE("log2");
+	test_linear_to_gamma(log2f, avx512constants::log2_approx, -30, 30, 1e-6f, 1e-7f);
+}
+
 #endif // ZIMG_X86
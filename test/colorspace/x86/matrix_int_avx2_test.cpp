@@ -0,0 +1,109 @@
+#ifdef ZIMG_X86
+
+#include <cstring>
+#include <memory>
+#include "colorspace/colorspace.h"
+#include "colorspace/matrix_int.h"
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "graphengine/filter.h"
+
+#include "gtest/gtest.h"
+#include "filter_compare.h"
+
+namespace {
+
+using zimg::colorspace::ColorspaceDefinition;
+using zimg::colorspace::MatrixCoefficients;
+using zimg::colorspace::TransferCharacteristics;
+using zimg::colorspace::ColorPrimaries;
+
+void test_case(zimg::PixelType type_in, unsigned depth_in, zimg::PixelType type_out, unsigned depth_out, unsigned left, unsigned right)
+{
+	const unsigned w = 640;
+	const unsigned h = 8;
+
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	SCOPED_TRACE(depth_in);
+	SCOPED_TRACE(depth_out);
+
+	const ColorspaceDefinition csp_in{ MatrixCoefficients::REC_709, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 };
+	const ColorspaceDefinition csp_out = csp_in.to_rgb();
+
+	zimg::PixelFormat format_in[3];
+	zimg::PixelFormat format_out[3];
+	for (unsigned p = 0; p < 3; ++p) {
+		format_in[p] = { type_in, depth_in, false, p != 0 };
+		format_out[p] = { type_out, depth_out, true, false };
+	}
+
+	auto filter_c = zimg::colorspace::create_matrix_int_filter(csp_in, csp_out, format_in, format_out, w, h, zimg::CPUClass::NONE);
+	auto filter_avx2 = zimg::colorspace::create_matrix_int_filter(csp_in, csp_out, format_in, format_out, w, h, zimg::CPUClass::X86_AVX2);
+	ASSERT_TRUE(filter_c);
+	ASSERT_TRUE(filter_avx2);
+	ASSERT_NE(zimg::colorspace::select_matrix_int_func(type_in, type_out, zimg::CPUClass::NONE),
+	          zimg::colorspace::select_matrix_int_func(type_in, type_out, zimg::CPUClass::X86_AVX2));
+
+	std::unique_ptr<TestPlane> src[3];
+	std::unique_ptr<TestPlane> dst_c[3];
+	std::unique_ptr<TestPlane> dst_avx2[3];
+	graphengine::BufferDescriptor src_buf[3];
+	graphengine::BufferDescriptor dst_c_buf[3];
+	graphengine::BufferDescriptor dst_avx2_buf[3];
+
+	for (unsigned p = 0; p < 3; ++p) {
+		src[p] = std::make_unique<TestPlane>(w, h, type_in);
+		dst_c[p] = std::make_unique<TestPlane>(w, h, type_out);
+		dst_avx2[p] = std::make_unique<TestPlane>(w, h, type_out);
+		src[p]->fill_random(type_in, depth_in);
+		src_buf[p] = src[p]->buffer();
+		dst_c_buf[p] = dst_c[p]->buffer();
+		dst_avx2_buf[p] = dst_avx2[p]->buffer();
+	}
+
+	size_t offset = static_cast<size_t>(left) * zimg::pixel_size(type_out);
+	size_t size = static_cast<size_t>(right - left) * zimg::pixel_size(type_out);
+
+	for (unsigned i = 0; i < h; ++i) {
+		filter_c->process(src_buf, dst_c_buf, i, left, right, nullptr, nullptr);
+		filter_avx2->process(src_buf, dst_avx2_buf, i, left, right, nullptr, nullptr);
+
+		for (unsigned p = 0; p < 3; ++p) {
+			ASSERT_EQ(0, std::memcmp(dst_c[p]->row(i) + offset, dst_avx2[p]->row(i) + offset, size)) << "mismatch at plane " << p << " row " << i;
+		}
+	}
+}
+
+} // namespace
+
+
+TEST(MatrixIntAVX2Test, test_matrix_int_b2b)
+{
+	test_case(zimg::PixelType::BYTE, 8, zimg::PixelType::BYTE, 8, 0, 640);
+	test_case(zimg::PixelType::BYTE, 8, zimg::PixelType::BYTE, 8, 7, 301);
+}
+
+TEST(MatrixIntAVX2Test, test_matrix_int_b2w)
+{
+	test_case(zimg::PixelType::BYTE, 8, zimg::PixelType::WORD, 10, 0, 640);
+	test_case(zimg::PixelType::BYTE, 8, zimg::PixelType::WORD, 10, 7, 301);
+}
+
+TEST(MatrixIntAVX2Test, test_matrix_int_w2b)
+{
+	test_case(zimg::PixelType::WORD, 10, zimg::PixelType::BYTE, 8, 0, 640);
+	test_case(zimg::PixelType::WORD, 12, zimg::PixelType::BYTE, 8, 7, 301);
+}
+
+TEST(MatrixIntAVX2Test, test_matrix_int_w2w)
+{
+	test_case(zimg::PixelType::WORD, 10, zimg::PixelType::WORD, 10, 0, 640);
+	test_case(zimg::PixelType::WORD, 12, zimg::PixelType::WORD, 10, 7, 301);
+}
+
+#endif // ZIMG_X86
@@ -1,8 +1,16 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "common/alloc.h"
 #include "common/cpuinfo.h"
 #include "common/pixel.h"
 #include "graphengine/filter.h"
+#include "graphengine/types.h"
 #include "depth/depth.h"
 #include "depth/dither.h"
+#include "depth/quantize.h"
 
 #include "gtest/gtest.h"
 #include "graphengine/filter_validation.h"
@@ -45,6 +53,64 @@ void test_case(zimg::depth::DitherType type, bool fullrange, bool chroma, const
 	}
 }
 
+// Compares against a row-by-row Floyd-Steinberg reference, including sizes
+// that leave partial row groups and narrow images.
+void test_case_error_diffusion_sequential(unsigned w, unsigned h)
+{
+	zimg::PixelFormat fmt_in{ zimg::PixelType::WORD, 10 };
+	zimg::PixelFormat fmt_out{ zimg::PixelType::BYTE, 8 };
+
+	bool planes[] = { true, false, false, false };
+	zimg::depth::DepthConversion::result dither = zimg::depth::create_dither(zimg::depth::DitherType::ERROR_DIFFUSION, w, h, fmt_in, fmt_out, planes, zimg::CPUClass::NONE);
+	ASSERT_TRUE(dither.filter_refs[0]);
+
+	const graphengine::Filter *filter = dither.filter_refs[0];
+	const graphengine::FilterDescriptor &desc = filter->descriptor();
+
+	std::mt19937 engine;
+	std::uniform_int_distribution<unsigned> dist{ 0, 1023 };
+	zimg::AlignedVector<uint16_t> src(static_cast<size_t>(w) * h);
+	zimg::AlignedVector<uint8_t> dst(static_cast<size_t>(w) * h);
+	zimg::AlignedVector<unsigned char> context(desc.context_size);
+
+	for (uint16_t &x : src) {
+		x = static_cast<uint16_t>(dist(engine));
+	}
+
+	graphengine::BufferDescriptor src_buf{ src.data(), static_cast<ptrdiff_t>(w * sizeof(uint16_t)), graphengine::BUFFER_MAX };
+	graphengine::BufferDescriptor dst_buf{ dst.data(), static_cast<ptrdiff_t>(w * sizeof(uint8_t)), graphengine::BUFFER_MAX };
+
+	filter->init_context(context.data());
+	for (unsigned i = 0; i < h; i += desc.step) {
+		filter->process(&src_buf, &dst_buf, i, 0, w, context.data(), nullptr);
+	}
+
+	auto scale_offset = zimg::depth::get_scale_offset(fmt_in, fmt_out);
+	std::vector<float> error_top(w + 2);
+	std::vector<float> error_cur(w + 2);
+
+	for (unsigned i = 0; i < h; ++i) {
+		for (unsigned j = 0; j < w; ++j) {
+			float x = static_cast<float>(src[static_cast<size_t>(i) * w + j]) * scale_offset.first + scale_offset.second;
+			float err = 0;
+
+			err += error_cur[j] * (7.0f / 16.0f);
+			err += error_top[j + 2] * (3.0f / 16.0f);
+			err += error_top[j + 1] * (5.0f / 16.0f);
+			err += error_top[j + 0] * (1.0f / 16.0f);
+
+			x += err;
+			x = std::clamp(x, 0.0f, 255.0f);
+
+			uint8_t q = static_cast<uint8_t>(std::lrint(x));
+			error_cur[j + 1] = x - static_cast<float>(q);
+
+			ASSERT_EQ(q, dst[static_cast<size_t>(i) * w + j]) << "at (" << i << ", " << j << ")";
+		}
+		std::swap(error_top, error_cur);
+	}
+}
+
 } // namespace
 
 
@@ -181,3 +247,14 @@ TEST(DitherTest, test_error_diffusion)
 	test_case(zimg::depth::DitherType::ERROR_DIFFUSION, false, false, expected_sha1);
 }
 
+TEST(DitherTest, test_error_diffusion_sequential)
+{
+	SCOPED_TRACE("640x480");
+	test_case_error_diffusion_sequential(640, 480);
+	SCOPED_TRACE("37x23");
+	test_case_error_diffusion_sequential(37, 23);
+	SCOPED_TRACE("14x9");
+	test_case_error_diffusion_sequential(14, 9);
+	SCOPED_TRACE("13x5");
+	test_case_error_diffusion_sequential(13, 5);
+}
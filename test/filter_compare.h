@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef ZIMG_TEST_FILTER_COMPARE_H_
+#define ZIMG_TEST_FILTER_COMPARE_H_
+
+#ifndef GOOGLETEST_INCLUDE_GTEST_GTEST_H_
+  #error gtest not included
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include "common/align.h"
+#include "common/alloc.h"
+#include "common/pixel.h"
+#include "graphengine/filter.h"
+#include "graphengine/types.h"
+
+// Single plane image with aligned rows.
+class TestPlane {
+	zimg::AlignedVector<unsigned char> m_data;
+	graphengine::BufferDescriptor m_buffer;
+	unsigned m_width;
+	unsigned m_height;
+	unsigned m_bytes_per_sample;
+public:
+	TestPlane(unsigned width, unsigned height, zimg::PixelType type) :
+		m_buffer{},
+		m_width{ width },
+		m_height{ height },
+		m_bytes_per_sample{ zimg::pixel_size(type) }
+	{
+		size_t stride = zimg::ceil_n(static_cast<size_t>(width) * m_bytes_per_sample, zimg::ALIGNMENT);
+		m_data.resize(stride * height);
+		m_buffer = { m_data.data(), static_cast<ptrdiff_t>(stride), graphengine::BUFFER_MAX };
+	}
+
+	const graphengine::BufferDescriptor &buffer() const { return m_buffer; }
+
+	const unsigned char *row(unsigned i) const { return m_buffer.get_line<unsigned char>(i); }
+
+	size_t row_size() const { return static_cast<size_t>(m_width) * m_bytes_per_sample; }
+
+	unsigned height() const { return m_height; }
+
+	void fill_random(zimg::PixelType type, unsigned depth)
+	{
+		std::mt19937 engine;
+		std::uniform_int_distribution<unsigned> dist{ 0, type == zimg::PixelType::FLOAT ? 0xFFFFU : (1U << depth) - 1 };
+
+		for (unsigned i = 0; i < m_height; ++i) {
+			unsigned char *ptr = m_buffer.get_line<unsigned char>(i);
+
+			for (unsigned j = 0; j < m_width; ++j) {
+				unsigned x = dist(engine);
+
+				if (type == zimg::PixelType::BYTE) {
+					ptr[j] = static_cast<uint8_t>(x);
+				} else if (type == zimg::PixelType::WORD) {
+					uint16_t w = static_cast<uint16_t>(x);
+					std::memcpy(ptr + j * sizeof(w), &w, sizeof(w));
+				} else {
+					float f = x / 65535.0f;
+					std::memcpy(ptr + j * sizeof(f), &f, sizeof(f));
+				}
+			}
+		}
+	}
+};
+
+// Processes an entire plane with a single-plane filter.
+inline void run_filter(const graphengine::Filter &filter, const TestPlane &src, const TestPlane &dst)
+{
+	const graphengine::FilterDescriptor &desc = filter.descriptor();
+	zimg::AlignedVector<unsigned char> context(desc.context_size);
+	zimg::AlignedVector<unsigned char> tmp(desc.scratchpad_size);
+
+	filter.init_context(context.data());
+
+	for (unsigned i = 0; i < desc.format.height; i += desc.step) {
+		filter.process(&src.buffer(), &dst.buffer(), i, 0, desc.format.width, context.data(), tmp.data());
+	}
+}
+
+// Checks that two filters produce bit-identical results on the same input.
+inline void assert_identical_filters(const graphengine::Filter *a, const graphengine::Filter *b, unsigned src_w, unsigned src_h, zimg::PixelType type, unsigned depth)
+{
+	const graphengine::PlaneDescriptor &format = a->descriptor().format;
+
+	TestPlane src{ src_w, src_h, type };
+	TestPlane dst_a{ format.width, format.height, type };
+	TestPlane dst_b{ format.width, format.height, type };
+
+	src.fill_random(type, depth);
+	run_filter(*a, src, dst_a);
+	run_filter(*b, src, dst_b);
+
+	for (unsigned i = 0; i < dst_a.height(); ++i) {
+		ASSERT_EQ(0, std::memcmp(dst_a.row(i), dst_b.row(i), dst_a.row_size())) << "mismatch at row " << i;
+	}
+}
+
+#endif // ZIMG_TEST_FILTER_COMPARE_H_
@@ -0,0 +1,18 @@
+#ifdef ZIMG_ARM
+
+#include "common/cpuinfo.h"
+
+#include "gtest/gtest.h"
+#include "graph/premultiply_compare.h"
+
+TEST(PremultiplyNEONTest, test_premultiply)
+{
+	test_case_premultiply(false, zimg::CPUClass::ARM_NEON);
+}
+
+TEST(PremultiplyNEONTest, test_unpremultiply)
+{
+	test_case_premultiply(true, zimg::CPUClass::ARM_NEON);
+}
+
+#endif // ZIMG_ARM
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "common/alloc.h"
+#include "common/except.h"
+#include "common/pixel.h"
+#include "depth/depth.h"
+#include "graph/filtergraph.h"
+#include "graph/graphbuilder.h"
+#include "graphengine/graph.h"
+#include "graphengine/types.h"
+
+#include "gtest/gtest.h"
+#include "graph_frame.h"
+
+namespace {
+
+using zimg::graph::GraphBuilder;
+
+int thread_pool(void *, void (*task)(void *, unsigned), void *task_user, unsigned num_tasks)
+{
+	std::vector<std::thread> threads;
+
+	for (unsigned i = 0; i < num_tasks; ++i) {
+		threads.emplace_back(task, task_user, i);
+	}
+	for (std::thread &th : threads) {
+		th.join();
+	}
+	return 0;
+}
+
+void test_case(const GraphBuilder::state &source, const GraphBuilder::state &target, zimg::depth::DitherType dither = zimg::depth::DitherType::NONE)
+{
+	GraphBuilder::params params;
+	params.dither_type = dither;
+
+	GraphBuilder builder;
+	auto graph = builder.set_source(source).connect(target, &params).build_graph();
+
+	TestFrame src_frame{ source };
+	src_frame.fill(source.type, source.depth);
+
+	TestFrame expected{ target };
+	zimg::AlignedVector<unsigned char> tmp(graph->get_tmp_size());
+	graph->process(src_frame.buffers(), expected.buffers(), tmp.data(), nullptr, nullptr, nullptr, nullptr);
+
+	for (unsigned num_bands : { 1U, 2U, 3U, 7U, 16U }) {
+		SCOPED_TRACE(num_bands);
+
+		TestFrame sequential{ target };
+		zimg::AlignedVector<unsigned char> tmp_mt(graph->get_tmp_size_mt(num_bands));
+		graph->process_mt(src_frame.buffers(), sequential.buffers(), tmp_mt.data(), num_bands, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+		EXPECT_TRUE(sequential == expected);
+
+		TestFrame threaded{ target };
+		graph->process_mt(src_frame.buffers(), threaded.buffers(), tmp_mt.data(), num_bands, nullptr, nullptr, nullptr, nullptr, thread_pool, nullptr);
+		EXPECT_TRUE(threaded == expected);
+	}
+}
+
+void stream_test_case(const GraphBuilder::state &source, const GraphBuilder::state &target, zimg::depth::DitherType dither = zimg::depth::DitherType::NONE)
+{
+	static const unsigned push_sizes[] = { 1, 2, 7, 16, 3, 64 };
+	static const unsigned pull_sizes[] = { 5, 1, 32, 2, 8 };
+
+	GraphBuilder::params params;
+	params.dither_type = dither;
+
+	GraphBuilder builder;
+	auto graph = builder.set_source(source).connect(target, &params).build_graph();
+
+	TestFrame src_frame{ source };
+	src_frame.fill(source.type, source.depth);
+
+	TestFrame expected{ target };
+	zimg::AlignedVector<unsigned char> tmp(graph->get_tmp_size());
+	graph->process(src_frame.buffers(), expected.buffers(), tmp.data(), nullptr, nullptr, nullptr, nullptr);
+
+	TestFrame streamed{ target };
+	auto stream = graph->begin_stream();
+	unsigned input_row = 0;
+	unsigned output_row = 0;
+	unsigned stalled = 0;
+
+	for (unsigned k = 0; output_row < target.height; ++k) {
+		unsigned num_push = std::min(push_sizes[k % std::size(push_sizes)], source.height - input_row);
+		unsigned num_pull = pull_sizes[k % std::size(pull_sizes)];
+
+		unsigned accepted = stream->push_rows(src_frame.buffers_at(input_row, source.subsample_h), num_push);
+		ASSERT_LE(accepted, num_push);
+		input_row += accepted;
+
+		unsigned returned = stream->pull_rows(streamed.buffers_at(output_row, target.subsample_h), num_pull);
+		ASSERT_LE(returned, num_pull);
+		output_row += returned;
+
+		stalled = accepted || returned ? 0 : stalled + 1;
+		ASSERT_LT(stalled, std::size(push_sizes) * std::size(pull_sizes)) << "stream stalled at input " << input_row << " output " << output_row;
+	}
+
+	EXPECT_TRUE(streamed == expected);
+}
+
+} // namespace
+
+
+TEST(BandExecutorTest, test_noop)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV);
+	test_case(source, source);
+}
+
+TEST(BandExecutorTest, test_resize_420)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV);
+	source.subsample_w = 1;
+	source.subsample_h = 1;
+
+	auto target = source;
+	target.type = zimg::PixelType::WORD;
+	target.depth = 10;
+	target.width = 1280;
+	target.height = 720;
+	target.active_width = 1280;
+	target.active_height = 720;
+
+	test_case(source, target);
+}
+
+TEST(BandExecutorTest, test_yuv420_to_rgb)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::WORD, GraphBuilder::ColorFamily::YUV);
+	source.depth = 10;
+	source.subsample_w = 1;
+	source.subsample_h = 1;
+
+	auto target = make_test_state(480, 360, zimg::PixelType::FLOAT, GraphBuilder::ColorFamily::RGB);
+	test_case(source, target);
+}
+
+TEST(BandExecutorTest, test_rgb_to_yuv420_alpha)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::FLOAT, GraphBuilder::ColorFamily::RGB);
+	source.alpha = GraphBuilder::AlphaType::STRAIGHT;
+
+	auto target = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV);
+	target.subsample_w = 1;
+	target.subsample_h = 1;
+	target.alpha = GraphBuilder::AlphaType::STRAIGHT;
+
+	test_case(source, target, zimg::depth::DitherType::ORDERED);
+}
+
+TEST(BandExecutorTest, test_grey_to_rgb)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::GREY);
+	auto target = make_test_state(320, 240, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::RGB);
+	source.fullrange = true;
+	test_case(source, target);
+}
+
+TEST(BandExecutorTest, test_error_diffusion)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::FLOAT, GraphBuilder::ColorFamily::RGB);
+	auto target = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::RGB);
+	test_case(source, target, zimg::depth::DitherType::ERROR_DIFFUSION);
+}
+
+TEST(BandExecutorTest, test_no_executor)
+{
+	graphengine::PlaneDescriptor desc{ 640, 480, 1 };
+
+	auto graph = std::make_unique<graphengine::GraphImpl>();
+	graphengine::node_id source_id = graph->add_source(1, &desc);
+	graphengine::node_dep_desc dep{ source_id, 0 };
+	graphengine::node_id sink_id = graph->add_sink(1, &dep);
+
+	zimg::graph::FilterGraph filtergraph{ std::move(graph), nullptr, source_id, sink_id };
+	std::array<graphengine::BufferDescriptor, 4> buffers{};
+
+	EXPECT_THROW(filtergraph.get_tmp_size_mt(2), zimg::error::UnsupportedOperation);
+	EXPECT_THROW(filtergraph.process_mt(buffers, buffers, nullptr, 2, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr), zimg::error::UnsupportedOperation);
+	EXPECT_THROW(filtergraph.begin_stream(), zimg::error::UnsupportedOperation);
+}
+
+TEST(BandExecutorTest, test_stream_noop)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV);
+	stream_test_case(source, source);
+}
+
+TEST(BandExecutorTest, test_stream_resize_420)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV);
+	source.subsample_w = 1;
+	source.subsample_h = 1;
+
+	auto target = source;
+	target.type = zimg::PixelType::WORD;
+	target.depth = 10;
+	target.width = 1280;
+	target.height = 720;
+	target.active_width = 1280;
+	target.active_height = 720;
+
+	stream_test_case(source, target);
+}
+
+TEST(BandExecutorTest, test_stream_yuv420_to_rgb)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::WORD, GraphBuilder::ColorFamily::YUV);
+	source.depth = 10;
+	source.subsample_w = 1;
+	source.subsample_h = 1;
+
+	auto target = make_test_state(480, 360, zimg::PixelType::FLOAT, GraphBuilder::ColorFamily::RGB);
+	stream_test_case(source, target);
+}
+
+TEST(BandExecutorTest, test_stream_rgb_to_yuv420_alpha)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::FLOAT, GraphBuilder::ColorFamily::RGB);
+	source.alpha = GraphBuilder::AlphaType::STRAIGHT;
+
+	auto target = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV);
+	target.subsample_w = 1;
+	target.subsample_h = 1;
+	target.alpha = GraphBuilder::AlphaType::STRAIGHT;
+
+	stream_test_case(source, target, zimg::depth::DitherType::ORDERED);
+}
+
+TEST(BandExecutorTest, test_stream_error_diffusion)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::FLOAT, GraphBuilder::ColorFamily::RGB);
+	auto target = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::RGB);
+	stream_test_case(source, target, zimg::depth::DitherType::ERROR_DIFFUSION);
+}
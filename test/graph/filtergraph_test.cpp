@@ -0,0 +1,165 @@
+#include <array>
+#include <vector>
+#include "common/alloc.h"
+#include "common/except.h"
+#include "common/pixel.h"
+#include "depth/depth.h"
+#include "graph/filtergraph.h"
+#include "graph/graphbuilder.h"
+#include "graphengine/types.h"
+#include "resize/filter.h"
+
+#include "gtest/gtest.h"
+#include "graph_frame.h"
+
+namespace {
+
+using zimg::colorspace::MatrixCoefficients;
+using zimg::graph::GraphBuilder;
+
+const zimg::resize::BilinearFilter bilinear;
+
+GraphBuilder::state make_yuv420(unsigned width, unsigned height, zimg::PixelType type, unsigned depth)
+{
+	GraphBuilder::state state = make_test_state(width, height, type, GraphBuilder::ColorFamily::YUV);
+	state.depth = depth;
+	state.subsample_w = 1;
+	state.subsample_h = 1;
+	return state;
+}
+
+void test_case(const GraphBuilder::state &source, const std::vector<GraphBuilder::state> &targets)
+{
+	GraphBuilder::params params;
+	params.dither_type = zimg::depth::DitherType::ORDERED;
+
+	auto graph = GraphBuilder{}.set_source(source).build_multi_graph(targets.data(), static_cast<unsigned>(targets.size()), &params);
+	ASSERT_EQ(targets.size(), graph->get_num_outputs());
+
+	TestFrame src_frame{ source };
+	src_frame.fill(source.type, source.depth);
+
+	std::vector<TestFrame> multi;
+	std::vector<std::array<graphengine::BufferDescriptor, 4>> multi_buffers;
+
+	for (const GraphBuilder::state &target : targets) {
+		multi.emplace_back(target);
+	}
+	for (const TestFrame &frame : multi) {
+		multi_buffers.push_back(frame.buffers());
+	}
+
+	zimg::AlignedVector<unsigned char> tmp(graph->get_tmp_size());
+	graph->process_multi(src_frame.buffers(), multi_buffers.data(), tmp.data(), nullptr, nullptr, nullptr, nullptr);
+
+	for (size_t i = 0; i < targets.size(); ++i) {
+		SCOPED_TRACE(i);
+
+		auto single = GraphBuilder{}.set_source(source).connect(targets[i], &params).build_graph();
+
+		TestFrame expected{ targets[i] };
+		zimg::AlignedVector<unsigned char> tmp_single(single->get_tmp_size());
+		single->process(src_frame.buffers(), expected.buffers(), tmp_single.data(), nullptr, nullptr, nullptr, nullptr);
+
+		EXPECT_TRUE(multi[i] == expected);
+	}
+}
+
+} // namespace
+
+
+TEST(FilterGraphTest, test_multi_output_ladder)
+{
+	auto source = make_yuv420(640, 360, zimg::PixelType::WORD, 10);
+
+	test_case(source, {
+		make_yuv420(640, 360, zimg::PixelType::BYTE, 8),
+		make_yuv420(480, 270, zimg::PixelType::BYTE, 8),
+		make_yuv420(320, 180, zimg::PixelType::BYTE, 8),
+		make_yuv420(160, 90, zimg::PixelType::WORD, 10),
+	});
+}
+
+TEST(FilterGraphTest, test_multi_output_mixed)
+{
+	auto source = make_yuv420(320, 240, zimg::PixelType::BYTE, 8);
+	auto rgb = make_test_state(320, 240, zimg::PixelType::WORD, GraphBuilder::ColorFamily::RGB);
+	auto grey = make_test_state(160, 120, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::GREY);
+	grey.colorspace.matrix = MatrixCoefficients::UNSPECIFIED;
+
+	test_case(source, { rgb, source, grey });
+}
+
+TEST(FilterGraphTest, test_multi_output_single_process)
+{
+	auto source = make_yuv420(64, 48, zimg::PixelType::BYTE, 8);
+	GraphBuilder::state targets[2] = { make_yuv420(32, 24, zimg::PixelType::BYTE, 8), make_yuv420(16, 12, zimg::PixelType::BYTE, 8) };
+
+	auto graph = GraphBuilder{}.set_source(source).build_multi_graph(targets, 2, nullptr);
+
+	TestFrame src_frame{ source };
+	TestFrame dst_frame{ targets[0] };
+	zimg::AlignedVector<unsigned char> tmp(graph->get_tmp_size());
+
+	EXPECT_THROW(graph->process(src_frame.buffers(), dst_frame.buffers(), tmp.data(), nullptr, nullptr, nullptr, nullptr), zimg::error::UnsupportedOperation);
+	EXPECT_THROW(graph->begin_stream(), zimg::error::UnsupportedOperation);
+}
+
+TEST(FilterGraphTest, test_pyramid)
+{
+	auto source = make_yuv420(640, 360, zimg::PixelType::WORD, 10);
+	source.chroma_location_w = GraphBuilder::ChromaLocationW::CENTER;
+
+	auto graph = GraphBuilder{}.set_source(source).build_pyramid(4, nullptr);
+	ASSERT_EQ(4U, graph->get_num_outputs());
+
+	TestFrame src_frame{ source };
+	src_frame.fill(source.type, source.depth);
+
+	// The last level is rounded down from 45 to a multiple of the subsampling factor.
+	std::vector<GraphBuilder::state> levels = {
+		make_yuv420(320, 180, zimg::PixelType::WORD, 10),
+		make_yuv420(160, 90, zimg::PixelType::WORD, 10),
+		make_yuv420(80, 44, zimg::PixelType::WORD, 10),
+		make_yuv420(40, 22, zimg::PixelType::WORD, 10),
+	};
+	std::vector<TestFrame> frames;
+	std::vector<std::array<graphengine::BufferDescriptor, 4>> buffers;
+
+	for (GraphBuilder::state &level : levels) {
+		level.chroma_location_w = GraphBuilder::ChromaLocationW::CENTER;
+		frames.emplace_back(level);
+	}
+	for (const TestFrame &frame : frames) {
+		buffers.push_back(frame.buffers());
+	}
+
+	zimg::AlignedVector<unsigned char> tmp(graph->get_tmp_size());
+	graph->process_multi(src_frame.buffers(), buffers.data(), tmp.data(), nullptr, nullptr, nullptr, nullptr);
+
+	// Each level matches a bilinear resize of the previous level.
+	GraphBuilder::params params;
+	params.filter = &bilinear;
+	params.filter_uv = &bilinear;
+
+	for (size_t i = 0; i < levels.size(); ++i) {
+		SCOPED_TRACE(i);
+
+		const GraphBuilder::state &prev_state = i ? levels[i - 1] : source;
+		const TestFrame &prev_frame = i ? frames[i - 1] : src_frame;
+
+		auto single = GraphBuilder{}.set_source(prev_state).connect(levels[i], &params).build_graph();
+
+		TestFrame expected{ levels[i] };
+		zimg::AlignedVector<unsigned char> tmp_single(single->get_tmp_size());
+		single->process(prev_frame.buffers(), expected.buffers(), tmp_single.data(), nullptr, nullptr, nullptr, nullptr);
+
+		EXPECT_TRUE(frames[i].max_difference(expected) <= 1);
+	}
+}
+
+TEST(FilterGraphTest, test_pyramid_too_many_levels)
+{
+	auto source = make_yuv420(64, 48, zimg::PixelType::BYTE, 8);
+	EXPECT_THROW(GraphBuilder{}.set_source(source).build_pyramid(6, nullptr), zimg::error::InvalidImageSize);
+}
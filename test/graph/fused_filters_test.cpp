@@ -0,0 +1,147 @@
+#include <array>
+#include "common/alloc.h"
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "graph/filtergraph.h"
+#include "graph/graphbuilder.h"
+#include "resize/filter.h"
+
+#include "gtest/gtest.h"
+#include "graph_frame.h"
+
+#if defined(ZIMG_X86)
+  #include "common/x86/cpuinfo_x86.h"
+#endif
+
+namespace {
+
+using zimg::colorspace::MatrixCoefficients;
+using zimg::colorspace::TransferCharacteristics;
+using zimg::colorspace::ColorPrimaries;
+using zimg::graph::GraphBuilder;
+
+// Computes the same taps as the wrapped filter, but is not recognized by the fused path.
+class OpaqueFilter : public zimg::resize::Filter {
+	const zimg::resize::Filter &m_filter;
+public:
+	explicit OpaqueFilter(const zimg::resize::Filter &filter) : m_filter(filter) {}
+
+	unsigned support() const override { return m_filter.support(); }
+
+	double operator()(double x) const override { return m_filter(x); }
+
+	std::array<double, 2> params() const override { return m_filter.params(); }
+};
+
+class TraceObserver : public zimg::graph::FilterObserver {
+	bool m_fused = false;
+public:
+	bool fused() const { return m_fused; }
+
+	void upsample_yuv_to_rgb() override { m_fused = true; }
+};
+
+void run_graph(const GraphBuilder::state &source, const GraphBuilder::state &target, const GraphBuilder::params &params,
+               const TestFrame &src_frame, const TestFrame &dst_frame, bool expect_fused)
+{
+	TraceObserver observer;
+	auto graph = GraphBuilder{}.set_source(source).connect(target, &params, &observer).build_graph();
+	ASSERT_EQ(expect_fused, observer.fused());
+
+	zimg::AlignedVector<unsigned char> tmp(graph->get_tmp_size());
+	graph->process(src_frame.buffers(), dst_frame.buffers(), tmp.data(), nullptr, nullptr, nullptr, nullptr);
+}
+
+void test_case_cpu(const GraphBuilder::state &source, const zimg::resize::Filter &filter_uv, zimg::CPUClass cpu)
+{
+	auto target = make_test_state(source.width, source.height, zimg::PixelType::FLOAT, GraphBuilder::ColorFamily::RGB);
+	target.colorspace.transfer = source.colorspace.transfer;
+	target.colorspace.primaries = source.colorspace.primaries;
+
+	OpaqueFilter opaque_uv{ filter_uv };
+
+	GraphBuilder::params fused_params;
+	fused_params.filter_uv = &filter_uv;
+	fused_params.cpu = cpu;
+
+	GraphBuilder::params planar_params;
+	planar_params.filter_uv = &opaque_uv;
+
+	TestFrame src_frame{ source };
+	src_frame.fill(source.type, source.depth);
+
+	TestFrame fused{ target };
+	TestFrame planar{ target };
+
+	ASSERT_NO_FATAL_FAILURE(run_graph(source, target, fused_params, src_frame, fused, true));
+	ASSERT_NO_FATAL_FAILURE(run_graph(source, target, planar_params, src_frame, planar, false));
+
+	for (unsigned p = 0; p < 3; ++p) {
+		for (unsigned i = 0; i < fused.height(p); ++i) {
+			const float *fused_p = fused.row_f(p, i);
+			const float *planar_p = planar.row_f(p, i);
+
+			for (unsigned j = 0; j < fused.width(p); ++j) {
+				ASSERT_NEAR(planar_p[j], fused_p[j], 1e-5f) << "plane " << p << " at (" << i << ", " << j << ")";
+			}
+		}
+	}
+}
+
+void test_case(const GraphBuilder::state &source, const zimg::resize::Filter &filter_uv)
+{
+	{
+		SCOPED_TRACE("c");
+		test_case_cpu(source, filter_uv, zimg::CPUClass::NONE);
+	}
+#if defined(ZIMG_X86)
+	if (zimg::query_x86_capabilities().avx2 && zimg::query_x86_capabilities().fma) {
+		SCOPED_TRACE("avx2");
+		test_case_cpu(source, filter_uv, zimg::CPUClass::X86_AVX2);
+	}
+#endif
+}
+
+} // namespace
+
+
+TEST(FusedFiltersTest, test_upsample_yuv_to_rgb_420)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::WORD, GraphBuilder::ColorFamily::YUV);
+	source.depth = 10;
+	source.subsample_w = 1;
+	source.subsample_h = 1;
+
+	test_case(source, zimg::resize::BilinearFilter{});
+}
+
+TEST(FusedFiltersTest, test_upsample_yuv_to_rgb_422_bicubic)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV);
+	source.subsample_w = 1;
+	source.fullrange = true;
+
+	test_case(source, zimg::resize::BicubicFilter{});
+}
+
+TEST(FusedFiltersTest, test_upsample_yuv_to_rgb_derived)
+{
+	auto source = make_test_state(590, 332, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV);
+	source.subsample_w = 1;
+	source.subsample_h = 1;
+	source.colorspace = { MatrixCoefficients::CHROMATICITY_DERIVED_NCL, TransferCharacteristics::REC_709, ColorPrimaries::DCI_P3 };
+	source.chroma_location_h = GraphBuilder::ChromaLocationH::TOP;
+
+	test_case(source, zimg::resize::BicubicFilter{});
+}
+
+TEST(FusedFiltersTest, test_upsample_yuv_to_rgb_ycgco)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::WORD, GraphBuilder::ColorFamily::YUV);
+	source.depth = 12;
+	source.subsample_w = 1;
+	source.subsample_h = 1;
+	source.colorspace.matrix = MatrixCoefficients::YCGCO;
+
+	test_case(source, zimg::resize::BilinearFilter{});
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#ifndef ZIMG_TEST_GRAPH_GRAPH_FRAME_H_
+#define ZIMG_TEST_GRAPH_GRAPH_FRAME_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include "common/align.h"
+#include "common/alloc.h"
+#include "common/pixel.h"
+#include "graph/graphbuilder.h"
+#include "graphengine/types.h"
+
+// Image stored in the API buffer planes of its layout.
+class TestFrame {
+	std::array<zimg::AlignedVector<unsigned char>, 4> m_planes;
+	std::array<graphengine::BufferDescriptor, 4> m_buffers;
+	std::array<size_t, 4> m_row_size;
+	std::array<unsigned, 4> m_heights;
+	unsigned m_bytes_per_sample;
+public:
+	explicit TestFrame(const zimg::graph::GraphBuilder::state &state) : m_buffers{}, m_row_size{}, m_heights{}, m_bytes_per_sample{ zimg::pixel_size(state.type) }
+	{
+		typedef zimg::graph::GraphBuilder GraphBuilder;
+
+		unsigned num_components = (state.color == GraphBuilder::ColorFamily::GREY ? 1 : 3) + (state.alpha != GraphBuilder::AlphaType::NONE ? 1 : 0);
+		unsigned chroma_width = state.width >> state.subsample_w;
+		unsigned chroma_height = state.height >> state.subsample_h;
+
+		auto set_plane = [&](unsigned p, size_t samples, unsigned height)
+		{
+			m_row_size[p] = samples * m_bytes_per_sample;
+			m_heights[p] = height;
+		};
+
+		switch (state.layout) {
+		case GraphBuilder::Layout::PLANAR:
+			set_plane(0, state.width, state.height);
+			if (state.color != GraphBuilder::ColorFamily::GREY) {
+				set_plane(1, chroma_width, chroma_height);
+				set_plane(2, chroma_width, chroma_height);
+			}
+			if (state.alpha != GraphBuilder::AlphaType::NONE)
+				set_plane(3, state.width, state.height);
+			break;
+		case GraphBuilder::Layout::SEMIPLANAR:
+			set_plane(0, state.width, state.height);
+			set_plane(1, chroma_width * 2, chroma_height);
+			if (state.alpha != GraphBuilder::AlphaType::NONE)
+				set_plane(3, state.width, state.height);
+			break;
+		case GraphBuilder::Layout::PACKED:
+		case GraphBuilder::Layout::PACKED_BGR:
+			set_plane(0, static_cast<size_t>(state.width) * num_components, state.height);
+			break;
+		case GraphBuilder::Layout::YUYV:
+		case GraphBuilder::Layout::UYVY:
+			set_plane(0, static_cast<size_t>(state.width) * 2, state.height);
+			break;
+		}
+
+		for (unsigned p = 0; p < 4; ++p) {
+			if (!m_row_size[p])
+				continue;
+
+			size_t stride = zimg::ceil_n(m_row_size[p], zimg::ALIGNMENT);
+			m_planes[p].resize(stride * m_heights[p]);
+			m_buffers[p] = { m_planes[p].data(), static_cast<ptrdiff_t>(stride), graphengine::BUFFER_MAX };
+		}
+	}
+
+	const std::array<graphengine::BufferDescriptor, 4> &buffers() const { return m_buffers; }
+
+	// Buffers addressing line |i| of the image as line 0.
+	std::array<graphengine::BufferDescriptor, 4> buffers_at(unsigned i, unsigned subsample_h) const
+	{
+		std::array<graphengine::BufferDescriptor, 4> buffers = m_buffers;
+
+		for (unsigned p = 0; p < 4; ++p) {
+			unsigned ss = p == 1 || p == 2 ? subsample_h : 0;
+			if (buffers[p].ptr)
+				buffers[p].ptr = static_cast<unsigned char *>(buffers[p].ptr) + static_cast<ptrdiff_t>(i >> ss) * buffers[p].stride;
+		}
+		return buffers;
+	}
+
+	unsigned char *row(unsigned p, unsigned i) const { return m_buffers[p].get_line<unsigned char>(i); }
+
+	const float *row_f(unsigned p, unsigned i) const { return m_buffers[p].get_line<float>(i); }
+
+	size_t row_size(unsigned p) const { return m_row_size[p]; }
+
+	unsigned width(unsigned p) const { return static_cast<unsigned>(m_row_size[p] / m_bytes_per_sample); }
+
+	unsigned height(unsigned p) const { return m_heights[p]; }
+
+	// Fill with random samples. Floating-point samples are in [0, 1].
+	void fill(zimg::PixelType type, unsigned depth)
+	{
+		std::mt19937 engine;
+		std::uniform_int_distribution<unsigned> dist{ 0, type == zimg::PixelType::FLOAT ? 0xFFFFU : (1U << depth) - 1 };
+
+		for (unsigned p = 0; p < 4; ++p) {
+			for (unsigned i = 0; i < m_heights[p]; ++i) {
+				unsigned char *ptr = row(p, i);
+
+				for (size_t j = 0; j < m_row_size[p]; j += m_bytes_per_sample) {
+					if (type == zimg::PixelType::BYTE) {
+						ptr[j] = static_cast<uint8_t>(dist(engine));
+					} else if (type == zimg::PixelType::WORD) {
+						uint16_t x = static_cast<uint16_t>(dist(engine));
+						std::memcpy(ptr + j, &x, sizeof(x));
+					} else {
+						float x = dist(engine) / 65535.0f;
+						std::memcpy(ptr + j, &x, sizeof(x));
+					}
+				}
+			}
+		}
+	}
+
+	bool operator==(const TestFrame &other) const { return m_planes == other.m_planes; }
+
+	// Largest absolute difference between integer samples.
+	unsigned max_difference(const TestFrame &other) const
+	{
+		unsigned ret = 0;
+
+		for (unsigned p = 0; p < 4; ++p) {
+			for (unsigned i = 0; i < m_heights[p]; ++i) {
+				for (size_t j = 0; j < m_row_size[p]; j += m_bytes_per_sample) {
+					unsigned x = 0;
+					unsigned y = 0;
+					std::memcpy(&x, row(p, i) + j, m_bytes_per_sample);
+					std::memcpy(&y, other.row(p, i) + j, m_bytes_per_sample);
+					ret = std::max(ret, x > y ? x - y : y - x);
+				}
+			}
+		}
+		return ret;
+	}
+};
+
+// Progressive BT.709 image with full range RGB and limited range YUV.
+inline zimg::graph::GraphBuilder::state make_test_state(unsigned width, unsigned height, zimg::PixelType type, zimg::graph::GraphBuilder::ColorFamily color,
+                                                        unsigned subsample_w = 0, unsigned subsample_h = 0)
+{
+	typedef zimg::graph::GraphBuilder GraphBuilder;
+	using zimg::colorspace::MatrixCoefficients;
+	using zimg::colorspace::TransferCharacteristics;
+	using zimg::colorspace::ColorPrimaries;
+
+	GraphBuilder::state state{};
+	state.width = width;
+	state.height = height;
+	state.type = type;
+	state.subsample_w = subsample_w;
+	state.subsample_h = subsample_h;
+	state.color = color;
+	state.colorspace = color == GraphBuilder::ColorFamily::RGB ?
+		zimg::colorspace::ColorspaceDefinition{ MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 } :
+		zimg::colorspace::ColorspaceDefinition{ MatrixCoefficients::REC_709, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 };
+	state.depth = zimg::pixel_depth(type);
+	state.fullrange = color == GraphBuilder::ColorFamily::RGB;
+	state.parity = GraphBuilder::FieldParity::PROGRESSIVE;
+	state.chroma_location_w = GraphBuilder::ChromaLocationW::LEFT;
+	state.chroma_location_h = GraphBuilder::ChromaLocationH::CENTER;
+	state.active_left = 0.0;
+	state.active_top = 0.0;
+	state.active_width = width;
+	state.active_height = height;
+	state.alpha = GraphBuilder::AlphaType::NONE;
+	state.layout = GraphBuilder::Layout::PLANAR;
+	return state;
+}
+
+#endif // ZIMG_TEST_GRAPH_GRAPH_FRAME_H_
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include "colorspace/colorspace.h"
+#include "common/cpuinfo.h"
 #include "common/pixel.h"
 #include "depth/depth.h"
 #include "graph/filtergraph.h"
@@ -37,6 +38,8 @@ public:
 
 	void grey_to_yuv() override { m_trace.push_back("grey_to_yuv"); }
 	void grey_to_rgb() override { m_trace.push_back("grey_to_rgb"); }
+	void upsample_yuv_to_rgb() override { m_trace.push_back("upsample_yuv_to_rgb"); }
+	void matrix_int() override { m_trace.push_back("matrix_int"); }
 
 	void premultiply() override { m_trace.push_back("premultiply"); }
 	void unpremultiply() override { m_trace.push_back("unpremultiply"); }
@@ -60,7 +63,7 @@ public:
 	void depth(const zimg::depth::DepthConversion &conv, int plane) override
 	{
 		char buffer[128];
-		sprintf(buffer, "depth[%d]: [%d/%u %c:%c%s] => [%d/%u %c:%c%s]\n",
+		sprintf(buffer, "depth[%d]: [%d/%u %c:%c%s] => [%d/%u %c:%c%s]%s\n",
 			plane,
 			static_cast<int>(conv.pixel_in.type),
 			conv.pixel_in.depth,
@@ -71,7 +74,8 @@ public:
 			conv.pixel_out.depth,
 			conv.pixel_out.fullrange ? 'f' : 'l',
 			conv.pixel_out.chroma ? 'c' : 'l',
-			conv.pixel_out.ycgco ? " ycgco" : "");
+			conv.pixel_out.ycgco ? " ycgco" : "",
+			conv.transfer.func ? " transfer" : "");
 		m_trace.push_back(buffer);
 	}
 
@@ -147,12 +151,8 @@ void set_resolution(GraphBuilder::state &state, unsigned width, unsigned height)
 	state.active_height = height;
 }
 
-void test_case(const GraphBuilder::state &source, const GraphBuilder::state &target, const TraceList &trace)
+void check_trace(const TracingObserver &observer, const TraceList &trace)
 {
-	GraphBuilder builder;
-	TracingObserver observer;
-	builder.set_source(source).connect(target, nullptr, &observer).build_graph();
-
 	EXPECT_EQ(trace.size(), observer.trace().size());
 	for (size_t i = 0; i < std::min(trace.size(), observer.trace().size()); ++i) {
 		EXPECT_TRUE(observer.trace()[i].rfind(trace[i]) == 0)
@@ -163,6 +163,14 @@ void test_case(const GraphBuilder::state &source, const GraphBuilder::state &tar
 	}
 }
 
+void test_case(const GraphBuilder::state &source, const GraphBuilder::state &target, const TraceList &trace, const GraphBuilder::params *params = nullptr)
+{
+	GraphBuilder builder;
+	TracingObserver observer;
+	builder.set_source(source).connect(target, params, &observer).build_graph();
+	check_trace(observer, trace);
+}
+
 } // namespace
 
 
@@ -326,9 +334,7 @@ TEST(GraphBuilderTest, test_resize_byte_fast_path)
 	set_resolution(target, 128, 96);
 
 	test_case(source, target, {
-		"depth[0]: [0/8 l:l] => [1/16 l:l]",
 		"resize",
-		"depth[0]: [1/16 l:l] => [0/8 l:l]",
 	});
 }
 
@@ -484,6 +490,147 @@ TEST(GraphBuilderTest, test_downscale_colorspace_tile)
 	});
 }
 
+TEST(GraphBuilderTest, test_upsample_yuv_to_rgb)
+{
+	auto source = make_basic_yuv_state();
+	source.type = zimg::PixelType::WORD;
+	source.depth = 10;
+	source.subsample_w = 1;
+	source.subsample_h = 1;
+
+	auto target = make_basic_rgb_state();
+
+	// The portable fused filters are not selected for SIMD CPU classes.
+	GraphBuilder::params params;
+	params.cpu = zimg::CPUClass::NONE;
+
+	test_case(source, target, { "upsample_yuv_to_rgb" }, &params);
+}
+
+TEST(GraphBuilderTest, test_upsample_yuv_to_rgb_upscale)
+{
+	auto source = make_basic_yuv_state();
+	source.type = zimg::PixelType::BYTE;
+	source.depth = 8;
+	source.subsample_w = 1;
+	source.subsample_h = 0;
+
+	auto target = make_basic_rgb_state();
+	set_resolution(target, 96, 72);
+
+	GraphBuilder::params params;
+	params.cpu = zimg::CPUClass::NONE;
+
+	test_case(source, target, {
+		"upsample_yuv_to_rgb",
+		"resize[0]: [64, 48] => [96, 72]",
+	}, &params);
+}
+
+TEST(GraphBuilderTest, test_upsample_yuv_to_rgb_downscale)
+{
+	auto source = make_basic_yuv_state();
+	source.type = zimg::PixelType::WORD;
+	source.depth = 10;
+	source.subsample_w = 1;
+	source.subsample_h = 1;
+
+	auto target = make_basic_rgb_state();
+	set_resolution(target, 32, 24);
+
+	test_case(source, target, {
+		"resize[0]: [64, 48] => [32, 24]",
+		"depth[0]",
+		"depth[1]",
+		"colorspace",
+	});
+}
+
+TEST(GraphBuilderTest, test_matrix_int)
+{
+	auto source = make_basic_yuv_state();
+	source.type = zimg::PixelType::BYTE;
+	source.depth = 8;
+
+	auto target = make_basic_rgb_state();
+	target.type = zimg::PixelType::WORD;
+	target.depth = 10;
+	target.fullrange = true;
+
+	test_case(source, target, { "matrix_int" });
+}
+
+TEST(GraphBuilderTest, test_matrix_int_16bit)
+{
+	auto source = make_basic_yuv_state();
+	source.type = zimg::PixelType::WORD;
+	source.depth = 16;
+
+	auto target = make_basic_rgb_state();
+	target.type = zimg::PixelType::WORD;
+	target.depth = 16;
+
+	test_case(source, target, {
+		"depth[0]",
+		"depth[1]",
+		"colorspace",
+		"depth[0]",
+	});
+}
+
+TEST(GraphBuilderTest, test_linearize_depth)
+{
+	auto source = make_basic_rgb_state();
+	source.type = zimg::PixelType::BYTE;
+	source.depth = 8;
+
+	auto target = make_basic_rgb_state();
+	target.colorspace.primaries = ColorPrimaries::REC_2020;
+
+	test_case(source, target, {
+		"depth[0]: [0/8 l:l] => [3/32 l:l] transfer",
+		"colorspace: [1, 1, 4] => [1, 4, 6]",
+	});
+}
+
+TEST(GraphBuilderTest, test_linearize_depth_16bit)
+{
+	auto source = make_basic_rgb_state();
+	source.type = zimg::PixelType::WORD;
+	source.depth = 16;
+
+	auto target = make_basic_rgb_state();
+	target.colorspace.primaries = ColorPrimaries::REC_2020;
+	target.type = zimg::PixelType::WORD;
+	target.depth = 16;
+
+	test_case(source, target, {
+		"depth[0]: [1/16 l:l] => [3/32 l:l]\n",
+		"colorspace: [1, 4, 4] => [1, 1, 6]",
+		"depth[0]: [3/32 l:l] => [1/16 l:l] transfer",
+	});
+}
+
+TEST(GraphBuilderTest, test_linearize_depth_resize)
+{
+	auto source = make_basic_rgb_state();
+	source.type = zimg::PixelType::BYTE;
+	source.depth = 8;
+
+	auto target = make_basic_rgb_state();
+	set_resolution(target, 128, 96);
+	target.colorspace.primaries = ColorPrimaries::REC_2020;
+	target.type = zimg::PixelType::BYTE;
+	target.depth = 8;
+
+	test_case(source, target, {
+		"depth[0]: [0/8 l:l] => [3/32 l:l] transfer",
+		"colorspace",
+		"resize[0]",
+		"depth[0]: [3/32 l:l] => [0/8 l:l]\n",
+	});
+}
+
 TEST(GraphBuilderTest, test_grey_to_grey_noop)
 {
 	auto source = make_basic_yuv_state();
@@ -717,3 +864,76 @@ TEST(GraphBuilderTest, test_subsample_noop_tile)
 		"subrectangle[1]: [16, 12, 16, 12]",
 	});
 }
+
+TEST(GraphBuilderTest, test_multi_shared_colorspace)
+{
+	auto source = make_basic_yuv_state();
+	source.type = zimg::PixelType::BYTE;
+	source.depth = 8;
+	source.subsample_w = 1;
+	source.subsample_h = 1;
+
+	GraphBuilder::state targets[2] = { source, source };
+	for (GraphBuilder::state &target : targets) {
+		target.colorspace = { MatrixCoefficients::REC_2020_NCL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 };
+	}
+	set_resolution(targets[0], 128, 96);
+	set_resolution(targets[1], 96, 72);
+
+	// The colorspace is converted once at the source resolution.
+	TracingObserver observer;
+	GraphBuilder{}.set_source(source).build_multi_graph(targets, 2, nullptr, &observer);
+
+	check_trace(observer, {
+		"depth[0]: [0/8 l:l] => [3/32 l:l]",
+		"depth[1]: [0/8 l:c] => [3/32 l:c]",
+		"resize[1]: [32, 24] => [64, 48]",
+		"colorspace",
+		"resize[0]: [64, 48] => [128, 96]",
+		"depth[0]: [3/32 l:l] => [0/8 l:l]",
+		"depth[1]: [3/32 l:c] => [0/8 l:c]",
+		"resize[0]: [64, 48] => [96, 72]",
+		"depth[0]: [3/32 l:l] => [0/8 l:l]",
+		"resize[1]: [64, 48] => [48, 36]",
+		"depth[1]: [3/32 l:c] => [0/8 l:c]",
+	});
+}
+
+TEST(GraphBuilderTest, test_multi_downscale_colorspace)
+{
+	auto source = make_basic_yuv_state();
+	source.type = zimg::PixelType::BYTE;
+	source.depth = 8;
+	source.subsample_w = 1;
+	source.subsample_h = 1;
+
+	GraphBuilder::state targets[2] = { source, source };
+	for (GraphBuilder::state &target : targets) {
+		target.colorspace = { MatrixCoefficients::REC_2020_NCL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 };
+	}
+	set_resolution(targets[0], 32, 24);
+	set_resolution(targets[1], 16, 12);
+
+	// Each target is converted at its own resolution, as by a single graph,
+	// instead of resizing source-resolution 4:4:4 float planes.
+	TracingObserver observer;
+	GraphBuilder{}.set_source(source).build_multi_graph(targets, 2, nullptr, &observer);
+
+	check_trace(observer, {
+		"depth[0]: [0/8 l:l] => [3/32 l:l]",
+		"resize[0]: [64, 48] => [32, 24]",
+		"depth[1]: [0/8 l:c] => [3/32 l:c]",
+		"colorspace",
+		"depth[0]: [3/32 l:l] => [0/8 l:l]",
+		"resize[1]: [32, 24] => [16, 12]",
+		"depth[1]: [3/32 l:c] => [0/8 l:c]",
+		"depth[0]: [0/8 l:l] => [3/32 l:l]",
+		"resize[0]: [64, 48] => [16, 12]",
+		"depth[1]: [0/8 l:c] => [3/32 l:c]",
+		"resize[1]: [32, 24] => [16, 12]",
+		"colorspace",
+		"depth[0]: [3/32 l:l] => [0/8 l:l]",
+		"resize[1]: [16, 12] => [8, 6]",
+		"depth[1]: [3/32 l:c] => [0/8 l:c]",
+	});
+}
@@ -0,0 +1,288 @@
+#include <cstdint>
+#include <cstring>
+#include "common/alloc.h"
+#include "common/cpuinfo.h"
+#include "common/except.h"
+#include "common/pixel.h"
+#include "graph/filtergraph.h"
+#include "graph/graphbuilder.h"
+#include "graph/packing.h"
+#include "graphengine/types.h"
+
+#include "gtest/gtest.h"
+#include "graph_frame.h"
+
+namespace {
+
+using zimg::colorspace::MatrixCoefficients;
+using zimg::graph::GraphBuilder;
+
+// Reference packing of a planar image, one sample at a time.
+void pack_reference(const GraphBuilder::state &state, const TestFrame &planar, const TestFrame &packed)
+{
+	unsigned bps = zimg::pixel_size(state.type);
+	bool has_chroma = state.color != GraphBuilder::ColorFamily::GREY;
+	bool has_alpha = state.alpha != GraphBuilder::AlphaType::NONE;
+
+	auto copy = [&](unsigned char *dst, size_t dst_idx, const unsigned char *src, size_t src_idx)
+	{
+		std::memcpy(dst + dst_idx * bps, src + src_idx * bps, bps);
+	};
+
+	for (unsigned i = 0; i < state.height; ++i) {
+		unsigned chroma_i = i >> state.subsample_h;
+		bool chroma_row = (i & ((1U << state.subsample_h) - 1)) == 0;
+
+		switch (state.layout) {
+		case GraphBuilder::Layout::SEMIPLANAR:
+			std::memcpy(packed.row(0, i), planar.row(0, i), planar.row_size(0));
+			if (has_alpha)
+				std::memcpy(packed.row(3, i), planar.row(3, i), planar.row_size(3));
+			if (chroma_row) {
+				for (unsigned j = 0; j < (state.width >> state.subsample_w); ++j) {
+					copy(packed.row(1, chroma_i), j * 2 + 0, planar.row(1, chroma_i), j);
+					copy(packed.row(1, chroma_i), j * 2 + 1, planar.row(2, chroma_i), j);
+				}
+			}
+			break;
+		case GraphBuilder::Layout::PACKED:
+		case GraphBuilder::Layout::PACKED_BGR: {
+			unsigned order[4] = { 0, 1, 2, 3 };
+			unsigned n = 0;
+
+			if (state.layout == GraphBuilder::Layout::PACKED_BGR)
+				std::swap(order[0], order[2]);
+
+			unsigned components[4];
+			for (unsigned p : order) {
+				if ((p == 1 || p == 2) && !has_chroma)
+					continue;
+				if (p == 3 && !has_alpha)
+					continue;
+				components[n++] = p;
+			}
+
+			for (unsigned j = 0; j < state.width; ++j) {
+				for (unsigned c = 0; c < n; ++c) {
+					copy(packed.row(0, i), static_cast<size_t>(j) * n + c, planar.row(components[c], i), j);
+				}
+			}
+			break;
+		}
+		case GraphBuilder::Layout::YUYV:
+		case GraphBuilder::Layout::UYVY: {
+			bool yuyv = state.layout == GraphBuilder::Layout::YUYV;
+
+			for (unsigned j = 0; j < state.width / 2; ++j) {
+				copy(packed.row(0, i), j * 4 + (yuyv ? 0 : 1), planar.row(0, i), j * 2 + 0);
+				copy(packed.row(0, i), j * 4 + (yuyv ? 2 : 3), planar.row(0, i), j * 2 + 1);
+				copy(packed.row(0, i), j * 4 + (yuyv ? 1 : 0), planar.row(1, i), j);
+				copy(packed.row(0, i), j * 4 + (yuyv ? 3 : 2), planar.row(2, i), j);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+void run_graph(const GraphBuilder::state &source, const GraphBuilder::state &target, const TestFrame &src_frame, const TestFrame &dst_frame, zimg::CPUClass cpu)
+{
+	GraphBuilder::params params;
+	params.cpu = cpu;
+
+	auto graph = GraphBuilder{}.set_source(source).connect(target, &params).build_graph();
+	zimg::AlignedVector<unsigned char> tmp(graph->get_tmp_size());
+	graph->process(src_frame.buffers(), dst_frame.buffers(), tmp.data(), nullptr, nullptr, nullptr, nullptr);
+}
+
+void assert_identical_frames(const TestFrame &a, const TestFrame &b)
+{
+	for (unsigned p = 0; p < 4; ++p) {
+		ASSERT_EQ(a.row_size(p), b.row_size(p));
+
+		for (unsigned i = 0; i < a.height(p); ++i) {
+			ASSERT_EQ(0, std::memcmp(a.row(p, i), b.row(p, i), a.row_size(p))) << "plane " << p << " row " << i;
+		}
+	}
+}
+
+// Checks that unpacking and packing round-trip against the reference packing.
+void test_case(GraphBuilder::state state, GraphBuilder::Layout layout)
+{
+	GraphBuilder::state packed_state = state;
+	packed_state.layout = layout;
+
+	TestFrame planar{ state };
+	TestFrame packed{ packed_state };
+
+	planar.fill(state.type, state.depth);
+	pack_reference(packed_state, planar, packed);
+
+	for (zimg::CPUClass cpu : { zimg::CPUClass::NONE, zimg::CPUClass::AUTO }) {
+		SCOPED_TRACE(static_cast<int>(cpu));
+
+		TestFrame unpacked{ state };
+		TestFrame repacked{ packed_state };
+		TestFrame passthrough{ packed_state };
+
+		ASSERT_NO_FATAL_FAILURE(run_graph(packed_state, state, packed, unpacked, cpu));
+		ASSERT_NO_FATAL_FAILURE(assert_identical_frames(planar, unpacked));
+
+		ASSERT_NO_FATAL_FAILURE(run_graph(state, packed_state, planar, repacked, cpu));
+		ASSERT_NO_FATAL_FAILURE(assert_identical_frames(packed, repacked));
+
+		ASSERT_NO_FATAL_FAILURE(run_graph(packed_state, packed_state, packed, passthrough, cpu));
+		ASSERT_NO_FATAL_FAILURE(assert_identical_frames(packed, passthrough));
+	}
+}
+
+} // namespace
+
+
+TEST(PackingTest, test_nv12)
+{
+	auto state = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV, 1, 1);
+	test_case(state, GraphBuilder::Layout::SEMIPLANAR);
+}
+
+TEST(PackingTest, test_p010)
+{
+	auto state = make_test_state(590, 332, zimg::PixelType::WORD, GraphBuilder::ColorFamily::YUV, 1, 1);
+	test_case(state, GraphBuilder::Layout::SEMIPLANAR);
+}
+
+TEST(PackingTest, test_semiplanar_alpha)
+{
+	auto state = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV, 1, 0);
+	state.alpha = GraphBuilder::AlphaType::STRAIGHT;
+	test_case(state, GraphBuilder::Layout::SEMIPLANAR);
+}
+
+TEST(PackingTest, test_yuyv)
+{
+	auto state = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV, 1, 0);
+	test_case(state, GraphBuilder::Layout::YUYV);
+}
+
+TEST(PackingTest, test_uyvy_word)
+{
+	auto state = make_test_state(590, 332, zimg::PixelType::WORD, GraphBuilder::ColorFamily::YUV, 1, 0);
+	state.depth = 10;
+	test_case(state, GraphBuilder::Layout::UYVY);
+}
+
+TEST(PackingTest, test_rgb24)
+{
+	auto state = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::RGB);
+	test_case(state, GraphBuilder::Layout::PACKED);
+}
+
+TEST(PackingTest, test_bgra)
+{
+	auto state = make_test_state(590, 332, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::RGB);
+	state.alpha = GraphBuilder::AlphaType::STRAIGHT;
+	test_case(state, GraphBuilder::Layout::PACKED_BGR);
+}
+
+TEST(PackingTest, test_rgba_word)
+{
+	auto state = make_test_state(640, 480, zimg::PixelType::WORD, GraphBuilder::ColorFamily::RGB);
+	state.alpha = GraphBuilder::AlphaType::PREMULTIPLIED;
+	test_case(state, GraphBuilder::Layout::PACKED);
+}
+
+TEST(PackingTest, test_rgb_float)
+{
+	auto state = make_test_state(640, 480, zimg::PixelType::FLOAT, GraphBuilder::ColorFamily::RGB);
+	test_case(state, GraphBuilder::Layout::PACKED);
+}
+
+TEST(PackingTest, test_grey_alpha)
+{
+	auto state = make_test_state(640, 480, zimg::PixelType::WORD, GraphBuilder::ColorFamily::GREY);
+	state.colorspace.matrix = MatrixCoefficients::UNSPECIFIED;
+	state.alpha = GraphBuilder::AlphaType::STRAIGHT;
+	test_case(state, GraphBuilder::Layout::PACKED);
+}
+
+TEST(PackingTest, test_nv12_to_bgra)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV, 1, 1);
+	source.fullrange = false;
+	auto target = make_test_state(960, 720, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::RGB);
+	target.alpha = GraphBuilder::AlphaType::STRAIGHT;
+
+	GraphBuilder::state packed_source = source;
+	GraphBuilder::state packed_target = target;
+	packed_source.layout = GraphBuilder::Layout::SEMIPLANAR;
+	packed_target.layout = GraphBuilder::Layout::PACKED_BGR;
+
+	TestFrame planar_src{ source };
+	TestFrame packed_src{ packed_source };
+	planar_src.fill(source.type, source.depth);
+	pack_reference(packed_source, planar_src, packed_src);
+
+	TestFrame planar_dst{ target };
+	TestFrame expected{ packed_target };
+	ASSERT_NO_FATAL_FAILURE(run_graph(source, target, planar_src, planar_dst, zimg::CPUClass::AUTO));
+	pack_reference(packed_target, planar_dst, expected);
+
+	TestFrame packed_dst{ packed_target };
+	ASSERT_NO_FATAL_FAILURE(run_graph(packed_source, packed_target, packed_src, packed_dst, zimg::CPUClass::AUTO));
+	ASSERT_NO_FATAL_FAILURE(assert_identical_frames(expected, packed_dst));
+}
+
+TEST(PackingTest, test_interleave_partial_group)
+{
+	const unsigned w = 101;
+	static constexpr int map[3] = { 2, 1, 0 };
+
+	zimg::graph::InterleaveFilter filter{ w, 1, zimg::PixelType::WORD, 3, 3, map, zimg::CPUClass::AUTO };
+
+	uint16_t src[3][w];
+	uint16_t expected[w * 3];
+	uint16_t dst[w * 3] = {};
+
+	for (unsigned j = 0; j < w; ++j) {
+		for (unsigned c = 0; c < 3; ++c) {
+			src[c][j] = static_cast<uint16_t>(j * 3 + c);
+			expected[j * 3 + (2 - c)] = src[c][j];
+		}
+	}
+
+	graphengine::BufferDescriptor in[3];
+	for (unsigned c = 0; c < 3; ++c) {
+		in[c] = { src[c], 0, graphengine::BUFFER_MAX };
+	}
+	graphengine::BufferDescriptor out = { dst, 0, graphengine::BUFFER_MAX };
+
+	// Split the row at positions that do not fall on group boundaries.
+	const unsigned splits[] = { 0, 1, 2, 4, 5, 131, 299, w * 3 };
+	for (unsigned k = 0; k + 1 < sizeof(splits) / sizeof(splits[0]); ++k) {
+		auto deps = filter.get_col_deps(splits[k], splits[k + 1]);
+		ASSERT_LE(deps.first * 3, splits[k]);
+		ASSERT_GE(deps.second * 3, splits[k + 1]);
+		filter.process(in, &out, 0, splits[k], splits[k + 1], nullptr, nullptr);
+	}
+
+	for (unsigned j = 0; j < w * 3; ++j) {
+		ASSERT_EQ(expected[j], dst[j]) << j;
+	}
+}
+
+TEST(PackingTest, test_invalid_layout)
+{
+	auto rgb = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::RGB);
+	auto yuv420 = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::YUV, 1, 1);
+
+	rgb.layout = GraphBuilder::Layout::SEMIPLANAR;
+	EXPECT_THROW(GraphBuilder{}.set_source(rgb), zimg::error::ColorFamilyMismatch);
+
+	yuv420.layout = GraphBuilder::Layout::YUYV;
+	EXPECT_THROW(GraphBuilder{}.set_source(yuv420), zimg::error::UnsupportedSubsampling);
+
+	yuv420.layout = GraphBuilder::Layout::PACKED;
+	EXPECT_THROW(GraphBuilder{}.set_source(yuv420), zimg::error::UnsupportedSubsampling);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef ZIMG_TEST_GRAPH_PREMULTIPLY_COMPARE_H_
+#define ZIMG_TEST_GRAPH_PREMULTIPLY_COMPARE_H_
+
+#ifndef GOOGLETEST_INCLUDE_GTEST_GTEST_H_
+  #error gtest not included
+#endif
+
+#include <cstddef>
+#include <random>
+#include "common/alloc.h"
+#include "common/cpuinfo.h"
+#include "graph/simple_filters.h"
+
+// Checks that the (un)premultiplication kernel for |cpu| matches the C kernel exactly.
+inline void test_case_premultiply(bool unpremultiply, zimg::CPUClass cpu)
+{
+	constexpr unsigned WIDTH = 333;
+	constexpr unsigned LEFT = 5;
+	constexpr unsigned RIGHT = WIDTH - 7;
+
+	auto random_samples = [](size_t count, float min, float max, unsigned seed)
+	{
+		std::mt19937 engine{ seed };
+		std::uniform_real_distribution<float> dist{ min, max };
+		zimg::AlignedVector<float> ret(count);
+
+		for (auto &x : ret) {
+			x = dist(engine);
+		}
+		return ret;
+	};
+
+	auto select = unpremultiply ? zimg::graph::select_unpremultiply_func : zimg::graph::select_premultiply_func;
+	auto func_c = select(zimg::CPUClass::NONE);
+	auto func_simd = select(cpu);
+	ASSERT_NE(func_c, func_simd);
+
+	zimg::AlignedVector<float> src = random_samples(WIDTH, -0.5f, 1.5f, 1);
+	zimg::AlignedVector<float> alpha = random_samples(WIDTH, -0.25f, 1.25f, 2);
+
+	// Include fully transparent and opaque pixels.
+	for (unsigned j = 0; j < WIDTH; j += 9) {
+		alpha[j] = 0.0f;
+		alpha[j + 1] = 1.0f;
+	}
+
+	zimg::AlignedVector<float> dst_c(WIDTH, -1.0f);
+	zimg::AlignedVector<float> dst_simd(WIDTH, -1.0f);
+
+	func_c(src.data(), alpha.data(), dst_c.data(), LEFT, RIGHT);
+	func_simd(src.data(), alpha.data(), dst_simd.data(), LEFT, RIGHT);
+
+	EXPECT_EQ(dst_c, dst_simd);
+}
+
+#endif // ZIMG_TEST_GRAPH_PREMULTIPLY_COMPARE_H_
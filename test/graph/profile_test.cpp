@@ -0,0 +1,74 @@
+#include <array>
+#include <cstdint>
+#include "common/alloc.h"
+#include "common/pixel.h"
+#include "graph/filtergraph.h"
+#include "graph/graphbuilder.h"
+#include "graph/profile.h"
+#include "graphengine/types.h"
+
+#include "gtest/gtest.h"
+#include "graph_frame.h"
+
+namespace {
+
+using zimg::graph::GraphBuilder;
+
+void run_graph(const zimg::graph::FilterGraph &graph, const GraphBuilder::state &source, const GraphBuilder::state &target)
+{
+	size_t src_stride = zimg::ceil_n(static_cast<size_t>(source.width) * zimg::pixel_size(source.type), zimg::ALIGNMENT);
+	size_t dst_stride = zimg::ceil_n(static_cast<size_t>(target.width) * zimg::pixel_size(target.type), zimg::ALIGNMENT);
+
+	zimg::AlignedVector<unsigned char> src(src_stride * source.height);
+	zimg::AlignedVector<unsigned char> dst(dst_stride * target.height);
+	zimg::AlignedVector<unsigned char> tmp(graph.get_tmp_size());
+
+	std::array<graphengine::BufferDescriptor, 4> src_buf{};
+	std::array<graphengine::BufferDescriptor, 4> dst_buf{};
+	src_buf[0] = { src.data(), static_cast<ptrdiff_t>(src_stride), graphengine::BUFFER_MAX };
+	dst_buf[0] = { dst.data(), static_cast<ptrdiff_t>(dst_stride), graphengine::BUFFER_MAX };
+
+	graph.process(src_buf, dst_buf, tmp.data(), nullptr, nullptr, nullptr, nullptr);
+}
+
+} // namespace
+
+
+TEST(ProfileTest, test_disabled)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::GREY);
+	auto target = make_test_state(320, 240, zimg::PixelType::FLOAT, GraphBuilder::ColorFamily::GREY);
+
+	auto graph = GraphBuilder{}.set_source(source).connect(target, nullptr).build_graph();
+	EXPECT_EQ(nullptr, graph->get_profile());
+}
+
+TEST(ProfileTest, test_counters)
+{
+	auto source = make_test_state(640, 480, zimg::PixelType::BYTE, GraphBuilder::ColorFamily::GREY);
+	auto target = make_test_state(320, 240, zimg::PixelType::FLOAT, GraphBuilder::ColorFamily::GREY);
+
+	GraphBuilder::params params;
+	params.profile = true;
+
+	auto graph = GraphBuilder{}.set_source(source).connect(target, &params).build_graph();
+	const zimg::graph::GraphProfile *profile = graph->get_profile();
+	ASSERT_TRUE(profile);
+	ASSERT_GT(profile->size(), 0U);
+
+	for (size_t n = 0; n < profile->size(); ++n) {
+		EXPECT_EQ(0U, (*profile)[n].calls);
+	}
+
+	run_graph(*graph, source, target);
+
+	for (size_t n = 0; n < profile->size(); ++n) {
+		const zimg::graph::FilterProfile &entry = (*profile)[n];
+		SCOPED_TRACE(entry.name);
+
+		EXPECT_FALSE(entry.name.empty());
+		EXPECT_GT(entry.calls, 0U);
+		EXPECT_GE(entry.rows, entry.height);
+		EXPECT_EQ(static_cast<uint64_t>(entry.width) * entry.height, entry.pixels);
+	}
+}
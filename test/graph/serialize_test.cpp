@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "common/cpuinfo.h"
+#include "common/except.h"
+#include "common/table_record.h"
+#include "graph/serialize.h"
+#include "resize/filter.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+zimg::graph::GraphBlob record_blob()
+{
+	zimg::graph::GraphBlob blob{ zimg::CPUClass::NONE, { 1, 2, 3 }, zimg::TableRecord{} };
+
+	zimg::TableRecordScope scope{ &blob.tables };
+	zimg::resize::get_filter_context(zimg::resize::BicubicFilter{}, 640, 427, 0.0, 640.0, zimg::resize::FilterPrecision::INT16);
+	zimg::resize::get_filter_context(zimg::resize::LanczosFilter{ 3 }, 427, 640, 0.25, 427.0, zimg::resize::FilterPrecision::FLOAT);
+
+	std::shared_ptr<float[]> lut{ new float[3]{ 1.0f, 2.0f, 3.0f } };
+	blob.tables.add(zimg::TableRecord::Kind::DEPTH_LUT, { 7 }, std::move(lut), 3);
+	return blob;
+}
+
+} // namespace
+
+
+TEST(SerializeTest, test_roundtrip)
+{
+	zimg::graph::GraphBlob blob = record_blob();
+	ASSERT_EQ(3U, blob.tables.entries().size());
+
+	std::vector<unsigned char> data = zimg::graph::write_graph_blob(blob);
+	zimg::graph::GraphBlob restored = zimg::graph::read_graph_blob(data.data(), data.size());
+
+	EXPECT_EQ(blob.cpu, restored.cpu);
+	EXPECT_EQ(blob.request, restored.request);
+	EXPECT_TRUE(restored.tables.is_replay());
+	ASSERT_EQ(blob.tables.entries().size(), restored.tables.entries().size());
+
+	for (size_t i = 0; i < 2; ++i) {
+		SCOPED_TRACE(i);
+		const zimg::TableRecord::entry &expected_entry = blob.tables.entries()[i];
+		const zimg::TableRecord::entry &entry = restored.tables.entries()[i];
+		ASSERT_EQ(zimg::TableRecord::Kind::RESIZE_FILTER, entry.kind);
+		EXPECT_EQ(expected_entry.key, entry.key);
+
+		const auto &expected = *static_cast<const zimg::resize::FilterContext *>(expected_entry.table.get());
+		const auto &ctx = *static_cast<const zimg::resize::FilterContext *>(entry.table.get());
+		EXPECT_EQ(expected.filter_width, ctx.filter_width);
+		EXPECT_EQ(expected.num_phases, ctx.num_phases);
+		EXPECT_EQ(expected.data, ctx.data);
+		EXPECT_EQ(expected.data_i16, ctx.data_i16);
+		EXPECT_EQ(expected.left, ctx.left);
+		EXPECT_EQ(expected.phase, ctx.phase);
+	}
+
+	const zimg::TableRecord::entry &lut = restored.tables.entries()[2];
+	ASSERT_EQ(3U, lut.count);
+	EXPECT_EQ(2.0f, static_cast<const float *>(lut.table.get())[1]);
+}
+
+TEST(SerializeTest, test_replay)
+{
+	zimg::graph::GraphBlob blob = record_blob();
+	std::vector<unsigned char> data = zimg::graph::write_graph_blob(blob);
+	zimg::graph::GraphBlob restored = zimg::graph::read_graph_blob(data.data(), data.size());
+
+	zimg::TableRecordScope scope{ &restored.tables };
+	auto ctx = zimg::resize::get_filter_context(zimg::resize::BicubicFilter{}, 640, 427, 0.0, 640.0, zimg::resize::FilterPrecision::INT16);
+	EXPECT_EQ(restored.tables.entries()[0].table, ctx);
+
+	// Parameters not in the record are computed as usual.
+	auto other = zimg::resize::get_filter_context(zimg::resize::BicubicFilter{}, 640, 427, 0.5, 640.0, zimg::resize::FilterPrecision::INT16);
+	EXPECT_EQ(427U, other->filter_rows);
+	EXPECT_NE(restored.tables.entries()[0].table, other);
+}
+
+TEST(SerializeTest, test_invalid_blob)
+{
+	std::vector<unsigned char> data = zimg::graph::write_graph_blob(record_blob());
+
+	for (size_t size : { static_cast<size_t>(0), static_cast<size_t>(16), data.size() / 2, data.size() - 8 }) {
+		SCOPED_TRACE(size);
+		EXPECT_THROW(zimg::graph::read_graph_blob(data.data(), size), zimg::error::IllegalArgument);
+	}
+
+	std::vector<unsigned char> bad_magic = data;
+	bad_magic[0] ^= 0xFF;
+	EXPECT_THROW(zimg::graph::read_graph_blob(bad_magic.data(), bad_magic.size()), zimg::error::IllegalArgument);
+}
@@ -0,0 +1,136 @@
+#ifdef ZIMG_X86
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "common/cpuinfo.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "graph/packing.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+constexpr unsigned WIDTH = 333;
+constexpr unsigned LEFT = 5;
+constexpr unsigned RIGHT = WIDTH - 7;
+
+std::vector<uint16_t> random_samples(size_t count)
+{
+	std::mt19937 engine;
+	std::uniform_int_distribution<unsigned> dist{ 0, 0xFFFF };
+	std::vector<uint16_t> ret(count);
+
+	for (auto &x : ret) {
+		x = static_cast<uint16_t>(dist(engine));
+	}
+	return ret;
+}
+
+void test_case_deinterleave(unsigned bytes_per_sample, unsigned num_components)
+{
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	auto func_c = zimg::graph::select_deinterleave_func(bytes_per_sample, num_components, zimg::CPUClass::NONE);
+	auto func_avx2 = zimg::graph::select_deinterleave_func(bytes_per_sample, num_components, zimg::CPUClass::X86_AVX2);
+	ASSERT_NE(func_c, func_avx2);
+
+	std::vector<uint16_t> src = random_samples(WIDTH * num_components);
+	std::vector<uint16_t> dst_c[4];
+	std::vector<uint16_t> dst_avx2[4];
+	void *ptr_c[4] = {};
+	void *ptr_avx2[4] = {};
+
+	// Leave the second component unused to check that skipped outputs are not written.
+	for (unsigned c = 0; c < num_components; ++c) {
+		if (c == 1)
+			continue;
+
+		dst_c[c].assign(WIDTH, 0xCDCD);
+		dst_avx2[c].assign(WIDTH, 0xCDCD);
+		ptr_c[c] = dst_c[c].data();
+		ptr_avx2[c] = dst_avx2[c].data();
+	}
+
+	func_c(src.data(), ptr_c, LEFT, RIGHT);
+	func_avx2(src.data(), ptr_avx2, LEFT, RIGHT);
+
+	for (unsigned c = 0; c < num_components; ++c) {
+		EXPECT_EQ(dst_c[c], dst_avx2[c]) << "component " << c;
+	}
+}
+
+void test_case_interleave(unsigned bytes_per_sample, unsigned num_components)
+{
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	auto func_c = zimg::graph::select_interleave_func(bytes_per_sample, num_components, zimg::CPUClass::NONE);
+	auto func_avx2 = zimg::graph::select_interleave_func(bytes_per_sample, num_components, zimg::CPUClass::X86_AVX2);
+	ASSERT_NE(func_c, func_avx2);
+
+	std::vector<uint16_t> src = random_samples(WIDTH * num_components);
+	const void *ptr[4] = {};
+
+	for (unsigned c = 0; c < num_components; ++c) {
+		ptr[c] = src.data() + c * WIDTH;
+	}
+
+	std::vector<uint16_t> dst_c(WIDTH * num_components, 0xCDCD);
+	std::vector<uint16_t> dst_avx2(WIDTH * num_components, 0xCDCD);
+
+	func_c(ptr, dst_c.data(), LEFT, RIGHT);
+	func_avx2(ptr, dst_avx2.data(), LEFT, RIGHT);
+
+	EXPECT_EQ(dst_c, dst_avx2);
+}
+
+} // namespace
+
+
+TEST(PackingAVX2Test, test_deinterleave_b2)
+{
+	test_case_deinterleave(1, 2);
+}
+
+TEST(PackingAVX2Test, test_deinterleave_b4)
+{
+	test_case_deinterleave(1, 4);
+}
+
+TEST(PackingAVX2Test, test_deinterleave_w2)
+{
+	test_case_deinterleave(2, 2);
+}
+
+TEST(PackingAVX2Test, test_deinterleave_w4)
+{
+	test_case_deinterleave(2, 4);
+}
+
+TEST(PackingAVX2Test, test_interleave_b2)
+{
+	test_case_interleave(1, 2);
+}
+
+TEST(PackingAVX2Test, test_interleave_b4)
+{
+	test_case_interleave(1, 4);
+}
+
+TEST(PackingAVX2Test, test_interleave_w2)
+{
+	test_case_interleave(2, 2);
+}
+
+TEST(PackingAVX2Test, test_interleave_w4)
+{
+	test_case_interleave(2, 4);
+}
+
+#endif // ZIMG_X86
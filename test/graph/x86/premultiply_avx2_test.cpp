@@ -0,0 +1,29 @@
+#ifdef ZIMG_X86
+
+#include "common/cpuinfo.h"
+#include "common/x86/cpuinfo_x86.h"
+
+#include "gtest/gtest.h"
+#include "graph/premultiply_compare.h"
+
+TEST(PremultiplyAVX2Test, test_premultiply)
+{
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	test_case_premultiply(false, zimg::CPUClass::X86_AVX2);
+}
+
+TEST(PremultiplyAVX2Test, test_unpremultiply)
+{
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	test_case_premultiply(true, zimg::CPUClass::X86_AVX2);
+}
+
+#endif // ZIMG_X86
@@ -0,0 +1,112 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "graphengine/filter.h"
+#include "resize/decimate.h"
+#include "resize/filter.h"
+#include "resize/resize_impl.h"
+
+#include "gtest/gtest.h"
+#include "filter_compare.h"
+
+namespace {
+
+constexpr unsigned SRC_W = 642;
+constexpr unsigned SRC_H = 482;
+
+float read_sample(const TestPlane &plane, unsigned i, unsigned j, zimg::PixelType type)
+{
+	const unsigned char *row = plane.row(i);
+
+	if (type == zimg::PixelType::BYTE) {
+		return row[j];
+	} else if (type == zimg::PixelType::WORD) {
+		uint16_t x;
+		std::memcpy(&x, row + j * sizeof(x), sizeof(x));
+		return x;
+	} else {
+		float x;
+		std::memcpy(&x, row + j * sizeof(x), sizeof(x));
+		return x;
+	}
+}
+
+// Reference result from the general resizer in floating point.
+TestPlane bilinear_reference(const TestPlane &src, zimg::PixelType type)
+{
+	const zimg::resize::BilinearFilter bilinear{};
+
+	TestPlane src_f{ SRC_W, SRC_H, zimg::PixelType::FLOAT };
+	for (unsigned i = 0; i < SRC_H; ++i) {
+		float *row = src_f.buffer().get_line<float>(i);
+
+		for (unsigned j = 0; j < SRC_W; ++j) {
+			row[j] = read_sample(src, i, j, type);
+		}
+	}
+
+	auto builder = zimg::resize::ResizeImplBuilder{ SRC_W, SRC_H, zimg::PixelType::FLOAT }
+		.set_depth(32)
+		.set_filter(&bilinear)
+		.set_shift(0.0)
+		.set_cpu(zimg::CPUClass::NONE);
+
+	auto filter_h = builder.set_horizontal(true).set_dst_dim(SRC_W / 2).set_subwidth(SRC_W).create();
+	auto filter_v = zimg::resize::ResizeImplBuilder{ SRC_W / 2, SRC_H, zimg::PixelType::FLOAT }
+		.set_horizontal(false)
+		.set_dst_dim(SRC_H / 2)
+		.set_depth(32)
+		.set_filter(&bilinear)
+		.set_shift(0.0)
+		.set_subwidth(SRC_H)
+		.set_cpu(zimg::CPUClass::NONE)
+		.create();
+
+	TestPlane tmp{ SRC_W / 2, SRC_H, zimg::PixelType::FLOAT };
+	TestPlane dst{ SRC_W / 2, SRC_H / 2, zimg::PixelType::FLOAT };
+	run_filter(*filter_h, src_f, tmp);
+	run_filter(*filter_v, tmp, dst);
+	return dst;
+}
+
+void test_case(zimg::PixelType type, unsigned depth, double tolerance)
+{
+	SCOPED_TRACE(static_cast<int>(type));
+
+	zimg::resize::DecimateFilter filter{ SRC_W, SRC_H, type, zimg::CPUClass::NONE };
+	ASSERT_EQ(SRC_W / 2, filter.descriptor().format.width);
+	ASSERT_EQ(SRC_H / 2, filter.descriptor().format.height);
+
+	TestPlane src{ SRC_W, SRC_H, type };
+	TestPlane dst{ SRC_W / 2, SRC_H / 2, type };
+	src.fill_random(type, depth);
+	run_filter(filter, src, dst);
+
+	TestPlane expected = bilinear_reference(src, type);
+
+	for (unsigned i = 0; i < SRC_H / 2; ++i) {
+		for (unsigned j = 0; j < SRC_W / 2; ++j) {
+			ASSERT_NEAR(read_sample(expected, i, j, zimg::PixelType::FLOAT), read_sample(dst, i, j, type), tolerance) << i << ", " << j;
+		}
+	}
+}
+
+} // namespace
+
+
+TEST(DecimateTest, test_decimate_u8)
+{
+	test_case(zimg::PixelType::BYTE, 8, 0.5 + 1e-3);
+}
+
+TEST(DecimateTest, test_decimate_u16)
+{
+	test_case(zimg::PixelType::WORD, 16, 0.5 + 1e-1);
+}
+
+TEST(DecimateTest, test_decimate_f32)
+{
+	test_case(zimg::PixelType::FLOAT, 32, 1e-6);
+}
@@ -104,3 +104,48 @@ TEST(FilterTest, test_lanczos)
 		check_interpolating(f);
 	}
 }
+
+TEST(FilterTest, test_filter_context_cache)
+{
+	zimg::resize::BicubicFilter f;
+	const zimg::resize::FilterContext *first = zimg::resize::get_filter_context(f, 640, 427, 0.0, 640.0).get();
+
+	// The coefficients outlive the last user, so that rebuilding a graph reuses them.
+	auto second = zimg::resize::get_filter_context(f, 640, 427, 0.0, 640.0);
+	EXPECT_EQ(first, second.get());
+
+	auto shifted = zimg::resize::get_filter_context(f, 640, 427, 0.5, 640.0);
+	EXPECT_NE(second, shifted);
+
+	zimg::resize::FilterContext expected = zimg::resize::compute_filter(f, 640, 427, 0.0, 640.0);
+	EXPECT_EQ(expected.filter_width, second->filter_width);
+	EXPECT_EQ(expected.left, second->left);
+	EXPECT_EQ(expected.data, second->data);
+	EXPECT_EQ(expected.data_i16, second->data_i16);
+}
+
+TEST(FilterTest, test_filter_context_phases)
+{
+	zimg::resize::BicubicFilter f;
+
+	// An integer scale factor repeats the same few phases across the interior.
+	zimg::resize::FilterContext ctx = zimg::resize::compute_filter(f, 640, 1280, 0.0, 640.0);
+	ASSERT_EQ(1280U, ctx.phase.size());
+	EXPECT_LT(ctx.num_phases, 16U);
+	EXPECT_EQ(ctx.num_phases * ctx.stride, ctx.data.size());
+	EXPECT_EQ(ctx.num_phases * ctx.stride_i16, ctx.data_i16.size());
+	EXPECT_EQ(ctx.phase[5], ctx.phase[7]);
+	EXPECT_EQ(ctx.phase[6], ctx.phase[8]);
+
+	for (unsigned i = 0; i < ctx.filter_rows; ++i) {
+		ASSERT_LT(ctx.phase[i], ctx.num_phases);
+	}
+
+	zimg::resize::FilterContext ctx_f = zimg::resize::compute_filter(f, 640, 1280, 0.0, 640.0, zimg::resize::FilterPrecision::FLOAT);
+	EXPECT_EQ(ctx.data, ctx_f.data);
+	EXPECT_TRUE(ctx_f.data_i16.empty());
+
+	zimg::resize::FilterContext ctx_i = zimg::resize::compute_filter(f, 640, 1280, 0.0, 640.0, zimg::resize::FilterPrecision::INT16);
+	EXPECT_TRUE(ctx_i.data.empty());
+	EXPECT_EQ(ctx.data_i16, ctx_i.data_i16);
+}
@@ -1,12 +1,19 @@
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <vector>
+#include "common/alloc.h"
 #include "common/cpuinfo.h"
 #include "common/pixel.h"
+#include "graph/simple_filters.h"
 #include "graphengine/filter.h"
 #include "resize/filter.h"
+#include "resize/resize.h"
 #include "resize/resize_impl.h"
 
 #include "gtest/gtest.h"
 #include "graphengine/filter_validation.h"
+#include "filter_compare.h"
 
 namespace {
 
@@ -45,9 +52,270 @@ void test_case(const zimg::PixelFormat &format, bool horizontal, double scale_fa
 	}
 }
 
+std::unique_ptr<graphengine::Filter> create_impulse_resizer(const zimg::resize::Filter &resample_filter)
+{
+	return zimg::resize::ResizeImplBuilder{ 16, 8, zimg::PixelType::FLOAT }
+		.set_horizontal(false)
+		.set_dst_dim(16)
+		.set_depth(32)
+		.set_filter(&resample_filter)
+		.set_shift(0.0)
+		.set_subwidth(8)
+		.create();
+}
+
+std::vector<float> resize_impulse(const graphengine::Filter &filter)
+{
+	const unsigned w = filter.descriptor().format.width;
+	const unsigned src_h = 8;
+	const unsigned dst_h = filter.descriptor().format.height;
+
+	zimg::AlignedVector<float> src(w * src_h);
+	zimg::AlignedVector<float> dst(w * dst_h);
+	src[w * (src_h / 2)] = 1.0f;
+
+	graphengine::BufferDescriptor src_buf{ src.data(), static_cast<ptrdiff_t>(w * sizeof(float)), graphengine::BUFFER_MAX };
+	graphengine::BufferDescriptor dst_buf{ dst.data(), static_cast<ptrdiff_t>(w * sizeof(float)), graphengine::BUFFER_MAX };
+
+	for (unsigned i = 0; i < dst_h; ++i) {
+		filter.process(&src_buf, &dst_buf, i, 0, w, nullptr, nullptr);
+	}
+	return{ dst.begin(), dst.end() };
+}
+
+void test_case_byte(bool horizontal, double scale_factor)
+{
+	const unsigned src_w = 640;
+	const unsigned src_h = 480;
+	const unsigned depth = 8;
+
+	const zimg::resize::BilinearFilter bilinear{};
+	const zimg::resize::Spline36Filter spline36{};
+	const zimg::resize::LanczosFilter lanczos4{ 4 };
+
+	const zimg::resize::Filter *resample_filters[] = { &bilinear, &spline36, &lanczos4 };
+
+	for (const zimg::resize::Filter *resample_filter : resample_filters) {
+		SCOPED_TRACE(resample_filter->support());
+
+		auto create = [&](zimg::PixelType type)
+		{
+			return zimg::resize::ResizeImplBuilder{ src_w, src_h, type }
+				.set_horizontal(horizontal)
+				.set_dst_dim(static_cast<unsigned>(std::lrint(scale_factor * (horizontal ? src_w : src_h))))
+				.set_depth(depth)
+				.set_filter(resample_filter)
+				.set_shift(0.0)
+				.set_subwidth(horizontal ? src_w : src_h)
+				.create();
+		};
+
+		auto filter_u8 = create(zimg::PixelType::BYTE);
+		auto filter_u16 = create(zimg::PixelType::WORD);
+		ASSERT_TRUE(filter_u8);
+		ASSERT_TRUE(filter_u16);
+
+		const graphengine::PlaneDescriptor &format = filter_u8->descriptor().format;
+
+		TestPlane src_u8{ src_w, src_h, zimg::PixelType::BYTE };
+		TestPlane src_u16{ src_w, src_h, zimg::PixelType::WORD };
+		TestPlane dst_u8{ format.width, format.height, zimg::PixelType::BYTE };
+		TestPlane dst_u16{ format.width, format.height, zimg::PixelType::WORD };
+
+		src_u8.fill_random(zimg::PixelType::BYTE, depth);
+
+		for (unsigned i = 0; i < src_h; ++i) {
+			std::copy_n(src_u8.row(i), src_w, src_u16.buffer().get_line<uint16_t>(i));
+		}
+
+		run_filter(*filter_u8, src_u8, dst_u8);
+		run_filter(*filter_u16, src_u16, dst_u16);
+
+		// 8-bit resizing must match 16-bit resizing of the same data.
+		for (unsigned i = 0; i < format.height; ++i) {
+			ASSERT_TRUE(std::equal(dst_u8.row(i), dst_u8.row(i) + format.width, dst_u16.buffer().get_line<uint16_t>(i))) << "mismatch at row " << i;
+		}
+	}
+}
+
+void test_case_alpha(bool horizontal, double scale_factor, zimg::CPUClass cpu)
+{
+	const unsigned src_w = 640;
+	const unsigned src_h = 480;
+	const zimg::resize::Spline36Filter spline36{};
+
+	auto builder = zimg::resize::ResizeImplBuilder{ src_w, src_h, zimg::PixelType::FLOAT }
+		.set_horizontal(horizontal)
+		.set_dst_dim(static_cast<unsigned>(std::lrint(scale_factor * (horizontal ? src_w : src_h))))
+		.set_depth(32)
+		.set_filter(&spline36)
+		.set_shift(0.0)
+		.set_subwidth(horizontal ? src_w : src_h)
+		.set_cpu(cpu);
+
+	auto filter = builder.create();
+	auto fused = builder.set_premultiply(horizontal).set_unpremultiply(true).set_resize_alpha(true).create();
+	ASSERT_TRUE(filter);
+	ASSERT_TRUE(fused);
+
+	const graphengine::FilterDescriptor &desc = fused->descriptor();
+	ASSERT_EQ(2U, desc.num_deps);
+	ASSERT_EQ(2U, desc.num_planes);
+
+	TestPlane src{ src_w, src_h, zimg::PixelType::FLOAT };
+	TestPlane src_alpha{ src_w, src_h, zimg::PixelType::FLOAT };
+	TestPlane premul{ src_w, src_h, zimg::PixelType::FLOAT };
+	TestPlane dst{ desc.format.width, desc.format.height, zimg::PixelType::FLOAT };
+	TestPlane dst_alpha{ desc.format.width, desc.format.height, zimg::PixelType::FLOAT };
+	TestPlane expected{ desc.format.width, desc.format.height, zimg::PixelType::FLOAT };
+	TestPlane expected_alpha{ desc.format.width, desc.format.height, zimg::PixelType::FLOAT };
+
+	src.fill_random(zimg::PixelType::FLOAT, 32);
+
+	for (unsigned i = 0; i < src_h; ++i) {
+		float *alpha = src_alpha.buffer().get_line<float>(i);
+
+		for (unsigned j = 0; j < src_w; ++j) {
+			alpha[j] = (i + j) % 7 == 0 ? 0.0f : static_cast<float>((i * 3 + j * 5) % 64) / 63.0f;
+		}
+	}
+
+	// Reference: separate premultiply, resize and unpremultiply passes.
+	auto premultiply = zimg::graph::select_premultiply_func(zimg::CPUClass::NONE);
+	auto unpremultiply = zimg::graph::select_unpremultiply_func(zimg::CPUClass::NONE);
+
+	for (unsigned i = 0; i < src_h; ++i) {
+		const float *src_p = src.buffer().get_line<float>(i);
+		float *dst_p = premul.buffer().get_line<float>(i);
+
+		if (horizontal)
+			premultiply(src_p, src_alpha.buffer().get_line<float>(i), dst_p, 0, src_w);
+		else
+			std::copy_n(src_p, src_w, dst_p);
+	}
+
+	run_filter(*filter, premul, expected);
+	run_filter(*filter, src_alpha, expected_alpha);
+
+	for (unsigned i = 0; i < desc.format.height; ++i) {
+		float *ptr = expected.buffer().get_line<float>(i);
+		unpremultiply(ptr, expected_alpha.buffer().get_line<float>(i), ptr, 0, desc.format.width);
+	}
+
+	zimg::AlignedVector<unsigned char> context(desc.context_size);
+	zimg::AlignedVector<unsigned char> tmp(desc.scratchpad_size);
+	graphengine::BufferDescriptor in[2] = { src.buffer(), src_alpha.buffer() };
+	graphengine::BufferDescriptor out[2] = { dst.buffer(), dst_alpha.buffer() };
+
+	fused->init_context(context.data());
+	for (unsigned i = 0; i < desc.format.height; i += desc.step) {
+		fused->process(in, out, i, 0, desc.format.width, context.data(), tmp.data());
+	}
+
+	for (unsigned i = 0; i < desc.format.height; ++i) {
+		ASSERT_EQ(0, std::memcmp(expected.row(i), dst.row(i), dst.row_size())) << "mismatch at row " << i;
+		ASSERT_EQ(0, std::memcmp(expected_alpha.row(i), dst_alpha.row(i), dst_alpha.row_size())) << "alpha mismatch at row " << i;
+	}
+}
+
+void test_case_planes(bool horizontal, double scale_factor, zimg::CPUClass cpu)
+{
+	const unsigned src_w = 640;
+	const unsigned src_h = 480;
+	const zimg::resize::LanczosFilter lanczos4{ 4 };
+
+	auto builder = zimg::resize::ResizeImplBuilder{ src_w, src_h, zimg::PixelType::FLOAT }
+		.set_horizontal(horizontal)
+		.set_dst_dim(static_cast<unsigned>(std::lrint(scale_factor * (horizontal ? src_w : src_h))))
+		.set_depth(32)
+		.set_filter(&lanczos4)
+		.set_shift(0.0)
+		.set_subwidth(horizontal ? src_w : src_h)
+		.set_cpu(cpu);
+
+	auto filter = builder.create();
+	auto planar = builder.set_color_planes(3).create();
+	ASSERT_TRUE(filter);
+	ASSERT_TRUE(planar);
+
+	const graphengine::FilterDescriptor &desc = planar->descriptor();
+	ASSERT_EQ(3U, desc.num_deps);
+	ASSERT_EQ(3U, desc.num_planes);
+
+	TestPlane src[3] = {
+		{ src_w, src_h, zimg::PixelType::FLOAT },
+		{ src_w, src_h, zimg::PixelType::FLOAT },
+		{ src_w, src_h, zimg::PixelType::FLOAT },
+	};
+	TestPlane dst[3] = {
+		{ desc.format.width, desc.format.height, zimg::PixelType::FLOAT },
+		{ desc.format.width, desc.format.height, zimg::PixelType::FLOAT },
+		{ desc.format.width, desc.format.height, zimg::PixelType::FLOAT },
+	};
+	TestPlane expected[3] = {
+		{ desc.format.width, desc.format.height, zimg::PixelType::FLOAT },
+		{ desc.format.width, desc.format.height, zimg::PixelType::FLOAT },
+		{ desc.format.width, desc.format.height, zimg::PixelType::FLOAT },
+	};
+
+	for (unsigned p = 0; p < 3; ++p) {
+		src[p].fill_random(zimg::PixelType::FLOAT, 32);
+		run_filter(*filter, src[p], expected[p]);
+	}
+
+	zimg::AlignedVector<unsigned char> context(desc.context_size);
+	zimg::AlignedVector<unsigned char> tmp(desc.scratchpad_size);
+	graphengine::BufferDescriptor in[3] = { src[0].buffer(), src[1].buffer(), src[2].buffer() };
+	graphengine::BufferDescriptor out[3] = { dst[0].buffer(), dst[1].buffer(), dst[2].buffer() };
+
+	planar->init_context(context.data());
+	for (unsigned i = 0; i < desc.format.height; i += desc.step) {
+		planar->process(in, out, i, 0, desc.format.width, context.data(), tmp.data());
+	}
+
+	for (unsigned p = 0; p < 3; ++p) {
+		for (unsigned i = 0; i < desc.format.height; ++i) {
+			ASSERT_EQ(0, std::memcmp(expected[p].row(i), dst[p].row(i), dst[p].row_size())) << "mismatch at plane " << p << " row " << i;
+		}
+	}
+}
+
 } // namespace
 
 
+TEST(ResizeImplTest, test_filter_cache)
+{
+	const zimg::resize::BicubicFilter catmull_rom{ 0.0, 0.5 };
+	const zimg::resize::BicubicFilter catmull_rom_copy{ 0.0, 0.5 };
+	const zimg::resize::BicubicFilter b_spline{ 1.0, 0.0 };
+
+	const zimg::resize::LanczosFilter lanczos2{ 2 };
+
+	// Keep all resizers alive, so that the coefficients can be shared.
+	auto filter1 = create_impulse_resizer(catmull_rom);
+	auto filter2 = create_impulse_resizer(catmull_rom_copy);
+	auto filter3 = create_impulse_resizer(b_spline);
+	auto filter4 = create_impulse_resizer(lanczos2);
+
+	auto filter_context = [](const graphengine::Filter &filter)
+	{
+		const auto *resize = dynamic_cast<const zimg::resize::ResizeImplV *>(&filter);
+		return resize ? resize->filter_context().get() : nullptr;
+	};
+
+	ASSERT_NE(nullptr, filter_context(*filter1));
+	EXPECT_EQ(filter_context(*filter1), filter_context(*filter2));
+
+	std::vector<float> expected = resize_impulse(*filter1);
+	EXPECT_EQ(expected, resize_impulse(*filter2));
+
+	// Filters with different parameters must not share coefficients.
+	EXPECT_NE(filter_context(*filter1), filter_context(*filter3));
+	EXPECT_NE(filter_context(*filter1), filter_context(*filter4));
+	EXPECT_NE(expected, resize_impulse(*filter3));
+	EXPECT_NE(expected, resize_impulse(*filter4));
+}
+
 TEST(ResizeImplTest, test_nop)
 {
 	static const char *expected_sha1_u16[] = {
@@ -292,3 +560,93 @@ TEST(ResizeImplTest, test_vertical_shift)
 		test_case(zimg::PixelType::FLOAT, false, 1.0 / 2.1, shift, subwidth_factor, expected_sha1_down);
 	}
 }
+
+TEST(ResizeImplTest, test_byte)
+{
+	{
+		SCOPED_TRACE("horizontal-up");
+		test_case_byte(true, 2.1);
+	}
+	{
+		SCOPED_TRACE("horizontal-down");
+		test_case_byte(true, 1.0 / 2.1);
+	}
+	{
+		SCOPED_TRACE("vertical-up");
+		test_case_byte(false, 2.1);
+	}
+	{
+		SCOPED_TRACE("vertical-down");
+		test_case_byte(false, 1.0 / 2.1);
+	}
+}
+
+TEST(ResizeImplTest, test_alpha)
+{
+	for (zimg::CPUClass cpu : { zimg::CPUClass::NONE, zimg::CPUClass::AUTO }) {
+		SCOPED_TRACE(static_cast<int>(cpu));
+		{
+			SCOPED_TRACE("horizontal-up");
+			test_case_alpha(true, 2.1, cpu);
+		}
+		{
+			SCOPED_TRACE("horizontal-down");
+			test_case_alpha(true, 1.0 / 2.1, cpu);
+		}
+		{
+			SCOPED_TRACE("vertical-up");
+			test_case_alpha(false, 2.1, cpu);
+		}
+		{
+			SCOPED_TRACE("vertical-down");
+			test_case_alpha(false, 1.0 / 2.1, cpu);
+		}
+	}
+}
+
+TEST(ResizeImplTest, test_premultiply_pass_order)
+{
+	const zimg::resize::BilinearFilter filter{};
+
+	auto make_conv = [&](unsigned dst_width, unsigned dst_height)
+	{
+		zimg::resize::ResizeConversion conv{ 512, 512, zimg::PixelType::FLOAT };
+		conv.set_filter(&filter)
+			.set_dst_width(dst_width)
+			.set_dst_height(dst_height)
+			.set_subwidth(512)
+			.set_subheight(512);
+		return conv;
+	};
+
+	// Horizontal-first or horizontal-only resizes can premultiply in the first pass.
+	EXPECT_TRUE(make_conv(1024, 1024).premultiply_supported());
+	EXPECT_TRUE(make_conv(256, 512).premultiply_supported());
+
+	// A large vertical downscale is cheaper vertical-first, so premultiplication stays separate.
+	EXPECT_FALSE(make_conv(480, 64).premultiply_supported());
+	EXPECT_FALSE(make_conv(512, 64).premultiply_supported());
+}
+
+TEST(ResizeImplTest, test_planes)
+{
+	for (zimg::CPUClass cpu : { zimg::CPUClass::NONE, zimg::CPUClass::AUTO, zimg::CPUClass::AUTO_64B }) {
+		SCOPED_TRACE(static_cast<int>(cpu));
+		{
+			SCOPED_TRACE("horizontal-up");
+			test_case_planes(true, 2.1, cpu);
+		}
+		{
+			SCOPED_TRACE("horizontal-down");
+			test_case_planes(true, 1.0 / 2.1, cpu);
+		}
+		{
+			SCOPED_TRACE("vertical-up");
+			test_case_planes(false, 2.1, cpu);
+		}
+		{
+			SCOPED_TRACE("vertical-down");
+			test_case_planes(false, 1.0 / 2.1, cpu);
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#ifdef ZIMG_X86
+
+#include <cstring>
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "graphengine/filter.h"
+#include "resize/decimate.h"
+
+#include "gtest/gtest.h"
+#include "filter_compare.h"
+
+namespace {
+
+void test_case(zimg::PixelType type, unsigned depth, unsigned src_w, unsigned src_h)
+{
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	SCOPED_TRACE(static_cast<int>(type));
+	SCOPED_TRACE(src_w);
+
+	zimg::resize::DecimateFilter filter_c{ src_w, src_h, type, zimg::CPUClass::NONE };
+	zimg::resize::DecimateFilter filter_avx2{ src_w, src_h, type, zimg::CPUClass::X86_AVX2 };
+	ASSERT_NE(zimg::resize::select_decimate_func(type, zimg::CPUClass::NONE), zimg::resize::select_decimate_func(type, zimg::CPUClass::X86_AVX2));
+
+	assert_identical_filters(&filter_c, &filter_avx2, src_w, src_h, type, depth);
+}
+
+// Partial column ranges must agree with the full row, as used by tiled execution.
+void test_case_window(zimg::PixelType type, unsigned depth, unsigned left, unsigned right)
+{
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	const unsigned src_w = 640;
+	const unsigned src_h = 8;
+
+	zimg::resize::DecimateFilter filter_c{ src_w, src_h, type, zimg::CPUClass::NONE };
+	zimg::resize::DecimateFilter filter_avx2{ src_w, src_h, type, zimg::CPUClass::X86_AVX2 };
+
+	TestPlane src{ src_w, src_h, type };
+	TestPlane dst_c{ src_w / 2, src_h / 2, type };
+	TestPlane dst_avx2{ src_w / 2, src_h / 2, type };
+	src.fill_random(type, depth);
+
+	zimg::AlignedVector<unsigned char> tmp(filter_c.descriptor().scratchpad_size);
+	size_t offset = static_cast<size_t>(left) * zimg::pixel_size(type);
+	size_t size = static_cast<size_t>(right - left) * zimg::pixel_size(type);
+
+	for (unsigned i = 0; i < src_h / 2; ++i) {
+		filter_c.process(&src.buffer(), &dst_c.buffer(), i, 0, src_w / 2, nullptr, tmp.data());
+		filter_avx2.process(&src.buffer(), &dst_avx2.buffer(), i, left, right, nullptr, tmp.data());
+		ASSERT_EQ(0, std::memcmp(dst_c.row(i) + offset, dst_avx2.row(i) + offset, size)) << "mismatch at row " << i;
+	}
+}
+
+} // namespace
+
+
+TEST(DecimateAVX2Test, test_decimate_u8)
+{
+	test_case(zimg::PixelType::BYTE, 8, 640, 480);
+	test_case(zimg::PixelType::BYTE, 8, 646, 62);
+	test_case_window(zimg::PixelType::BYTE, 8, 7, 301);
+}
+
+TEST(DecimateAVX2Test, test_decimate_u16)
+{
+	test_case(zimg::PixelType::WORD, 16, 640, 480);
+	test_case(zimg::PixelType::WORD, 10, 646, 62);
+	test_case_window(zimg::PixelType::WORD, 16, 7, 301);
+}
+
+TEST(DecimateAVX2Test, test_decimate_f32)
+{
+	test_case(zimg::PixelType::FLOAT, 32, 640, 480);
+	test_case(zimg::PixelType::FLOAT, 32, 646, 62);
+	test_case_window(zimg::PixelType::FLOAT, 32, 7, 301);
+}
+
+#endif // ZIMG_X86
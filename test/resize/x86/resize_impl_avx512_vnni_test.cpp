@@ -10,6 +10,7 @@
 #include "gtest/gtest.h"
 #include "graphengine/filter_validation.h"
 #include "dynamic_type.h"
+#include "filter_compare.h"
 
 namespace {
 
@@ -44,9 +45,61 @@ void test_case(const zimg::resize::Filter &filter, bool horizontal, unsigned src
 		.run();
 }
 
+void test_case_exact(const zimg::resize::Filter &filter, bool horizontal, unsigned src_w, unsigned src_h, unsigned dst_w, unsigned dst_h,
+                     const zimg::PixelFormat &format)
+{
+	if (!zimg::query_x86_capabilities().avx512vnni) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	SCOPED_TRACE(filter.support());
+	SCOPED_TRACE(horizontal ? static_cast<double>(dst_w) / src_w : static_cast<double>(dst_h) / src_h);
+
+	auto builder = zimg::resize::ResizeImplBuilder{ src_w, src_h, format.type }
+		.set_horizontal(horizontal)
+		.set_dst_dim(horizontal ? dst_w : dst_h)
+		.set_depth(format.depth)
+		.set_filter(&filter)
+		.set_shift(0.0)
+		.set_subwidth(horizontal ? src_w : src_h);
+
+	std::unique_ptr<graphengine::Filter> filter_avx512 = builder.set_cpu(zimg::CPUClass::X86_AVX512_CLX).create();
+	std::unique_ptr<graphengine::Filter> filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
+	ASSERT_TRUE(assert_different_dynamic_type(filter_c.get(), filter_avx512.get()));
+
+	assert_identical_filters(filter_c.get(), filter_avx512.get(), src_w, src_h, format.type, format.depth);
+}
+
 } // namespace
 
 
+TEST(ResizeImplAVX512VNNITest, test_resize_h_u8)
+{
+	const unsigned src_w = 640;
+	const unsigned dst_w = 957;
+	const unsigned h = 480;
+	const zimg::PixelFormat format{ zimg::PixelType::BYTE, 8 };
+
+	test_case_exact(zimg::resize::BilinearFilter{}, true, src_w, h, dst_w, h, format);
+	test_case_exact(zimg::resize::Spline16Filter{}, true, src_w, h, dst_w, h, format);
+	test_case_exact(zimg::resize::LanczosFilter{ 4 }, true, src_w, h, dst_w, h, format);
+	test_case_exact(zimg::resize::LanczosFilter{ 4 }, true, dst_w, h, src_w, h, format);
+}
+
+TEST(ResizeImplAVX512VNNITest, test_resize_v_u8)
+{
+	const unsigned w = 637;
+	const unsigned src_h = 480;
+	const unsigned dst_h = 719;
+	const zimg::PixelFormat format{ zimg::PixelType::BYTE, 8 };
+
+	test_case_exact(zimg::resize::BilinearFilter{}, false, w, src_h, w, dst_h, format);
+	test_case_exact(zimg::resize::Spline16Filter{}, false, w, src_h, w, dst_h, format);
+	test_case_exact(zimg::resize::LanczosFilter{ 4 }, false, w, src_h, w, dst_h, format);
+	test_case_exact(zimg::resize::LanczosFilter{ 4 }, false, w, dst_h, w, src_h, format);
+}
+
 TEST(ResizeImplAVX512VNNITest, test_resize_h_u10)
 {
 	const unsigned src_w = 640;